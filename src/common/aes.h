@@ -10,6 +10,15 @@
 #include <stdexcept>
 #include <vector>
 
+#if defined(__x86_64__) || defined(_M_X64)
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include <immintrin.h>
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+#include <arm_neon.h>
+#endif
+
 /** AES cipher APIs */
 namespace aes {
 namespace detail {
@@ -267,8 +276,207 @@ inline void incr_counter(unsigned char counter[kStateSize]) {
     } while (n);
 }
 
+/**
+ * @private
+ * Hardware AES kernels, AES-NI is detected at runtime and the ARMv8 crypto extension at compile
+ * time. Round keys are stored in the byte order of the state, so they are loaded as is.
+ */
+namespace hw {
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define AES_HW_AVAILABLE 1
+#ifdef _MSC_VER
+#define AES_HW_TARGET
+#else
+#define AES_HW_TARGET __attribute__((target("aes,sse2")))
+#endif
+
+inline bool is_supported() {
+    static const bool supported = [] {
+#ifdef _MSC_VER
+        int info[4];
+        __cpuid(info, 1);
+        return (info[2] & (1 << 25)) != 0;
+#else
+        return __builtin_cpu_supports("aes") != 0;
+#endif
+    }();
+    return supported;
+}
+
+AES_HW_TARGET inline void encrypt_blocks(const RoundKeys& rkeys, const unsigned char* data,
+                                         unsigned char* encrypted, std::size_t count) {
+    const std::size_t nr = rkeys.size() - 1;
+    __m128i k[15];
+    for (std::size_t i = 0; i <= nr; ++i) {
+        k[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&rkeys[i]));
+    }
+    std::size_t b = 0;
+    // Blocks are independent, interleave four of them to hide the latency of aesenc
+    for (; b + 4 <= count; b += 4) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(data + b * kStateSize);
+        __m128i s0 = _mm_xor_si128(_mm_loadu_si128(in + 0), k[0]);
+        __m128i s1 = _mm_xor_si128(_mm_loadu_si128(in + 1), k[0]);
+        __m128i s2 = _mm_xor_si128(_mm_loadu_si128(in + 2), k[0]);
+        __m128i s3 = _mm_xor_si128(_mm_loadu_si128(in + 3), k[0]);
+        for (std::size_t r = 1; r < nr; ++r) {
+            s0 = _mm_aesenc_si128(s0, k[r]);
+            s1 = _mm_aesenc_si128(s1, k[r]);
+            s2 = _mm_aesenc_si128(s2, k[r]);
+            s3 = _mm_aesenc_si128(s3, k[r]);
+        }
+        __m128i* out = reinterpret_cast<__m128i*>(encrypted + b * kStateSize);
+        _mm_storeu_si128(out + 0, _mm_aesenclast_si128(s0, k[nr]));
+        _mm_storeu_si128(out + 1, _mm_aesenclast_si128(s1, k[nr]));
+        _mm_storeu_si128(out + 2, _mm_aesenclast_si128(s2, k[nr]));
+        _mm_storeu_si128(out + 3, _mm_aesenclast_si128(s3, k[nr]));
+    }
+    for (; b < count; ++b) {
+        __m128i s = _mm_xor_si128(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + b * kStateSize)), k[0]);
+        for (std::size_t r = 1; r < nr; ++r) {
+            s = _mm_aesenc_si128(s, k[r]);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(encrypted + b * kStateSize),
+                         _mm_aesenclast_si128(s, k[nr]));
+    }
+}
+
+/**
+ * Decrypts count blocks. With chain set, every block is xored with the ciphertext before it
+ * like CBC, the first one with the 16 bytes at chain.
+ */
+AES_HW_TARGET inline void decrypt_blocks(const RoundKeys& rkeys, const unsigned char* data,
+                                         unsigned char* decrypted, std::size_t count,
+                                         const unsigned char* chain) {
+    const std::size_t nr = rkeys.size() - 1;
+    // Round keys of the equivalent inverse cipher
+    __m128i k[15];
+    k[0] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&rkeys[nr]));
+    for (std::size_t i = 1; i < nr; ++i) {
+        k[i] = _mm_aesimc_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&rkeys[nr - i])));
+    }
+    k[nr] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&rkeys[0]));
+
+    __m128i prev = chain ? _mm_loadu_si128(reinterpret_cast<const __m128i*>(chain))
+                         : _mm_setzero_si128();
+    std::size_t b = 0;
+    // Unlike CBC encryption the blocks don't depend on each other, interleave four of them.
+    // The ciphertext is loaded before storing so the data can be decrypted in place.
+    for (; b + 4 <= count; b += 4) {
+        const __m128i* in = reinterpret_cast<const __m128i*>(data + b * kStateSize);
+        const __m128i c0 = _mm_loadu_si128(in + 0);
+        const __m128i c1 = _mm_loadu_si128(in + 1);
+        const __m128i c2 = _mm_loadu_si128(in + 2);
+        const __m128i c3 = _mm_loadu_si128(in + 3);
+        __m128i s0 = _mm_xor_si128(c0, k[0]);
+        __m128i s1 = _mm_xor_si128(c1, k[0]);
+        __m128i s2 = _mm_xor_si128(c2, k[0]);
+        __m128i s3 = _mm_xor_si128(c3, k[0]);
+        for (std::size_t r = 1; r < nr; ++r) {
+            s0 = _mm_aesdec_si128(s0, k[r]);
+            s1 = _mm_aesdec_si128(s1, k[r]);
+            s2 = _mm_aesdec_si128(s2, k[r]);
+            s3 = _mm_aesdec_si128(s3, k[r]);
+        }
+        s0 = _mm_aesdeclast_si128(s0, k[nr]);
+        s1 = _mm_aesdeclast_si128(s1, k[nr]);
+        s2 = _mm_aesdeclast_si128(s2, k[nr]);
+        s3 = _mm_aesdeclast_si128(s3, k[nr]);
+        if (chain) {
+            s0 = _mm_xor_si128(s0, prev);
+            s1 = _mm_xor_si128(s1, c0);
+            s2 = _mm_xor_si128(s2, c1);
+            s3 = _mm_xor_si128(s3, c2);
+            prev = c3;
+        }
+        __m128i* out = reinterpret_cast<__m128i*>(decrypted + b * kStateSize);
+        _mm_storeu_si128(out + 0, s0);
+        _mm_storeu_si128(out + 1, s1);
+        _mm_storeu_si128(out + 2, s2);
+        _mm_storeu_si128(out + 3, s3);
+    }
+    for (; b < count; ++b) {
+        const __m128i c =
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + b * kStateSize));
+        __m128i s = _mm_xor_si128(c, k[0]);
+        for (std::size_t r = 1; r < nr; ++r) {
+            s = _mm_aesdec_si128(s, k[r]);
+        }
+        s = _mm_aesdeclast_si128(s, k[nr]);
+        if (chain) {
+            s = _mm_xor_si128(s, prev);
+            prev = c;
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(decrypted + b * kStateSize), s);
+    }
+}
+
+#undef AES_HW_TARGET
+
+#elif defined(__aarch64__) && (defined(__ARM_FEATURE_AES) || defined(__ARM_FEATURE_CRYPTO))
+#define AES_HW_AVAILABLE 1
+
+inline bool is_supported() {
+    return true;
+}
+
+inline void encrypt_blocks(const RoundKeys& rkeys, const unsigned char* data,
+                           unsigned char* encrypted, std::size_t count) {
+    const std::size_t nr = rkeys.size() - 1;
+    uint8x16_t k[15];
+    for (std::size_t i = 0; i <= nr; ++i) {
+        k[i] = vld1q_u8(reinterpret_cast<const uint8_t*>(&rkeys[i]));
+    }
+    for (std::size_t b = 0; b < count; ++b) {
+        uint8x16_t s = vld1q_u8(data + b * kStateSize);
+        for (std::size_t r = 0; r < nr - 1; ++r) {
+            s = vaesmcq_u8(vaeseq_u8(s, k[r]));
+        }
+        s = veorq_u8(vaeseq_u8(s, k[nr - 1]), k[nr]);
+        vst1q_u8(encrypted + b * kStateSize, s);
+    }
+}
+
+inline void decrypt_blocks(const RoundKeys& rkeys, const unsigned char* data,
+                           unsigned char* decrypted, std::size_t count,
+                           const unsigned char* chain) {
+    const std::size_t nr = rkeys.size() - 1;
+    uint8x16_t k[15];
+    k[0] = vld1q_u8(reinterpret_cast<const uint8_t*>(&rkeys[nr]));
+    for (std::size_t i = 1; i < nr; ++i) {
+        k[i] = vaesimcq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(&rkeys[nr - i])));
+    }
+    k[nr] = vld1q_u8(reinterpret_cast<const uint8_t*>(&rkeys[0]));
+
+    uint8x16_t prev = chain ? vld1q_u8(chain) : vdupq_n_u8(0);
+    for (std::size_t b = 0; b < count; ++b) {
+        const uint8x16_t c = vld1q_u8(data + b * kStateSize);
+        uint8x16_t s = vaesdq_u8(c, k[0]);
+        for (std::size_t r = 1; r < nr; ++r) {
+            s = vaesdq_u8(vaesimcq_u8(s), k[r]);
+        }
+        s = veorq_u8(s, k[nr]);
+        if (chain) {
+            s = veorq_u8(s, prev);
+            prev = c;
+        }
+        vst1q_u8(decrypted + b * kStateSize, s);
+    }
+}
+
+#endif
+
+} // namespace hw
+
 inline void encrypt_state(const RoundKeys& rkeys, const unsigned char data[16],
                           unsigned char encrypted[16]) {
+#ifdef AES_HW_AVAILABLE
+    if (hw::is_supported()) {
+        hw::encrypt_blocks(rkeys, data, encrypted, 1);
+        return;
+    }
+#endif
     State s;
     copy_bytes_to_state(data, s);
 
@@ -290,6 +498,12 @@ inline void encrypt_state(const RoundKeys& rkeys, const unsigned char data[16],
 
 inline void decrypt_state(const RoundKeys& rkeys, const unsigned char data[16],
                           unsigned char decrypted[16]) {
+#ifdef AES_HW_AVAILABLE
+    if (hw::is_supported()) {
+        hw::decrypt_blocks(rkeys, data, decrypted, 1, nullptr);
+        return;
+    }
+#endif
     State s;
     copy_bytes_to_state(data, s);
 
@@ -309,6 +523,39 @@ inline void decrypt_state(const RoundKeys& rkeys, const unsigned char data[16],
     copy_state_to_bytes(s, decrypted);
 }
 
+/** @private Encrypts count consecutive blocks independently. */
+inline void encrypt_blocks(const RoundKeys& rkeys, const unsigned char* data,
+                           unsigned char* encrypted, std::size_t count) {
+#ifdef AES_HW_AVAILABLE
+    if (hw::is_supported()) {
+        hw::encrypt_blocks(rkeys, data, encrypted, count);
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < count; ++i) {
+        encrypt_state(rkeys, data + i * kStateSize, encrypted + i * kStateSize);
+    }
+}
+
+/** @private Decrypts count consecutive blocks, chained like CBC if chain is not null. */
+inline void decrypt_blocks(const RoundKeys& rkeys, const unsigned char* data,
+                           unsigned char* decrypted, std::size_t count,
+                           const unsigned char* chain) {
+#ifdef AES_HW_AVAILABLE
+    if (hw::is_supported()) {
+        hw::decrypt_blocks(rkeys, data, decrypted, count, chain);
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < count; ++i) {
+        const std::size_t offset = i * kStateSize;
+        decrypt_state(rkeys, data + offset, decrypted + offset);
+        if (chain) {
+            xor_data(decrypted + offset, i == 0 ? chain : data + offset - kStateSize);
+        }
+    }
+}
+
 template <int KeyLen>
 std::vector<unsigned char> key_from_string(const char (*key_str)[KeyLen]) {
     std::vector<unsigned char> key(KeyLen - 1);
@@ -813,10 +1060,7 @@ inline Error encrypt_ecb(const unsigned char* data, const unsigned long data_siz
     const detail::RoundKeys rkeys = detail::expand_key(key, static_cast<int>(key_size));
 
     const unsigned long bc = data_size / detail::kStateSize;
-    for (unsigned long i = 0; i < bc; ++i) {
-        detail::encrypt_state(rkeys, data + (i * detail::kStateSize),
-                              encrypted + (i * detail::kStateSize));
-    }
+    detail::encrypt_blocks(rkeys, data, encrypted, bc);
 
     if (pads) {
         const int rem = data_size % detail::kStateSize;
@@ -857,10 +1101,7 @@ inline Error decrypt_ecb(const unsigned char* data, const unsigned long data_siz
     const detail::RoundKeys rkeys = detail::expand_key(key, static_cast<int>(key_size));
 
     const unsigned long bc = data_size / detail::kStateSize - 1;
-    for (unsigned long i = 0; i < bc; ++i) {
-        detail::decrypt_state(rkeys, data + (i * detail::kStateSize),
-                              decrypted + (i * detail::kStateSize));
-    }
+    detail::decrypt_blocks(rkeys, data, decrypted, bc, nullptr);
 
     unsigned char last[detail::kStateSize] = {};
     detail::decrypt_state(rkeys, data + (bc * detail::kStateSize), last);
@@ -992,10 +1233,9 @@ inline Error decrypt_cbc(const unsigned char* data, const unsigned long data_siz
 
     // decrypt mid
     const unsigned long bc = data_size / detail::kStateSize - 1;
-    for (unsigned long i = 1; i < bc; ++i) {
-        const long offset = i * detail::kStateSize;
-        detail::decrypt_state(rkeys, data + offset, decrypted + offset);
-        detail::xor_data(decrypted + offset, data + offset - detail::kStateSize);
+    if (bc > 1) {
+        detail::decrypt_blocks(rkeys, data + detail::kStateSize, decrypted + detail::kStateSize,
+                               bc - 1, data);
     }
 
     // decrypt last
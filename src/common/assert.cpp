@@ -15,12 +15,14 @@
 
 void assert_fail_impl() {
     Common::Log::Stop();
+    Common::Log::EnableForStacktrace();
     std::fflush(stdout);
     // Crash();
 }
 
 [[noreturn]] void unreachable_impl() {
     Common::Log::Stop();
+    Common::Log::EnableForStacktrace();
     std::fflush(stdout);
     // Crash();
     throw std::runtime_error("Unreachable code");
@@ -3,7 +3,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
+#include <bit>
 #include <cstddef>
 #include "common/types.h"
 
@@ -22,6 +24,9 @@ class BitArray {
     static constexpr size_t WORD_COUNT = N / BITS_PER_WORD;
     static constexpr size_t WORDS_PER_AVX = 4;
     static constexpr size_t AVX_WORD_COUNT = WORD_COUNT / WORDS_PER_AVX;
+    // The summary has a bit per word that is set when the word is not zero, so that scans skip
+    // 64 clear words at a time.
+    static constexpr size_t SUMMARY_WORD_COUNT = (WORD_COUNT + BITS_PER_WORD - 1) / BITS_PER_WORD;
 
 public:
     using Range = std::pair<size_t, size_t>;
@@ -86,19 +91,15 @@ public:
             data[first_word] = other.data[first_word] & (start_mask & end_mask);
         } else {
             data[first_word] = other.data[first_word] & start_mask;
-            size_t i = first_word + 1;
-#ifdef BIT_ARRAY_USE_AVX
-            for (; i + WORDS_PER_AVX <= last_word; i += WORDS_PER_AVX) {
-                const __m256i current =
-                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&other.data[i]));
-                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&data[i]), current);
-            }
-#endif
-            for (; i < last_word; ++i) {
-                data[i] = other.data[i];
-            }
+            std::copy(other.data.begin() + first_word + 1, other.data.begin() + last_word,
+                      data.begin() + first_word + 1);
+            ForEachSummaryWord(first_word + 1, last_word, [&](size_t index, u64 mask) {
+                summary[index] |= other.summary[index] & mask;
+            });
             data[last_word] = other.data[last_word] & end_mask;
+            UpdateSummary(last_word);
         }
+        UpdateSummary(first_word);
     }
 
     BitArray(const BitArray& other, const Range& range)
@@ -112,11 +113,14 @@ public:
     }
 
     inline constexpr void Set(size_t idx) {
-        data[idx / BITS_PER_WORD] |= (1ULL << (idx % BITS_PER_WORD));
+        const size_t word = idx / BITS_PER_WORD;
+        data[word] |= (1ULL << (idx % BITS_PER_WORD));
+        summary[word / BITS_PER_WORD] |= 1ULL << (word % BITS_PER_WORD);
     }
 
     inline constexpr void Unset(size_t idx) {
         data[idx / BITS_PER_WORD] &= ~(1ULL << (idx % BITS_PER_WORD));
+        UpdateSummary(idx / BITS_PER_WORD);
     }
 
     inline constexpr bool Get(size_t idx) const {
@@ -137,18 +141,11 @@ public:
             data[first_word] |= start_mask & end_mask;
         } else {
             data[first_word] |= start_mask;
-            size_t i = first_word + 1;
-#ifdef BIT_ARRAY_USE_AVX
-            const __m256i value = _mm256_set1_epi64x(-1);
-            for (; i + WORDS_PER_AVX <= last_word; i += WORDS_PER_AVX) {
-                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&data[i]), value);
-            }
-#endif
-            for (; i < last_word; ++i) {
-                data[i] = ~0ULL;
-            }
+            std::fill(data.begin() + first_word + 1, data.begin() + last_word, ~0ULL);
             data[last_word] |= end_mask;
         }
+        ForEachSummaryWord(first_word, last_word + 1,
+                           [&](size_t index, u64 mask) { summary[index] |= mask; });
     }
 
     inline void UnsetRange(size_t start, size_t end) {
@@ -165,18 +162,13 @@ public:
             data[first_word] &= start_mask | end_mask;
         } else {
             data[first_word] &= start_mask;
-            size_t i = first_word + 1;
-#ifdef BIT_ARRAY_USE_AVX
-            const __m256i value = _mm256_setzero_si256();
-            for (; i + WORDS_PER_AVX <= last_word; i += WORDS_PER_AVX) {
-                _mm256_storeu_si256(reinterpret_cast<__m256i*>(&data[i]), value);
-            }
-#endif
-            for (; i < last_word; ++i) {
-                data[i] = 0ULL;
-            }
+            std::fill(data.begin() + first_word + 1, data.begin() + last_word, 0ULL);
+            ForEachSummaryWord(first_word + 1, last_word,
+                               [&](size_t index, u64 mask) { summary[index] &= ~mask; });
             data[last_word] &= end_mask;
+            UpdateSummary(last_word);
         }
+        UpdateSummary(first_word);
     }
 
     inline constexpr void SetRange(const Range& range) {
@@ -189,15 +181,17 @@ public:
 
     inline constexpr void Clear() {
         data.fill(0);
+        summary.fill(0);
     }
 
     inline constexpr void Fill() {
         data.fill(~0ULL);
+        ForEachSummaryWord(0, WORD_COUNT, [&](size_t index, u64 mask) { summary[index] = mask; });
     }
 
     inline constexpr bool None() const {
         u64 result = 0;
-        for (const auto& word : data) {
+        for (const auto& word : summary) {
             result |= word;
         }
         return result == 0;
@@ -207,6 +201,29 @@ public:
         return !None();
     }
 
+    /// Returns true when any bit in [start, end) is set, without copying the range out.
+    inline constexpr bool AnyInRange(size_t start, size_t end) const {
+        if (start >= end || end > N) {
+            return false;
+        }
+        const size_t first_word = start / BITS_PER_WORD;
+        const size_t last_word = (end - 1) / BITS_PER_WORD;
+        const size_t start_bit = start % BITS_PER_WORD;
+        const size_t end_bit = (end - 1) % BITS_PER_WORD;
+        const u64 start_mask = ~((1ULL << start_bit) - 1);
+        const u64 end_mask = end_bit == BITS_PER_WORD - 1 ? ~0ULL : (1ULL << (end_bit + 1)) - 1;
+        if (first_word == last_word) {
+            return (data[first_word] & start_mask & end_mask) != 0;
+        }
+        if ((data[first_word] & start_mask) != 0 || (data[last_word] & end_mask) != 0) {
+            return true;
+        }
+        u64 result = 0;
+        ForEachSummaryWord(first_word + 1, last_word,
+                           [&](size_t index, u64 mask) { result |= summary[index] & mask; });
+        return result != 0;
+    }
+
     Range FirstRangeFrom(size_t start) const {
         if (start >= N) {
             return {N, N};
@@ -248,22 +265,11 @@ public:
             return word_bits(start_word, masked_first);
         }
 
-        size_t word = start_word + 1;
-#ifdef BIT_ARRAY_USE_AVX
-        for (; word + WORDS_PER_AVX <= WORD_COUNT; word += WORDS_PER_AVX) {
-            const __m256i current =
-                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&data[word]));
-            if (!_mm256_testz_si256(current, current)) {
-                break;
-            }
-        }
-#endif
-        for (; word < WORD_COUNT; ++word) {
-            if (data[word] != 0) {
-                return word_bits(word, data[word]);
-            }
+        const size_t word = NextNonZeroWord(start_word + 1);
+        if (word == WORD_COUNT) {
+            return {N, N};
         }
-        return {N, N};
+        return word_bits(word, data[word]);
     }
 
     inline constexpr Range FirstRange() const {
@@ -279,11 +285,11 @@ public:
         }
         const auto find_start_bit = [&](size_t word) {
 #ifdef BIT_ARRAY_USE_AVX
-            const __m256i all_zero = _mm256_setzero_si256();
+            const __m256i all_one = _mm256_set1_epi64x(-1);
             for (; word >= WORDS_PER_AVX; word -= WORDS_PER_AVX) {
                 const __m256i current = _mm256_loadu_si256(
                     reinterpret_cast<const __m256i*>(&data[word - WORDS_PER_AVX]));
-                const __m256i cmp = _mm256_cmpeq_epi64(current, all_zero);
+                const __m256i cmp = _mm256_cmpeq_epi64(current, all_one);
                 if (_mm256_movemask_epi8(cmp) != 0xFFFFFFFF) {
                     break;
                 }
@@ -314,22 +320,11 @@ public:
         if (masked_last) {
             return word_bits(end_word, masked_last);
         }
-        size_t word = end_word - 1;
-#ifdef BIT_ARRAY_USE_AVX
-        for (; word >= WORDS_PER_AVX; word -= WORDS_PER_AVX) {
-            const __m256i current =
-                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&data[word - WORDS_PER_AVX]));
-            if (!_mm256_testz_si256(current, current)) {
-                break;
-            }
-        }
-#endif
-        for (; word > 0; --word) {
-            if (data[word - 1] != 0) {
-                return word_bits(word, data[word - 1]);
-            }
+        const size_t word = PrevNonZeroWord(end_word - 1);
+        if (word == 0) {
+            return {0, 0};
         }
-        return {0, 0};
+        return word_bits(word, data[word - 1]);
     }
 
     inline constexpr Range LastRange() const {
@@ -344,6 +339,7 @@ public:
         for (size_t i = 0; i < WORD_COUNT; ++i) {
             data[i] |= other.data[i];
         }
+        RebuildSummary();
         return *this;
     }
 
@@ -351,6 +347,7 @@ public:
         for (size_t i = 0; i < WORD_COUNT; ++i) {
             data[i] &= other.data[i];
         }
+        RebuildSummary();
         return *this;
     }
 
@@ -358,6 +355,7 @@ public:
         for (size_t i = 0; i < WORD_COUNT; ++i) {
             data[i] ^= other.data[i];
         }
+        RebuildSummary();
         return *this;
     }
 
@@ -384,6 +382,7 @@ public:
         for (size_t i = 0; i < WORD_COUNT; ++i) {
             result.data[i] = ~result.data[i];
         }
+        result.RebuildSummary();
         return result;
     }
 
@@ -400,7 +399,72 @@ public:
     }
 
 private:
+    /// Calls func with the index and mask of each summary word covering the words [first, last).
+    template <typename Func>
+    static constexpr void ForEachSummaryWord(size_t first, size_t last, Func&& func) {
+        while (first < last) {
+            const size_t bit = first % BITS_PER_WORD;
+            const size_t count = std::min(BITS_PER_WORD - bit, last - first);
+            const u64 mask = count == BITS_PER_WORD ? ~0ULL : ((1ULL << count) - 1) << bit;
+            func(first / BITS_PER_WORD, mask);
+            first += count;
+        }
+    }
+
+    inline constexpr void UpdateSummary(size_t word) {
+        const u64 bit = 1ULL << (word % BITS_PER_WORD);
+        if (data[word] != 0) {
+            summary[word / BITS_PER_WORD] |= bit;
+        } else {
+            summary[word / BITS_PER_WORD] &= ~bit;
+        }
+    }
+
+    inline constexpr void RebuildSummary() {
+        summary.fill(0);
+        for (size_t i = 0; i < WORD_COUNT; ++i) {
+            summary[i / BITS_PER_WORD] |= u64{data[i] != 0} << (i % BITS_PER_WORD);
+        }
+    }
+
+    /// Returns the first word at or after word that is not zero, WORD_COUNT if there is none.
+    inline constexpr size_t NextNonZeroWord(size_t word) const {
+        size_t index = word / BITS_PER_WORD;
+        if (index >= SUMMARY_WORD_COUNT) {
+            return WORD_COUNT;
+        }
+        u64 bits = summary[index] & (~0ULL << (word % BITS_PER_WORD));
+        while (bits == 0) {
+            if (++index == SUMMARY_WORD_COUNT) {
+                return WORD_COUNT;
+            }
+            bits = summary[index];
+        }
+        return index * BITS_PER_WORD + std::countr_zero(bits);
+    }
+
+    /// Returns one past the last word before end that is not zero, 0 if there is none.
+    inline constexpr size_t PrevNonZeroWord(size_t end) const {
+        if (end == 0) {
+            return 0;
+        }
+        size_t index = (end - 1) / BITS_PER_WORD;
+        const size_t end_bit = (end - 1) % BITS_PER_WORD;
+        u64 bits = summary[index];
+        if (end_bit < BITS_PER_WORD - 1) {
+            bits &= (1ULL << (end_bit + 1)) - 1;
+        }
+        while (bits == 0) {
+            if (index-- == 0) {
+                return 0;
+            }
+            bits = summary[index];
+        }
+        return index * BITS_PER_WORD + (BITS_PER_WORD - std::countl_zero(bits));
+    }
+
     std::array<u64, WORD_COUNT> data{};
+    std::array<u64, SUMMARY_WORD_COUNT> summary{};
 };
 
 } // namespace Common
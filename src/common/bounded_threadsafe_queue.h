@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <condition_variable>
 #include <cstddef>
@@ -55,6 +56,12 @@ public:
         return t;
     }
 
+    [[nodiscard]] std::size_t Size() const {
+        // Read index first, it never passes the write index loaded after it.
+        const std::size_t read_index = m_read_index.load(std::memory_order::acquire);
+        return m_write_index.load(std::memory_order::acquire) - read_index;
+    }
+
 private:
     enum class PushMode {
         Try,
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Common {
+
+/**
+ * Variant of ObjectPool that several threads may create objects from at once. Objects are
+ * bump allocated from the current chunk with a single atomic increment and keep their address
+ * until the contents are released, which must not overlap with Create.
+ */
+template <typename T>
+    requires std::is_destructible_v<T>
+class ConcurrentObjectPool {
+public:
+    explicit ConcurrentObjectPool(size_t chunk_size = 8192) : new_chunk_size{chunk_size} {
+        chunks.emplace_back(std::make_unique<Chunk>(new_chunk_size));
+        current = chunks.back().get();
+    }
+
+    ~ConcurrentObjectPool() = default;
+
+    ConcurrentObjectPool(const ConcurrentObjectPool&) = delete;
+    ConcurrentObjectPool& operator=(const ConcurrentObjectPool&) = delete;
+
+    template <typename... Args>
+        requires std::is_constructible_v<T, Args...>
+    [[nodiscard]] T* Create(Args&&... args) {
+        while (true) {
+            Chunk* const chunk = current.load(std::memory_order_acquire);
+            const size_t slot = chunk->used_objects.fetch_add(1, std::memory_order_relaxed);
+            if (slot < chunk->num_objects) {
+                return std::construct_at(&chunk->storage[slot].object,
+                                         std::forward<Args>(args)...);
+            }
+            Grow(chunk);
+        }
+    }
+
+    void ReleaseContents() {
+        std::scoped_lock lk{grow_mutex};
+        if (chunks.size() > 1) {
+            // Squash the allocations of the last use into a single chunk.
+            size_t total_objects = 0;
+            for (const auto& chunk : chunks) {
+                total_objects += chunk->num_objects;
+            }
+            chunks.clear();
+            chunks.emplace_back(std::make_unique<Chunk>(total_objects));
+        } else {
+            chunks.front()->Release();
+        }
+        current.store(chunks.front().get(), std::memory_order_release);
+    }
+
+private:
+    struct NonTrivialDummy {
+        NonTrivialDummy() noexcept {}
+    };
+
+    union Storage {
+        Storage() noexcept {}
+        ~Storage() noexcept {}
+
+        NonTrivialDummy dummy{};
+        T object;
+    };
+
+    struct Chunk {
+        explicit Chunk(size_t size)
+            : num_objects{size}, storage{std::make_unique<Storage[]>(size)} {}
+
+        ~Chunk() {
+            Release();
+        }
+
+        void Release() {
+            // Creators overshoot the count when the chunk fills up.
+            const size_t num_created =
+                std::min(used_objects.load(std::memory_order_acquire), num_objects);
+            for (size_t i = 0; i < num_created; ++i) {
+                std::destroy_at(&storage[i].object);
+            }
+            used_objects.store(0, std::memory_order_relaxed);
+        }
+
+        std::atomic<size_t> used_objects{};
+        size_t num_objects;
+        std::unique_ptr<Storage[]> storage;
+    };
+
+    void Grow(Chunk* full_chunk) {
+        std::scoped_lock lk{grow_mutex};
+        if (current.load(std::memory_order_relaxed) != full_chunk) {
+            return;
+        }
+        chunks.emplace_back(std::make_unique<Chunk>(new_chunk_size));
+        current.store(chunks.back().get(), std::memory_order_release);
+    }
+
+    std::mutex grow_mutex;
+    std::vector<std::unique_ptr<Chunk>> chunks;
+    std::atomic<Chunk*> current;
+    size_t new_chunk_size{};
+};
+
+} // namespace Common
@@ -0,0 +1,268 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <limits>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "common/assert.h"
+#include "common/types.h"
+
+namespace Common {
+
+/// Identifies an object of a ConcurrentSlotVector. The generation tells apart the objects that
+/// reuse the same slot, so a stale id never resolves to a newer object.
+struct ConcurrentSlotId {
+    static constexpr u32 INVALID_INDEX = std::numeric_limits<u32>::max();
+
+    constexpr auto operator<=>(const ConcurrentSlotId&) const noexcept = default;
+
+    constexpr explicit operator bool() const noexcept {
+        return index != INVALID_INDEX;
+    }
+
+    u32 index = INVALID_INDEX;
+    u32 generation = 0;
+};
+
+/**
+ * Slot vector that can be read and modified from several threads without an external lock.
+ * Objects live in fixed size chunks that are never moved, slots are allocated from a lock-free
+ * free list and erased objects are destroyed once no reader that may still see them is left.
+ * Readers hold a ReadGuard while they use the objects returned by Find.
+ */
+template <class T>
+class ConcurrentSlotVector {
+    static constexpr u32 ChunkBits = 10;
+    static constexpr u32 ChunkSize = 1U << ChunkBits;
+    static constexpr u32 MaxChunks = 1024;
+    static constexpr u32 EndOfList = std::numeric_limits<u32>::max();
+
+public:
+    class ReadGuard {
+    public:
+        explicit ReadGuard(ConcurrentSlotVector& vector_) : vector{vector_} {
+            epoch = vector.EnterRead();
+        }
+        ~ReadGuard() {
+            vector.ExitRead(epoch);
+        }
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+    private:
+        ConcurrentSlotVector& vector;
+        u32 epoch;
+    };
+
+    ConcurrentSlotVector() = default;
+
+    ~ConcurrentSlotVector() noexcept {
+        const u32 num_slots = std::min(next_index.load(), MaxChunks * ChunkSize);
+        for (u32 index = 0; index < num_slots; ++index) {
+            Entry& entry = GetEntry(index);
+            if (IsAlive(entry.generation.load(std::memory_order_relaxed)) ||
+                entry.pending_destroy) {
+                entry.object.~T();
+            }
+        }
+        for (auto& chunk : chunks) {
+            delete[] chunk.load(std::memory_order_relaxed);
+        }
+    }
+
+    ConcurrentSlotVector(const ConcurrentSlotVector&) = delete;
+    ConcurrentSlotVector& operator=(const ConcurrentSlotVector&) = delete;
+
+    template <typename... Args>
+    ConcurrentSlotId insert(Args&&... args) {
+        const u32 index = AllocateIndex();
+        Entry& entry = GetEntry(index);
+        new (&entry.object) T(std::forward<Args>(args)...);
+        // Publish the constructed object by making the generation odd.
+        const u32 generation = entry.generation.load(std::memory_order_relaxed) + 1;
+        entry.generation.store(generation, std::memory_order_release);
+        num_objects.fetch_add(1, std::memory_order_relaxed);
+        return ConcurrentSlotId{index, generation};
+    }
+
+    /// Returns the object of id, or null when it has been erased.
+    [[nodiscard]] T* Find(ConcurrentSlotId id) noexcept {
+        if (!id || id.index >= next_index.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        Entry& entry = GetEntry(id.index);
+        // Sequentially consistent so that a reader that entered after an erase observes it.
+        if (entry.generation.load(std::memory_order_seq_cst) != id.generation) {
+            return nullptr;
+        }
+        return &entry.object;
+    }
+
+    /// Erases the object of id, returns false when it was already erased. The object is destroyed
+    /// once all readers that were active at the time have left.
+    bool erase(ConcurrentSlotId id) {
+        if (!id) {
+            return false;
+        }
+        Entry& entry = GetEntry(id.index);
+        u32 generation = id.generation;
+        if (!entry.generation.compare_exchange_strong(generation, generation + 1,
+                                                      std::memory_order_seq_cst)) {
+            return false;
+        }
+        num_objects.fetch_sub(1, std::memory_order_relaxed);
+        std::scoped_lock lk{retire_mutex};
+        entry.pending_destroy = true;
+        retired.push_back({id.index, epoch.load(std::memory_order_seq_cst)});
+        ReclaimLocked();
+        return true;
+    }
+
+    /// Destroys the erased objects that no reader can see anymore and recycles their slots.
+    void Reclaim() {
+        std::scoped_lock lk{retire_mutex};
+        ReclaimLocked();
+    }
+
+    [[nodiscard]] size_t size() const noexcept {
+        return num_objects.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct NonTrivialDummy {
+        NonTrivialDummy() noexcept {}
+    };
+
+    struct Entry {
+        Entry() noexcept : dummy{} {}
+        ~Entry() noexcept {}
+
+        /// Odd while the slot holds a live object.
+        std::atomic<u32> generation{};
+        std::atomic<u32> next_free{EndOfList};
+        bool pending_destroy{};
+        union {
+            NonTrivialDummy dummy;
+            T object;
+        };
+    };
+
+    struct Retired {
+        u32 index;
+        u32 epoch;
+    };
+
+    static constexpr bool IsAlive(u32 generation) noexcept {
+        return (generation & 1) != 0;
+    }
+
+    Entry& GetEntry(u32 index) noexcept {
+        Entry* const chunk = chunks[index >> ChunkBits].load(std::memory_order_acquire);
+        return chunk[index & (ChunkSize - 1)];
+    }
+
+    u32 AllocateIndex() {
+        // The free list head packs the first free index with a tag that changes on every pop,
+        // so a concurrent pop and push of the same index can not corrupt the list.
+        u64 head = free_head.load(std::memory_order_acquire);
+        while (static_cast<u32>(head) != EndOfList) {
+            const u32 index = static_cast<u32>(head);
+            const u32 next_free = GetEntry(index).next_free.load(std::memory_order_relaxed);
+            const u64 next = ((head & ~u64(EndOfList)) + (u64(1) << 32)) | next_free;
+            if (free_head.compare_exchange_weak(head, next, std::memory_order_acq_rel)) {
+                return index;
+            }
+        }
+        const u32 index = next_index.load(std::memory_order_relaxed);
+        const u32 chunk = index >> ChunkBits;
+        ASSERT_MSG(chunk < MaxChunks, "Concurrent slot vector is full");
+        if (!chunks[chunk].load(std::memory_order_acquire)) {
+            Entry* expected = nullptr;
+            Entry* const new_chunk = new Entry[ChunkSize];
+            if (!chunks[chunk].compare_exchange_strong(expected, new_chunk,
+                                                       std::memory_order_acq_rel)) {
+                delete[] new_chunk;
+            }
+        }
+        // Claim the index only after its chunk exists, readers bound their lookups by it.
+        u32 claimed = index;
+        if (next_index.compare_exchange_strong(claimed, index + 1, std::memory_order_acq_rel)) {
+            return index;
+        }
+        return AllocateIndex();
+    }
+
+    void PushFree(u32 index) noexcept {
+        Entry& entry = GetEntry(index);
+        u64 head = free_head.load(std::memory_order_relaxed);
+        do {
+            entry.next_free.store(static_cast<u32>(head), std::memory_order_relaxed);
+        } while (!free_head.compare_exchange_weak(head, (head & ~u64(EndOfList)) | index,
+                                                  std::memory_order_acq_rel));
+    }
+
+    u32 EnterRead() noexcept {
+        while (true) {
+            const u32 current = epoch.load(std::memory_order_seq_cst);
+            readers[current & 1].fetch_add(1, std::memory_order_seq_cst);
+            if (epoch.load(std::memory_order_seq_cst) == current) {
+                return current;
+            }
+            readers[current & 1].fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    void ExitRead(u32 read_epoch) noexcept {
+        readers[read_epoch & 1].fetch_sub(1, std::memory_order_seq_cst);
+    }
+
+    void ReclaimLocked() {
+        // A slot retired in some epoch is safe once the epoch has advanced twice, as each step
+        // waits for the readers of the epoch before it to leave.
+        for (u32 step = 0; step < 2; ++step) {
+            const u32 current = epoch.load(std::memory_order_seq_cst);
+            if (readers[(current - 1) & 1].load(std::memory_order_seq_cst) != 0) {
+                break;
+            }
+            epoch.store(current + 1, std::memory_order_seq_cst);
+        }
+        const u32 current = epoch.load(std::memory_order_seq_cst);
+        std::erase_if(retired, [&](const Retired& item) {
+            if (current - item.epoch < 2) {
+                return false;
+            }
+            Entry& entry = GetEntry(item.index);
+            entry.object.~T();
+            entry.pending_destroy = false;
+            PushFree(item.index);
+            return true;
+        });
+    }
+
+    std::array<std::atomic<Entry*>, MaxChunks> chunks{};
+    std::atomic<u32> next_index{};
+    std::atomic<u64> free_head{EndOfList};
+    std::atomic<size_t> num_objects{};
+
+    std::atomic<u32> epoch{1};
+    std::array<std::atomic<u32>, 2> readers{};
+    std::mutex retire_mutex;
+    std::vector<Retired> retired;
+};
+
+} // namespace Common
+
+template <>
+struct std::hash<Common::ConcurrentSlotId> {
+    std::size_t operator()(const Common::ConcurrentSlotId& id) const noexcept {
+        return std::hash<u64>{}((u64(id.generation) << 32) | id.index);
+    }
+};
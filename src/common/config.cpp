@@ -1,7 +1,11 @@
 // SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <atomic>
+#include <forward_list>
 #include <fstream>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <fmt/core.h>
@@ -77,8 +81,11 @@ namespace Config {
 
 ConfigMode config_mode = ConfigMode::Default;
 
+static void PublishSnapshot();
+
 void setConfigMode(ConfigMode mode) {
     config_mode = mode;
+    PublishSnapshot();
 }
 
 template <typename T>
@@ -138,11 +145,22 @@ static ConfigEntry<bool> isTrophyPopupDisabled(false);
 static ConfigEntry<double> trophyNotificationDuration(6.0);
 static ConfigEntry<string> logFilter("");
 static ConfigEntry<string> logType("sync");
+static ConfigEntry<bool> logCompression(false);
+static ConfigEntry<int> logMaxFileSize(100);
+static ConfigEntry<int> logMaxFiles(0);
+static ConfigEntry<int> logRotationInterval(0);
+static ConfigEntry<int> logMemoryBufferSize(0);
 static ConfigEntry<string> userName("shadPS4");
 static ConfigEntry<string> chooseHomeTab("General");
 static ConfigEntry<bool> isShowSplash(false);
 static ConfigEntry<string> isSideTrophy("right");
 static ConfigEntry<bool> isConnectedToNetwork(false);
+static ConfigEntry<bool> mappedFileReadsEnabled(true);
+static ConfigEntry<bool> hugePageBacking(false);
+static ConfigEntry<bool> threadPriorityMapping(false);
+static ConfigEntry<bool> threadAffinityMapping(false);
+static ConfigEntry<string> hostCpuCores("");
+static ConfigEntry<bool> lazySymbolBinding(true);
 static bool enableDiscordRPC = false;
 static bool checkCompatibilityOnStartup = false;
 static bool compatibilityData = false;
@@ -162,6 +180,9 @@ static ConfigEntry<bool> backgroundControllerInput(false);
 static ConfigEntry<string> micDevice("Default Device");
 static ConfigEntry<string> mainOutputDevice("Default Device");
 static ConfigEntry<string> padSpkOutputDevice("Default Device");
+static ConfigEntry<string> audioBackend("SDL");
+static ConfigEntry<u32> audioPeriodFrames(0);
+static ConfigEntry<bool> audio3dHrtf(false);
 
 // GPU
 static ConfigEntry<u32> windowWidth(1280);
@@ -172,16 +193,34 @@ static ConfigEntry<bool> isNullGpu(false);
 static ConfigEntry<bool> shouldCopyGPUBuffers(false);
 static ConfigEntry<bool> readbacksEnabled(false);
 static ConfigEntry<bool> readbackLinearImagesEnabled(false);
+static ConfigEntry<bool> predictiveReadbacksEnabled(false);
 static ConfigEntry<bool> directMemoryAccessEnabled(false);
 static ConfigEntry<bool> shouldDumpShaders(false);
 static ConfigEntry<bool> shouldPatchShaders(false);
+static ConfigEntry<bool> pipelineCacheEnabled(true);
+static ConfigEntry<bool> asyncPipelineCompileEnabled(false);
+static ConfigEntry<bool> pipelineWarmupEnabled(true);
+static ConfigEntry<bool> pm4PreParseEnabled(false);
+static ConfigEntry<string> pageTracking("signal");
+static ConfigEntry<bool> asyncTransferEnabled(false);
+static ConfigEntry<bool> descriptorBufferEnabled(false);
+static ConfigEntry<bool> bindlessTexturesEnabled(false);
+static ConfigEntry<bool> drawBatchingEnabled(false);
+static ConfigEntry<bool> asyncComputeEnabled(false);
+static ConfigEntry<string> spirvOptPasses("");
+static ConfigEntry<string> fp64Mode("exact");
+static ConfigEntry<string> videoHwAccel("auto");
+static ConfigEntry<bool> videoGpuConversion(false);
 static ConfigEntry<u32> vblankFrequency(60);
+static ConfigEntry<u32> framesInFlight(3);
 static ConfigEntry<bool> isFullscreen(false);
 static ConfigEntry<string> fullscreenMode("Windowed");
 static ConfigEntry<string> presentMode("Mailbox");
+static ConfigEntry<bool> lowLatencyMode(false);
 static ConfigEntry<bool> isHDRAllowed(false);
 static ConfigEntry<bool> fsrEnabled(true);
 static ConfigEntry<bool> rcasEnabled(true);
+static ConfigEntry<bool> frameInterpolationEnabled(false);
 static ConfigEntry<int> rcasAttenuation(250);
 
 // Vulkan
@@ -198,6 +237,8 @@ static ConfigEntry<bool> rdocEnable(false);
 // Debug
 static ConfigEntry<bool> isDebugDump(false);
 static ConfigEntry<bool> isShaderDebug(false);
+static ConfigEntry<bool> isShaderProfiling(false);
+static ConfigEntry<bool> isGpuProfiling(false);
 static ConfigEntry<bool> isSeparateLogFilesEnabled(false);
 static ConfigEntry<bool> isFpsColor(true);
 static ConfigEntry<bool> logEnabled(true);
@@ -325,6 +366,10 @@ std::string getPresentMode() {
     return presentMode.get();
 }
 
+bool isLowLatencyModeEnabled() {
+    return lowLatencyMode.get();
+}
+
 bool getisTrophyPopupDisabled() {
     return isTrophyPopupDisabled.get();
 }
@@ -353,6 +398,18 @@ std::string getPadSpkOutputDevice() {
     return padSpkOutputDevice.get();
 }
 
+std::string getAudioBackend() {
+    return audioBackend.get();
+}
+
+u32 getAudioPeriodFrames() {
+    return audioPeriodFrames.get();
+}
+
+bool isAudio3dHrtfEnabled() {
+    return audio3dHrtf.get();
+}
+
 double getTrophyNotificationDuration() {
     return trophyNotificationDuration.get();
 }
@@ -385,6 +442,26 @@ string getLogType() {
     return logType.get();
 }
 
+bool getLogCompression() {
+    return logCompression.get();
+}
+
+int getLogMaxFileSize() {
+    return logMaxFileSize.get();
+}
+
+int getLogMaxFiles() {
+    return logMaxFiles.get();
+}
+
+int getLogRotationInterval() {
+    return logRotationInterval.get();
+}
+
+int getLogMemoryBufferSize() {
+    return logMemoryBufferSize.get();
+}
+
 string getUserName() {
     return userName.get();
 }
@@ -413,6 +490,14 @@ bool collectShadersForDebug() {
     return isShaderDebug.get();
 }
 
+bool isShaderProfilingEnabled() {
+    return isShaderProfiling.get();
+}
+
+bool isGpuProfilingEnabled() {
+    return isGpuProfiling.get();
+}
+
 bool showSplash() {
     return isShowSplash.get();
 }
@@ -437,6 +522,10 @@ bool readbackLinearImages() {
     return readbackLinearImagesEnabled.get();
 }
 
+bool predictiveReadbacks() {
+    return predictiveReadbacksEnabled.get();
+}
+
 bool directMemoryAccess() {
     return directMemoryAccessEnabled.get();
 }
@@ -449,6 +538,62 @@ bool patchShaders() {
     return shouldPatchShaders.get();
 }
 
+bool isPipelineCacheEnabled() {
+    return pipelineCacheEnabled.get();
+}
+
+bool isAsyncPipelineCompileEnabled() {
+    return asyncPipelineCompileEnabled.get();
+}
+
+bool isPipelineWarmupEnabled() {
+    return pipelineWarmupEnabled.get();
+}
+
+bool isPm4PreParseEnabled() {
+    return pm4PreParseEnabled.get();
+}
+
+std::string getPageTracking() {
+    return pageTracking.get();
+}
+
+bool isAsyncTransferEnabled() {
+    return asyncTransferEnabled.get();
+}
+
+bool isDescriptorBufferEnabled() {
+    return descriptorBufferEnabled.get();
+}
+
+bool isBindlessTexturesEnabled() {
+    return bindlessTexturesEnabled.get();
+}
+
+bool isDrawBatchingEnabled() {
+    return drawBatchingEnabled.get();
+}
+
+bool isAsyncComputeEnabled() {
+    return asyncComputeEnabled.get();
+}
+
+std::string getSpirvOptPasses() {
+    return spirvOptPasses.get();
+}
+
+std::string getFp64Mode() {
+    return fp64Mode.get();
+}
+
+std::string getVideoHwAccel() {
+    return videoHwAccel.get();
+}
+
+bool isVideoGpuConversionEnabled() {
+    return videoGpuConversion.get();
+}
+
 bool isRdocEnabled() {
     return rdocEnable.get();
 }
@@ -502,10 +647,12 @@ void setVkCrashDiagnosticEnabled(bool enable, bool is_game_specific) {
 
 void setVkHostMarkersEnabled(bool enable, bool is_game_specific) {
     vkHostMarkers.set(enable, is_game_specific);
+    PublishSnapshot();
 }
 
 void setVkGuestMarkersEnabled(bool enable, bool is_game_specific) {
     vkGuestMarkers.set(enable, is_game_specific);
+    PublishSnapshot();
 }
 
 bool getCompatibilityEnabled() {
@@ -524,6 +671,54 @@ void setConnectedToNetwork(bool enable, bool is_game_specific) {
     isConnectedToNetwork.set(enable, is_game_specific);
 }
 
+bool isMappedFileReadsEnabled() {
+    return mappedFileReadsEnabled.get();
+}
+
+void setMappedFileReadsEnabled(bool enable, bool is_game_specific) {
+    mappedFileReadsEnabled.set(enable, is_game_specific);
+}
+
+bool isHugePageBackingEnabled() {
+    return hugePageBacking.get();
+}
+
+void setHugePageBackingEnabled(bool enable, bool is_game_specific) {
+    hugePageBacking.set(enable, is_game_specific);
+}
+
+bool isThreadPriorityMappingEnabled() {
+    return threadPriorityMapping.get();
+}
+
+void setThreadPriorityMappingEnabled(bool enable, bool is_game_specific) {
+    threadPriorityMapping.set(enable, is_game_specific);
+}
+
+bool isThreadAffinityMappingEnabled() {
+    return threadAffinityMapping.get();
+}
+
+void setThreadAffinityMappingEnabled(bool enable, bool is_game_specific) {
+    threadAffinityMapping.set(enable, is_game_specific);
+}
+
+string getHostCpuCores() {
+    return hostCpuCores.get();
+}
+
+void setHostCpuCores(const string& cores, bool is_game_specific) {
+    hostCpuCores.set(cores, is_game_specific);
+}
+
+bool isLazySymbolBindingEnabled() {
+    return lazySymbolBinding.get();
+}
+
+void setLazySymbolBindingEnabled(bool enable, bool is_game_specific) {
+    lazySymbolBinding.set(enable, is_game_specific);
+}
+
 void setGpuId(s32 selectedGpuId, bool is_game_specific) {
     gpuId.set(selectedGpuId, is_game_specific);
 }
@@ -554,6 +749,15 @@ void setLoggingEnabled(bool enable, bool is_game_specific) {
 
 void setCollectShaderForDebug(bool enable, bool is_game_specific) {
     isShaderDebug.set(enable, is_game_specific);
+    PublishSnapshot();
+}
+
+void setShaderProfilingEnabled(bool enable, bool is_game_specific) {
+    isShaderProfiling.set(enable, is_game_specific);
+}
+
+void setGpuProfilingEnabled(bool enable, bool is_game_specific) {
+    isGpuProfiling.set(enable, is_game_specific);
 }
 
 void setShowSplash(bool enable, bool is_game_specific) {
@@ -566,6 +770,7 @@ void setSideTrophy(string side, bool is_game_specific) {
 
 void setNullGpu(bool enable, bool is_game_specific) {
     isNullGpu.set(enable, is_game_specific);
+    PublishSnapshot();
 }
 
 void setAllowHDR(bool enable, bool is_game_specific) {
@@ -578,10 +783,17 @@ void setCopyGPUCmdBuffers(bool enable, bool is_game_specific) {
 
 void setReadbacks(bool enable, bool is_game_specific) {
     readbacksEnabled.set(enable, is_game_specific);
+    PublishSnapshot();
 }
 
 void setReadbackLinearImages(bool enable, bool is_game_specific) {
     readbackLinearImagesEnabled.set(enable, is_game_specific);
+    PublishSnapshot();
+}
+
+void setPredictiveReadbacks(bool enable, bool is_game_specific) {
+    predictiveReadbacksEnabled.set(enable, is_game_specific);
+    PublishSnapshot();
 }
 
 void setDirectMemoryAccess(bool enable, bool is_game_specific) {
@@ -592,6 +804,62 @@ void setDumpShaders(bool enable, bool is_game_specific) {
     shouldDumpShaders.set(enable, is_game_specific);
 }
 
+void setPipelineCacheEnabled(bool enable, bool is_game_specific) {
+    pipelineCacheEnabled.set(enable, is_game_specific);
+}
+
+void setAsyncPipelineCompileEnabled(bool enable, bool is_game_specific) {
+    asyncPipelineCompileEnabled.set(enable, is_game_specific);
+}
+
+void setPipelineWarmupEnabled(bool enable, bool is_game_specific) {
+    pipelineWarmupEnabled.set(enable, is_game_specific);
+}
+
+void setPm4PreParseEnabled(bool enable, bool is_game_specific) {
+    pm4PreParseEnabled.set(enable, is_game_specific);
+}
+
+void setPageTracking(const std::string& backend, bool is_game_specific) {
+    pageTracking.set(backend, is_game_specific);
+}
+
+void setAsyncTransferEnabled(bool enable, bool is_game_specific) {
+    asyncTransferEnabled.set(enable, is_game_specific);
+}
+
+void setDescriptorBufferEnabled(bool enable, bool is_game_specific) {
+    descriptorBufferEnabled.set(enable, is_game_specific);
+}
+
+void setBindlessTexturesEnabled(bool enable, bool is_game_specific) {
+    bindlessTexturesEnabled.set(enable, is_game_specific);
+}
+
+void setDrawBatchingEnabled(bool enable, bool is_game_specific) {
+    drawBatchingEnabled.set(enable, is_game_specific);
+}
+
+void setAsyncComputeEnabled(bool enable, bool is_game_specific) {
+    asyncComputeEnabled.set(enable, is_game_specific);
+}
+
+void setSpirvOptPasses(const std::string& passes, bool is_game_specific) {
+    spirvOptPasses.set(passes, is_game_specific);
+}
+
+void setFp64Mode(const std::string& mode, bool is_game_specific) {
+    fp64Mode.set(mode, is_game_specific);
+}
+
+void setVideoHwAccel(const std::string& device, bool is_game_specific) {
+    videoHwAccel.set(device, is_game_specific);
+}
+
+void setVideoGpuConversionEnabled(bool enable, bool is_game_specific) {
+    videoGpuConversion.set(enable, is_game_specific);
+}
+
 void setVkValidation(bool enable, bool is_game_specific) {
     vkValidation.set(enable, is_game_specific);
 }
@@ -606,6 +874,16 @@ void setRdocEnabled(bool enable, bool is_game_specific) {
 
 void setVblankFreq(u32 value, bool is_game_specific) {
     vblankFrequency.set(value, is_game_specific);
+    PublishSnapshot();
+}
+
+u32 getFramesInFlight() {
+    return std::clamp<u32>(framesInFlight.get(), 1, 3);
+}
+
+void setFramesInFlight(u32 value, bool is_game_specific) {
+    framesInFlight.set(value, is_game_specific);
+    PublishSnapshot();
 }
 
 void setIsFullscreen(bool enable, bool is_game_specific) {
@@ -614,10 +892,16 @@ void setIsFullscreen(bool enable, bool is_game_specific) {
 
 void setFullscreenMode(string mode, bool is_game_specific) {
     fullscreenMode.set(mode, is_game_specific);
+    PublishSnapshot();
 }
 
 void setPresentMode(std::string mode, bool is_game_specific) {
     presentMode.set(mode, is_game_specific);
+    PublishSnapshot();
+}
+
+void setLowLatencyModeEnabled(bool enable, bool is_game_specific) {
+    lowLatencyMode.set(enable, is_game_specific);
 }
 
 void setisTrophyPopupDisabled(bool disable, bool is_game_specific) {
@@ -648,6 +932,18 @@ void setPadSpkOutputDevice(std::string device, bool is_game_specific) {
     padSpkOutputDevice.set(device, is_game_specific);
 }
 
+void setAudioBackend(const std::string& backend, bool is_game_specific) {
+    audioBackend.set(backend, is_game_specific);
+}
+
+void setAudioPeriodFrames(u32 frames, bool is_game_specific) {
+    audioPeriodFrames.set(frames, is_game_specific);
+}
+
+void setAudio3dHrtfEnabled(bool enable, bool is_game_specific) {
+    audio3dHrtf.set(enable, is_game_specific);
+}
+
 void setTrophyNotificationDuration(double newTrophyNotificationDuration, bool is_game_specific) {
     trophyNotificationDuration.set(newTrophyNotificationDuration, is_game_specific);
 }
@@ -666,12 +962,33 @@ void setDevKitConsole(bool enable, bool is_game_specific) {
 
 void setLogType(const string& type, bool is_game_specific) {
     logType.set(type, is_game_specific);
+    PublishSnapshot();
 }
 
 void setLogFilter(const string& type, bool is_game_specific) {
     logFilter.set(type, is_game_specific);
 }
 
+void setLogCompression(bool enable, bool is_game_specific) {
+    logCompression.set(enable, is_game_specific);
+}
+
+void setLogMaxFileSize(int size_mb, bool is_game_specific) {
+    logMaxFileSize.set(size_mb, is_game_specific);
+}
+
+void setLogMaxFiles(int count, bool is_game_specific) {
+    logMaxFiles.set(count, is_game_specific);
+}
+
+void setLogRotationInterval(int minutes, bool is_game_specific) {
+    logRotationInterval.set(minutes, is_game_specific);
+}
+
+void setLogMemoryBufferSize(int size_mb, bool is_game_specific) {
+    logMemoryBufferSize.set(size_mb, is_game_specific);
+}
+
 void setSeparateLogFilesEnabled(bool enabled, bool is_game_specific) {
     isSeparateLogFilesEnabled.set(enabled, is_game_specific);
 }
@@ -686,6 +1003,7 @@ void setChooseHomeTab(const string& type, bool is_game_specific) {
 
 void setUseSpecialPad(bool use) {
     useSpecialPad.base_value = use;
+    PublishSnapshot();
 }
 
 void setSpecialPadClass(int type) {
@@ -825,6 +1143,14 @@ void setRcasEnabled(bool enable, bool is_game_specific) {
     rcasEnabled.set(enable, is_game_specific);
 }
 
+bool getFrameInterpolationEnabled() {
+    return frameInterpolationEnabled.get();
+}
+
+void setFrameInterpolationEnabled(bool enable, bool is_game_specific) {
+    frameInterpolationEnabled.set(enable, is_game_specific);
+}
+
 int getRcasAttenuation() {
     return rcasAttenuation.get();
 }
@@ -871,6 +1197,11 @@ void load(const std::filesystem::path& path, bool is_game_specific) {
         enableDiscordRPC = toml::find_or<bool>(general, "enableDiscordRPC", enableDiscordRPC);
         logFilter.setFromToml(general, "logFilter", is_game_specific);
         logType.setFromToml(general, "logType", is_game_specific);
+        logCompression.setFromToml(general, "logCompression", is_game_specific);
+        logMaxFileSize.setFromToml(general, "logMaxFileSize", is_game_specific);
+        logMaxFiles.setFromToml(general, "logMaxFiles", is_game_specific);
+        logRotationInterval.setFromToml(general, "logRotationInterval", is_game_specific);
+        logMemoryBufferSize.setFromToml(general, "logMemoryBufferSize", is_game_specific);
         userName.setFromToml(general, "userName", is_game_specific);
         isShowSplash.setFromToml(general, "showSplash", is_game_specific);
         isSideTrophy.setFromToml(general, "sideTrophy", is_game_specific);
@@ -879,6 +1210,12 @@ void load(const std::filesystem::path& path, bool is_game_specific) {
                                                           checkCompatibilityOnStartup);
 
         isConnectedToNetwork.setFromToml(general, "isConnectedToNetwork", is_game_specific);
+        mappedFileReadsEnabled.setFromToml(general, "mappedFileReads", is_game_specific);
+        hugePageBacking.setFromToml(general, "hugePageBacking", is_game_specific);
+        threadPriorityMapping.setFromToml(general, "threadPriorityMapping", is_game_specific);
+        threadAffinityMapping.setFromToml(general, "threadAffinityMapping", is_game_specific);
+        hostCpuCores.setFromToml(general, "hostCpuCores", is_game_specific);
+        lazySymbolBinding.setFromToml(general, "lazySymbolBinding", is_game_specific);
         chooseHomeTab.setFromToml(general, "chooseHomeTab", is_game_specific);
         defaultControllerID.setFromToml(general, "defaultControllerID", is_game_specific);
         sys_modules_path = toml::find_fs_path_or(general, "sysModulesPath", sys_modules_path);
@@ -902,6 +1239,9 @@ void load(const std::filesystem::path& path, bool is_game_specific) {
         micDevice.setFromToml(audio, "micDevice", is_game_specific);
         mainOutputDevice.setFromToml(audio, "mainOutputDevice", is_game_specific);
         padSpkOutputDevice.setFromToml(audio, "padSpkOutputDevice", is_game_specific);
+        audioBackend.setFromToml(audio, "audioBackend", is_game_specific);
+        audioPeriodFrames.setFromToml(audio, "audioPeriodFrames", is_game_specific);
+        audio3dHrtf.setFromToml(audio, "audio3dHrtf", is_game_specific);
     }
 
     if (data.contains("GPU")) {
@@ -915,16 +1255,34 @@ void load(const std::filesystem::path& path, bool is_game_specific) {
         shouldCopyGPUBuffers.setFromToml(gpu, "copyGPUBuffers", is_game_specific);
         readbacksEnabled.setFromToml(gpu, "readbacks", is_game_specific);
         readbackLinearImagesEnabled.setFromToml(gpu, "readbackLinearImages", is_game_specific);
+        predictiveReadbacksEnabled.setFromToml(gpu, "predictiveReadbacks", is_game_specific);
         directMemoryAccessEnabled.setFromToml(gpu, "directMemoryAccess", is_game_specific);
         shouldDumpShaders.setFromToml(gpu, "dumpShaders", is_game_specific);
         shouldPatchShaders.setFromToml(gpu, "patchShaders", is_game_specific);
+        pipelineCacheEnabled.setFromToml(gpu, "pipelineCache", is_game_specific);
+        asyncPipelineCompileEnabled.setFromToml(gpu, "asyncPipelineCompile", is_game_specific);
+        pipelineWarmupEnabled.setFromToml(gpu, "pipelineWarmup", is_game_specific);
+        pm4PreParseEnabled.setFromToml(gpu, "pm4PreParse", is_game_specific);
+        pageTracking.setFromToml(gpu, "pageTracking", is_game_specific);
+        asyncTransferEnabled.setFromToml(gpu, "asyncTransfer", is_game_specific);
+        descriptorBufferEnabled.setFromToml(gpu, "descriptorBuffer", is_game_specific);
+        bindlessTexturesEnabled.setFromToml(gpu, "bindlessTextures", is_game_specific);
+        drawBatchingEnabled.setFromToml(gpu, "drawBatching", is_game_specific);
+        asyncComputeEnabled.setFromToml(gpu, "asyncCompute", is_game_specific);
+        spirvOptPasses.setFromToml(gpu, "spirvOptPasses", is_game_specific);
+        fp64Mode.setFromToml(gpu, "fp64Mode", is_game_specific);
+        videoHwAccel.setFromToml(gpu, "videoHwAccel", is_game_specific);
+        videoGpuConversion.setFromToml(gpu, "videoGpuConversion", is_game_specific);
         vblankFrequency.setFromToml(gpu, "vblankFrequency", is_game_specific);
+        framesInFlight.setFromToml(gpu, "framesInFlight", is_game_specific);
         isFullscreen.setFromToml(gpu, "Fullscreen", is_game_specific);
         fullscreenMode.setFromToml(gpu, "FullscreenMode", is_game_specific);
         presentMode.setFromToml(gpu, "presentMode", is_game_specific);
+        lowLatencyMode.setFromToml(gpu, "lowLatencyMode", is_game_specific);
         isHDRAllowed.setFromToml(gpu, "allowHDR", is_game_specific);
         fsrEnabled.setFromToml(gpu, "fsrEnabled", is_game_specific);
         rcasEnabled.setFromToml(gpu, "rcasEnabled", is_game_specific);
+        frameInterpolationEnabled.setFromToml(gpu, "frameInterpolation", is_game_specific);
         rcasAttenuation.setFromToml(gpu, "rcasAttenuation", is_game_specific);
     }
 
@@ -949,6 +1307,8 @@ void load(const std::filesystem::path& path, bool is_game_specific) {
         isDebugDump.setFromToml(debug, "DebugDump", is_game_specific);
         isSeparateLogFilesEnabled.setFromToml(debug, "isSeparateLogFilesEnabled", is_game_specific);
         isShaderDebug.setFromToml(debug, "CollectShader", is_game_specific);
+        isShaderProfiling.setFromToml(debug, "ShaderProfiling", is_game_specific);
+        isGpuProfiling.setFromToml(debug, "GpuProfiling", is_game_specific);
         isFpsColor.setFromToml(debug, "FPSColor", is_game_specific);
         logEnabled.setFromToml(debug, "logEnabled", is_game_specific);
         current_version = toml::find_or<std::string>(debug, "ConfigVersion", current_version);
@@ -999,6 +1359,7 @@ void load(const std::filesystem::path& path, bool is_game_specific) {
     if (config_version != current_version && !is_game_specific) {
         save(path);
     }
+    PublishSnapshot();
 }
 
 void sortTomlSections(toml::ordered_value& data) {
@@ -1061,6 +1422,11 @@ void save(const std::filesystem::path& path, bool is_game_specific) {
                                             is_game_specific);
     logFilter.setTomlValue(data, "General", "logFilter", is_game_specific);
     logType.setTomlValue(data, "General", "logType", is_game_specific);
+    logCompression.setTomlValue(data, "General", "logCompression", is_game_specific);
+    logMaxFileSize.setTomlValue(data, "General", "logMaxFileSize", is_game_specific);
+    logMaxFiles.setTomlValue(data, "General", "logMaxFiles", is_game_specific);
+    logRotationInterval.setTomlValue(data, "General", "logRotationInterval", is_game_specific);
+    logMemoryBufferSize.setTomlValue(data, "General", "logMemoryBufferSize", is_game_specific);
     userName.setTomlValue(data, "General", "userName", is_game_specific);
     chooseHomeTab.setTomlValue(data, "General", "chooseHomeTab", is_game_specific);
     isShowSplash.setTomlValue(data, "General", "showSplash", is_game_specific);
@@ -1072,6 +1438,12 @@ void save(const std::filesystem::path& path, bool is_game_specific) {
     }
     isPSNSignedIn.setTomlValue(data, "General", "isPSNSignedIn", is_game_specific);
     isConnectedToNetwork.setTomlValue(data, "General", "isConnectedToNetwork", is_game_specific);
+    mappedFileReadsEnabled.setTomlValue(data, "General", "mappedFileReads", is_game_specific);
+    hugePageBacking.setTomlValue(data, "General", "hugePageBacking", is_game_specific);
+    threadPriorityMapping.setTomlValue(data, "General", "threadPriorityMapping", is_game_specific);
+    threadAffinityMapping.setTomlValue(data, "General", "threadAffinityMapping", is_game_specific);
+    hostCpuCores.setTomlValue(data, "General", "hostCpuCores", is_game_specific);
+    lazySymbolBinding.setTomlValue(data, "General", "lazySymbolBinding", is_game_specific);
 
     cursorState.setTomlValue(data, "Input", "cursorState", is_game_specific);
     cursorHideTimeout.setTomlValue(data, "Input", "cursorHideTimeout", is_game_specific);
@@ -1083,6 +1455,9 @@ void save(const std::filesystem::path& path, bool is_game_specific) {
     micDevice.setTomlValue(data, "Audio", "micDevice", is_game_specific);
     mainOutputDevice.setTomlValue(data, "Audio", "mainOutputDevice", is_game_specific);
     padSpkOutputDevice.setTomlValue(data, "Audio", "padSpkOutputDevice", is_game_specific);
+    audioBackend.setTomlValue(data, "Audio", "audioBackend", is_game_specific);
+    audioPeriodFrames.setTomlValue(data, "Audio", "audioPeriodFrames", is_game_specific);
+    audio3dHrtf.setTomlValue(data, "Audio", "audio3dHrtf", is_game_specific);
 
     windowWidth.setTomlValue(data, "GPU", "screenWidth", is_game_specific);
     windowHeight.setTomlValue(data, "GPU", "screenHeight", is_game_specific);
@@ -1090,14 +1465,33 @@ void save(const std::filesystem::path& path, bool is_game_specific) {
     shouldCopyGPUBuffers.setTomlValue(data, "GPU", "copyGPUBuffers", is_game_specific);
     readbacksEnabled.setTomlValue(data, "GPU", "readbacks", is_game_specific);
     readbackLinearImagesEnabled.setTomlValue(data, "GPU", "readbackLinearImages", is_game_specific);
+    predictiveReadbacksEnabled.setTomlValue(data, "GPU", "predictiveReadbacks", is_game_specific);
     shouldDumpShaders.setTomlValue(data, "GPU", "dumpShaders", is_game_specific);
+    pipelineCacheEnabled.setTomlValue(data, "GPU", "pipelineCache", is_game_specific);
+    asyncPipelineCompileEnabled.setTomlValue(data, "GPU", "asyncPipelineCompile",
+                                             is_game_specific);
+    pipelineWarmupEnabled.setTomlValue(data, "GPU", "pipelineWarmup", is_game_specific);
+    pm4PreParseEnabled.setTomlValue(data, "GPU", "pm4PreParse", is_game_specific);
+    pageTracking.setTomlValue(data, "GPU", "pageTracking", is_game_specific);
+    asyncTransferEnabled.setTomlValue(data, "GPU", "asyncTransfer", is_game_specific);
+    descriptorBufferEnabled.setTomlValue(data, "GPU", "descriptorBuffer", is_game_specific);
+    bindlessTexturesEnabled.setTomlValue(data, "GPU", "bindlessTextures", is_game_specific);
+    drawBatchingEnabled.setTomlValue(data, "GPU", "drawBatching", is_game_specific);
+    asyncComputeEnabled.setTomlValue(data, "GPU", "asyncCompute", is_game_specific);
+    spirvOptPasses.setTomlValue(data, "GPU", "spirvOptPasses", is_game_specific);
+    fp64Mode.setTomlValue(data, "GPU", "fp64Mode", is_game_specific);
+    videoHwAccel.setTomlValue(data, "GPU", "videoHwAccel", is_game_specific);
+    videoGpuConversion.setTomlValue(data, "GPU", "videoGpuConversion", is_game_specific);
     vblankFrequency.setTomlValue(data, "GPU", "vblankFrequency", is_game_specific);
+    framesInFlight.setTomlValue(data, "GPU", "framesInFlight", is_game_specific);
     isFullscreen.setTomlValue(data, "GPU", "Fullscreen", is_game_specific);
     fullscreenMode.setTomlValue(data, "GPU", "FullscreenMode", is_game_specific);
     presentMode.setTomlValue(data, "GPU", "presentMode", is_game_specific);
+    lowLatencyMode.setTomlValue(data, "GPU", "lowLatencyMode", is_game_specific);
     isHDRAllowed.setTomlValue(data, "GPU", "allowHDR", is_game_specific);
     fsrEnabled.setTomlValue(data, "GPU", "fsrEnabled", is_game_specific);
     rcasEnabled.setTomlValue(data, "GPU", "rcasEnabled", is_game_specific);
+    frameInterpolationEnabled.setTomlValue(data, "GPU", "frameInterpolation", is_game_specific);
     rcasAttenuation.setTomlValue(data, "GPU", "rcasAttenuation", is_game_specific);
     directMemoryAccessEnabled.setTomlValue(data, "GPU", "directMemoryAccess", is_game_specific);
 
@@ -1111,6 +1505,8 @@ void save(const std::filesystem::path& path, bool is_game_specific) {
 
     isDebugDump.setTomlValue(data, "Debug", "DebugDump", is_game_specific);
     isShaderDebug.setTomlValue(data, "Debug", "CollectShader", is_game_specific);
+    isShaderProfiling.setTomlValue(data, "Debug", "ShaderProfiling", is_game_specific);
+    isGpuProfiling.setTomlValue(data, "Debug", "GpuProfiling", is_game_specific);
     isSeparateLogFilesEnabled.setTomlValue(data, "Debug", "isSeparateLogFilesEnabled",
                                            is_game_specific);
     logEnabled.setTomlValue(data, "Debug", "logEnabled", is_game_specific);
@@ -1180,6 +1576,8 @@ void save(const std::filesystem::path& path, bool is_game_specific) {
     std::ofstream file(path, std::ios::binary);
     file << data;
     file.close();
+    // Saving a game specific config drops its values
+    PublishSnapshot();
 }
 
 void setDefaultValues(bool is_game_specific) {
@@ -1189,6 +1587,7 @@ void setDefaultValues(bool is_game_specific) {
     if (is_game_specific) {
         readbacksEnabled.set(false, is_game_specific);
         readbackLinearImagesEnabled.set(false, is_game_specific);
+        predictiveReadbacksEnabled.set(false, is_game_specific);
         isNeo.set(false, is_game_specific);
         isDevKit.set(false, is_game_specific);
         isPSNSignedIn.set(false, is_game_specific);
@@ -1204,10 +1603,21 @@ void setDefaultValues(bool is_game_specific) {
     trophyNotificationDuration.set(6.0, is_game_specific);
     logFilter.set("", is_game_specific);
     logType.set("sync", is_game_specific);
+    logCompression.set(false, is_game_specific);
+    logMaxFileSize.set(100, is_game_specific);
+    logMaxFiles.set(0, is_game_specific);
+    logRotationInterval.set(0, is_game_specific);
+    logMemoryBufferSize.set(0, is_game_specific);
     userName.set("shadPS4", is_game_specific);
     chooseHomeTab.set("General", is_game_specific);
     isShowSplash.set(false, is_game_specific);
     isSideTrophy.set("right", is_game_specific);
+    mappedFileReadsEnabled.set(true, is_game_specific);
+    hugePageBacking.set(false, is_game_specific);
+    threadPriorityMapping.set(false, is_game_specific);
+    threadAffinityMapping.set(false, is_game_specific);
+    hostCpuCores.set("", is_game_specific);
+    lazySymbolBinding.set(true, is_game_specific);
 
     // GS - Input
     cursorState.set(HideCursorState::Idle, is_game_specific);
@@ -1217,6 +1627,9 @@ void setDefaultValues(bool is_game_specific) {
 
     // GS - Audio
     micDevice.set("Default Device", is_game_specific);
+    audioBackend.set("SDL", is_game_specific);
+    audioPeriodFrames.set(0, is_game_specific);
+    audio3dHrtf.set(false, is_game_specific);
 
     // GS - GPU
     windowWidth.set(1280, is_game_specific);
@@ -1224,13 +1637,30 @@ void setDefaultValues(bool is_game_specific) {
     isNullGpu.set(false, is_game_specific);
     shouldCopyGPUBuffers.set(false, is_game_specific);
     shouldDumpShaders.set(false, is_game_specific);
+    pipelineCacheEnabled.set(true, is_game_specific);
+    asyncPipelineCompileEnabled.set(false, is_game_specific);
+    pipelineWarmupEnabled.set(true, is_game_specific);
+    pm4PreParseEnabled.set(false, is_game_specific);
+    pageTracking.set("signal", is_game_specific);
+    asyncTransferEnabled.set(false, is_game_specific);
+    descriptorBufferEnabled.set(false, is_game_specific);
+    bindlessTexturesEnabled.set(false, is_game_specific);
+    drawBatchingEnabled.set(false, is_game_specific);
+    asyncComputeEnabled.set(false, is_game_specific);
+    spirvOptPasses.set("", is_game_specific);
+    fp64Mode.set("exact", is_game_specific);
+    videoHwAccel.set("auto", is_game_specific);
+    videoGpuConversion.set(false, is_game_specific);
     vblankFrequency.set(60, is_game_specific);
+    framesInFlight.set(3, is_game_specific);
     isFullscreen.set(false, is_game_specific);
     fullscreenMode.set("Windowed", is_game_specific);
     presentMode.set("Mailbox", is_game_specific);
+    lowLatencyMode.set(false, is_game_specific);
     isHDRAllowed.set(false, is_game_specific);
     fsrEnabled.set(true, is_game_specific);
     rcasEnabled.set(true, is_game_specific);
+    frameInterpolationEnabled.set(false, is_game_specific);
     rcasAttenuation.set(250, is_game_specific);
 
     // GS - Vulkan
@@ -1247,6 +1677,8 @@ void setDefaultValues(bool is_game_specific) {
     // GS - Debug
     isDebugDump.set(false, is_game_specific);
     isShaderDebug.set(false, is_game_specific);
+    isShaderProfiling.set(false, is_game_specific);
+    isGpuProfiling.set(false, is_game_specific);
     isSeparateLogFilesEnabled.set(false, is_game_specific);
     logEnabled.set(true, is_game_specific);
 
@@ -1284,6 +1716,7 @@ void setDefaultValues(bool is_game_specific) {
         // Debug
         isFpsColor.base_value = true;
     }
+    PublishSnapshot();
 }
 
 constexpr std::string_view GetDefaultGlobalConfig() {
@@ -1428,4 +1861,48 @@ void resetGameSpecificValue(std::string entry) {
     }
 }
 
+static Snapshot MakeSnapshot() {
+    const auto log_type = logType.get();
+    const auto present_mode = presentMode.get();
+    const auto fullscreen_mode = fullscreenMode.get();
+    return Snapshot{
+        .log_type = log_type == "binary"  ? LogType::Binary
+                    : log_type == "async" ? LogType::Async
+                                          : LogType::Sync,
+        .present_mode = present_mode == "Auto"        ? PresentMode::Auto
+                        : present_mode == "Fifo"      ? PresentMode::Fifo
+                        : present_mode == "Immediate" ? PresentMode::Immediate
+                                                      : PresentMode::Mailbox,
+        .fullscreen_mode = fullscreen_mode == "Fullscreen" ? FullscreenMode::Fullscreen
+                           : fullscreen_mode == "Windowed" ? FullscreenMode::Windowed
+                                                           : FullscreenMode::Borderless,
+        .vblank_freq = std::max<u32>(vblankFrequency.get(), 60),
+        .frames_in_flight = std::clamp<u32>(framesInFlight.get(), 1, 3),
+        .null_gpu = isNullGpu.get(),
+        .readbacks = readbacksEnabled.get(),
+        .readback_linear_images = readbackLinearImagesEnabled.get(),
+        .predictive_readbacks = predictiveReadbacksEnabled.get(),
+        .collect_shaders_for_debug = isShaderDebug.get(),
+        .vk_host_markers = vkHostMarkers.get(),
+        .vk_guest_markers = vkGuestMarkers.get(),
+        .fps_color = isFpsColor.get(),
+        .use_special_pad = useSpecialPad.get(),
+    };
+}
+
+static const Snapshot default_snapshot = MakeSnapshot();
+static std::atomic<const Snapshot*> current_snapshot{&default_snapshot};
+static std::mutex snapshot_mutex;
+static std::forward_list<Snapshot> published_snapshots;
+
+static void PublishSnapshot() {
+    std::scoped_lock lk{snapshot_mutex};
+    const auto& snapshot = published_snapshots.emplace_front(MakeSnapshot());
+    current_snapshot.store(&snapshot, std::memory_order_release);
+}
+
+const Snapshot& GetSnapshot() {
+    return *current_snapshot.load(std::memory_order_acquire);
+}
+
 } // namespace Config
@@ -23,6 +23,35 @@ struct GameInstallDir {
 
 enum HideCursorState : int { Never, Idle, Always };
 
+enum class LogType : u8 { Sync, Async, Binary };
+enum class PresentMode : u8 { Mailbox, Fifo, Immediate, Auto };
+enum class FullscreenMode : u8 { Windowed, Borderless, Fullscreen };
+
+/**
+ * Immutable copy of the settings read on hot paths, with string settings parsed into enums. A new
+ * snapshot is published when the configuration is loaded, reset or one of these settings is set.
+ * Snapshots are never freed, so a reference stays valid after a newer one is published.
+ */
+struct Snapshot {
+    LogType log_type;
+    PresentMode present_mode;
+    FullscreenMode fullscreen_mode;
+    u32 vblank_freq;
+    u32 frames_in_flight;
+    bool null_gpu;
+    bool readbacks;
+    bool readback_linear_images;
+    bool predictive_readbacks;
+    bool collect_shaders_for_debug;
+    bool vk_host_markers;
+    bool vk_guest_markers;
+    bool fps_color;
+    bool use_special_pad;
+};
+
+// Current snapshot, reading it is a single atomic load
+const Snapshot& GetSnapshot();
+
 void load(const std::filesystem::path& path, bool is_game_specific = false);
 void save(const std::filesystem::path& path, bool is_game_specific = false);
 void resetGameSpecificValue(std::string entry);
@@ -37,6 +66,8 @@ std::string getFullscreenMode();
 void setFullscreenMode(std::string mode, bool is_game_specific = false);
 std::string getPresentMode();
 void setPresentMode(std::string mode, bool is_game_specific = false);
+bool isLowLatencyModeEnabled();
+void setLowLatencyModeEnabled(bool enable, bool is_game_specific = false);
 u32 getWindowWidth();
 u32 getWindowHeight();
 void setWindowWidth(u32 width, bool is_game_specific = false);
@@ -53,6 +84,10 @@ bool allowHDR();
 void setAllowHDR(bool enable, bool is_game_specific = false);
 bool collectShadersForDebug();
 void setCollectShaderForDebug(bool enable, bool is_game_specific = false);
+bool isShaderProfilingEnabled();
+void setShaderProfilingEnabled(bool enable, bool is_game_specific = false);
+bool isGpuProfilingEnabled();
+void setGpuProfilingEnabled(bool enable, bool is_game_specific = false);
 bool showSplash();
 void setShowSplash(bool enable, bool is_game_specific = false);
 std::string sideTrophy();
@@ -65,12 +100,45 @@ bool readbacks();
 void setReadbacks(bool enable, bool is_game_specific = false);
 bool readbackLinearImages();
 void setReadbackLinearImages(bool enable, bool is_game_specific = false);
+bool predictiveReadbacks();
+void setPredictiveReadbacks(bool enable, bool is_game_specific = false);
 bool directMemoryAccess();
 void setDirectMemoryAccess(bool enable, bool is_game_specific = false);
 bool dumpShaders();
 void setDumpShaders(bool enable, bool is_game_specific = false);
+bool isPipelineCacheEnabled();
+void setPipelineCacheEnabled(bool enable, bool is_game_specific = false);
+bool isAsyncPipelineCompileEnabled();
+void setAsyncPipelineCompileEnabled(bool enable, bool is_game_specific = false);
+bool isPipelineWarmupEnabled();
+void setPipelineWarmupEnabled(bool enable, bool is_game_specific = false);
+bool isPm4PreParseEnabled();
+void setPm4PreParseEnabled(bool enable, bool is_game_specific = false);
+std::string getPageTracking();
+void setPageTracking(const std::string& backend, bool is_game_specific = false);
+bool isAsyncTransferEnabled();
+void setAsyncTransferEnabled(bool enable, bool is_game_specific = false);
+bool isDescriptorBufferEnabled();
+void setDescriptorBufferEnabled(bool enable, bool is_game_specific = false);
+bool isBindlessTexturesEnabled();
+void setBindlessTexturesEnabled(bool enable, bool is_game_specific = false);
+bool isDrawBatchingEnabled();
+void setDrawBatchingEnabled(bool enable, bool is_game_specific = false);
+bool isAsyncComputeEnabled();
+void setAsyncComputeEnabled(bool enable, bool is_game_specific = false);
+std::string getSpirvOptPasses();
+void setSpirvOptPasses(const std::string& passes, bool is_game_specific = false);
+std::string getFp64Mode();
+void setFp64Mode(const std::string& mode, bool is_game_specific = false);
+std::string getVideoHwAccel();
+void setVideoHwAccel(const std::string& device, bool is_game_specific = false);
+bool isVideoGpuConversionEnabled();
+void setVideoGpuConversionEnabled(bool enable, bool is_game_specific = false);
 u32 vblankFreq();
 void setVblankFreq(u32 value, bool is_game_specific = false);
+// Guest frames the renderer may queue to the GPU before waiting on the oldest one, 1 to 3.
+u32 getFramesInFlight();
+void setFramesInFlight(u32 value, bool is_game_specific = false);
 bool getisTrophyPopupDisabled();
 void setisTrophyPopupDisabled(bool disable, bool is_game_specific = false);
 s16 getCursorState();
@@ -93,6 +161,16 @@ std::string getLogType();
 void setLogType(const std::string& type, bool is_game_specific = false);
 std::string getLogFilter();
 void setLogFilter(const std::string& type, bool is_game_specific = false);
+bool getLogCompression();
+void setLogCompression(bool enable, bool is_game_specific = false);
+int getLogMaxFileSize();
+void setLogMaxFileSize(int size_mb, bool is_game_specific = false);
+int getLogMaxFiles();
+void setLogMaxFiles(int count, bool is_game_specific = false);
+int getLogRotationInterval();
+void setLogRotationInterval(int minutes, bool is_game_specific = false);
+int getLogMemoryBufferSize();
+void setLogMemoryBufferSize(int size_mb, bool is_game_specific = false);
 double getTrophyNotificationDuration();
 void setTrophyNotificationDuration(double newTrophyNotificationDuration,
                                    bool is_game_specific = false);
@@ -102,6 +180,12 @@ std::string getMainOutputDevice();
 void setMainOutputDevice(std::string device);
 std::string getPadSpkOutputDevice();
 void setPadSpkOutputDevice(std::string device);
+std::string getAudioBackend();
+void setAudioBackend(const std::string& backend, bool is_game_specific = false);
+u32 getAudioPeriodFrames();
+void setAudioPeriodFrames(u32 frames, bool is_game_specific = false);
+bool isAudio3dHrtfEnabled();
+void setAudio3dHrtfEnabled(bool enable, bool is_game_specific = false);
 std::string getMicDevice();
 void setCursorHideTimeout(int newcursorHideTimeout, bool is_game_specific = false);
 void setMicDevice(std::string device, bool is_game_specific = false);
@@ -138,10 +222,24 @@ bool getFsrEnabled();
 void setFsrEnabled(bool enable, bool is_game_specific = false);
 bool getRcasEnabled();
 void setRcasEnabled(bool enable, bool is_game_specific = false);
+bool getFrameInterpolationEnabled();
+void setFrameInterpolationEnabled(bool enable, bool is_game_specific = false);
 int getRcasAttenuation();
 void setRcasAttenuation(int value, bool is_game_specific = false);
 bool getIsConnectedToNetwork();
 void setConnectedToNetwork(bool enable, bool is_game_specific = false);
+bool isMappedFileReadsEnabled();
+void setMappedFileReadsEnabled(bool enable, bool is_game_specific = false);
+bool isHugePageBackingEnabled();
+void setHugePageBackingEnabled(bool enable, bool is_game_specific = false);
+bool isThreadPriorityMappingEnabled();
+void setThreadPriorityMappingEnabled(bool enable, bool is_game_specific = false);
+bool isThreadAffinityMappingEnabled();
+void setThreadAffinityMappingEnabled(bool enable, bool is_game_specific = false);
+std::string getHostCpuCores();
+void setHostCpuCores(const std::string& cores, bool is_game_specific = false);
+bool isLazySymbolBindingEnabled();
+void setLazySymbolBindingEnabled(bool enable, bool is_game_specific = false);
 void setUserName(const std::string& name, bool is_game_specific = false);
 void setChooseHomeTab(const std::string& type, bool is_game_specific = false);
 std::filesystem::path getSysModulesPath();
@@ -64,6 +64,26 @@ enum MarkersPalette : int {
 
 #define FRAME_END FrameMark
 
+// Fine grained instrumentation, only compiled in with ENABLE_DETAILED_PROFILING as it adds
+// overhead to every HLE call and lock operation even when no profiler is connected.
+#if defined(ENABLE_DETAILED_PROFILING) && defined(TRACY_ENABLE)
+#define DETAILED_PROFILING 1
+#define DETAILED_TRACE(name, color) ZoneScopedNC(name, color)
+#define DETAILED_TRACE_VALUE(value) ZoneValue(value)
+#define DETAILED_PLOT(name, value) TracyPlot(name, value)
+#define DETAILED_FRAME_MARK(name) FrameMarkNamed(name)
+#define PROFILED_MUTEX(type, varname) TracyLockable(type, varname)
+#define PROFILED_SHARED_MUTEX(type, varname) TracySharedLockable(type, varname)
+#else
+#define DETAILED_PROFILING 0
+#define DETAILED_TRACE(name, color)
+#define DETAILED_TRACE_VALUE(value)
+#define DETAILED_PLOT(name, value)
+#define DETAILED_FRAME_MARK(name)
+#define PROFILED_MUTEX(type, varname) type varname
+#define PROFILED_SHARED_MUTEX(type, varname) type varname
+#endif
+
 #ifdef TRACY_FIBERS
 #define FIBER_ENTER(name) TracyFiberEnter(name)
 #define FIBER_EXIT TracyFiberLeave
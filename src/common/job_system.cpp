@@ -0,0 +1,187 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <fmt/format.h>
+
+#include "common/job_system.h"
+#include "common/thread.h"
+
+namespace Common {
+
+namespace {
+
+/// Job system and worker index of the current thread, if it is a worker.
+thread_local JobSystem* current_system{};
+thread_local size_t current_worker{};
+
+} // Anonymous namespace
+
+void JobGroup::Wait() {
+    while (!IsDone()) {
+        if (system && system->TryRunOne(JobPriority::FrameCritical)) {
+            continue;
+        }
+        if (const u32 value = pending.load(std::memory_order_acquire); value != 0) {
+            pending.wait(value, std::memory_order_acquire);
+        }
+    }
+    // The job that finished the group may still be scheduling its continuations.
+    std::scoped_lock lk{continuation_mutex};
+}
+
+JobSystem::JobSystem(size_t num_workers) {
+    num_workers = std::max<size_t>(num_workers, 1);
+    workers.reserve(num_workers);
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers.emplace_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < num_workers; ++i) {
+        workers[i]->thread =
+            std::jthread([this, i](std::stop_token token) { WorkerLoop(token, i); });
+    }
+}
+
+JobSystem::~JobSystem() {
+    for (auto& worker : workers) {
+        worker->thread.request_stop();
+    }
+    sleep_cv.notify_all();
+    // Workers steal from each other, so all of them have to stop before any queue goes away.
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+}
+
+JobSystem& JobSystem::Get() {
+    // Half of the host threads are left to the guest, GPU and presentation threads.
+    static JobSystem system{std::clamp<size_t>(std::thread::hardware_concurrency() / 2, 2, 16)};
+    return system;
+}
+
+void JobSystem::Schedule(JobPriority priority, Task task, JobGroup* group) {
+    if (group) {
+        group->system = this;
+        group->pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    size_t index = current_system == this ? current_worker
+                                           : next_worker.fetch_add(1, std::memory_order_relaxed) %
+                                                 workers.size();
+    if (priority == JobPriority::Background && index == 0 && workers.size() > 1) {
+        index = 1;
+    }
+    const auto queue = static_cast<size_t>(priority);
+    {
+        Worker& worker = *workers[index];
+        std::scoped_lock lk{worker.mutex};
+        worker.queues[queue].push_back(Job{std::move(task), group});
+    }
+    {
+        std::scoped_lock lk{sleep_mutex};
+        num_queued[queue].fetch_add(1, std::memory_order_relaxed);
+    }
+    // A single wakeup could land on the first worker, which would not take the job.
+    if (priority == JobPriority::Background) {
+        sleep_cv.notify_all();
+    } else {
+        sleep_cv.notify_one();
+    }
+}
+
+void JobSystem::Then(JobGroup& group, JobPriority priority, Task task) {
+    {
+        std::scoped_lock lk{group.continuation_mutex};
+        if (group.pending.load(std::memory_order_acquire) != 0) {
+            group.continuations.push_back({priority, std::move(task)});
+            return;
+        }
+    }
+    Schedule(priority, std::move(task));
+}
+
+bool JobSystem::TryRunOne(JobPriority max_priority) {
+    const size_t index = current_system == this ? current_worker : 0;
+    Job job;
+    if (!PopJob(index, static_cast<u32>(max_priority), job)) {
+        return false;
+    }
+    Run(job);
+    return true;
+}
+
+void JobSystem::WorkerLoop(std::stop_token token, size_t index) {
+    const std::string name = fmt::format("shadPS4:JobWorker{}", index);
+    SetCurrentThreadName(name.c_str());
+    current_system = this;
+    current_worker = index;
+
+    u32 max_priority = static_cast<u32>(JobPriority::Background);
+    if (index == 0 && workers.size() > 1) {
+        SetCurrentThreadPriority(ThreadPriority::High);
+        max_priority = static_cast<u32>(JobPriority::FrameCritical);
+    }
+    while (!token.stop_requested()) {
+        Job job;
+        if (PopJob(index, max_priority, job)) {
+            Run(job);
+            continue;
+        }
+        std::unique_lock lk{sleep_mutex};
+        CondvarWait(sleep_cv, lk, token, [&] { return HasWork(max_priority); });
+    }
+}
+
+bool JobSystem::PopJob(size_t index, u32 max_priority, Job& job) {
+    for (u32 queue = 0; queue <= max_priority; ++queue) {
+        if (num_queued[queue].load(std::memory_order_relaxed) == 0) {
+            continue;
+        }
+        // Start with the own queue, then steal from the other workers in turn.
+        for (size_t i = 0; i < workers.size(); ++i) {
+            Worker& worker = *workers[(index + i) % workers.size()];
+            std::scoped_lock lk{worker.mutex};
+            auto& jobs = worker.queues[queue];
+            if (jobs.empty()) {
+                continue;
+            }
+            job = std::move(jobs.front());
+            jobs.pop_front();
+            num_queued[queue].fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool JobSystem::HasWork(u32 max_priority) const {
+    for (u32 queue = 0; queue <= max_priority; ++queue) {
+        if (num_queued[queue].load(std::memory_order_relaxed) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::Run(Job& job) {
+    job.task();
+    JobGroup* const group = job.group;
+    if (!group) {
+        return;
+    }
+    std::vector<JobGroup::Continuation> ready;
+    {
+        std::scoped_lock lk{group->continuation_mutex};
+        if (group->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready = std::move(group->continuations);
+            group->continuations.clear();
+            group->pending.notify_all();
+        }
+    }
+    for (auto& continuation : ready) {
+        Schedule(continuation.priority, std::move(continuation.task));
+    }
+}
+
+} // namespace Common
@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/polyfill_thread.h"
+#include "common/types.h"
+#include "common/unique_function.h"
+
+namespace Common {
+
+enum class JobPriority : u32 {
+    /// Work due within an audio period, such as mixing.
+    Realtime,
+    /// Work the next frame waits for, such as shader compiles or detiling.
+    FrameCritical,
+    /// Work nothing waits on, such as scans or backups.
+    Background,
+};
+
+constexpr size_t NumJobPriorities = 3;
+
+class JobSystem;
+
+/**
+ * Counts the jobs scheduled into it. Continuations added with JobSystem::Then are scheduled once
+ * all of them have finished, and Wait runs queued jobs on the calling thread until then.
+ * A group may be reused once it has been waited on.
+ */
+class JobGroup {
+public:
+    JobGroup() = default;
+    ~JobGroup() {
+        Wait();
+    }
+
+    JobGroup(const JobGroup&) = delete;
+    JobGroup& operator=(const JobGroup&) = delete;
+
+    /// Blocks until every job of the group has finished, running queued jobs meanwhile.
+    void Wait();
+
+    [[nodiscard]] bool IsDone() const noexcept {
+        return pending.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+
+    struct Continuation {
+        JobPriority priority;
+        UniqueFunction<void> task;
+    };
+
+    JobSystem* system{};
+    std::atomic<u32> pending{};
+    std::mutex continuation_mutex;
+    std::vector<Continuation> continuations;
+};
+
+/**
+ * Work stealing pool shared by the emulator subsystems. Every worker owns a queue per priority,
+ * jobs scheduled from a worker go to its own queue and other jobs are spread over the workers.
+ * Idle workers steal from the others, always taking the most urgent job available. The first
+ * worker never runs background jobs, so these can not delay realtime or frame critical ones.
+ */
+class JobSystem {
+    using Task = UniqueFunction<void>;
+
+public:
+    explicit JobSystem(size_t num_workers);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /// Returns the shared instance, sized from the host thread count.
+    static JobSystem& Get();
+
+    /// Schedules a job, which is counted into group when one is given.
+    void Schedule(JobPriority priority, Task task, JobGroup* group = nullptr);
+
+    /// Schedules a job once every job of group has finished, right away if it already has.
+    void Then(JobGroup& group, JobPriority priority, Task task);
+
+    /// Runs one queued job of at most max_priority on the calling thread, returns false when
+    /// none was found.
+    bool TryRunOne(JobPriority max_priority = JobPriority::Background);
+
+    [[nodiscard]] size_t NumWorkers() const noexcept {
+        return workers.size();
+    }
+
+private:
+    struct Job {
+        Task task;
+        JobGroup* group{};
+    };
+
+    struct Worker {
+        std::mutex mutex;
+        std::array<std::deque<Job>, NumJobPriorities> queues;
+        std::jthread thread;
+    };
+
+    void WorkerLoop(std::stop_token token, size_t index);
+    bool PopJob(size_t index, u32 max_priority, Job& job);
+    bool HasWork(u32 max_priority) const;
+    void Run(Job& job);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::array<std::atomic<u64>, NumJobPriorities> num_queued{};
+    std::atomic<size_t> next_worker{};
+    std::mutex sleep_mutex;
+    std::condition_variable_any sleep_cv;
+};
+
+} // namespace Common
@@ -1,16 +1,23 @@
 // SPDX-FileCopyrightText: Copyright 2014 Citra Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <array>
 #include <chrono>
+#include <cstring>
 #include <filesystem>
+#include <memory>
+#include <mutex>
 #include <thread>
+#include <vector>
 
 #include <fmt/format.h>
+#include <zlib.h>
 
 #ifdef _WIN32
 #include <windows.h> // For OutputDebugStringW
 #endif
 
+#include "common/alignment.h"
 #include "common/bounded_threadsafe_queue.h"
 #include "common/config.h"
 #include "common/debug.h"
@@ -57,44 +64,197 @@ private:
 };
 
 /**
- * Backend that writes to a file passed into the constructor
+ * Backend that writes to a file passed into the constructor. Messages are buffered and optionally
+ * compressed into a gzip stream. The file is rotated by size or age when backups are kept and
+ * writing stops at the size limit otherwise. With a memory buffer only the most recent messages
+ * are kept, they are written out when a stacktrace is requested.
  */
 class FileBackend {
 public:
     explicit FileBackend(const std::filesystem::path& filename, bool should_append = false)
-        : file{filename, should_append ? FS::FileAccessMode::Append : FS::FileAccessMode::Write,
-               FS::FileType::TextFile} {}
+        : path{filename}, compress{Config::getLogCompression()},
+          max_file_size{static_cast<size_t>(std::max(Config::getLogMaxFileSize(), 1)) * 1_MB},
+          max_files{std::max(Config::getLogMaxFiles(), 0)},
+          rotation_interval{std::max(Config::getLogRotationInterval(), 0)} {
+        if (compress) {
+            path += ".gz";
+        }
+        if (const int memory_size = Config::getLogMemoryBufferSize(); memory_size > 0) {
+            memory_buffer.resize(static_cast<size_t>(memory_size) * 1_MB);
+            return;
+        }
+        Open(should_append);
+    }
 
-    ~FileBackend() = default;
+    ~FileBackend() {
+        Close();
+    }
 
     void Write(const Entry& entry) {
         if (!enabled) {
             return;
         }
 
-        bytes_written += file.WriteString(FormatLogMessage(entry).append(1, '\n'));
+        const auto message = FormatLogMessage(entry).append(1, '\n');
+        if (!memory_buffer.empty()) {
+            WriteToMemory(message);
+            return;
+        }
 
-        // Prevent logs from exceeding a set maximum size in the event that log entries are spammed.
-        const auto write_limit = 100_MB;
-        const bool write_limit_exceeded = bytes_written > write_limit;
-        if (entry.log_level >= Level::Error || write_limit_exceeded) {
-            if (write_limit_exceeded) {
-                // Stop writing after the write limit is exceeded.
-                // Don't close the file so we can print a stacktrace if necessary
-                enabled = false;
-            }
-            file.Flush();
+        buffer.append(message);
+        if (buffer.size() >= BufferSize) {
+            WriteBuffer(false);
+        }
+        if (entry.log_level >= Level::Error) {
+            Flush();
+        }
+
+        const bool write_limit_exceeded = file_size + buffer.size() > max_file_size;
+        const bool rotation_due = rotation_interval.count() > 0 &&
+                                  std::chrono::steady_clock::now() - opened_at >= rotation_interval;
+        if (max_files > 0 && (write_limit_exceeded || rotation_due)) {
+            Rotate();
+        } else if (write_limit_exceeded) {
+            // Prevent logs from exceeding a set maximum size in the event that log entries are
+            // spammed. Don't close the file so we can print a stacktrace if necessary
+            Flush();
+            enabled = false;
         }
     }
 
     void Flush() {
+        if (!file.IsOpen()) {
+            return;
+        }
+        WriteBuffer(true);
         file.Flush();
     }
 
+    void EnableForStacktrace() {
+        if (!memory_buffer.empty()) {
+            DumpMemoryBuffer();
+        }
+        enabled = true;
+    }
+
 private:
+    static constexpr size_t BufferSize = 256_KB;
+
+    void Open(bool should_append) {
+        file.Open(path, should_append ? FS::FileAccessMode::Append : FS::FileAccessMode::Write,
+                  compress ? FS::FileType::BinaryFile : FS::FileType::TextFile);
+        file_size = 0;
+        opened_at = std::chrono::steady_clock::now();
+        if (compress && file.IsOpen()) {
+            // Favor speed, the log thread has to keep up with bursts of messages. An appended
+            // stream starts a new gzip member, which readers continue to decompress.
+            stream = {};
+            deflateInit2(&stream, Z_BEST_SPEED, Z_DEFLATED, MAX_WBITS + 16, 8, Z_DEFAULT_STRATEGY);
+        }
+    }
+
+    void Close() {
+        if (!file.IsOpen()) {
+            return;
+        }
+        WriteBuffer(false);
+        if (compress) {
+            Deflate({}, Z_FINISH);
+            deflateEnd(&stream);
+        }
+        file.Close();
+    }
+
+    /// Writes out the buffered messages, making them readable from the file if sync is set.
+    void WriteBuffer(bool sync) {
+        if (compress) {
+            Deflate(buffer, sync ? Z_SYNC_FLUSH : Z_NO_FLUSH);
+        } else if (!buffer.empty()) {
+            file_size += file.WriteString(buffer);
+        }
+        buffer.clear();
+    }
+
+    void Deflate(std::string_view data, int flush) {
+        stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+        stream.avail_in = static_cast<uInt>(data.size());
+        do {
+            stream.next_out = compressed.data();
+            stream.avail_out = static_cast<uInt>(compressed.size());
+            deflate(&stream, flush);
+            const size_t size = compressed.size() - stream.avail_out;
+            file_size += file.WriteSpan(std::span<const u8>(compressed.data(), size));
+        } while (stream.avail_out == 0);
+    }
+
+    [[nodiscard]] std::filesystem::path RotatedPath(int index) const {
+        auto name = path.filename();
+        auto extension = name.extension();
+        name.replace_extension();
+        if (compress) {
+            extension = name.extension().string() + extension.string();
+            name.replace_extension();
+        }
+        return path.parent_path() / fmt::format("{}.{}{}", name.string(), index,
+                                                extension.string());
+    }
+
+    /// Moves the current file to the first backup, shifting the older backups and dropping the
+    /// oldest, and starts a new file.
+    void Rotate() {
+        Close();
+        std::error_code ec;
+        std::filesystem::remove(RotatedPath(max_files), ec);
+        for (int index = max_files - 1; index > 0; index--) {
+            std::filesystem::rename(RotatedPath(index), RotatedPath(index + 1), ec);
+        }
+        std::filesystem::rename(path, RotatedPath(1), ec);
+        Open(false);
+    }
+
+    void WriteToMemory(std::string_view message) {
+        const size_t capacity = memory_buffer.size();
+        if (message.size() > capacity) {
+            message = message.substr(message.size() - capacity);
+        }
+        const size_t first = std::min(message.size(), capacity - memory_pos);
+        std::memcpy(memory_buffer.data() + memory_pos, message.data(), first);
+        std::memcpy(memory_buffer.data(), message.data() + first, message.size() - first);
+        memory_wrapped |= memory_pos + message.size() >= capacity;
+        memory_pos = (memory_pos + message.size()) % capacity;
+    }
+
+    /// Writes the messages kept in memory to the file, which then receives messages directly.
+    void DumpMemoryBuffer() {
+        std::string messages;
+        if (memory_wrapped) {
+            messages.assign(memory_buffer.begin() + memory_pos, memory_buffer.end());
+            // The oldest message was partially overwritten.
+            messages.erase(0, messages.find('\n') + 1);
+        }
+        messages.append(memory_buffer.begin(), memory_buffer.begin() + memory_pos);
+        std::vector<char>{}.swap(memory_buffer);
+
+        Open(false);
+        buffer = std::move(messages);
+        Flush();
+    }
+
+    std::filesystem::path path;
     Common::FS::IOFile file;
+    bool compress;
+    size_t max_file_size;
+    int max_files;
+    std::chrono::minutes rotation_interval;
+    std::chrono::steady_clock::time_point opened_at;
     bool enabled = true;
-    std::size_t bytes_written = 0;
+    std::size_t file_size = 0;
+    std::string buffer;
+    z_stream stream{};
+    std::array<u8, 64_KB> compressed{};
+    std::vector<char> memory_buffer;
+    size_t memory_pos{};
+    bool memory_wrapped{};
 };
 
 /**
@@ -117,6 +277,117 @@ public:
     void EnableForStacktrace() {}
 };
 
+/**
+ * Entry of a binary log ring, followed by the arguments of the message. Formatting the arguments
+ * is left to the backend thread.
+ */
+struct BinaryEntryHeader {
+    /// Size of the entry including the header, a multiple of 8 bytes.
+    u32 size;
+    /// Marks the unused end of the ring, the next entry starts at the beginning.
+    u32 is_padding;
+    Class log_class;
+    Level log_level;
+    u32 line_num;
+    const char* filename;
+    const char* function;
+    const char* format;
+    Detail::FormatFn format_fn;
+    std::chrono::steady_clock::time_point timestamp;
+};
+
+/**
+ * Binary log entries of one thread. Only that thread writes and only the backend thread reads,
+ * so entries are passed without locking.
+ */
+class BinaryRing {
+public:
+    static constexpr size_t Capacity = 256_KB;
+
+    BinaryRing() : buffer{std::make_unique<u64[]>(Capacity / sizeof(u64))} {}
+
+    /// Reserves an entry of size bytes, waiting for the backend thread while the ring is full.
+    BinaryEntryHeader* Reserve(u32 size) {
+        while (true) {
+            const u64 write = write_pos.load(std::memory_order_relaxed);
+            const u64 read = read_pos.load(std::memory_order_acquire);
+            const size_t offset = write % Capacity;
+            const size_t padding = Capacity - offset < size ? Capacity - offset : 0;
+            if (Capacity - (write - read) >= size + padding) {
+                if (padding != 0) {
+                    auto* end = At(offset);
+                    end->size = static_cast<u32>(padding);
+                    end->is_padding = 1;
+                }
+                reserved_pos = write + padding + size;
+                auto* header = At((write + padding) % Capacity);
+                header->size = size;
+                header->is_padding = 0;
+                return header;
+            }
+            if (!Detail::binary_logging.load(std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void Commit() {
+        write_pos.store(reserved_pos, std::memory_order_release);
+    }
+
+    /// Returns the oldest entry, or nullptr if the ring is empty.
+    const BinaryEntryHeader* Peek() {
+        while (true) {
+            const u64 read = read_pos.load(std::memory_order_relaxed);
+            if (read == write_pos.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            const auto* header = At(read % Capacity);
+            if (!header->is_padding) {
+                return header;
+            }
+            read_pos.store(read + header->size, std::memory_order_release);
+        }
+    }
+
+    void Pop() {
+        const u64 read = read_pos.load(std::memory_order_relaxed);
+        read_pos.store(read + At(read % Capacity)->size, std::memory_order_release);
+    }
+
+    [[nodiscard]] bool IsEmpty() const {
+        return read_pos.load(std::memory_order_acquire) ==
+               write_pos.load(std::memory_order_acquire);
+    }
+
+private:
+    BinaryEntryHeader* At(size_t offset) const {
+        return reinterpret_cast<BinaryEntryHeader*>(reinterpret_cast<u8*>(buffer.get()) + offset);
+    }
+
+    std::unique_ptr<u64[]> buffer;
+    std::atomic<u64> read_pos{};
+    std::atomic<u64> write_pos{};
+    u64 reserved_pos{};
+};
+
+class Impl;
+
+/// Binary logging state of a thread.
+struct BinaryWriter {
+    const Impl* owner{};
+    std::shared_ptr<BinaryRing> ring;
+    BinaryEntryHeader* entry{};
+    /// Entries too large for the ring are formatted on the calling thread instead.
+    std::vector<u64> overflow;
+    bool is_overflow{};
+};
+
+thread_local BinaryWriter binary_writer;
+
+using Config::LogType;
+
 bool initialization_in_progress_suppress_logging = true;
 
 /**
@@ -175,32 +446,37 @@ public:
 
     void SetGlobalFilter(const Filter& f) {
         filter = f;
+        UpdateClassLevels();
     }
 
     void SetColorConsoleBackendEnabled(bool enabled) {
         color_console_backend.SetEnabled(enabled);
     }
 
+    void EnableForStacktrace() {
+        file_backend.EnableForStacktrace();
+        debugger_backend.EnableForStacktrace();
+    }
+
     void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, std::string message) {
-        // Propagate important log messages to the profiler
-        if (IsProfilerConnected()) {
-            const auto& msg_str = fmt::format("[{}] {}", GetLogClassName(log_class), message);
-            switch (log_level) {
-            case Level::Warning:
-                TRACE_WARN(msg_str);
-                break;
-            case Level::Error:
-                TRACE_ERROR(msg_str);
-                break;
-            case Level::Critical:
-                TRACE_CRIT(msg_str);
-                break;
-            default:
-                break;
+        if (Detail::binary_logging.load(std::memory_order_relaxed)) {
+            // Keep the order of the messages of a thread by passing them through its ring.
+            if (!filter.CheckMessage(log_class, log_level) || !Config::getLoggingEnabled()) {
+                return;
             }
+            u8* payload = ReserveBinaryEntry(log_class, log_level, filename, line_num, function,
+                                             "{}", &Detail::FormatPayload<std::string>,
+                                             Detail::ArgSize(message));
+            if (payload) {
+                Detail::WriteArg(payload, message);
+                EndBinaryEntry();
+            }
+            return;
         }
 
+        TraceMessage(log_class, log_level, message);
+
         if (!filter.CheckMessage(log_class, log_level) || !Config::getLoggingEnabled()) {
             return;
         }
@@ -218,7 +494,7 @@ public:
             .function = function,
             .message = std::move(message),
         };
-        if (Config::getLogType() == "async") {
+        if (log_type == LogType::Async) {
             message_queue.EmplaceWait(entry);
         } else {
             ForEachBackend([&entry](auto& backend) { backend.Write(entry); });
@@ -226,13 +502,167 @@ public:
         }
     }
 
+    u8* BeginBinaryEntry(Class log_class, Level log_level, const char* filename,
+                         unsigned int line_num, const char* function, const char* format,
+                         Detail::FormatFn format_fn, size_t payload_size) {
+        if (!filter.CheckMessage(log_class, log_level) || !Config::getLoggingEnabled()) {
+            return nullptr;
+        }
+        return ReserveBinaryEntry(log_class, log_level, filename, line_num, function, format,
+                                  format_fn, payload_size);
+    }
+
+    void EndBinaryEntry() {
+        auto& writer = binary_writer;
+        if (!writer.is_overflow) {
+            writer.ring->Commit();
+            return;
+        }
+        message_queue.EmplaceWait(MakeEntry(*writer.entry));
+    }
+
 private:
     Impl(const std::filesystem::path& file_backend_filename, const Filter& filter_)
-        : filter{filter_}, file_backend{file_backend_filename, should_append} {}
+        : filter{filter_}, file_backend{file_backend_filename, should_append} {
+        log_type = Config::GetSnapshot().log_type;
+        UpdateClassLevels();
+    }
 
     ~Impl() = default;
 
+    void UpdateClassLevels() const {
+        for (std::size_t i = 0; i < Detail::class_levels.size(); i++) {
+            Detail::class_levels[i].store(filter.GetClassLevel(static_cast<Class>(i)),
+                                          std::memory_order_relaxed);
+        }
+    }
+
+    /// Propagates important log messages to the profiler.
+    static void TraceMessage(Class log_class, Level log_level, const std::string& message) {
+        if (!IsProfilerConnected()) {
+            return;
+        }
+        const auto& msg_str = fmt::format("[{}] {}", GetLogClassName(log_class), message);
+        switch (log_level) {
+        case Level::Warning:
+            TRACE_WARN(msg_str);
+            break;
+        case Level::Error:
+            TRACE_ERROR(msg_str);
+            break;
+        case Level::Critical:
+            TRACE_CRIT(msg_str);
+            break;
+        default:
+            break;
+        }
+    }
+
+    u8* ReserveBinaryEntry(Class log_class, Level log_level, const char* filename,
+                           unsigned int line_num, const char* function, const char* format,
+                           Detail::FormatFn format_fn, size_t payload_size) {
+        auto& writer = binary_writer;
+        const u32 size =
+            static_cast<u32>(Common::AlignUp(sizeof(BinaryEntryHeader) + payload_size, 8));
+        BinaryEntryHeader* header;
+        if (size <= BinaryRing::Capacity / 2) {
+            if (writer.owner != this) {
+                writer.owner = this;
+                writer.ring = std::make_shared<BinaryRing>();
+                std::scoped_lock lock{rings_mutex};
+                rings.push_back(writer.ring);
+            }
+            header = writer.ring->Reserve(size);
+            if (!header) {
+                return nullptr;
+            }
+            writer.is_overflow = false;
+        } else {
+            writer.overflow.resize(size / sizeof(u64));
+            header = reinterpret_cast<BinaryEntryHeader*>(writer.overflow.data());
+            header->size = size;
+            header->is_padding = 0;
+            writer.is_overflow = true;
+        }
+        header->log_class = log_class;
+        header->log_level = log_level;
+        header->line_num = line_num;
+        header->filename = filename;
+        header->function = function;
+        header->format = format;
+        header->format_fn = format_fn;
+        header->timestamp = std::chrono::steady_clock::now();
+        writer.entry = header;
+        return reinterpret_cast<u8*>(header + 1);
+    }
+
+    Entry MakeEntry(const BinaryEntryHeader& header) const {
+        using std::chrono::duration_cast;
+        using std::chrono::microseconds;
+
+        return Entry{
+            .timestamp = duration_cast<microseconds>(header.timestamp - time_origin),
+            .log_class = header.log_class,
+            .log_level = header.log_level,
+            .filename = header.filename,
+            .line_num = header.line_num,
+            .function = header.function,
+            .message =
+                header.format_fn(header.format, reinterpret_cast<const u8*>(&header + 1)),
+        };
+    }
+
+    /// Writes out the pending binary entries of all threads in the order they were logged.
+    bool WriteBinaryEntries() {
+        bool has_written = false;
+        Entry entry;
+        while (message_queue.TryPop(entry)) {
+            TraceMessage(entry.log_class, entry.log_level, entry.message);
+            ForEachBackend([&entry](auto& backend) { backend.Write(entry); });
+            has_written = true;
+        }
+
+        std::scoped_lock lock{rings_mutex};
+        while (true) {
+            BinaryRing* oldest_ring = nullptr;
+            const BinaryEntryHeader* oldest = nullptr;
+            for (const auto& ring : rings) {
+                const auto* header = ring->Peek();
+                if (header && (!oldest || header->timestamp < oldest->timestamp)) {
+                    oldest_ring = ring.get();
+                    oldest = header;
+                }
+            }
+            if (!oldest) {
+                break;
+            }
+            entry = MakeEntry(*oldest);
+            oldest_ring->Pop();
+            TraceMessage(entry.log_class, entry.log_level, entry.message);
+            ForEachBackend([&entry](auto& backend) { backend.Write(entry); });
+            has_written = true;
+        }
+        // Rings of threads that have exited are only referenced here.
+        std::erase_if(rings, [](const auto& ring) {
+            return ring.use_count() == 1 && ring->IsEmpty();
+        });
+        return has_written;
+    }
+
     void StartBackendThread() {
+        if (log_type == LogType::Binary) {
+            Detail::binary_logging = true;
+            backend_thread = std::jthread([this](std::stop_token stop_token) {
+                Common::SetCurrentThreadName("shadPS4:Log");
+                while (!stop_token.stop_requested()) {
+                    if (!WriteBinaryEntries()) {
+                        std::this_thread::sleep_for(BinaryPollInterval);
+                    }
+                }
+                WriteBinaryEntries();
+            });
+            return;
+        }
         backend_thread = std::jthread([this](std::stop_token stop_token) {
             Common::SetCurrentThreadName("shadPS4:Log");
             Entry entry;
@@ -255,6 +685,7 @@ private:
     }
 
     void StopBackendThread() {
+        Detail::binary_logging = false;
         backend_thread.request_stop();
         if (backend_thread.joinable()) {
             backend_thread.join();
@@ -281,7 +712,12 @@ private:
     ColorConsoleBackend color_console_backend{};
     FileBackend file_backend;
 
+    static constexpr auto BinaryPollInterval = std::chrono::milliseconds(1);
+
+    LogType log_type;
     MPSCQueue<Entry> message_queue{};
+    std::mutex rings_mutex;
+    std::vector<std::shared_ptr<BinaryRing>> rings;
     std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
     std::jthread backend_thread;
 };
@@ -320,6 +756,30 @@ void SetAppend() {
     Impl::SetAppend();
 }
 
+void EnableForStacktrace() {
+    if (Impl::IsActive()) {
+        Impl::Instance().EnableForStacktrace();
+    }
+}
+
+namespace Detail {
+
+u8* BeginBinaryEntry(Class log_class, Level log_level, const char* filename,
+                     unsigned int line_num, const char* function, const char* format,
+                     FormatFn format_fn, size_t payload_size) {
+    if (initialization_in_progress_suppress_logging) [[unlikely]] {
+        return nullptr;
+    }
+    return Impl::Instance().BeginBinaryEntry(log_class, log_level, filename, line_num, function,
+                                             format, format_fn, payload_size);
+}
+
+void EndBinaryEntry() {
+    Impl::Instance().EndBinaryEntry();
+}
+
+} // namespace Detail
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
@@ -31,4 +31,8 @@ void SetColorConsoleBackendEnabled(bool enabled);
 
 void SetAppend();
 
+/// Writes out the messages kept in memory and resumes file logging after the size limit, so that
+/// the cause of a crash ends up in the log. Call it after the logger thread has been stopped.
+void EnableForStacktrace();
+
 } // namespace Common::Log
@@ -53,6 +53,11 @@ public:
      */
     void ParseFilterString(std::string_view filter_view);
 
+    /// Returns the minimum displayed level of `log_class`.
+    Level GetClassLevel(Class log_class) const {
+        return class_levels[static_cast<std::size_t>(log_class)];
+    }
+
     /// Matches class/level combination against the filter, returning true if it passed.
     bool CheckMessage(Class log_class, Level level) const;
 
@@ -5,7 +5,12 @@
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstring>
+#include <string>
 #include <string_view>
+#include <tuple>
+#include <type_traits>
 
 #include "common/logging/formatter.h"
 #include "common/logging/types.h"
@@ -25,46 +30,175 @@ void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args);
 
+namespace Detail {
+
+/// Set while the backend thread formats binary entries, see the "binary" log type.
+inline std::atomic_bool binary_logging{false};
+
+/// Minimum level of every class mirrored from the global filter, checked before the arguments of
+/// a message are evaluated.
+inline std::array<std::atomic<Level>, static_cast<std::size_t>(Class::Count)> class_levels{};
+
+[[nodiscard]] inline bool IsLevelEnabled(Class log_class, Level log_level) {
+    return log_level >=
+           class_levels[static_cast<std::size_t>(log_class)].load(std::memory_order_relaxed);
+}
+
+/// Formats the arguments stored in the payload of a binary entry.
+using FormatFn = std::string (*)(const char* format, const u8* payload);
+
+/**
+ * Reserves an entry with payload_size bytes of arguments in the log ring of the calling thread.
+ * Returns the payload, or nullptr when the message is filtered out.
+ */
+u8* BeginBinaryEntry(Class log_class, Level log_level, const char* filename,
+                     unsigned int line_num, const char* function, const char* format,
+                     FormatFn format_fn, size_t payload_size);
+
+/// Publishes the entry last reserved by the calling thread to the backend thread.
+void EndBinaryEntry();
+
+template <typename T>
+constexpr bool IsStringArg =
+    std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view> ||
+    std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+    (std::is_array_v<T> && std::is_same_v<std::remove_cv_t<std::remove_extent_t<T>>, char>);
+
+/// Arguments that binary entries store by value, anything else is formatted at the call site.
+template <typename T>
+constexpr bool IsDeferrableArg = std::is_arithmetic_v<T> || std::is_enum_v<T> ||
+                                 std::is_same_v<T, const void*> || std::is_same_v<T, void*> ||
+                                 IsStringArg<T>;
+
+template <typename T>
+using StoredArg = std::conditional_t<IsStringArg<T>, std::string_view, T>;
+
+template <typename T>
+std::string_view ToStringArg(const T& arg) {
+    if constexpr (std::is_pointer_v<T>) {
+        return arg ? std::string_view{arg} : std::string_view{};
+    } else {
+        return std::string_view{arg};
+    }
+}
+
+template <typename T>
+size_t ArgSize(const T& arg) {
+    if constexpr (IsStringArg<T>) {
+        return sizeof(u32) + ToStringArg(arg).size();
+    } else {
+        return sizeof(T);
+    }
+}
+
+/// Strings are stored as their length followed by the characters, other arguments as is.
+template <typename T>
+u8* WriteArg(u8* dst, const T& arg) {
+    if constexpr (IsStringArg<T>) {
+        const auto view = ToStringArg(arg);
+        const u32 size = static_cast<u32>(view.size());
+        std::memcpy(dst, &size, sizeof(size));
+        std::memcpy(dst + sizeof(size), view.data(), size);
+        return dst + sizeof(size) + size;
+    } else {
+        std::memcpy(dst, &arg, sizeof(T));
+        return dst + sizeof(T);
+    }
+}
+
+template <typename T>
+const u8* ReadArg(const u8* src, T& arg) {
+    if constexpr (std::is_same_v<T, std::string_view>) {
+        u32 size;
+        std::memcpy(&size, src, sizeof(size));
+        arg = std::string_view{reinterpret_cast<const char*>(src + sizeof(size)), size};
+        return src + sizeof(size) + size;
+    } else {
+        std::memcpy(&arg, src, sizeof(T));
+        return src + sizeof(T);
+    }
+}
+
+template <typename... Args>
+std::string FormatPayload(const char* format, const u8* payload) {
+    std::tuple<StoredArg<Args>...> values;
+    std::apply([&payload](auto&... value) { ((payload = ReadArg(payload, value)), ...); },
+               values);
+    return std::apply(
+        [format](const auto&... value) {
+            return fmt::vformat(format, fmt::make_format_args(value...));
+        },
+        values);
+}
+
+} // namespace Detail
+
 template <typename... Args>
 void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsigned int line_num,
                    const char* function, const char* format, const Args&... args) {
+    if constexpr ((Detail::IsDeferrableArg<Args> && ...)) {
+        if (Detail::binary_logging.load(std::memory_order_relaxed)) {
+            // The arguments are copied and formatted later by the backend thread.
+            const size_t payload_size = (size_t{0} + ... + Detail::ArgSize(args));
+            u8* payload =
+                Detail::BeginBinaryEntry(log_class, log_level, filename, line_num, function,
+                                         format, &Detail::FormatPayload<Args...>, payload_size);
+            if (payload) {
+                ((payload = Detail::WriteArg(payload, args)), ...);
+                Detail::EndBinaryEntry();
+            }
+            return;
+        }
+    }
     FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
                       fmt::make_format_args(args...));
 }
 
 } // namespace Common::Log
 
+/// Messages below this level are compiled out, Trace is only kept in debug builds by default.
+#ifndef LOG_MIN_LEVEL
+#ifdef _DEBUG
+#define LOG_MIN_LEVEL 0
+#else
+#define LOG_MIN_LEVEL 1
+#endif
+#endif
+
 // Define the fmt lib macros
 #define LOG_GENERIC(log_class, log_level, ...)                                                     \
-    Common::Log::FmtLogMessage(log_class, log_level, Common::Log::TrimSourcePath(__FILE__),        \
-                               __LINE__, __func__, __VA_ARGS__)
+    (Common::Log::Detail::IsLevelEnabled(log_class, log_level)                                     \
+         ? Common::Log::FmtLogMessage(log_class, log_level,                                        \
+                                      Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,   \
+                                      __VA_ARGS__)                                                 \
+         : void(0))
 
-#ifdef _DEBUG
-#define LOG_TRACE(log_class, ...)                                                                  \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Trace,           \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
+#define LOG_LEVEL_(log_class, log_level, ...)                                                      \
+    LOG_GENERIC(Common::Log::Class::log_class, Common::Log::Level::log_level, __VA_ARGS__)
+
+#if LOG_MIN_LEVEL <= 0
+#define LOG_TRACE(log_class, ...) LOG_LEVEL_(log_class, Trace, __VA_ARGS__)
+#else
+#define LOG_TRACE(log_class, ...) (void(0))
+#endif
+
+#if LOG_MIN_LEVEL <= 1
+#define LOG_DEBUG(log_class, ...) LOG_LEVEL_(log_class, Debug, __VA_ARGS__)
+#else
+#define LOG_DEBUG(log_class, ...) (void(0))
+#endif
+
+#if LOG_MIN_LEVEL <= 2
+#define LOG_INFO(log_class, ...) LOG_LEVEL_(log_class, Info, __VA_ARGS__)
+#else
+#define LOG_INFO(log_class, ...) (void(0))
+#endif
+
+#if LOG_MIN_LEVEL <= 3
+#define LOG_WARNING(log_class, ...) LOG_LEVEL_(log_class, Warning, __VA_ARGS__)
 #else
-#define LOG_TRACE(log_class, fmt, ...) (void(0))
+#define LOG_WARNING(log_class, ...) (void(0))
 #endif
 
-#define LOG_DEBUG(log_class, ...)                                                                  \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Debug,           \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
-#define LOG_INFO(log_class, ...)                                                                   \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Info,            \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
-#define LOG_WARNING(log_class, ...)                                                                \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Warning,         \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
-#define LOG_ERROR(log_class, ...)                                                                  \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Error,           \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
-#define LOG_CRITICAL(log_class, ...)                                                               \
-    Common::Log::FmtLogMessage(Common::Log::Class::log_class, Common::Log::Level::Critical,        \
-                               Common::Log::TrimSourcePath(__FILE__), __LINE__, __func__,          \
-                               __VA_ARGS__)
+#define LOG_ERROR(log_class, ...) LOG_LEVEL_(log_class, Error, __VA_ARGS__)
+#define LOG_CRITICAL(log_class, ...) LOG_LEVEL_(log_class, Critical, __VA_ARGS__)
@@ -53,6 +53,10 @@ public:
         free_items.push_back(id);
     }
 
+    size_t Size() const {
+        return item_pool.size() - free_items.size();
+    }
+
     template <typename Func>
     void ForEachItemBelow(TickType tick, Func&& func) {
         static constexpr bool RETURNS_BOOL =
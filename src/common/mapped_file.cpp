@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/error.h"
+#include "common/logging/log.h"
+#include "common/mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Common::FS {
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+bool MappedFile::Open(const std::filesystem::path& path) {
+    Close();
+#ifdef _WIN32
+    const HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                    OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    LARGE_INTEGER file_size{};
+    if (!GetFileSizeEx(file, &file_size) || file_size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+    const HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) {
+        LOG_WARNING(Common_Filesystem, "Failed to map {}: {}", path.string(), GetLastErrorMsg());
+        return false;
+    }
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    // The view keeps the section alive.
+    CloseHandle(mapping);
+    if (view == nullptr) {
+        LOG_WARNING(Common_Filesystem, "Failed to map {}: {}", path.string(), GetLastErrorMsg());
+        return false;
+    }
+    size = static_cast<u64>(file_size.QuadPart);
+#else
+    const int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // The mapping keeps its own reference to the file.
+    close(fd);
+    if (view == MAP_FAILED) {
+        LOG_WARNING(Common_Filesystem, "Failed to map {}: {}", path.string(), GetLastErrorMsg());
+        return false;
+    }
+    size = static_cast<u64>(st.st_size);
+#endif
+    data = static_cast<const u8*>(view);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (!data) {
+        return;
+    }
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+#else
+    munmap(const_cast<u8*>(data), size);
+#endif
+    data = nullptr;
+    size = 0;
+}
+
+u64 MappedFile::Read(void* buf, u64 nbytes, u64 offset) const {
+    if (offset >= size) {
+        return 0;
+    }
+    const u64 count = std::min(nbytes, size - offset);
+    std::memcpy(buf, data + offset, count);
+    return count;
+}
+
+void MappedFile::Prefetch(u64 offset, u64 length) const {
+    if (offset >= size) {
+        return;
+    }
+    length = std::min(length, size - offset);
+#ifdef _WIN32
+    WIN32_MEMORY_RANGE_ENTRY range{const_cast<u8*>(data + offset), length};
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+#else
+    // madvise wants a page aligned start, round it down into the range already read.
+    static const u64 page_size = static_cast<u64>(sysconf(_SC_PAGESIZE));
+    const u64 aligned_offset = offset & ~(page_size - 1);
+    madvise(const_cast<u8*>(data + aligned_offset), length + offset - aligned_offset,
+            MADV_WILLNEED);
+#endif
+}
+
+} // namespace Common::FS
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <span>
+
+#include "common/types.h"
+
+namespace Common::FS {
+
+/**
+ * Read-only view of a whole host file mapped into the host address space.
+ * The contents are paged in on demand by the host, reads from the view don't go through the
+ * stdio buffer or issue any syscall.
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const std::filesystem::path& path) {
+        Open(path);
+    }
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /// Maps the file at the provided path, returns false if it can't be mapped.
+    bool Open(const std::filesystem::path& path);
+    void Close();
+
+    [[nodiscard]] bool IsOpen() const noexcept {
+        return data != nullptr;
+    }
+
+    [[nodiscard]] u64 GetSize() const noexcept {
+        return size;
+    }
+
+    [[nodiscard]] std::span<const u8> Data() const noexcept {
+        return {data, size};
+    }
+
+    /// Copies up to nbytes starting at offset into buf, returns the number of bytes copied.
+    u64 Read(void* buf, u64 nbytes, u64 offset) const;
+
+    /// Asks the host to start paging in the range asynchronously, the call doesn't wait for it.
+    void Prefetch(u64 offset, u64 length) const;
+
+private:
+    const u8* data{};
+    u64 size{};
+};
+
+} // namespace Common::FS
@@ -0,0 +1,58 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/types.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace Common {
+
+/// Copies and fills at least this large are written with non-temporal stores, as the data
+/// would not fit the cache share of a core anyway.
+constexpr u64 NonTemporalThreshold = 4_MB;
+
+/// Copies without pulling dest into the cache, the source is read as usual.
+inline void StreamCopy(void* dest_, const void* src_, u64 size) {
+#ifdef __AVX2__
+    u8* const dest = static_cast<u8*>(dest_);
+    const u8* const src = static_cast<const u8*>(src_);
+    const u64 head = std::min<u64>(-reinterpret_cast<uintptr_t>(dest) & 31, size);
+    std::memcpy(dest, src, head);
+    u64 i = head;
+    for (; i + 32 <= size; i += 32) {
+        const __m256i data = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i), data);
+    }
+    std::memcpy(dest + i, src + i, size - i);
+    _mm_sfence();
+#else
+    std::memcpy(dest_, src_, size);
+#endif
+}
+
+/// Fills without pulling dest into the cache.
+inline void StreamFill(void* dest_, u8 value, u64 size) {
+#ifdef __AVX2__
+    u8* const dest = static_cast<u8*>(dest_);
+    const u64 head = std::min<u64>(-reinterpret_cast<uintptr_t>(dest) & 31, size);
+    std::memset(dest, value, head);
+    const __m256i data = _mm256_set1_epi8(static_cast<char>(value));
+    u64 i = head;
+    for (; i + 32 <= size; i += 32) {
+        _mm256_stream_si256(reinterpret_cast<__m256i*>(dest + i), data);
+    }
+    std::memset(dest + i, value, size - i);
+    _mm_sfence();
+#else
+    std::memset(dest_, value, size);
+#endif
+}
+
+} // namespace Common
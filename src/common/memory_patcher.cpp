@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <codecvt>
+#include <cstring>
 #include <sstream>
 #include <string>
 #include <pugixml.hpp>
@@ -546,21 +547,40 @@ uintptr_t PatternScan(const std::string& signature) {
 
     const int32_t* sigPtr = patternBytes.data();
     const size_t sigSize = patternBytes.size();
+    if (sigSize == 0 || sigSize > g_eboot_image_size) {
+        return 0;
+    }
 
-    uint32_t foundResults = 0;
-    for (uint32_t i = 0; i < g_eboot_image_size - sigSize; ++i) {
+    // Candidates are found with memchr on the first byte that is not a wildcard, which skips
+    // most of the image without comparing the whole pattern at every offset.
+    const auto anchor = std::ranges::find_if(patternBytes, [](int32_t b) { return b != -1; });
+    if (anchor == patternBytes.end()) {
+        return reinterpret_cast<uintptr_t>(scanBytes);
+    }
+    const size_t anchorOffset = std::distance(patternBytes.begin(), anchor);
+    const auto anchorByte = static_cast<uint8_t>(*anchor);
+
+    const uint8_t* const scanEnd = scanBytes + (g_eboot_image_size - sigSize) + anchorOffset;
+    const uint8_t* current = scanBytes + anchorOffset;
+    while (current <= scanEnd) {
+        current = static_cast<const uint8_t*>(
+            std::memchr(current, anchorByte, static_cast<size_t>(scanEnd - current) + 1));
+        if (!current) {
+            break;
+        }
+        const uint8_t* candidate = current - anchorOffset;
         bool found = true;
-        for (uint32_t j = 0; j < sigSize; ++j) {
-            if (scanBytes[i + j] != sigPtr[j] && sigPtr[j] != -1) {
+        for (size_t j = anchorOffset + 1; j < sigSize; ++j) {
+            if (candidate[j] != sigPtr[j] && sigPtr[j] != -1) {
                 found = false;
                 break;
             }
         }
 
         if (found) {
-            foundResults++;
-            return reinterpret_cast<uintptr_t>(&scanBytes[i]);
+            return reinterpret_cast<uintptr_t>(candidate);
         }
+        ++current;
     }
 
     return 0;
@@ -29,4 +29,16 @@ u64 NativeClock::GetUptime() const {
     return FencedRDTSC();
 }
 
+ClockPage NativeClock::MapHostClock(u64 (*host_ns)()) const {
+    // The host clock was read somewhere between the two TSC samples.
+    const u64 tsc_before = FencedRDTSC();
+    const u64 ns = host_ns();
+    const u64 tsc_after = FencedRDTSC();
+    return ClockPage{
+        .base_tsc = tsc_before + (tsc_after - tsc_before) / 2,
+        .base_ns = ns,
+        .ns_factor = ns_rdtsc_factor,
+    };
+}
+
 } // namespace Common
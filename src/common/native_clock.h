@@ -5,9 +5,21 @@
 
 #include <chrono>
 #include "common/types.h"
+#include "common/uint128.h"
 
 namespace Common {
 
+/// Maps TSC values onto a host clock, reading the clock is then a rdtsc and a multiply.
+struct ClockPage {
+    u64 base_tsc;
+    u64 base_ns;
+    u64 ns_factor;
+
+    [[nodiscard]] u64 GetTimeNS(u64 tsc) const {
+        return base_ns + MultiplyHigh(tsc - base_tsc, ns_factor);
+    }
+};
+
 class NativeClock final {
 public:
     explicit NativeClock();
@@ -21,6 +33,9 @@ public:
     u64 GetTimeMS(u64 base_ptc = 0) const;
     u64 GetUptime() const;
 
+    /// Samples a host clock in nanoseconds together with the TSC.
+    ClockPage MapHostClock(u64 (*host_ns)()) const;
+
 private:
     u64 rdtsc_frequency;
     u64 ns_rdtsc_factor;
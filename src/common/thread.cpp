@@ -2,6 +2,7 @@
 // SPDX-FileCopyrightText: 2014 Citra Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <ctime>
 #include <string>
 #include <thread>
@@ -105,24 +106,39 @@ void SetCurrentThreadPriority(ThreadPriority new_priority) {
     SetThreadPriority(handle, windows_priority);
 }
 
-bool AccurateSleep(const std::chrono::nanoseconds duration, std::chrono::nanoseconds* remaining,
-                   const bool interruptible) {
-    const auto begin_sleep = std::chrono::high_resolution_clock::now();
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
 
-    LARGE_INTEGER interval{
-        .QuadPart = -1 * (duration.count() / 100u),
-    };
-    HANDLE timer = ::CreateWaitableTimer(NULL, TRUE, NULL);
-    SetWaitableTimer(timer, &interval, 0, NULL, NULL, 0);
-    const auto ret = WaitForSingleObjectEx(timer, INFINITE, interruptible);
-    ::CloseHandle(timer);
+// Waitable timer of a thread, high resolution timers wake up within a few ten microseconds
+// instead of the 1 ms granularity of the regular ones. They need Windows 10 1803.
+struct SleepTimer {
+    HANDLE handle;
 
-    if (remaining) {
-        const auto end_sleep = std::chrono::high_resolution_clock::now();
-        const auto sleep_time = end_sleep - begin_sleep;
-        *remaining = duration > sleep_time ? duration - sleep_time : std::chrono::nanoseconds(0);
+    SleepTimer() {
+        handle = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+                                        TIMER_ALL_ACCESS);
+        if (!handle) {
+            handle = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+        }
     }
-    return ret == WAIT_OBJECT_0;
+
+    ~SleepTimer() {
+        CloseHandle(handle);
+    }
+};
+
+static bool HostSleepUntil(const std::chrono::steady_clock::time_point deadline,
+                           const bool interruptible) {
+    thread_local SleepTimer timer;
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        deadline - std::chrono::steady_clock::now());
+    // Relative in 100 ns units
+    LARGE_INTEGER interval{
+        .QuadPart = -std::max<s64>(duration.count() / 100, 1),
+    };
+    SetWaitableTimer(timer.handle, &interval, 0, NULL, NULL, 0);
+    return WaitForSingleObjectEx(timer.handle, INFINITE, interruptible) == WAIT_OBJECT_0;
 }
 
 #else
@@ -145,28 +161,94 @@ void SetCurrentThreadPriority(ThreadPriority new_priority) {
     pthread_setschedparam(this_thread, scheduling_type, &params);
 }
 
-bool AccurateSleep(const std::chrono::nanoseconds duration, std::chrono::nanoseconds* remaining,
-                   const bool interruptible) {
+static bool HostSleepUntil(const std::chrono::steady_clock::time_point deadline,
+                           const bool interruptible) {
+#ifdef __APPLE__
+    // No clock_nanosleep, restarts after a signal are relative to the remaining time
+    const auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        deadline - std::chrono::steady_clock::now());
+    if (duration.count() <= 0) {
+        return true;
+    }
     timespec request = {
         .tv_sec = duration.count() / 1'000'000'000,
         .tv_nsec = duration.count() % 1'000'000'000,
     };
     timespec remain;
-    int ret;
-    while ((ret = nanosleep(&request, &remain)) < 0 && errno == EINTR) {
+    while (nanosleep(&request, &remain) < 0 && errno == EINTR) {
         if (interruptible) {
-            break;
+            return false;
         }
         request = remain;
     }
-    if (remaining) {
-        *remaining = std::chrono::nanoseconds(remain.tv_sec * 1'000'000'000 + remain.tv_nsec);
+    return true;
+#else
+    // steady_clock is CLOCK_MONOTONIC, an absolute deadline doesn't drift over restarts
+    const auto since_epoch = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        deadline.time_since_epoch());
+    const timespec request = {
+        .tv_sec = since_epoch.count() / 1'000'000'000,
+        .tv_nsec = since_epoch.count() % 1'000'000'000,
+    };
+    int ret;
+    while ((ret = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &request, nullptr)) == EINTR) {
+        if (interruptible) {
+            return false;
+        }
     }
-    return ret == 0 || errno != EINTR;
+    return true;
+#endif
 }
 
 #endif
 
+namespace {
+
+/// Longest tail of a sleep that is spun instead of slept.
+constexpr std::chrono::nanoseconds MaxSleepSlack = std::chrono::milliseconds{2};
+
+/// Per thread estimate of how late the host wakes up a sleeping thread.
+struct SleepSlack {
+    std::chrono::nanoseconds estimate{std::chrono::microseconds{50}};
+
+    void Update(std::chrono::nanoseconds overshoot) {
+        estimate += (overshoot - estimate) / 8;
+        estimate = std::clamp(estimate, std::chrono::nanoseconds{0}, MaxSleepSlack);
+    }
+};
+
+thread_local SleepSlack sleep_slack;
+
+} // Anonymous namespace
+
+bool AccurateSleep(const std::chrono::nanoseconds duration, std::chrono::nanoseconds* remaining,
+                   const bool interruptible) {
+    const auto deadline = std::chrono::steady_clock::now() + duration;
+
+    // The host sleeps until the expected oversleep before the deadline and the rest is spun.
+    // Sleeps shorter than that never reach the host timer.
+    bool uninterrupted = true;
+    if (duration > sleep_slack.estimate) {
+        const auto wake = deadline - sleep_slack.estimate;
+        uninterrupted = HostSleepUntil(wake, interruptible);
+        if (uninterrupted) {
+            sleep_slack.Update(std::chrono::steady_clock::now() - wake);
+        }
+    }
+    if (uninterrupted) {
+        // Yield while spinning so the core stays available to other threads
+        while (std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (remaining) {
+        const auto now = std::chrono::steady_clock::now();
+        *remaining = deadline > now ? deadline - now : std::chrono::nanoseconds{0};
+    }
+    return uninterrupted;
+}
+
 #ifdef _MSC_VER
 
 // Sets the debugger-visible name of the current thread.
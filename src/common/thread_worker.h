@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "common/polyfill_thread.h"
+#include "common/thread.h"
+#include "common/types.h"
+#include "common/unique_function.h"
+
+namespace Common {
+
+/**
+ * Fixed-size pool of threads consuming a shared FIFO of tasks.
+ * Tasks that are still queued when the worker is destroyed are discarded, running ones are
+ * allowed to finish.
+ */
+class ThreadWorker {
+    using Task = UniqueFunction<void>;
+
+public:
+    explicit ThreadWorker(size_t num_workers, std::string name_) : name{std::move(name_)} {
+        threads.reserve(num_workers);
+        for (size_t i = 0; i < num_workers; ++i) {
+            threads.emplace_back([this](std::stop_token token) { WorkerLoop(token); });
+        }
+    }
+
+    ~ThreadWorker() {
+        for (auto& thread : threads) {
+            thread.request_stop();
+        }
+        work_cv.notify_all();
+    }
+
+    ThreadWorker(const ThreadWorker&) = delete;
+    ThreadWorker& operator=(const ThreadWorker&) = delete;
+
+    /// Queues a task to be executed by any of the worker threads.
+    template <typename Func>
+    void QueueWork(Func&& work) {
+        {
+            std::scoped_lock lk{queue_mutex};
+            requests.emplace(std::forward<Func>(work));
+            ++work_scheduled;
+        }
+        work_cv.notify_one();
+    }
+
+    /// Blocks until every task queued so far has been executed.
+    void WaitForRequests() {
+        std::unique_lock lk{queue_mutex};
+        wait_cv.wait(lk, [this] { return work_done >= work_scheduled; });
+    }
+
+    /// Returns true when there are queued or running tasks.
+    [[nodiscard]] bool IsBusy() const {
+        std::scoped_lock lk{queue_mutex};
+        return work_done < work_scheduled;
+    }
+
+    [[nodiscard]] size_t NumWorkers() const noexcept {
+        return threads.size();
+    }
+
+private:
+    void WorkerLoop(std::stop_token token) {
+        SetCurrentThreadName(name.c_str());
+        while (!token.stop_requested()) {
+            Task task;
+            {
+                std::unique_lock lk{queue_mutex};
+                CondvarWait(work_cv, lk, token, [this] { return !requests.empty(); });
+                if (token.stop_requested()) {
+                    break;
+                }
+                task = std::move(requests.front());
+                requests.pop();
+            }
+            task();
+            {
+                std::scoped_lock lk{queue_mutex};
+                ++work_done;
+            }
+            wait_cv.notify_all();
+        }
+    }
+
+    std::string name;
+    mutable std::mutex queue_mutex;
+    std::condition_variable_any work_cv;
+    std::condition_variable wait_cv;
+    std::queue<Task> requests;
+    u64 work_scheduled{};
+    u64 work_done{};
+    std::vector<std::jthread> threads;
+};
+
+} // namespace Common
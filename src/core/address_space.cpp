@@ -176,9 +176,17 @@ struct AddressSpace::Impl {
         // Increase BackingSize to account for config options.
         BackingSize += Config::getExtraDmemInMbytes() * 1_MB;
 
-        // Allocate backing file that represents the total physical memory.
+        // Large page sections can only be viewed at large page granularity, guest mappings need
+        // 16KB granularity.
+        if (Config::isHugePageBackingEnabled()) {
+            LOG_WARNING(Kernel_Vmm, "Huge page backing is not supported on this platform");
+        }
+
+        // Allocate backing file that represents the total physical memory. Its pages are only
+        // committed once a mapping references them, so untouched memory does not count against
+        // the commit limit.
         backing_handle = CreateFileMapping2(INVALID_HANDLE_VALUE, nullptr, FILE_MAP_ALL_ACCESS,
-                                            PAGE_EXECUTE_READWRITE, SEC_COMMIT, BackingSize,
+                                            PAGE_EXECUTE_READWRITE, SEC_RESERVE, BackingSize,
                                             nullptr, nullptr, 0);
 
         ASSERT_MSG(backing_handle, "{}", Common::GetLastErrorMsg());
@@ -188,7 +196,7 @@ struct AddressSpace::Impl {
                                                       PAGE_NOACCESS, nullptr, 0));
         ASSERT_MSG(backing_base, "{}", Common::GetLastErrorMsg());
 
-        // Map backing placeholder. This will commit the pages
+        // Map backing placeholder.
         void* const ret =
             MapViewOfFile3(backing_handle, process, backing_base, 0, BackingSize,
                            MEM_REPLACE_PLACEHOLDER, PAGE_EXECUTE_READWRITE, nullptr, 0);
@@ -231,6 +239,9 @@ struct AddressSpace::Impl {
                 ret = VirtualProtect(ptr, size, prot, &resultvar);
                 ASSERT_MSG(ret, "VirtualProtect failed. {}", Common::GetLastErrorMsg());
             } else {
+                if (backing == backing_handle) {
+                    Commit(phys_addr, size);
+                }
                 ptr = MapViewOfFile3(backing, process, reinterpret_cast<PVOID>(virtual_addr),
                                      phys_addr, size, MEM_REPLACE_PLACEHOLDER,
                                      PAGE_EXECUTE_READWRITE, nullptr, 0);
@@ -248,6 +259,19 @@ struct AddressSpace::Impl {
         return ptr;
     }
 
+    void Commit(PAddr phys_addr, size_t size) {
+        // Pages committed through the backing view are committed for every view of the section.
+        void* const ret = VirtualAlloc(backing_base + phys_addr, size, MEM_COMMIT, PAGE_READWRITE);
+        ASSERT_MSG(ret, "Failed to commit backing memory: {}", Common::GetLastErrorMsg());
+    }
+
+    bool Discard(PAddr phys_addr, size_t size) {
+        // Section pages cannot be decommitted while mapped, but their contents can be dropped
+        // from the working set. The contents are undefined afterwards.
+        DiscardVirtualMemory(backing_base + phys_addr, size);
+        return false;
+    }
+
     void Unmap(VAddr virtual_addr, size_t size, bool has_backing) {
         bool ret;
         if (has_backing) {
@@ -590,6 +614,23 @@ struct AddressSpace::Impl {
             LOG_CRITICAL(Kernel_Vmm, "mmap failed: {}", strerror(errno));
             throw std::bad_alloc{};
         }
+
+        // Hugetlb files can only be mapped at huge page granularity, so the backing file stays
+        // on shmem and transparent huge pages are requested for it instead. The kernel splits
+        // huge pages back into small ones where a mapping or protection change is not huge page
+        // aligned, which keeps write tracking on sub-ranges working unchanged.
+        if (Config::isHugePageBackingEnabled()) {
+#ifdef __linux__
+            use_huge_pages = madvise(backing_base, BackingSize, MADV_HUGEPAGE) == 0;
+            if (use_huge_pages) {
+                LOG_INFO(Kernel_Vmm, "Using transparent huge pages for guest memory backing");
+            } else {
+                LOG_WARNING(Kernel_Vmm, "Huge page backing is unavailable: {}", strerror(errno));
+            }
+#else
+            LOG_WARNING(Kernel_Vmm, "Huge page backing is not supported on this platform");
+#endif
+        }
     }
 
     void* Map(VAddr virtual_addr, PAddr phys_addr, size_t size, PosixPageProtection prot,
@@ -601,9 +642,26 @@ struct AddressSpace::Impl {
         void* ret = mmap(reinterpret_cast<void*>(virtual_addr), size, prot, MAP_FIXED | flag,
                          handle, host_offset);
         ASSERT_MSG(ret != MAP_FAILED, "mmap failed: {}", strerror(errno));
+#ifdef __linux__
+        // A huge page can only back a view whose address and file offset agree modulo its size.
+        if (use_huge_pages && handle == backing_fd && size >= HugePageSize &&
+            ((virtual_addr ^ phys_addr) & (HugePageSize - 1)) == 0) {
+            madvise(ret, size, MADV_HUGEPAGE);
+        }
+#endif
         return ret;
     }
 
+    bool Discard(PAddr phys_addr, size_t size) {
+#ifdef __linux__
+        // Punching a hole returns the pages to the host, they read back as zero when touched.
+        return fallocate(backing_fd, FALLOC_FL_PUNCH_HOLE | FALLOC_FL_KEEP_SIZE, phys_addr, size) ==
+               0;
+#else
+        return false;
+#endif
+    }
+
     void Unmap(VAddr virtual_addr, size_t size, bool) {
         // Check to see if we are adjacent to any regions.
         auto start_address = virtual_addr;
@@ -642,7 +700,10 @@ struct AddressSpace::Impl {
         ASSERT_MSG(ret == 0, "mprotect failed: {}", strerror(errno));
     }
 
+    static constexpr u64 HugePageSize = 2_MB;
+
     int backing_fd;
+    bool use_huge_pages{};
     u8* backing_base{};
     u8* system_managed_base{};
     size_t system_managed_size{};
@@ -713,6 +774,10 @@ void AddressSpace::Unmap(VAddr virtual_addr, size_t size, VAddr start_in_vma, VA
 #endif
 }
 
+bool AddressSpace::Discard(PAddr phys_addr, size_t size) {
+    return impl->Discard(phys_addr, size);
+}
+
 void AddressSpace::Protect(VAddr virtual_addr, size_t size, MemoryPermission perms) {
     const bool read = True(perms & MemoryPermission::Read);
     const bool write = True(perms & MemoryPermission::Write);
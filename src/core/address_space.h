@@ -83,6 +83,13 @@ public:
     void Unmap(VAddr virtual_addr, size_t size, VAddr start_in_vma, VAddr end_in_vma,
                PAddr phys_base, bool is_exec, bool has_backing, bool readonly_file);
 
+    /**
+     * @brief Returns the host memory backing a physical range to the host.
+     * @return True when the range reads back as zero afterwards, false when its contents are
+     *         undefined.
+     */
+    bool Discard(PAddr phys_addr, size_t size);
+
     void Protect(VAddr virtual_addr, size_t size, MemoryPermission perms);
 
     // Returns an interval set containing all usable regions.
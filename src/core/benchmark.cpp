@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <fmt/core.h>
+
+#include "common/logging/backend.h"
+#include "common/logging/log.h"
+#include "common/path_util.h"
+#include "core/benchmark.h"
+#include "core/debug_state.h"
+#include "core/libraries/hle_profiler.h"
+#include "core/signals.h"
+#include "shader_recompiler/recompiler.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace Core::Benchmark {
+
+namespace {
+
+struct BenchmarkState {
+    bool enabled{};
+    Options options;
+    std::vector<double> frame_times_ms;
+    std::chrono::steady_clock::time_point first_flip;
+    std::chrono::steady_clock::time_point last_flip;
+    u64 num_flips{};
+} g_state;
+
+/// Peak resident set size of the process in bytes.
+u64 GetPeakMemory() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.PeakWorkingSetSize;
+    }
+    return 0;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    return static_cast<u64>(usage.ru_maxrss);
+#else
+    return static_cast<u64>(usage.ru_maxrss) * 1024;
+#endif
+#endif
+}
+
+double HitRate(u64 hits, u64 total) {
+    return total != 0 ? static_cast<double>(hits) / static_cast<double>(total) : 0.0;
+}
+
+void WriteReport(double duration_s) {
+    auto times = g_state.frame_times_ms;
+    std::ranges::sort(times);
+    // Nearest rank percentiles.
+    const auto percentile = [&](double p) {
+        if (times.empty()) {
+            return 0.0;
+        }
+        const auto rank = static_cast<size_t>(p * static_cast<double>(times.size()) + 0.999999);
+        return times[std::clamp<size_t>(rank, 1, times.size()) - 1];
+    };
+    double total_ms = 0.0;
+    for (const double time : times) {
+        total_ms += time;
+    }
+    const double average_ms = times.empty() ? 0.0 : total_ms / static_cast<double>(times.size());
+
+    using DebugStateType::RendererCounter;
+    const auto& counters = DebugState.renderer_counters;
+    const u64 spirv_hits = counters.Total(RendererCounter::SpirvCacheHits);
+    const u64 spirv_misses = counters.Total(RendererCounter::SpirvCacheMisses);
+    const u64 created = counters.Total(RendererCounter::PipelinesCreated);
+    const u64 lookups = counters.Total(RendererCounter::PipelineLookups);
+    const auto& textures = DebugState.texture_cache_memory;
+
+    std::string report = "{\n";
+    report += fmt::format("  \"frames\": {},\n", times.size());
+    report += fmt::format("  \"duration_s\": {:.3f},\n", duration_s);
+    report += fmt::format("  \"average_fps\": {:.2f},\n",
+                          average_ms > 0.0 ? 1000.0 / average_ms : 0.0);
+    report += "  \"frame_time_ms\": {\n";
+    report += fmt::format("    \"min\": {:.3f},\n", times.empty() ? 0.0 : times.front());
+    report += fmt::format("    \"average\": {:.3f},\n", average_ms);
+    report += fmt::format("    \"p50\": {:.3f},\n", percentile(0.50));
+    report += fmt::format("    \"p90\": {:.3f},\n", percentile(0.90));
+    report += fmt::format("    \"p99\": {:.3f},\n", percentile(0.99));
+    report += fmt::format("    \"max\": {:.3f}\n", times.empty() ? 0.0 : times.back());
+    report += "  },\n";
+    report += "  \"shaders\": {\n";
+    report += fmt::format("    \"compiled\": {},\n",
+                          counters.Total(RendererCounter::ShaderCompiles));
+    report += fmt::format("    \"spirv_cache_hits\": {},\n", spirv_hits);
+    report += fmt::format("    \"spirv_cache_misses\": {},\n", spirv_misses);
+    report += fmt::format("    \"spirv_cache_hit_rate\": {:.4f}\n",
+                          HitRate(spirv_hits, spirv_hits + spirv_misses));
+    report += "  },\n";
+    report += "  \"pipelines\": {\n";
+    report += fmt::format("    \"created\": {},\n", created);
+    report += fmt::format("    \"lookups\": {},\n", lookups);
+    report += fmt::format("    \"hit_rate\": {:.4f}\n", HitRate(lookups - created, lookups));
+    report += "  },\n";
+    report += "  \"renderer_counters\": {\n";
+    for (u32 i = 0; i < DebugStateType::NumRendererCounters; i++) {
+        const auto counter = static_cast<RendererCounter>(i);
+        report += fmt::format("    \"{}\": {}{}\n", DebugStateType::RendererCounterName(counter),
+                              counters.Total(counter),
+                              i + 1 < DebugStateType::NumRendererCounters ? "," : "");
+    }
+    report += "  },\n";
+    const auto& passes = Shader::GetPassStats();
+    report += "  \"recompiler\": {\n";
+    report += fmt::format("    \"programs\": {},\n", passes.num_programs.load());
+    report += "    \"pass_time_ms\": {\n";
+    for (u32 i = 0; i < static_cast<u32>(Shader::Pass::Count); i++) {
+        report += fmt::format("      \"{}\": {:.3f}{}\n", Shader::PassName(Shader::Pass{i}),
+                              static_cast<double>(passes.time_ns[i].load()) / 1e6,
+                              i + 1 < static_cast<u32>(Shader::Pass::Count) ? "," : "");
+    }
+    report += "    }\n";
+    report += "  },\n";
+    if constexpr (Libraries::HleProfiler::IsEnabled()) {
+        const auto calls = Libraries::HleProfiler::GetTopCalls(32);
+        report += "  \"hle_calls\": [\n";
+        for (size_t i = 0; i < calls.size(); i++) {
+            report += fmt::format("    {{\"name\": \"{}\", \"calls\": {}, \"average_us\": {:.3f}, "
+                                  "\"max_us\": {:.3f}}}{}\n",
+                                  calls[i].name, calls[i].calls, calls[i].average_us,
+                                  calls[i].max_us, i + 1 < calls.size() ? "," : "");
+        }
+        report += "  ],\n";
+    }
+    const auto faults = Signals::Instance()->GetAccessViolationStats();
+    report += "  \"access_violations\": {\n";
+    report += fmt::format("    \"faults\": {},\n", faults.num_faults);
+    report += fmt::format("    \"owner_hits\": {},\n", faults.num_owner_hits);
+    report += fmt::format("    \"average_us\": {:.3f},\n",
+                          faults.num_faults != 0 ? static_cast<double>(faults.total_ns) /
+                                                       static_cast<double>(faults.num_faults) / 1e3
+                                                 : 0.0);
+    report += fmt::format("    \"max_us\": {:.3f}\n", static_cast<double>(faults.max_ns) / 1e3);
+    report += "  },\n";
+    report += "  \"texture_cache\": {\n";
+    report += fmt::format("    \"images\": {},\n", textures.num_images.load());
+    report += fmt::format("    \"evicted\": {},\n", textures.num_evicted.load());
+    report += fmt::format("    \"image_memory_bytes\": {},\n", textures.image_memory.load());
+    report += fmt::format("    \"device_usage_bytes\": {}\n", textures.device_usage.load());
+    report += "  },\n";
+    report += fmt::format("  \"peak_memory_bytes\": {}\n", GetPeakMemory());
+    report += "}\n";
+
+    std::ofstream file{g_state.options.report_path, std::ios::trunc};
+    file << report;
+    if (!file) {
+        LOG_ERROR(Core, "Unable to write benchmark report {}",
+                  Common::FS::PathToUTF8String(g_state.options.report_path));
+        return;
+    }
+    LOG_INFO(Core, "Benchmark finished after {} frames, p50 {:.3f} ms, p99 {:.3f} ms", times.size(),
+             percentile(0.50), percentile(0.99));
+}
+
+} // Anonymous namespace
+
+void Configure(const Options& options) {
+    g_state.enabled = true;
+    g_state.options = options;
+}
+
+bool IsEnabled() {
+    return g_state.enabled;
+}
+
+void Start() {
+    if (!g_state.enabled) {
+        return;
+    }
+    g_state.frame_times_ms.reserve(g_state.options.num_frames);
+    Signals::Instance()->SetFaultTiming(true);
+    LOG_INFO(Core, "Benchmark mode, running for {} {}",
+             g_state.options.num_frames != 0 ? static_cast<double>(g_state.options.num_frames)
+                                             : g_state.options.num_seconds,
+             g_state.options.num_frames != 0 ? "frames" : "seconds");
+}
+
+void OnFlip() {
+    if (!g_state.enabled) {
+        return;
+    }
+    // The run is timed from the first presented frame so that loading is left out.
+    const auto now = std::chrono::steady_clock::now();
+    if (g_state.num_flips++ == 0) {
+        g_state.first_flip = now;
+    } else {
+        g_state.frame_times_ms.push_back(
+            std::chrono::duration<double, std::milli>(now - g_state.last_flip).count());
+    }
+    g_state.last_flip = now;
+
+    const double elapsed_s = std::chrono::duration<double>(now - g_state.first_flip).count();
+    const bool done = g_state.options.num_frames != 0
+                          ? g_state.frame_times_ms.size() >= g_state.options.num_frames
+                          : elapsed_s >= g_state.options.num_seconds;
+    if (!done) {
+        return;
+    }
+    WriteReport(elapsed_s);
+    Common::Log::Stop();
+    std::quick_exit(0);
+}
+
+} // namespace Core::Benchmark
@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+
+#include "common/types.h"
+
+namespace Core::Benchmark {
+
+struct Options {
+    /// Length of the run in presented frames, or in seconds when num_frames is 0.
+    u64 num_frames{};
+    double num_seconds{};
+    std::filesystem::path report_path{"benchmark.json"};
+};
+
+/// Enables benchmark mode, the run ends by writing the report and exiting the emulator.
+void Configure(const Options& options);
+
+[[nodiscard]] bool IsEnabled();
+
+/// Logs the run length, called before the game starts.
+void Start();
+
+/// Records a presented frame, ends the run once its length is reached.
+void OnFlip();
+
+} // namespace Core::Benchmark
@@ -1,10 +1,16 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
 #include <map>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <span>
+#include <vector>
+#include <xxhash.h>
 #include <Zydis/Zydis.h>
 #include <xbyak/xbyak.h>
 #include <xbyak/xbyak_util.h>
@@ -12,6 +18,10 @@
 #include "common/arch.h"
 #include "common/assert.h"
 #include "common/decoder.h"
+#include "common/io_file.h"
+#include "common/logging/log.h"
+#include "common/path_util.h"
+#include "common/scm_rev.h"
 #include "common/signal_context.h"
 #include "common/types.h"
 #include "core/signals.h"
@@ -457,6 +467,13 @@ static const std::unordered_map<ZydisMnemonic, PatchInfo> Patches = {
 
 static std::once_flag init_flag;
 
+/// Executable segment of a module whose patch locations are cached on disk.
+struct PatchSegment {
+    u8* start;
+    u64 size;
+    std::filesystem::path cache_path;
+};
+
 struct PatchModule {
     /// Mutex controlling access to module code regions.
     std::mutex mutex{};
@@ -470,6 +487,9 @@ struct PatchModule {
     /// Tracker for patched code locations.
     std::set<u8*> patched;
 
+    /// Executable segments with their patch cache.
+    std::vector<PatchSegment> segments;
+
     /// Code generator for patching the module.
     Xbyak::CodeGenerator patch_gen;
 
@@ -705,6 +725,82 @@ static bool TryExecuteIllegalInstruction(void*, void*) {
 #error "Unsupported architecture"
 #endif
 
+/**
+ * Patch caches hold the offsets of the patched instructions of an executable segment, one file
+ * per segment named after the hash of its contents. The offsets found by the ahead-of-time scan
+ * are written when the cache is created and the ones patched at runtime are appended, so the next
+ * boot patches all of them without decoding the whole segment.
+ */
+struct PatchCacheHeader {
+    u32 magic;
+    u32 version;
+    u64 build_hash;
+    u32 host_flags;
+    u32 reserved;
+
+    bool operator==(const PatchCacheHeader&) const = default;
+};
+static_assert(sizeof(PatchCacheHeader) == 24);
+
+static constexpr u32 PatchCacheMagic = 0x48435050; // "PPCH"
+static constexpr u32 PatchCacheVersion = 1;
+
+static PatchCacheHeader MakePatchCacheHeader() {
+    // Whether SSE4a instructions are patched depends on the host CPU.
+    static const Xbyak::util::Cpu cpu;
+    return PatchCacheHeader{
+        .magic = PatchCacheMagic,
+        .version = PatchCacheVersion,
+        .build_hash = XXH3_64bits(Common::g_scm_rev, std::strlen(Common::g_scm_rev)),
+        .host_flags = cpu.has(Xbyak::util::Cpu::tSSE4a) ? 1U : 0U,
+        .reserved = 0,
+    };
+}
+
+static std::filesystem::path GetPatchCachePath(const u8* code, u64 code_size) {
+    const auto cache_dir = Common::FS::GetUserPath(Common::FS::PathType::UserDir) / "cache" /
+                           "cpu_patches";
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+    return cache_dir / fmt::format("{:016x}.bin", XXH3_64bits(code, code_size));
+}
+
+static bool LoadPatchCache(const std::filesystem::path& path, std::vector<u32>& offsets) {
+    using namespace Common::FS;
+    IOFile file{path, FileAccessMode::Read};
+    if (!file.IsOpen()) {
+        return false;
+    }
+    PatchCacheHeader header{};
+    if (!file.ReadObject(header) || header != MakePatchCacheHeader()) {
+        LOG_INFO(Core, "Discarding incompatible patch cache {}", path.filename().string());
+        return false;
+    }
+    // A runtime patch may have been cut short while it was appended, drop the partial entry.
+    offsets.resize((file.GetSize() - sizeof(header)) / sizeof(u32));
+    return file.ReadSpan<u32>(offsets) == offsets.size();
+}
+
+static void StorePatchCache(const std::filesystem::path& path, std::span<const u32> offsets) {
+    using namespace Common::FS;
+    IOFile file{path, FileAccessMode::Write};
+    if (!file.IsOpen() || !file.WriteObject(MakePatchCacheHeader()) ||
+        file.WriteSpan(offsets) != offsets.size()) {
+        LOG_WARNING(Core, "Failed to write patch cache {}", path.string());
+    }
+}
+
+static void AppendPatchCache(PatchModule* module, const u8* code) {
+    const auto it = std::ranges::find_if(module->segments, [code](const PatchSegment& segment) {
+        return code >= segment.start && code < segment.start + segment.size;
+    });
+    if (it == module->segments.end()) {
+        return;
+    }
+    Common::FS::IOFile file{it->cache_path, Common::FS::FileAccessMode::Append};
+    file.WriteObject(static_cast<u32>(code - it->start));
+}
+
 static bool TryPatchJit(void* code_address) {
     auto* code = static_cast<u8*>(code_address);
     auto* module = GetModule(code);
@@ -719,21 +815,22 @@ static bool TryPatchJit(void* code_address) {
         return true;
     }
 
-    return TryPatch(code, module).first;
-}
-
-static void TryPatchAot(void* code_address, u64 code_size) {
-    auto* code = static_cast<u8*>(code_address);
-    auto* module = GetModule(code);
-    if (module == nullptr) {
-        return;
+    if (!TryPatch(code, module).first) {
+        return false;
     }
+    // Patch this location ahead of time on the next boot.
+    AppendPatchCache(module, code);
+    return true;
+}
 
-    std::unique_lock lock{module->mutex};
-
+static void TryPatchAot(u8* code, u64 code_size, PatchModule* module, std::vector<u32>& offsets) {
     const auto* end = code + code_size;
-    while (code < end) {
-        code += TryPatch(code, module).second;
+    for (u8* ptr = code; ptr < end;) {
+        const auto [patched, length] = TryPatch(ptr, module);
+        if (patched) {
+            offsets.push_back(static_cast<u32>(ptr - code));
+        }
+        ptr += length;
     }
 }
 
@@ -788,13 +885,39 @@ void RegisterPatchModule(void* module_ptr, u64 module_size, void* trampoline_are
 }
 
 void PrePatchInstructions(u64 segment_addr, u64 segment_size) {
+    if (Patches.empty()) {
+        return;
+    }
+    auto* code = reinterpret_cast<u8*>(segment_addr);
+    auto* module = GetModule(code);
+    if (module == nullptr) {
+        return;
+    }
+
+    std::unique_lock lock{module->mutex};
+    const auto& segment =
+        module->segments.emplace_back(code, segment_size, GetPatchCachePath(code, segment_size));
+
+    // Cached locations were all patched before, either by the scan or at runtime, so they are
+    // applied on every platform.
+    std::vector<u32> offsets;
+    if (LoadPatchCache(segment.cache_path, offsets)) {
+        for (const u32 offset : offsets) {
+            if (offset < segment_size && !module->patched.contains(code + offset)) {
+                TryPatch(code + offset, module);
+            }
+        }
+        LOG_INFO(Core, "Applied {} cached patches to segment at {}", offsets.size(),
+                 fmt::ptr(code));
+        return;
+    }
+
 #if !defined(_WIN32) && !defined(__APPLE__)
     // Linux and others have an FS segment pointing to valid memory, so continue to do full
     // ahead-of-time patching for now until a better solution is worked out.
-    if (!Patches.empty()) {
-        TryPatchAot(reinterpret_cast<void*>(segment_addr), segment_size);
-    }
+    TryPatchAot(code, segment_size, module, offsets);
 #endif
+    StorePatchCache(segment.cache_path, offsets);
 }
 
 } // namespace Core
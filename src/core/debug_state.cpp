@@ -4,6 +4,8 @@
 #include <imgui.h>
 
 #include "common/assert.h"
+#include "common/io_file.h"
+#include "common/logging/log.h"
 #include "common/native_clock.h"
 #include "common/singleton.h"
 #include "debug_state.h"
@@ -19,6 +21,134 @@ DebugStateImpl& DebugState = *Common::Singleton<DebugStateImpl>::Instance();
 
 bool DebugStateType::showing_debug_menu_bar = false;
 
+bool DebugStateType::FrameDump::SaveCapture(const std::filesystem::path& path) const {
+    constexpr u32 CaptureMagic = 0x344D5053; // SPM4
+    constexpr u32 CaptureVersion = 1;
+
+    Common::FS::IOFile file(path, Common::FS::FileAccessMode::Write);
+    if (!file.IsOpen()) {
+        return false;
+    }
+    bool ok = file.WriteObject(CaptureMagic) && file.WriteObject(CaptureVersion) &&
+              file.WriteObject(frame_id) && file.WriteObject(static_cast<u32>(queues.size())) &&
+              file.WriteObject(static_cast<u32>(regs.size()));
+    for (const auto& queue : queues) {
+        ok &= file.WriteObject(static_cast<u32>(queue.type)) &&
+              file.WriteObject(queue.submit_num) && file.WriteObject(queue.num2) &&
+              file.WriteObject(static_cast<u64>(queue.base_addr)) &&
+              file.WriteObject(static_cast<u64>(queue.data.size())) &&
+              file.Write(queue.data) == queue.data.size();
+    }
+    const auto write_code = [&](u64 address, u64 hash, const std::vector<u32>& code) {
+        return file.WriteObject(address) && file.WriteObject(hash) &&
+               file.WriteObject(static_cast<u64>(code.size())) && file.Write(code) == code.size();
+    };
+    for (const auto& [addr, dump] : regs) {
+        ok &= file.WriteObject(static_cast<u64>(addr)) &&
+              file.WriteObject(static_cast<u32>(dump.is_compute)) && file.WriteObject(dump.regs);
+        if (dump.is_compute) {
+            ok &= write_code(dump.cs_data.cs_program.Address<uintptr_t>(), dump.cs_data.hash,
+                             dump.cs_data.code);
+            continue;
+        }
+        for (const auto& stage : dump.stages) {
+            ok &= write_code(stage.user_data.Address<uintptr_t>(), stage.hash, stage.code);
+        }
+    }
+    return ok;
+}
+
+const char* DebugStateType::StallCauseName(StallCause cause) {
+    switch (cause) {
+    case StallCause::ShaderCompile:
+        return "shader compile";
+    case StallCause::PipelineCompile:
+        return "pipeline compile";
+    case StallCause::ImageEviction:
+        return "image eviction";
+    case StallCause::ImageUpload:
+        return "image upload";
+    case StallCause::BufferDownload:
+        return "buffer download";
+    case StallCause::GpuIdleWait:
+        return "gpu idle wait";
+    case StallCause::PageFault:
+        return "page fault";
+    case StallCause::AioWait:
+        return "aio wait";
+    case StallCause::FrameWait:
+        return "frame wait";
+    default:
+        return "unknown";
+    }
+}
+
+const char* DebugStateType::RendererCounterName(RendererCounter counter) {
+    switch (counter) {
+    case RendererCounter::ImagesCreated:
+        return "images_created";
+    case RendererCounter::ImageOverlaps:
+        return "image_overlaps";
+    case RendererCounter::ImageUploads:
+        return "image_uploads";
+    case RendererCounter::ImageUploadBytes:
+        return "image_upload_bytes";
+    case RendererCounter::BuffersCreated:
+        return "buffers_created";
+    case RendererCounter::BufferSyncs:
+        return "buffer_syncs";
+    case RendererCounter::BufferUploadBytes:
+        return "buffer_upload_bytes";
+    case RendererCounter::BufferDownloads:
+        return "buffer_downloads";
+    case RendererCounter::DownloadStalls:
+        return "download_stalls";
+    case RendererCounter::StreamBytes:
+        return "stream_bytes";
+    case RendererCounter::StagingBytes:
+        return "staging_bytes";
+    case RendererCounter::ReadbackBytes:
+        return "readback_bytes";
+    case RendererCounter::PredictedReadbacks:
+        return "predicted_readbacks";
+    case RendererCounter::ShaderCompiles:
+        return "shader_compiles";
+    case RendererCounter::SpirvCacheHits:
+        return "spirv_cache_hits";
+    case RendererCounter::SpirvCacheMisses:
+        return "spirv_cache_misses";
+    case RendererCounter::PipelineLookups:
+        return "pipeline_lookups";
+    case RendererCounter::PipelinesCreated:
+        return "pipelines_created";
+    case RendererCounter::DescriptorWrites:
+        return "descriptor_writes";
+    case RendererCounter::ShaderHleDispatches:
+        return "shader_hle_dispatches";
+    default:
+        return "unknown";
+    }
+}
+
+std::string DebugStateType::FrameSpike::Describe() const {
+    std::string description;
+    for (size_t i = 0; i < NumStallCauses; i++) {
+        if (counts[i] == 0) {
+            continue;
+        }
+        if (!description.empty()) {
+            description += ", ";
+        }
+        const char* name = StallCauseName(static_cast<StallCause>(i));
+        if (wait_us[i] != 0) {
+            description += fmt::format("{} {:.2f} ms", name, wait_us[i] / 1000.0f);
+        } else {
+            description += fmt::format("{} {}{}", counts[i], name, counts[i] > 1 ? "s" : "");
+        }
+    }
+    return description.empty() ? "no known cause" : description;
+}
+
 static ThreadID ThisThreadID() {
 #ifdef _WIN32
     return GetCurrentThreadId();
@@ -214,3 +344,48 @@ void DebugStateImpl::CollectShader(const std::string& name, Shader::LogicalStage
                                   std::vector<u32>{raw_code.begin(), raw_code.end()},
                                   std::vector<u32>{patch_spv.begin(), patch_spv.end()}, is_patched);
 }
+
+void DebugStateImpl::AnalyzeFlip() {
+    // Frames need to be this much slower than the average to count as spikes, so that the usual
+    // jitter of the presentation is ignored.
+    constexpr float SpikeFactor = 2.0f;
+    constexpr float SpikeMinExcessMs = 8.0f;
+    constexpr float AverageWeight = 0.05f;
+    constexpr u32 WarmupFrames = 60;
+    constexpr size_t MaxFrameSpikes = 64;
+
+    renderer_counters.Aggregate();
+
+    FrameSpike frame{};
+    for (size_t i = 0; i < NumStallCauses; i++) {
+        frame.counts[i] = stall_counts[i].exchange(0, std::memory_order_relaxed);
+        frame.wait_us[i] = stall_wait_us[i].exchange(0, std::memory_order_relaxed);
+    }
+    const auto now = std::chrono::steady_clock::now();
+    const auto last = std::exchange(last_flip_time, now);
+    if (last.time_since_epoch().count() == 0 || IsGuestThreadsPaused()) {
+        return;
+    }
+    frame.frame = flip_frame_count.load(std::memory_order_relaxed);
+    frame.time_ms = std::chrono::duration<float, std::milli>(now - last).count();
+    frame.average_ms = average_frame_ms;
+    average_frame_ms = average_frame_ms == 0.0f
+                           ? frame.time_ms
+                           : average_frame_ms + AverageWeight * (frame.time_ms - average_frame_ms);
+    if (frame.frame < WarmupFrames || frame.time_ms < frame.average_ms * SpikeFactor ||
+        frame.time_ms - frame.average_ms < SpikeMinExcessMs) {
+        return;
+    }
+    LOG_WARNING(Render, "Frame {} took {:.2f} ms, {:.2f} ms on average: {}", frame.frame,
+                frame.time_ms, frame.average_ms, frame.Describe());
+    std::scoped_lock lock{frame_spikes_mutex};
+    if (frame_spikes.size() == MaxFrameSpikes) {
+        frame_spikes.pop_front();
+    }
+    frame_spikes.push_back(frame);
+}
+
+std::vector<FrameSpike> DebugStateImpl::GetFrameSpikes() const {
+    std::scoped_lock lock{frame_spikes_mutex};
+    return {frame_spikes.begin(), frame_spikes.end()};
+}
@@ -3,7 +3,11 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
+#include <chrono>
+#include <deque>
+#include <filesystem>
 #include <mutex>
 #include <shared_mutex>
 #include <unordered_map>
@@ -75,10 +79,93 @@ struct RegDump {
     PipelineComputerProgramDump cs_data{};
 };
 
+/// Events that commonly make a frame stutter. They are counted as they happen on any thread and
+/// attributed to the frame that is presented next.
+enum class StallCause : u32 {
+    ShaderCompile,
+    PipelineCompile,
+    ImageEviction,
+    ImageUpload,
+    BufferDownload,
+    GpuIdleWait,
+    PageFault,
+    AioWait,
+    FrameWait,
+    Count,
+};
+
+constexpr size_t NumStallCauses = static_cast<size_t>(StallCause::Count);
+
+const char* StallCauseName(StallCause cause);
+
+/// Counters of the renderer caches, reported per presented frame and in total.
+enum class RendererCounter : u32 {
+    ImagesCreated,
+    ImageOverlaps,
+    ImageUploads,
+    ImageUploadBytes,
+    BuffersCreated,
+    BufferSyncs,
+    BufferUploadBytes,
+    BufferDownloads,
+    DownloadStalls,
+    StreamBytes,
+    StagingBytes,
+    ReadbackBytes,
+    PredictedReadbacks,
+    ShaderCompiles,
+    SpirvCacheHits,
+    SpirvCacheMisses,
+    PipelineLookups,
+    PipelinesCreated,
+    DescriptorWrites,
+    ShaderHleDispatches,
+    Count,
+};
+
+constexpr size_t NumRendererCounters = static_cast<size_t>(RendererCounter::Count);
+
+const char* RendererCounterName(RendererCounter counter);
+
+/// Statistics of a Vulkan memory heap as reported by VMA.
+struct GpuHeap {
+    u64 size;
+    u64 budget;
+    /// Memory used by the process, including allocations made outside of VMA.
+    u64 usage;
+    /// Memory of the VMA blocks in the heap and of the allocations made from them.
+    u64 block_bytes;
+    u64 allocation_bytes;
+    u32 num_allocations;
+    bool device_local;
+};
+
+struct FrameSpike {
+    u32 frame;
+    float time_ms;
+    float average_ms;
+    std::array<u32, NumStallCauses> counts;
+    /// Time spent blocked for the causes that are waits, in microseconds.
+    std::array<u32, NumStallCauses> wait_us;
+
+    /// Lists the stalls seen in the frame, like "2 shader compiles, gpu idle wait 3.1 ms".
+    [[nodiscard]] std::string Describe() const;
+};
+
 struct FrameDump {
     u32 frame_id;
     std::vector<QueueDump> queues;
     std::unordered_map<uintptr_t, RegDump> regs; // address -> reg dump
+
+    /**
+     * Writes the frame as a capture file, all fields are little endian:
+     *  - header: magic "SPM4", version, frame id, number of queues, number of reg dumps (u32)
+     *  - queue: type, submit num, num2 (u32), base address, number of dwords (u64), dwords
+     *  - reg dump: draw address (u64), is compute (u32), raw AmdGpu::Regs, then for the
+     *    compute stage or each of the MaxShaderStages graphics stages the code address, hash,
+     *    number of dwords (u64) and the shader code, so the shader memory travels with it.
+     */
+    bool SaveCapture(const std::filesystem::path& path) const;
 };
 
 struct ShaderDump {
@@ -156,6 +243,15 @@ class DebugStateImpl {
 
     std::vector<ShaderDump> shader_dump_list{};
 
+    std::array<std::atomic<u32>, NumStallCauses> stall_counts{};
+    std::array<std::atomic<u32>, NumStallCauses> stall_wait_us{};
+    std::chrono::steady_clock::time_point last_flip_time{};
+    float average_frame_ms{};
+    mutable std::mutex frame_spikes_mutex;
+    std::deque<FrameSpike> frame_spikes;
+    mutable std::mutex gpu_heaps_mutex;
+    std::vector<GpuHeap> gpu_heaps;
+
 public:
     float Framerate = 1.0f / 60.0f;
     float FrameDeltaTime;
@@ -164,6 +260,63 @@ public:
     std::pair<u32, u32> output_resolution{};
     bool is_using_fsr{};
 
+    struct TextureCacheMemory {
+        std::atomic<u64> device_usage{};
+        std::atomic<u64> device_budget{};
+        std::atomic<u64> image_memory{};
+        std::atomic<u32> num_images{};
+        std::atomic<u32> num_evicted{};
+    } texture_cache_memory;
+
+    struct RendererCounters {
+        std::array<std::atomic<u64>, NumRendererCounters> pending{};
+        std::array<std::atomic<u64>, NumRendererCounters> last_frame{};
+        std::array<std::atomic<u64>, NumRendererCounters> total{};
+
+        void Add(RendererCounter counter, u64 value = 1) {
+            pending[static_cast<size_t>(counter)].fetch_add(value, std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] u64 LastFrame(RendererCounter counter) const {
+            return last_frame[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] u64 Total(RendererCounter counter) const {
+            return total[static_cast<size_t>(counter)].load(std::memory_order_relaxed);
+        }
+
+        /// Moves the pending counts into the values of the presented frame.
+        void Aggregate() {
+            for (size_t i = 0; i < NumRendererCounters; i++) {
+                const u64 value = pending[i].exchange(0, std::memory_order_relaxed);
+                last_frame[i].store(value, std::memory_order_relaxed);
+                total[i].fetch_add(value, std::memory_order_relaxed);
+            }
+        }
+    } renderer_counters;
+
+    struct AudioPortStats {
+        std::atomic<bool> is_open{};
+        std::atomic<s32> type{};
+        std::atomic<u32> buffer_frames{};
+        std::atomic<u64> num_outputs{};
+        /// Frames waiting on the host after the last output.
+        std::atomic<u32> queued_frames{};
+        /// Gaps in the guest output while the port was playing.
+        std::atomic<u32> underruns{};
+        /// Deviation of the last and largest output interval from the buffer time.
+        std::atomic<u32> jitter_us{};
+        std::atomic<u32> max_jitter_us{};
+    };
+
+    struct AudioStats {
+        static constexpr size_t NumPorts = 22;
+        std::array<AudioPortStats, NumPorts> ports{};
+        std::atomic<u64> ajm_jobs{};
+        std::atomic<u32> ajm_decode_us{};
+        std::atomic<u32> ajm_max_decode_us{};
+    } audio_stats;
+
     void ShowDebugMessage(std::string message) {
         if (message.empty()) {
             return;
@@ -177,8 +330,23 @@ public:
 
     void AddCurrentThreadToGuestList();
 
+    [[nodiscard]] std::vector<ThreadID> GetGuestThreads() {
+        std::lock_guard lock{guest_threads_mutex};
+        return guest_threads;
+    }
+
     void RemoveCurrentThreadFromGuestList();
 
+    void SetGpuHeaps(std::vector<GpuHeap> heaps) {
+        std::scoped_lock lock{gpu_heaps_mutex};
+        gpu_heaps = std::move(heaps);
+    }
+
+    [[nodiscard]] std::vector<GpuHeap> GetGpuHeaps() const {
+        std::scoped_lock lock{gpu_heaps_mutex};
+        return gpu_heaps;
+    }
+
     void PauseGuestThreads();
 
     void ResumeGuestThreads();
@@ -191,6 +359,20 @@ public:
         ++flip_frame_count;
     }
 
+    void AddStall(StallCause cause, u32 wait_us = 0) {
+        const auto index = static_cast<size_t>(cause);
+        stall_counts[index].fetch_add(1, std::memory_order_relaxed);
+        if (wait_us != 0) {
+            stall_wait_us[index].fetch_add(wait_us, std::memory_order_relaxed);
+        }
+    }
+
+    /// Aggregates the renderer counters and attributes the stalls since the last flip to the
+    /// presented frame, logging the frame with them when it took much longer than the average.
+    void AnalyzeFlip();
+
+    [[nodiscard]] std::vector<FrameSpike> GetFrameSpikes() const;
+
     void IncGnmFrameNum() {
         ++gnm_frame_count;
         --gnm_frame_dump_request_count;
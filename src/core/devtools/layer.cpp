@@ -11,12 +11,16 @@
 #include "common/singleton.h"
 #include "common/types.h"
 #include "core/debug_state.h"
+#include "core/sampling_profiler.h"
 #include "imgui/imgui_std.h"
 #include "imgui_internal.h"
 #include "options.h"
 #include "video_core/renderer_vulkan/vk_presenter.h"
+#include "widget/audio_info.h"
 #include "widget/frame_dump.h"
 #include "widget/frame_graph.h"
+#include "widget/gpu_memory.h"
+#include "widget/hle_calls.h"
 #include "widget/memory_map.h"
 #include "widget/module_list.h"
 #include "widget/shader_list.h"
@@ -44,6 +48,9 @@ static bool just_opened_options = false;
 static Widget::MemoryMapViewer memory_map;
 static Widget::ShaderList shader_list;
 static Widget::ModuleList module_list;
+static Widget::HleCalls hle_calls;
+static Widget::GpuMemory gpu_memory;
+static Widget::AudioInfo audio_info;
 
 // clang-format off
 static std::string help_text =
@@ -74,6 +81,7 @@ void L::DrawMenuBar() {
         if (BeginMenu("GPU Tools")) {
             MenuItem("Show frame info", nullptr, &frame_graph.is_open);
             MenuItem("Show loaded shaders", nullptr, &shader_list.open);
+            MenuItem("Show GPU memory", nullptr, &gpu_memory.open);
             if (BeginMenu("Dump frames")) {
                 SliderInt("Count", &dump_frame_count, 1, 5);
                 if (MenuItem("Dump", "Ctrl+Alt+F9", nullptr, !DebugState.DumpingCurrentFrame())) {
@@ -125,6 +133,21 @@ void L::DrawMenuBar() {
             if (MenuItem("Module list")) {
                 module_list.open = true;
             }
+            if (MenuItem("Audio info")) {
+                audio_info.open = true;
+            }
+            if (MenuItem("HLE calls")) {
+                hle_calls.open = true;
+            }
+            Separator();
+            if (!Core::SamplingProfiler::IsRunning()) {
+                if (MenuItem("Start CPU profile")) {
+                    Core::SamplingProfiler::Start();
+                }
+            } else if (MenuItem("Stop CPU profile")) {
+                Core::SamplingProfiler::Stop(Common::FS::GetUserPath(Common::FS::PathType::LogDir) /
+                                             "cpu_profile.folded");
+            }
             ImGui::EndMenu();
         }
 
@@ -269,11 +292,20 @@ void L::DrawAdvanced() {
     if (module_list.open) {
         module_list.Draw();
     }
+    if (audio_info.open) {
+        audio_info.Draw();
+    }
+    if (hle_calls.open) {
+        hle_calls.Draw();
+    }
+    if (gpu_memory.open) {
+        gpu_memory.Draw();
+    }
 }
 
 void L::DrawSimple() {
     const float frameRate = DebugState.Framerate;
-    if (Config::fpsColor()) {
+    if (Config::GetSnapshot().fps_color) {
         if (frameRate < 10) {
             PushStyleColor(ImGuiCol_Text, ImVec4(1.0f, 0.0f, 0.0f, 1.0f)); // Red
         } else if (frameRate >= 10 && frameRate < 20) {
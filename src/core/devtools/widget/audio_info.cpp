@@ -0,0 +1,100 @@
+//  SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "audio_info.h"
+
+#include <imgui.h>
+
+#include "core/debug_state.h"
+
+using namespace ImGui;
+
+namespace Core::Devtools::Widget {
+
+static const char* GetPortTypeName(s32 type) {
+    switch (type) {
+    case 0:
+        return "Main";
+    case 1:
+        return "BGM";
+    case 2:
+        return "Voice";
+    case 3:
+        return "Personal";
+    case 4:
+        return "PadSpk";
+    case 126:
+        return "Audio3d";
+    case 127:
+        return "Aux";
+    default:
+        return "Unknown";
+    }
+}
+
+void AudioInfo::Draw() {
+    SetNextWindowSize({520.0f, 300.0f}, ImGuiCond_FirstUseEver);
+    if (!Begin("Audio Info", &open)) {
+        End();
+        return;
+    }
+
+    auto& stats = DebugState.audio_stats;
+
+    SeparatorText("AudioOut ports");
+    if (BeginTable("AudioPortTable", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+        TableSetupColumn("Port");
+        TableSetupColumn("Type");
+        TableSetupColumn("Buffer");
+        TableSetupColumn("Queued");
+        TableSetupColumn("Underruns");
+        TableSetupColumn("Jitter (us)");
+        TableSetupColumn("Max jitter (us)");
+        TableHeadersRow();
+
+        for (size_t i = 0; i < stats.ports.size(); i++) {
+            const auto& port = stats.ports[i];
+            if (!port.is_open.load(std::memory_order_relaxed)) {
+                continue;
+            }
+            TableNextRow();
+            TableSetColumnIndex(0);
+            Text("%zu", i + 1);
+            TableSetColumnIndex(1);
+            TextUnformatted(GetPortTypeName(port.type.load(std::memory_order_relaxed)));
+            TableSetColumnIndex(2);
+            Text("%u", port.buffer_frames.load(std::memory_order_relaxed));
+            TableSetColumnIndex(3);
+            Text("%u", port.queued_frames.load(std::memory_order_relaxed));
+            TableSetColumnIndex(4);
+            const u32 underruns = port.underruns.load(std::memory_order_relaxed);
+            if (underruns != 0) {
+                TextColored({1.0f, 0.4f, 0.3f, 1.0f}, "%u", underruns);
+            } else {
+                Text("%u", underruns);
+            }
+            TableSetColumnIndex(5);
+            Text("%u", port.jitter_us.load(std::memory_order_relaxed));
+            TableSetColumnIndex(6);
+            Text("%u", port.max_jitter_us.load(std::memory_order_relaxed));
+        }
+        EndTable();
+    }
+
+    SeparatorText("AJM");
+    Text("Jobs: %llu", static_cast<unsigned long long>(stats.ajm_jobs.load()));
+    Text("Decode time: %u us (max %u us)", stats.ajm_decode_us.load(),
+         stats.ajm_max_decode_us.load());
+
+    if (Button("Reset")) {
+        for (auto& port : stats.ports) {
+            port.underruns = 0;
+            port.max_jitter_us = 0;
+        }
+        stats.ajm_max_decode_us = 0;
+    }
+
+    End();
+}
+
+} // namespace Core::Devtools::Widget
@@ -0,0 +1,18 @@
+//  SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+namespace Core::Devtools::Widget {
+
+/// Shows the AudioOut port and AJM counters, to correlate crackling with CPU load.
+class AudioInfo {
+public:
+    AudioInfo() = default;
+    ~AudioInfo() = default;
+
+    void Draw();
+    bool open = false;
+};
+
+} // namespace Core::Devtools::Widget
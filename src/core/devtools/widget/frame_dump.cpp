@@ -135,6 +135,19 @@ void FrameDumpViewer::Draw() {
         }
         EndDisabled();
         SameLine();
+        if (SmallButton("Save capture")) {
+            auto time = std::time(nullptr);
+            auto now_time = *std::localtime(&time);
+            const auto fname =
+                fmt::format("{:%F %H-%M-%S} frame_{}.spm4", now_time, frame_dump->frame_id);
+            if (frame_dump->SaveCapture(fname)) {
+                DebugState.ShowDebugMessage(fmt::format("Saved capture as {}", fname));
+            } else {
+                DebugState.ShowDebugMessage(fmt::format("Failed to save {}", fname));
+                LOG_ERROR(Core, "Failed to write capture {}", fname);
+            }
+        }
+        SameLine();
         if (BeginMenu("Filter")) {
 
             TextUnformatted("Shader name");
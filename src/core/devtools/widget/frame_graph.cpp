@@ -3,11 +3,17 @@
 
 #include "frame_graph.h"
 
+#include <fmt/format.h>
+
 #include "common/config.h"
 #include "common/singleton.h"
 #include "core/debug_state.h"
 #include "imgui.h"
 #include "imgui_internal.h"
+#include "video_core/renderer_vulkan/vk_presenter.h"
+#include "video_core/renderer_vulkan/vk_rasterizer.h"
+
+extern std::unique_ptr<Vulkan::Presenter> presenter;
 
 using namespace ImGui;
 
@@ -17,6 +23,8 @@ constexpr float BAR_WIDTH_MULT = 1.4f;
 constexpr float BAR_HEIGHT_MULT = 1.25f;
 constexpr float FRAME_GRAPH_PADDING_Y = 3.0f;
 constexpr static float FRAME_GRAPH_HEIGHT = 50.0f;
+constexpr float GPU_TIMELINE_ROW_HEIGHT = 12.0f;
+constexpr u32 GPU_TIMELINE_MAX_DEPTH = 8;
 
 void FrameGraph::DrawFrameGraph() {
     // Frame graph - inspired by
@@ -29,7 +37,7 @@ void FrameGraph::DrawFrameGraph() {
         return;
     }
 
-    float target_dt = 1.0f / (float)Config::vblankFreq();
+    float target_dt = 1.0f / (float)Config::GetSnapshot().vblank_freq;
     float cur_pos_x = pos.x + full_width;
     pos.y += FRAME_GRAPH_PADDING_Y;
     const float final_pos_y = pos.y + FRAME_GRAPH_HEIGHT;
@@ -69,6 +77,51 @@ void FrameGraph::DrawFrameGraph() {
     draw_list.PopClipRect();
 }
 
+void FrameGraph::DrawGpuTimeline(const Vulkan::GpuProfiler& profiler) {
+    const auto frame = profiler.GetLastFrame();
+    Text("GPU time: %.3f ms in %zu zones", static_cast<double>(frame.duration_ns) / 1e6,
+         frame.zones.size());
+    if (frame.duration_ns == 0) {
+        return;
+    }
+
+    // Render passes are drawn on the first row, nested scope markers on the rows below it.
+    u32 max_depth = 0;
+    for (const auto& zone : frame.zones) {
+        max_depth = std::max(max_depth, std::min(zone.depth, GPU_TIMELINE_MAX_DEPTH));
+    }
+    const float full_width = GetContentRegionAvail().x;
+    const auto pos = GetCursorScreenPos();
+    const ImVec2 size{full_width, GPU_TIMELINE_ROW_HEIGHT * static_cast<float>(max_depth + 1)};
+    ItemSize(size);
+    if (!ItemAdd({pos, pos + size}, GetID("GpuTimeline"))) {
+        return;
+    }
+
+    auto& draw_list = *GetWindowDrawList();
+    draw_list.AddRectFilled(pos, pos + size, IM_COL32(0x33, 0x33, 0x33, 0xFF));
+    draw_list.PushClipRect(pos, pos + size, true);
+    const float scale = full_width / static_cast<float>(frame.duration_ns);
+    for (const auto& zone : frame.zones) {
+        if (zone.depth > GPU_TIMELINE_MAX_DEPTH) {
+            continue;
+        }
+        const float x0 = pos.x + static_cast<float>(zone.begin_ns) * scale;
+        const float x1 = std::max(pos.x + static_cast<float>(zone.end_ns) * scale, x0 + 1.0f);
+        const float y0 = pos.y + GPU_TIMELINE_ROW_HEIGHT * static_cast<float>(zone.depth);
+        const ImVec2 min{x0, y0};
+        const ImVec2 max{x1, y0 + GPU_TIMELINE_ROW_HEIGHT - 1.0f};
+        const ImU32 color = zone.depth == 0 ? IM_COL32(0x2A, 0x9D, 0x8F, 0xFF)
+                                            : IM_COL32(0xF4, 0xA2 - zone.depth * 0x10, 0x61, 0xFF);
+        draw_list.AddRectFilled(min, max, color);
+        if (IsMouseHoveringRect(min, max)) {
+            SetTooltip("%s: %.3f ms", zone.name.c_str(),
+                       static_cast<double>(zone.end_ns - zone.begin_ns) / 1e6);
+        }
+    }
+    draw_list.PopClipRect();
+}
+
 void FrameGraph::Draw() {
     if (!is_open) {
         return;
@@ -90,6 +143,11 @@ void FrameGraph::Draw() {
         SeparatorText("Frame graph");
         DrawFrameGraph();
 
+        if (const auto* profiler = presenter->GetRasterizer().GetGpuProfiler()) {
+            SeparatorText("GPU timeline");
+            DrawGpuTimeline(*profiler);
+        }
+
         SeparatorText("Renderer info");
 
         Text("Frame time: %.3f ms (%.1f FPS)", deltaTime, frameRate);
@@ -101,6 +159,49 @@ void FrameGraph::Draw() {
         Text("Output Res: %dx%d", DebugState.output_resolution.first,
              DebugState.output_resolution.second);
         Text("FSR: %s", DebugState.is_using_fsr ? "on" : "off");
+
+        SeparatorText("Video memory");
+
+        const auto& tc_memory = DebugState.texture_cache_memory;
+        constexpr float MB = 1024.0f * 1024.0f;
+        const float usage = float(tc_memory.device_usage.load()) / MB;
+        const float budget = float(tc_memory.device_budget.load()) / MB;
+        Text("Device: %.1f / %.1f MB", usage, budget);
+        if (budget > 0.0f) {
+            ProgressBar(std::min(usage / budget, 1.0f), ImVec2{-FLT_MIN, 0.0f});
+        }
+        Text("Texture cache: %.1f MB in %u images", float(tc_memory.image_memory.load()) / MB,
+             tc_memory.num_images.load());
+        Text("Evicted images: %u", tc_memory.num_evicted.load());
+
+        if (CollapsingHeader("Renderer counters")) {
+            const auto& counters = DebugState.renderer_counters;
+            if (BeginTable("RendererCounters", 3, ImGuiTableFlags_RowBg)) {
+                TableSetupColumn("Counter");
+                TableSetupColumn("Last frame");
+                TableSetupColumn("Total");
+                TableHeadersRow();
+                for (u32 i = 0; i < DebugStateType::NumRendererCounters; i++) {
+                    const auto counter = static_cast<DebugStateType::RendererCounter>(i);
+                    TableNextRow();
+                    TableNextColumn();
+                    TextUnformatted(DebugStateType::RendererCounterName(counter));
+                    TableNextColumn();
+                    Text("%llu", static_cast<unsigned long long>(counters.LastFrame(counter)));
+                    TableNextColumn();
+                    Text("%llu", static_cast<unsigned long long>(counters.Total(counter)));
+                }
+                EndTable();
+            }
+        }
+
+        const auto spikes = DebugState.GetFrameSpikes();
+        if (CollapsingHeader(fmt::format("Stutters ({})###Stutters", spikes.size()).c_str())) {
+            for (auto it = spikes.rbegin(); it != spikes.rend(); ++it) {
+                TextWrapped("Frame %u: %.2f ms (%.2f ms avg), %s", it->frame, it->time_ms,
+                            it->average_ms, it->Describe().c_str());
+            }
+        }
     }
     End();
 }
@@ -5,6 +5,10 @@
 
 #include "common/types.h"
 
+namespace Vulkan {
+class GpuProfiler;
+}
+
 namespace Core::Devtools::Widget {
 
 class FrameGraph {
@@ -20,6 +24,7 @@ class FrameGraph {
     float frameRate{};
 
     void DrawFrameGraph();
+    void DrawGpuTimeline(const Vulkan::GpuProfiler& profiler);
 
 public:
     bool is_open = true;
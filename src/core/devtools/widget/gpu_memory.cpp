@@ -0,0 +1,118 @@
+//  SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "gpu_memory.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <fmt/format.h>
+#include <imgui.h>
+
+using namespace ImGui;
+
+namespace Core::Devtools::Widget {
+
+namespace {
+
+float ToMiB(u64 bytes) {
+    return static_cast<float>(bytes) / (1024.0f * 1024.0f);
+}
+
+} // Anonymous namespace
+
+void GpuMemory::Sample() {
+    // Counters are aggregated once per presented frame, so history advances with the frame number.
+    const u32 frame = DebugState.GetFrameNum();
+    if (frame == last_frame) {
+        return;
+    }
+    last_frame = frame;
+    heaps = DebugState.GetGpuHeaps();
+
+    const auto& counters = DebugState.renderer_counters;
+    for (auto& transfer : transfers) {
+        transfer.kib_per_frame[history_pos] =
+            static_cast<float>(counters.LastFrame(transfer.counter)) / 1024.0f;
+    }
+    u64 device_usage = 0;
+    for (const auto& heap : heaps) {
+        device_usage += heap.device_local ? heap.usage : 0;
+    }
+    device_usage_mib[history_pos] = ToMiB(device_usage);
+    history_pos = (history_pos + 1) % HistorySize;
+}
+
+void GpuMemory::DrawHeaps() {
+    constexpr ImGuiTableFlags flags = ImGuiTableFlags_RowBg | ImGuiTableFlags_Resizable;
+    if (!BeginTable("GpuHeaps", 7, flags)) {
+        return;
+    }
+    TableSetupColumn("Heap");
+    TableSetupColumn("Size MiB");
+    TableSetupColumn("Budget MiB");
+    TableSetupColumn("Usage MiB");
+    TableSetupColumn("Blocks MiB");
+    TableSetupColumn("Allocated MiB");
+    TableSetupColumn("Allocations");
+    TableHeadersRow();
+    for (size_t i = 0; i < heaps.size(); i++) {
+        const auto& heap = heaps[i];
+        TableNextRow();
+        TableNextColumn();
+        Text("%zu%s", i, heap.device_local ? " (device local)" : "");
+        TableNextColumn();
+        Text("%.1f", ToMiB(heap.size));
+        TableNextColumn();
+        Text("%.1f", ToMiB(heap.budget));
+        TableNextColumn();
+        if (heap.budget != 0 && heap.usage > heap.budget * 9 / 10) {
+            TextColored({1.0f, 0.4f, 0.4f, 1.0f}, "%.1f", ToMiB(heap.usage));
+        } else {
+            Text("%.1f", ToMiB(heap.usage));
+        }
+        TableNextColumn();
+        Text("%.1f", ToMiB(heap.block_bytes));
+        TableNextColumn();
+        Text("%.1f", ToMiB(heap.allocation_bytes));
+        TableNextColumn();
+        Text("%u", heap.num_allocations);
+    }
+    EndTable();
+}
+
+void GpuMemory::Draw() {
+    Sample();
+    SetNextWindowSize({620.0f, 520.0f}, ImGuiCond_FirstUseEver);
+    if (!Begin("GPU memory", &open)) {
+        End();
+        return;
+    }
+
+    if (CollapsingHeader("Heaps", ImGuiTreeNodeFlags_DefaultOpen)) {
+        DrawHeaps();
+        const auto& textures = DebugState.texture_cache_memory;
+        Text("Texture cache: %.1f MiB of images, %u images, %u evicted",
+             ToMiB(textures.image_memory.load()), textures.num_images.load(),
+             textures.num_evicted.load());
+        const auto usage = fmt::format("{:.1f} MiB", device_usage_mib[LastSample()]);
+        PlotLines("Device local", device_usage_mib.data(), HistorySize,
+                  static_cast<int>(history_pos), usage.c_str(), 0.0f, FLT_MAX, {0.0f, 60.0f});
+    }
+
+    if (CollapsingHeader("Transfers", ImGuiTreeNodeFlags_DefaultOpen)) {
+        const auto& counters = DebugState.renderer_counters;
+        for (const auto& transfer : transfers) {
+            const float peak = *std::ranges::max_element(transfer.kib_per_frame);
+            const auto overlay =
+                fmt::format("{:.1f} KiB/frame, peak {:.1f}, total {:.1f} MiB",
+                            transfer.kib_per_frame[LastSample()],
+                            peak, ToMiB(counters.Total(transfer.counter)));
+            PlotHistogram(transfer.name, transfer.kib_per_frame.data(), HistorySize,
+                          static_cast<int>(history_pos), overlay.c_str(), 0.0f, FLT_MAX,
+                          {0.0f, 50.0f});
+        }
+    }
+    End();
+}
+
+} // namespace Core::Devtools::Widget
@@ -0,0 +1,51 @@
+//  SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "core/debug_state.h"
+
+namespace Core::Devtools::Widget {
+
+/// Shows the heaps of the Vulkan allocator and graphs the bytes moved between CPU and GPU.
+class GpuMemory {
+public:
+    GpuMemory() = default;
+    ~GpuMemory() = default;
+
+    void Draw();
+    bool open = false;
+
+private:
+    static constexpr size_t HistorySize = 256;
+
+    struct Transfer {
+        const char* name;
+        DebugStateType::RendererCounter counter;
+        std::array<float, HistorySize> kib_per_frame{};
+    };
+
+    void Sample();
+    void DrawHeaps();
+
+    [[nodiscard]] size_t LastSample() const {
+        return (history_pos + HistorySize - 1) % HistorySize;
+    }
+
+    u32 last_frame{};
+    size_t history_pos{};
+    std::array<Transfer, 5> transfers{{
+        {"CPU to GPU, stream", DebugStateType::RendererCounter::StreamBytes},
+        {"CPU to GPU, staging", DebugStateType::RendererCounter::StagingBytes},
+        {"GPU to CPU, readback", DebugStateType::RendererCounter::ReadbackBytes},
+        {"Image uploads", DebugStateType::RendererCounter::ImageUploadBytes},
+        {"Buffer uploads", DebugStateType::RendererCounter::BufferUploadBytes},
+    }};
+    std::array<float, HistorySize> device_usage_mib{};
+    std::vector<DebugStateType::GpuHeap> heaps;
+};
+
+} // namespace Core::Devtools::Widget
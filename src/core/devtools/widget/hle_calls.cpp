@@ -0,0 +1,71 @@
+//  SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "hle_calls.h"
+
+#include <imgui.h>
+
+using namespace ImGui;
+
+namespace Core::Devtools::Widget {
+
+void HleCalls::Refresh(double now) {
+    const double elapsed = now - last_refresh;
+    last_refresh = now;
+    rows = Libraries::HleProfiler::GetTopCalls(MaxRows);
+    rates.resize(rows.size());
+    for (size_t i = 0; i < rows.size(); i++) {
+        auto& last = last_calls[rows[i].name];
+        rates[i] = elapsed > 0.0 ? static_cast<double>(rows[i].calls - last) / elapsed : 0.0;
+        last = rows[i].calls;
+    }
+}
+
+void HleCalls::Draw() {
+    SetNextWindowSize({560.0f, 400.0f}, ImGuiCond_FirstUseEver);
+    if (!Begin("HLE calls", &open)) {
+        End();
+        return;
+    }
+    if (!Libraries::HleProfiler::IsEnabled()) {
+        TextWrapped("HLE calls are only counted in builds with ENABLE_HLE_PROFILER.");
+        End();
+        return;
+    }
+
+    const double now = GetTime();
+    if (now - last_refresh >= RefreshInterval) {
+        Refresh(now);
+    }
+    Text("Latency is sampled every %llu calls",
+         static_cast<unsigned long long>(Libraries::HleProfiler::SampleInterval));
+    constexpr ImGuiTableFlags flags =
+        ImGuiTableFlags_RowBg | ImGuiTableFlags_ScrollY | ImGuiTableFlags_Resizable;
+    if (BeginTable("HleCalls", 5, flags)) {
+        TableSetupScrollFreeze(0, 1);
+        TableSetupColumn("Function");
+        TableSetupColumn("Calls");
+        TableSetupColumn("Calls/s");
+        TableSetupColumn("Avg us");
+        TableSetupColumn("Max us");
+        TableHeadersRow();
+        for (size_t i = 0; i < rows.size(); i++) {
+            const auto& row = rows[i];
+            TableNextRow();
+            TableNextColumn();
+            TextUnformatted(row.name.c_str());
+            TableNextColumn();
+            Text("%llu", static_cast<unsigned long long>(row.calls));
+            TableNextColumn();
+            Text("%.0f", rates[i]);
+            TableNextColumn();
+            Text("%.2f", row.average_us);
+            TableNextColumn();
+            Text("%.2f", row.max_us);
+        }
+        EndTable();
+    }
+    End();
+}
+
+} // namespace Core::Devtools::Widget
@@ -0,0 +1,35 @@
+//  SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "core/libraries/hle_profiler.h"
+
+namespace Core::Devtools::Widget {
+
+/// Lists the most called HLE exports with their call rate and sampled latency.
+class HleCalls {
+public:
+    HleCalls() = default;
+    ~HleCalls() = default;
+
+    void Draw();
+    bool open = false;
+
+private:
+    static constexpr double RefreshInterval = 1.0;
+    static constexpr size_t MaxRows = 100;
+
+    void Refresh(double now);
+
+    double last_refresh{};
+    std::vector<Libraries::HleProfiler::CallSummary> rows;
+    std::vector<double> rates;
+    std::unordered_map<std::string, u64> last_calls;
+};
+
+} // namespace Core::Devtools::Widget
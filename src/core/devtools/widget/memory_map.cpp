@@ -13,52 +13,48 @@ using namespace ImGui;
 
 namespace Core::Devtools::Widget {
 
-bool MemoryMapViewer::Iterator::DrawLine() {
-    if (is_vma) {
-        if (vma.it == vma.end) {
-            return false;
-        }
-        auto m = vma.it->second;
-        if (m.type == VMAType::Free) {
-            ++vma.it;
-            return DrawLine();
+// The maps can hold thousands of areas, they are copied at most this often in seconds.
+constexpr double RefreshInterval = 0.5;
+
+void MemoryMapViewer::UpdateRows() {
+    auto mem = Memory::Instance();
+    std::scoped_lock lck{mem->mutex};
+
+    rows.clear();
+    if (showing_vma) {
+        for (const auto& [_, m] : mem->vma_map) {
+            if (m.type == VMAType::Free) {
+                continue;
+            }
+            rows.push_back({
+                .base = m.base,
+                .size = m.size,
+                .type = magic_enum::enum_name(m.type),
+                .prot = magic_enum::enum_name(m.prot),
+                .is_exec = m.is_exec,
+                .pooled = false,
+                .name = m.name,
+            });
         }
-        TableNextColumn();
-        Text("%" PRIXPTR, m.base);
-        TableNextColumn();
-        Text("%" PRIX64, m.size);
-        TableNextColumn();
-        Text("%s", magic_enum::enum_name(m.type).data());
-        TableNextColumn();
-        Text("%s", magic_enum::enum_name(m.prot).data());
-        TableNextColumn();
-        if (m.is_exec) {
-            Text("X");
+    } else {
+        for (const auto& [_, m] : mem->dmem_map) {
+            if (m.dma_type == DMAType::Free) {
+                continue;
+            }
+            const auto type = static_cast<::Libraries::Kernel::MemoryTypes>(m.memory_type);
+            rows.push_back({
+                .base = m.base,
+                .size = m.size,
+                .type = magic_enum::enum_name(type),
+                .prot = {},
+                .is_exec = false,
+                .pooled = m.dma_type == DMAType::Pooled || m.dma_type == DMAType::Committed,
+                .name = {},
+            });
         }
-        TableNextColumn();
-        Text("%s", m.name.c_str());
-        ++vma.it;
-        return true;
-    }
-    if (dmem.it == dmem.end) {
-        return false;
     }
-    auto m = dmem.it->second;
-    if (m.dma_type == DMAType::Free) {
-        ++dmem.it;
-        return DrawLine();
-    }
-    TableNextColumn();
-    Text("%" PRIXPTR, m.base);
-    TableNextColumn();
-    Text("%" PRIX64, m.size);
-    TableNextColumn();
-    auto type = static_cast<::Libraries::Kernel::MemoryTypes>(m.memory_type);
-    Text("%s", magic_enum::enum_name(type).data());
-    TableNextColumn();
-    Text("%d", m.dma_type == DMAType::Pooled || m.dma_type == DMAType::Committed);
-    ++dmem.it;
-    return true;
+    rows_vma = showing_vma;
+    last_update = GetTime();
 }
 
 void MemoryMapViewer::Draw() {
@@ -68,9 +64,6 @@ void MemoryMapViewer::Draw() {
         return;
     }
 
-    auto mem = Memory::Instance();
-    std::scoped_lock lck{mem->mutex};
-
     {
         bool next_showing_vma = showing_vma;
         if (showing_vma) {
@@ -95,15 +88,8 @@ void MemoryMapViewer::Draw() {
         showing_vma = next_showing_vma;
     }
 
-    Iterator it{};
-    if (showing_vma) {
-        it.is_vma = true;
-        it.vma.it = mem->vma_map.begin();
-        it.vma.end = mem->vma_map.end();
-    } else {
-        it.is_vma = false;
-        it.dmem.it = mem->dmem_map.begin();
-        it.dmem.end = mem->dmem_map.end();
+    if (rows_vma != showing_vma || GetTime() - last_update >= RefreshInterval) {
+        UpdateRows();
     }
 
     if (BeginTable("memory_view_table", showing_vma ? 6 : 4,
@@ -124,8 +110,32 @@ void MemoryMapViewer::Draw() {
         }
         TableHeadersRow();
 
-        while (it.DrawLine())
-            ;
+        // Only the visible rows are laid out.
+        ImGuiListClipper clipper;
+        clipper.Begin(static_cast<int>(rows.size()));
+        while (clipper.Step()) {
+            for (int i = clipper.DisplayStart; i < clipper.DisplayEnd; i++) {
+                const Row& row = rows[i];
+                TableNextColumn();
+                Text("%" PRIX64, row.base);
+                TableNextColumn();
+                Text("%" PRIX64, row.size);
+                TableNextColumn();
+                TextUnformatted(row.type.data(), row.type.data() + row.type.size());
+                TableNextColumn();
+                if (showing_vma) {
+                    TextUnformatted(row.prot.data(), row.prot.data() + row.prot.size());
+                    TableNextColumn();
+                    if (row.is_exec) {
+                        Text("X");
+                    }
+                    TableNextColumn();
+                    Text("%s", row.name.c_str());
+                } else {
+                    Text("%d", row.pooled);
+                }
+            }
+        }
         EndTable();
     }
 
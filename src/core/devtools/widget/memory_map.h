@@ -3,26 +3,33 @@
 
 #pragma once
 
-#include "core/memory.h"
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/types.h"
 
 namespace Core::Devtools::Widget {
 
 class MemoryMapViewer {
-    struct Iterator {
-        bool is_vma;
-        struct {
-            MemoryManager::DMemMap::iterator it;
-            MemoryManager::DMemMap::iterator end;
-        } dmem;
-        struct {
-            MemoryManager::VMAMap::iterator it;
-            MemoryManager::VMAMap::iterator end;
-        } vma;
-
-        bool DrawLine();
+    /// Copy of a mapped area, the tables are drawn from these so the memory manager is only
+    /// locked while they are refreshed.
+    struct Row {
+        u64 base;
+        u64 size;
+        std::string_view type;
+        std::string_view prot;
+        bool is_exec;
+        bool pooled;
+        std::string name;
     };
 
+    void UpdateRows();
+
     bool showing_vma = true;
+    bool rows_vma = true;
+    double last_update = -1.0;
+    std::vector<Row> rows;
 
 public:
     bool open = false;
@@ -1,6 +1,8 @@
 //  SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 //  SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cstring>
 #include <fstream>
 
 #include "shader_list.h"
@@ -217,6 +219,8 @@ bool ShaderList::Selection::DrawShader(DebugStateType::ShaderDump& value) {
         }
     }
 
+    DrawProfile(value);
+
     if (showing_bin) {
         isa_editor->Render(value.is_patched ? "SPIRV" : "ISA", GetContentRegionAvail());
     } else {
@@ -227,6 +231,35 @@ bool ShaderList::Selection::DrawShader(DebugStateType::ShaderDump& value) {
     return open;
 }
 
+void ShaderList::Selection::DrawProfile(const DebugStateType::ShaderDump& value) {
+    const auto* profiler = presenter->GetRasterizer().GetShaderProfiler();
+    if (!profiler) {
+        return;
+    }
+    const auto stats = profiler->GetStats(value.name, true);
+    if (!stats || !CollapsingHeader("Profile")) {
+        return;
+    }
+    Text("GPU time: %.3f ms in %llu draws", static_cast<double>(stats->gpu_time_ns) / 1e6,
+         static_cast<unsigned long long>(stats->num_dispatches));
+    const auto& counts = stats->block_counts;
+    if (counts.empty()) {
+        return;
+    }
+    // Blocks are colored from green to red by how often they ran compared to the hottest one.
+    const u32 max_count = std::max(*std::ranges::max_element(counts), 1U);
+    if (BeginChild("##block_heat", {0.0f, 150.0f})) {
+        for (size_t block = 0; block < counts.size(); ++block) {
+            const float heat = static_cast<float>(counts[block]) / static_cast<float>(max_count);
+            const auto label = fmt::format("Block {}: {}", block, counts[block]);
+            PushStyleColor(ImGuiCol_PlotHistogram, ImVec4{heat, 1.0f - heat, 0.0f, 1.0f});
+            ProgressBar(heat, {-FLT_MIN, 0.0f}, label.c_str());
+            PopStyleColor();
+        }
+    }
+    EndChild();
+}
+
 void ShaderList::Draw() {
     for (auto it = open_shaders.begin(); it != open_shaders.end();) {
         auto& selection = *it;
@@ -253,6 +286,7 @@ void ShaderList::Draw() {
     InputTextEx("##search_shader", "Search by name", search_box, sizeof(search_box), {},
                 ImGuiInputTextFlags_None);
 
+    const auto* profiler = presenter->GetRasterizer().GetShaderProfiler();
     auto width = GetContentRegionAvail().x;
     int i = 0;
     for (const auto& shader : DebugState.shader_dump_list) {
@@ -268,6 +302,11 @@ void ShaderList::Draw() {
         } else {
             snprintf(name, sizeof(name), "%s", shader.name.c_str());
         }
+        if (const auto stats = profiler ? profiler->GetStats(shader.name) : std::nullopt) {
+            const size_t len = std::strlen(name);
+            snprintf(name + len, sizeof(name) - len, " [%.3f ms]",
+                     static_cast<double>(stats->gpu_time_ns) / 1e6);
+        }
         if (ButtonEx(name, {width, 20.0f}, ImGuiButtonFlags_NoHoveredOnFocus)) {
             open_shaders.emplace_back(i);
         }
@@ -22,6 +22,8 @@ class ShaderList {
 
         bool DrawShader(DebugStateType::ShaderDump& value);
 
+        void DrawProfile(const DebugStateType::ShaderDump& value);
+
         int index{-1};
         std::unique_ptr<TextEditor> isa_editor{};
         std::unique_ptr<TextEditor> glsl_editor{};
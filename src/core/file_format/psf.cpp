@@ -6,6 +6,7 @@
 #include "common/assert.h"
 #include "common/io_file.h"
 #include "common/logging/log.h"
+#include "common/mapped_file.h"
 #include "core/file_format/psf.h"
 
 static const std::unordered_map<std::string_view, u32> psf_known_max_sizes = {
@@ -20,15 +21,21 @@ static inline u32 get_max_size(std::string_view key, u32 default_value) {
     return default_value;
 }
 
-bool PSF::Open(const std::filesystem::path& filepath) {
+void PSF::UpdateLastWrite(const std::filesystem::path& filepath) {
     using namespace std::chrono;
-    if (std::filesystem::exists(filepath)) {
-        const auto t = std::filesystem::last_write_time(filepath);
-        const auto rel =
-            duration_cast<seconds>(t - std::filesystem::file_time_type::clock::now()).count();
-        const auto tp = system_clock::to_time_t(system_clock::now() + seconds{rel});
-        last_write = system_clock::from_time_t(tp);
+    std::error_code ec;
+    const auto t = std::filesystem::last_write_time(filepath, ec);
+    if (ec) {
+        return;
     }
+    const auto rel =
+        duration_cast<seconds>(t - std::filesystem::file_time_type::clock::now()).count();
+    const auto tp = system_clock::to_time_t(system_clock::now() + seconds{rel});
+    last_write = system_clock::from_time_t(tp);
+}
+
+bool PSF::Open(const std::filesystem::path& filepath) {
+    UpdateLastWrite(filepath);
 
     Common::FS::IOFile file(filepath, Common::FS::FileAccessMode::Read);
     if (!file.IsOpen()) {
@@ -44,16 +51,40 @@ bool PSF::Open(const std::filesystem::path& filepath) {
 }
 
 bool PSF::Open(const std::vector<u8>& psf_buffer) {
-    const u8* psf_data = psf_buffer.data();
+    mapping.reset();
+    return Parse(psf_buffer, false);
+}
+
+bool PSF::OpenMapped(const std::filesystem::path& filepath) {
+    UpdateLastWrite(filepath);
+
+    auto file = std::make_shared<Common::FS::MappedFile>();
+    if (!file->Open(filepath)) {
+        return false;
+    }
+    mapping = std::move(file);
+    if (!Parse(mapping->Data(), true)) {
+        mapping.reset();
+        return false;
+    }
+    return true;
+}
 
+bool PSF::Parse(std::span<const u8> psf_data, bool is_view) {
     entry_list.clear();
     map_binaries.clear();
     map_strings.clear();
     map_integers.clear();
+    map_binary_views.clear();
+    map_string_views.clear();
 
     // Parse file contents
     PSFHeader header{};
-    std::memcpy(&header, psf_data, sizeof(header));
+    if (psf_data.size() < sizeof(header)) {
+        LOG_ERROR(Core, "PSF is too small: {} bytes", psf_data.size());
+        return false;
+    }
+    std::memcpy(&header, psf_data.data(), sizeof(header));
 
     if (header.magic != PSF_MAGIC) {
         LOG_ERROR(Core, "Invalid PSF magic number");
@@ -63,32 +94,56 @@ bool PSF::Open(const std::vector<u8>& psf_buffer) {
         LOG_ERROR(Core, "Unsupported PSF version: 0x{:08x}", header.version);
         return false;
     }
+    const u64 index_table_end =
+        sizeof(PSFHeader) + u64{header.index_table_entries} * sizeof(PSFRawEntry);
+    if (index_table_end > psf_data.size() || header.key_table_offset >= psf_data.size()) {
+        LOG_ERROR(Core, "PSF tables are out of bounds");
+        return false;
+    }
 
     for (u32 i = 0; i < header.index_table_entries; i++) {
         PSFRawEntry raw_entry{};
-        std::memcpy(&raw_entry, psf_data + sizeof(PSFHeader) + i * sizeof(PSFRawEntry),
+        std::memcpy(&raw_entry, psf_data.data() + sizeof(PSFHeader) + i * sizeof(PSFRawEntry),
                     sizeof(raw_entry));
 
+        const u64 key_offset = u64{header.key_table_offset} + raw_entry.key_offset;
+        const u64 data_offset = u64{header.data_table_offset} + raw_entry.data_offset;
+        if (key_offset >= psf_data.size() || data_offset + raw_entry.param_len > psf_data.size()) {
+            LOG_ERROR(Core, "PSF entry {} is out of bounds", i);
+            return false;
+        }
+
+        const auto* key = reinterpret_cast<const char*>(psf_data.data() + key_offset);
         Entry& entry = entry_list.emplace_back();
-        entry.key = std::string{(char*)(psf_data + header.key_table_offset + raw_entry.key_offset)};
+        entry.key = std::string{key, strnlen(key, psf_data.size() - key_offset)};
         entry.param_fmt = static_cast<PSFEntryFmt>(raw_entry.param_fmt.Raw());
         entry.max_len = raw_entry.param_max_len;
 
-        const u8* data = psf_data + header.data_table_offset + raw_entry.data_offset;
+        const u8* data = psf_data.data() + data_offset;
 
         switch (entry.param_fmt) {
         case PSFEntryFmt::Binary: {
+            if (is_view) {
+                map_binary_views.emplace(i, std::span{data, raw_entry.param_len});
+                break;
+            }
             std::vector<u8> value(raw_entry.param_len);
             std::memcpy(value.data(), data, raw_entry.param_len);
             map_binaries.emplace(i, std::move(value));
         } break;
         case PSFEntryFmt::Text: {
-            std::string c_str{reinterpret_cast<const char*>(data)};
-            map_strings.emplace(i, std::move(c_str));
+            const auto* c_str = reinterpret_cast<const char*>(data);
+            const std::string_view value{c_str, strnlen(c_str, raw_entry.param_len)};
+            if (is_view) {
+                map_string_views.emplace(i, value);
+                break;
+            }
+            map_strings.emplace(i, std::string{value});
         } break;
         case PSFEntryFmt::Integer: {
             ASSERT_MSG(raw_entry.param_len == sizeof(s32), "PSF integer entry size mismatch");
-            s32 integer = *(s32*)data;
+            s32 integer;
+            std::memcpy(&integer, data, sizeof(integer));
             map_integers.emplace(i, integer);
         } break;
         default:
@@ -98,6 +153,35 @@ bool PSF::Open(const std::vector<u8>& psf_buffer) {
     return true;
 }
 
+void PSF::DetachMapping() {
+    if (!mapping) {
+        return;
+    }
+    for (const auto& [index, value] : map_binary_views) {
+        map_binaries.emplace(index, std::vector<u8>{value.begin(), value.end()});
+    }
+    for (const auto& [index, value] : map_string_views) {
+        map_strings.emplace(index, std::string{value});
+    }
+    map_binary_views.clear();
+    map_string_views.clear();
+    mapping.reset();
+}
+
+std::span<const u8> PSF::BinaryAt(size_t index) const {
+    if (mapping) {
+        return map_binary_views.at(index);
+    }
+    return map_binaries.at(index);
+}
+
+std::string_view PSF::StringAt(size_t index) const {
+    if (mapping) {
+        return map_string_views.at(index);
+    }
+    return map_strings.at(index);
+}
+
 bool PSF::Encode(const std::filesystem::path& filepath) const {
     Common::FS::IOFile file(filepath, Common::FS::FileAccessMode::Write);
     if (!file.IsOpen()) {
@@ -157,13 +241,13 @@ void PSF::Encode(std::vector<u8>& psf_buffer) const {
 
         switch (entry.param_fmt) {
         case PSFEntryFmt::Binary: {
-            const auto& value = map_binaries.at(i);
+            const auto value = BinaryAt(i);
             raw_entry.param_len = value.size();
             additional_padding -= s32(raw_entry.param_len);
             std::ranges::copy(value, std::back_inserter(psf_buffer));
         } break;
         case PSFEntryFmt::Text: {
-            const auto& value = map_strings.at(i);
+            const auto value = StringAt(i);
             raw_entry.param_len = value.size() + 1;
             additional_padding -= s32(raw_entry.param_len);
             std::ranges::copy(value, std::back_inserter(psf_buffer));
@@ -191,7 +275,7 @@ std::optional<std::span<const u8>> PSF::GetBinary(std::string_view key) const {
         return {};
     }
     ASSERT(it->param_fmt == PSFEntryFmt::Binary);
-    return std::span{map_binaries.at(index)};
+    return BinaryAt(index);
 }
 
 std::optional<std::string_view> PSF::GetString(std::string_view key) const {
@@ -200,7 +284,7 @@ std::optional<std::string_view> PSF::GetString(std::string_view key) const {
         return {};
     }
     ASSERT(it->param_fmt == PSFEntryFmt::Text);
-    return std::string_view{map_strings.at(index)};
+    return StringAt(index);
 }
 
 std::optional<s32> PSF::GetInteger(std::string_view key) const {
@@ -213,6 +297,7 @@ std::optional<s32> PSF::GetInteger(std::string_view key) const {
 }
 
 void PSF::AddBinary(std::string key, std::vector<u8> value, bool update) {
+    DetachMapping();
     auto [it, index] = FindEntry(key);
     bool exist = it != entry_list.end();
     if (exist && !update) {
@@ -239,6 +324,7 @@ void PSF::AddBinary(std::string key, uint64_t value, bool update) {
 }
 
 void PSF::AddString(std::string key, std::string value, bool update) {
+    DetachMapping();
     auto [it, index] = FindEntry(key);
     bool exist = it != entry_list.end();
     if (exist && !update) {
@@ -5,6 +5,8 @@
 
 #include <chrono>
 #include <filesystem>
+#include <memory>
+#include <optional>
 #include <span>
 #include <string>
 #include <string_view>
@@ -12,6 +14,10 @@
 #include <vector>
 #include "common/endian.h"
 
+namespace Common::FS {
+class MappedFile;
+}
+
 constexpr u32 PSF_MAGIC = 0x00505346;
 constexpr u32 PSF_VERSION_1_1 = 0x00000101;
 constexpr u32 PSF_VERSION_1_0 = 0x00000100;
@@ -59,6 +65,13 @@ public:
     bool Open(const std::filesystem::path& filepath);
     bool Open(const std::vector<u8>& psf_buffer);
 
+    /**
+     * Opens the file as a read-only view. The file stays mapped while the PSF or a copy of it is
+     * alive and binary and string values point into it instead of being copied. Adding a value
+     * copies the values out first.
+     */
+    bool OpenMapped(const std::filesystem::path& filepath);
+
     [[nodiscard]] std::vector<u8> Encode() const;
     void Encode(std::vector<u8>& buf) const;
     bool Encode(const std::filesystem::path& filepath) const;
@@ -89,6 +102,19 @@ private:
     std::unordered_map<size_t, std::string> map_strings;
     std::unordered_map<size_t, s32> map_integers;
 
+    /// Values of a mapped file, pointing into mapping.
+    std::shared_ptr<const Common::FS::MappedFile> mapping;
+    std::unordered_map<size_t, std::span<const u8>> map_binary_views;
+    std::unordered_map<size_t, std::string_view> map_string_views;
+
+    void UpdateLastWrite(const std::filesystem::path& filepath);
+    bool Parse(std::span<const u8> psf_data, bool is_view);
+    /// Copies the values of a mapped file into owned storage and releases the mapping.
+    void DetachMapping();
+
+    [[nodiscard]] std::span<const u8> BinaryAt(size_t index) const;
+    [[nodiscard]] std::string_view StringAt(size_t index) const;
+
     [[nodiscard]] std::pair<std::vector<Entry>::iterator, size_t> FindEntry(std::string_view key);
     [[nodiscard]] std::pair<std::vector<Entry>::const_iterator, size_t> FindEntry(
         std::string_view key) const;
@@ -1,12 +1,20 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <mutex>
+#include <unordered_map>
+#include <fmt/ranges.h>
+
 #include "common/aes.h"
 #include "common/config.h"
 #include "common/logging/log.h"
 #include "common/path_util.h"
+#include "common/thread.h"
 #include "core/file_format/trp.h"
 
+// Holds the digest of the TRP the files of a trophy directory were extracted from.
+constexpr std::string_view DigestFileName = "trp_digest";
+
 static void DecryptEFSM(std::span<u8, 16> trophyKey, std::span<u8, 16> NPcommID,
                         std::span<u8, 16> efsmIv, std::span<u8> ciphertext,
                         std::span<u8> decrypted) {
@@ -56,6 +64,63 @@ static void hexToBytes(const char* hex, unsigned char* dst) {
     }
 }
 
+bool TRP::ExtractFile(Common::FS::IOFile& file, const TrpHeader& header,
+                      const std::filesystem::path& filesPath, std::span<u8, 16> user_key) {
+    std::filesystem::create_directories(filesPath / "Icons");
+    std::filesystem::create_directory(filesPath / "Xml");
+
+    s64 seekPos = sizeof(TrpHeader);
+    for (int i = 0; i < header.entry_num; i++) {
+        if (!file.Seek(seekPos)) {
+            LOG_CRITICAL(Common_Filesystem, "Failed to seek to TRP entry offset");
+            return false;
+        }
+        seekPos += (s64)header.entry_size;
+        TrpEntry entry;
+        file.Read(entry);
+        std::string_view name(entry.entry_name);
+        if (entry.flag == 0) { // PNG
+            if (!file.Seek(entry.entry_pos)) {
+                LOG_CRITICAL(Common_Filesystem, "Failed to seek to TRP entry offset");
+                return false;
+            }
+            std::vector<u8> icon(entry.entry_len);
+            file.Read(icon);
+            Common::FS::IOFile::WriteBytes(filesPath / "Icons" / name, icon);
+        }
+        if (entry.flag == 3 && np_comm_id[0] == 'N' && np_comm_id[1] == 'P') { // ESFM, encrypted.
+            if (!file.Seek(entry.entry_pos)) {
+                LOG_CRITICAL(Common_Filesystem, "Failed to seek to TRP entry offset");
+                return false;
+            }
+            file.Read(esfmIv); // get iv key.
+            // Skip the first 16 bytes which are the iv key on every entry as we want a
+            // clean xml file. The buffers are reused by all entries.
+            esfm.resize(entry.entry_len - iv_len);
+            xml.resize(entry.entry_len - iv_len);
+            if (!file.Seek(entry.entry_pos + iv_len)) {
+                LOG_CRITICAL(Common_Filesystem, "Failed to seek to TRP entry + iv offset");
+                return false;
+            }
+            file.Read(esfm);
+            DecryptEFSM(user_key, np_comm_id, esfmIv, esfm, xml); // decrypt
+            removePadding(xml);
+            std::string xml_name = entry.entry_name;
+            size_t pos = xml_name.find("ESFM");
+            if (pos != std::string::npos)
+                xml_name.replace(pos, xml_name.length(), "XML");
+            std::filesystem::path path = filesPath / "Xml" / xml_name;
+            size_t written = Common::FS::IOFile::WriteBytes(path, xml);
+            if (written != xml.size()) {
+                LOG_CRITICAL(Common_Filesystem,
+                             "Trophy XML {} write failed, wanted to write {} bytes, wrote {}",
+                             fmt::UTF(path.u8string()), xml.size(), written);
+            }
+        }
+    }
+    return true;
+}
+
 bool TRP::Extract(const std::filesystem::path& trophyPath, const std::string titleId) {
     std::filesystem::path gameSysDir = trophyPath / "sce_sys/trophy/";
     if (!std::filesystem::exists(gameSysDir)) {
@@ -89,65 +154,56 @@ bool TRP::Extract(const std::filesystem::path& trophyPath, const std::string tit
                 return false;
             }
 
-            s64 seekPos = sizeof(TrpHeader);
             std::filesystem::path trpFilesPath(
                 Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) / titleId /
                 "TrophyFiles" / it.path().stem());
-            std::filesystem::create_directories(trpFilesPath / "Icons");
-            std::filesystem::create_directory(trpFilesPath / "Xml");
-
-            for (int i = 0; i < header.entry_num; i++) {
-                if (!file.Seek(seekPos)) {
-                    LOG_CRITICAL(Common_Filesystem, "Failed to seek to TRP entry offset");
-                    return false;
-                }
-                seekPos += (s64)header.entry_size;
-                TrpEntry entry;
-                file.Read(entry);
-                std::string_view name(entry.entry_name);
-                if (entry.flag == 0) { // PNG
-                    if (!file.Seek(entry.entry_pos)) {
-                        LOG_CRITICAL(Common_Filesystem, "Failed to seek to TRP entry offset");
-                        return false;
-                    }
-                    std::vector<u8> icon(entry.entry_len);
-                    file.Read(icon);
-                    Common::FS::IOFile::WriteBytes(trpFilesPath / "Icons" / name, icon);
-                }
-                if (entry.flag == 3 && np_comm_id[0] == 'N' &&
-                    np_comm_id[1] == 'P') { // ESFM, encrypted.
-                    if (!file.Seek(entry.entry_pos)) {
-                        LOG_CRITICAL(Common_Filesystem, "Failed to seek to TRP entry offset");
-                        return false;
-                    }
-                    file.Read(esfmIv); // get iv key.
-                    // Skip the first 16 bytes which are the iv key on every entry as we want a
-                    // clean xml file.
-                    std::vector<u8> ESFM(entry.entry_len - iv_len);
-                    std::vector<u8> XML(entry.entry_len - iv_len);
-                    if (!file.Seek(entry.entry_pos + iv_len)) {
-                        LOG_CRITICAL(Common_Filesystem, "Failed to seek to TRP entry + iv offset");
-                        return false;
-                    }
-                    file.Read(ESFM);
-                    DecryptEFSM(user_key, np_comm_id, esfmIv, ESFM, XML); // decrypt
-                    removePadding(XML);
-                    std::string xml_name = entry.entry_name;
-                    size_t pos = xml_name.find("ESFM");
-                    if (pos != std::string::npos)
-                        xml_name.replace(pos, xml_name.length(), "XML");
-                    std::filesystem::path path = trpFilesPath / "Xml" / xml_name;
-                    size_t written = Common::FS::IOFile::WriteBytes(path, XML);
-                    if (written != XML.size()) {
-                        LOG_CRITICAL(
-                            Common_Filesystem,
-                            "Trophy XML {} write failed, wanted to write {} bytes, wrote {}",
-                            fmt::UTF(path.u8string()), XML.size(), written);
-                    }
-                }
+
+            // The files are extracted again only when the TRP changed, e.g. by an update.
+            const auto digest = fmt::format("{:02x}", fmt::join(header.digest, ""));
+            const auto digestPath = trpFilesPath / DigestFileName;
+            if (Common::FS::IOFile digestFile{digestPath, Common::FS::FileAccessMode::Read};
+                digestFile.IsOpen() && digestFile.ReadString(digestFile.GetSize()) == digest) {
+                index++;
+                continue;
             }
+            if (!ExtractFile(file, header, trpFilesPath, user_key)) {
+                return false;
+            }
+            Common::FS::IOFile digestFile{digestPath, Common::FS::FileAccessMode::Write};
+            digestFile.WriteString(digest);
         }
         index++;
     }
     return true;
 }
+
+static std::mutex g_extract_mutex;
+static std::unordered_map<std::string, std::shared_future<bool>> g_extract_jobs;
+
+std::shared_future<bool> TRP::ExtractAsync(const std::filesystem::path& trophyPath,
+                                           const std::string& titleId) {
+    std::scoped_lock lk{g_extract_mutex};
+    auto& job = g_extract_jobs[titleId];
+    if (job.valid() && job.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return job;
+    }
+    job = std::async(std::launch::async, [trophyPath, titleId] {
+              Common::SetCurrentThreadName("shadPS4:TrophyExtract");
+              TRP trp;
+              return trp.Extract(trophyPath, titleId);
+          }).share();
+    return job;
+}
+
+void TRP::WaitForExtraction(const std::string& titleId) {
+    std::shared_future<bool> job;
+    {
+        std::scoped_lock lk{g_extract_mutex};
+        const auto it = g_extract_jobs.find(titleId);
+        if (it == g_extract_jobs.end()) {
+            return;
+        }
+        job = it->second;
+    }
+    job.wait();
+}
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <future>
+#include <string>
 #include <vector>
 #include "common/endian.h"
 #include "common/io_file.h"
@@ -35,10 +37,23 @@ public:
     bool Extract(const std::filesystem::path& trophyPath, const std::string titleId);
     void GetNPcommID(const std::filesystem::path& trophyPath, int index);
 
+    /// Extracts the trophies of a game on a background thread. Calls for a title that is being
+    /// extracted share the running job.
+    static std::shared_future<bool> ExtractAsync(const std::filesystem::path& trophyPath,
+                                                 const std::string& titleId);
+
+    /// Blocks until a background extraction of the title has finished.
+    static void WaitForExtraction(const std::string& titleId);
+
 private:
+    bool ExtractFile(Common::FS::IOFile& file, const TrpHeader& header,
+                     const std::filesystem::path& filesPath, std::span<u8, 16> user_key);
+
     std::vector<u8> NPcommID = std::vector<u8>(12);
     std::array<u8, 16> np_comm_id{};
     std::array<u8, 16> esfmIv{};
     std::filesystem::path trpFilesPath;
+    std::vector<u8> esfm;
+    std::vector<u8> xml;
     static constexpr int iv_len = 16;
 };
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include "common/assert.h"
 #include "common/config.h"
 #include "common/string_util.h"
 #include "core/file_sys/devices/logger.h"
@@ -23,23 +24,45 @@ std::string RemoveTrailingSlashes(const std::string& path) {
 
 void MntPoints::Mount(const std::filesystem::path& host_folder, const std::string& guest_folder,
                       bool read_only) {
-    std::scoped_lock lock{m_mutex};
-    const auto guest_folder_sanitized = RemoveTrailingSlashes(guest_folder);
-    m_mnt_pairs.emplace_back(host_folder, guest_folder_sanitized, read_only);
+    {
+        std::scoped_lock lock{m_mutex};
+        const auto guest_folder_sanitized = RemoveTrailingSlashes(guest_folder);
+        m_mnt_pairs.emplace_back(host_folder, guest_folder_sanitized, read_only);
+    }
+    InvalidateCache();
 }
 
 void MntPoints::Unmount(const std::filesystem::path& host_folder, const std::string& guest_folder) {
-    std::scoped_lock lock{m_mutex};
-    const auto guest_folder_sanitized = RemoveTrailingSlashes(guest_folder);
-    auto it = std::remove_if(m_mnt_pairs.begin(), m_mnt_pairs.end(), [&](const MntPair& pair) {
-        return pair.mount == guest_folder_sanitized;
-    });
-    m_mnt_pairs.erase(it, m_mnt_pairs.end());
+    {
+        std::scoped_lock lock{m_mutex};
+        const auto guest_folder_sanitized = RemoveTrailingSlashes(guest_folder);
+        auto it = std::remove_if(m_mnt_pairs.begin(), m_mnt_pairs.end(), [&](const MntPair& pair) {
+            return pair.mount == guest_folder_sanitized;
+        });
+        m_mnt_pairs.erase(it, m_mnt_pairs.end());
+    }
+    InvalidateCache();
 }
 
 void MntPoints::UnmountAll() {
+    {
+        std::scoped_lock lock{m_mutex};
+        m_mnt_pairs.clear();
+    }
+    InvalidateCache();
+}
+
+void MntPoints::InvalidateCache() {
+    std::unique_lock lk{m_cache_mutex};
+    ++cache_generation;
+    for (auto& cache : resolve_cache) {
+        cache.clear();
+    }
+    info_cache.clear();
+    directory_cache.clear();
+
     std::scoped_lock lock{m_mutex};
-    m_mnt_pairs.clear();
+    path_cache.clear();
 }
 
 std::filesystem::path MntPoints::GetHostPath(std::string_view path, bool* is_read_only,
@@ -52,6 +75,67 @@ std::filesystem::path MntPoints::GetHostPath(std::string_view path, bool* is_rea
         pos = corrected_path.find("//", pos + 1);
     }
 
+    auto& cache = resolve_cache[force_base_path];
+    u64 generation;
+    {
+        std::shared_lock lk{m_cache_mutex};
+        if (const auto it = cache.find(corrected_path); it != cache.end()) {
+            if (is_read_only) {
+                *is_read_only = it->second.read_only;
+            }
+            return it->second.host_path;
+        }
+        generation = cache_generation;
+    }
+
+    bool read_only = false;
+    auto host_path = ResolveHostPath(corrected_path, &read_only, force_base_path);
+    if (is_read_only) {
+        *is_read_only = read_only;
+    }
+    if (!host_path.empty()) {
+        std::unique_lock lk{m_cache_mutex};
+        if (generation == cache_generation) {
+            cache.try_emplace(std::move(corrected_path), host_path, read_only);
+        }
+    }
+    return host_path;
+}
+
+MntPoints::HostPathInfo MntPoints::GetHostPathInfo(std::string_view guest_path) {
+    HostPathInfo info{};
+    info.host_path = GetHostPath(guest_path, &info.read_only);
+
+    const std::string key(guest_path);
+    u64 generation;
+    {
+        std::shared_lock lk{m_cache_mutex};
+        if (const auto it = info_cache.find(key); it != info_cache.end()) {
+            return it->second;
+        }
+        generation = cache_generation;
+    }
+
+    std::error_code ec;
+    const auto status = std::filesystem::status(info.host_path, ec);
+    info.exists = std::filesystem::exists(status);
+    info.is_directory = std::filesystem::is_directory(status);
+    info.is_file = std::filesystem::is_regular_file(status);
+    if (info.is_file) {
+        info.size = std::filesystem::file_size(info.host_path, ec);
+    }
+
+    if (info.read_only) {
+        std::unique_lock lk{m_cache_mutex};
+        if (generation == cache_generation) {
+            info_cache.try_emplace(key, info);
+        }
+    }
+    return info;
+}
+
+std::filesystem::path MntPoints::ResolveHostPath(const std::string& corrected_path,
+                                                 bool* is_read_only, bool force_base_path) {
     const MntPair* mount = GetMount(corrected_path);
     if (!mount) {
         return "";
@@ -156,7 +240,50 @@ std::filesystem::path MntPoints::GetHostPath(std::string_view path, bool* is_rea
 // TODO: Does not handle mount points inside mount points.
 void MntPoints::IterateDirectory(std::string_view guest_directory,
                                  const IterateDirectoryCallback& callback) {
-    const auto base_path = GetHostPath(guest_directory, nullptr, true);
+    bool read_only = false;
+    const auto base_path = GetHostPath(guest_directory, &read_only, true);
+
+    // Listings of read-only mounts never change, replay them instead of walking the host again.
+    const std::string key(guest_directory);
+    u64 generation;
+    std::vector<DirectoryEntry> cached_entries;
+    bool is_cached = false;
+    {
+        std::shared_lock lk{m_cache_mutex};
+        if (const auto it = directory_cache.find(key); it != directory_cache.end()) {
+            // Copy out so the callback is free to resolve paths itself.
+            cached_entries = it->second;
+            is_cached = true;
+        }
+        generation = cache_generation;
+    }
+    if (is_cached) {
+        for (const auto& entry : cached_entries) {
+            callback(entry.host_path, entry.is_file);
+        }
+        return;
+    }
+    if (read_only) {
+        std::vector<DirectoryEntry> entries;
+        IterateHostDirectory(guest_directory, base_path,
+                             [&entries](const auto& host_path, const auto is_file) {
+                                 entries.emplace_back(host_path, is_file);
+                             });
+        for (const auto& entry : entries) {
+            callback(entry.host_path, entry.is_file);
+        }
+        std::unique_lock lk{m_cache_mutex};
+        if (generation == cache_generation) {
+            directory_cache.try_emplace(key, std::move(entries));
+        }
+        return;
+    }
+    IterateHostDirectory(guest_directory, base_path, callback);
+}
+
+void MntPoints::IterateHostDirectory(std::string_view guest_directory,
+                                     const std::filesystem::path& base_path,
+                                     const IterateDirectoryCallback& callback) {
     const auto patch_path = GetHostPath(guest_directory, nullptr, false);
     // Only need to consider patch path if it exists and does not resolve to the same as base.
     const auto apply_patch = base_path != patch_path && std::filesystem::exists(patch_path);
@@ -190,77 +317,82 @@ void MntPoints::IterateDirectory(std::string_view guest_directory,
     }
 }
 
+HandleTable::~HandleTable() {
+    for (auto& chunk : m_chunks) {
+        delete[] chunk.load(std::memory_order_relaxed);
+    }
+}
+
 int HandleTable::CreateHandle() {
     std::scoped_lock lock{m_mutex};
 
     auto* file = new File{};
     file->is_opened = false;
 
-    int existingFilesNum = m_files.size();
-
-    for (int index = 0; index < existingFilesNum; index++) {
-        if (m_files.at(index) == nullptr) {
-            m_files[index] = file;
+    const int num_slots = m_num_slots.load(std::memory_order_relaxed);
+    for (int index = 0; index < num_slots; index++) {
+        auto& slot = GetSlot(index);
+        if (slot.load(std::memory_order_relaxed) == nullptr) {
+            slot.store(file, std::memory_order_release);
             return index;
         }
     }
 
-    m_files.push_back(file);
-    return m_files.size() - 1;
+    const u32 chunk = num_slots >> ChunkBits;
+    ASSERT_MSG(chunk < MaxChunks, "File descriptor table is full");
+    if (!m_chunks[chunk].load(std::memory_order_relaxed)) {
+        m_chunks[chunk].store(new Slot[ChunkSize]{}, std::memory_order_release);
+    }
+    GetSlot(num_slots).store(file, std::memory_order_release);
+    m_num_slots.store(num_slots + 1, std::memory_order_release);
+    return num_slots;
 }
 
 void HandleTable::DeleteHandle(int d) {
     std::scoped_lock lock{m_mutex};
-    delete m_files.at(d);
-    m_files[d] = nullptr;
+    ASSERT(d >= 0 && d < m_num_slots.load(std::memory_order_relaxed));
+    delete GetSlot(d).exchange(nullptr, std::memory_order_acq_rel);
 }
 
-File* HandleTable::GetFile(int d) {
-    std::scoped_lock lock{m_mutex};
-    if (d < 0 || d >= m_files.size()) {
+File* HandleTable::LoadFile(int d) const {
+    if (d < 0 || d >= m_num_slots.load(std::memory_order_acquire)) {
         return nullptr;
     }
-    return m_files.at(d);
+    return GetSlot(d).load(std::memory_order_acquire);
+}
+
+File* HandleTable::GetFile(int d) {
+    return LoadFile(d);
 }
 
 File* HandleTable::GetSocket(int d) {
-    std::scoped_lock lock{m_mutex};
-    if (d < 0 || d >= m_files.size()) {
-        return nullptr;
-    }
-    auto file = m_files.at(d);
-    if (file->type != Core::FileSys::FileType::Socket) {
+    auto* file = LoadFile(d);
+    if (file == nullptr || file->type != Core::FileSys::FileType::Socket) {
         return nullptr;
     }
     return file;
 }
 
 File* HandleTable::GetEpoll(int d) {
-    std::scoped_lock lock{m_mutex};
-    if (d < 0 || d >= m_files.size()) {
-        return nullptr;
-    }
-    auto file = m_files.at(d);
-    if (file->type != Core::FileSys::FileType::Epoll) {
+    auto* file = LoadFile(d);
+    if (file == nullptr || file->type != Core::FileSys::FileType::Epoll) {
         return nullptr;
     }
     return file;
 }
 
 File* HandleTable::GetResolver(int d) {
-    std::scoped_lock lock{m_mutex};
-    if (d < 0 || d >= m_files.size()) {
-        return nullptr;
-    }
-    auto file = m_files.at(d);
-    if (file->type != Core::FileSys::FileType::Resolver) {
+    auto* file = LoadFile(d);
+    if (file == nullptr || file->type != Core::FileSys::FileType::Resolver) {
         return nullptr;
     }
     return file;
 }
 
 File* HandleTable::GetFile(const std::filesystem::path& host_name) {
-    for (auto* file : m_files) {
+    const int num_slots = m_num_slots.load(std::memory_order_acquire);
+    for (int index = 0; index < num_slots; index++) {
+        auto* file = GetSlot(index).load(std::memory_order_acquire);
         if (file != nullptr && file->m_host_name == host_name) {
             return file;
         }
@@ -285,11 +417,11 @@ void HandleTable::CreateStdHandles() {
 }
 
 int HandleTable::GetFileDescriptor(File* file) {
-    std::scoped_lock lock{m_mutex};
-    auto it = std::find(m_files.begin(), m_files.end(), file);
-
-    if (it != m_files.end()) {
-        return std::distance(m_files.begin(), it);
+    const int num_slots = m_num_slots.load(std::memory_order_acquire);
+    for (int index = 0; index < num_slots; index++) {
+        if (GetSlot(index).load(std::memory_order_acquire) == file) {
+            return index;
+        }
     }
     return 0;
 }
@@ -3,12 +3,16 @@
 
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <vector>
 #include <tsl/robin_map.h>
+#include "common/debug.h"
 #include "common/io_file.h"
+#include "common/mapped_file.h"
 #include "common/logging/formatter.h"
 #include "core/file_sys/devices/base_device.h"
 #include "core/file_sys/directories/base_directory.h"
@@ -34,6 +38,14 @@ public:
         std::string mount; // e.g /app0
         bool read_only;
     };
+    struct HostPathInfo {
+        std::filesystem::path host_path;
+        bool read_only{};
+        bool exists{};
+        bool is_directory{};
+        bool is_file{};
+        u64 size{};
+    };
 
     explicit MntPoints() = default;
     ~MntPoints() = default;
@@ -45,6 +57,15 @@ public:
 
     std::filesystem::path GetHostPath(std::string_view guest_directory,
                                       bool* is_read_only = nullptr, bool force_base_path = false);
+
+    /// Resolves a guest path and queries the host entry it points to. Results on read-only
+    /// mounts are cached, their contents can't change while the title runs.
+    HostPathInfo GetHostPathInfo(std::string_view guest_path);
+
+    /// Drops every cached path resolution, must be called whenever the guest creates, renames
+    /// or removes entries.
+    void InvalidateCache();
+
     using IterateDirectoryCallback =
         std::function<void(const std::filesystem::path& host_path, bool is_file)>;
     void IterateDirectory(std::string_view guest_directory,
@@ -69,10 +90,32 @@ public:
     }
 
 private:
+    std::filesystem::path ResolveHostPath(const std::string& corrected_path, bool* is_read_only,
+                                          bool force_base_path);
+    void IterateHostDirectory(std::string_view guest_directory,
+                              const std::filesystem::path& base_path,
+                              const IterateDirectoryCallback& callback);
+
+    struct ResolvedPath {
+        std::filesystem::path host_path;
+        bool read_only;
+    };
+    struct DirectoryEntry {
+        std::filesystem::path host_path;
+        bool is_file;
+    };
+
     std::vector<MntPair> m_mnt_pairs;
     std::vector<std::filesystem::path> path_parts;
     tsl::robin_map<std::filesystem::path, std::filesystem::path> path_cache;
     std::mutex m_mutex;
+    // Resolution caches, indexed by guest path. A resolution racing with an invalidation is
+    // only inserted if the generation did not change in the meantime.
+    std::shared_mutex m_cache_mutex;
+    u64 cache_generation{};
+    std::array<tsl::robin_map<std::string, ResolvedPath>, 2> resolve_cache; // by force_base_path
+    tsl::robin_map<std::string, HostPathInfo> info_cache;
+    tsl::robin_map<std::string, std::vector<DirectoryEntry>> directory_cache;
 };
 
 enum class FileType {
@@ -84,12 +127,21 @@ enum class FileType {
     Resolver
 };
 
+/// Access pattern of a mapped file, used to page in ahead of sequential readers.
+struct ReadAhead {
+    u64 next_offset{};    // offset a sequential read would start at
+    u64 prefetched_end{}; // end of the range already handed to the host
+    u64 window{};         // read-ahead distance, grows while the reads stay sequential
+};
+
 struct File {
     std::atomic_bool is_opened{};
     std::atomic<FileType> type{FileType::Regular};
     std::filesystem::path m_host_name;
     std::string m_guest_name;
     Common::FS::IOFile f;
+    Common::FS::MappedFile mapping; // only valid for read-only regular files, may be closed
+    ReadAhead read_ahead;           // only used with mapping
     std::mutex m_mutex;
     std::shared_ptr<Directories::BaseDirectory> directory; // only valid for type == Directory
     std::shared_ptr<Devices::BaseDevice> device;           // only valid for type == Device
@@ -98,10 +150,20 @@ struct File {
     std::shared_ptr<Libraries::Net::Resolver> resolver;    // only valid for type == Resolver
 };
 
+/**
+ * Guest file descriptor table. Descriptors index slots kept in fixed size chunks that never move,
+ * so lookups only load atomics while creating and deleting handles is serialized by a mutex.
+ */
 class HandleTable {
+    static constexpr u32 ChunkBits = 8;
+    static constexpr u32 ChunkSize = 1U << ChunkBits;
+    static constexpr u32 MaxChunks = 256;
+
+    using Slot = std::atomic<File*>;
+
 public:
     HandleTable() = default;
-    virtual ~HandleTable() = default;
+    virtual ~HandleTable();
 
     int CreateHandle();
     void DeleteHandle(int d);
@@ -115,8 +177,16 @@ public:
     void CreateStdHandles();
 
 private:
-    std::vector<File*> m_files;
-    std::mutex m_mutex;
+    File* LoadFile(int d) const;
+
+    Slot& GetSlot(int d) const {
+        Slot* const chunk = m_chunks[d >> ChunkBits].load(std::memory_order_acquire);
+        return chunk[d & (ChunkSize - 1)];
+    }
+
+    std::array<std::atomic<Slot*>, MaxChunks> m_chunks{};
+    std::atomic<int> m_num_slots{}; // slots below this have an allocated chunk
+    PROFILED_MUTEX(std::mutex, m_mutex);
 };
 
 } // namespace Core::FileSys
@@ -52,6 +52,8 @@ struct AjmBatch {
     u32 id{};
     std::atomic_bool waiting{};
     std::atomic_bool canceled{};
+    /// Number of instances whose jobs of this batch are still running.
+    std::atomic<u32> pending_instances{};
     std::binary_semaphore finished{0};
     boost::container::small_vector<AjmJob, 16> jobs;
 
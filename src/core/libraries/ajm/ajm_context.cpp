@@ -2,7 +2,9 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include "common/assert.h"
+#include "common/debug.h"
 #include "common/logging/log.h"
+#include "common/polyfill_thread.h"
 #include "common/thread.h"
 #include "core/libraries/ajm/ajm.h"
 #include "core/libraries/ajm/ajm_at9.h"
@@ -10,10 +12,12 @@
 #include "core/libraries/ajm/ajm_error.h"
 #include "core/libraries/ajm/ajm_instance.h"
 #include "core/libraries/ajm/ajm_instance_statistics.h"
+#include "core/debug_state.h"
 #include "core/libraries/ajm/ajm_mp3.h"
 #include "core/libraries/error_codes.h"
 
-#include <span>
+#include <algorithm>
+#include <chrono>
 #include <utility>
 
 namespace Libraries::Ajm {
@@ -21,7 +25,11 @@ namespace Libraries::Ajm {
 static constexpr u32 ORBIS_AJM_WAIT_INFINITE = -1;
 
 AjmContext::AjmContext() {
-    worker_thread = std::jthread([this](std::stop_token stop) { this->WorkerThread(stop); });
+    // Instances decode independently, a few workers are enough to keep many voices on time.
+    const u32 num_workers = std::clamp(std::thread::hardware_concurrency() / 4, 1U, 4U);
+    for (u32 i = 0; i < num_workers; i++) {
+        workers.emplace_back([this](std::stop_token stop) { this->WorkerThread(stop); });
+    }
 }
 
 bool AjmContext::IsRegistered(AjmCodecType type) const {
@@ -56,20 +64,68 @@ s32 AjmContext::ModuleRegister(AjmCodecType type) {
 
 void AjmContext::WorkerThread(std::stop_token stop) {
     Common::SetCurrentThreadName("shadPS4:AjmWorker");
-    while (!stop.stop_requested()) {
-        auto batch = batch_queue.PopWait(stop);
-        if (batch != nullptr) {
-            ProcessBatch(batch->id, batch->jobs);
-            batch->finished.release();
+    std::unique_lock lock{work_mutex};
+    while (true) {
+        Common::CondvarWait(work_cv, lock, stop, [this] { return !ready_instances.empty(); });
+        if (stop.stop_requested()) {
+            break;
+        }
+        const u32 instance_id = ready_instances.front();
+        ready_instances.pop_front();
+        auto& queue = instance_queues[instance_id].work;
+        InstanceWork work = std::move(queue.front());
+        queue.pop_front();
+
+        lock.unlock();
+        ProcessWork(work);
+        if (work.batch->pending_instances.fetch_sub(1) == 1) {
+            work.batch->finished.release();
+        }
+        lock.lock();
+
+        // Requeue the instance behind the others so busy instances do not starve the rest.
+        if (const auto it = instance_queues.find(instance_id); it->second.work.empty()) {
+            instance_queues.erase(it);
+        } else {
+            ready_instances.push_back(instance_id);
+        }
+    }
+}
+
+void AjmContext::SubmitBatch(const std::shared_ptr<AjmBatch>& batch) {
+    boost::container::small_vector<InstanceWork, 8> groups;
+    for (u32 i = 0; i < batch->jobs.size(); i++) {
+        const u32 instance_id = batch->jobs[i].instance_id;
+        const auto it = std::ranges::find(groups, instance_id, &InstanceWork::instance_id);
+        if (it != groups.end()) {
+            it->jobs.push_back(i);
+        } else {
+            groups.push_back(InstanceWork{instance_id, batch, {i}});
+        }
+    }
+    batch->pending_instances = static_cast<u32>(groups.size());
+
+    {
+        std::scoped_lock lock{work_mutex};
+        for (auto& group : groups) {
+            const u32 instance_id = group.instance_id;
+            auto [it, is_new] = instance_queues.try_emplace(instance_id);
+            it->second.work.push_back(std::move(group));
+            if (is_new) {
+                // Instances that already have a queue are either ready or being processed.
+                ready_instances.push_back(instance_id);
+            }
         }
     }
+    work_cv.notify_all();
 }
 
-void AjmContext::ProcessBatch(u32 id, std::span<AjmJob> jobs) {
+void AjmContext::ProcessWork(InstanceWork& work) {
     // Perform operation requested by control flags.
-    for (auto& job : jobs) {
-        LOG_TRACE(Lib_Ajm, "Processing job {} for instance {}. flags = {:#x}", id, job.instance_id,
-                  job.flags.raw);
+    for (const u32 index : work.jobs) {
+        auto& job = work.batch->jobs[index];
+        LOG_TRACE(Lib_Ajm, "Processing job {} for instance {}. flags = {:#x}", work.batch->id,
+                  job.instance_id, job.flags.raw);
 
         if (job.instance_id == AJM_INSTANCE_STATISTICS) {
             AjmInstanceStatistics::Getinstance().ExecuteJob(job);
@@ -82,7 +138,20 @@ void AjmContext::ProcessBatch(u32 id, std::span<AjmJob> jobs) {
                 instance = *p_instance;
             }
 
+            const auto start = std::chrono::steady_clock::now();
             instance->ExecuteJob(job);
+            const u32 decode_us = static_cast<u32>(
+                std::chrono::duration_cast<std::chrono::microseconds>(
+                    std::chrono::steady_clock::now() - start)
+                    .count());
+
+            auto& stats = DebugState.audio_stats;
+            stats.ajm_jobs.fetch_add(1, std::memory_order_relaxed);
+            stats.ajm_decode_us.store(decode_us, std::memory_order_relaxed);
+            if (decode_us > stats.ajm_max_decode_us.load(std::memory_order_relaxed)) {
+                stats.ajm_max_decode_us.store(decode_us, std::memory_order_relaxed);
+            }
+            DETAILED_PLOT("AJM decode time (us)", static_cast<s64>(decode_us));
         }
     }
 }
@@ -142,7 +211,7 @@ int AjmContext::BatchStartBuffer(u8* p_batch, u32 batch_size, const int priority
     batch_info->id = *out_batch_id;
 
     if (!batch_info->jobs.empty()) {
-        batch_queue.EmplaceWait(batch_info);
+        SubmitBatch(batch_info);
     } else {
         // Empty batches are not submitted to the processor and are marked as finished
         batch_info->finished.release();
@@ -3,7 +3,6 @@
 
 #pragma once
 
-#include "common/bounded_threadsafe_queue.h"
 #include "common/slot_array.h"
 #include "common/types.h"
 #include "core/libraries/ajm/ajm.h"
@@ -11,11 +10,15 @@
 #include "core/libraries/ajm/ajm_instance.h"
 
 #include <array>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
 #include <shared_mutex>
-#include <span>
 #include <thread>
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 namespace Libraries::Ajm {
 
@@ -33,9 +36,23 @@ public:
                          AjmBatchError* p_batch_error, u32* p_batch_id);
 
     void WorkerThread(std::stop_token stop);
-    void ProcessBatch(u32 id, std::span<AjmJob> jobs);
 
 private:
+    /// Jobs of one batch that target the same instance, in batch order.
+    struct InstanceWork {
+        u32 instance_id;
+        std::shared_ptr<AjmBatch> batch;
+        boost::container::small_vector<u32, 8> jobs;
+    };
+
+    /// Pending work of an instance, at most one worker runs it at a time to keep job order.
+    struct InstanceQueue {
+        std::deque<InstanceWork> work;
+    };
+
+    void SubmitBatch(const std::shared_ptr<AjmBatch>& batch);
+    void ProcessWork(InstanceWork& work);
+
     static constexpr u32 MaxInstances = 0x2fff;
     static constexpr u32 MaxBatches = 0x0400;
     static constexpr u32 NumAjmCodecs = std::to_underlying(AjmCodecType::Max);
@@ -50,8 +67,13 @@ private:
     std::shared_mutex batches_mutex;
     Common::SlotArray<u32, std::shared_ptr<AjmBatch>, MaxBatches, 1> batches;
 
-    std::jthread worker_thread{};
-    Common::MPSCQueue<std::shared_ptr<AjmBatch>> batch_queue;
+    std::mutex work_mutex;
+    std::condition_variable_any work_cv;
+    /// Instances with pending work, an instance is listed only while it has a queue.
+    std::unordered_map<u32, InstanceQueue> instance_queues;
+    /// Instances whose next work is ready to run and no worker holds.
+    std::deque<u32> ready_instances;
+    std::vector<std::jthread> workers;
 };
 
 } // namespace Libraries::Ajm
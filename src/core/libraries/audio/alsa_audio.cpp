@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <alsa/asoundlib.h>
+
+#include "common/config.h"
+#include "common/logging/log.h"
+#include "core/libraries/audio/audioout.h"
+#include "core/libraries/audio/audioout_backend.h"
+
+namespace Libraries::AudioOut {
+
+// ALSA orders surround channels as FL, FR, BL, BR, FC, LFE, SL, SR.
+static constexpr std::array<int, 8> AlsaChannelOrder = {0, 1, 4, 5, 2, 3, 6, 7};
+
+class AlsaPortBackend : public PortBackend {
+public:
+    explicit AlsaPortBackend(const PortOut& port)
+        : frame_size(port.format_info.FrameSize()), guest_buffer_frames(port.buffer_frames),
+          remapper(port, AlsaChannelOrder) {
+        const std::string port_name = port.type == OrbisAudioOutPort::PadSpk
+                                          ? Config::getPadSpkOutputDevice()
+                                          : Config::getMainOutputDevice();
+        if (port_name == "None") {
+            return;
+        }
+        // Names that ALSA does not know are SDL device names, those go to the default device.
+        if (port_name == "Default Device" ||
+            snd_pcm_open(&pcm, port_name.c_str(), SND_PCM_STREAM_PLAYBACK, 0) < 0) {
+            if (const int err = snd_pcm_open(&pcm, "default", SND_PCM_STREAM_PLAYBACK, 0);
+                err < 0) {
+                LOG_ERROR(Lib_AudioOut, "Failed to open ALSA device: {}", snd_strerror(err));
+                pcm = nullptr;
+                return;
+            }
+        }
+        if (!Configure(port)) {
+            snd_pcm_close(pcm);
+            pcm = nullptr;
+            return;
+        }
+    }
+
+    ~AlsaPortBackend() override {
+        if (!pcm) {
+            return;
+        }
+        snd_pcm_close(pcm);
+        pcm = nullptr;
+    }
+
+    [[nodiscard]] bool IsValid() const {
+        return pcm != nullptr;
+    }
+
+    void Output(void* ptr) override {
+        const u8* data = static_cast<const u8*>(remapper.Remap(ptr));
+        // Same as for SDL, the device may stop consuming samples during device changes.
+        snd_pcm_sframes_t delay;
+        if (snd_pcm_delay(pcm, &delay) == 0 && delay >= queue_threshold) {
+            LOG_INFO(Lib_AudioOut, "ALSA queue backed up ({} queued, {} threshold), clearing.",
+                     delay, queue_threshold);
+            snd_pcm_drop(pcm);
+            snd_pcm_prepare(pcm);
+        }
+        u32 frames_written = 0;
+        while (frames_written < guest_buffer_frames) {
+            const auto ret = snd_pcm_writei(pcm, data + frames_written * frame_size,
+                                            guest_buffer_frames - frames_written);
+            if (ret >= 0) {
+                frames_written += static_cast<u32>(ret);
+                continue;
+            }
+            if (const int err = snd_pcm_recover(pcm, static_cast<int>(ret), 1); err < 0) {
+                LOG_ERROR(Lib_AudioOut, "Failed to output to ALSA device: {}", snd_strerror(err));
+                return;
+            }
+        }
+    }
+
+    [[nodiscard]] u32 GetQueuedFrames() const override {
+        snd_pcm_sframes_t delay;
+        if (snd_pcm_delay(pcm, &delay) != 0) {
+            return 0;
+        }
+        return static_cast<u32>(std::max<snd_pcm_sframes_t>(delay, 0));
+    }
+
+private:
+    bool Configure(const PortOut& port) {
+        snd_pcm_hw_params_t* params;
+        snd_pcm_hw_params_alloca(&params);
+        snd_pcm_hw_params_any(pcm, params);
+
+        const auto format = port.format_info.is_float ? SND_PCM_FORMAT_FLOAT_LE
+                                                      : SND_PCM_FORMAT_S16_LE;
+        u32 rate = port.sample_rate;
+        snd_pcm_uframes_t period_frames = GetPeriodFrames(port);
+        // Keep room for two guest buffers so that output does not wait on the device.
+        snd_pcm_uframes_t buffer_frames =
+            std::max<snd_pcm_uframes_t>(period_frames * 2, guest_buffer_frames * 2);
+        int err = snd_pcm_hw_params_set_access(pcm, params, SND_PCM_ACCESS_RW_INTERLEAVED);
+        if (err >= 0) {
+            err = snd_pcm_hw_params_set_format(pcm, params, format);
+        }
+        if (err >= 0) {
+            err = snd_pcm_hw_params_set_channels(pcm, params, port.format_info.num_channels);
+        }
+        if (err >= 0) {
+            err = snd_pcm_hw_params_set_rate_near(pcm, params, &rate, nullptr);
+        }
+        if (err >= 0) {
+            err = snd_pcm_hw_params_set_period_size_near(pcm, params, &period_frames, nullptr);
+        }
+        if (err >= 0) {
+            err = snd_pcm_hw_params_set_buffer_size_near(pcm, params, &buffer_frames);
+        }
+        if (err >= 0) {
+            err = snd_pcm_hw_params(pcm, params);
+        }
+        if (err < 0) {
+            LOG_ERROR(Lib_AudioOut, "Failed to configure ALSA device: {}", snd_strerror(err));
+            return false;
+        }
+        if (rate != port.sample_rate) {
+            LOG_ERROR(Lib_AudioOut, "ALSA device does not support {} Hz", port.sample_rate);
+            return false;
+        }
+        queue_threshold = static_cast<snd_pcm_sframes_t>(buffer_frames) * 4;
+        LOG_INFO(Lib_AudioOut,
+                 "ALSA audio buffers: guest = {} frames, period = {} frames, host = {} frames",
+                 guest_buffer_frames, period_frames, buffer_frames);
+        return true;
+    }
+
+    u32 frame_size;
+    u32 guest_buffer_frames;
+    ChannelRemapper remapper;
+    snd_pcm_sframes_t queue_threshold{};
+    snd_pcm_t* pcm{};
+};
+
+std::unique_ptr<PortBackend> NativeAudioOut::Open(PortOut& port) {
+    auto backend = std::make_unique<AlsaPortBackend>(port);
+    if (backend->IsValid()) {
+        return backend;
+    }
+    LOG_WARNING(Lib_AudioOut, "Falling back to SDL audio output");
+    return SDLAudioOut{}.Open(port);
+}
+
+} // namespace Libraries::AudioOut
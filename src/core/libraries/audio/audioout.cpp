@@ -9,11 +9,14 @@
 
 #include "common/assert.h"
 #include "common/config.h"
+#include "common/debug.h"
 #include "common/logging/log.h"
 #include "common/thread.h"
+#include "core/debug_state.h"
 #include "core/libraries/audio/audioout.h"
 #include "core/libraries/audio/audioout_backend.h"
 #include "core/libraries/audio/audioout_error.h"
+#include "core/libraries/audio/audioout_kernels.h"
 #include "core/libraries/kernel/time.h"
 #include "core/libraries/libs.h"
 
@@ -109,6 +112,7 @@ int PS4_SYSV_ABI sceAudioOutClose(s32 handle) {
         port.output_ready = false;
         port.impl = nullptr;
     }
+    DebugState.audio_stats.ports[handle - 1].is_open = false;
     // Stop outside of port lock scope to prevent deadlocks.
     port.output_thread.Stop();
     return ORBIS_OK;
@@ -255,6 +259,16 @@ int PS4_SYSV_ABI sceAudioOutInit() {
     if (audio != nullptr) {
         return ORBIS_AUDIO_OUT_ERROR_ALREADY_INIT;
     }
+    const auto backend = Config::getAudioBackend();
+#ifdef ENABLE_NATIVE_AUDIO
+    if (backend == "Native") {
+        audio = std::make_unique<NativeAudioOut>();
+        return ORBIS_OK;
+    }
+#endif
+    if (backend != "SDL") {
+        LOG_WARNING(Lib_AudioOut, "Audio backend {} is not available, using SDL", backend);
+    }
     audio = std::make_unique<SDLAudioOut>();
     return ORBIS_OK;
 }
@@ -289,14 +303,90 @@ int PS4_SYSV_ABI sceAudioOutMbusInit() {
     return ORBIS_OK;
 }
 
+u32 GetPeriodFrames(const PortOut& port) {
+    const u32 period = Config::getAudioPeriodFrames();
+    return period != 0 ? period : port.buffer_frames;
+}
+
+ChannelRemapper::ChannelRemapper(const PortOut& port, std::span<const int> host_order)
+    : sample_size(port.format_info.sample_size), num_channels(port.format_info.num_channels) {
+    bool is_identity = true;
+    for (u32 i = 0; i < num_channels; i++) {
+        const u32 position = num_channels == 8 && !host_order.empty() ? host_order[i] : i;
+        channel_map[i] = port.format_info.channel_layout[position];
+        is_identity &= channel_map[i] == static_cast<int>(i);
+    }
+    if (!is_identity) {
+        buffer.resize(port.BufferSize());
+    }
+}
+
+const void* ChannelRemapper::Remap(const void* ptr) {
+    if (buffer.empty()) {
+        return ptr;
+    }
+    RemapChannels(std::span{static_cast<const u8*>(ptr), buffer.size()}, buffer, sample_size,
+                  std::span{channel_map.data(), num_channels});
+    return buffer.data();
+}
+
+static void UpdateGains(PortOut& port) {
+    const float slider = Config::getVolumeSlider() / 100.0f;
+    port.unity_gain = true;
+    for (u32 i = 0; i < port.format_info.num_channels; i++) {
+        port.gains[i] = static_cast<float>(port.volume[i]) / SCE_AUDIO_OUT_VOLUME_0DB * slider;
+        port.unity_gain &= port.gains[i] == 1.0f;
+    }
+}
+
+static void CopyOutput(PortOut& port, const void* ptr) {
+    if (port.unity_gain) {
+        std::memcpy(port.output_buffer, ptr, port.BufferSize());
+        return;
+    }
+    const u32 num_samples = port.buffer_frames * port.format_info.num_channels;
+    const std::span<const float> gains{port.gains.data(), port.format_info.num_channels};
+    if (port.format_info.is_float) {
+        CopyScaled(std::span{static_cast<const float*>(ptr), num_samples},
+                   std::span{static_cast<float*>(port.output_buffer), num_samples}, gains);
+    } else {
+        CopyScaled(std::span{static_cast<const s16*>(ptr), num_samples},
+                   std::span{static_cast<s16*>(port.output_buffer), num_samples}, gains);
+    }
+}
+
+static_assert(DebugStateType::DebugStateImpl::AudioStats::NumPorts == SCE_AUDIO_OUT_NUM_PORTS);
+
+#if DETAILED_PROFILING
+static const auto queued_plot_names = [] {
+    std::array<std::string, SCE_AUDIO_OUT_NUM_PORTS> names;
+    for (s32 i = 0; i < SCE_AUDIO_OUT_NUM_PORTS; i++) {
+        names[i] = fmt::format("AudioOut {} queued frames", i + 1);
+    }
+    return names;
+}();
+static const auto jitter_plot_names = [] {
+    std::array<std::string, SCE_AUDIO_OUT_NUM_PORTS> names;
+    for (s32 i = 0; i < SCE_AUDIO_OUT_NUM_PORTS; i++) {
+        names[i] = fmt::format("AudioOut {} jitter (us)", i + 1);
+    }
+    return names;
+}();
+#endif
+
 static void AudioOutputThread(PortOut* port, const std::stop_token& stop) {
     {
         const auto thread_name = fmt::format("shadPS4:AudioOutputThread:{}", fmt::ptr(port));
         Common::SetCurrentThreadName(thread_name.c_str());
     }
 
-    Common::AccurateTimer timer(
-        std::chrono::nanoseconds(1000000000ULL * port->buffer_frames / port->sample_rate));
+    const size_t index = port - ports_out.data();
+    auto& stats = DebugState.audio_stats.ports[index];
+    const auto period =
+        std::chrono::nanoseconds(1000000000ULL * port->buffer_frames / port->sample_rate);
+    Common::AccurateTimer timer(period);
+    std::chrono::steady_clock::time_point last_output{};
+    bool playing = false;
     while (true) {
         timer.Start();
         {
@@ -304,6 +394,29 @@ static void AudioOutputThread(PortOut* port, const std::stop_token& stop) {
             if (port->output_ready) {
                 port->impl->Output(port->output_buffer);
                 port->output_ready = false;
+
+                const auto now = std::chrono::steady_clock::now();
+                if (playing) {
+                    const auto interval = now - last_output;
+                    const auto jitter = std::chrono::duration_cast<std::chrono::microseconds>(
+                        interval > period ? interval - period : period - interval);
+                    const u32 jitter_us = static_cast<u32>(jitter.count());
+                    stats.jitter_us.store(jitter_us, std::memory_order_relaxed);
+                    if (jitter_us > stats.max_jitter_us.load(std::memory_order_relaxed)) {
+                        stats.max_jitter_us.store(jitter_us, std::memory_order_relaxed);
+                    }
+                    DETAILED_PLOT(jitter_plot_names[index].c_str(), static_cast<s64>(jitter_us));
+                }
+                last_output = now;
+                playing = true;
+                const u32 queued = port->impl->GetQueuedFrames();
+                stats.queued_frames.store(queued, std::memory_order_relaxed);
+                stats.num_outputs.fetch_add(1, std::memory_order_relaxed);
+                DETAILED_PLOT(queued_plot_names[index].c_str(), static_cast<s64>(queued));
+            } else if (playing) {
+                // The guest missed a period, the host drains its queue or plays silence.
+                stats.underruns.fetch_add(1, std::memory_order_relaxed);
+                playing = false;
             }
         }
         port->output_cv.notify_one();
@@ -374,11 +487,22 @@ s32 PS4_SYSV_ABI sceAudioOutOpen(UserService::OrbisUserServiceUserId user_id,
         port->sample_rate = sample_rate;
         port->buffer_frames = length;
         port->volume.fill(SCE_AUDIO_OUT_VOLUME_0DB);
+        UpdateGains(*port);
 
         port->impl = audio->Open(*port);
 
         port->output_buffer = std::malloc(port->BufferSize());
         port->output_ready = false;
+        auto& stats = DebugState.audio_stats.ports[std::distance(ports_out.begin(), port)];
+        stats.type = static_cast<s32>(port_type);
+        stats.buffer_frames = length;
+        stats.num_outputs = 0;
+        stats.queued_frames = 0;
+        stats.underruns = 0;
+        stats.jitter_us = 0;
+        stats.max_jitter_us = 0;
+        stats.is_open = true;
+
         port->output_thread.Run(
             [port](const std::stop_token& stop) { AudioOutputThread(&*port, stop); });
     }
@@ -407,7 +531,7 @@ s32 PS4_SYSV_ABI sceAudioOutOutput(s32 handle, void* ptr) {
         }
         port.output_cv.wait(lock, [&] { return !port.output_ready; });
         if (ptr != nullptr && port.IsOpen()) {
-            std::memcpy(port.output_buffer, ptr, port.BufferSize());
+            CopyOutput(port, ptr);
             port.output_ready = true;
             port.last_output_time = Kernel::sceKernelGetProcessTime();
             samples_sent = port.buffer_frames * port.format_info.num_channels;
@@ -536,9 +660,8 @@ s32 PS4_SYSV_ABI sceAudioOutSetVolume(s32 handle, s32 flag, s32* vol) {
                 port.volume[i] = vol[i];
             }
         }
-        port.impl->SetVolume(port.volume);
+        UpdateGains(port);
     }
-    AdjustVol();
     return ORBIS_OK;
 }
 
@@ -552,7 +675,7 @@ void AdjustVol() {
         if (!ports_out[i].IsOpen()) {
             continue;
         }
-        ports_out[i].impl->SetVolume(ports_out[i].volume);
+        UpdateGains(ports_out[i]);
     }
 }
 
@@ -98,6 +98,9 @@ struct PortOut {
     u32 buffer_frames;
     u64 last_output_time;
     std::array<s32, 8> volume;
+    /// Channel volumes combined with the volume slider.
+    std::array<float, 8> gains;
+    bool unity_gain;
 
     [[nodiscard]] bool IsOpen() const {
         return impl != nullptr;
@@ -3,6 +3,13 @@
 
 #pragma once
 
+#include <array>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "common/types.h"
+
 namespace Libraries::AudioOut {
 
 struct PortOut;
@@ -13,9 +20,13 @@ public:
 
     /// Guaranteed to be called in intervals of at least port buffer time,
     /// with size equal to port buffer size.
+    /// Volume is applied by the AudioOut library before the buffer is passed to the backend.
     virtual void Output(void* ptr) = 0;
 
-    virtual void SetVolume(const std::array<int, 8>& ch_volumes) = 0;
+    /// Returns the number of frames queued on the host that have not been played yet.
+    [[nodiscard]] virtual u32 GetQueuedFrames() const {
+        return 0;
+    }
 };
 
 class AudioOutBackend {
@@ -31,4 +42,33 @@ public:
     std::unique_ptr<PortBackend> Open(PortOut& port) override;
 };
 
+#ifdef ENABLE_NATIVE_AUDIO
+/// Outputs through the audio API of the host, ALSA on Linux, WASAPI on Windows and CoreAudio on
+/// macOS. Ports that fail to open on the host API fall back to SDL.
+class NativeAudioOut final : public AudioOutBackend {
+public:
+    std::unique_ptr<PortBackend> Open(PortOut& port) override;
+};
+#endif
+
+/// Returns the host period size of a port in frames, the guest buffer size unless configured.
+u32 GetPeriodFrames(const PortOut& port);
+
+/// Reorders the frames of a port into the channel order of a host API.
+class ChannelRemapper {
+public:
+    /// host_order holds the position in the port channel layout of each host channel for 8
+    /// channel ports, it is empty when the host uses the layout order.
+    explicit ChannelRemapper(const PortOut& port, std::span<const int> host_order = {});
+
+    /// Returns the frames in host order, this is ptr itself when no reordering is needed.
+    const void* Remap(const void* ptr);
+
+private:
+    u32 sample_size;
+    u32 num_channels;
+    std::array<int, 8> channel_map{};
+    std::vector<u8> buffer;
+};
+
 } // namespace Libraries::AudioOut
@@ -0,0 +1,93 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#include "common/assert.h"
+#include "core/libraries/audio/audioout_kernels.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace Libraries::AudioOut {
+
+namespace {
+
+constexpr size_t VectorLanes = 8;
+
+/// Returns the gains of eight consecutive samples, valid when the channel count divides them.
+std::array<float, VectorLanes> ExpandGains(std::span<const float> gains) {
+    std::array<float, VectorLanes> lanes{};
+    for (size_t i = 0; i < lanes.size(); i++) {
+        lanes[i] = gains[i % gains.size()];
+    }
+    return lanes;
+}
+
+bool CanVectorize(std::span<const float> gains) {
+    return VectorLanes % gains.size() == 0;
+}
+
+} // Anonymous namespace
+
+void CopyScaled(std::span<const s16> src, std::span<s16> dst, std::span<const float> gains) {
+    ASSERT(dst.size() >= src.size() && !gains.empty());
+    size_t i = 0;
+#ifdef __AVX2__
+    if (CanVectorize(gains)) {
+        const auto lanes = ExpandGains(gains);
+        const __m256 gain = _mm256_loadu_ps(lanes.data());
+        const auto scale = [&](__m128i samples) {
+            const __m256 values = _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(samples));
+            return _mm256_cvtps_epi32(_mm256_mul_ps(values, gain));
+        };
+        for (; i + 2 * VectorLanes <= src.size(); i += 2 * VectorLanes) {
+            const __m128i* in = reinterpret_cast<const __m128i*>(src.data() + i);
+            // Packing saturates and works per 128-bit lane, the permute restores the order.
+            const __m256i packed = _mm256_packs_epi32(scale(_mm_loadu_si128(in)),
+                                                      scale(_mm_loadu_si128(in + 1)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst.data() + i),
+                                _mm256_permute4x64_epi64(packed, 0xD8));
+        }
+    }
+#endif
+    for (; i < src.size(); i++) {
+        const float value = std::nearbyint(src[i] * gains[i % gains.size()]);
+        dst[i] = static_cast<s16>(std::clamp(value, -32768.0f, 32767.0f));
+    }
+}
+
+void CopyScaled(std::span<const float> src, std::span<float> dst, std::span<const float> gains) {
+    ASSERT(dst.size() >= src.size() && !gains.empty());
+    size_t i = 0;
+#ifdef __AVX2__
+    if (CanVectorize(gains)) {
+        const auto lanes = ExpandGains(gains);
+        const __m256 gain = _mm256_loadu_ps(lanes.data());
+        for (; i + VectorLanes <= src.size(); i += VectorLanes) {
+            _mm256_storeu_ps(dst.data() + i, _mm256_mul_ps(_mm256_loadu_ps(src.data() + i), gain));
+        }
+    }
+#endif
+    for (; i < src.size(); i++) {
+        dst[i] = src[i] * gains[i % gains.size()];
+    }
+}
+
+void RemapChannels(std::span<const u8> src, std::span<u8> dst, u32 sample_size,
+                   std::span<const int> map) {
+    const size_t frame_size = sample_size * map.size();
+    ASSERT(dst.size() >= src.size() && src.size() % frame_size == 0);
+    for (size_t frame = 0; frame < src.size(); frame += frame_size) {
+        for (size_t i = 0; i < map.size(); i++) {
+            std::memcpy(dst.data() + frame + i * sample_size,
+                        src.data() + frame + map[i] * sample_size, sample_size);
+        }
+    }
+}
+
+} // namespace Libraries::AudioOut
@@ -0,0 +1,22 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <span>
+
+#include "common/types.h"
+
+namespace Libraries::AudioOut {
+
+/// Copies interleaved samples from src to dst, scaling each channel by its gain. The number of
+/// channels is the size of gains, S16 results saturate.
+void CopyScaled(std::span<const s16> src, std::span<s16> dst, std::span<const float> gains);
+void CopyScaled(std::span<const float> src, std::span<float> dst, std::span<const float> gains);
+
+/// Reorders the channels of interleaved frames, channel i of a dst frame is channel map[i] of the
+/// src frame. The number of channels is the size of map.
+void RemapChannels(std::span<const u8> src, std::span<u8> dst, u32 sample_size,
+                   std::span<const int> map);
+
+} // namespace Libraries::AudioOut
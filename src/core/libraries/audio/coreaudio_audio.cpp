@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <vector>
+#include <AudioToolbox/AudioToolbox.h>
+
+#include "common/config.h"
+#include "common/logging/log.h"
+#include "core/libraries/audio/audioout.h"
+#include "core/libraries/audio/audioout_backend.h"
+
+namespace Libraries::AudioOut {
+
+class CoreAudioPortBackend : public PortBackend {
+public:
+    explicit CoreAudioPortBackend(const PortOut& port)
+        : frame_size(port.format_info.FrameSize()), guest_buffer_size(port.BufferSize()),
+          remapper(port) {
+        const std::string port_name = port.type == OrbisAudioOutPort::PadSpk
+                                          ? Config::getPadSpkOutputDevice()
+                                          : Config::getMainOutputDevice();
+        if (port_name != "Default Device") {
+            // The default output unit follows the system device, other devices go through SDL.
+            return;
+        }
+        const u32 period_frames = GetPeriodFrames(port);
+        ring.resize(std::max(period_frames, port.buffer_frames) * port.format_info.FrameSize() * 4);
+        if (!Initialize(port, period_frames) && unit) {
+            AudioComponentInstanceDispose(unit);
+            unit = nullptr;
+        }
+    }
+
+    ~CoreAudioPortBackend() override {
+        if (!unit) {
+            return;
+        }
+        AudioOutputUnitStop(unit);
+        AudioUnitUninitialize(unit);
+        AudioComponentInstanceDispose(unit);
+        unit = nullptr;
+    }
+
+    [[nodiscard]] bool IsValid() const {
+        return unit != nullptr;
+    }
+
+    void Output(void* ptr) override {
+        const u8* data = static_cast<const u8*>(remapper.Remap(ptr));
+        const u64 write = write_pos.load(std::memory_order_relaxed);
+        const u64 read = read_pos.load(std::memory_order_acquire);
+        if (ring.size() - (write - read) < guest_buffer_size) {
+            // Same as for SDL, the device may stop consuming samples during device changes.
+            LOG_INFO(Lib_AudioOut, "CoreAudio queue backed up, dropping samples.");
+            return;
+        }
+        const size_t offset = write % ring.size();
+        const size_t head = std::min<size_t>(guest_buffer_size, ring.size() - offset);
+        std::memcpy(ring.data() + offset, data, head);
+        std::memcpy(ring.data(), data + head, guest_buffer_size - head);
+        write_pos.store(write + guest_buffer_size, std::memory_order_release);
+    }
+
+    [[nodiscard]] u32 GetQueuedFrames() const override {
+        const u64 write = write_pos.load(std::memory_order_acquire);
+        const u64 read = read_pos.load(std::memory_order_acquire);
+        return static_cast<u32>((write - read) / frame_size);
+    }
+
+private:
+    bool Initialize(const PortOut& port, u32 period_frames) {
+        const AudioComponentDescription description = {
+            .componentType = kAudioUnitType_Output,
+            .componentSubType = kAudioUnitSubType_DefaultOutput,
+            .componentManufacturer = kAudioUnitManufacturer_Apple,
+        };
+        const AudioComponent component = AudioComponentFindNext(nullptr, &description);
+        if (!component || AudioComponentInstanceNew(component, &unit) != noErr) {
+            LOG_ERROR(Lib_AudioOut, "Failed to create CoreAudio output unit");
+            unit = nullptr;
+            return false;
+        }
+
+        const auto& info = port.format_info;
+        const AudioStreamBasicDescription format = {
+            .mSampleRate = static_cast<Float64>(port.sample_rate),
+            .mFormatID = kAudioFormatLinearPCM,
+            .mFormatFlags = (info.is_float ? kAudioFormatFlagIsFloat
+                                           : kAudioFormatFlagIsSignedInteger) |
+                            kAudioFormatFlagIsPacked,
+            .mBytesPerPacket = info.FrameSize(),
+            .mFramesPerPacket = 1,
+            .mBytesPerFrame = info.FrameSize(),
+            .mChannelsPerFrame = info.num_channels,
+            .mBitsPerChannel = info.sample_size * 8U,
+        };
+        OSStatus status = AudioUnitSetProperty(unit, kAudioUnitProperty_StreamFormat,
+                                               kAudioUnitScope_Input, 0, &format, sizeof(format));
+        if (status != noErr) {
+            LOG_ERROR(Lib_AudioOut, "Failed to set CoreAudio stream format: {}", status);
+            return false;
+        }
+        if (info.num_channels == 8) {
+            // Port channels are reordered to the WAVE layout, FL, FR, FC, LFE, BL, BR, SL, SR.
+            AudioChannelLayout layout{};
+            layout.mChannelLayoutTag = kAudioChannelLayoutTag_WAVE_7_1;
+            AudioUnitSetProperty(unit, kAudioUnitProperty_AudioChannelLayout,
+                                 kAudioUnitScope_Input, 0, &layout, sizeof(layout));
+        }
+        const AURenderCallbackStruct callback = {
+            .inputProc = RenderCallback,
+            .inputProcRefCon = this,
+        };
+        status = AudioUnitSetProperty(unit, kAudioUnitProperty_SetRenderCallback,
+                                      kAudioUnitScope_Input, 0, &callback, sizeof(callback));
+        if (status != noErr) {
+            LOG_ERROR(Lib_AudioOut, "Failed to set CoreAudio render callback: {}", status);
+            return false;
+        }
+        UInt32 device_period = period_frames;
+        if (AudioUnitSetProperty(unit, kAudioDevicePropertyBufferFrameSize,
+                                 kAudioUnitScope_Global, 0, &device_period,
+                                 sizeof(device_period)) != noErr) {
+            LOG_WARNING(Lib_AudioOut, "Failed to set CoreAudio period to {} frames",
+                        period_frames);
+        }
+        if (status = AudioUnitInitialize(unit); status != noErr) {
+            LOG_ERROR(Lib_AudioOut, "Failed to initialize CoreAudio output unit: {}", status);
+            return false;
+        }
+        if (status = AudioOutputUnitStart(unit); status != noErr) {
+            LOG_ERROR(Lib_AudioOut, "Failed to start CoreAudio output unit: {}", status);
+            AudioUnitUninitialize(unit);
+            return false;
+        }
+        LOG_INFO(Lib_AudioOut, "CoreAudio audio buffers: guest = {} bytes, host = {} bytes",
+                 guest_buffer_size, ring.size());
+        return true;
+    }
+
+    static OSStatus RenderCallback(void* user_data, AudioUnitRenderActionFlags*,
+                                   const AudioTimeStamp*, UInt32, UInt32,
+                                   AudioBufferList* buffers) {
+        auto* backend = static_cast<CoreAudioPortBackend*>(user_data);
+        AudioBuffer& buffer = buffers->mBuffers[0];
+        backend->Read(static_cast<u8*>(buffer.mData), buffer.mDataByteSize);
+        return noErr;
+    }
+
+    /// Runs on the CoreAudio render thread, missing samples are filled with silence.
+    void Read(u8* dst, size_t size) {
+        const u64 read = read_pos.load(std::memory_order_relaxed);
+        const u64 write = write_pos.load(std::memory_order_acquire);
+        const size_t available = std::min<size_t>(size, write - read);
+        const size_t offset = read % ring.size();
+        const size_t head = std::min(available, ring.size() - offset);
+        std::memcpy(dst, ring.data() + offset, head);
+        std::memcpy(dst + head, ring.data(), available - head);
+        std::memset(dst + available, 0, size - available);
+        read_pos.store(read + available, std::memory_order_release);
+    }
+
+    u32 frame_size;
+    u32 guest_buffer_size;
+    ChannelRemapper remapper;
+    AudioComponentInstance unit{};
+    std::vector<u8> ring;
+    std::atomic<u64> read_pos{};
+    std::atomic<u64> write_pos{};
+};
+
+std::unique_ptr<PortBackend> NativeAudioOut::Open(PortOut& port) {
+    auto backend = std::make_unique<CoreAudioPortBackend>(port);
+    if (backend->IsValid()) {
+        return backend;
+    }
+    LOG_WARNING(Lib_AudioOut, "Falling back to SDL audio output");
+    return SDLAudioOut{}.Open(port);
+}
+
+} // namespace Libraries::AudioOut
@@ -78,7 +78,6 @@ public:
             stream = nullptr;
             return;
         }
-        SDL_SetAudioStreamGain(stream, Config::getVolumeSlider() / 100.0f);
     }
 
     ~SDLPortBackend() override {
@@ -108,17 +107,11 @@ public:
         }
     }
 
-    void SetVolume(const std::array<int, 8>& ch_volumes) override {
+    [[nodiscard]] u32 GetQueuedFrames() const override {
         if (!stream) {
-            return;
-        }
-        // SDL does not have per-channel volumes, for now just take the maximum of the channels.
-        const auto vol = *std::ranges::max_element(ch_volumes);
-        if (!SDL_SetAudioStreamGain(stream, static_cast<float>(vol) / SCE_AUDIO_OUT_VOLUME_0DB *
-                                                Config::getVolumeSlider() / 100.0f)) {
-            LOG_WARNING(Lib_AudioOut, "Failed to change SDL audio stream volume: {}",
-                        SDL_GetError());
+            return 0;
         }
+        return std::max(SDL_GetAudioStreamQueued(stream), 0) / frame_size;
     }
 
 private:
@@ -0,0 +1,262 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <windows.h>
+#include <audioclient.h>
+#include <mmdeviceapi.h>
+#include <initguid.h>
+#include <functiondiscoverykeys_devpkey.h>
+#include <ksmedia.h>
+
+#include "common/config.h"
+#include "common/logging/log.h"
+#include "common/string_util.h"
+#include "core/libraries/audio/audioout.h"
+#include "core/libraries/audio/audioout_backend.h"
+
+namespace Libraries::AudioOut {
+
+namespace {
+
+struct ComReleaser {
+    void operator()(IUnknown* ptr) const {
+        ptr->Release();
+    }
+};
+
+template <typename T>
+using ComPtr = std::unique_ptr<T, ComReleaser>;
+
+/// Audio clients are created in the multithreaded apartment, which both the thread opening a
+/// port and its output thread have to join.
+void InitializeCom() {
+    thread_local const HRESULT result = CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+    if (FAILED(result)) {
+        LOG_ERROR(Lib_AudioOut, "Failed to initialize COM: {:#x}", static_cast<u32>(result));
+    }
+}
+
+ComPtr<IMMDevice> FindDevice(IMMDeviceEnumerator* enumerator, const std::string& name) {
+    if (name != "Default Device") {
+        // Configured devices are named by their friendly name, as listed by SDL.
+        IMMDeviceCollection* collection_ptr;
+        if (SUCCEEDED(enumerator->EnumAudioEndpoints(eRender, DEVICE_STATE_ACTIVE,
+                                                     &collection_ptr))) {
+            ComPtr<IMMDeviceCollection> collection{collection_ptr};
+            UINT count = 0;
+            collection->GetCount(&count);
+            for (UINT i = 0; i < count; i++) {
+                IMMDevice* device_ptr;
+                if (FAILED(collection->Item(i, &device_ptr))) {
+                    continue;
+                }
+                ComPtr<IMMDevice> device{device_ptr};
+                IPropertyStore* store_ptr;
+                if (FAILED(device->OpenPropertyStore(STGM_READ, &store_ptr))) {
+                    continue;
+                }
+                ComPtr<IPropertyStore> store{store_ptr};
+                PROPVARIANT friendly_name;
+                PropVariantInit(&friendly_name);
+                const bool matches =
+                    SUCCEEDED(store->GetValue(PKEY_Device_FriendlyName, &friendly_name)) &&
+                    friendly_name.vt == VT_LPWSTR &&
+                    Common::UTF16ToUTF8(friendly_name.pwszVal) == name;
+                PropVariantClear(&friendly_name);
+                if (matches) {
+                    return device;
+                }
+            }
+        }
+        LOG_WARNING(Lib_AudioOut, "Audio device not found: {}", name);
+    }
+    IMMDevice* device_ptr;
+    if (FAILED(enumerator->GetDefaultAudioEndpoint(eRender, eConsole, &device_ptr))) {
+        return nullptr;
+    }
+    return ComPtr<IMMDevice>{device_ptr};
+}
+
+} // Anonymous namespace
+
+class WasapiPortBackend : public PortBackend {
+public:
+    explicit WasapiPortBackend(const PortOut& port)
+        : frame_size(port.format_info.FrameSize()), guest_buffer_frames(port.buffer_frames),
+          remapper(port) {
+        const std::string port_name = port.type == OrbisAudioOutPort::PadSpk
+                                          ? Config::getPadSpkOutputDevice()
+                                          : Config::getMainOutputDevice();
+        if (port_name == "None") {
+            return;
+        }
+        InitializeCom();
+        if (!Initialize(port, port_name)) {
+            render_client.reset();
+            client.reset();
+        }
+    }
+
+    ~WasapiPortBackend() override {
+        if (client) {
+            client->Stop();
+        }
+        render_client.reset();
+        client.reset();
+        if (event) {
+            CloseHandle(event);
+        }
+    }
+
+    [[nodiscard]] bool IsValid() const {
+        return client != nullptr;
+    }
+
+    void Output(void* ptr) override {
+        InitializeCom();
+        const u8* data = static_cast<const u8*>(remapper.Remap(ptr));
+        u32 frames_written = 0;
+        while (frames_written < guest_buffer_frames) {
+            UINT32 padding;
+            if (const HRESULT result = client->GetCurrentPadding(&padding); FAILED(result)) {
+                LOG_ERROR(Lib_AudioOut, "Failed to query WASAPI buffer: {:#x}",
+                          static_cast<u32>(result));
+                return;
+            }
+            const u32 frames =
+                std::min(host_buffer_frames - padding, guest_buffer_frames - frames_written);
+            if (frames == 0) {
+                // The event is signaled whenever the device has consumed a period. The device
+                // may stop consuming samples during device changes, drop the buffer then.
+                if (WaitForSingleObject(event, 100) == WAIT_TIMEOUT) {
+                    LOG_INFO(Lib_AudioOut, "WASAPI device stalled, dropping samples.");
+                    return;
+                }
+                continue;
+            }
+            BYTE* buffer;
+            if (const HRESULT result = render_client->GetBuffer(frames, &buffer);
+                FAILED(result)) {
+                LOG_ERROR(Lib_AudioOut, "Failed to output to WASAPI device: {:#x}",
+                          static_cast<u32>(result));
+                return;
+            }
+            std::memcpy(buffer, data + frames_written * frame_size, frames * frame_size);
+            render_client->ReleaseBuffer(frames, 0);
+            frames_written += frames;
+        }
+    }
+
+    [[nodiscard]] u32 GetQueuedFrames() const override {
+        UINT32 padding;
+        if (FAILED(client->GetCurrentPadding(&padding))) {
+            return 0;
+        }
+        return padding;
+    }
+
+private:
+    bool Initialize(const PortOut& port, const std::string& port_name) {
+        IMMDeviceEnumerator* enumerator_ptr;
+        HRESULT result = CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL,
+                                          __uuidof(IMMDeviceEnumerator),
+                                          reinterpret_cast<void**>(&enumerator_ptr));
+        if (FAILED(result)) {
+            LOG_ERROR(Lib_AudioOut, "Failed to create device enumerator: {:#x}",
+                      static_cast<u32>(result));
+            return false;
+        }
+        ComPtr<IMMDeviceEnumerator> enumerator{enumerator_ptr};
+        const auto device = FindDevice(enumerator.get(), port_name);
+        if (!device) {
+            LOG_ERROR(Lib_AudioOut, "No WASAPI output device available");
+            return false;
+        }
+
+        IAudioClient* client_ptr;
+        result = device->Activate(__uuidof(IAudioClient), CLSCTX_ALL, nullptr,
+                                  reinterpret_cast<void**>(&client_ptr));
+        if (FAILED(result)) {
+            LOG_ERROR(Lib_AudioOut, "Failed to activate audio client: {:#x}",
+                      static_cast<u32>(result));
+            return false;
+        }
+        client.reset(client_ptr);
+
+        const auto& info = port.format_info;
+        WAVEFORMATEXTENSIBLE format{};
+        format.Format.wFormatTag = WAVE_FORMAT_EXTENSIBLE;
+        format.Format.nChannels = info.num_channels;
+        format.Format.nSamplesPerSec = port.sample_rate;
+        format.Format.nAvgBytesPerSec = port.sample_rate * info.FrameSize();
+        format.Format.nBlockAlign = info.FrameSize();
+        format.Format.wBitsPerSample = info.sample_size * 8;
+        format.Format.cbSize = sizeof(WAVEFORMATEXTENSIBLE) - sizeof(WAVEFORMATEX);
+        format.Samples.wValidBitsPerSample = info.sample_size * 8;
+        format.dwChannelMask = info.num_channels == 1   ? KSAUDIO_SPEAKER_MONO
+                               : info.num_channels == 2 ? KSAUDIO_SPEAKER_STEREO
+                                                        : KSAUDIO_SPEAKER_7POINT1_SURROUND;
+        format.SubFormat =
+            info.is_float ? KSDATAFORMAT_SUBTYPE_IEEE_FLOAT : KSDATAFORMAT_SUBTYPE_PCM;
+
+        // Keep room for two guest buffers so that output does not wait on the device.
+        const u32 buffer_frames = std::max(GetPeriodFrames(port), guest_buffer_frames) * 2;
+        const REFERENCE_TIME buffer_duration = 10'000'000LL * buffer_frames / port.sample_rate;
+        result = client->Initialize(AUDCLNT_SHAREMODE_SHARED,
+                                    AUDCLNT_STREAMFLAGS_EVENTCALLBACK |
+                                        AUDCLNT_STREAMFLAGS_AUTOCONVERTPCM |
+                                        AUDCLNT_STREAMFLAGS_SRC_DEFAULT_QUALITY,
+                                    buffer_duration, 0, &format.Format, nullptr);
+        if (FAILED(result)) {
+            LOG_ERROR(Lib_AudioOut, "Failed to initialize audio client: {:#x}",
+                      static_cast<u32>(result));
+            return false;
+        }
+        event = CreateEventW(nullptr, FALSE, FALSE, nullptr);
+        if (!event || FAILED(client->SetEventHandle(event))) {
+            LOG_ERROR(Lib_AudioOut, "Failed to set audio client event");
+            return false;
+        }
+        client->GetBufferSize(&host_buffer_frames);
+
+        IAudioRenderClient* render_ptr;
+        result = client->GetService(__uuidof(IAudioRenderClient),
+                                    reinterpret_cast<void**>(&render_ptr));
+        if (FAILED(result)) {
+            LOG_ERROR(Lib_AudioOut, "Failed to get audio render client: {:#x}",
+                      static_cast<u32>(result));
+            return false;
+        }
+        render_client.reset(render_ptr);
+        if (result = client->Start(); FAILED(result)) {
+            LOG_ERROR(Lib_AudioOut, "Failed to start audio client: {:#x}",
+                      static_cast<u32>(result));
+            return false;
+        }
+        LOG_INFO(Lib_AudioOut, "WASAPI audio buffers: guest = {} frames, host = {} frames",
+                 guest_buffer_frames, host_buffer_frames);
+        return true;
+    }
+
+    u32 frame_size;
+    u32 guest_buffer_frames;
+    UINT32 host_buffer_frames{};
+    ChannelRemapper remapper;
+    HANDLE event{};
+    ComPtr<IAudioClient> client;
+    ComPtr<IAudioRenderClient> render_client;
+};
+
+std::unique_ptr<PortBackend> NativeAudioOut::Open(PortOut& port) {
+    auto backend = std::make_unique<WasapiPortBackend>(port);
+    if (backend->IsValid()) {
+        return backend;
+    }
+    LOG_WARNING(Lib_AudioOut, "Falling back to SDL audio output");
+    return SDLAudioOut{}.Open(port);
+}
+
+} // namespace Libraries::AudioOut
@@ -1,10 +1,12 @@
 // SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-#include <SDL3/SDL_audio.h>
+#include <algorithm>
+#include <ranges>
 #include <magic_enum/magic_enum.hpp>
 
 #include "common/assert.h"
+#include "common/config.h"
 #include "common/logging/log.h"
 #include "core/libraries/audio/audioout.h"
 #include "core/libraries/audio/audioout_error.h"
@@ -17,9 +19,6 @@ namespace Libraries::Audio3d {
 
 static constexpr u32 AUDIO3D_SAMPLE_RATE = 48000;
 
-static constexpr AudioOut::OrbisAudioOutParamFormat AUDIO3D_OUTPUT_FORMAT =
-    AudioOut::OrbisAudioOutParamFormat::S16Stereo;
-static constexpr u32 AUDIO3D_OUTPUT_NUM_CHANNELS = 2;
 static constexpr u32 AUDIO3D_OUTPUT_BUFFER_FRAMES = 0x100;
 
 static std::unique_ptr<Audio3dState> state;
@@ -79,36 +78,37 @@ s32 PS4_SYSV_ABI sceAudio3dAudioOutOutputs(AudioOut::OrbisAudioOutOutputParam* p
     return AudioOut::sceAudioOutOutputs(param, num);
 }
 
-static s32 PortQueueAudio(Port& port, const OrbisAudio3dPcm& pcm, const u32 num_channels) {
-    // Audio3d output is configured for stereo signed 16-bit PCM. Convert the data to match.
-    const SDL_AudioSpec src_spec = {
-        .format = pcm.format == OrbisAudio3dFormat::ORBIS_AUDIO3D_FORMAT_S16 ? SDL_AUDIO_S16LE
-                                                                             : SDL_AUDIO_F32LE,
-        .channels = static_cast<int>(num_channels),
-        .freq = AUDIO3D_SAMPLE_RATE,
-    };
-    constexpr SDL_AudioSpec dst_spec = {
-        .format = SDL_AUDIO_S16LE,
-        .channels = AUDIO3D_OUTPUT_NUM_CHANNELS,
-        .freq = AUDIO3D_SAMPLE_RATE,
-    };
-    const auto src_size = pcm.num_samples *
-                          (pcm.format == OrbisAudio3dFormat::ORBIS_AUDIO3D_FORMAT_S16 ? 2 : 4) *
-                          num_channels;
-
-    u8* dst_data;
-    int dst_len;
-    if (!SDL_ConvertAudioSamples(&src_spec, static_cast<u8*>(pcm.sample_buffer),
-                                 static_cast<int>(src_size), &dst_spec, &dst_data, &dst_len)) {
-        LOG_ERROR(Lib_Audio3d, "SDL_ConvertAudioSamples failed: {}", SDL_GetError());
-        return ORBIS_AUDIO3D_ERROR_OUT_OF_MEMORY;
-    }
-
-    port.queue.emplace_back(AudioData{
-        .sample_buffer = dst_data,
-        .num_samples = pcm.num_samples,
-    });
-    return ORBIS_OK;
+/// Converts num_frames of interleaved PCM to float samples.
+static void ConvertPcm(const OrbisAudio3dPcm& pcm, const u32 num_channels, const u32 num_frames,
+                       std::span<float> out) {
+    const u32 num_samples = num_frames * num_channels;
+    if (pcm.format == OrbisAudio3dFormat::ORBIS_AUDIO3D_FORMAT_FLOAT) {
+        const auto* src = static_cast<const float*>(pcm.sample_buffer);
+        std::copy_n(src, num_samples, out.begin());
+        return;
+    }
+    const auto* src = static_cast<const s16*>(pcm.sample_buffer);
+    for (u32 i = 0; i < num_samples; i++) {
+        out[i] = static_cast<float>(src[i]) / 32768.0f;
+    }
+}
+
+/// Sends the samples of a grain to the AudioOut port in buffers of its length.
+static s32 OutputGrain(std::span<const float> grain) {
+    auto& pending = state->pending_output;
+    pending.insert(pending.end(), grain.begin(), grain.end());
+    const u32 num_channels = state->binaural ? 2 : NUM_SPEAKER_CHANNELS;
+    const size_t buffer_size = AUDIO3D_OUTPUT_BUFFER_FRAMES * num_channels;
+    size_t offset = 0;
+    s32 ret = ORBIS_OK;
+    for (; offset + buffer_size <= pending.size(); offset += buffer_size) {
+        ret = AudioOut::sceAudioOutOutput(state->audio_out_handle, pending.data() + offset);
+        if (ret < 0) {
+            break;
+        }
+    }
+    pending.erase(pending.begin(), pending.begin() + offset);
+    return ret < 0 ? ret : ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceAudio3dBedWrite(const OrbisAudio3dPortId port_id, const u32 num_channels,
@@ -167,13 +167,19 @@ s32 PS4_SYSV_ABI sceAudio3dBedWrite2(const OrbisAudio3dPortId port_id, const u32
         }
     }
 
-    return PortQueueAudio(state->ports[port_id],
-                          OrbisAudio3dPcm{
-                              .format = format,
-                              .sample_buffer = buffer,
-                              .num_samples = num_samples,
-                          },
-                          num_channels);
+    auto& mixer = *state->ports[port_id].mixer;
+    const u32 num_frames = std::min(num_samples, mixer.NumSamples());
+    auto& samples = state->convert_buffer;
+    samples.resize(num_frames * num_channels);
+    ConvertPcm(
+        OrbisAudio3dPcm{
+            .format = format,
+            .sample_buffer = buffer,
+            .num_samples = num_samples,
+        },
+        num_channels, num_frames, samples);
+    mixer.MixBed(samples, num_channels);
+    return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceAudio3dCreateSpeakerArray() {
@@ -237,7 +243,9 @@ s32 PS4_SYSV_ABI sceAudio3dInitialize(const s64 reserved) {
     }
 
     AudioOut::OrbisAudioOutParamExtendedInformation ext_info{};
-    ext_info.data_format.Assign(AUDIO3D_OUTPUT_FORMAT);
+    state->binaural = Config::isAudio3dHrtfEnabled();
+    ext_info.data_format.Assign(state->binaural ? AudioOut::OrbisAudioOutParamFormat::FloatStereo
+                                                : AudioOut::OrbisAudioOutParamFormat::Float_8CH);
     state->audio_out_handle =
         AudioOut::sceAudioOutOpen(0xFF, AudioOut::OrbisAudioOutPort::Audio3d, 0,
                                   AUDIO3D_OUTPUT_BUFFER_FRAMES, AUDIO3D_SAMPLE_RATE, ext_info);
@@ -263,8 +271,14 @@ s32 PS4_SYSV_ABI sceAudio3dObjectReserve(const OrbisAudio3dPortId port_id,
         return ORBIS_AUDIO3D_ERROR_INVALID_PARAMETER;
     }
 
-    static int last_id = 0;
-    *object_id = ++last_id;
+    auto& port = state->ports[port_id];
+    if (port.objects.size() >= port.parameters.max_objects) {
+        LOG_ERROR(Lib_Audio3d, "port.objects.size() >= port.parameters.max_objects");
+        return ORBIS_AUDIO3D_ERROR_OUT_OF_RESOURCES;
+    }
+
+    *object_id = ++port.last_object_id;
+    port.objects[*object_id].pcm.resize(port.mixer->NumSamples());
 
     return ORBIS_OK;
 }
@@ -283,6 +297,17 @@ s32 PS4_SYSV_ABI sceAudio3dObjectSetAttributes(const OrbisAudio3dPortId port_id,
     }
 
     auto& port = state->ports[port_id];
+    if (!port.objects.contains(object_id)) {
+        LOG_ERROR(Lib_Audio3d, "!port.objects.contains(object_id)");
+        return ORBIS_AUDIO3D_ERROR_INVALID_OBJECT;
+    }
+
+    if (num_attributes && !attribute_array) {
+        LOG_ERROR(Lib_Audio3d, "!attribute_array");
+        return ORBIS_AUDIO3D_ERROR_INVALID_PARAMETER;
+    }
+
+    auto& object = port.objects[object_id];
 
     for (u64 i = 0; i < num_attributes; i++) {
         const auto& attribute = attribute_array[i];
@@ -290,12 +315,41 @@ s32 PS4_SYSV_ABI sceAudio3dObjectSetAttributes(const OrbisAudio3dPortId port_id,
         switch (attribute.attribute_id) {
         case OrbisAudio3dAttributeId::ORBIS_AUDIO3D_ATTRIBUTE_PCM: {
             const auto pcm = static_cast<OrbisAudio3dPcm*>(attribute.value);
-            // Object audio has 1 channel.
-            if (const auto ret = PortQueueAudio(port, *pcm, 1); ret != ORBIS_OK) {
-                return ret;
+            if (pcm->format > OrbisAudio3dFormat::ORBIS_AUDIO3D_FORMAT_FLOAT ||
+                !pcm->sample_buffer) {
+                LOG_ERROR(Lib_Audio3d, "invalid object PCM");
+                return ORBIS_AUDIO3D_ERROR_INVALID_PARAMETER;
             }
+            // Object audio has 1 channel, samples past the grain are dropped.
+            const u32 num_frames = std::min<u32>(pcm->num_samples, object.pcm.size());
+            ConvertPcm(*pcm, 1, num_frames, object.pcm);
+            std::fill(object.pcm.begin() + num_frames, object.pcm.end(), 0.0f);
+            object.has_pcm = true;
             break;
         }
+        case OrbisAudio3dAttributeId::ORBIS_AUDIO3D_ATTRIBUTE_PRIORITY:
+            // Every object is mixed, priorities only matter once objects are culled.
+            break;
+        case OrbisAudio3dAttributeId::ORBIS_AUDIO3D_ATTRIBUTE_POSITION: {
+            const auto position = static_cast<const OrbisAudio3dPosition*>(attribute.value);
+            object.position = {position->x, position->y, position->z};
+            break;
+        }
+        case OrbisAudio3dAttributeId::ORBIS_AUDIO3D_ATTRIBUTE_SPREAD:
+            object.spread = *static_cast<const float*>(attribute.value);
+            break;
+        case OrbisAudio3dAttributeId::ORBIS_AUDIO3D_ATTRIBUTE_GAIN:
+            object.gain = *static_cast<const float*>(attribute.value);
+            break;
+        case OrbisAudio3dAttributeId::ORBIS_AUDIO3D_ATTRIBUTE_PASSTHROUGH:
+            object.passthrough = *static_cast<const Audio3dPassthrough*>(attribute.value);
+            break;
+        case OrbisAudio3dAttributeId::ORBIS_AUDIO3D_ATTRIBUTE_RESET_STATE:
+            object.position = {};
+            object.gain = 1.0f;
+            object.spread = 0.0f;
+            object.passthrough = Audio3dPassthrough::None;
+            break;
         default:
             LOG_ERROR(Lib_Audio3d, "Unsupported attribute ID: {:#x}",
                       static_cast<u32>(attribute.attribute_id));
@@ -306,8 +360,20 @@ s32 PS4_SYSV_ABI sceAudio3dObjectSetAttributes(const OrbisAudio3dPortId port_id,
     return ORBIS_OK;
 }
 
-s32 PS4_SYSV_ABI sceAudio3dObjectUnreserve() {
-    LOG_ERROR(Lib_Audio3d, "(STUBBED) called");
+s32 PS4_SYSV_ABI sceAudio3dObjectUnreserve(const OrbisAudio3dPortId port_id,
+                                           const OrbisAudio3dObjectId object_id) {
+    LOG_INFO(Lib_Audio3d, "called, port_id = {}, object_id = {}", port_id, object_id);
+
+    if (!state->ports.contains(port_id)) {
+        LOG_ERROR(Lib_Audio3d, "!state->ports.contains(port_id)");
+        return ORBIS_AUDIO3D_ERROR_INVALID_PORT;
+    }
+
+    if (!state->ports[port_id].objects.erase(object_id)) {
+        LOG_ERROR(Lib_Audio3d, "!port.objects.contains(object_id)");
+        return ORBIS_AUDIO3D_ERROR_INVALID_OBJECT;
+    }
+
     return ORBIS_OK;
 }
 
@@ -326,19 +392,19 @@ s32 PS4_SYSV_ABI sceAudio3dPortAdvance(const OrbisAudio3dPortId port_id) {
     }
 
     auto& port = state->ports[port_id];
-    if (port.current_buffer.has_value()) {
-        // Free existing buffer before replacing.
-        SDL_free(port.current_buffer->sample_buffer);
+    if (port.queue.size() >= std::max(port.parameters.queue_depth, 1U)) {
+        // The guest is not pushing, drop the oldest grain rather than growing the queue.
+        LOG_DEBUG(Lib_Audio3d, "Port advance with full queue");
+        port.queue.pop_front();
     }
 
-    if (!port.queue.empty()) {
-        port.current_buffer = port.queue.front();
-        port.queue.pop_front();
-    } else {
-        // Nothing to advance to.
-        LOG_DEBUG(Lib_Audio3d, "Port advance with no buffer queued");
-        port.current_buffer = std::nullopt;
+    // Objects are mixed once per grain, after all of their attributes for it are set.
+    auto& mixer = *port.mixer;
+    for (auto& object : port.objects | std::views::values) {
+        mixer.MixObject(object);
     }
+    auto& grain = port.queue.emplace_back(mixer.NumSamples() * mixer.NumChannels());
+    mixer.Resolve(grain);
 
     return ORBIS_OK;
 }
@@ -397,7 +463,7 @@ s32 PS4_SYSV_ABI sceAudio3dPortGetQueueLevel(const OrbisAudio3dPortId port_id, u
         return ORBIS_AUDIO3D_ERROR_INVALID_PARAMETER;
     }
 
-    const auto port = state->ports[port_id];
+    const auto& port = state->ports[port_id];
     const size_t size = port.queue.size();
 
     if (queue_level) {
@@ -437,6 +503,11 @@ s32 PS4_SYSV_ABI sceAudio3dPortOpen(const OrbisUserServiceUserId user_id,
         return ORBIS_AUDIO3D_ERROR_INVALID_PARAMETER;
     }
 
+    if (parameters->granularity < MAX_ITD_SAMPLES) {
+        LOG_ERROR(Lib_Audio3d, "granularity < {}", MAX_ITD_SAMPLES);
+        return ORBIS_AUDIO3D_ERROR_INVALID_PARAMETER;
+    }
+
     const int id = static_cast<int>(state->ports.size()) + 1;
 
     if (id > 3) {
@@ -445,7 +516,9 @@ s32 PS4_SYSV_ABI sceAudio3dPortOpen(const OrbisUserServiceUserId user_id,
     }
 
     *port_id = id;
-    std::memcpy(&state->ports[id].parameters, parameters, sizeof(OrbisAudio3dOpenParameters));
+    auto& port = state->ports[id];
+    std::memcpy(&port.parameters, parameters, sizeof(OrbisAudio3dOpenParameters));
+    port.mixer.emplace(parameters->granularity, state->binaural);
 
     return ORBIS_OK;
 }
@@ -460,22 +533,23 @@ s32 PS4_SYSV_ABI sceAudio3dPortPush(const OrbisAudio3dPortId port_id,
         return ORBIS_AUDIO3D_ERROR_INVALID_PORT;
     }
 
-    const auto& port = state->ports[port_id];
+    auto& port = state->ports[port_id];
     if (port.parameters.buffer_mode !=
         OrbisAudio3dBufferMode::ORBIS_AUDIO3D_BUFFER_ADVANCE_AND_PUSH) {
         LOG_ERROR(Lib_Audio3d, "port doesn't have push capability");
         return ORBIS_AUDIO3D_ERROR_NOT_SUPPORTED;
     }
 
-    if (!port.current_buffer.has_value()) {
+    if (port.queue.empty()) {
         // Nothing to push.
         LOG_DEBUG(Lib_Audio3d, "Port push with no buffer ready");
         return ORBIS_OK;
     }
 
     // TODO: Implement asynchronous blocking mode.
-    const auto& [sample_buffer, num_samples] = port.current_buffer.value();
-    return AudioOut::sceAudioOutOutput(state->audio_out_handle, sample_buffer);
+    const auto grain = std::move(port.queue.front());
+    port.queue.pop_front();
+    return OutputGrain(grain);
 }
 
 s32 PS4_SYSV_ABI sceAudio3dPortQueryDebug() {
@@ -3,11 +3,14 @@
 
 #pragma once
 
+#include <deque>
 #include <optional>
-#include <queue>
+#include <unordered_map>
+#include <vector>
 
 #include "common/types.h"
 #include "core/libraries/audio/audioout.h"
+#include "core/libraries/audio3d/audio3d_mixer.h"
 
 namespace Core::Loader {
 class SymbolsResolver;
@@ -62,6 +65,18 @@ struct OrbisAudio3dPcm {
 
 enum class OrbisAudio3dAttributeId : u32 {
     ORBIS_AUDIO3D_ATTRIBUTE_PCM = 1,
+    ORBIS_AUDIO3D_ATTRIBUTE_PRIORITY = 2,
+    ORBIS_AUDIO3D_ATTRIBUTE_POSITION = 3,
+    ORBIS_AUDIO3D_ATTRIBUTE_SPREAD = 4,
+    ORBIS_AUDIO3D_ATTRIBUTE_GAIN = 5,
+    ORBIS_AUDIO3D_ATTRIBUTE_PASSTHROUGH = 6,
+    ORBIS_AUDIO3D_ATTRIBUTE_RESET_STATE = 7,
+};
+
+struct OrbisAudio3dPosition {
+    float x;
+    float y;
+    float z;
 };
 
 using OrbisAudio3dPortId = u32;
@@ -74,20 +89,23 @@ struct OrbisAudio3dAttribute {
     u64 value_size;
 };
 
-struct AudioData {
-    u8* sample_buffer;
-    u32 num_samples;
-};
-
 struct Port {
     OrbisAudio3dOpenParameters parameters{};
-    std::deque<AudioData> queue; // Only stores PCM buffers for now
-    std::optional<AudioData> current_buffer{};
+    std::optional<Audio3dMixer> mixer;
+    std::unordered_map<OrbisAudio3dObjectId, Audio3dObject> objects;
+    OrbisAudio3dObjectId last_object_id{};
+    /// Mixed grains waiting to be pushed, interleaved in the output layout.
+    std::deque<std::vector<float>> queue;
 };
 
 struct Audio3dState {
     std::unordered_map<OrbisAudio3dPortId, Port> ports;
     s32 audio_out_handle;
+    /// Renders to stereo for headphones instead of the 7.1 speaker layout.
+    bool binaural;
+    /// Pushed samples not yet making up a whole AudioOut buffer.
+    std::vector<float> pending_output;
+    std::vector<float> convert_buffer;
 };
 
 s32 PS4_SYSV_ABI sceAudio3dAudioOutClose(s32 handle);
@@ -113,7 +131,8 @@ s32 PS4_SYSV_ABI sceAudio3dObjectReserve(OrbisAudio3dPortId port_id,
 s32 PS4_SYSV_ABI sceAudio3dObjectSetAttributes(OrbisAudio3dPortId port_id,
                                                OrbisAudio3dObjectId object_id, u64 num_attributes,
                                                const OrbisAudio3dAttribute* attribute_array);
-s32 PS4_SYSV_ABI sceAudio3dObjectUnreserve();
+s32 PS4_SYSV_ABI sceAudio3dObjectUnreserve(OrbisAudio3dPortId port_id,
+                                           OrbisAudio3dObjectId object_id);
 s32 PS4_SYSV_ABI sceAudio3dPortAdvance(OrbisAudio3dPortId port_id);
 s32 PS4_SYSV_ABI sceAudio3dPortClose();
 s32 PS4_SYSV_ABI sceAudio3dPortCreate();
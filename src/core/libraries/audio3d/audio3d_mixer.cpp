@@ -0,0 +1,227 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "common/assert.h"
+#include "core/libraries/audio3d/audio3d_mixer.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace Libraries::Audio3d {
+
+namespace {
+
+constexpr float SAMPLE_RATE = 48000.0f;
+/// Objects closer than this are not amplified.
+constexpr float REFERENCE_DISTANCE = 1.0f;
+constexpr float HEAD_RADIUS = 0.0875f;
+constexpr float SPEED_OF_SOUND = 343.0f;
+
+struct Speaker {
+    u32 channel;
+    float azimuth;
+};
+
+/// Main speakers clockwise from the front, azimuths are in degrees to the right of the listener.
+constexpr std::array<Speaker, 7> SpeakerRing = {{
+    {2, 0.0f},
+    {1, 30.0f},
+    {7, 90.0f},
+    {5, 150.0f},
+    {4, 210.0f},
+    {6, 270.0f},
+    {0, 330.0f},
+}};
+
+/// Bed downmix to stereo for binaural output, left and right gain of each speaker channel.
+constexpr std::array<std::array<float, 2>, NUM_SPEAKER_CHANNELS> StereoDownmix = {{
+    {1.0f, 0.0f},
+    {0.0f, 1.0f},
+    {std::numbers::sqrt2_v<float> / 2, std::numbers::sqrt2_v<float> / 2},
+    {0.5f, 0.5f},
+    {std::numbers::sqrt2_v<float> / 2, 0.0f},
+    {0.0f, std::numbers::sqrt2_v<float> / 2},
+    {std::numbers::sqrt2_v<float> / 2, 0.0f},
+    {0.0f, std::numbers::sqrt2_v<float> / 2},
+}};
+
+/// Adds src to dst, scaled by a gain ramping linearly from start_gain to end_gain.
+void MixRamped(float* dst, const float* src, float start_gain, float end_gain, u32 num_samples) {
+    const float step = (end_gain - start_gain) / static_cast<float>(num_samples);
+    u32 i = 0;
+#ifdef __AVX2__
+    __m256 gain = _mm256_add_ps(_mm256_set1_ps(start_gain),
+                                _mm256_mul_ps(_mm256_set1_ps(step),
+                                              _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7)));
+    const __m256 gain_step = _mm256_set1_ps(step * 8);
+    for (; i + 8 <= num_samples; i += 8) {
+        const __m256 mixed =
+            _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), gain));
+        _mm256_storeu_ps(dst + i, mixed);
+        gain = _mm256_add_ps(gain, gain_step);
+    }
+#endif
+    for (; i < num_samples; i++) {
+        dst[i] += src[i] * (start_gain + step * static_cast<float>(i));
+    }
+}
+
+/// Returns constant power gains panning between the two speakers around azimuth, spread blends
+/// them towards an even distribution over all speakers.
+std::array<float, NUM_SPEAKER_CHANNELS> PanToSpeakers(float azimuth, float spread) {
+    float degrees = azimuth * 180.0f / std::numbers::pi_v<float>;
+    if (degrees < 0.0f) {
+        degrees += 360.0f;
+    }
+    std::array<float, NUM_SPEAKER_CHANNELS> gains{};
+    for (size_t i = 0; i < SpeakerRing.size(); i++) {
+        const auto& first = SpeakerRing[i];
+        const auto& second = SpeakerRing[(i + 1) % SpeakerRing.size()];
+        const float end = i + 1 == SpeakerRing.size() ? 360.0f : second.azimuth;
+        if (degrees < first.azimuth || degrees > end) {
+            continue;
+        }
+        const float t = (degrees - first.azimuth) / (end - first.azimuth);
+        gains[first.channel] = std::cos(t * std::numbers::pi_v<float> / 2);
+        gains[second.channel] = std::sin(t * std::numbers::pi_v<float> / 2);
+        break;
+    }
+    if (spread > 0.0f) {
+        const float even = spread / static_cast<float>(SpeakerRing.size());
+        for (const auto& speaker : SpeakerRing) {
+            float& gain = gains[speaker.channel];
+            gain = std::sqrt((1.0f - spread) * gain * gain + even);
+        }
+    }
+    return gains;
+}
+
+} // Anonymous namespace
+
+Audio3dMixer::Audio3dMixer(u32 num_samples_, bool binaural_)
+    : num_samples{num_samples_}, binaural{binaural_} {
+    ASSERT(num_samples >= MAX_ITD_SAMPLES);
+    planes.resize(num_samples * NumChannels());
+    if (binaural) {
+        delayed.resize(MAX_ITD_SAMPLES + num_samples);
+        ear.resize(num_samples);
+    }
+}
+
+void Audio3dMixer::MixBed(std::span<const float> samples, u32 num_channels) {
+    const u32 num_frames = std::min<u32>(samples.size() / num_channels, num_samples);
+    for (u32 channel = 0; channel < num_channels; channel++) {
+        if (!binaural || num_channels == 2) {
+            float* dst = Plane(channel);
+            for (u32 i = 0; i < num_frames; i++) {
+                dst[i] += samples[i * num_channels + channel];
+            }
+            continue;
+        }
+        const auto [left_gain, right_gain] = StereoDownmix[channel];
+        float* left = Plane(0);
+        float* right = Plane(1);
+        for (u32 i = 0; i < num_frames; i++) {
+            const float sample = samples[i * num_channels + channel];
+            left[i] += sample * left_gain;
+            right[i] += sample * right_gain;
+        }
+    }
+}
+
+void Audio3dMixer::MixObject(Audio3dObject& object) {
+    if (!object.has_pcm) {
+        return;
+    }
+    object.has_pcm = false;
+
+    std::array<float, NUM_SPEAKER_CHANNELS> targets{};
+    if (object.passthrough != Audio3dPassthrough::None) {
+        // Passthrough objects bypass spatialization and go to a front speaker or an ear as is.
+        targets[object.passthrough == Audio3dPassthrough::Left ? 0 : 1] = object.gain;
+    } else {
+        const auto [x, y, z] = object.position;
+        const float distance = std::sqrt(x * x + y * y + z * z);
+        const float attenuation = object.gain / std::max(distance, REFERENCE_DISTANCE);
+        // Sources above, below or at the listener have no direction in the horizontal plane and
+        // are spread over all speakers.
+        const float elevation = distance > 0.0f ? std::abs(y) / distance : 1.0f;
+        const float spread = std::clamp(std::max(object.spread, elevation), 0.0f, 1.0f);
+        if (binaural) {
+            const float lateral = distance > 0.0f ? x / distance : 0.0f;
+            MixBinaural(object, lateral * (1.0f - spread), attenuation);
+            return;
+        }
+        targets = PanToSpeakers(std::atan2(x, z), spread);
+        for (float& target : targets) {
+            target *= attenuation;
+        }
+    }
+
+    for (u32 channel = 0; channel < NumChannels(); channel++) {
+        float& gain = object.speaker_gains[channel];
+        if (gain != 0.0f || targets[channel] != 0.0f) {
+            MixRamped(Plane(channel), object.pcm.data(), gain, targets[channel], num_samples);
+        }
+        gain = targets[channel];
+    }
+    object.ear_gains = {};
+}
+
+void Audio3dMixer::MixBinaural(Audio3dObject& object, float lateral, float attenuation) {
+    // Woodworth's formula for the interaural time difference of a spherical head.
+    const float angle = std::asin(std::clamp(std::abs(lateral), 0.0f, 1.0f));
+    const float itd = HEAD_RADIUS / SPEED_OF_SOUND * (angle + std::sin(angle));
+    const u32 delay = std::min<u32>(std::lround(itd * SAMPLE_RATE), MAX_ITD_SAMPLES);
+
+    // The far ear is shadowed by the head, it is quieter and low-pass filtered down to 2 kHz
+    // for sources at the side.
+    const float shadow = std::sin(angle);
+    const float cutoff = 20000.0f - 18000.0f * shadow;
+    const float level = attenuation * std::numbers::sqrt2_v<float> / 2;
+    const u32 near_ear = lateral >= 0.0f ? 1 : 0;
+    std::array<u32, 2> delays{};
+    std::array<float, 2> coefficients{1.0f, 1.0f};
+    std::array<float, 2> targets{};
+    delays[near_ear ^ 1] = delay;
+    coefficients[near_ear ^ 1] = 1.0f - std::exp(-2.0f * std::numbers::pi_v<float> * cutoff /
+                                                 SAMPLE_RATE);
+    targets[near_ear] = level * (1.0f + 0.3f * shadow);
+    targets[near_ear ^ 1] = level * (1.0f - 0.3f * shadow);
+
+    std::ranges::copy(object.history, delayed.begin());
+    std::ranges::copy(object.pcm, delayed.begin() + MAX_ITD_SAMPLES);
+    for (u32 side = 0; side < 2; side++) {
+        const float* src = delayed.data() + MAX_ITD_SAMPLES - delays[side];
+        const float coefficient = coefficients[side];
+        float state = object.ear_filters[side];
+        for (u32 i = 0; i < num_samples; i++) {
+            state += coefficient * (src[i] - state);
+            ear[i] = state;
+        }
+        object.ear_filters[side] = state;
+        MixRamped(Plane(side), ear.data(), object.ear_gains[side], targets[side], num_samples);
+    }
+    std::copy(delayed.end() - MAX_ITD_SAMPLES, delayed.end(), object.history.begin());
+    object.ear_gains = targets;
+    object.speaker_gains = {};
+}
+
+void Audio3dMixer::Resolve(std::span<float> out) {
+    const u32 num_channels = NumChannels();
+    ASSERT(out.size() >= num_samples * num_channels);
+    for (u32 channel = 0; channel < num_channels; channel++) {
+        const float* src = Plane(channel);
+        for (u32 i = 0; i < num_samples; i++) {
+            out[i * num_channels + channel] = src[i];
+        }
+    }
+    std::ranges::fill(planes, 0.0f);
+}
+
+} // namespace Libraries::Audio3d
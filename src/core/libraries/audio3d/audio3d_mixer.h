@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+
+#include "common/types.h"
+
+namespace Libraries::Audio3d {
+
+/// Channels of the speaker layout, ordered FL, FR, FC, LFE, BL, BR, SL, SR like the 8 channel
+/// AudioOut formats.
+constexpr u32 NUM_SPEAKER_CHANNELS = 8;
+
+/// Longest interaural delay of the binaural renderer, about 0.66 ms at 48 kHz.
+constexpr u32 MAX_ITD_SAMPLES = 32;
+
+enum class Audio3dPassthrough : u32 {
+    None = 0,
+    Left = 1,
+    Right = 2,
+};
+
+struct Audio3dObject {
+    /// Position relative to the listener, x points right, y up and z to the front.
+    std::array<float, 3> position{};
+    float gain{1.0f};
+    float spread{};
+    Audio3dPassthrough passthrough{};
+    /// Mono samples of the current grain.
+    std::vector<float> pcm;
+    bool has_pcm{};
+
+    /// Gains of the last grain, new gains are ramped from them to avoid zipper noise.
+    std::array<float, NUM_SPEAKER_CHANNELS> speaker_gains{};
+    std::array<float, 2> ear_gains{};
+    /// Head shadow filter state and the tail of the last grain for the interaural delay.
+    std::array<float, 2> ear_filters{};
+    std::array<float, MAX_ITD_SAMPLES> history{};
+};
+
+/**
+ * Mixes the beds and objects of a port into grains of the output layout. Speaker output pans
+ * objects between the two nearest speakers of the 7.1 layout, binaural output renders them to
+ * stereo with interaural time and level differences of a spherical head. Both attenuate objects
+ * with the inverse of their distance.
+ */
+class Audio3dMixer {
+public:
+    explicit Audio3dMixer(u32 num_samples, bool binaural);
+
+    [[nodiscard]] u32 NumSamples() const {
+        return num_samples;
+    }
+
+    [[nodiscard]] u32 NumChannels() const {
+        return binaural ? 2 : NUM_SPEAKER_CHANNELS;
+    }
+
+    /// Adds interleaved bed samples of 2 or 8 channels to the grain.
+    void MixBed(std::span<const float> samples, u32 num_channels);
+
+    /// Adds the samples of an object to the grain at its position and consumes them.
+    void MixObject(Audio3dObject& object);
+
+    /// Writes the grain as interleaved samples and starts the next one.
+    void Resolve(std::span<float> out);
+
+private:
+    void MixBinaural(Audio3dObject& object, float lateral, float attenuation);
+
+    [[nodiscard]] float* Plane(u32 channel) {
+        return planes.data() + channel * num_samples;
+    }
+
+    u32 num_samples;
+    bool binaural;
+    std::vector<float> planes;
+    std::vector<float> delayed;
+    std::vector<float> ear;
+};
+
+} // namespace Libraries::Audio3d
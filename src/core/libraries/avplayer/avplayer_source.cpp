@@ -8,13 +8,17 @@
 #include "core/libraries/avplayer/avplayer_error.h"
 #include "core/libraries/avplayer/avplayer_file_streamer.h"
 #include "core/libraries/avplayer/avplayer_source.h"
+#include "core/libraries/videodec/videodec_hwaccel.h"
 
+#include <algorithm>
+#include <thread>
 #include <magic_enum/magic_enum.hpp>
 
 extern "C" {
 #include <libavcodec/avcodec.h>
 #include <libavformat/avformat.h>
 #include <libavformat/avio.h>
+#include <libavutil/imgutils.h>
 #include <libswresample/swresample.h>
 #include <libswscale/swscale.h>
 }
@@ -23,17 +27,22 @@ extern "C" {
 
 namespace Libraries::AvPlayer {
 
+// Demuxing pauses while both streams have this many packets queued.
+constexpr size_t NumPrefetchVideoPackets = 30;
+constexpr size_t NumPrefetchAudioPackets = 8;
+
 AvPlayerSource::AvPlayerSource(AvPlayerStateCallback& state, bool use_vdec2)
     : m_state(state), m_use_vdec2(use_vdec2) {}
 
 AvPlayerSource::~AvPlayerSource() {
     Stop();
+    ClearQueues();
 }
 
 bool AvPlayerSource::Init(const AvPlayerInitData& init_data, std::string_view path) {
     m_memory_replacement = init_data.memory_replacement;
     m_max_num_video_framebuffers =
-        std::min(std::max(2, init_data.num_output_video_framebuffers), 16);
+        std::clamp(init_data.num_output_video_framebuffers, 2, s32(MaxVideoFramebuffers));
 
     AVFormatContext* context = avformat_alloc_context();
     if (init_data.file_replacement.open != nullptr) {
@@ -214,6 +223,9 @@ bool AvPlayerSource::Start() {
                       m_video_stream_index.value());
             return false;
         }
+        // Frame threading delays output by a frame per thread, which the packet queue absorbs.
+        m_video_codec_context->thread_count = std::min(std::thread::hardware_concurrency(), 8U);
+        m_video_codec_context->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
         if (avcodec_open2(m_video_codec_context.get(), decoder, nullptr) < 0) {
             LOG_ERROR(Lib_AvPlayer, "Could not open avcodec for video stream {}.",
                       m_video_stream_index.value());
@@ -226,8 +238,11 @@ bool AvPlayerSource::Start() {
             height = Common::AlignUp(height, 16);
         }
         const auto size = (width * height * 3) / 2;
+        m_video_framebuffers.reserve(m_max_num_video_framebuffers);
         for (u64 index = 0; index < m_max_num_video_framebuffers; ++index) {
-            m_video_buffers.Push(GuestBuffer(m_memory_replacement, 0x100, size, true));
+            const auto& buffer =
+                m_video_framebuffers.emplace_back(m_memory_replacement, 0x100, size, true);
+            m_video_buffers.TryEmplace(buffer.GetBuffer());
         }
     }
     if (m_audio_stream_index) {
@@ -251,10 +266,12 @@ bool AvPlayerSource::Start() {
             return false;
         }
         const auto num_channels = m_audio_codec_context->ch_layout.nb_channels;
-        const auto align = num_channels * sizeof(u16);
         const auto size = num_channels * sizeof(u16) * 1024;
-        for (u64 index = 0; index < 8; ++index) {
-            m_audio_buffers.Push(GuestBuffer(m_memory_replacement, 0x100, size, false));
+        m_audio_framebuffers.reserve(NumAudioBuffers);
+        for (u64 index = 0; index < NumAudioBuffers; ++index) {
+            const auto& buffer =
+                m_audio_framebuffers.emplace_back(m_memory_replacement, 0x100, size, false);
+            m_audio_buffers.TryEmplace(buffer.GetBuffer());
         }
     }
     m_demuxer_thread.Run([this](std::stop_token stop) { this->DemuxerThread(stop); });
@@ -280,15 +297,7 @@ bool AvPlayerSource::Stop() {
     m_audio_decoder_thread.Stop();
     m_demuxer_thread.Stop();
 
-    m_current_audio_frame.reset();
-    m_current_video_frame.reset();
-
-    m_video_buffers.Clear();
-    m_audio_buffers.Clear();
-    m_audio_packets.Clear();
-    m_video_packets.Clear();
-    m_audio_frames.Clear();
-    m_video_frames.Clear();
+    ClearQueues();
 
     m_last_audio_ts.reset();
     m_start_time.reset();
@@ -297,6 +306,7 @@ bool AvPlayerSource::Stop() {
 
     m_is_paused = false;
     m_is_eof = false;
+    m_is_flushed = false;
 
     return true;
 }
@@ -327,20 +337,24 @@ bool AvPlayerSource::GetVideoData(AvPlayerFrameInfo& video_info) {
 
 bool AvPlayerSource::GetVideoData(AvPlayerFrameInfoEx& video_info) {
     if (m_current_video_frame.has_value()) {
-        m_video_buffers.Push(std::move(m_current_video_frame->buffer));
+        // The guest is done with the previous frame, its buffer can be decoded into again.
+        m_video_buffers.TryEmplace(m_current_video_frame->buffer);
         m_current_video_frame.reset();
-        m_video_buffers_cv.Notify();
     }
 
     if (!IsActive() || m_is_paused) {
         return false;
     }
 
-    if (m_video_frames.Size() == 0) {
-        return false;
+    if (!m_next_video_frame.has_value()) {
+        Frame frame;
+        if (!m_video_frames.TryPop(frame)) {
+            return false;
+        }
+        m_next_video_frame = frame;
     }
 
-    const auto& new_frame = m_video_frames.Front();
+    const auto& new_frame = m_next_video_frame.value();
     if (m_state.GetSyncMode() == AvPlayerAvSyncMode::Default) {
         if (m_audio_stream_index) {
             if (new_frame.info.timestamp > m_last_audio_ts.value_or(0)) {
@@ -355,38 +369,35 @@ bool AvPlayerSource::GetVideoData(AvPlayerFrameInfoEx& video_info) {
         }
     }
 
-    auto frame = m_video_frames.Pop();
-    video_info = frame->info;
-    m_current_video_frame = std::move(frame);
+    video_info = new_frame.info;
+    m_current_video_frame = std::exchange(m_next_video_frame, std::nullopt);
     return true;
 }
 
 bool AvPlayerSource::GetAudioData(AvPlayerFrameInfo& audio_info) {
     if (m_current_audio_frame.has_value()) {
         // return the buffer to the queue
-        m_audio_buffers.Push(std::move(m_current_audio_frame->buffer));
+        m_audio_buffers.TryEmplace(m_current_audio_frame->buffer);
         m_current_audio_frame.reset();
-        m_audio_buffers_cv.Notify();
     }
 
     if (!IsActive() || m_is_paused) {
         return false;
     }
 
-    if (m_audio_frames.Size() == 0) {
+    Frame frame;
+    if (!m_audio_frames.TryPop(frame)) {
         return false;
     }
-
-    auto frame = m_audio_frames.Pop();
-    m_last_audio_ts = frame->info.timestamp;
+    m_last_audio_ts = frame.info.timestamp;
 
     audio_info = {};
-    audio_info.timestamp = frame->info.timestamp;
-    audio_info.p_data = reinterpret_cast<u8*>(frame->info.p_data);
-    audio_info.details.audio.sample_rate = frame->info.details.audio.sample_rate;
-    audio_info.details.audio.size = frame->info.details.audio.size;
-    audio_info.details.audio.channel_count = frame->info.details.audio.channel_count;
-    m_current_audio_frame = std::move(frame);
+    audio_info.timestamp = frame.info.timestamp;
+    audio_info.p_data = reinterpret_cast<u8*>(frame.info.p_data);
+    audio_info.details.audio.sample_rate = frame.info.details.audio.sample_rate;
+    audio_info.details.audio.size = frame.info.details.audio.size;
+    audio_info.details.audio.channel_count = frame.info.details.audio.channel_count;
+    m_current_audio_frame = frame;
     return true;
 }
 
@@ -401,8 +412,8 @@ u64 AvPlayerSource::CurrentTime() {
 }
 
 bool AvPlayerSource::IsActive() {
-    return !m_is_eof || m_audio_packets.Size() != 0 || m_video_packets.Size() != 0 ||
-           m_video_frames.Size() != 0 || m_audio_frames.Size() != 0;
+    return !m_is_flushed || m_next_video_frame.has_value() || m_video_frames.Size() != 0 ||
+           m_audio_frames.Size() != 0;
 }
 
 void AvPlayerSource::ReleaseAVPacket(AVPacket* packet) {
@@ -451,10 +462,17 @@ void AvPlayerSource::DemuxerThread(std::stop_token stop) {
     }
     LOG_INFO(Lib_AvPlayer, "Demuxer Thread started");
 
+    const auto can_demux = [this] {
+        if (m_video_packets.Size() == MaxPackets || m_audio_packets.Size() == MaxPackets) {
+            return false;
+        }
+        return m_video_packets.Size() <= NumPrefetchVideoPackets ||
+               (m_audio_stream_index.has_value() &&
+                m_audio_packets.Size() <= NumPrefetchAudioPackets);
+    };
+
     while (!stop.stop_requested()) {
-        if (m_video_packets.Size() > 30 &&
-            (!m_audio_stream_index.has_value() || m_audio_packets.Size() > 8)) {
-            std::this_thread::sleep_for(milliseconds(5));
+        if (!m_demuxer_cv.Wait(stop, can_demux)) {
             continue;
         }
         AVPacketPtr up_packet(av_packet_alloc(), &ReleaseAVPacket);
@@ -490,10 +508,10 @@ void AvPlayerSource::DemuxerThread(std::stop_token stop) {
             break;
         }
         if (up_packet->stream_index == m_video_stream_index) {
-            m_video_packets.Push(std::move(up_packet));
+            m_video_packets.TryEmplace(up_packet.release());
             m_video_packets_cv.Notify();
         } else if (up_packet->stream_index == m_audio_stream_index) {
-            m_audio_packets.Push(std::move(up_packet));
+            m_audio_packets.TryEmplace(up_packet.release());
             m_audio_packets_cv.Notify();
         }
     }
@@ -502,78 +520,57 @@ void AvPlayerSource::DemuxerThread(std::stop_token stop) {
 
     m_video_packets_cv.Notify();
     m_audio_packets_cv.Notify();
-    m_video_frames_cv.Notify();
-    m_audio_frames_cv.Notify();
 
     m_video_decoder_thread.Join();
     m_audio_decoder_thread.Join();
+    m_is_flushed = true;
     m_state.OnEOF();
 
     LOG_INFO(Lib_AvPlayer, "Demuxer Thread exited normally");
 }
 
-AvPlayerSource::AVFramePtr AvPlayerSource::ConvertVideoFrame(const AVFrame& frame) {
-    auto nv12_frame = AVFramePtr{av_frame_alloc(), &ReleaseAVFrame};
-    nv12_frame->pts = frame.pts;
-    nv12_frame->pkt_dts = frame.pkt_dts < 0 ? 0 : frame.pkt_dts;
-    nv12_frame->format = AV_PIX_FMT_NV12;
-    nv12_frame->width = frame.width;
-    nv12_frame->height = frame.height;
-    nv12_frame->sample_aspect_ratio = frame.sample_aspect_ratio;
-    nv12_frame->crop_top = frame.crop_top;
-    nv12_frame->crop_bottom = frame.crop_bottom;
-    nv12_frame->crop_left = frame.crop_left;
-    nv12_frame->crop_right = frame.crop_right;
+bool AvPlayerSource::ConvertVideoFrame(const AVFrame& frame, u8* dst) {
+    auto width = u32(frame.width);
+    auto height = u32(frame.height);
+    if (!m_use_vdec2) {
+        width = Common::AlignUp(width, 16);
+        height = Common::AlignUp(height, 16);
+    }
+    if (Videodec::UploadToGpu(frame, dst, width, width * height)) {
+        return true;
+    }
 
-    av_frame_get_buffer(nv12_frame.get(), 0);
+    u8* const dst_data[4] = {dst, dst + width * height, nullptr, nullptr};
+    const int dst_linesize[4] = {int(width), int(width), 0, 0};
 
+    if (frame.format == AV_PIX_FMT_NV12) {
+        av_image_copy_plane(dst_data[0], dst_linesize[0], frame.data[0], frame.linesize[0],
+                            frame.width, frame.height);
+        av_image_copy_plane(dst_data[1], dst_linesize[1], frame.data[1], frame.linesize[1],
+                            frame.width, (frame.height + 1) / 2);
+        return true;
+    }
+
+    // Other formats are converted straight into the guest buffer.
+    m_sws_context.reset(sws_getCachedContext(m_sws_context.release(), frame.width, frame.height,
+                                             AVPixelFormat(frame.format), frame.width,
+                                             frame.height, AV_PIX_FMT_NV12, SWS_FAST_BILINEAR,
+                                             nullptr, nullptr, nullptr));
     if (m_sws_context == nullptr) {
-        m_sws_context =
-            SWSContextPtr(sws_getContext(frame.width, frame.height, AVPixelFormat(frame.format),
-                                         nv12_frame->width, nv12_frame->height, AV_PIX_FMT_NV12,
-                                         SWS_FAST_BILINEAR, nullptr, nullptr, nullptr),
-                          &ReleaseSWSContext);
+        LOG_ERROR(Lib_AvPlayer, "Could not create the NV12 conversion context");
+        return false;
     }
     const auto res = sws_scale(m_sws_context.get(), frame.data, frame.linesize, 0, frame.height,
-                               nv12_frame->data, nv12_frame->linesize);
+                               dst_data, dst_linesize);
     if (res < 0) {
         LOG_ERROR(Lib_AvPlayer, "Could not convert to NV12: {}", av_err2str(res));
-        return AVFramePtr{nullptr, &ReleaseAVFrame};
-    }
-    return nv12_frame;
-}
-
-static void CopyNV12Data(u8* dst, const AVFrame& src, bool use_vdec2) {
-    auto width = u32(src.width);
-    auto height = u32(src.height);
-    if (!use_vdec2) {
-        width = Common::AlignUp(width, 16);
-        height = Common::AlignUp(height, 16);
-    }
-
-    if (src.width == width) {
-        std::memcpy(dst, src.data[0], src.width * src.height);
-        std::memcpy(dst + src.width * height, src.data[1], (src.width * src.height) / 2);
-    } else {
-        const auto luma_dst = dst;
-        for (u32 y = 0; y < src.height; ++y) {
-            std::memcpy(luma_dst + y * width, src.data[0] + y * src.width, src.width);
-        }
-        const auto chroma_dst = dst + width * height;
-        for (u32 y = 0; y < src.height / 2; ++y) {
-            std::memcpy(chroma_dst + y * (width / 2), src.data[0] + y * (src.width / 2),
-                        src.width / 2);
-        }
+        return false;
     }
+    return true;
 }
 
-Frame AvPlayerSource::PrepareVideoFrame(GuestBuffer buffer, const AVFrame& frame) {
-    ASSERT(frame.format == AV_PIX_FMT_NV12);
-
-    auto p_buffer = buffer.GetBuffer();
-    CopyNV12Data(p_buffer, frame, m_use_vdec2);
-
-    const auto pkt_dts = u64(frame.pkt_dts) * 1000;
+Frame AvPlayerSource::PrepareVideoFrame(u8* buffer, const AVFrame& frame) {
+    const auto pkt_dts = u64(frame.pkt_dts < 0 ? 0 : frame.pkt_dts) * 1000;
     const auto stream = m_avformat_context->streams[m_video_stream_index.value()];
     const auto time_base = stream->time_base;
     const auto den = time_base.den;
@@ -588,10 +585,10 @@ Frame AvPlayerSource::PrepareVideoFrame(GuestBuffer buffer, const AVFrame& frame
     }
 
     return Frame{
-        .buffer = std::move(buffer),
+        .buffer = buffer,
         .info =
             {
-                .p_data = p_buffer,
+                .p_data = buffer,
                 .timestamp = timestamp,
                 .details =
                     {
@@ -605,7 +602,7 @@ Frame AvPlayerSource::PrepareVideoFrame(GuestBuffer buffer, const AVFrame& frame
                                 .crop_top_offset = u32(frame.crop_top),
                                 .crop_bottom_offset =
                                     u32(frame.crop_bottom + (height - frame.height)),
-                                .pitch = u32(frame.linesize[0]),
+                                .pitch = width,
                                 .luma_bit_depth = 8,
                                 .chroma_bit_depth = 8,
                             },
@@ -614,75 +611,94 @@ Frame AvPlayerSource::PrepareVideoFrame(GuestBuffer buffer, const AVFrame& frame
     };
 }
 
+bool AvPlayerSource::ReceiveVideoFrames(std::stop_token stop, AVFrame& frame, u8*& buffer) {
+    while (true) {
+        if (buffer == nullptr) {
+            // Decoding stalls here until the guest hands a frame back.
+            m_video_buffers.PopWait(buffer, stop);
+            if (stop.stop_requested()) {
+                return false;
+            }
+        }
+        const auto res = avcodec_receive_frame(m_video_codec_context.get(), &frame);
+        if (res == AVERROR(EAGAIN)) {
+            return true;
+        }
+        if (res == AVERROR_EOF) {
+            LOG_INFO(Lib_AvPlayer, "EOF reached in video decoder");
+            return false;
+        }
+        if (res < 0) {
+            LOG_ERROR(Lib_AvPlayer, "Could not receive frame from the video codec. Error = {}",
+                      av_err2str(res));
+            m_state.OnError();
+            return false;
+        }
+        const bool converted = ConvertVideoFrame(frame, buffer);
+        if (converted) {
+            m_video_frames.TryEmplace(PrepareVideoFrame(std::exchange(buffer, nullptr), frame));
+        }
+        av_frame_unref(&frame);
+        if (!converted) {
+            m_state.OnError();
+            return false;
+        }
+    }
+}
+
 void AvPlayerSource::VideoDecoderThread(std::stop_token stop) {
     using namespace std::chrono;
     Common::SetCurrentThreadName("shadPS4:AvVideoDecoder");
 
     LOG_INFO(Lib_AvPlayer, "Video Decoder Thread started");
+    const auto up_frame = AVFramePtr(av_frame_alloc(), &ReleaseAVFrame);
+    u8* buffer = nullptr;
     while ((!m_is_eof || m_video_packets.Size() != 0) && !stop.stop_requested()) {
         if (!m_video_packets_cv.Wait(stop,
                                      [this] { return m_video_packets.Size() != 0 || m_is_eof; })) {
             continue;
         }
-        const auto packet = m_video_packets.Pop();
-        if (!packet.has_value()) {
+        AVPacket* p_packet;
+        if (!m_video_packets.TryPop(p_packet)) {
             continue;
         }
+        m_demuxer_cv.Notify();
+        const AVPacketPtr packet(p_packet, &ReleaseAVPacket);
 
-        auto res = avcodec_send_packet(m_video_codec_context.get(), packet->get());
-        if (res < 0 && res != AVERROR(EAGAIN)) {
+        auto res = avcodec_send_packet(m_video_codec_context.get(), packet.get());
+        while (res == AVERROR(EAGAIN)) {
+            // The decoder is full, take frames out of it before sending the packet again.
+            if (!ReceiveVideoFrames(stop, *up_frame, buffer)) {
+                return;
+            }
+            res = avcodec_send_packet(m_video_codec_context.get(), packet.get());
+        }
+        if (res < 0) {
             m_state.OnError();
             LOG_ERROR(Lib_AvPlayer, "Could not send packet to the video codec. Error = {}",
                       av_err2str(res));
             return;
         }
-        while (res >= 0) {
-            if (!m_video_buffers_cv.Wait(stop, [this] { return m_video_buffers.Size() != 0; })) {
-                break;
-            }
-            if (m_video_buffers.Size() == 0) {
-                continue;
-            }
-            auto up_frame = AVFramePtr(av_frame_alloc(), &ReleaseAVFrame);
-            res = avcodec_receive_frame(m_video_codec_context.get(), up_frame.get());
-            if (res < 0) {
-                if (res == AVERROR_EOF) {
-                    LOG_INFO(Lib_AvPlayer, "EOF reached in video decoder");
-                    return;
-                } else if (res != AVERROR(EAGAIN)) {
-                    LOG_ERROR(Lib_AvPlayer,
-                              "Could not receive frame from the video codec. Error = {}",
-                              av_err2str(res));
-                    m_state.OnError();
-                    return;
-                }
-            } else {
-                auto buffer = m_video_buffers.Pop();
-                if (!buffer.has_value()) {
-                    // Video buffers queue was cleared. This means that player was stopped.
-                    break;
-                }
-                if (up_frame->format != AV_PIX_FMT_NV12) {
-                    const auto nv12_frame = ConvertVideoFrame(*up_frame);
-                    m_video_frames.Push(PrepareVideoFrame(std::move(buffer.value()), *nv12_frame));
-                } else {
-                    m_video_frames.Push(PrepareVideoFrame(std::move(buffer.value()), *up_frame));
-                }
-                m_video_frames_cv.Notify();
-            }
+        if (!ReceiveVideoFrames(stop, *up_frame, buffer)) {
+            return;
         }
     }
 
+    if (!stop.stop_requested() && m_video_codec_context != nullptr) {
+        // Drain the frames still held by the decoder threads.
+        avcodec_send_packet(m_video_codec_context.get(), nullptr);
+        ReceiveVideoFrames(stop, *up_frame, buffer);
+    }
+
     LOG_INFO(Lib_AvPlayer, "Video Decoder Thread exited normally");
 }
 
-AvPlayerSource::AVFramePtr AvPlayerSource::ConvertAudioFrame(const AVFrame& frame) {
-    auto pcm16_frame = AVFramePtr{av_frame_alloc(), &ReleaseAVFrame};
-    pcm16_frame->pts = frame.pts;
-    pcm16_frame->pkt_dts = frame.pkt_dts < 0 ? 0 : frame.pkt_dts;
-    pcm16_frame->format = AV_SAMPLE_FMT_S16;
-    pcm16_frame->ch_layout = frame.ch_layout;
-    pcm16_frame->sample_rate = frame.sample_rate;
+s32 AvPlayerSource::ConvertAudioFrame(const AVFrame& frame, u8* dst) {
+    const auto num_channels = frame.ch_layout.nb_channels;
+    if (frame.format == AV_SAMPLE_FMT_S16) {
+        std::memcpy(dst, frame.data[0], num_channels * frame.nb_samples * sizeof(u16));
+        return frame.nb_samples;
+    }
 
     if (m_swr_context == nullptr) {
         SwrContext* swr_context = nullptr;
@@ -694,23 +710,19 @@ AvPlayerSource::AVFramePtr AvPlayerSource::ConvertAudioFrame(const AVFrame& fram
         m_swr_context = SWRContextPtr(swr_context, &ReleaseSWRContext);
         swr_init(m_swr_context.get());
     }
-    const auto res = swr_convert_frame(m_swr_context.get(), pcm16_frame.get(), &frame);
+    // Sample rates match, so every input sample is converted right away into the guest buffer.
+    const auto res = swr_convert(m_swr_context.get(), &dst, 1024,
+                                 const_cast<const u8**>(frame.extended_data), frame.nb_samples);
     if (res < 0) {
-        LOG_ERROR(Lib_AvPlayer, "Could not convert to NV12: {}", av_err2str(res));
-        return AVFramePtr{nullptr, &ReleaseAVFrame};
+        LOG_ERROR(Lib_AvPlayer, "Could not convert to PCM16: {}", av_err2str(res));
     }
-    return pcm16_frame;
+    return res;
 }
 
-Frame AvPlayerSource::PrepareAudioFrame(GuestBuffer buffer, const AVFrame& frame) {
-    ASSERT(frame.format == AV_SAMPLE_FMT_S16);
-    ASSERT(frame.nb_samples <= 1024);
+Frame AvPlayerSource::PrepareAudioFrame(u8* buffer, const AVFrame& frame, u32 num_samples) {
+    const auto size = frame.ch_layout.nb_channels * num_samples * sizeof(u16);
 
-    auto p_buffer = buffer.GetBuffer();
-    const auto size = frame.ch_layout.nb_channels * frame.nb_samples * sizeof(u16);
-    std::memcpy(p_buffer, frame.data[0], size);
-
-    const auto pkt_dts = u64(frame.pkt_dts) * 1000;
+    const auto pkt_dts = u64(frame.pkt_dts < 0 ? 0 : frame.pkt_dts) * 1000;
     const auto stream = m_avformat_context->streams[m_audio_stream_index.value()];
     const auto time_base = stream->time_base;
     const auto den = time_base.den;
@@ -718,10 +730,10 @@ Frame AvPlayerSource::PrepareAudioFrame(GuestBuffer buffer, const AVFrame& frame
     const auto timestamp = (num != 0 && den > 1) ? (pkt_dts * num) / den : pkt_dts;
 
     return Frame{
-        .buffer = std::move(buffer),
+        .buffer = buffer,
         .info =
             {
-                .p_data = p_buffer,
+                .p_data = buffer,
                 .timestamp = timestamp,
                 .details =
                     {
@@ -736,65 +748,84 @@ Frame AvPlayerSource::PrepareAudioFrame(GuestBuffer buffer, const AVFrame& frame
     };
 }
 
+bool AvPlayerSource::ReceiveAudioFrames(std::stop_token stop, AVFrame& frame, u8*& buffer) {
+    while (true) {
+        if (buffer == nullptr) {
+            m_audio_buffers.PopWait(buffer, stop);
+            if (stop.stop_requested()) {
+                return false;
+            }
+        }
+        const auto res = avcodec_receive_frame(m_audio_codec_context.get(), &frame);
+        if (res == AVERROR(EAGAIN)) {
+            return true;
+        }
+        if (res == AVERROR_EOF) {
+            LOG_INFO(Lib_AvPlayer, "EOF reached in audio decoder");
+            return false;
+        }
+        if (res < 0) {
+            m_state.OnError();
+            LOG_ERROR(Lib_AvPlayer, "Could not receive frame from the audio codec. Error = {}",
+                      av_err2str(res));
+            return false;
+        }
+        ASSERT(frame.nb_samples <= 1024);
+        const auto num_samples = ConvertAudioFrame(frame, buffer);
+        if (num_samples > 0) {
+            m_audio_frames.TryEmplace(
+                PrepareAudioFrame(std::exchange(buffer, nullptr), frame, num_samples));
+        }
+        av_frame_unref(&frame);
+        if (num_samples < 0) {
+            m_state.OnError();
+            return false;
+        }
+    }
+}
+
 void AvPlayerSource::AudioDecoderThread(std::stop_token stop) {
     using namespace std::chrono;
     Common::SetCurrentThreadName("shadPS4:AvAudioDecoder");
 
     LOG_INFO(Lib_AvPlayer, "Audio Decoder Thread started");
+    const auto up_frame = AVFramePtr(av_frame_alloc(), &ReleaseAVFrame);
+    u8* buffer = nullptr;
     while ((!m_is_eof || m_audio_packets.Size() != 0) && !stop.stop_requested()) {
         if (!m_audio_packets_cv.Wait(stop,
                                      [this] { return m_audio_packets.Size() != 0 || m_is_eof; })) {
             continue;
         }
-        const auto packet = m_audio_packets.Pop();
-        if (!packet.has_value()) {
+        AVPacket* p_packet;
+        if (!m_audio_packets.TryPop(p_packet)) {
             continue;
         }
-        auto res = avcodec_send_packet(m_audio_codec_context.get(), packet->get());
-        if (res < 0 && res != AVERROR(EAGAIN)) {
+        m_demuxer_cv.Notify();
+        const AVPacketPtr packet(p_packet, &ReleaseAVPacket);
+
+        auto res = avcodec_send_packet(m_audio_codec_context.get(), packet.get());
+        while (res == AVERROR(EAGAIN)) {
+            if (!ReceiveAudioFrames(stop, *up_frame, buffer)) {
+                return;
+            }
+            res = avcodec_send_packet(m_audio_codec_context.get(), packet.get());
+        }
+        if (res < 0) {
             m_state.OnError();
             LOG_ERROR(Lib_AvPlayer, "Could not send packet to the audio codec. Error = {}",
                       av_err2str(res));
             return;
         }
-        while (res >= 0) {
-            if (!m_audio_buffers_cv.Wait(stop, [this] { return m_audio_buffers.Size() != 0; })) {
-                break;
-            }
-            if (m_audio_buffers.Size() == 0) {
-                continue;
-            }
-
-            auto up_frame = AVFramePtr(av_frame_alloc(), &ReleaseAVFrame);
-            res = avcodec_receive_frame(m_audio_codec_context.get(), up_frame.get());
-            if (res < 0) {
-                if (res == AVERROR_EOF) {
-                    LOG_INFO(Lib_AvPlayer, "EOF reached in audio decoder");
-                    return;
-                } else if (res != AVERROR(EAGAIN)) {
-                    m_state.OnError();
-                    LOG_ERROR(Lib_AvPlayer,
-                              "Could not receive frame from the audio codec. Error = {}",
-                              av_err2str(res));
-                    return;
-                }
-            } else {
-                auto buffer = m_audio_buffers.Pop();
-                if (!buffer.has_value()) {
-                    // Audio buffers queue was cleared. This means that player was stopped.
-                    break;
-                }
-                if (up_frame->format != AV_SAMPLE_FMT_S16) {
-                    const auto pcm16_frame = ConvertAudioFrame(*up_frame);
-                    m_audio_frames.Push(PrepareAudioFrame(std::move(buffer.value()), *pcm16_frame));
-                } else {
-                    m_audio_frames.Push(PrepareAudioFrame(std::move(buffer.value()), *up_frame));
-                }
-                m_audio_frames_cv.Notify();
-            }
+        if (!ReceiveAudioFrames(stop, *up_frame, buffer)) {
+            return;
         }
     }
 
+    if (!stop.stop_requested() && m_audio_codec_context != nullptr) {
+        avcodec_send_packet(m_audio_codec_context.get(), nullptr);
+        ReceiveAudioFrames(stop, *up_frame, buffer);
+    }
+
     LOG_INFO(Lib_AvPlayer, "Audio Decoder Thread exited normally");
 }
 
@@ -803,4 +834,32 @@ bool AvPlayerSource::HasRunningThreads() const {
            m_audio_decoder_thread.Joinable();
 }
 
+void AvPlayerSource::ClearQueues() {
+    // Only called once the pipeline threads have stopped.
+    AVPacket* packet;
+    while (m_video_packets.TryPop(packet)) {
+        ReleaseAVPacket(packet);
+    }
+    while (m_audio_packets.TryPop(packet)) {
+        ReleaseAVPacket(packet);
+    }
+    Frame frame;
+    while (m_video_frames.TryPop(frame)) {
+    }
+    while (m_audio_frames.TryPop(frame)) {
+    }
+    u8* buffer;
+    while (m_video_buffers.TryPop(buffer)) {
+    }
+    while (m_audio_buffers.TryPop(buffer)) {
+    }
+
+    m_next_video_frame.reset();
+    m_current_video_frame.reset();
+    m_current_audio_frame.reset();
+
+    m_video_framebuffers.clear();
+    m_audio_framebuffers.clear();
+}
+
 } // namespace Libraries::AvPlayer
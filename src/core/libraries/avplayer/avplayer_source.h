@@ -9,8 +9,10 @@
 #include <mutex>
 #include <optional>
 #include <string_view>
+#include <vector>
 
 #include "common/assert.h"
+#include "common/bounded_threadsafe_queue.h"
 #include "core/libraries/avplayer/avplayer.h"
 #include "core/libraries/avplayer/avplayer_common.h"
 #include "core/libraries/avplayer/avplayer_data_streamer.h"
@@ -102,9 +104,10 @@ private:
     bool m_is_texture = false;
 };
 
+/// Decoded frame, the data is stored in one of the preallocated guest buffers.
 struct Frame {
-    GuestBuffer buffer;
-    AvPlayerFrameInfoEx info;
+    u8* buffer{};
+    AvPlayerFrameInfoEx info{};
 };
 
 class EventCV {
@@ -160,6 +163,13 @@ public:
     bool IsActive();
 
 private:
+    static constexpr size_t MaxVideoFramebuffers = 16;
+    static constexpr size_t NumAudioBuffers = 8;
+    // Hard bound of the packet queues, demuxing normally pauses well before reaching it.
+    static constexpr size_t MaxPackets = 256;
+
+    using PacketQueue = Common::SPSCQueue<AVPacket*, MaxPackets>;
+
     static void ReleaseAVPacket(AVPacket* packet);
     static void ReleaseAVFrame(AVFrame* frame);
     static void ReleaseAVCodecContext(AVCodecContext* context);
@@ -178,13 +188,17 @@ private:
     void VideoDecoderThread(std::stop_token stop);
     void AudioDecoderThread(std::stop_token stop);
 
+    bool ReceiveVideoFrames(std::stop_token stop, AVFrame& frame, u8*& buffer);
+    bool ReceiveAudioFrames(std::stop_token stop, AVFrame& frame, u8*& buffer);
+
     bool HasRunningThreads() const;
+    void ClearQueues();
 
-    AVFramePtr ConvertAudioFrame(const AVFrame& frame);
-    AVFramePtr ConvertVideoFrame(const AVFrame& frame);
+    s32 ConvertAudioFrame(const AVFrame& frame, u8* dst);
+    bool ConvertVideoFrame(const AVFrame& frame, u8* dst);
 
-    Frame PrepareAudioFrame(GuestBuffer buffer, const AVFrame& frame);
-    Frame PrepareVideoFrame(GuestBuffer buffer, const AVFrame& frame);
+    Frame PrepareAudioFrame(u8* buffer, const AVFrame& frame, u32 num_samples);
+    Frame PrepareVideoFrame(u8* buffer, const AVFrame& frame);
 
     AvPlayerStateCallback& m_state;
     bool m_use_vdec2 = false;
@@ -195,31 +209,35 @@ private:
     std::atomic_bool m_is_looping = false;
     std::atomic_bool m_is_paused = false;
     std::atomic_bool m_is_eof = false;
+    // Set once the decoders have returned their last frames after the end of the file.
+    std::atomic_bool m_is_flushed = false;
 
     std::unique_ptr<IDataStreamer> m_up_data_streamer;
 
-    AvPlayerQueue<GuestBuffer> m_audio_buffers;
-    AvPlayerQueue<GuestBuffer> m_video_buffers;
+    // Frames are decoded straight into these and handed to the guest without further copies.
+    std::vector<GuestBuffer> m_audio_framebuffers;
+    std::vector<GuestBuffer> m_video_framebuffers;
 
-    AvPlayerQueue<AVPacketPtr> m_audio_packets;
-    AvPlayerQueue<AVPacketPtr> m_video_packets;
+    // Free buffers go back from the guest to the decoders, decoded frames the other way.
+    Common::SPSCQueue<u8*, NumAudioBuffers> m_audio_buffers;
+    Common::SPSCQueue<u8*, MaxVideoFramebuffers> m_video_buffers;
 
-    AvPlayerQueue<Frame> m_audio_frames;
-    AvPlayerQueue<Frame> m_video_frames;
+    PacketQueue m_audio_packets;
+    PacketQueue m_video_packets;
 
+    Common::SPSCQueue<Frame, NumAudioBuffers> m_audio_frames;
+    Common::SPSCQueue<Frame, MaxVideoFramebuffers> m_video_frames;
+
+    std::optional<Frame> m_next_video_frame;
     std::optional<Frame> m_current_video_frame;
     std::optional<Frame> m_current_audio_frame;
 
     std::optional<s32> m_video_stream_index{};
     std::optional<s32> m_audio_stream_index{};
 
+    EventCV m_demuxer_cv{};
     EventCV m_audio_packets_cv{};
-    EventCV m_audio_frames_cv{};
-    EventCV m_audio_buffers_cv{};
-
     EventCV m_video_packets_cv{};
-    EventCV m_video_frames_cv{};
-    EventCV m_video_buffers_cv{};
 
     std::mutex m_state_mutex{};
     Kernel::Thread m_demuxer_thread{};
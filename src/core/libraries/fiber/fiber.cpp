@@ -25,6 +25,9 @@ OrbisFiberContext* GetFiberContext() {
 
 extern "C" s32 PS4_SYSV_ABI _sceFiberSetJmp(OrbisFiberContext* ctx) asm("_sceFiberSetJmp");
 extern "C" s32 PS4_SYSV_ABI _sceFiberLongJmp(OrbisFiberContext* ctx) asm("_sceFiberLongJmp");
+extern "C" s32 PS4_SYSV_ABI _sceFiberSwitchContext(OrbisFiberContext* save,
+                                                   OrbisFiberContext* resume)
+    asm("_sceFiberSwitchContext");
 extern "C" void PS4_SYSV_ABI _sceFiberSwitchEntry(OrbisFiberData* data,
                                                   bool set_fpu) asm("_sceFiberSwitchEntry");
 extern "C" void PS4_SYSV_ABI _sceFiberForceQuit(u64 ret) asm("_sceFiberForceQuit");
@@ -370,8 +373,16 @@ s32 PS4_SYSV_ABI sceFiberSwitchImpl(OrbisFiber* fiber, void* addr_context, u64 s
     }
 
     OrbisFiberContext ctx{};
-    s32 jmp = _sceFiberSetJmp(&ctx);
-    if (!jmp) {
+    if (fiber->context) {
+        // Switches between suspended fibers are saved and resumed in one step, this is what job
+        // systems do thousands of times per frame.
+        cur_fiber->context = &ctx;
+        _sceFiberCheckStackOverflow(g_ctx);
+        g_ctx->prev_fiber = cur_fiber;
+        g_ctx->current_fiber = fiber;
+        g_ctx->arg_on_run_to = arg_on_run_to;
+        _sceFiberSwitchContext(&ctx, fiber->context);
+    } else if (!_sceFiberSetJmp(&ctx)) {
         cur_fiber->context = &ctx;
         _sceFiberCheckStackOverflow(g_ctx);
         _sceFiberSwitch(cur_fiber, fiber, arg_on_run_to, g_ctx);
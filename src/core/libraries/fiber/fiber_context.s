@@ -1,22 +1,16 @@
 # SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 # SPDX-License-Identifier: GPL-2.0-or-later
 
+# Contexts are only saved by calls, so only the callee-saved registers have to be kept.
 .global _sceFiberSetJmp
 _sceFiberSetJmp:
-    movq %rax, 0x0(%rdi)
-
     movq (%rsp), %rdx
     movq %rdx, 0x10(%rdi)
 
-    movq %rcx, 0x08(%rdi)
     movq %rbx, 0x18(%rdi)
     movq %rsp, 0x20(%rdi)
     movq %rbp, 0x28(%rdi)
 
-    movq %r8,  0x30(%rdi)
-    movq %r9,  0x38(%rdi)
-    movq %r10, 0x40(%rdi)
-    movq %r11, 0x48(%rdi)
     movq %r12, 0x50(%rdi)
     movq %r13, 0x58(%rdi)
     movq %r14, 0x60(%rdi)
@@ -40,17 +34,11 @@ _sceFiberLongJmp:
     movl %ecx, -0x4(%rsp)
     ldmxcsr -0x4(%rsp)
 
-    movq 0x00(%rdi), %rax
-    movq 0x08(%rdi), %rcx
     movq 0x10(%rdi), %rdx
     movq 0x18(%rdi), %rbx
     movq 0x20(%rdi), %rsp
     movq 0x28(%rdi), %rbp
 
-    movq 0x30(%rdi), %r8
-    movq 0x38(%rdi), %r9
-    movq 0x40(%rdi), %r10
-    movq 0x48(%rdi), %r11
     movq 0x50(%rdi), %r12
     movq 0x58(%rdi), %r13
     movq 0x60(%rdi), %r14
@@ -63,6 +51,28 @@ _sceFiberLongJmp:
     movl $0x1, %eax
     ret
 
+# Saves the caller into the first context like _sceFiberSetJmp and resumes the second one, the
+# call returns 1 once the first context is resumed.
+.global _sceFiberSwitchContext
+_sceFiberSwitchContext:
+    movq (%rsp), %rdx
+    movq %rdx, 0x10(%rdi)
+
+    movq %rbx, 0x18(%rdi)
+    movq %rsp, 0x20(%rdi)
+    movq %rbp, 0x28(%rdi)
+
+    movq %r12, 0x50(%rdi)
+    movq %r13, 0x58(%rdi)
+    movq %r14, 0x60(%rdi)
+    movq %r15, 0x68(%rdi)
+
+    fnstcw  0x70(%rdi)
+    stmxcsr 0x72(%rdi)
+
+    movq %rsi, %rdi
+    jmp _sceFiberLongJmp
+
 .global _sceFiberSwitchEntry
 _sceFiberSwitchEntry:
     mov %rdi, %r11
@@ -85,7 +85,14 @@ static void ResetSubmissionLock(Platform::InterruptId irq) {
 static void WaitGpuIdle() {
     HLE_TRACE;
     std::unique_lock lock{m_submission};
+    if (submission_lock == 0) {
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
     cv_lock.wait(lock, [] { return submission_lock == 0; });
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    DebugState.AddStall(DebugStateType::StallCause::GpuIdleWait,
+                        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
 }
 
 // Write a special ending NOP packet with N DWs data block
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+
+#include "core/libraries/hle_profiler.h"
+
+namespace Libraries::HleProfiler {
+
+/// Exports register themselves on their first call, the list is only ever prepended to.
+static constinit std::atomic<CallStats*> g_first_stats{};
+
+CallStats::CallStats(const char* name_) : name{name_} {
+    next = g_first_stats.load(std::memory_order_relaxed);
+    while (!g_first_stats.compare_exchange_weak(next, this, std::memory_order_release,
+                                                std::memory_order_relaxed)) {
+    }
+}
+
+void CallScope::Record() {
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const u64 ns = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+    stats.sampled_calls.fetch_add(1, std::memory_order_relaxed);
+    stats.sampled_ns.fetch_add(ns, std::memory_order_relaxed);
+    u64 max_ns = stats.max_ns.load(std::memory_order_relaxed);
+    while (ns > max_ns &&
+           !stats.max_ns.compare_exchange_weak(max_ns, ns, std::memory_order_relaxed)) {
+    }
+}
+
+std::vector<CallSummary> GetTopCalls(size_t count) {
+    std::vector<CallSummary> summaries;
+    for (auto* stats = g_first_stats.load(std::memory_order_acquire); stats;
+         stats = stats->next) {
+        const u64 sampled = stats->sampled_calls.load(std::memory_order_relaxed);
+        const u64 sampled_ns = stats->sampled_ns.load(std::memory_order_relaxed);
+        summaries.push_back({
+            .name = stats->name,
+            .calls = stats->calls.load(std::memory_order_relaxed),
+            .average_us = sampled != 0 ? static_cast<double>(sampled_ns) / sampled / 1000.0 : 0.0,
+            .max_us = static_cast<double>(stats->max_ns.load(std::memory_order_relaxed)) / 1000.0,
+        });
+    }
+    std::ranges::sort(summaries, std::ranges::greater{}, &CallSummary::calls);
+    if (summaries.size() > count) {
+        summaries.resize(count);
+    }
+    return summaries;
+}
+
+} // namespace Libraries::HleProfiler
@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "common/types.h"
+
+/**
+ * Counts the calls of every HLE export and samples their latency. The counting wrapper is only
+ * compiled into LIB_FUNCTION with ENABLE_HLE_PROFILER, as it adds an atomic increment to every
+ * call.
+ */
+namespace Libraries::HleProfiler {
+
+/// Every Nth call of an export is timed.
+constexpr u64 SampleInterval = 64;
+
+struct CallStats {
+    explicit CallStats(const char* name);
+
+    const char* name;
+    std::atomic<u64> calls{};
+    std::atomic<u64> sampled_calls{};
+    std::atomic<u64> sampled_ns{};
+    std::atomic<u64> max_ns{};
+    CallStats* next{};
+};
+
+class CallScope {
+public:
+    explicit CallScope(CallStats& stats_)
+        : stats{stats_},
+          sampled{stats.calls.fetch_add(1, std::memory_order_relaxed) % SampleInterval == 0} {
+        if (sampled) {
+            start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~CallScope() {
+        if (sampled) {
+            Record();
+        }
+    }
+
+    CallScope(const CallScope&) = delete;
+    CallScope& operator=(const CallScope&) = delete;
+
+private:
+    void Record();
+
+    CallStats& stats;
+    bool sampled;
+    std::chrono::steady_clock::time_point start{};
+};
+
+struct CallSummary {
+    std::string name;
+    u64 calls;
+    double average_us;
+    double max_us;
+};
+
+[[nodiscard]] constexpr bool IsEnabled() {
+#ifdef ENABLE_HLE_PROFILER
+    return true;
+#else
+    return false;
+#endif
+}
+
+/// Returns the most called exports, most calls first.
+[[nodiscard]] std::vector<CallSummary> GetTopCalls(size_t count);
+
+} // namespace Libraries::HleProfiler
@@ -1,12 +1,18 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-#include <thread>
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <memory>
+#include <ranges>
 
 #include "aio.h"
 #include "common/assert.h"
 #include "common/debug.h"
 #include "common/logging/log.h"
+#include "common/thread_worker.h"
+#include "core/debug_state.h"
 #include "core/libraries/kernel/equeue.h"
 #include "core/libraries/kernel/orbis_error.h"
 #include "core/libraries/libs.h"
@@ -16,20 +22,134 @@ namespace Libraries::Kernel {
 
 #define MAX_QUEUE 512
 
-static s32* id_state;
+// Requests of different files are serviced concurrently, those of the same file serialize on
+// the file mutex anyway.
+static constexpr size_t NumAioWorkers = 4;
+
+struct AioSubmission {
+    s32 state{};
+    u32 pending{};
+    u32 running{};
+    bool cancelled{};
+    bool failed{};
+};
+
+static std::mutex aio_mutex;
+static std::condition_variable aio_cv;
+static std::array<AioSubmission, MAX_QUEUE> submissions;
 static s32 id_index;
+static std::unique_ptr<Common::ThreadWorker> aio_worker;
 
-s32 PS4_SYSV_ABI sceKernelAioInitializeImpl(void* p, s32 size) {
+static bool IsInFlight(s32 state) {
+    return state == ORBIS_KERNEL_AIO_STATE_SUBMITTED || state == ORBIS_KERNEL_AIO_STATE_PROCESSING;
+}
 
-    return 0;
+static bool IsValidId(OrbisKernelAioSubmitId id) {
+    return id > 0 && id < MAX_QUEUE;
 }
 
-s32 PS4_SYSV_ABI sceKernelAioDeleteRequest(OrbisKernelAioSubmitId id, s32* ret) {
-    if (ret == nullptr) {
+static OrbisKernelAioSubmitId AllocateId(std::unique_lock<std::mutex>& lk, u32 num_requests) {
+    // Never recycle an id whose requests are still referenced by the workers.
+    aio_cv.wait(lk, [] {
+        return std::ranges::any_of(submissions, [](const auto& sub) { return sub.pending == 0; });
+    });
+    while (submissions[id_index].pending != 0) {
+        id_index = std::max((id_index + 1) % MAX_QUEUE, 1);
+    }
+    const OrbisKernelAioSubmitId id = id_index;
+    // skip id_index equals 0, because sceKernelAioCancelRequest will submit id equal to 0
+    id_index = std::max((id_index + 1) % MAX_QUEUE, 1);
+    submissions[id] = AioSubmission{
+        .state = ORBIS_KERNEL_AIO_STATE_SUBMITTED,
+        .pending = num_requests,
+    };
+    return id;
+}
+
+static void ExecuteRequest(OrbisKernelAioSubmitId id, OrbisKernelAioRWRequest req,
+                           bool is_write) {
+    auto& sub = submissions[id];
+    bool skip;
+    {
+        std::scoped_lock lk{aio_mutex};
+        skip = sub.cancelled;
+        if (!skip) {
+            sub.state = ORBIS_KERNEL_AIO_STATE_PROCESSING;
+            ++sub.running;
+        }
+    }
+
+    s64 ret = 0;
+    if (skip) {
+        req.result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
+    } else {
+        ret = is_write ? sceKernelPwrite(req.fd, req.buf, req.nbyte, req.offset)
+                       : sceKernelPread(req.fd, req.buf, req.nbyte, req.offset);
+        req.result->returnValue = ret;
+        req.result->state =
+            ret < 0 ? ORBIS_KERNEL_AIO_STATE_ABORTED : ORBIS_KERNEL_AIO_STATE_COMPLETED;
+    }
+
+    {
+        std::scoped_lock lk{aio_mutex};
+        if (!skip) {
+            --sub.running;
+            sub.failed |= ret < 0;
+        }
+        if (--sub.pending == 0 && IsInFlight(sub.state)) {
+            sub.state = sub.cancelled || sub.failed ? ORBIS_KERNEL_AIO_STATE_ABORTED
+                                                    : ORBIS_KERNEL_AIO_STATE_COMPLETED;
+        } else if (sub.cancelled && sub.running == 0) {
+            sub.state = ORBIS_KERNEL_AIO_STATE_ABORTED;
+        }
+    }
+    aio_cv.notify_all();
+}
+
+static s32 SubmitCommands(OrbisKernelAioRWRequest req[], s32 size, OrbisKernelAioSubmitId id[],
+                          bool is_write, bool is_multiple) {
+    if (req == nullptr || id == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    id_state[id] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-    *ret = 0;
+    if (size <= 0 || (is_multiple && size >= MAX_QUEUE)) {
+        return ORBIS_KERNEL_ERROR_EINVAL;
+    }
+    for (s32 i = 0; i < size; i++) {
+        req[i].result->state = ORBIS_KERNEL_AIO_STATE_SUBMITTED;
+    }
+
+    // Allocate every id before queueing so a fast worker can't observe a half built batch.
+    std::array<OrbisKernelAioSubmitId, MAX_QUEUE> ids;
+    const s32 num_ids = is_multiple ? size : 1;
+    {
+        std::unique_lock lk{aio_mutex};
+        for (s32 i = 0; i < num_ids; i++) {
+            ids[i] = AllocateId(lk, is_multiple ? 1 : size);
+        }
+    }
+    for (s32 i = 0; i < size; i++) {
+        const auto req_id = ids[is_multiple ? i : 0];
+        aio_worker->QueueWork(
+            [req_id, request = req[i], is_write] { ExecuteRequest(req_id, request, is_write); });
+    }
+    for (s32 i = 0; i < num_ids; i++) {
+        id[i] = ids[i];
+    }
+    return ORBIS_OK;
+}
+
+/// Waits until the predicate holds, a zero or missing timeout waits forever.
+template <typename Pred>
+static bool WaitFor(std::unique_lock<std::mutex>& lk, const u32* usec, Pred&& pred) {
+    if (usec == nullptr || *usec == 0) {
+        aio_cv.wait(lk, pred);
+        return true;
+    }
+    return aio_cv.wait_for(lk, std::chrono::microseconds(*usec), pred);
+}
+
+s32 PS4_SYSV_ABI sceKernelAioInitializeImpl(void* p, s32 size) {
+
     return 0;
 }
 
@@ -37,86 +157,76 @@ s32 PS4_SYSV_ABI sceKernelAioDeleteRequests(OrbisKernelAioSubmitId id[], s32 num
     if (ret == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
+    std::scoped_lock lk{aio_mutex};
     for (s32 i = 0; i < num; i++) {
-        id_state[id[i]] = ORBIS_KERNEL_AIO_STATE_ABORTED;
+        if (IsValidId(id[i])) {
+            auto& sub = submissions[id[i]];
+            sub.cancelled = true;
+            if (sub.running == 0) {
+                sub.state = ORBIS_KERNEL_AIO_STATE_ABORTED;
+            }
+        }
         ret[i] = 0;
     }
-
+    aio_cv.notify_all();
     return 0;
 }
-s32 PS4_SYSV_ABI sceKernelAioPollRequest(OrbisKernelAioSubmitId id, s32* state) {
-    if (state == nullptr) {
+
+s32 PS4_SYSV_ABI sceKernelAioDeleteRequest(OrbisKernelAioSubmitId id, s32* ret) {
+    if (ret == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    *state = id_state[id];
-    return 0;
+    return sceKernelAioDeleteRequests(&id, 1, ret);
 }
 
 s32 PS4_SYSV_ABI sceKernelAioPollRequests(OrbisKernelAioSubmitId id[], s32 num, s32 state[]) {
     if (state == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
+    std::scoped_lock lk{aio_mutex};
     for (s32 i = 0; i < num; i++) {
-        state[i] = id_state[id[i]];
+        state[i] = IsValidId(id[i]) ? submissions[id[i]].state : 0;
     }
-
     return 0;
 }
 
-s32 PS4_SYSV_ABI sceKernelAioCancelRequest(OrbisKernelAioSubmitId id, s32* state) {
+s32 PS4_SYSV_ABI sceKernelAioPollRequest(OrbisKernelAioSubmitId id, s32* state) {
     if (state == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    if (id) {
-        id_state[id] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-        *state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-    } else {
-        *state = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-    }
-    return 0;
+    return sceKernelAioPollRequests(&id, 1, state);
 }
 
 s32 PS4_SYSV_ABI sceKernelAioCancelRequests(OrbisKernelAioSubmitId id[], s32 num, s32 state[]) {
     if (state == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
+    std::scoped_lock lk{aio_mutex};
     for (s32 i = 0; i < num; i++) {
-        if (id[i]) {
-            id_state[id[i]] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            state[i] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-        } else {
+        if (!IsValidId(id[i])) {
             state[i] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
+            continue;
+        }
+        // Requests already handed to the host can't be interrupted, the submission turns
+        // aborted once they are done and the remaining ones are skipped.
+        auto& sub = submissions[id[i]];
+        if (IsInFlight(sub.state)) {
+            sub.cancelled = true;
+            if (sub.running == 0) {
+                sub.state = ORBIS_KERNEL_AIO_STATE_ABORTED;
+            }
         }
+        state[i] = sub.state;
     }
-
+    aio_cv.notify_all();
     return 0;
 }
 
-s32 PS4_SYSV_ABI sceKernelAioWaitRequest(OrbisKernelAioSubmitId id, s32* state, u32* usec) {
+s32 PS4_SYSV_ABI sceKernelAioCancelRequest(OrbisKernelAioSubmitId id, s32* state) {
     if (state == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    u32 timer = 0;
-
-    s32 timeout = 0;
-
-    while (id_state[id] == ORBIS_KERNEL_AIO_STATE_PROCESSING) {
-        sceKernelUsleep(10);
-
-        timer += 10;
-        if (*usec) {
-            if (timer > *usec) {
-                timeout = 1;
-                break;
-            }
-        }
-    }
-
-    *state = id_state[id];
-
-    if (timeout)
-        return ORBIS_KERNEL_ERROR_ETIMEDOUT;
-    return 0;
+    return sceKernelAioCancelRequests(&id, 1, state);
 }
 
 s32 PS4_SYSV_ABI sceKernelAioWaitRequests(OrbisKernelAioSubmitId id[], s32 num, s32 state[],
@@ -124,182 +234,55 @@ s32 PS4_SYSV_ABI sceKernelAioWaitRequests(OrbisKernelAioSubmitId id[], s32 num,
     if (state == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    u32 timer = 0;
-    s32 timeout = 0;
-    s32 completion = 0;
-
+    const auto is_done = [id](s32 i) {
+        return !IsValidId(id[i]) || !IsInFlight(submissions[id[i]].state);
+    };
+    const auto indices = std::views::iota(0, num);
+
+    const auto start = std::chrono::steady_clock::now();
+    std::unique_lock lk{aio_mutex};
+    const bool completed = WaitFor(lk, usec, [&] {
+        return mode == ORBIS_KERNEL_AIO_WAIT_OR ? std::ranges::any_of(indices, is_done)
+                                                : std::ranges::all_of(indices, is_done);
+    });
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    DebugState.AddStall(DebugStateType::StallCause::AioWait,
+                        std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
     for (s32 i = 0; i < num; i++) {
-        if (!completion && !timeout) {
-            while (id_state[id[i]] == ORBIS_KERNEL_AIO_STATE_PROCESSING) {
-                sceKernelUsleep(10);
-                timer += 10;
-
-                if (*usec) {
-                    if (timer > *usec) {
-                        timeout = 1;
-                        break;
-                    }
-                }
-            }
-        }
-
-        if (mode == 0x02) {
-            if (id_state[id[i]] == ORBIS_KERNEL_AIO_STATE_COMPLETED)
-                completion = 1;
-        }
-
-        state[i] = id_state[id[i]];
+        state[i] = IsValidId(id[i]) ? submissions[id[i]].state : 0;
     }
 
-    if (timeout)
+    if (!completed)
         return ORBIS_KERNEL_ERROR_ETIMEDOUT;
 
     return 0;
 }
 
-s32 PS4_SYSV_ABI sceKernelAioSubmitReadCommands(OrbisKernelAioRWRequest req[], s32 size, s32 prio,
-                                                OrbisKernelAioSubmitId* id) {
-    if (req == nullptr) {
-        return ORBIS_KERNEL_ERROR_EFAULT;
-    }
-    if (id == nullptr) {
+s32 PS4_SYSV_ABI sceKernelAioWaitRequest(OrbisKernelAioSubmitId id, s32* state, u32* usec) {
+    if (state == nullptr) {
         return ORBIS_KERNEL_ERROR_EFAULT;
     }
-    id_state[id_index] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-
-    for (s32 i = 0; i < size; i++) {
-
-        s64 ret = sceKernelPread(req[i].fd, req[i].buf, req[i].nbyte, req[i].offset);
-
-        if (ret < 0) {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            req[i].result->returnValue = ret;
-
-        } else {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-            req[i].result->returnValue = ret;
-        }
-    }
-
-    id_state[id_index] = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-
-    *id = id_index;
-
-    id_index = (id_index + 1) % MAX_QUEUE;
-
-    if (!id_index)
-        id_index++;
+    return sceKernelAioWaitRequests(&id, 1, state, ORBIS_KERNEL_AIO_WAIT_AND, usec);
+}
 
-    return 0;
+s32 PS4_SYSV_ABI sceKernelAioSubmitReadCommands(OrbisKernelAioRWRequest req[], s32 size, s32 prio,
+                                                OrbisKernelAioSubmitId* id) {
+    return SubmitCommands(req, size, id, false, false);
 }
 
 s32 PS4_SYSV_ABI sceKernelAioSubmitReadCommandsMultiple(OrbisKernelAioRWRequest req[], s32 size,
                                                         s32 prio, OrbisKernelAioSubmitId id[]) {
-    if (req == nullptr) {
-        return ORBIS_KERNEL_ERROR_EFAULT;
-    }
-    if (id == nullptr) {
-        return ORBIS_KERNEL_ERROR_EFAULT;
-    }
-    for (s32 i = 0; i < size; i++) {
-        id_state[id_index] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-
-        s64 ret = sceKernelPread(req[i].fd, req[i].buf, req[i].nbyte, req[i].offset);
-
-        if (ret < 0) {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-
-        } else {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-        }
-
-        id[i] = id_index;
-
-        id_index = (id_index + 1) % MAX_QUEUE;
-
-        if (!id_index)
-            id_index++;
-    }
-
-    return 0;
+    return SubmitCommands(req, size, id, false, true);
 }
 
 s32 PS4_SYSV_ABI sceKernelAioSubmitWriteCommands(OrbisKernelAioRWRequest req[], s32 size, s32 prio,
                                                  OrbisKernelAioSubmitId* id) {
-    if (req == nullptr) {
-        return ORBIS_KERNEL_ERROR_EFAULT;
-    }
-    if (id == nullptr) {
-        return ORBIS_KERNEL_ERROR_EFAULT;
-    }
-    for (s32 i = 0; i < size; i++) {
-        id_state[id_index] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-
-        s64 ret = sceKernelPwrite(req[i].fd, req[i].buf, req[i].nbyte, req[i].offset);
-
-        if (ret < 0) {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-
-        } else {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-        }
-    }
-
-    *id = id_index;
-
-    id_index = (id_index + 1) % MAX_QUEUE;
-
-    // skip id_index equals 0 , because sceKernelAioCancelRequest will submit id
-    // equal to 0
-    if (!id_index)
-        id_index++;
-
-    return 0;
+    return SubmitCommands(req, size, id, true, false);
 }
 
 s32 PS4_SYSV_ABI sceKernelAioSubmitWriteCommandsMultiple(OrbisKernelAioRWRequest req[], s32 size,
                                                          s32 prio, OrbisKernelAioSubmitId id[]) {
-    if (req == nullptr) {
-        return ORBIS_KERNEL_ERROR_EFAULT;
-    }
-    if (id == nullptr) {
-        return ORBIS_KERNEL_ERROR_EFAULT;
-    }
-    for (s32 i = 0; i < size; i++) {
-        id_state[id_index] = ORBIS_KERNEL_AIO_STATE_PROCESSING;
-        s64 ret = sceKernelPwrite(req[i].fd, req[i].buf, req[i].nbyte, req[i].offset);
-
-        if (ret < 0) {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_ABORTED;
-            req[i].result->returnValue = ret;
-
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_ABORTED;
-
-        } else {
-            req[i].result->state = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-            req[i].result->returnValue = ret;
-            id_state[id_index] = ORBIS_KERNEL_AIO_STATE_COMPLETED;
-        }
-
-        id[i] = id_index;
-        id_index = (id_index + 1) % MAX_QUEUE;
-
-        if (!id_index)
-            id_index++;
-    }
-    return 0;
+    return SubmitCommands(req, size, id, true, true);
 }
 
 s32 PS4_SYSV_ABI sceKernelAioSetParam() {
@@ -314,8 +297,7 @@ s32 PS4_SYSV_ABI sceKernelAioInitializeParam() {
 
 void RegisterAio(Core::Loader::SymbolsResolver* sym) {
     id_index = 1;
-    id_state = (int*)malloc(sizeof(int) * MAX_QUEUE);
-    memset(id_state, 0, sizeof(sizeof(int) * MAX_QUEUE));
+    aio_worker = std::make_unique<Common::ThreadWorker>(NumAioWorkers, "shadPS4:AioWorker");
 
     LIB_FUNCTION("fR521KIGgb8", "libkernel", 1, "libkernel", sceKernelAioCancelRequest);
     LIB_FUNCTION("3Lca1XBrQdY", "libkernel", 1, "libkernel", sceKernelAioCancelRequests);
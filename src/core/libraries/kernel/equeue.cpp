@@ -1,37 +1,148 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <map>
 #include <thread>
 
 #include "common/assert.h"
 #include "common/debug.h"
 #include "common/logging/log.h"
+#include "common/thread.h"
 #include "core/libraries/kernel/equeue.h"
 #include "core/libraries/kernel/orbis_error.h"
 #include "core/libraries/libs.h"
 
 namespace Libraries::Kernel {
 
-extern boost::asio::io_context io_context;
-extern void KernelSignalRequest();
+// Host sleeps overshoot by far more than the resolution HR timers need, so the timer thread wakes
+// up this much earlier and spins for the remaining time of an HR timer.
+static constexpr auto HrTimerSpinlockThreshold = std::chrono::microseconds{1200};
 
-static constexpr auto HrTimerSpinlockThresholdUs = 1200u;
+namespace {
+
+/**
+ * Timers of all event queues of the process. They are ordered by deadline and served by a single
+ * thread that sleeps until the earliest one expires, expired timers trigger their event directly
+ * so waiters are woken by the trigger like for any other event.
+ */
+class EqueueTimers {
+    using Clock = std::chrono::steady_clock;
+
+    struct Timer {
+        EqueueInternal* eq;
+        SceKernelEvent event;
+        std::chrono::microseconds period;
+    };
+
+public:
+    EqueueTimers() : thread{[this] { Run(); }} {}
+
+    ~EqueueTimers() {
+        {
+            std::scoped_lock lock{mutex};
+            stop = true;
+        }
+        cond.notify_one();
+        thread.join();
+    }
+
+    void Schedule(EqueueInternal* eq, const SceKernelEvent& event, Clock::duration delay,
+                  std::chrono::microseconds period) {
+        {
+            std::scoped_lock lock{mutex};
+            timers.emplace(Clock::now() + delay, Timer{eq, event, period});
+            ++generation;
+        }
+        cond.notify_one();
+    }
+
+    void Cancel(EqueueInternal* eq, u64 ident, s16 filter) {
+        std::scoped_lock lock{mutex};
+        std::erase_if(timers, [&](const auto& entry) {
+            const Timer& timer = entry.second;
+            return timer.eq == eq && timer.event.ident == ident && timer.event.filter == filter;
+        });
+        ++generation;
+    }
+
+    void CancelAll(EqueueInternal* eq) {
+        std::scoped_lock lock{mutex};
+        std::erase_if(timers, [&](const auto& entry) { return entry.second.eq == eq; });
+        ++generation;
+    }
+
+private:
+    void Run() {
+        Common::SetCurrentThreadName("shadPS4:EqueueTimers");
+
+        std::unique_lock lock{mutex};
+        while (!stop) {
+            if (timers.empty()) {
+                const u64 seen = generation;
+                cond.wait(lock, [&] { return stop || generation != seen; });
+                continue;
+            }
+
+            const auto it = timers.begin();
+            const auto deadline = it->first;
+            const bool is_hr = it->second.event.filter == SceKernelEvent::Filter::HrTimer;
+            const auto wakeup = is_hr ? deadline - HrTimerSpinlockThreshold : deadline;
+            if (Clock::now() < wakeup) {
+                // Any change of the timers may move the earliest deadline.
+                const u64 seen = generation;
+                cond.wait_until(lock, wakeup, [&] { return stop || generation != seen; });
+                continue;
+            }
+            if (Clock::now() < deadline) {
+                lock.unlock();
+                while (Clock::now() < deadline) {
+                    std::this_thread::yield();
+                }
+                lock.lock();
+                continue;
+            }
+
+            // Triggering under the lock keeps queues from being deleted while a timer fires.
+            auto node = timers.extract(it);
+            Timer& timer = node.mapped();
+            const bool exists =
+                timer.eq->TriggerEvent(timer.event.ident, timer.event.filter, timer.event.udata);
+            if (exists && timer.period.count() != 0) {
+                // The next occurrence is relative to the previous one so periods do not drift.
+                node.key() += timer.period;
+                timers.insert(std::move(node));
+            }
+        }
+    }
+
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::multimap<Clock::time_point, Timer> timers;
+    u64 generation{};
+    bool stop{};
+    std::thread thread;
+};
+
+EqueueTimers& GetTimers() {
+    static EqueueTimers timers;
+    return timers;
+}
+
+bool IsTimerFilter(s16 filter) {
+    return filter == SceKernelEvent::Filter::Timer || filter == SceKernelEvent::Filter::HrTimer;
+}
+
+} // Anonymous namespace
 
 // Events are uniquely identified by id and filter.
 
+EqueueInternal::~EqueueInternal() {
+    GetTimers().CancelAll(this);
+}
+
 bool EqueueInternal::AddEvent(EqueueEvent& event) {
     std::scoped_lock lock{m_mutex};
 
-    event.time_added = std::chrono::steady_clock::now();
-    if (event.event.filter == SceKernelEvent::Filter::Timer ||
-        event.event.filter == SceKernelEvent::Filter::HrTimer) {
-        // HrTimer events are offset by the threshold of time at the end that we spinlock for
-        // greater accuracy.
-        const auto offset =
-            event.event.filter == SceKernelEvent::Filter::HrTimer ? HrTimerSpinlockThresholdUs : 0u;
-        event.timer_interval = std::chrono::microseconds(event.event.data - offset);
-    }
-
     const auto& it = std::ranges::find(m_events, event);
     if (it != m_events.cend()) {
         *it = std::move(event);
@@ -42,73 +153,54 @@ bool EqueueInternal::AddEvent(EqueueEvent& event) {
     return true;
 }
 
-bool EqueueInternal::ScheduleEvent(u64 id, s16 filter,
-                                   void (*callback)(SceKernelEqueue, const SceKernelEvent&)) {
-    std::scoped_lock lock{m_mutex};
-
-    const auto& it = std::ranges::find_if(m_events, [id, filter](auto& ev) {
-        return ev.event.ident == id && ev.event.filter == filter;
-    });
-    if (it == m_events.cend()) {
-        return false;
-    }
-
-    const auto& event = *it;
-    ASSERT(event.event.filter == SceKernelEvent::Filter::Timer ||
-           event.event.filter == SceKernelEvent::Filter::HrTimer);
+bool EqueueInternal::ScheduleEvent(u64 id, s16 filter, std::chrono::microseconds delay,
+                                   std::chrono::microseconds period) {
+    ASSERT(IsTimerFilter(filter));
 
-    if (!it->timer) {
-        it->timer = std::make_unique<boost::asio::steady_timer>(io_context, event.timer_interval);
-    } else {
-        // If the timer already exists we are scheduling a reoccurrence after the next period.
-        // Set the expiration time to the previous occurrence plus the period.
-        it->timer->expires_at(it->timer->expiry() + event.timer_interval);
-    }
-
-    it->timer->async_wait(
-        [this, event_data = event.event, callback](const boost::system::error_code& ec) {
-            if (ec) {
-                if (ec != boost::system::errc::operation_canceled) {
-                    LOG_ERROR(Kernel_Event, "Timer callback error: {}", ec.message());
-                } else {
-                    // Timer was cancelled (removed) before it triggered
-                    LOG_DEBUG(Kernel_Event, "Timer cancelled");
-                }
-                return;
-            }
-            callback(this, event_data);
+    SceKernelEvent event;
+    {
+        std::scoped_lock lock{m_mutex};
+        const auto& it = std::ranges::find_if(m_events, [id, filter](auto& ev) {
+            return ev.event.ident == id && ev.event.filter == filter;
         });
-    KernelSignalRequest();
+        if (it == m_events.cend()) {
+            return false;
+        }
+        event = it->event;
+    }
 
+    // The timer lock is taken before queue locks when a timer fires, so it is never taken while
+    // holding the queue lock.
+    GetTimers().Schedule(this, event, delay, period);
     return true;
 }
 
 bool EqueueInternal::RemoveEvent(u64 id, s16 filter) {
-    bool has_found = false;
-    std::scoped_lock lock{m_mutex};
+    {
+        std::scoped_lock lock{m_mutex};
 
-    const auto& it = std::ranges::find_if(m_events, [id, filter](auto& ev) {
-        return ev.event.ident == id && ev.event.filter == filter;
-    });
-    if (it != m_events.cend()) {
+        const auto& it = std::ranges::find_if(m_events, [id, filter](auto& ev) {
+            return ev.event.ident == id && ev.event.filter == filter;
+        });
+        if (it == m_events.cend()) {
+            return false;
+        }
         m_events.erase(it);
-        has_found = true;
     }
-    return has_found;
+
+    if (IsTimerFilter(filter)) {
+        GetTimers().Cancel(this, id, filter);
+    }
+    return true;
 }
 
 int EqueueInternal::WaitForEvents(SceKernelEvent* ev, int num, const SceKernelUseconds* timo) {
+    std::unique_lock lock{m_mutex};
     if (timo != nullptr && *timo == 0) {
         // Effectively acts as a poll; only events that have already
         // arrived at the time of this function call can be received
         return GetTriggeredEvents(ev, num);
     }
-    const auto micros = timo ? *timo : 0u;
-
-    if (HasSmallTimer()) {
-        // If a small timer is set, just wait for it to expire.
-        return WaitForSmallTimer(ev, num, micros);
-    }
 
     int count = 0;
 
@@ -117,30 +209,22 @@ int EqueueInternal::WaitForEvents(SceKernelEvent* ev, int num, const SceKernelUs
         return count > 0;
     };
 
-    if (micros == 0) {
+    ++m_num_waiters;
+    if (timo == nullptr) {
         // Wait indefinitely for events
-        std::unique_lock lock{m_mutex};
         m_cond.wait(lock, predicate);
     } else {
         // Wait up until the timeout value
-        std::unique_lock lock{m_mutex};
-        m_cond.wait_for(lock, std::chrono::microseconds(micros), predicate);
-    }
-
-    if (HasSmallTimer()) {
-        if (count > 0) {
-            const auto time_waited = std::chrono::duration_cast<std::chrono::microseconds>(
-                                         std::chrono::steady_clock::now() - m_events[0].time_added)
-                                         .count();
-            count = WaitForSmallTimer(ev, num, std::max(0l, long(micros - time_waited)));
-        }
+        m_cond.wait_for(lock, std::chrono::microseconds(*timo), predicate);
     }
+    --m_num_waiters;
 
     return count;
 }
 
 bool EqueueInternal::TriggerEvent(u64 ident, s16 filter, void* trigger_data) {
     bool has_found = false;
+    bool has_waiters = false;
     {
         std::scoped_lock lock{m_mutex};
         for (auto& event : m_events) {
@@ -155,8 +239,13 @@ bool EqueueInternal::TriggerEvent(u64 ident, s16 filter, void* trigger_data) {
                 has_found = true;
             }
         }
+        has_waiters = has_found && m_num_waiters != 0;
+    }
+    // Every waiter checks for the triggered events, waking a single one could leave the event
+    // to a thread that is already about to return with another one.
+    if (has_waiters) {
+        m_cond.notify_all();
     }
-    m_cond.notify_one();
     return has_found;
 }
 
@@ -189,49 +278,6 @@ int EqueueInternal::GetTriggeredEvents(SceKernelEvent* ev, int num) {
     return count;
 }
 
-bool EqueueInternal::AddSmallTimer(EqueueEvent& ev) {
-    SmallTimer st;
-    st.event = ev.event;
-    st.added = std::chrono::steady_clock::now();
-    st.interval = std::chrono::microseconds{ev.event.data};
-    {
-        std::scoped_lock lock{m_mutex};
-        m_small_timers[st.event.ident] = std::move(st);
-    }
-    return true;
-}
-
-int EqueueInternal::WaitForSmallTimer(SceKernelEvent* ev, int num, u32 micros) {
-    ASSERT(num >= 1);
-
-    auto curr_clock = std::chrono::steady_clock::now();
-    const auto wait_end_us = (micros == 0) ? std::chrono::steady_clock::time_point::max()
-                                           : curr_clock + std::chrono::microseconds{micros};
-    int count = 0;
-    do {
-        curr_clock = std::chrono::steady_clock::now();
-        {
-            std::scoped_lock lock{m_mutex};
-            for (auto it = m_small_timers.begin(); it != m_small_timers.end() && count < num;) {
-                const SmallTimer& st = it->second;
-
-                if (curr_clock - st.added >= st.interval) {
-                    ev[count++] = st.event;
-                    it = m_small_timers.erase(it);
-                } else {
-                    ++it;
-                }
-            }
-
-            if (count > 0)
-                return count;
-        }
-        std::this_thread::yield();
-    } while (curr_clock < wait_end_us);
-
-    return 0;
-}
-
 bool EqueueInternal::EventExists(u64 id, s16 filter) {
     std::scoped_lock lock{m_mutex};
 
@@ -302,14 +348,6 @@ int PS4_SYSV_ABI sceKernelWaitEqueue(SceKernelEqueue eq, SceKernelEvent* ev, int
     return ORBIS_OK;
 }
 
-static void HrTimerCallback(SceKernelEqueue eq, const SceKernelEvent& kevent) {
-    static EqueueEvent event;
-    event.event = kevent;
-    event.event.data = HrTimerSpinlockThresholdUs;
-    eq->AddSmallTimer(event);
-    eq->TriggerEvent(kevent.ident, SceKernelEvent::Filter::HrTimer, kevent.udata);
-}
-
 s32 PS4_SYSV_ABI sceKernelAddHRTimerEvent(SceKernelEqueue eq, int id, timespec* ts, void* udata) {
     if (eq == nullptr) {
         return ORBIS_KERNEL_ERROR_EBADF;
@@ -329,24 +367,16 @@ s32 PS4_SYSV_ABI sceKernelAddHRTimerEvent(SceKernelEqueue eq, int id, timespec*
     event.event.data = total_us;
     event.event.udata = udata;
 
-    // HR timers cannot be implemented within the existing event queue architecture due to the
-    // slowness of the notification mechanism. For instance, a 100us timer will lose its precision
-    // as the trigger time drifts by +50-700%, depending on the host PC and workload. To address
-    // this issue, we use a spinlock for small waits (which can be adjusted using
-    // `HrTimerSpinlockThresholdUs`) and fall back to boost asio timers if the time to tick is
-    // large. Even for large delays, we truncate a small portion to complete the wait
-    // using the spinlock, prioritizing precision.
+    // A 100us timer loses its precision if it relies on host sleeps alone, the timer thread
+    // spins for the last `HrTimerSpinlockThreshold` of the delay to trigger it on time.
 
     if (eq->EventExists(event.event.ident, event.event.filter)) {
         eq->RemoveEvent(id, SceKernelEvent::Filter::HrTimer);
     }
 
-    if (total_us < HrTimerSpinlockThresholdUs) {
-        return eq->AddSmallTimer(event) ? ORBIS_OK : ORBIS_KERNEL_ERROR_ENOMEM;
-    }
-
     if (!eq->AddEvent(event) ||
-        !eq->ScheduleEvent(id, SceKernelEvent::Filter::HrTimer, HrTimerCallback)) {
+        !eq->ScheduleEvent(id, SceKernelEvent::Filter::HrTimer,
+                           std::chrono::microseconds{total_us}, std::chrono::microseconds{0})) {
         return ORBIS_KERNEL_ERROR_ENOMEM;
     }
     return ORBIS_OK;
@@ -357,23 +387,8 @@ int PS4_SYSV_ABI sceKernelDeleteHRTimerEvent(SceKernelEqueue eq, int id) {
         return ORBIS_KERNEL_ERROR_EBADF;
     }
 
-    if (eq->HasSmallTimer()) {
-        return eq->RemoveSmallTimer(id) ? ORBIS_OK : ORBIS_KERNEL_ERROR_ENOENT;
-    } else {
-        return eq->RemoveEvent(id, SceKernelEvent::Filter::HrTimer) ? ORBIS_OK
-                                                                    : ORBIS_KERNEL_ERROR_ENOENT;
-    }
-}
-
-static void TimerCallback(SceKernelEqueue eq, const SceKernelEvent& kevent) {
-    if (eq->EventExists(kevent.ident, kevent.filter)) {
-        eq->TriggerEvent(kevent.ident, SceKernelEvent::Filter::Timer, kevent.udata);
-
-        if (!(kevent.flags & SceKernelEvent::Flags::OneShot)) {
-            // Reschedule the event for its next period.
-            eq->ScheduleEvent(kevent.ident, kevent.filter, TimerCallback);
-        }
-    }
+    return eq->RemoveEvent(id, SceKernelEvent::Filter::HrTimer) ? ORBIS_OK
+                                                                : ORBIS_KERNEL_ERROR_ENOENT;
 }
 
 int PS4_SYSV_ABI sceKernelAddTimerEvent(SceKernelEqueue eq, int id, SceKernelUseconds usec,
@@ -400,8 +415,9 @@ int PS4_SYSV_ABI sceKernelAddTimerEvent(SceKernelEqueue eq, int id, SceKernelUse
     LOG_DEBUG(Kernel_Event, "Added timing event: queue name={}, queue id={}, usec={}, pointer={:x}",
               eq->GetName(), event.event.ident, usec, reinterpret_cast<uintptr_t>(udata));
 
+    const auto period = std::chrono::microseconds{usec};
     if (!eq->AddEvent(event) ||
-        !eq->ScheduleEvent(id, SceKernelEvent::Filter::Timer, TimerCallback)) {
+        !eq->ScheduleEvent(id, SceKernelEvent::Filter::Timer, period, period)) {
         return ORBIS_KERNEL_ERROR_ENOMEM;
     }
     return ORBIS_OK;
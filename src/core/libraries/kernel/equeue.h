@@ -3,13 +3,12 @@
 
 #pragma once
 
+#include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <string>
 #include <vector>
-#include <boost/asio/steady_timer.hpp>
 
-#include <unordered_map>
 #include "common/rdtsc.h"
 #include "common/types.h"
 
@@ -80,9 +79,6 @@ struct OrbisVideoOutEventData {
 struct EqueueEvent {
     SceKernelEvent event;
     void* data = nullptr;
-    std::chrono::steady_clock::time_point time_added;
-    std::chrono::microseconds timer_interval;
-    std::unique_ptr<boost::asio::steady_timer> timer;
 
     void ResetTriggerState() {
         is_triggered = false;
@@ -136,42 +132,24 @@ private:
 };
 
 class EqueueInternal {
-    struct SmallTimer {
-        SceKernelEvent event;
-        std::chrono::steady_clock::time_point added;
-        std::chrono::microseconds interval;
-    };
-
 public:
     explicit EqueueInternal(std::string_view name) : m_name(name) {}
+    ~EqueueInternal();
 
     std::string_view GetName() const {
         return m_name;
     }
 
     bool AddEvent(EqueueEvent& event);
-    bool ScheduleEvent(u64 id, s16 filter,
-                       void (*callback)(SceKernelEqueue, const SceKernelEvent&));
+    /// Arms the timer of a timer event that is already added. The event is triggered once the
+    /// delay expires and then every period, a zero period makes it fire only once.
+    bool ScheduleEvent(u64 id, s16 filter, std::chrono::microseconds delay,
+                       std::chrono::microseconds period);
     bool RemoveEvent(u64 id, s16 filter);
     int WaitForEvents(SceKernelEvent* ev, int num, const SceKernelUseconds* timo);
     bool TriggerEvent(u64 ident, s16 filter, void* trigger_data);
     int GetTriggeredEvents(SceKernelEvent* ev, int num);
 
-    bool AddSmallTimer(EqueueEvent& event);
-    bool HasSmallTimer() {
-        std::scoped_lock lock{m_mutex};
-        return !m_small_timers.empty();
-    }
-    bool RemoveSmallTimer(u64 id) {
-        if (HasSmallTimer()) {
-            std::scoped_lock lock{m_mutex};
-            return m_small_timers.erase(id) > 0;
-        }
-        return false;
-    }
-
-    int WaitForSmallTimer(SceKernelEvent* ev, int num, u32 micros);
-
     bool EventExists(u64 id, s16 filter);
 
 private:
@@ -179,7 +157,7 @@ private:
     std::mutex m_mutex;
     std::vector<EqueueEvent> m_events;
     std::condition_variable m_cond;
-    std::unordered_map<u64, SmallTimer> m_small_timers;
+    u32 m_num_waiters{};
 };
 
 u64 PS4_SYSV_ABI sceKernelGetEventData(const SceKernelEvent* ev);
@@ -1,11 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <map>
 #include <ranges>
 #include <magic_enum/magic_enum.hpp>
 
 #include "common/assert.h"
+#include "common/config.h"
 #include "common/error.h"
 #include "common/logging/log.h"
 #include "common/scope_exit.h"
@@ -118,10 +120,11 @@ s32 PS4_SYSV_ABI open(const char* raw_path, s32 flags, u16 mode) {
         }
     }
 
-    bool read_only = false;
     file->m_guest_name = path;
-    file->m_host_name = mnt->GetHostPath(file->m_guest_name, &read_only);
-    bool exists = std::filesystem::exists(file->m_host_name);
+    const auto info = mnt->GetHostPathInfo(file->m_guest_name);
+    file->m_host_name = info.host_path;
+    const bool read_only = info.read_only;
+    bool exists = info.exists;
     s32 e = 0;
 
     if (create) {
@@ -141,6 +144,7 @@ s32 PS4_SYSV_ABI open(const char* raw_path, s32 flags, u16 mode) {
             }
             // Create a file if it doesn't exist
             Common::FS::IOFile out(file->m_host_name, Common::FS::FileAccessMode::Write);
+            mnt->InvalidateCache();
         }
     } else if (!exists) {
         // If we're not creating a file, and it doesn't exist, return ENOENT
@@ -149,14 +153,14 @@ s32 PS4_SYSV_ABI open(const char* raw_path, s32 flags, u16 mode) {
         return -1;
     }
 
-    if (std::filesystem::is_directory(file->m_host_name) || directory) {
+    if (info.is_directory || directory) {
         // Directories can be opened even if the directory flag isn't set.
         // In these cases, error behavior is identical to the directory code path.
         directory = true;
     }
 
     if (directory) {
-        if (!std::filesystem::is_directory(file->m_host_name)) {
+        if (!info.is_directory) {
             // If the opened file is not a directory, return ENOTDIR.
             // This will trigger when create & directory is specified, this is expected.
             h->DeleteHandle(handle);
@@ -207,6 +211,11 @@ s32 PS4_SYSV_ABI open(const char* raw_path, s32 flags, u16 mode) {
         if (read) {
             // Read only
             e = file->f.Open(file->m_host_name, Common::FS::FileAccessMode::Read);
+            if (e == 0 && read_only && Config::isMappedFileReadsEnabled()) {
+                // Files on read-only mounts can't change under us, serve reads from a mapping.
+                file->mapping.Open(file->m_host_name);
+                file->read_ahead = {};
+            }
         } else if (read_only) {
             // Can't open files with write/read-write access in a read only directory
             h->DeleteHandle(handle);
@@ -260,6 +269,7 @@ s32 PS4_SYSV_ABI close(s32 fd) {
         return -1;
     }
     if (file->type == Core::FileSys::FileType::Regular) {
+        file->mapping.Close();
         file->f.Close();
     } else if (file->type == Core::FileSys::FileType::Socket) {
         file->socket->Close();
@@ -321,13 +331,58 @@ s64 PS4_SYSV_ABI sceKernelWrite(s32 fd, const void* buf, u64 nbytes) {
     return result;
 }
 
-s64 ReadFile(Common::FS::IOFile& file, void* buf, u64 nbytes) {
+static constexpr u64 MinReadAheadWindow = 256_KB;
+static constexpr u64 MaxReadAheadWindow = 8_MB;
+
+// Sequential readers get the range after their read paged in asynchronously, with a window
+// that doubles on every sequential read so small chunked reads turn into large host reads.
+static void UpdateReadAhead(Core::FileSys::File& file, u64 offset, u64 nbytes) {
+    auto& ra = file.read_ahead;
+    const u64 end = offset + nbytes;
+    if (offset != ra.next_offset) {
+        // Random access, stop reading ahead until the reads look sequential again.
+        ra.window = 0;
+        ra.prefetched_end = 0;
+        ra.next_offset = end;
+        return;
+    }
+    ra.next_offset = end;
+    ra.window = std::clamp(ra.window * 2, MinReadAheadWindow, MaxReadAheadWindow);
+    const u64 target = std::min(end + ra.window, file.mapping.GetSize());
+    // Only issue the hint once half of the previous window was consumed.
+    if (ra.prefetched_end >= end + ra.window / 2 || target <= end) {
+        return;
+    }
+    const u64 start = std::max(ra.prefetched_end, end);
+    file.mapping.Prefetch(start, target - start);
+    ra.prefetched_end = target;
+}
+
+static s64 ReadMappedFile(Core::FileSys::File& file, void* buf, u64 nbytes, u64 offset) {
+    const auto& mapping = file.mapping;
+    const auto* memory = Core::Memory::Instance();
+    const auto remaining = offset < mapping.GetSize() ? mapping.GetSize() - offset : 0;
+    memory->InvalidateMemory(reinterpret_cast<VAddr>(buf), std::min<u64>(nbytes, remaining));
+
+    UpdateReadAhead(file, offset, nbytes);
+    return mapping.Read(buf, nbytes, offset);
+}
+
+s64 ReadFile(Core::FileSys::File& file, void* buf, u64 nbytes) {
+    if (file.mapping.IsOpen()) {
+        // Keep the host file position authoritative so lseek and friends don't need to know.
+        const s64 pos = file.f.Tell();
+        const s64 bytes_read = ReadMappedFile(file, buf, nbytes, pos);
+        file.f.Seek(pos + bytes_read);
+        return bytes_read;
+    }
+
     const auto* memory = Core::Memory::Instance();
     // Invalidate up to the actual number of bytes that could be read.
-    const auto remaining = file.GetSize() - file.Tell();
+    const auto remaining = file.f.GetSize() - file.f.Tell();
     memory->InvalidateMemory(reinterpret_cast<VAddr>(buf), std::min<u64>(nbytes, remaining));
 
-    return file.ReadRaw<u8>(buf, nbytes);
+    return file.f.ReadRaw<u8>(buf, nbytes);
 }
 
 s64 PS4_SYSV_ABI readv(s32 fd, const OrbisKernelIovec* iov, s32 iovcnt) {
@@ -354,9 +409,19 @@ s64 PS4_SYSV_ABI readv(s32 fd, const OrbisKernelIovec* iov, s32 iovcnt) {
         }
         return result;
     }
+    if (file->mapping.IsOpen()) {
+        // Resolve the position once for the whole vector instead of once per element.
+        const s64 pos = file->f.Tell();
+        s64 total_read = 0;
+        for (s32 i = 0; i < iovcnt; i++) {
+            total_read += ReadMappedFile(*file, iov[i].iov_base, iov[i].iov_len, pos + total_read);
+        }
+        file->f.Seek(pos + total_read);
+        return total_read;
+    }
     s64 total_read = 0;
     for (s32 i = 0; i < iovcnt; i++) {
-        total_read += ReadFile(file->f, iov[i].iov_base, iov[i].iov_len);
+        total_read += ReadFile(*file, iov[i].iov_base, iov[i].iov_len);
     }
     return total_read;
 }
@@ -509,7 +574,7 @@ s64 PS4_SYSV_ABI read(s32 fd, void* buf, u64 nbytes) {
         // Socket functions handle errnos internally.
         return file->socket->ReceivePacket(buf, nbytes, 0, nullptr, 0);
     }
-    return ReadFile(file->f, buf, nbytes);
+    return ReadFile(*file, buf, nbytes);
 }
 
 s64 PS4_SYSV_ABI posix_read(s32 fd, void* buf, u64 nbytes) {
@@ -552,6 +617,7 @@ s32 PS4_SYSV_ABI posix_mkdir(const char* path, u16 mode) {
         *__Error() = POSIX_EIO;
         return -1;
     }
+    mnt->InvalidateCache();
 
     if (!std::filesystem::exists(dir_name)) {
         *__Error() = POSIX_ENOENT;
@@ -592,6 +658,7 @@ s32 PS4_SYSV_ABI posix_rmdir(const char* path) {
 
     std::error_code ec;
     s32 result = std::filesystem::remove_all(dir_name, ec);
+    mnt->InvalidateCache();
 
     if (ec) {
         *__Error() = POSIX_EIO;
@@ -612,15 +679,13 @@ s32 PS4_SYSV_ABI sceKernelRmdir(const char* path) {
 s32 PS4_SYSV_ABI posix_stat(const char* path, OrbisKernelStat* sb) {
     LOG_DEBUG(Kernel_Fs, "(PARTIAL) path = {}", path);
     auto* mnt = Common::Singleton<Core::FileSys::MntPoints>::Instance();
-    const auto path_name = mnt->GetHostPath(path);
+    const auto info = mnt->GetHostPathInfo(path);
     std::memset(sb, 0, sizeof(OrbisKernelStat));
-    const bool is_dir = std::filesystem::is_directory(path_name);
-    const bool is_file = std::filesystem::is_regular_file(path_name);
-    if (!is_dir && !is_file) {
+    if (!info.is_directory && !info.is_file) {
         *__Error() = POSIX_ENOENT;
         return -1;
     }
-    if (std::filesystem::is_directory(path_name)) {
+    if (info.is_directory) {
         sb->st_mode = 0000777u | 0040000u;
         sb->st_size = 65536;
         sb->st_blksize = 65536;
@@ -628,7 +693,7 @@ s32 PS4_SYSV_ABI posix_stat(const char* path, OrbisKernelStat* sb) {
         // TODO incomplete
     } else {
         sb->st_mode = 0000777u | 0100000u;
-        sb->st_size = static_cast<s64>(std::filesystem::file_size(path_name));
+        sb->st_size = static_cast<s64>(info.size);
         sb->st_blksize = 512;
         sb->st_blocks = (sb->st_size + 511) / 512;
         // TODO incomplete
@@ -812,6 +877,7 @@ s32 PS4_SYSV_ABI posix_rename(const char* from, const char* to) {
     } else {
         std::filesystem::remove(src_path);
     }
+    mnt->InvalidateCache();
 
     return ORBIS_OK;
 }
@@ -855,6 +921,16 @@ s64 PS4_SYSV_ABI posix_preadv(s32 fd, OrbisKernelIovec* iov, s32 iovcnt, s64 off
         return result;
     }
 
+    if (file->mapping.IsOpen()) {
+        // Positional reads from the mapping leave the file position alone without any seeking.
+        s64 total_read = 0;
+        for (s32 i = 0; i < iovcnt; i++) {
+            total_read +=
+                ReadMappedFile(*file, iov[i].iov_base, iov[i].iov_len, offset + total_read);
+        }
+        return total_read;
+    }
+
     const s64 pos = file->f.Tell();
     SCOPE_EXIT {
         file->f.Seek(pos);
@@ -865,7 +941,7 @@ s64 PS4_SYSV_ABI posix_preadv(s32 fd, OrbisKernelIovec* iov, s32 iovcnt, s64 off
     }
     s64 total_read = 0;
     for (s32 i = 0; i < iovcnt; i++) {
-        total_read += ReadFile(file->f, iov[i].iov_base, iov[i].iov_len);
+        total_read += ReadFile(*file, iov[i].iov_base, iov[i].iov_len);
     }
     return total_read;
 }
@@ -1087,6 +1163,7 @@ s32 PS4_SYSV_ABI posix_unlink(const char* path) {
     } else {
         file->f.Unlink();
     }
+    mnt->InvalidateCache();
 
     LOG_INFO(Kernel_Fs, "Unlinked {}", path);
     return ORBIS_OK;
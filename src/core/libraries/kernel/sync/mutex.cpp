@@ -1,52 +1,175 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <limits>
+
 #include "mutex.h"
 
-#include "common/assert.h"
+#ifdef _WIN64
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <cerrno>
+#else
+#include <cerrno>
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
-namespace Libraries::Kernel {
+#if defined(_M_AMD64) || defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
-TimedMutex::TimedMutex() {
-#ifdef _WIN64
-    mtx = CreateMutex(nullptr, false, nullptr);
-    ASSERT(mtx);
+#ifdef __APPLE__
+// Darwin address wait primitive, the one libc++ uses to implement std::atomic::wait.
+extern "C" int __ulock_wait(u32 operation, void* addr, u64 value, u32 timeout_us);
+extern "C" int __ulock_wake(u32 operation, void* addr, u64 wake_value);
+constexpr u32 UL_COMPARE_AND_WAIT = 1;
+constexpr u32 ULF_NO_ERRNO = 0x01000000;
 #endif
-}
 
-TimedMutex::~TimedMutex() {
-#ifdef _WIN64
-    CloseHandle(mtx);
+namespace Libraries::Kernel {
+
+namespace {
+
+/// Spins before sleeping, most guest critical sections are shorter than a host sleep and wake.
+constexpr u32 SpinCount = 100;
+
+void SpinPause() {
+#if defined(_M_AMD64) || defined(__x86_64__)
+    _mm_pause();
+#elif defined(_MSC_VER)
+    __yield();
+#else
+    asm volatile("yield");
 #endif
 }
 
-void TimedMutex::lock() {
+/// Sleeps while the word holds the expected value, a null timeout waits indefinitely. Returns on
+/// wakes, value changes, timeouts and spurious wakeups alike, the caller rechecks the word.
+void WaitOnWord(std::atomic<u32>& word, u32 expected, const std::chrono::nanoseconds* timeout) {
 #ifdef _WIN64
-    for (;;) {
-        u64 res = WaitForSingleObjectEx(mtx, INFINITE, true);
-        if (res == WAIT_OBJECT_0) {
-            return;
-        }
-    }
+    const DWORD timeout_ms =
+        timeout ? static_cast<DWORD>(std::chrono::ceil<std::chrono::milliseconds>(*timeout).count())
+                : INFINITE;
+    WaitOnAddress(&word, &expected, sizeof(expected), timeout_ms);
+#elif defined(__APPLE__)
+    const u32 timeout_us =
+        timeout ? static_cast<u32>(std::max<s64>(
+                      std::chrono::ceil<std::chrono::microseconds>(*timeout).count(), 1))
+                : 0;
+    __ulock_wait(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO, &word, expected, timeout_us);
 #else
-    mtx.lock();
+    timespec ts{};
+    if (timeout) {
+        ts.tv_sec = static_cast<time_t>(timeout->count() / 1000000000);
+        ts.tv_nsec = static_cast<long>(timeout->count() % 1000000000);
+    }
+    syscall(SYS_futex, &word, FUTEX_WAIT_PRIVATE, expected, timeout ? &ts : nullptr, nullptr, 0);
 #endif
 }
 
-bool TimedMutex::try_lock() {
+void WakeOneOnWord(std::atomic<u32>& word) {
 #ifdef _WIN64
-    return WaitForSingleObjectEx(mtx, 0, true) == WAIT_OBJECT_0;
+    WakeByAddressSingle(&word);
+#elif defined(__APPLE__)
+    __ulock_wake(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO, &word, 0);
 #else
-    return mtx.try_lock();
+    syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
 #endif
 }
 
-void TimedMutex::unlock() {
+void WakeAllOnWord(std::atomic<u32>& word) {
 #ifdef _WIN64
-    ReleaseMutex(mtx);
+    WakeByAddressAll(&word);
+#elif defined(__APPLE__)
+    constexpr u32 ULF_WAKE_ALL = 0x00000100;
+    __ulock_wake(UL_COMPARE_AND_WAIT | ULF_NO_ERRNO | ULF_WAKE_ALL, &word, 0);
 #else
-    mtx.unlock();
+    syscall(SYS_futex, &word, FUTEX_WAKE_PRIVATE, std::numeric_limits<int>::max(), nullptr,
+            nullptr, 0);
 #endif
 }
 
-} // namespace Libraries::Kernel
\ No newline at end of file
+} // Anonymous namespace
+
+bool TimedMutex::LockSlow(const std::chrono::steady_clock::time_point* deadline) {
+    // Spin while the owner is likely to release soon and nobody is sleeping yet.
+    for (u32 i = 0; i < SpinCount; ++i) {
+        u32 current = state.load(std::memory_order_relaxed);
+        if (current == Unlocked &&
+            state.compare_exchange_weak(current, Locked, std::memory_order_acquire)) {
+            return true;
+        }
+        if (current == Contended) {
+            break;
+        }
+        SpinPause();
+    }
+
+    // Marking the word contended makes the owner wake a waiter on unlock. A mutex acquired here
+    // stays marked, which costs one spurious wake when no other waiter exists.
+    while (state.exchange(Contended, std::memory_order_acquire) != Unlocked) {
+        if (!deadline) {
+            WaitOnWord(state, Contended, nullptr);
+            continue;
+        }
+        const auto remaining = *deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::steady_clock::duration::zero()) {
+            return false;
+        }
+        const auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining);
+        WaitOnWord(state, Contended, &timeout);
+    }
+    return true;
+}
+
+void TimedMutex::WakeOne() {
+    WakeOneOnWord(state);
+}
+
+bool TimedRwLock::LockSlow(bool shared, const std::chrono::steady_clock::time_point* deadline) {
+    const auto try_acquire = [&] { return shared ? try_lock_shared() : try_lock(); };
+    for (u32 i = 0; i < SpinCount; ++i) {
+        if (try_acquire()) {
+            return true;
+        }
+        SpinPause();
+    }
+
+    for (;;) {
+        if (try_acquire()) {
+            return true;
+        }
+        // Flag the sleeper so the releasing thread wakes us, then sleep on the flagged value.
+        // Any change to the word in between makes the wait return at once.
+        u32 current = state.load(std::memory_order_relaxed);
+        const bool blocked = shared ? (current & WriterBit) != 0 : (current & ~SleepersBit) != 0;
+        if (!blocked) {
+            continue;
+        }
+        const u32 flagged = current | SleepersBit;
+        if (current != flagged &&
+            !state.compare_exchange_weak(current, flagged, std::memory_order_relaxed)) {
+            continue;
+        }
+        if (!deadline) {
+            WaitOnWord(state, flagged, nullptr);
+            continue;
+        }
+        const auto remaining = *deadline - std::chrono::steady_clock::now();
+        if (remaining <= std::chrono::steady_clock::duration::zero()) {
+            return false;
+        }
+        const auto timeout = std::chrono::duration_cast<std::chrono::nanoseconds>(remaining);
+        WaitOnWord(state, flagged, &timeout);
+    }
+}
+
+void TimedRwLock::WakeAll() {
+    WakeAllOnWord(state);
+}
+
+} // namespace Libraries::Kernel
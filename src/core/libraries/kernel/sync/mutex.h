@@ -3,78 +3,167 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 
 #include "common/types.h"
 
-#ifdef _WIN64
-#include <windows.h>
-#else
-#include <mutex>
-#endif
-
 namespace Libraries::Kernel {
 
+/**
+ * Mutex built on an address wait primitive (futex, WaitOnAddress, ulock). Uncontended lock and
+ * unlock are a single atomic operation, the host kernel is only entered once a waiter has to
+ * sleep and on unlocks that have sleeping waiters.
+ */
 class TimedMutex {
 public:
-    TimedMutex();
-    ~TimedMutex();
+    TimedMutex() = default;
+    ~TimedMutex() = default;
 
-    void lock();
-    bool try_lock();
+    TimedMutex(const TimedMutex&) = delete;
+    TimedMutex& operator=(const TimedMutex&) = delete;
 
-    void unlock();
+    void lock() {
+        u32 expected = Unlocked;
+        if (!state.compare_exchange_strong(expected, Locked, std::memory_order_acquire))
+            [[unlikely]] {
+            LockSlow(nullptr);
+        }
+    }
+
+    bool try_lock() {
+        u32 expected = Unlocked;
+        return state.compare_exchange_strong(expected, Locked, std::memory_order_acquire);
+    }
+
+    void unlock() {
+        if (state.exchange(Unlocked, std::memory_order_release) == Contended) [[unlikely]] {
+            WakeOne();
+        }
+    }
 
     template <class Rep, class Period>
     bool try_lock_for(const std::chrono::duration<Rep, Period>& rel_time) {
-#ifdef _WIN64
-        constexpr auto zero = std::chrono::duration<Rep, Period>::zero();
-        const auto now = std::chrono::steady_clock::now();
-
-        std::chrono::steady_clock::time_point abs_time = now;
-        if (rel_time > zero) {
-            constexpr auto max = (std::chrono::steady_clock::time_point::max)();
-            if (abs_time < max - rel_time) {
-                abs_time += rel_time;
-            } else {
-                abs_time = max;
+        return try_lock_until(std::chrono::steady_clock::now() + rel_time);
+    }
+
+    template <class Clock, class Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time) {
+        if (try_lock()) {
+            return true;
+        }
+        const auto deadline =
+            std::chrono::steady_clock::now() +
+            std::chrono::ceil<std::chrono::steady_clock::duration>(abs_time - Clock::now());
+        return LockSlow(&deadline);
+    }
+
+private:
+    static constexpr u32 Unlocked = 0;
+    static constexpr u32 Locked = 1;
+    static constexpr u32 Contended = 2;
+
+    /// Spins briefly and then sleeps until the mutex is acquired or the deadline has passed.
+    bool LockSlow(const std::chrono::steady_clock::time_point* deadline);
+
+    void WakeOne();
+
+    std::atomic<u32> state{Unlocked};
+};
+
+/**
+ * Reader-writer lock built on the same address wait primitive as TimedMutex. The word holds the
+ * reader count and a writer bit, so read locks and unlocks are a single atomic operation while no
+ * writer holds the lock. Readers are only held back by a writer that owns the lock, which keeps
+ * recursive read locking safe like the default host rwlock does.
+ */
+class TimedRwLock {
+public:
+    TimedRwLock() = default;
+    ~TimedRwLock() = default;
+
+    TimedRwLock(const TimedRwLock&) = delete;
+    TimedRwLock& operator=(const TimedRwLock&) = delete;
+
+    void lock() {
+        if (!try_lock()) [[unlikely]] {
+            LockSlow(false, nullptr);
+        }
+    }
+
+    bool try_lock() {
+        u32 current = state.load(std::memory_order_relaxed);
+        return (current & ~SleepersBit) == 0 &&
+               state.compare_exchange_strong(current, current | WriterBit,
+                                             std::memory_order_acquire);
+    }
+
+    void unlock() {
+        if (state.exchange(0, std::memory_order_release) & SleepersBit) [[unlikely]] {
+            WakeAll();
+        }
+    }
+
+    void lock_shared() {
+        if (!try_lock_shared()) [[unlikely]] {
+            LockSlow(true, nullptr);
+        }
+    }
+
+    bool try_lock_shared() {
+        u32 current = state.load(std::memory_order_relaxed);
+        while ((current & WriterBit) == 0) {
+            if (state.compare_exchange_weak(current, current + 1, std::memory_order_acquire)) {
+                return true;
             }
         }
+        return false;
+    }
 
-        return try_lock_until(abs_time);
-#else
-        return mtx.try_lock_for(rel_time);
-#endif
+    void unlock_shared() {
+        const u32 previous = state.fetch_sub(1, std::memory_order_release);
+        if (previous == (SleepersBit | 1)) [[unlikely]] {
+            // The last reader left while a writer sleeps.
+            state.fetch_and(~SleepersBit, std::memory_order_relaxed);
+            WakeAll();
+        }
     }
 
     template <class Clock, class Duration>
     bool try_lock_until(const std::chrono::time_point<Clock, Duration>& abs_time) {
-#ifdef _WIN64
-        for (;;) {
-            const auto now = Clock::now();
-            if (abs_time <= now) {
-                return false;
-            }
+        if (try_lock()) {
+            return true;
+        }
+        const auto deadline = ToSteady(abs_time);
+        return LockSlow(false, &deadline);
+    }
 
-            const auto rel_ms = std::chrono::ceil<std::chrono::milliseconds>(abs_time - now);
-            u64 res = WaitForSingleObjectEx(mtx, static_cast<u64>(rel_ms.count()), true);
-            if (res == WAIT_OBJECT_0) {
-                return true;
-            } else if (res == WAIT_TIMEOUT) {
-                return false;
-            }
+    template <class Clock, class Duration>
+    bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration>& abs_time) {
+        if (try_lock_shared()) {
+            return true;
         }
-#else
-        return mtx.try_lock_until(abs_time);
-#endif
+        const auto deadline = ToSteady(abs_time);
+        return LockSlow(true, &deadline);
     }
 
 private:
-#ifdef _WIN64
-    HANDLE mtx;
-#else
-    std::timed_mutex mtx;
-#endif
+    static constexpr u32 WriterBit = 1U << 31;
+    static constexpr u32 SleepersBit = 1U << 30;
+
+    template <class Clock, class Duration>
+    static std::chrono::steady_clock::time_point ToSteady(
+        const std::chrono::time_point<Clock, Duration>& abs_time) {
+        return std::chrono::steady_clock::now() +
+               std::chrono::ceil<std::chrono::steady_clock::duration>(abs_time - Clock::now());
+    }
+
+    /// Spins briefly and then sleeps until the lock is acquired or the deadline has passed.
+    bool LockSlow(bool shared, const std::chrono::steady_clock::time_point* deadline);
+
+    void WakeAll();
+
+    std::atomic<u32> state{0};
 };
 
-} // namespace Libraries::Kernel
\ No newline at end of file
+} // namespace Libraries::Kernel
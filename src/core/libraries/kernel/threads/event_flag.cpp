@@ -1,13 +1,16 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
-#include <condition_variable>
+#include <chrono>
+#include <list>
 #include <mutex>
-#include <thread>
+
+#include "core/libraries/kernel/sync/semaphore.h"
 
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/libraries/kernel/orbis_error.h"
+#include "core/libraries/kernel/threads/pthread.h"
 #include "core/libraries/libs.h"
 
 namespace Libraries::Kernel {
@@ -36,65 +39,64 @@ public:
     int Wait(u64 bits, WaitMode wait_mode, ClearMode clear_mode, u64* result, u32* ptr_micros) {
         std::unique_lock lock{m_mutex};
 
-        uint32_t micros = 0;
-        bool infinitely = true;
-        if (ptr_micros != nullptr) {
-            micros = *ptr_micros;
-            infinitely = false;
-        }
-
-        if (m_thread_mode == ThreadMode::Single && m_waiting_threads > 0) {
+        if (m_thread_mode == ThreadMode::Single && !m_wait_list.empty()) {
             return ORBIS_KERNEL_ERROR_EPERM;
         }
 
-        auto const start = std::chrono::system_clock::now();
-        m_waiting_threads++;
-        auto waitFunc = [this, wait_mode, bits] {
-            return (m_status == Status::Canceled || m_status == Status::Deleted ||
-                    (wait_mode == WaitMode::And && (m_bits & bits) == bits) ||
-                    (wait_mode == WaitMode::Or && (m_bits & bits) != 0));
-        };
-
-        if (infinitely) {
-            m_cond_var.wait(lock, waitFunc);
-        } else {
-            if (!m_cond_var.wait_for(lock, std::chrono::microseconds(micros), waitFunc)) {
-                if (result != nullptr) {
-                    *result = m_bits;
-                }
-                *ptr_micros = 0;
-                --m_waiting_threads;
-                return ORBIS_KERNEL_ERROR_ETIMEDOUT;
+        if (IsSatisfied(bits, wait_mode)) {
+            if (result != nullptr) {
+                *result = m_bits;
             }
-        }
-        --m_waiting_threads;
-        if (result != nullptr) {
-            *result = m_bits;
+            ApplyClear(bits, clear_mode);
+            return ORBIS_OK;
         }
 
-        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
-                           std::chrono::system_clock::now() - start)
-                           .count();
-        if (result != nullptr) {
-            *result = m_bits;
+        if (ptr_micros != nullptr && *ptr_micros == 0) {
+            if (result != nullptr) {
+                *result = m_bits;
+            }
+            return ORBIS_KERNEL_ERROR_ETIMEDOUT;
         }
 
-        if (ptr_micros != nullptr) {
-            *ptr_micros = (elapsed >= micros ? 0 : micros - elapsed);
+        // Create waiting thread object and add it into the list of waiters.
+        WaitingThread waiter{bits, wait_mode, clear_mode, m_queue_mode};
+        const auto it = AddWaiter(&waiter);
+
+        // Perform the wait, waiters are only woken once their pattern is satisfied.
+        lock.unlock();
+        if (ptr_micros == nullptr) {
+            waiter.sem.acquire();
+            lock.lock();
+        } else {
+            const auto start = std::chrono::high_resolution_clock::now();
+            waiter.sem.try_acquire_for(std::chrono::microseconds(*ptr_micros));
+            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+                                     std::chrono::high_resolution_clock::now() - start)
+                                     .count();
+            lock.lock();
+            if (waiter.was_signaled || waiter.was_canceled) {
+                *ptr_micros = elapsed >= *ptr_micros ? 0 : *ptr_micros - elapsed;
+            } else {
+                *ptr_micros = 0;
+            }
         }
 
-        if (m_status == Status::Canceled) {
+        if (waiter.was_canceled) {
+            if (result != nullptr) {
+                *result = waiter.result_bits;
+            }
             return ORBIS_KERNEL_ERROR_ECANCELED;
-        } else if (m_status == Status::Deleted) {
-            return ORBIS_KERNEL_ERROR_EACCES;
         }
-
-        if (clear_mode == ClearMode::All) {
-            m_bits = 0;
-        } else if (clear_mode == ClearMode::Bits) {
-            m_bits &= ~bits;
+        if (!waiter.was_signaled) {
+            m_wait_list.erase(it);
+            if (result != nullptr) {
+                *result = m_bits;
+            }
+            return ORBIS_KERNEL_ERROR_ETIMEDOUT;
+        }
+        if (result != nullptr) {
+            *result = waiter.result_bits;
         }
-
         return ORBIS_OK;
     }
 
@@ -109,63 +111,95 @@ public:
     }
 
     void Set(u64 bits) {
-        std::unique_lock lock{m_mutex};
+        std::scoped_lock lock{m_mutex};
+        m_bits |= bits;
 
-        while (m_status != Status::Set) {
-            m_mutex.unlock();
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-            m_mutex.lock();
+        // Wake up the waiters whose pattern is satisfied in queue order. Their clear mode is
+        // applied as they are released, so it is visible to the waiters queued behind them.
+        for (auto it = m_wait_list.begin(); it != m_wait_list.end();) {
+            auto* waiter = *it;
+            if (!IsSatisfied(waiter->bits, waiter->wait_mode)) {
+                ++it;
+                continue;
+            }
+            it = m_wait_list.erase(it);
+            waiter->result_bits = m_bits;
+            ApplyClear(waiter->bits, waiter->clear_mode);
+            waiter->was_signaled = true;
+            waiter->sem.release();
         }
-
-        m_bits |= bits;
-        m_cond_var.notify_all();
     }
 
     void Clear(u64 bits) {
-        std::unique_lock lock{m_mutex};
-        while (m_status != Status::Set) {
-            m_mutex.unlock();
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-            m_mutex.lock();
-        }
-
+        std::scoped_lock lock{m_mutex};
         m_bits &= bits;
     }
 
     void Cancel(u64 setPattern, int* numWaitThreads) {
-        std::unique_lock lock{m_mutex};
-
-        while (m_status != Status::Set) {
-            m_mutex.unlock();
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-            m_mutex.lock();
+        std::scoped_lock lock{m_mutex};
+        if (numWaitThreads) {
+            *numWaitThreads = static_cast<int>(m_wait_list.size());
+        }
+        m_bits = setPattern;
+        for (auto* waiter : m_wait_list) {
+            waiter->result_bits = setPattern;
+            waiter->was_canceled = true;
+            waiter->sem.release();
         }
+        m_wait_list.clear();
+    }
 
-        if (numWaitThreads) {
-            *numWaitThreads = m_waiting_threads;
+private:
+    struct WaitingThread {
+        BinarySemaphore sem;
+        u32 priority;
+        u64 bits;
+        u64 result_bits{};
+        WaitMode wait_mode;
+        ClearMode clear_mode;
+        bool was_signaled{};
+        bool was_canceled{};
+
+        explicit WaitingThread(u64 bits, WaitMode wait_mode, ClearMode clear_mode,
+                               QueueMode queue_mode)
+            : sem{0}, priority{0}, bits{bits}, wait_mode{wait_mode}, clear_mode{clear_mode} {
+            // Retrieve calling thread priority for sorting into waiting threads list.
+            if (queue_mode == QueueMode::ThreadPrio) {
+                priority = g_curthread->attr.prio;
+            }
         }
+    };
 
-        m_status = Status::Canceled;
-        m_bits = setPattern;
+    using WaitList = std::list<WaitingThread*>;
 
-        m_cond_var.notify_all();
+    [[nodiscard]] bool IsSatisfied(u64 bits, WaitMode wait_mode) const {
+        return wait_mode == WaitMode::And ? (m_bits & bits) == bits : (m_bits & bits) != 0;
+    }
 
-        while (m_waiting_threads > 0) {
-            m_mutex.unlock();
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-            m_mutex.lock();
+    void ApplyClear(u64 bits, ClearMode clear_mode) {
+        if (clear_mode == ClearMode::All) {
+            m_bits = 0;
+        } else if (clear_mode == ClearMode::Bits) {
+            m_bits &= ~bits;
         }
-
-        m_status = Status::Set;
     }
 
-private:
-    enum class Status { Set, Canceled, Deleted };
+    WaitList::iterator AddWaiter(WaitingThread* waiter) {
+        // Insert at the end of the list for FIFO order.
+        if (m_queue_mode == QueueMode::Fifo) {
+            m_wait_list.push_back(waiter);
+            return --m_wait_list.end();
+        }
+        // Find the first with lower priority (greater number) than us and insert right before it.
+        auto it = m_wait_list.begin();
+        while (it != m_wait_list.end() && (*it)->priority <= waiter->priority) {
+            ++it;
+        }
+        return m_wait_list.insert(it, waiter);
+    }
 
     std::mutex m_mutex;
-    std::condition_variable m_cond_var;
-    Status m_status = Status::Set;
-    int m_waiting_threads = 0;
+    WaitList m_wait_list;
     std::string m_name;
     ThreadMode m_thread_mode = ThreadMode::Single;
     QueueMode m_queue_mode = QueueMode::Fifo;
@@ -3,6 +3,7 @@
 
 #include <thread>
 #include "common/assert.h"
+#include "common/thread.h"
 #include "common/types.h"
 #include "core/libraries/kernel/kernel.h"
 #include "core/libraries/kernel/posix_error.h"
@@ -138,7 +139,7 @@ int PthreadMutex::SelfTryLock() {
 int PthreadMutex::SelfLock(const OrbisKernelTimespec* abstime, u64 usec) {
     const auto DoSleep = [&] {
         if (abstime == THR_RELTIME) {
-            std::this_thread::sleep_for(std::chrono::microseconds(usec));
+            Common::AccurateSleep(std::chrono::microseconds(usec), nullptr, false);
             return POSIX_ETIMEDOUT;
         } else {
             if (abstime->tv_sec < 0 || abstime->tv_nsec < 0 || abstime->tv_nsec >= 1000000000) {
@@ -208,6 +208,7 @@ static void RunThread(void* arg) {
 
     /* Run the current thread's start routine with argument: */
     curthread->native_thr.Initialize();
+    curthread->native_thr.SetPriority(curthread->attr.prio);
     void* ret = Core::ExecuteGuest(curthread->start_routine, curthread->arg);
 
     /* Remove thread from tracking */
@@ -457,13 +458,14 @@ int PS4_SYSV_ABI posix_pthread_setschedparam(PthreadT pthread, SchedPolicy polic
     if (pthread->attr.sched_policy == policy &&
         (policy == SchedPolicy::Other || pthread->attr.prio == param->sched_priority)) {
         pthread->attr.prio = param->sched_priority;
+        pthread->native_thr.SetPriority(pthread->attr.prio);
         pthread->lock.unlock();
         return 0;
     }
 
-    // TODO: _thr_setscheduler
     pthread->attr.sched_policy = policy;
     pthread->attr.prio = param->sched_priority;
+    pthread->native_thr.SetPriority(pthread->attr.prio);
     pthread->lock.unlock();
     return 0;
 }
@@ -488,11 +490,9 @@ int PS4_SYSV_ABI posix_pthread_setprio(PthreadT thread, int prio) {
         return ret;
     }
 
-    if (thread->attr.sched_policy == SchedPolicy::Other || thread->attr.prio == prio) {
-        thread->attr.prio = prio;
-    } else {
-        // TODO: _thr_setscheduler
+    if (thread->attr.prio != prio) {
         thread->attr.prio = prio;
+        thread->native_thr.SetPriority(prio);
     }
 
     thread->lock.unlock();
@@ -535,10 +535,6 @@ int PS4_SYSV_ABI posix_pthread_setcancelstate(PthreadCancelState state,
 }
 
 int Pthread::SetAffinity(const Cpuset* cpuset) {
-    const auto processor_count = std::thread::hardware_concurrency();
-    if (processor_count < 8) {
-        return 0;
-    }
     if (cpuset == nullptr) {
         return POSIX_EINVAL;
     }
@@ -548,34 +544,11 @@ int Pthread::SetAffinity(const Cpuset* cpuset) {
         return POSIX_ESRCH;
     }
 
-    // We don't use this currently because some games gets performance problems
-    // when applying affinity even on strong hardware
-    /*
-    u64 mask = cpuset->bits;
-    #ifdef _WIN64
-        DWORD_PTR affinity_mask = static_cast<DWORD_PTR>(mask);
-        if (!SetThreadAffinityMask(reinterpret_cast<HANDLE>(handle), affinity_mask)) {
-            return POSIX_EINVAL;
-        }
-
-    #elif defined(__linux__)
-        cpu_set_t cpu_set;
-        CPU_ZERO(&cpu_set);
-
-        u64 mask = cpuset->bits;
-        for (int cpu = 0; cpu < std::min(64, CPU_SETSIZE); ++cpu) {
-            if (mask & (1ULL << cpu)) {
-                CPU_SET(cpu, &cpu_set);
-            }
-        }
-
-        int result =
-            pthread_setaffinity_np(static_cast<pthread_t>(handle), sizeof(cpu_set_t), &cpu_set);
-        if (result != 0) {
-            return POSIX_EINVAL;
-        }
-    #endif
-    */
+    // Guest masks are applied 1:1 only through the configured guest to host core mapping, some
+    // games lose performance when their masks pin threads to arbitrary host processors.
+    if (native_thr.SetAffinity(cpuset->bits) != 0) {
+        return POSIX_EINVAL;
+    }
     return 0;
 }
 
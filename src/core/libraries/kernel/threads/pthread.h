@@ -186,7 +186,7 @@ struct PthreadRwlockAttr {
 using PthreadRwlockAttrT = PthreadRwlockAttr*;
 
 struct PthreadRwlock {
-    std::shared_timed_mutex lock;
+    TimedRwLock lock;
     Pthread* owner;
 
     int Wrlock(const OrbisKernelTimespec* abstime);
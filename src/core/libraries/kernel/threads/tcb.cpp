@@ -78,6 +78,11 @@ void TcbDtor(Core::Tcb* oldtls) {
     }
 
     delete[] dtv_table;
+
+    // Return the static TLS and TCB block to the linker, which keeps it for the next thread.
+    if (!linker->IsPrimaryTls(tls_base)) {
+        linker->FreeTlsForNonPrimaryThread(const_cast<u8*>(tls_base));
+    }
 }
 
 struct TlsIndex {
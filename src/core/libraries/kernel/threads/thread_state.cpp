@@ -72,6 +72,7 @@ void ThreadState::TryCollect(Pthread* thread) {
 
 Pthread* ThreadState::Alloc(Pthread* curthread) {
     Pthread* thread = nullptr;
+    SleepQueue* sleepqueue = nullptr;
     if (curthread != nullptr) {
         if (GcNeeded()) {
             Collect(curthread);
@@ -80,6 +81,8 @@ Pthread* ThreadState::Alloc(Pthread* curthread) {
             std::scoped_lock lk{free_thread_lock};
             thread = free_threads.back();
             free_threads.pop_back();
+            // A cached thread keeps the sleep queue it owned when it exited.
+            sleepqueue = thread->sleepqueue;
         }
     }
     if (thread == nullptr) {
@@ -106,8 +109,9 @@ Pthread* ThreadState::Alloc(Pthread* curthread) {
         std::memset(static_cast<void*>(thread), 0, sizeof(Pthread));
         std::construct_at(thread);
         thread->tcb = tcb;
-        thread->sleepqueue = new SleepQueue{};
+        thread->sleepqueue = sleepqueue ? sleepqueue : new SleepQueue{};
     } else {
+        delete sleepqueue;
         thread_heap.Free(thread);
         total_threads.fetch_sub(1);
         thread = nullptr;
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <atomic>
+#include <chrono>
 #include <thread>
 
 #include "common/assert.h"
@@ -30,6 +32,40 @@ namespace Libraries::Kernel {
 static u64 initial_ptc;
 static std::unique_ptr<Common::NativeClock> clock;
 
+// Guest clock reads convert the TSC with a mapping computed once instead of calling the host
+// clocks. Realtime is the monotonic clock plus an offset that is resynced every second to follow
+// adjustments of the host time.
+static Common::ClockPage monotonic_page;
+static std::atomic<s64> realtime_offset;
+static std::atomic<u64> realtime_sync_tsc;
+
+static u64 HostMonotonicNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+static s64 HostRealtimeNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+static u64 MonotonicNs() {
+    return monotonic_page.GetTimeNS(clock->GetUptime());
+}
+
+static u64 RealtimeNs() {
+    const u64 tsc = clock->GetUptime();
+    u64 last_sync = realtime_sync_tsc.load(std::memory_order_relaxed);
+    if (tsc - last_sync > clock->GetTscFrequency() &&
+        realtime_sync_tsc.compare_exchange_strong(last_sync, tsc, std::memory_order_relaxed)) {
+        realtime_offset.store(HostRealtimeNs() - static_cast<s64>(monotonic_page.GetTimeNS(tsc)),
+                              std::memory_order_relaxed);
+    }
+    return monotonic_page.GetTimeNS(tsc) + realtime_offset.load(std::memory_order_relaxed);
+}
+
 u64 PS4_SYSV_ABI sceKernelGetTscFrequency() {
     return clock->GetTscFrequency();
 }
@@ -132,50 +168,34 @@ s32 PS4_SYSV_ABI posix_clock_gettime(u32 clock_id, OrbisKernelTimespec* ts) {
         clock_id = ORBIS_CLOCK_MONOTONIC;
     }
 
-#ifdef _WIN32
-    static const auto FileTimeTo100Ns = [](FILETIME& ft) { return *reinterpret_cast<u64*>(&ft); };
     switch (clock_id) {
     case ORBIS_CLOCK_REALTIME:
-    case ORBIS_CLOCK_REALTIME_PRECISE: {
-        FILETIME ft;
-        GetSystemTimePreciseAsFileTime(&ft);
-        static constexpr u64 DeltaEpochIn100ns = 116444736000000000ULL;
-        const u64 ns = FileTimeTo100Ns(ft) - DeltaEpochIn100ns;
-        ts->tv_sec = ns / 10'000'000;
-        ts->tv_nsec = (ns % 10'000'000) * 100;
-        return 0;
-    }
-    case ORBIS_CLOCK_SECOND:
-    case ORBIS_CLOCK_REALTIME_FAST: {
-        FILETIME ft;
-        GetSystemTimeAsFileTime(&ft);
-        static constexpr u64 DeltaEpochIn100ns = 116444736000000000ULL;
-        const u64 ns = FileTimeTo100Ns(ft) - DeltaEpochIn100ns;
-        ts->tv_sec = ns / 10'000'000;
-        ts->tv_nsec = (ns % 10'000'000) * 100;
+    case ORBIS_CLOCK_REALTIME_PRECISE:
+    case ORBIS_CLOCK_REALTIME_FAST:
+    case ORBIS_CLOCK_SECOND: {
+        const u64 ns = RealtimeNs();
+        ts->tv_sec = ns / 1'000'000'000;
+        ts->tv_nsec = ns % 1'000'000'000;
         return 0;
     }
     case ORBIS_CLOCK_UPTIME:
     case ORBIS_CLOCK_UPTIME_PRECISE:
+    case ORBIS_CLOCK_UPTIME_FAST:
     case ORBIS_CLOCK_MONOTONIC:
     case ORBIS_CLOCK_MONOTONIC_PRECISE:
-    case ORBIS_CLOCK_UPTIME_FAST:
     case ORBIS_CLOCK_MONOTONIC_FAST: {
-        static LARGE_INTEGER pf = [] {
-            LARGE_INTEGER res{};
-            QueryPerformanceFrequency(&pf);
-            return res;
-        }();
-
-        LARGE_INTEGER pc{};
-        if (!QueryPerformanceCounter(&pc)) {
-            SetPosixErrno(EFAULT);
-            return -1;
-        }
-        ts->tv_sec = pc.QuadPart / pf.QuadPart;
-        ts->tv_nsec = ((pc.QuadPart % pf.QuadPart) * 1000'000'000) / pf.QuadPart;
+        const u64 ns = MonotonicNs();
+        ts->tv_sec = ns / 1'000'000'000;
+        ts->tv_nsec = ns % 1'000'000'000;
         return 0;
     }
+    default:
+        break;
+    }
+
+#ifdef _WIN32
+    static const auto FileTimeTo100Ns = [](FILETIME& ft) { return *reinterpret_cast<u64*>(&ft); };
+    switch (clock_id) {
     case ORBIS_CLOCK_THREAD_CPUTIME_ID: {
         FILETIME ct, et, kt, ut;
         if (!GetThreadTimes(GetCurrentThread(), &ct, &et, &kt, &ut)) {
@@ -216,32 +236,6 @@ s32 PS4_SYSV_ABI posix_clock_gettime(u32 clock_id, OrbisKernelTimespec* ts) {
 #else
     clockid_t pclock_id;
     switch (clock_id) {
-    case ORBIS_CLOCK_REALTIME:
-    case ORBIS_CLOCK_REALTIME_PRECISE:
-        pclock_id = CLOCK_REALTIME;
-        break;
-    case ORBIS_CLOCK_SECOND:
-    case ORBIS_CLOCK_REALTIME_FAST:
-#ifdef CLOCK_REALTIME_COARSE
-        pclock_id = CLOCK_REALTIME_COARSE;
-#else
-        pclock_id = CLOCK_REALTIME;
-#endif
-        break;
-    case ORBIS_CLOCK_UPTIME:
-    case ORBIS_CLOCK_UPTIME_PRECISE:
-    case ORBIS_CLOCK_MONOTONIC:
-    case ORBIS_CLOCK_MONOTONIC_PRECISE:
-        pclock_id = CLOCK_MONOTONIC;
-        break;
-    case ORBIS_CLOCK_UPTIME_FAST:
-    case ORBIS_CLOCK_MONOTONIC_FAST:
-#ifdef CLOCK_MONOTONIC_COARSE
-        pclock_id = CLOCK_MONOTONIC_COARSE;
-#else
-        pclock_id = CLOCK_MONOTONIC;
-#endif
-        break;
     case ORBIS_CLOCK_THREAD_CPUTIME_ID:
         pclock_id = CLOCK_THREAD_CPUTIME_ID;
         break;
@@ -392,23 +386,12 @@ s32 PS4_SYSV_ABI sceKernelClockGetres(const u32 clock_id, OrbisKernelTimespec* r
 }
 
 s32 PS4_SYSV_ABI posix_gettimeofday(OrbisKernelTimeval* tp, OrbisKernelTimezone* tz) {
-#ifdef _WIN64
     if (tp) {
-        FILETIME filetime;
-        GetSystemTimePreciseAsFileTime(&filetime);
-
-        constexpr u64 UNIX_TIME_START = 0x295E9648864000;
-        constexpr u64 TICKS_PER_SECOND = 1000000;
-
-        u64 ticks = filetime.dwHighDateTime;
-        ticks <<= 32;
-        ticks |= filetime.dwLowDateTime;
-        ticks /= 10;
-        ticks -= UNIX_TIME_START;
-
-        tp->tv_sec = ticks / TICKS_PER_SECOND;
-        tp->tv_usec = ticks % TICKS_PER_SECOND;
+        const u64 us = RealtimeNs() / 1'000;
+        tp->tv_sec = us / 1'000'000;
+        tp->tv_usec = us % 1'000'000;
     }
+#ifdef _WIN64
     if (tz) {
         static int tzflag = 0;
         if (!tzflag) {
@@ -420,21 +403,16 @@ s32 PS4_SYSV_ABI posix_gettimeofday(OrbisKernelTimeval* tp, OrbisKernelTimezone*
     }
     return 0;
 #else
-    struct timezone tzz;
-    timeval tv;
-    const auto ret = gettimeofday(&tv, &tzz);
-    if (tp) {
-        tp->tv_sec = tv.tv_sec;
-        tp->tv_usec = tv.tv_usec;
-    }
     if (tz) {
+        struct timezone tzz;
+        timeval tv;
+        if (gettimeofday(&tv, &tzz) < 0) {
+            SetPosixErrno(errno);
+            return -1;
+        }
         tz->tz_dsttime = tzz.tz_dsttime;
         tz->tz_minuteswest = tzz.tz_minuteswest;
     }
-    if (ret < 0) {
-        SetPosixErrno(errno);
-        return -1;
-    }
     return 0;
 #endif
 }
@@ -529,6 +507,9 @@ s32 PS4_SYSV_ABI sceKernelSettimeofday(OrbisKernelTimeval* _tv, OrbisKernelTimez
 void RegisterTime(Core::Loader::SymbolsResolver* sym) {
     clock = std::make_unique<Common::NativeClock>();
     initial_ptc = clock->GetUptime();
+    monotonic_page = clock->MapHostClock(HostMonotonicNs);
+    realtime_sync_tsc = monotonic_page.base_tsc;
+    realtime_offset = HostRealtimeNs() - static_cast<s64>(monotonic_page.base_ns);
 
     // POSIX
     LIB_FUNCTION("yS8U2TGCe1A", "libkernel", 1, "libkernel", posix_nanosleep);
@@ -3,6 +3,7 @@
 
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/memory_copy.h"
 #include "core/libraries/error_codes.h"
 #include "core/libraries/libs.h"
 #include "libc_internal_memory.h"
@@ -10,10 +11,19 @@
 namespace Libraries::LibcInternal {
 
 void* PS4_SYSV_ABI internal_memset(void* s, int c, size_t n) {
+    if (n >= Common::NonTemporalThreshold) [[unlikely]] {
+        Common::StreamFill(s, static_cast<u8>(c), n);
+        return s;
+    }
     return std::memset(s, c, n);
 }
 
 void* PS4_SYSV_ABI internal_memcpy(void* dest, const void* src, size_t n) {
+    // Smaller copies stay with the host libc, which already picks ERMS or vector copies.
+    if (n >= Common::NonTemporalThreshold) [[unlikely]] {
+        Common::StreamCopy(dest, src, n);
+        return dest;
+    }
     return std::memcpy(dest, src, n);
 }
 
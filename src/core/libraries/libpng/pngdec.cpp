@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <vector>
 #include <png.h>
 #include "common/assert.h"
 #include "common/logging/log.h"
@@ -158,20 +159,20 @@ s32 PS4_SYSV_ABI scePngDecDecode(OrbisPngDecHandle handle, const OrbisPngDecDeco
         png_set_add_alpha(pngh->png_ptr, param->alpha_value, PNG_FILLER_AFTER);
     }
 
-    const s32 pass = png_set_interlace_handling(pngh->png_ptr);
+    png_set_interlace_handling(pngh->png_ptr);
     png_read_update_info(pngh->png_ptr, pngh->info_ptr);
 
     const s32 num_channels = png_get_channels(pngh->png_ptr, pngh->info_ptr);
     const s32 horizontal_bytes = num_channels * width;
     const s32 stride = param->image_pitch > 0 ? param->image_pitch : horizontal_bytes;
 
-    for (int j = 0; j < pass; j++) {
-        auto ptr = reinterpret_cast<png_bytep>(param->image_mem_addr);
-        for (int y = 0; y < height; y++) {
-            png_read_row(pngh->png_ptr, ptr, nullptr);
-            ptr += stride;
-        }
+    // Rows are decoded straight into the guest image, libpng runs the interlace passes and the
+    // pixel format transforms set above on each row as it goes.
+    std::vector<png_bytep> rows(height);
+    for (u32 y = 0; y < height; y++) {
+        rows[y] = reinterpret_cast<png_bytep>(param->image_mem_addr) + u64(y) * stride;
     }
+    png_read_image(pngh->png_ptr, rows.data());
 
     return (width > 32767 || height > 32767) ? 0 : (width << 16) | height;
 }
@@ -3,10 +3,47 @@
 
 #pragma once
 
+#include "common/debug.h"
+#include "common/string_literal.h"
+#include "core/libraries/hle_profiler.h"
 #include "core/loader/elf.h"
 #include "core/loader/symbols_resolver.h"
 #include "core/tls.h"
 
+namespace Libraries {
+
+#if DETAILED_PROFILING || defined(ENABLE_HLE_PROFILER)
+template <class F, F f, StringLiteral name>
+struct ProfiledHostCallWrapperImpl;
+
+/// Host call wrapper that opens a profiler zone named after the library and function, and counts
+/// the call for the HLE profiler.
+template <class ReturnType, class... Args, PS4_SYSV_ABI ReturnType (*func)(Args...),
+          StringLiteral name>
+struct ProfiledHostCallWrapperImpl<PS4_SYSV_ABI ReturnType (*)(Args...), func, name> {
+    static ReturnType PS4_SYSV_ABI wrap(Args... args) {
+#if DETAILED_PROFILING
+        static constexpr tracy::SourceLocationData srcloc{name.value, name.value, TracyFile,
+                                                          TracyLine, HleMarkerColor};
+        tracy::ScopedZone zone{&srcloc, true};
+#endif
+#ifdef ENABLE_HLE_PROFILER
+        static HleProfiler::CallStats stats{name.value};
+        HleProfiler::CallScope scope{stats};
+#endif
+        return func(args...);
+    }
+};
+
+#define HLE_CALL(function, lib)                                                                    \
+    (Libraries::ProfiledHostCallWrapperImpl<decltype(&(function)), function,                       \
+                                            lib ":" #function>::wrap)
+#else
+#define HLE_CALL(function, lib) HOST_CALL(function)
+#endif
+
+} // namespace Libraries
+
 #define LIB_FUNCTION(nid, lib, libversion, mod, function)                                          \
     {                                                                                              \
         Core::Loader::SymbolResolver sr{};                                                         \
@@ -15,7 +52,7 @@
         sr.library_version = libversion;                                                           \
         sr.module = mod;                                                                           \
         sr.type = Core::Loader::SymbolType::Function;                                              \
-        auto func = reinterpret_cast<u64>(HOST_CALL(function));                                    \
+        auto func = reinterpret_cast<u64>(HLE_CALL(function, lib));                                \
         sym->AddSymbol(sr, func);                                                                  \
     }
 
@@ -631,6 +631,7 @@ int PS4_SYSV_ABI sceNetEpollControl(OrbisNetId epollid, OrbisNetEpollFlag op, Or
     LOG_WARNING(Lib_Net, "called, epollid = {} ({}), op = {}, id = {}", epollid, epoll->name,
                 magic_enum::enum_name(op), id);
 
+    std::scoped_lock lock{epoll->mutex};
     auto find_id = [&](OrbisNetId id) {
         return std::ranges::find_if(epoll->events, [&](auto& el) { return el.first == id; });
     };
@@ -781,6 +782,7 @@ int PS4_SYSV_ABI sceNetEpollDestroy(OrbisNetId epollid) {
 
     LOG_DEBUG(Lib_Net, "called, epollid = {} ({})", epollid, file->epoll->name);
 
+    std::scoped_lock lock{file->epoll->mutex};
     file->epoll->Destroy();
 
     return ORBIS_OK;
@@ -797,21 +799,37 @@ int PS4_SYSV_ABI sceNetEpollWait(OrbisNetId epollid, OrbisNetEpollEvent* events,
     LOG_DEBUG(Lib_Net, "called, epollid = {} ({}), maxevents = {}, timeout = {}", epollid,
               epoll->name, maxevents, timeout);
 
-    int sockets_waited_on = (epoll->events.size() - epoll->async_resolutions.size()) > 0;
+    if (maxevents <= 0) {
+        *sceNetErrnoLoc() = ORBIS_NET_EINVAL;
+        return ORBIS_NET_ERROR_EINVAL;
+    }
+
+    // Sockets are always waited on through the host epoll, so the guest thread sleeps until one
+    // is ready or the timeout passes even when none are registered. Pending resolutions are
+    // reported right away, only polling the sockets.
+    bool has_resolutions;
+    {
+        std::scoped_lock lock{epoll->mutex};
+        has_resolutions = !epoll->async_resolutions.empty();
+    }
+    if (has_resolutions) {
+        timeout = 0;
+    }
 
-    std::vector<epoll_event> native_events{static_cast<size_t>(maxevents)};
-    int result = ORBIS_OK;
-    if (sockets_waited_on) {
+    thread_local std::vector<epoll_event> native_events;
+    if (native_events.size() < static_cast<size_t>(maxevents)) {
+        native_events.resize(maxevents);
+    }
 #ifdef __linux__
-        const timespec epoll_timeout{.tv_sec = timeout / 1000000,
-                                     .tv_nsec = (timeout % 1000000) * 1000};
-        result = epoll_pwait2(epoll->epoll_fd, native_events.data(), maxevents,
+    const timespec epoll_timeout{.tv_sec = timeout / 1000000,
+                                 .tv_nsec = (timeout % 1000000) * 1000};
+    int result = epoll_pwait2(epoll->epoll_fd, native_events.data(), maxevents,
                               timeout < 0 ? nullptr : &epoll_timeout, nullptr);
 #else
-        result = epoll_wait(epoll->epoll_fd, native_events.data(), maxevents,
-                            timeout < 0 ? timeout : timeout / 1000);
+    // Round up so short timeouts do not turn into a spinning poll.
+    int result = epoll_wait(epoll->epoll_fd, native_events.data(), maxevents,
+                            timeout < 0 ? timeout : (timeout + 999) / 1000);
 #endif
-    }
 
     int i = 0;
 
@@ -833,51 +851,54 @@ int PS4_SYSV_ABI sceNetEpollWait(OrbisNetId epollid, OrbisNetEpollEvent* events,
         }
     } else if (result == 0) {
         LOG_TRACE(Lib_Net, "timed out");
-    } else {
-        for (; i < result; ++i) {
-            const auto& current_event = native_events[i];
-            LOG_DEBUG(Lib_Net, "native_event[{}] = ( .events = {}, .data = {:#x} )", i,
-                      current_event.events, current_event.data.u64);
-            const auto it = std::ranges::find_if(
-                epoll->events, [&](auto& el) { return el.first == current_event.data.fd; });
-            ASSERT(it != epoll->events.end());
-            events[i] = {
-                .events = ConvertEpollEventsOut(current_event.events),
-                .ident = static_cast<u64>(current_event.data.fd),
-                .data = it->second.data,
-            };
-            LOG_DEBUG(Lib_Net, "event[{}] = ( .events = {:#x}, .ident = {}, .data = {:#x} )", i,
-                      events[i].events, events[i].ident, events[i].data.data_u64);
-        }
     }
 
-    if (result >= 0) {
-        while (!epoll->async_resolutions.empty()) {
-            if (i == maxevents) {
-                break;
-            }
-            auto rid = epoll->async_resolutions.front();
-            epoll->async_resolutions.pop_front();
-            auto file = FDTable::Instance()->GetResolver(rid);
-            if (!file) {
-                LOG_ERROR(Lib_Net, "resolver {} does not exist", rid);
-                continue;
-            }
+    std::scoped_lock lock{epoll->mutex};
+    for (int n = 0; n < result; ++n) {
+        const auto& current_event = native_events[n];
+        LOG_DEBUG(Lib_Net, "native_event[{}] = ( .events = {}, .data = {:#x} )", n,
+                  current_event.events, current_event.data.u64);
+        const auto it = std::ranges::find_if(
+            epoll->events, [&](auto& el) { return el.first == current_event.data.fd; });
+        if (it == epoll->events.end()) {
+            // The socket was removed by another thread while this one was waiting.
+            continue;
+        }
+        events[i] = {
+            .events = ConvertEpollEventsOut(current_event.events),
+            .ident = static_cast<u64>(current_event.data.fd),
+            .data = it->second.data,
+        };
+        LOG_DEBUG(Lib_Net, "event[{}] = ( .events = {:#x}, .ident = {}, .data = {:#x} )", i,
+                  events[i].events, events[i].ident, events[i].data.data_u64);
+        ++i;
+    }
 
-            file->resolver->Resolve();
-
-            const auto it =
-                std::ranges::find_if(epoll->events, [&](auto& el) { return el.first == rid; });
-            ASSERT(it != epoll->events.end());
-            events[i] = {
-                .events = ORBIS_NET_EPOLLDESCID,
-                .ident = static_cast<u64>(rid),
-                .data = it->second.data,
-            };
-            LOG_DEBUG(Lib_Net, "event[{}] = ( .events = {:#x}, .ident = {}, .data = {:#x} )", i,
-                      events[i].events, events[i].ident, events[i].data.data_u64);
-            ++i;
+    while (!epoll->async_resolutions.empty()) {
+        if (i == maxevents) {
+            break;
         }
+        auto rid = epoll->async_resolutions.front();
+        epoll->async_resolutions.pop_front();
+        auto file = FDTable::Instance()->GetResolver(rid);
+        if (!file) {
+            LOG_ERROR(Lib_Net, "resolver {} does not exist", rid);
+            continue;
+        }
+
+        file->resolver->Resolve();
+
+        const auto it =
+            std::ranges::find_if(epoll->events, [&](auto& el) { return el.first == rid; });
+        ASSERT(it != epoll->events.end());
+        events[i] = {
+            .events = ORBIS_NET_EPOLLDESCID,
+            .ident = static_cast<u64>(rid),
+            .data = it->second.data,
+        };
+        LOG_DEBUG(Lib_Net, "event[{}] = ( .events = {:#x}, .ident = {}, .data = {:#x} )", i,
+                  events[i].events, events[i].ident, events[i].data.data_u64);
+        ++i;
     }
 
     return i;
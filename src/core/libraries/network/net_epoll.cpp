@@ -39,34 +39,4 @@ u32 ConvertEpollEventsOut(u32 epoll_events) {
     return ret;
 }
 
-int EpollTable::CreateHandle(const char* name) {
-    std::scoped_lock lock{m_mutex};
-
-    if (auto it = std::ranges::find_if(epolls, [](const Epoll& e) { return e.Destroyed(); });
-        it != epolls.end()) {
-        *it = Epoll(name);
-        const auto ret = std::distance(epolls.begin(), it);
-        LOG_DEBUG(Lib_Net, "epollid = {}", ret);
-        return ret;
-    } else {
-        epolls.emplace_back(name);
-        const auto ret = epolls.size() - 1;
-        LOG_DEBUG(Lib_Net, "epollid = {}", ret);
-        return ret;
-    }
-}
-
-void EpollTable::DeleteHandle(int d) {
-    UNREACHABLE();
-}
-
-Epoll* EpollTable::GetEpoll(int epollid) {
-    std::scoped_lock lock{m_mutex};
-    if (epollid >= epolls.size() || epolls[epollid].Destroyed()) {
-        return nullptr;
-    }
-
-    return &epolls[epollid];
-}
-
 } // namespace Libraries::Net
@@ -28,6 +28,8 @@ using epoll_handle = int;
 #endif
 
 struct Epoll {
+    /// Guards the registered events, which may change while another thread waits.
+    std::mutex mutex;
     std::vector<std::pair<u32 /*netId*/, OrbisNetEpollEvent>> events{};
     std::string name;
     epoll_handle epoll_fd;
@@ -68,18 +70,4 @@ private:
 u32 ConvertEpollEventsIn(u32 orbis_events);
 u32 ConvertEpollEventsOut(u32 epoll_events);
 
-class EpollTable {
-public:
-    EpollTable() = default;
-    virtual ~EpollTable() = default;
-
-    int CreateHandle(const char* name);
-    void DeleteHandle(int d);
-    Epoll* GetEpoll(int d);
-
-private:
-    std::vector<Epoll> epolls;
-    std::mutex m_mutex;
-};
-
 } // namespace Libraries::Net
\ No newline at end of file
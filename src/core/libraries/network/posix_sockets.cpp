@@ -185,16 +185,16 @@ int PosixSocket::Listen(int backlog) {
 }
 
 int PosixSocket::SendMessage(const OrbisNetMsghdr* msg, int flags) {
-    std::scoped_lock lock{m_mutex};
+    std::scoped_lock lock{send_mutex};
 #ifdef _WIN32
     DWORD bytesSent = 0;
-    LPFN_WSASENDMSG wsasendmsg = nullptr;
-    GUID guid = WSAID_WSASENDMSG;
-    DWORD bytes = 0;
-
-    if (WSAIoctl(sock, SIO_GET_EXTENSION_FUNCTION_POINTER, &guid, sizeof(guid), &wsasendmsg,
-                 sizeof(wsasendmsg), &bytes, nullptr, nullptr) != 0) {
-        return ConvertReturnErrorCode(-1);
+    if (!wsasendmsg) {
+        GUID guid = WSAID_WSASENDMSG;
+        DWORD bytes = 0;
+        if (WSAIoctl(sock, SIO_GET_EXTENSION_FUNCTION_POINTER, &guid, sizeof(guid), &wsasendmsg,
+                     sizeof(wsasendmsg), &bytes, nullptr, nullptr) != 0) {
+            return ConvertReturnErrorCode(-1);
+        }
     }
 
     int res = wsasendmsg(sock, reinterpret_cast<LPWSAMSG>(const_cast<OrbisNetMsghdr*>(msg)), flags,
@@ -212,7 +212,7 @@ int PosixSocket::SendMessage(const OrbisNetMsghdr* msg, int flags) {
 
 int PosixSocket::SendPacket(const void* msg, u32 len, int flags, const OrbisNetSockaddr* to,
                             u32 tolen) {
-    std::scoped_lock lock{m_mutex};
+    std::scoped_lock lock{send_mutex};
     if (to != nullptr) {
         sockaddr addr;
         convertOrbisNetSockaddrToPosix(to, &addr);
@@ -226,13 +226,13 @@ int PosixSocket::SendPacket(const void* msg, u32 len, int flags, const OrbisNetS
 int PosixSocket::ReceiveMessage(OrbisNetMsghdr* msg, int flags) {
     std::scoped_lock lock{receive_mutex};
 #ifdef _WIN32
-    LPFN_WSARECVMSG wsarecvmsg = nullptr;
-    GUID guid = WSAID_WSARECVMSG;
-    DWORD bytes = 0;
-
-    if (WSAIoctl(sock, SIO_GET_EXTENSION_FUNCTION_POINTER, &guid, sizeof(guid), &wsarecvmsg,
-                 sizeof(wsarecvmsg), &bytes, nullptr, nullptr) != 0) {
-        return ConvertReturnErrorCode(-1);
+    if (!wsarecvmsg) {
+        GUID guid = WSAID_WSARECVMSG;
+        DWORD bytes = 0;
+        if (WSAIoctl(sock, SIO_GET_EXTENSION_FUNCTION_POINTER, &guid, sizeof(guid), &wsarecvmsg,
+                     sizeof(wsarecvmsg), &bytes, nullptr, nullptr) != 0) {
+            return ConvertReturnErrorCode(-1);
+        }
     }
 
     DWORD bytesReceived = 0;
@@ -84,6 +84,7 @@ struct Socket {
     virtual std::optional<net_socket> Native() = 0;
     std::mutex m_mutex;
     std::mutex receive_mutex;
+    std::mutex send_mutex;
 };
 
 struct PosixSocket : public Socket {
@@ -98,6 +99,11 @@ struct PosixSocket : public Socket {
     int sockopt_ip_maxttl = 0;
     int sockopt_tcp_mss_to_advertise = 0;
     int socket_type;
+#ifdef _WIN32
+    /// Message functions of the socket provider, looked up on first use.
+    LPFN_WSASENDMSG wsasendmsg = nullptr;
+    LPFN_WSARECVMSG wsarecvmsg = nullptr;
+#endif
     explicit PosixSocket(int domain, int type, int protocol)
         : Socket(domain, type, protocol), sock(socket(domain, type, protocol)) {
         socket_type = type;
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 #include "core/libraries/libs.h"
@@ -10,6 +12,7 @@
 #include "core/libraries/ngs2/ngs2_geom.h"
 #include "core/libraries/ngs2/ngs2_impl.h"
 #include "core/libraries/ngs2/ngs2_pan.h"
+#include "core/libraries/ngs2/ngs2_render.h"
 #include "core/libraries/ngs2/ngs2_report.h"
 
 namespace Libraries::Ngs2 {
@@ -47,15 +50,66 @@ s32 PS4_SYSV_ABI sceNgs2ParseWaveformUser(OrbisNgs2ParseReadHandler handler, uin
     return ORBIS_OK;
 }
 
+/// Size reported for rack buffers, the host keeps the voices in its own memory.
+static size_t RackBufferSize(const OrbisNgs2RackOption& option) {
+    return 0x100 + static_cast<size_t>(option.maxVoices) * 0x100;
+}
+
+static s32 RackSetup(OrbisNgs2Handle systemHandle, u32 rackId, const OrbisNgs2RackOption* option,
+                     OrbisNgs2RackOption* outOption) {
+    if (rackId != ORBIS_NGS2_RACK_ID_SAMPLER && rackId != ORBIS_NGS2_RACK_ID_SUBMIXER &&
+        rackId != ORBIS_NGS2_RACK_ID_MASTERING) {
+        LOG_ERROR(Lib_Ngs2, "Unimplemented rack id {:#x}", rackId);
+        return ORBIS_NGS2_ERROR_INVALID_RACK_ID;
+    }
+    if (option && option->size < sizeof(OrbisNgs2RackOption)) {
+        LOG_ERROR(Lib_Ngs2, "Invalid rack option size ({})", option->size);
+        return ORBIS_NGS2_ERROR_INVALID_OPTION_SIZE;
+    }
+    if (option) {
+        *outOption = *option;
+    } else {
+        *outOption = {.size = sizeof(OrbisNgs2RackOption), .maxVoices = 1, .maxMatrices = 1,
+                      .maxPorts = 1};
+    }
+    if (outOption->maxVoices == 0) {
+        return ORBIS_NGS2_ERROR_INVALID_MAX_VOICES;
+    }
+    if (systemHandle) {
+        const Ngs2System* system = GetSystem(systemHandle);
+        if (!system) {
+            return HandleReportInvalid(systemHandle, 1);
+        }
+        outOption->maxGrainSamples = system->max_grain_samples;
+    }
+    return ORBIS_OK;
+}
+
 s32 PS4_SYSV_ABI sceNgs2RackCreate(OrbisNgs2Handle systemHandle, u32 rackId,
                                    const OrbisNgs2RackOption* option,
                                    const OrbisNgs2ContextBufferInfo* bufferInfo,
                                    OrbisNgs2Handle* outHandle) {
-    LOG_ERROR(Lib_Ngs2, "rackId = {}", rackId);
+    LOG_INFO(Lib_Ngs2, "rackId = {:#x}", rackId);
     if (!systemHandle) {
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
+    if (!bufferInfo) {
+        return ORBIS_NGS2_ERROR_INVALID_BUFFER_INFO;
+    }
+    if (!outHandle) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    OrbisNgs2RackOption rackOption;
+    if (const s32 result = RackSetup(systemHandle, rackId, option, &rackOption); result < 0) {
+        return result;
+    }
+    if (bufferInfo->hostBufferSize < RackBufferSize(rackOption)) {
+        return ORBIS_NGS2_ERROR_INVALID_BUFFER_SIZE;
+    }
+    Ngs2Rack* rack = GetSystem(systemHandle)->CreateRack(rackId, rackOption, option);
+    rack->buffer_info = *bufferInfo;
+    *outHandle = rack->Handle();
     return ORBIS_OK;
 }
 
@@ -63,55 +117,138 @@ s32 PS4_SYSV_ABI sceNgs2RackCreateWithAllocator(OrbisNgs2Handle systemHandle, u3
                                                 const OrbisNgs2RackOption* option,
                                                 const OrbisNgs2BufferAllocator* allocator,
                                                 OrbisNgs2Handle* outHandle) {
-    LOG_ERROR(Lib_Ngs2, "rackId = {}", rackId);
+    LOG_INFO(Lib_Ngs2, "rackId = {:#x}", rackId);
     if (!systemHandle) {
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
+    if (!allocator || !allocator->allocHandler) {
+        return ORBIS_NGS2_ERROR_INVALID_BUFFER_ALLOCATOR;
+    }
+    if (!outHandle) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    OrbisNgs2RackOption rackOption;
+    if (const s32 result = RackSetup(systemHandle, rackId, option, &rackOption); result < 0) {
+        return result;
+    }
+    OrbisNgs2ContextBufferInfo bufferInfo{};
+    bufferInfo.hostBufferSize = RackBufferSize(rackOption);
+    bufferInfo.userData = allocator->userData;
+    if (const s32 result = Core::ExecuteGuest(allocator->allocHandler, &bufferInfo);
+        result < 0) {
+        return result;
+    }
+    Ngs2Rack* rack = GetSystem(systemHandle)->CreateRack(rackId, rackOption, option);
+    rack->buffer_info = bufferInfo;
+    rack->host_free = allocator->freeHandler;
+    *outHandle = rack->Handle();
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackDestroy(OrbisNgs2Handle rackHandle,
                                     OrbisNgs2ContextBufferInfo* outBufferInfo) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    Ngs2Rack* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    OrbisNgs2ContextBufferInfo bufferInfo = rack->buffer_info;
+    const OrbisNgs2BufferFreeHandler hostFree = rack->host_free;
+    rack->system.DestroyRack(rack);
+    if (outBufferInfo) {
+        *outBufferInfo = bufferInfo;
+    }
+    if (hostFree) {
+        Core::ExecuteGuest(hostFree, &bufferInfo);
+    }
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackGetInfo(OrbisNgs2Handle rackHandle, OrbisNgs2RackInfo* outInfo,
                                     size_t infoSize) {
-    LOG_ERROR(Lib_Ngs2, "infoSize = {}", infoSize);
+    const Ngs2Rack* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    if (!outInfo) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    if (infoSize < sizeof(OrbisNgs2RackInfo)) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_SIZE;
+    }
+    rack->GetInfo(outInfo);
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackGetUserData(OrbisNgs2Handle rackHandle, uintptr_t* outUserData) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    const Ngs2Rack* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    if (!outUserData) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    *outUserData = rack->user_data;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackGetVoiceHandle(OrbisNgs2Handle rackHandle, u32 voiceIndex,
                                            OrbisNgs2Handle* outHandle) {
-    LOG_DEBUG(Lib_Ngs2, "(STUBBED) voiceIndex = {}", voiceIndex);
+    LOG_DEBUG(Lib_Ngs2, "voiceIndex = {}", voiceIndex);
+    const Ngs2Rack* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    if (voiceIndex >= rack->voices.size()) {
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_INDEX;
+    }
+    if (!outHandle) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    *outHandle = rack->voices[voiceIndex]->Handle();
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackLock(OrbisNgs2Handle rackHandle) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    Ngs2Rack* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    rack->system.mutex.lock();
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackQueryBufferSize(u32 rackId, const OrbisNgs2RackOption* option,
                                             OrbisNgs2ContextBufferInfo* outBufferInfo) {
-    LOG_ERROR(Lib_Ngs2, "rackId = {}", rackId);
+    LOG_INFO(Lib_Ngs2, "rackId = {:#x}", rackId);
+    if (!outBufferInfo) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    OrbisNgs2RackOption rackOption;
+    if (const s32 result = RackSetup(0, rackId, option, &rackOption); result < 0) {
+        return result;
+    }
+    outBufferInfo->hostBuffer = nullptr;
+    outBufferInfo->hostBufferSize = RackBufferSize(rackOption);
+    MemoryClear(&outBufferInfo->reserved, sizeof(outBufferInfo->reserved));
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackSetUserData(OrbisNgs2Handle rackHandle, uintptr_t userData) {
-    LOG_ERROR(Lib_Ngs2, "userData = {}", userData);
+    Ngs2Rack* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    rack->user_data = userData;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2RackUnlock(OrbisNgs2Handle rackHandle) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    Ngs2Rack* rack = GetRack(rackHandle);
+    if (!rack) {
+        return HandleReportInvalid(rackHandle, 2);
+    }
+    rack->system.mutex.unlock();
     return ORBIS_OK;
 }
 
@@ -189,6 +326,22 @@ s32 PS4_SYSV_ABI sceNgs2SystemDestroy(OrbisNgs2Handle systemHandle,
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
+    const Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    const OrbisNgs2BufferFreeHandler hostFree = system->host_free;
+    OrbisNgs2ContextBufferInfo bufferInfo;
+    const s32 result = SystemCleanup(systemHandle, &bufferInfo);
+    if (result < 0) {
+        return result;
+    }
+    if (outBufferInfo) {
+        *outBufferInfo = bufferInfo;
+    }
+    if (hostFree) {
+        Core::ExecuteGuest(hostFree, &bufferInfo);
+    }
     LOG_INFO(Lib_Ngs2, "called");
     return ORBIS_OK;
 }
@@ -200,17 +353,38 @@ s32 PS4_SYSV_ABI sceNgs2SystemEnumHandles(OrbisNgs2Handle* aOutHandle, u32 maxHa
 
 s32 PS4_SYSV_ABI sceNgs2SystemEnumRackHandles(OrbisNgs2Handle systemHandle,
                                               OrbisNgs2Handle* aOutHandle, u32 maxHandles) {
-    LOG_ERROR(Lib_Ngs2, "maxHandles = {}", maxHandles);
+    LOG_DEBUG(Lib_Ngs2, "maxHandles = {}", maxHandles);
     if (!systemHandle) {
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
-    return ORBIS_OK;
+    Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    std::scoped_lock lk{system->mutex};
+    const u32 numRacks = static_cast<u32>(system->racks.size());
+    if (aOutHandle) {
+        for (u32 i = 0; i < std::min(numRacks, maxHandles); i++) {
+            aOutHandle[i] = system->racks[i]->Handle();
+        }
+    }
+    return static_cast<s32>(numRacks);
 }
 
-s32 PS4_SYSV_ABI sceNgs2SystemGetInfo(OrbisNgs2Handle rackHandle, OrbisNgs2SystemInfo* outInfo,
+s32 PS4_SYSV_ABI sceNgs2SystemGetInfo(OrbisNgs2Handle systemHandle, OrbisNgs2SystemInfo* outInfo,
                                       size_t infoSize) {
-    LOG_ERROR(Lib_Ngs2, "infoSize = {}", infoSize);
+    const Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    if (!outInfo) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    if (infoSize < sizeof(OrbisNgs2SystemInfo)) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_SIZE;
+    }
+    system->GetInfo(outInfo);
     return ORBIS_OK;
 }
 
@@ -219,7 +393,14 @@ s32 PS4_SYSV_ABI sceNgs2SystemGetUserData(OrbisNgs2Handle systemHandle, uintptr_
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
-    LOG_ERROR(Lib_Ngs2, "called");
+    const Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    if (!outUserData) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    *outUserData = system->user_data;
     return ORBIS_OK;
 }
 
@@ -228,7 +409,11 @@ s32 PS4_SYSV_ABI sceNgs2SystemLock(OrbisNgs2Handle systemHandle) {
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
-    LOG_ERROR(Lib_Ngs2, "called");
+    Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    system->mutex.lock();
     return ORBIS_OK;
 }
 
@@ -249,12 +434,19 @@ s32 PS4_SYSV_ABI sceNgs2SystemQueryBufferSize(const OrbisNgs2SystemOption* optio
 s32 PS4_SYSV_ABI sceNgs2SystemRender(OrbisNgs2Handle systemHandle,
                                      const OrbisNgs2RenderBufferInfo* aBufferInfo,
                                      u32 numBufferInfo) {
-    LOG_DEBUG(Lib_Ngs2, "(STUBBED) numBufferInfo = {}", numBufferInfo);
+    LOG_TRACE(Lib_Ngs2, "numBufferInfo = {}", numBufferInfo);
     if (!systemHandle) {
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
-    return ORBIS_OK;
+    Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    if (numBufferInfo != 0 && !aBufferInfo) {
+        return ORBIS_NGS2_ERROR_INVALID_BUFFER_INFO;
+    }
+    return system->Render({aBufferInfo, numBufferInfo});
 }
 
 static s32 PS4_SYSV_ABI sceNgs2SystemResetOption(OrbisNgs2SystemOption* outOption) {
@@ -272,29 +464,53 @@ static s32 PS4_SYSV_ABI sceNgs2SystemResetOption(OrbisNgs2SystemOption* outOptio
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemSetGrainSamples(OrbisNgs2Handle systemHandle, u32 numSamples) {
-    LOG_ERROR(Lib_Ngs2, "numSamples = {}", numSamples);
+    LOG_INFO(Lib_Ngs2, "numSamples = {}", numSamples);
     if (!systemHandle) {
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
+    Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    if (numSamples < 64 || numSamples > system->max_grain_samples || (numSamples & 63) != 0) {
+        LOG_ERROR(Lib_Ngs2, "Invalid grain samples ({},x64)", numSamples);
+        return ORBIS_NGS2_ERROR_INVALID_NUM_GRAIN_SAMPLES;
+    }
+    std::scoped_lock lk{system->mutex};
+    system->num_grain_samples = numSamples;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemSetSampleRate(OrbisNgs2Handle systemHandle, u32 sampleRate) {
-    LOG_ERROR(Lib_Ngs2, "sampleRate = {}", sampleRate);
+    LOG_INFO(Lib_Ngs2, "sampleRate = {}", sampleRate);
     if (!systemHandle) {
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
+    Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    if (sampleRate == 0) {
+        return ORBIS_NGS2_ERROR_INVALID_SAMPLE_RATE;
+    }
+    std::scoped_lock lk{system->mutex};
+    system->sample_rate = sampleRate;
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2SystemSetUserData(OrbisNgs2Handle systemHandle, uintptr_t userData) {
-    LOG_ERROR(Lib_Ngs2, "userData = {}", userData);
+    LOG_DEBUG(Lib_Ngs2, "userData = {}", userData);
     if (!systemHandle) {
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
+    Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    system->user_data = userData;
     return ORBIS_OK;
 }
 
@@ -303,42 +519,93 @@ s32 PS4_SYSV_ABI sceNgs2SystemUnlock(OrbisNgs2Handle systemHandle) {
         LOG_ERROR(Lib_Ngs2, "systemHandle is nullptr");
         return ORBIS_NGS2_ERROR_INVALID_SYSTEM_HANDLE;
     }
-    LOG_ERROR(Lib_Ngs2, "called");
+    Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
+        return HandleReportInvalid(systemHandle, 1);
+    }
+    system->mutex.unlock();
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceControl(OrbisNgs2Handle voiceHandle,
                                      const OrbisNgs2VoiceParamHeader* paramList) {
-    LOG_ERROR(Lib_Ngs2, "called");
-    return ORBIS_OK;
+    Ngs2Voice* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (!paramList) {
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ADDRESS;
+    }
+    std::scoped_lock lk{voice->rack.system.mutex};
+    return voice->Control(paramList);
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetMatrixInfo(OrbisNgs2Handle voiceHandle, u32 matrixId,
                                            OrbisNgs2VoiceMatrixInfo* outInfo, size_t outInfoSize) {
-    LOG_ERROR(Lib_Ngs2, "matrixId = {}, outInfoSize = {}", matrixId, outInfoSize);
-    return ORBIS_OK;
+    const Ngs2Voice* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (!outInfo) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    if (outInfoSize < sizeof(OrbisNgs2VoiceMatrixInfo)) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_SIZE;
+    }
+    return voice->GetMatrixInfo(matrixId, outInfo);
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetOwner(OrbisNgs2Handle voiceHandle, OrbisNgs2Handle* outRackHandle,
                                       u32* outVoiceId) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    const Ngs2Voice* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (outRackHandle) {
+        *outRackHandle = voice->rack.Handle();
+    }
+    if (outVoiceId) {
+        *outVoiceId = voice->index;
+    }
     return ORBIS_OK;
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetPortInfo(OrbisNgs2Handle voiceHandle, u32 port,
                                          OrbisNgs2VoicePortInfo* outInfo, size_t outInfoSize) {
-    LOG_ERROR(Lib_Ngs2, "port = {}, outInfoSize = {}", port, outInfoSize);
-    return ORBIS_OK;
+    const Ngs2Voice* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (!outInfo) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    if (outInfoSize < sizeof(OrbisNgs2VoicePortInfo)) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_SIZE;
+    }
+    return voice->GetPortInfo(port, outInfo);
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetState(OrbisNgs2Handle voiceHandle, OrbisNgs2VoiceState* outState,
                                       size_t stateSize) {
-    LOG_ERROR(Lib_Ngs2, "stateSize = {}", stateSize);
-    return ORBIS_OK;
+    const Ngs2Voice* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (!outState) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    return voice->GetState(outState, stateSize);
 }
 
 s32 PS4_SYSV_ABI sceNgs2VoiceGetStateFlags(OrbisNgs2Handle voiceHandle, u32* outStateFlags) {
-    LOG_ERROR(Lib_Ngs2, "called");
+    const Ngs2Voice* voice = GetVoice(voiceHandle);
+    if (!voice) {
+        return HandleReportInvalid(voiceHandle, 4);
+    }
+    if (!outStateFlags) {
+        return ORBIS_NGS2_ERROR_INVALID_OUT_ADDRESS;
+    }
+    *outStateFlags = voice->state_flags;
     return ORBIS_OK;
 }
 
@@ -27,6 +27,54 @@ enum class OrbisNgs2HandleType : u32 {
     VoiceControl = 6
 };
 
+constexpr u32 ORBIS_NGS2_RACK_ID_SAMPLER = 0x1000;
+constexpr u32 ORBIS_NGS2_RACK_ID_SUBMIXER = 0x2000;
+constexpr u32 ORBIS_NGS2_RACK_ID_MASTERING = 0x3000;
+
+constexpr u32 ORBIS_NGS2_VOICE_PARAM_MATRIX_LEVELS = 1;
+constexpr u32 ORBIS_NGS2_VOICE_PARAM_PORT_MATRIX = 2;
+constexpr u32 ORBIS_NGS2_VOICE_PARAM_PORT_VOLUME = 3;
+constexpr u32 ORBIS_NGS2_VOICE_PARAM_PORT_DELAY = 4;
+constexpr u32 ORBIS_NGS2_VOICE_PARAM_PATCH = 5;
+constexpr u32 ORBIS_NGS2_VOICE_PARAM_EVENT = 6;
+constexpr u32 ORBIS_NGS2_VOICE_PARAM_CALLBACK = 7;
+
+enum class OrbisNgs2VoiceEvent : u32 {
+    Play = 0,
+    Stop = 1,
+    StopImm = 2,
+    Kill = 3,
+    Pause = 4,
+    Resume = 5,
+};
+
+constexpr u32 ORBIS_NGS2_VOICE_STATE_FLAG_INUSE = 0x1;
+constexpr u32 ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING = 0x2;
+constexpr u32 ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED = 0x4;
+constexpr u32 ORBIS_NGS2_VOICE_STATE_FLAG_STOPPED = 0x8;
+constexpr u32 ORBIS_NGS2_VOICE_STATE_FLAG_ERROR = 0x10;
+constexpr u32 ORBIS_NGS2_VOICE_STATE_FLAG_EMPTY = 0x20;
+
+constexpr u32 ORBIS_NGS2_VOICE_CALLBACK_FLAG_WAVEFORM_BLOCK_END = 0x1;
+
+enum class OrbisNgs2WaveformType : u32 {
+    None = 0,
+    PcmI8 = 0x10,
+    PcmU8 = 0x11,
+    PcmI16Little = 0x12,
+    PcmI16Big = 0x13,
+    PcmI24Little = 0x14,
+    PcmI24Big = 0x15,
+    PcmI32Little = 0x16,
+    PcmI32Big = 0x17,
+    PcmF32Little = 0x18,
+    PcmF32Big = 0x19,
+    PcmF64Little = 0x1A,
+    PcmF64Big = 0x1B,
+    Vag = 0x1C,
+    Atrac9 = 0x40,
+};
+
 static const int ORBIS_NGS2_MAX_VOICE_CHANNELS = 8;
 static const int ORBIS_NGS2_WAVEFORM_INFO_MAX_BLOCKS = 4;
 static const int ORBIS_NGS2_MAX_MATRIX_LEVELS =
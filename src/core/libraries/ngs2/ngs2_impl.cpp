@@ -1,8 +1,11 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <cstring>
+
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_render.h"
 
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
@@ -62,12 +65,14 @@ s32 StackBufferOpen(StackBuffer* stackBuffer, void* bufferStart, size_t bufferSi
 }
 
 s32 SystemCleanup(OrbisNgs2Handle systemHandle, OrbisNgs2ContextBufferInfo* outInfo) {
-    if (!systemHandle) {
+    Ngs2System* system = GetSystem(systemHandle);
+    if (!system) {
         return ORBIS_NGS2_ERROR_INVALID_HANDLE;
     }
-
-    // TODO
-
+    if (outInfo) {
+        *outInfo = system->buffer_info;
+    }
+    DestroySystem(system);
     return ORBIS_OK;
 }
 
@@ -101,8 +106,12 @@ s32 SystemSetupCore(StackBuffer* stackBuffer, const OrbisNgs2SystemOption* optio
     }
 
     if (outSystem) {
-        // dummy handle
-        outSystem->systemHandle = 1;
+        if (option) {
+            std::memcpy(outSystem->name, option->name, sizeof(outSystem->name));
+        }
+        outSystem->sampleRate = sampleRate;
+        outSystem->numGrainSamples = static_cast<u16>(numGrainSamples);
+        outSystem->maxGrainSamples = static_cast<u16>(maxGrainSamples);
     }
 
     return ORBIS_OK;
@@ -112,7 +121,7 @@ s32 SystemSetup(const OrbisNgs2SystemOption* option, OrbisNgs2ContextBufferInfo*
                 OrbisNgs2BufferFreeHandler hostFree, OrbisNgs2Handle* outHandle) {
     u8 optionFlags = 0;
     StackBuffer stackBuffer;
-    SystemInternal setupResult;
+    SystemInternal setupResult{};
     void* systemList = NULL;
     size_t requiredBufferSize = 0;
     u32 result = ORBIS_NGS2_ERROR_INVALID_BUFFER_SIZE;
@@ -171,7 +180,7 @@ s32 SystemSetup(const OrbisNgs2SystemOption* option, OrbisNgs2ContextBufferInfo*
     // TODO
     // setupResult.systemList = systemList;
 
-    OrbisNgs2Handle systemHandle = setupResult.systemHandle;
+    OrbisNgs2Handle systemHandle = CreateSystem(setupResult)->Handle();
     if (hostBufferInfo->hostBufferSize >= requiredBufferSize) {
         *outHandle = systemHandle;
         return ORBIS_OK;
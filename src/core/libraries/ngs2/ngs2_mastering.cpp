@@ -1,12 +1,96 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_mastering.h"
 
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 
 using namespace Libraries::Kernel;
 
-namespace Libraries::Ngs2 {} // namespace Libraries::Ngs2
+namespace Libraries::Ngs2 {
+
+/// Surround layouts carry the low frequency channel fourth.
+constexpr u32 LfeChannel = 3;
+
+Ngs2Mastering::Ngs2Mastering(Ngs2Rack& rack, u32 index) : Ngs2Voice(rack, index) {
+    SetChannels(2, 2);
+}
+
+s32 Ngs2Mastering::SetParam(const OrbisNgs2VoiceParamHeader* param) {
+    switch (param->id) {
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_SETUP: {
+        const auto* setup = reinterpret_cast<const OrbisNgs2MasteringVoiceSetupParam*>(param);
+        const u32 num_channels = setup->numInputChannels != 0 ? setup->numInputChannels : 2;
+        if (num_channels > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+            return ORBIS_NGS2_ERROR_INVALID_NUM_CHANNELS;
+        }
+        SetChannels(num_channels, num_channels);
+        state_flags = ORBIS_NGS2_VOICE_STATE_FLAG_INUSE;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_GAIN: {
+        const auto* gain = reinterpret_cast<const OrbisNgs2MasteringVoiceGainParam*>(param);
+        fbw_level = gain->fbwLevel;
+        lfe_level = gain->lfeLevel;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_OUTPUT:
+        output_id = reinterpret_cast<const OrbisNgs2MasteringVoiceOutputParam*>(param)->outputId;
+        return ORBIS_OK;
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_LIMITER: {
+        const auto* limiter = reinterpret_cast<const OrbisNgs2MasteringVoiceLimiterParam*>(param);
+        limiter_enabled = limiter->enableFlag != 0;
+        limiter_threshold = limiter->threshold;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_MATRIX:
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_LFE:
+    case ORBIS_NGS2_MASTERING_VOICE_PARAM_PEAK_METER:
+        LOG_DEBUG(Lib_Ngs2, "Ignoring mastering voice param {:#x}", param->id);
+        return ORBIS_OK;
+    default:
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ID;
+    }
+}
+
+void Ngs2Mastering::Process(u32 num_samples) {
+    limiter_peak = 0.0f;
+    for (u32 ch = 0; ch < num_output_channels; ch++) {
+        float* out = OutputChannel(ch);
+        if (!has_input) {
+            std::fill_n(out, num_samples, 0.0f);
+            continue;
+        }
+        std::copy_n(InputChannel(ch), num_samples, out);
+        const bool is_lfe = num_output_channels > LfeChannel + 1 && ch == LfeChannel;
+        ScaleSamples(out, is_lfe ? lfe_level : fbw_level, num_samples);
+        if (!limiter_enabled) {
+            continue;
+        }
+        for (u32 i = 0; i < num_samples; i++) {
+            limiter_peak = std::max(limiter_peak, std::abs(out[i]));
+            out[i] = std::clamp(out[i], -limiter_threshold, limiter_threshold);
+        }
+    }
+}
+
+s32 Ngs2Mastering::GetState(void* out_state, size_t state_size) const {
+    if (state_size < sizeof(OrbisNgs2MasteringVoiceState)) {
+        return Ngs2Voice::GetState(out_state, state_size);
+    }
+    auto* state = static_cast<OrbisNgs2MasteringVoiceState*>(out_state);
+    std::memset(state, 0, state_size);
+    state->voiceState.stateFlags = state_flags;
+    state->limiterPeakLevel = limiter_peak;
+    state->limiterPressLevel = limiter_enabled ? std::min(limiter_peak, limiter_threshold) : 0.0f;
+    return ORBIS_OK;
+}
+
+} // namespace Libraries::Ngs2
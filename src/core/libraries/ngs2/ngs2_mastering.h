@@ -4,10 +4,17 @@
 #pragma once
 
 #include "ngs2.h"
+#include "ngs2_render.h"
 
 namespace Libraries::Ngs2 {
 
-class Ngs2Mastering;
+constexpr u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_SETUP = 0x30000001;
+constexpr u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_MATRIX = 0x30000002;
+constexpr u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_LFE = 0x30000003;
+constexpr u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_LIMITER = 0x30000004;
+constexpr u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_GAIN = 0x30000005;
+constexpr u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_OUTPUT = 0x30000006;
+constexpr u32 ORBIS_NGS2_MASTERING_VOICE_PARAM_PEAK_METER = 0x30000007;
 
 struct OrbisNgs2MasteringRackOption {
     OrbisNgs2RackOption rackOption;
@@ -78,4 +85,28 @@ struct OrbisNgs2MasteringRackInfo {
     u32 reserved;
 };
 
+/**
+ * Mastering voice, applies the output gain and limiter and is written to a render buffer.
+ */
+class Ngs2Mastering final : public Ngs2Voice {
+public:
+    explicit Ngs2Mastering(Ngs2Rack& rack, u32 index);
+
+    void Process(u32 num_samples) override;
+    s32 GetState(void* out_state, size_t state_size) const override;
+
+    /// Index of the render buffer the voice is written to.
+    u32 output_id{};
+
+protected:
+    s32 SetParam(const OrbisNgs2VoiceParamHeader* param) override;
+
+private:
+    float fbw_level{1.0f};
+    float lfe_level{1.0f};
+    bool limiter_enabled{};
+    float limiter_threshold{1.0f};
+    float limiter_peak{};
+};
+
 } // namespace Libraries::Ngs2
@@ -0,0 +1,558 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "common/thread_worker.h"
+#include "core/libraries/error_codes.h"
+#include "core/libraries/ngs2/ngs2_error.h"
+#include "core/libraries/ngs2/ngs2_mastering.h"
+#include "core/libraries/ngs2/ngs2_render.h"
+#include "core/libraries/ngs2/ngs2_sampler.h"
+#include "core/libraries/ngs2/ngs2_submixer.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace Libraries::Ngs2 {
+
+namespace {
+
+/// Parameter lists longer than this are assumed to be circular.
+constexpr u32 MaxVoiceParams = 1024;
+
+/// Rendering sampler voices is split over the worker pool from this many active voices.
+constexpr size_t ParallelVoiceThreshold = 16;
+
+std::mutex handle_mutex;
+std::unordered_map<OrbisNgs2Handle, OrbisNgs2HandleType> handles;
+u32 next_uid = 1;
+
+void RegisterHandle(OrbisNgs2Handle handle, OrbisNgs2HandleType type) {
+    std::scoped_lock lk{handle_mutex};
+    handles.emplace(handle, type);
+}
+
+void UnregisterHandle(OrbisNgs2Handle handle) {
+    std::scoped_lock lk{handle_mutex};
+    handles.erase(handle);
+}
+
+bool IsHandle(OrbisNgs2Handle handle, OrbisNgs2HandleType type) {
+    std::scoped_lock lk{handle_mutex};
+    const auto it = handles.find(handle);
+    return it != handles.end() && it->second == type;
+}
+
+u32 NextUid() {
+    std::scoped_lock lk{handle_mutex};
+    return next_uid++;
+}
+
+std::unique_ptr<Ngs2Voice> CreateVoice(Ngs2Rack& rack, u32 index) {
+    switch (rack.rack_id) {
+    case ORBIS_NGS2_RACK_ID_SAMPLER:
+        return std::make_unique<Ngs2Sampler>(rack, index);
+    case ORBIS_NGS2_RACK_ID_SUBMIXER:
+        return std::make_unique<Ngs2Submixer>(rack, index);
+    case ORBIS_NGS2_RACK_ID_MASTERING:
+        return std::make_unique<Ngs2Mastering>(rack, index);
+    default:
+        UNREACHABLE_MSG("Unknown rack id {:#x}", rack.rack_id);
+    }
+}
+
+/// Level of a port without a matrix, mono voices are spread over the front channels.
+float DefaultLevel(u32 src_channel, u32 dst_channel, u32 num_src_channels) {
+    if (num_src_channels == 1) {
+        return dst_channel < 2 ? 1.0f : 0.0f;
+    }
+    return src_channel == dst_channel ? 1.0f : 0.0f;
+}
+
+template <typename T>
+const T* NextParam(const T* param) {
+    if (param->next == 0) {
+        return nullptr;
+    }
+    return reinterpret_cast<const T*>(reinterpret_cast<const u8*>(param) + param->next);
+}
+
+} // Anonymous namespace
+
+void MixSamples(float* dst, const float* src, float level, u32 num_samples) {
+    u32 i = 0;
+#ifdef __AVX2__
+    const __m256 gain = _mm256_set1_ps(level);
+    for (; i + 8 <= num_samples; i += 8) {
+        const __m256 mixed =
+            _mm256_add_ps(_mm256_loadu_ps(dst + i), _mm256_mul_ps(_mm256_loadu_ps(src + i), gain));
+        _mm256_storeu_ps(dst + i, mixed);
+    }
+#endif
+    for (; i < num_samples; i++) {
+        dst[i] += src[i] * level;
+    }
+}
+
+void ScaleSamples(float* samples, float level, u32 num_samples) {
+    u32 i = 0;
+#ifdef __AVX2__
+    const __m256 gain = _mm256_set1_ps(level);
+    for (; i + 8 <= num_samples; i += 8) {
+        _mm256_storeu_ps(samples + i, _mm256_mul_ps(_mm256_loadu_ps(samples + i), gain));
+    }
+#endif
+    for (; i < num_samples; i++) {
+        samples[i] *= level;
+    }
+}
+
+Ngs2Voice::Ngs2Voice(Ngs2Rack& rack_, u32 index_)
+    : rack{rack_}, index{index_}, max_grain_samples{rack_.system.max_grain_samples} {
+    ports.resize(std::max(rack.option.maxPorts, 1U));
+    matrices.resize(std::max(rack.option.maxMatrices, 1U));
+}
+
+Ngs2Voice::~Ngs2Voice() = default;
+
+s32 Ngs2Voice::Control(const OrbisNgs2VoiceParamHeader* param) {
+    for (u32 num_params = 0; param != nullptr; param = NextParam(param)) {
+        if (++num_params > MaxVoiceParams) {
+            return ORBIS_NGS2_ERROR_DETECTED_CIRCULAR_VOICE_CONTROL;
+        }
+        s32 result = ORBIS_OK;
+        switch (param->id) {
+        case ORBIS_NGS2_VOICE_PARAM_MATRIX_LEVELS: {
+            const auto* levels = reinterpret_cast<const OrbisNgs2VoiceMatrixLevelsParam*>(param);
+            if (levels->matrixId >= matrices.size()) {
+                return ORBIS_NGS2_ERROR_INVALID_MATRIX_INDEX;
+            }
+            if (levels->numLevels > ORBIS_NGS2_MAX_MATRIX_LEVELS) {
+                return ORBIS_NGS2_ERROR_INVALID_NUM_MATRIX_LEVELS;
+            }
+            if (levels->numLevels != 0 && !levels->aLevel) {
+                return ORBIS_NGS2_ERROR_INVALID_MATRIX_LEVEL_ADDRESS;
+            }
+            matrices[levels->matrixId].assign(levels->aLevel, levels->aLevel + levels->numLevels);
+            break;
+        }
+        case ORBIS_NGS2_VOICE_PARAM_PORT_MATRIX: {
+            const auto* matrix = reinterpret_cast<const OrbisNgs2VoicePortMatrixParam*>(param);
+            if (matrix->port >= ports.size()) {
+                return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+            }
+            if (matrix->matrixId >= static_cast<s32>(matrices.size())) {
+                return ORBIS_NGS2_ERROR_INVALID_MATRIX_INDEX;
+            }
+            ports[matrix->port].matrix_id = matrix->matrixId;
+            break;
+        }
+        case ORBIS_NGS2_VOICE_PARAM_PORT_VOLUME: {
+            const auto* volume = reinterpret_cast<const OrbisNgs2VoicePortVolumeParam*>(param);
+            if (volume->port >= ports.size()) {
+                return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+            }
+            ports[volume->port].volume = volume->level;
+            break;
+        }
+        case ORBIS_NGS2_VOICE_PARAM_PORT_DELAY: {
+            const auto* delay = reinterpret_cast<const OrbisNgs2VoicePortDelayParam*>(param);
+            if (delay->port >= ports.size()) {
+                return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+            }
+            ports[delay->port].num_delay_samples = delay->numSamples;
+            break;
+        }
+        case ORBIS_NGS2_VOICE_PARAM_PATCH: {
+            const auto* patch = reinterpret_cast<const OrbisNgs2VoicePatchParam*>(param);
+            if (patch->port >= ports.size()) {
+                return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+            }
+            if (patch->destHandle != 0) {
+                const Ngs2Voice* dest = GetVoice(patch->destHandle);
+                if (!dest || dest == this || &dest->rack.system != &rack.system) {
+                    return ORBIS_NGS2_ERROR_INVALID_PATCH;
+                }
+            }
+            ports[patch->port].dest_handle = patch->destHandle;
+            ports[patch->port].dest_input_id = patch->destInputId;
+            break;
+        }
+        case ORBIS_NGS2_VOICE_PARAM_EVENT: {
+            const auto* event = reinterpret_cast<const OrbisNgs2VoiceEventParam*>(param);
+            if (event->eventId > static_cast<u32>(OrbisNgs2VoiceEvent::Resume)) {
+                return ORBIS_NGS2_ERROR_INVALID_EVENT_TYPE;
+            }
+            result = HandleEvent(static_cast<OrbisNgs2VoiceEvent>(event->eventId));
+            break;
+        }
+        case ORBIS_NGS2_VOICE_PARAM_CALLBACK: {
+            const auto* callback = reinterpret_cast<const OrbisNgs2VoiceCallbackParam*>(param);
+            callback_handler = callback->callbackHandler;
+            callback_data = callback->callbackData;
+            callback_flags = callback->flags;
+            break;
+        }
+        default:
+            result = SetParam(param);
+            break;
+        }
+        if (result < 0) {
+            return result;
+        }
+    }
+    return ORBIS_OK;
+}
+
+s32 Ngs2Voice::HandleEvent(OrbisNgs2VoiceEvent event) {
+    switch (event) {
+    case OrbisNgs2VoiceEvent::Play:
+        state_flags = ORBIS_NGS2_VOICE_STATE_FLAG_INUSE | ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING;
+        break;
+    case OrbisNgs2VoiceEvent::Stop:
+    case OrbisNgs2VoiceEvent::StopImm:
+    case OrbisNgs2VoiceEvent::Kill:
+        state_flags = 0;
+        break;
+    case OrbisNgs2VoiceEvent::Pause:
+        state_flags |= ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED;
+        break;
+    case OrbisNgs2VoiceEvent::Resume:
+        state_flags &= ~ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED;
+        break;
+    }
+    return ORBIS_OK;
+}
+
+s32 Ngs2Voice::GetState(void* out_state, size_t state_size) const {
+    if (state_size < sizeof(OrbisNgs2VoiceState)) {
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_STATE_SIZE;
+    }
+    std::memset(out_state, 0, state_size);
+    static_cast<OrbisNgs2VoiceState*>(out_state)->stateFlags = state_flags;
+    return ORBIS_OK;
+}
+
+void Ngs2Voice::SetChannels(u32 num_inputs, u32 num_outputs) {
+    num_input_channels = num_inputs;
+    num_output_channels = num_outputs;
+    input.assign(num_inputs * max_grain_samples, 0.0f);
+    output.assign(num_outputs * max_grain_samples, 0.0f);
+}
+
+void Ngs2Voice::MixPorts(u32 num_samples) {
+    for (const Ngs2VoicePort& port : ports) {
+        if (port.dest_handle == 0 || port.volume == 0.0f) {
+            continue;
+        }
+        // Patches are validated when set and removed when their rack is destroyed.
+        auto* dest = reinterpret_cast<Ngs2Voice*>(port.dest_handle);
+        const u32 num_dest_channels = dest->num_input_channels;
+        const std::vector<float>* matrix =
+            port.matrix_id >= 0 && !matrices[port.matrix_id].empty() ? &matrices[port.matrix_id]
+                                                                     : nullptr;
+        for (u32 src = 0; src < num_output_channels; src++) {
+            for (u32 dst = 0; dst < num_dest_channels; dst++) {
+                float level = DefaultLevel(src, dst, num_output_channels);
+                if (matrix) {
+                    const u32 level_index = src * num_dest_channels + dst;
+                    level = level_index < matrix->size() ? (*matrix)[level_index] : 0.0f;
+                }
+                if (level != 0.0f) {
+                    MixSamples(dest->InputChannel(dst), OutputChannel(src), level * port.volume,
+                               num_samples);
+                }
+            }
+        }
+        dest->has_input = true;
+    }
+}
+
+void Ngs2Voice::Unpatch(const Ngs2Rack& dest_rack) {
+    for (Ngs2VoicePort& port : ports) {
+        if (port.dest_handle != 0 &&
+            &reinterpret_cast<const Ngs2Voice*>(port.dest_handle)->rack == &dest_rack) {
+            port.dest_handle = 0;
+        }
+    }
+}
+
+s32 Ngs2Voice::GetPortInfo(u32 port_index, OrbisNgs2VoicePortInfo* out_info) const {
+    if (port_index >= ports.size()) {
+        return ORBIS_NGS2_ERROR_INVALID_PORT_INDEX;
+    }
+    const Ngs2VoicePort& port = ports[port_index];
+    *out_info = {
+        .matrixId = port.matrix_id,
+        .volume = port.volume,
+        .numDelaySamples = port.num_delay_samples,
+        .destInputId = port.dest_input_id,
+        .destHandle = port.dest_handle,
+    };
+    return ORBIS_OK;
+}
+
+s32 Ngs2Voice::GetMatrixInfo(u32 matrix_id, OrbisNgs2VoiceMatrixInfo* out_info) const {
+    if (matrix_id >= matrices.size()) {
+        return ORBIS_NGS2_ERROR_INVALID_MATRIX_INDEX;
+    }
+    const std::vector<float>& levels = matrices[matrix_id];
+    out_info->numLevels = static_cast<u32>(levels.size());
+    std::ranges::copy(levels, out_info->aLevel);
+    return ORBIS_OK;
+}
+
+Ngs2Rack::Ngs2Rack(Ngs2System& system_, u32 rack_id_, const OrbisNgs2RackOption& option_,
+                   const void* full_option)
+    : system{system_}, rack_id{rack_id_}, option{option_} {
+    if (rack_id == ORBIS_NGS2_RACK_ID_SAMPLER && full_option &&
+        option.size >= sizeof(OrbisNgs2SamplerRackOption)) {
+        max_waveform_blocks =
+            static_cast<const OrbisNgs2SamplerRackOption*>(full_option)->maxWaveformBlocks;
+    }
+    voices.reserve(option.maxVoices);
+    for (u32 i = 0; i < option.maxVoices; i++) {
+        voices.push_back(CreateVoice(*this, i));
+        RegisterHandle(voices.back()->Handle(), OrbisNgs2HandleType::Voice);
+    }
+}
+
+Ngs2Rack::~Ngs2Rack() {
+    for (const auto& voice : voices) {
+        UnregisterHandle(voice->Handle());
+    }
+}
+
+void Ngs2Rack::GetInfo(OrbisNgs2RackInfo* out_info) const {
+    std::memset(out_info, 0, sizeof(*out_info));
+    std::memcpy(out_info->name, option.name, sizeof(out_info->name));
+    out_info->rackHandle = Handle();
+    out_info->bufferInfo = buffer_info;
+    out_info->ownerSystemHandle = system.Handle();
+    out_info->type = rack_id >> 12;
+    out_info->rackId = rack_id;
+    out_info->minGrainSamples = 64;
+    out_info->maxGrainSamples = option.maxGrainSamples;
+    out_info->maxVoices = option.maxVoices;
+    out_info->maxMatrices = option.maxMatrices;
+    out_info->maxPorts = option.maxPorts;
+    out_info->renderCount = render_count;
+    out_info->activeVoiceCount = static_cast<u32>(
+        std::ranges::count_if(voices, [](const auto& voice) { return voice->IsActive(); }));
+}
+
+Ngs2System::Ngs2System(const SystemInternal& setup)
+    : name{setup.name, strnlen(setup.name, sizeof(setup.name))}, buffer_info{setup.bufferInfo},
+      host_free{setup.hostFree}, uid{NextUid()}, sample_rate{setup.sampleRate},
+      num_grain_samples{setup.numGrainSamples}, max_grain_samples{setup.maxGrainSamples} {}
+
+Ngs2System::~Ngs2System() {
+    while (!racks.empty()) {
+        DestroyRack(racks.back().get());
+    }
+}
+
+Ngs2Rack* Ngs2System::CreateRack(u32 rack_id, const OrbisNgs2RackOption& option,
+                                 const void* full_option) {
+    std::scoped_lock lk{mutex};
+    auto& rack = racks.emplace_back(std::make_unique<Ngs2Rack>(*this, rack_id, option,
+                                                               full_option));
+    RegisterHandle(rack->Handle(), OrbisNgs2HandleType::Rack);
+    return rack.get();
+}
+
+void Ngs2System::DestroyRack(Ngs2Rack* rack) {
+    std::scoped_lock lk{mutex};
+    for (const auto& other : racks) {
+        for (const auto& voice : other->voices) {
+            voice->Unpatch(*rack);
+        }
+    }
+    UnregisterHandle(rack->Handle());
+    std::erase_if(racks, [rack](const auto& entry) { return entry.get() == rack; });
+}
+
+void Ngs2System::ProcessVoices(std::span<Ngs2Voice* const> voices, u32 num_samples) {
+    if (voices.size() < ParallelVoiceThreshold) {
+        for (Ngs2Voice* voice : voices) {
+            voice->Process(num_samples);
+        }
+        return;
+    }
+    if (!worker) {
+        const u32 num_workers = std::clamp(std::thread::hardware_concurrency() / 4, 1U, 4U);
+        worker = std::make_unique<Common::ThreadWorker>(num_workers, "shadPS4:Ngs2Render");
+    }
+    // The calling thread renders the first chunk while the workers render the others.
+    const size_t num_chunks = worker->NumWorkers() + 1;
+    const size_t chunk_size = (voices.size() + num_chunks - 1) / num_chunks;
+    for (size_t begin = chunk_size; begin < voices.size(); begin += chunk_size) {
+        const auto chunk = voices.subspan(begin, std::min(chunk_size, voices.size() - begin));
+        worker->QueueWork([chunk, num_samples] {
+            for (Ngs2Voice* voice : chunk) {
+                voice->Process(num_samples);
+            }
+        });
+    }
+    for (Ngs2Voice* voice : voices.first(chunk_size)) {
+        voice->Process(num_samples);
+    }
+    worker->WaitForRequests();
+}
+
+s32 Ngs2System::Render(std::span<const OrbisNgs2RenderBufferInfo> buffers) {
+    std::scoped_lock lk{mutex};
+    const u32 num_samples = num_grain_samples;
+    // Inputs are consumed by rendering, stopped voices do not keep what was sent to them.
+    const auto clear_input = [num_samples](Ngs2Voice* voice) {
+        if (voice->has_input) {
+            for (u32 ch = 0; ch < voice->num_input_channels; ch++) {
+                std::fill_n(voice->InputChannel(ch), num_samples, 0.0f);
+            }
+            voice->has_input = false;
+        }
+    };
+    for (const auto& rack : racks) {
+        for (const auto& voice : rack->voices) {
+            if (!voice->IsActive()) {
+                clear_input(voice.get());
+            }
+        }
+    }
+
+    // Sampler voices are independent of each other and are mixed once all are rendered.
+    // Submixers are rendered in creation order so that chains created in order see their input.
+    const auto collect = [&](u32 rack_id) {
+        active_voices.clear();
+        for (const auto& rack : racks) {
+            if (rack->rack_id != rack_id) {
+                continue;
+            }
+            ++rack->render_count;
+            for (const auto& voice : rack->voices) {
+                if (voice->IsActive()) {
+                    active_voices.push_back(voice.get());
+                }
+            }
+        }
+    };
+    collect(ORBIS_NGS2_RACK_ID_SAMPLER);
+    ProcessVoices(active_voices, num_samples);
+    for (Ngs2Voice* voice : active_voices) {
+        voice->MixPorts(num_samples);
+    }
+    collect(ORBIS_NGS2_RACK_ID_SUBMIXER);
+    for (Ngs2Voice* voice : active_voices) {
+        voice->Process(num_samples);
+        clear_input(voice);
+        voice->MixPorts(num_samples);
+    }
+    collect(ORBIS_NGS2_RACK_ID_MASTERING);
+    for (Ngs2Voice* voice : active_voices) {
+        voice->Process(num_samples);
+        clear_input(voice);
+    }
+
+    for (u32 buffer_index = 0; buffer_index < buffers.size(); buffer_index++) {
+        const OrbisNgs2RenderBufferInfo& buffer = buffers[buffer_index];
+        if (!buffer.buffer || buffer.numChannels == 0) {
+            continue;
+        }
+        const u32 num_channels = std::min<u32>(buffer.numChannels, ORBIS_NGS2_MAX_VOICE_CHANNELS);
+        mix_buffer.assign(num_channels * num_samples, 0.0f);
+        for (Ngs2Voice* voice : active_voices) {
+            const auto* mastering = static_cast<Ngs2Mastering*>(voice);
+            if (mastering->output_id != buffer_index) {
+                continue;
+            }
+            for (u32 ch = 0; ch < std::min(num_channels, voice->num_output_channels); ch++) {
+                MixSamples(mix_buffer.data() + ch * num_samples, voice->OutputChannel(ch), 1.0f,
+                           num_samples);
+            }
+        }
+        const auto type = static_cast<OrbisNgs2WaveformType>(buffer.waveformType);
+        const size_t sample_size = type == OrbisNgs2WaveformType::PcmI16Little ? 2 : 4;
+        const u32 num_frames = static_cast<u32>(
+            std::min<size_t>(num_samples, buffer.bufferSize / (sample_size * buffer.numChannels)));
+        if (type == OrbisNgs2WaveformType::PcmI16Little) {
+            auto* out = static_cast<s16*>(buffer.buffer);
+            for (u32 frame = 0; frame < num_frames; frame++) {
+                for (u32 ch = 0; ch < buffer.numChannels; ch++) {
+                    const float sample =
+                        ch < num_channels ? mix_buffer[ch * num_samples + frame] : 0.0f;
+                    out[frame * buffer.numChannels + ch] =
+                        static_cast<s16>(std::clamp(sample, -1.0f, 1.0f) * 32767.0f);
+                }
+            }
+        } else if (type == OrbisNgs2WaveformType::PcmF32Little) {
+            auto* out = static_cast<float*>(buffer.buffer);
+            for (u32 frame = 0; frame < num_frames; frame++) {
+                for (u32 ch = 0; ch < buffer.numChannels; ch++) {
+                    out[frame * buffer.numChannels + ch] =
+                        ch < num_channels ? mix_buffer[ch * num_samples + frame] : 0.0f;
+                }
+            }
+        } else {
+            LOG_ERROR(Lib_Ngs2, "Unsupported render buffer waveform type {:#x}",
+                      buffer.waveformType);
+        }
+    }
+
+    // Guest callbacks run last, they may control voices again.
+    for (const auto& rack : racks) {
+        for (const auto& voice : rack->voices) {
+            voice->FlushCallbacks();
+        }
+    }
+    ++render_count;
+    return ORBIS_OK;
+}
+
+void Ngs2System::GetInfo(OrbisNgs2SystemInfo* out_info) const {
+    std::memset(out_info, 0, sizeof(*out_info));
+    name.copy(out_info->name, sizeof(out_info->name) - 1);
+    out_info->systemHandle = Handle();
+    out_info->bufferInfo = buffer_info;
+    out_info->uid = uid;
+    out_info->minGrainSamples = 64;
+    out_info->maxGrainSamples = max_grain_samples;
+    out_info->rackCount = static_cast<u32>(racks.size());
+    out_info->renderCount = static_cast<s64>(render_count);
+    out_info->sampleRate = sample_rate;
+    out_info->numGrainSamples = num_grain_samples;
+}
+
+Ngs2System* GetSystem(OrbisNgs2Handle handle) {
+    return IsHandle(handle, OrbisNgs2HandleType::System) ? reinterpret_cast<Ngs2System*>(handle)
+                                                         : nullptr;
+}
+
+Ngs2Rack* GetRack(OrbisNgs2Handle handle) {
+    return IsHandle(handle, OrbisNgs2HandleType::Rack) ? reinterpret_cast<Ngs2Rack*>(handle)
+                                                       : nullptr;
+}
+
+Ngs2Voice* GetVoice(OrbisNgs2Handle handle) {
+    return IsHandle(handle, OrbisNgs2HandleType::Voice) ? reinterpret_cast<Ngs2Voice*>(handle)
+                                                        : nullptr;
+}
+
+Ngs2System* CreateSystem(const SystemInternal& setup) {
+    auto* system = new Ngs2System(setup);
+    RegisterHandle(system->Handle(), OrbisNgs2HandleType::System);
+    return system;
+}
+
+void DestroySystem(Ngs2System* system) {
+    UnregisterHandle(system->Handle());
+    delete system;
+}
+
+} // namespace Libraries::Ngs2
@@ -0,0 +1,186 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "core/libraries/ngs2/ngs2.h"
+
+namespace Common {
+class ThreadWorker;
+}
+
+namespace Libraries::Ngs2 {
+
+class Ngs2Rack;
+class Ngs2System;
+
+/// Adds the samples of src scaled by level to dst.
+void MixSamples(float* dst, const float* src, float level, u32 num_samples);
+
+/// Scales samples by level in place.
+void ScaleSamples(float* samples, float level, u32 num_samples);
+
+struct Ngs2VoicePort {
+    s32 matrix_id{-1};
+    float volume{1.0f};
+    u32 num_delay_samples{};
+    u32 dest_input_id{};
+    OrbisNgs2Handle dest_handle{};
+};
+
+/**
+ * Voice of a rack. A playing voice renders one grain at a time into its output channels, which
+ * are then mixed through its ports into the input channels of the voices they are patched to.
+ * Channels are stored one after the other, each holding the samples of a grain.
+ */
+class Ngs2Voice {
+public:
+    explicit Ngs2Voice(Ngs2Rack& rack, u32 index);
+    virtual ~Ngs2Voice();
+
+    Ngs2Voice(const Ngs2Voice&) = delete;
+    Ngs2Voice& operator=(const Ngs2Voice&) = delete;
+
+    /// Applies a linked list of voice parameters.
+    s32 Control(const OrbisNgs2VoiceParamHeader* param_list);
+
+    /// Renders a grain of num_samples into the output channels.
+    virtual void Process(u32 num_samples) = 0;
+
+    /// Invokes the guest callbacks of events raised during the last grain.
+    virtual void FlushCallbacks() {}
+
+    /// Writes the rack specific voice state, which starts with the common state.
+    virtual s32 GetState(void* out_state, size_t state_size) const;
+
+    [[nodiscard]] OrbisNgs2Handle Handle() const {
+        return reinterpret_cast<OrbisNgs2Handle>(this);
+    }
+
+    [[nodiscard]] bool IsActive() const {
+        constexpr u32 mask =
+            ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING | ORBIS_NGS2_VOICE_STATE_FLAG_PAUSED;
+        return (state_flags & mask) == ORBIS_NGS2_VOICE_STATE_FLAG_PLAYING;
+    }
+
+    [[nodiscard]] float* InputChannel(u32 channel) {
+        return input.data() + channel * max_grain_samples;
+    }
+
+    [[nodiscard]] float* OutputChannel(u32 channel) {
+        return output.data() + channel * max_grain_samples;
+    }
+
+    /// Mixes the output channels into the patched voices.
+    void MixPorts(u32 num_samples);
+
+    /// Forgets the patches to voices of a rack that is being destroyed.
+    void Unpatch(const Ngs2Rack& dest_rack);
+
+    s32 GetPortInfo(u32 port, OrbisNgs2VoicePortInfo* out_info) const;
+    s32 GetMatrixInfo(u32 matrix_id, OrbisNgs2VoiceMatrixInfo* out_info) const;
+
+    Ngs2Rack& rack;
+    u32 index;
+    u32 state_flags{};
+    u32 num_input_channels{};
+    u32 num_output_channels{};
+    bool has_input{};
+
+protected:
+    /// Applies one rack specific parameter.
+    virtual s32 SetParam(const OrbisNgs2VoiceParamHeader* param) = 0;
+
+    /// Handles a voice event, the default starts and stops the voice.
+    virtual s32 HandleEvent(OrbisNgs2VoiceEvent event);
+
+    /// Resizes the channel buffers for new channel counts.
+    void SetChannels(u32 num_inputs, u32 num_outputs);
+
+    u32 max_grain_samples;
+    std::vector<float> input;
+    std::vector<float> output;
+    std::vector<Ngs2VoicePort> ports;
+    std::vector<std::vector<float>> matrices;
+    OrbisNgs2VoiceCallbackHandler callback_handler{};
+    uintptr_t callback_data{};
+    u32 callback_flags{};
+};
+
+class Ngs2Rack {
+public:
+    explicit Ngs2Rack(Ngs2System& system, u32 rack_id, const OrbisNgs2RackOption& option,
+                      const void* full_option);
+    ~Ngs2Rack();
+
+    [[nodiscard]] OrbisNgs2Handle Handle() const {
+        return reinterpret_cast<OrbisNgs2Handle>(this);
+    }
+
+    void GetInfo(OrbisNgs2RackInfo* out_info) const;
+
+    Ngs2System& system;
+    u32 rack_id;
+    OrbisNgs2RackOption option;
+    /// Maximum number of waveform blocks of sampler voices.
+    u32 max_waveform_blocks{};
+    std::vector<std::unique_ptr<Ngs2Voice>> voices;
+    OrbisNgs2ContextBufferInfo buffer_info{};
+    OrbisNgs2BufferFreeHandler host_free{};
+    uintptr_t user_data{};
+    u64 render_count{};
+};
+
+class Ngs2System {
+public:
+    explicit Ngs2System(const SystemInternal& setup);
+    ~Ngs2System();
+
+    [[nodiscard]] OrbisNgs2Handle Handle() const {
+        return reinterpret_cast<OrbisNgs2Handle>(this);
+    }
+
+    Ngs2Rack* CreateRack(u32 rack_id, const OrbisNgs2RackOption& option, const void* full_option);
+    void DestroyRack(Ngs2Rack* rack);
+
+    /// Renders one grain of every rack and writes the mastering voices into the buffers.
+    s32 Render(std::span<const OrbisNgs2RenderBufferInfo> buffers);
+
+    void GetInfo(OrbisNgs2SystemInfo* out_info) const;
+
+    /// Guards the graph against concurrent control and rendering, guest locks nest with it.
+    std::recursive_mutex mutex;
+    std::string name;
+    std::vector<std::unique_ptr<Ngs2Rack>> racks;
+    OrbisNgs2ContextBufferInfo buffer_info{};
+    OrbisNgs2BufferFreeHandler host_free{};
+    uintptr_t user_data{};
+    u32 uid{};
+    u32 sample_rate;
+    u32 num_grain_samples;
+    u32 max_grain_samples;
+    u64 render_count{};
+
+private:
+    void ProcessVoices(std::span<Ngs2Voice* const> voices, u32 num_samples);
+
+    std::unique_ptr<Common::ThreadWorker> worker;
+    std::vector<Ngs2Voice*> active_voices;
+    std::vector<float> mix_buffer;
+};
+
+Ngs2System* GetSystem(OrbisNgs2Handle handle);
+Ngs2Rack* GetRack(OrbisNgs2Handle handle);
+Ngs2Voice* GetVoice(OrbisNgs2Handle handle);
+
+/// Creates the host side of a system that passed setup.
+Ngs2System* CreateSystem(const SystemInternal& setup);
+void DestroySystem(Ngs2System* system);
+
+} // namespace Libraries::Ngs2
@@ -1,12 +1,335 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_sampler.h"
 
+#include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
+#include "core/tls.h"
 
 using namespace Libraries::Kernel;
 
-namespace Libraries::Ngs2 {} // namespace Libraries::Ngs2
+namespace Libraries::Ngs2 {
+
+namespace {
+
+constexpr u32 SampleSize(OrbisNgs2WaveformType type) {
+    switch (type) {
+    case OrbisNgs2WaveformType::PcmI8:
+    case OrbisNgs2WaveformType::PcmU8:
+        return 1;
+    case OrbisNgs2WaveformType::PcmI16Little:
+    case OrbisNgs2WaveformType::PcmI16Big:
+        return 2;
+    case OrbisNgs2WaveformType::PcmI24Little:
+    case OrbisNgs2WaveformType::PcmI24Big:
+        return 3;
+    case OrbisNgs2WaveformType::PcmI32Little:
+    case OrbisNgs2WaveformType::PcmI32Big:
+    case OrbisNgs2WaveformType::PcmF32Little:
+    case OrbisNgs2WaveformType::PcmF32Big:
+        return 4;
+    case OrbisNgs2WaveformType::PcmF64Little:
+    case OrbisNgs2WaveformType::PcmF64Big:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+template <typename T, bool BigEndian>
+T Load(const u8* ptr) {
+    T value;
+    std::memcpy(&value, ptr, sizeof(T));
+    if constexpr (BigEndian) {
+        value = std::byteswap(value);
+    }
+    return value;
+}
+
+template <OrbisNgs2WaveformType Type>
+float ReadSample(const u8* ptr) {
+    using enum OrbisNgs2WaveformType;
+    if constexpr (Type == PcmI8) {
+        return static_cast<s8>(*ptr) / 128.0f;
+    } else if constexpr (Type == PcmU8) {
+        return (static_cast<s32>(*ptr) - 128) / 128.0f;
+    } else if constexpr (Type == PcmI16Little || Type == PcmI16Big) {
+        return Load<s16, Type == PcmI16Big>(ptr) / 32768.0f;
+    } else if constexpr (Type == PcmI24Little || Type == PcmI24Big) {
+        const u32 b0 = Type == PcmI24Little ? ptr[0] : ptr[2];
+        const u32 b2 = Type == PcmI24Little ? ptr[2] : ptr[0];
+        const s32 value = static_cast<s32>((b2 << 24) | (ptr[1] << 16) | (b0 << 8)) >> 8;
+        return value / 8388608.0f;
+    } else if constexpr (Type == PcmI32Little || Type == PcmI32Big) {
+        return static_cast<float>(Load<s32, Type == PcmI32Big>(ptr) / 2147483648.0);
+    } else if constexpr (Type == PcmF32Little || Type == PcmF32Big) {
+        return std::bit_cast<float>(Load<u32, Type == PcmF32Big>(ptr));
+    } else {
+        return static_cast<float>(std::bit_cast<double>(Load<u64, Type == PcmF64Big>(ptr)));
+    }
+}
+
+} // Anonymous namespace
+
+Ngs2Sampler::Ngs2Sampler(Ngs2Rack& rack, u32 index) : Ngs2Voice(rack, index) {}
+
+s32 Ngs2Sampler::SetParam(const OrbisNgs2VoiceParamHeader* param) {
+    switch (param->id) {
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_SETUP: {
+        const auto* setup = reinterpret_cast<const OrbisNgs2SamplerVoiceSetupParam*>(param);
+        const auto type = static_cast<OrbisNgs2WaveformType>(setup->format.waveformType);
+        if (setup->format.numChannels == 0 ||
+            setup->format.numChannels > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+            return ORBIS_NGS2_ERROR_INVALID_WAVEFORM_FORMAT;
+        }
+        if (setup->format.sampleRate == 0) {
+            return ORBIS_NGS2_ERROR_INVALID_WAVEFORM_SAMPLE_RATE;
+        }
+        if (type != OrbisNgs2WaveformType::Vag && type != OrbisNgs2WaveformType::Atrac9 &&
+            SampleSize(type) == 0) {
+            return ORBIS_NGS2_ERROR_INVALID_WAVEFORM_TYPE;
+        }
+        if (SampleSize(type) == 0) {
+            LOG_ERROR(Lib_Ngs2, "Unimplemented sampler waveform type {:#x}",
+                      setup->format.waveformType);
+        }
+        format = setup->format;
+        frame_size = SampleSize(type) * format.numChannels;
+        SetChannels(0, format.numChannels);
+        blocks.clear();
+        data = nullptr;
+        pitch = 1.0f;
+        Rewind();
+        state_flags = ORBIS_NGS2_VOICE_STATE_FLAG_INUSE;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_BLOCKS: {
+        const auto* waveform =
+            reinterpret_cast<const OrbisNgs2SamplerVoiceWaveformBlocksParam*>(param);
+        if (rack.max_waveform_blocks != 0 && waveform->numBlocks > rack.max_waveform_blocks) {
+            return ORBIS_NGS2_ERROR_INVALID_NUM_WAVEFORM_BLOCKS;
+        }
+        if (waveform->numBlocks != 0 && !waveform->aBlock) {
+            return ORBIS_NGS2_ERROR_INVALID_WAVEFORM_BLOCK_ADDRESS;
+        }
+        if (waveform->numBlocks != 0 && !waveform->data) {
+            return ORBIS_NGS2_ERROR_INVALID_WAVEFORM_ADDRESS;
+        }
+        data = static_cast<const u8*>(waveform->data);
+        blocks.assign(waveform->aBlock, waveform->aBlock + waveform->numBlocks);
+        Rewind();
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_ADDRESS: {
+        const auto* address =
+            reinterpret_cast<const OrbisNgs2SamplerVoiceWaveformAddressParam*>(param);
+        if (data == address->from) {
+            data = static_cast<const u8*>(address->to);
+        }
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_FRAME_OFFSET: {
+        const auto* offset =
+            reinterpret_cast<const OrbisNgs2SamplerVoiceWaveformFrameOffsetParam*>(param);
+        position = offset->frameOffset;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_EXIT_LOOP:
+        exit_loop = true;
+        return ORBIS_OK;
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_PITCH:
+        pitch = reinterpret_cast<const OrbisNgs2SamplerVoicePitchParam*>(param)->ratio;
+        return ORBIS_OK;
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_ENVELOPE:
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_DISTORTION:
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_USER_FX:
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_PEAK_METER:
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_FILTER:
+    case ORBIS_NGS2_SAMPLER_VOICE_PARAM_NUM_FILTERS:
+        LOG_DEBUG(Lib_Ngs2, "Ignoring sampler voice param {:#x}", param->id);
+        return ORBIS_OK;
+    default:
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ID;
+    }
+}
+
+s32 Ngs2Sampler::HandleEvent(OrbisNgs2VoiceEvent event) {
+    switch (event) {
+    case OrbisNgs2VoiceEvent::Play:
+        if (frame_size == 0) {
+            state_flags = ORBIS_NGS2_VOICE_STATE_FLAG_INUSE | ORBIS_NGS2_VOICE_STATE_FLAG_ERROR;
+            return ORBIS_OK;
+        }
+        Rewind();
+        break;
+    case OrbisNgs2VoiceEvent::Stop:
+    case OrbisNgs2VoiceEvent::StopImm:
+    case OrbisNgs2VoiceEvent::Kill:
+        Rewind();
+        break;
+    default:
+        break;
+    }
+    return Ngs2Voice::HandleEvent(event);
+}
+
+void Ngs2Sampler::Rewind() {
+    block_index = 0;
+    repeat_count = 0;
+    position = 0.0;
+    exit_loop = false;
+    num_decoded_samples = 0;
+    decoded_data_size = 0;
+}
+
+u32 Ngs2Sampler::BlockFrames(const OrbisNgs2WaveformBlock& block) const {
+    const u32 available = block.dataSize / frame_size;
+    if (available <= block.numSkipSamples) {
+        return 0;
+    }
+    const u32 num_frames = available - block.numSkipSamples;
+    return block.numSamples != 0 ? std::min(block.numSamples, num_frames) : num_frames;
+}
+
+bool Ngs2Sampler::AdvanceBlock() {
+    const OrbisNgs2WaveformBlock& block = blocks[block_index];
+    const u32 num_frames = BlockFrames(block);
+    num_decoded_samples += num_frames;
+    decoded_data_size += block.dataSize;
+    if (repeat_count < block.numRepeats && !exit_loop && num_frames != 0) {
+        ++repeat_count;
+        return true;
+    }
+    if (callback_handler) {
+        OrbisNgs2VoiceCallbackInfo& info = pending_callbacks.emplace_back();
+        info.callbackData = callback_data;
+        info.voiceHandle = Handle();
+        info.flag = ORBIS_NGS2_VOICE_CALLBACK_FLAG_WAVEFORM_BLOCK_END;
+        info.param.waveformBlock.userData = block.userData;
+        info.param.waveformBlock.data = data + block.dataOffset;
+        info.param.waveformBlock.dataSize = block.dataSize;
+        info.param.waveformBlock.repeatedCount = repeat_count;
+    }
+    repeat_count = 0;
+    exit_loop = false;
+    if (++block_index < blocks.size()) {
+        return true;
+    }
+    block_index = 0;
+    state_flags = 0;
+    return false;
+}
+
+template <OrbisNgs2WaveformType Type>
+void Ngs2Sampler::Resample(u32 num_samples) {
+    constexpr u32 sample_size = SampleSize(Type);
+    const double ratio = static_cast<double>(pitch) * format.sampleRate / rack.system.sample_rate;
+    // Every block may end at most once within a grain before the sampler gives up on it.
+    u32 num_advances = 0;
+    u32 t = 0;
+    while (t < num_samples) {
+        const OrbisNgs2WaveformBlock& block = blocks[block_index];
+        const u32 num_frames = BlockFrames(block);
+        const u8* base = data + block.dataOffset + block.numSkipSamples * frame_size;
+        for (; t < num_samples && position < num_frames; t++) {
+            const u32 frame_index = static_cast<u32>(position);
+            const float frac = static_cast<float>(position - frame_index);
+            const u8* frame = base + frame_index * frame_size;
+            const u8* next = frame_index + 1 < num_frames ? frame + frame_size : frame;
+            for (u32 ch = 0; ch < num_output_channels; ch++) {
+                const float a = ReadSample<Type>(frame + ch * sample_size);
+                const float b = ReadSample<Type>(next + ch * sample_size);
+                OutputChannel(ch)[t] = a + (b - a) * frac;
+            }
+            position += ratio;
+        }
+        if (position < num_frames) {
+            break;
+        }
+        position -= num_frames;
+        if (!AdvanceBlock() || ++num_advances > blocks.size() * 2) {
+            for (u32 ch = 0; ch < num_output_channels; ch++) {
+                std::fill(OutputChannel(ch) + t, OutputChannel(ch) + num_samples, 0.0f);
+            }
+            position = 0.0;
+            return;
+        }
+    }
+}
+
+void Ngs2Sampler::Process(u32 num_samples) {
+    if (blocks.empty() || !data || frame_size == 0) {
+        for (u32 ch = 0; ch < num_output_channels; ch++) {
+            std::fill_n(OutputChannel(ch), num_samples, 0.0f);
+        }
+        return;
+    }
+    using enum OrbisNgs2WaveformType;
+    switch (static_cast<OrbisNgs2WaveformType>(format.waveformType)) {
+    case PcmI8:
+        return Resample<PcmI8>(num_samples);
+    case PcmU8:
+        return Resample<PcmU8>(num_samples);
+    case PcmI16Little:
+        return Resample<PcmI16Little>(num_samples);
+    case PcmI16Big:
+        return Resample<PcmI16Big>(num_samples);
+    case PcmI24Little:
+        return Resample<PcmI24Little>(num_samples);
+    case PcmI24Big:
+        return Resample<PcmI24Big>(num_samples);
+    case PcmI32Little:
+        return Resample<PcmI32Little>(num_samples);
+    case PcmI32Big:
+        return Resample<PcmI32Big>(num_samples);
+    case PcmF32Little:
+        return Resample<PcmF32Little>(num_samples);
+    case PcmF32Big:
+        return Resample<PcmF32Big>(num_samples);
+    case PcmF64Little:
+        return Resample<PcmF64Little>(num_samples);
+    case PcmF64Big:
+        return Resample<PcmF64Big>(num_samples);
+    default:
+        UNREACHABLE();
+    }
+}
+
+void Ngs2Sampler::FlushCallbacks() {
+    if (pending_callbacks.empty()) {
+        return;
+    }
+    // The handler may control the voice again and raise new callbacks.
+    const auto callbacks = std::move(pending_callbacks);
+    pending_callbacks.clear();
+    for (const OrbisNgs2VoiceCallbackInfo& info : callbacks) {
+        Core::ExecuteGuest(callback_handler, &info);
+    }
+}
+
+s32 Ngs2Sampler::GetState(void* out_state, size_t state_size) const {
+    if (state_size < sizeof(OrbisNgs2SamplerVoiceState)) {
+        return Ngs2Voice::GetState(out_state, state_size);
+    }
+    auto* state = static_cast<OrbisNgs2SamplerVoiceState*>(out_state);
+    std::memset(state, 0, state_size);
+    state->voiceState.stateFlags = state_flags;
+    state->envelopeHeight = 1.0f;
+    state->numDecodedSamples = num_decoded_samples;
+    state->decodedDataSize = decoded_data_size;
+    if (block_index < blocks.size()) {
+        state->userData = blocks[block_index].userData;
+    }
+    state->waveformData = data;
+    return ORBIS_OK;
+}
+
+} // namespace Libraries::Ngs2
@@ -3,11 +3,25 @@
 
 #pragma once
 
+#include <vector>
+
 #include "ngs2.h"
+#include "ngs2_render.h"
 
 namespace Libraries::Ngs2 {
 
-class Ngs2Sampler;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_SETUP = 0x10000001;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_BLOCKS = 0x10000002;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_ADDRESS = 0x10000003;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_WAVEFORM_FRAME_OFFSET = 0x10000004;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_EXIT_LOOP = 0x10000005;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_PITCH = 0x10000006;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_ENVELOPE = 0x10000007;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_DISTORTION = 0x10000008;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_USER_FX = 0x10000009;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_PEAK_METER = 0x1000000A;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_FILTER = 0x1000000B;
+constexpr u32 ORBIS_NGS2_SAMPLER_VOICE_PARAM_NUM_FILTERS = 0x1000000C;
 
 struct OrbisNgs2SamplerRackOption {
     OrbisNgs2RackOption rackOption;
@@ -159,4 +173,45 @@ struct OrbisNgs2SamplerRackInfo {
     u32 maxAjmAtrac9Decoders;
 };
 
+/**
+ * Sampler voice, plays a list of PCM waveform blocks resampled to the system rate.
+ */
+class Ngs2Sampler final : public Ngs2Voice {
+public:
+    explicit Ngs2Sampler(Ngs2Rack& rack, u32 index);
+
+    void Process(u32 num_samples) override;
+    void FlushCallbacks() override;
+    s32 GetState(void* out_state, size_t state_size) const override;
+
+protected:
+    s32 SetParam(const OrbisNgs2VoiceParamHeader* param) override;
+    s32 HandleEvent(OrbisNgs2VoiceEvent event) override;
+
+private:
+    template <OrbisNgs2WaveformType Type>
+    void Resample(u32 num_samples);
+
+    /// Number of frames played from the current block.
+    [[nodiscard]] u32 BlockFrames(const OrbisNgs2WaveformBlock& block) const;
+
+    /// Moves past the end of the current block, returns false once the waveform has ended.
+    bool AdvanceBlock();
+
+    void Rewind();
+
+    OrbisNgs2WaveformFormat format{};
+    u32 frame_size{};
+    const u8* data{};
+    std::vector<OrbisNgs2WaveformBlock> blocks;
+    u32 block_index{};
+    u32 repeat_count{};
+    double position{};
+    float pitch{1.0f};
+    bool exit_loop{};
+    u64 num_decoded_samples{};
+    u64 decoded_data_size{};
+    std::vector<OrbisNgs2VoiceCallbackInfo> pending_callbacks;
+};
+
 } // namespace Libraries::Ngs2
@@ -1,12 +1,70 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <cstring>
+
 #include "ngs2_error.h"
 #include "ngs2_impl.h"
+#include "ngs2_submixer.h"
 
 #include "common/logging/log.h"
 #include "core/libraries/error_codes.h"
 
 using namespace Libraries::Kernel;
 
-namespace Libraries::Ngs2 {} // namespace Libraries::Ngs2
+namespace Libraries::Ngs2 {
+
+Ngs2Submixer::Ngs2Submixer(Ngs2Rack& rack, u32 index) : Ngs2Voice(rack, index) {
+    SetChannels(2, 2);
+}
+
+s32 Ngs2Submixer::SetParam(const OrbisNgs2VoiceParamHeader* param) {
+    switch (param->id) {
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_SETUP: {
+        const auto* setup = reinterpret_cast<const OrbisNgs2SubmixerVoiceSetupParam*>(param);
+        const u32 num_channels = setup->numIoChannels != 0 ? setup->numIoChannels : 2;
+        if (num_channels > ORBIS_NGS2_MAX_VOICE_CHANNELS) {
+            return ORBIS_NGS2_ERROR_INVALID_NUM_CHANNELS;
+        }
+        SetChannels(num_channels, num_channels);
+        state_flags = ORBIS_NGS2_VOICE_STATE_FLAG_INUSE;
+        return ORBIS_OK;
+    }
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_ENVELOPE:
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_COMPRESSOR:
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_DISTORTION:
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_USER_FX:
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_PEAK_METER:
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_FILTER:
+    case ORBIS_NGS2_SUBMIXER_VOICE_PARAM_NUM_FILTERS:
+        LOG_DEBUG(Lib_Ngs2, "Ignoring submixer voice param {:#x}", param->id);
+        return ORBIS_OK;
+    default:
+        return ORBIS_NGS2_ERROR_INVALID_VOICE_CONTROL_ID;
+    }
+}
+
+void Ngs2Submixer::Process(u32 num_samples) {
+    for (u32 ch = 0; ch < num_output_channels; ch++) {
+        if (has_input) {
+            std::copy_n(InputChannel(ch), num_samples, OutputChannel(ch));
+        } else {
+            std::fill_n(OutputChannel(ch), num_samples, 0.0f);
+        }
+    }
+}
+
+s32 Ngs2Submixer::GetState(void* out_state, size_t state_size) const {
+    if (state_size < sizeof(OrbisNgs2SubmixerVoiceState)) {
+        return Ngs2Voice::GetState(out_state, state_size);
+    }
+    auto* state = static_cast<OrbisNgs2SubmixerVoiceState*>(out_state);
+    std::memset(state, 0, state_size);
+    state->voiceState.stateFlags = state_flags;
+    state->envelopeHeight = 1.0f;
+    state->compressorHeight = 1.0f;
+    return ORBIS_OK;
+}
+
+} // namespace Libraries::Ngs2
@@ -4,10 +4,18 @@
 #pragma once
 
 #include "ngs2.h"
+#include "ngs2_render.h"
 
 namespace Libraries::Ngs2 {
 
-class Ngs2Submixer;
+constexpr u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_SETUP = 0x20000001;
+constexpr u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_ENVELOPE = 0x20000002;
+constexpr u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_COMPRESSOR = 0x20000003;
+constexpr u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_DISTORTION = 0x20000004;
+constexpr u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_USER_FX = 0x20000005;
+constexpr u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_PEAK_METER = 0x20000006;
+constexpr u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_FILTER = 0x20000007;
+constexpr u32 ORBIS_NGS2_SUBMIXER_VOICE_PARAM_NUM_FILTERS = 0x20000008;
 
 struct OrbisNgs2SubmixerRackOption {
     OrbisNgs2RackOption rackOption;
@@ -123,4 +131,18 @@ struct OrbisNgs2SubmixerRackInfo {
     u32 maxInputs;
 };
 
+/**
+ * Submixer voice, passes the sum of its inputs on to its ports.
+ */
+class Ngs2Submixer final : public Ngs2Voice {
+public:
+    explicit Ngs2Submixer(Ngs2Rack& rack, u32 index);
+
+    void Process(u32 num_samples) override;
+    s32 GetState(void* out_state, size_t state_size) const override;
+
+protected:
+    s32 SetParam(const OrbisNgs2VoiceParamHeader* param) override;
+};
+
 } // namespace Libraries::Ngs2
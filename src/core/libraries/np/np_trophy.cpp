@@ -1,12 +1,16 @@
 // SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <mutex>
+#include <sstream>
 #include <unordered_map>
 #include <pugixml.hpp>
 
+#include "common/job_system.h"
 #include "common/logging/log.h"
 #include "common/path_util.h"
 #include "common/slot_vector.h"
+#include "core/file_format/trp.h"
 #include "core/libraries/libs.h"
 #include "core/libraries/np/np_error.h"
 #include "core/libraries/np/np_trophy.h"
@@ -18,6 +22,13 @@ namespace Libraries::Np::NpTrophy {
 
 std::string game_serial;
 
+// Waits for the trophies to be extracted if they are still being extracted
+static std::filesystem::path GetTrophyDir() {
+    TRP::WaitForExtraction(game_serial);
+    return Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) / game_serial /
+           "TrophyFiles";
+}
+
 static constexpr auto MaxTrophyHandles = 4u;
 static constexpr auto MaxTrophyContexts = 8u;
 
@@ -31,10 +42,75 @@ struct ContextKeyHash {
 struct TrophyContext {
     u32 context_id;
 };
+
 static Common::SlotVector<OrbisNpTrophyHandle> trophy_handles{};
 static Common::SlotVector<ContextKey> trophy_contexts{};
 static std::unordered_map<ContextKey, TrophyContext, ContextKeyHash> contexts_internal{};
 
+/// TROP.XML of a trophy set, parsed once and served from memory. Unlocks update the document
+/// and persist it from a background job, unlocks that land before the job runs share its write.
+struct TrophySet {
+    std::mutex mutex;
+    pugi::xml_document doc;
+    std::filesystem::path xml_path;
+    bool save_pending{};
+};
+
+static std::mutex trophy_sets_mutex;
+static std::mutex trophy_save_mutex;
+static std::unordered_map<std::string, std::unique_ptr<TrophySet>> trophy_sets{};
+
+static TrophySet* GetTrophySet(const std::filesystem::path& trophy_dir,
+                               const char* trophy_folder) {
+    const auto xml_path = trophy_dir / trophy_folder / "Xml" / "TROP.XML";
+    std::scoped_lock lk{trophy_sets_mutex};
+    if (const auto it = trophy_sets.find(xml_path.string()); it != trophy_sets.end()) {
+        return it->second.get();
+    }
+    auto set = std::make_unique<TrophySet>();
+    const pugi::xml_parse_result result = set->doc.load_file(xml_path.native().c_str());
+    if (!result) {
+        LOG_ERROR(Lib_NpTrophy, "Failed to parse trophy xml : {}", result.description());
+        return nullptr;
+    }
+    set->xml_path = xml_path;
+    return trophy_sets.emplace(xml_path.string(), std::move(set)).first->second.get();
+}
+
+// Must be called with the mutex of the set held.
+static void SaveTrophySet(TrophySet& set) {
+    if (set.save_pending) {
+        return;
+    }
+    set.save_pending = true;
+    Common::JobSystem::Get().Schedule(Common::JobPriority::Background, [&set] {
+        std::scoped_lock save_lk{trophy_save_mutex};
+        std::ostringstream xml;
+        {
+            std::scoped_lock lk{set.mutex};
+            set.save_pending = false;
+            set.doc.save(xml);
+        }
+        // Write to a temporary file first so an interrupted save never leaves a torn file behind.
+        auto temp_path = set.xml_path;
+        temp_path += ".tmp";
+        {
+            const Common::FS::IOFile file{temp_path, Common::FS::FileAccessMode::Write};
+            const std::string data = xml.str();
+            if (file.WriteString(data) != data.size()) {
+                LOG_ERROR(Lib_NpTrophy, "Failed to write trophy xml {}", temp_path.string());
+                return;
+            }
+        }
+        std::error_code ec;
+        std::filesystem::rename(temp_path, set.xml_path, ec);
+        if (ec) {
+            LOG_ERROR(Lib_NpTrophy, "Failed to replace trophy xml {}: {}",
+                      set.xml_path.string(), ec.message());
+        }
+    });
+}
+
 void ORBIS_NP_TROPHY_FLAG_ZERO(OrbisNpTrophyFlagArray* p) {
     for (int i = 0; i < ORBIS_NP_TROPHY_NUM_MAX; i++) {
         uint32_t array_index = i / 32;
@@ -253,8 +329,7 @@ int PS4_SYSV_ABI sceNpTrophyGetGameIcon(OrbisNpTrophyContext context, OrbisNpTro
     char trophy_folder[9];
     snprintf(trophy_folder, sizeof(trophy_folder), "trophy%02d", contextkey.second);
 
-    const auto trophy_dir =
-        Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) / game_serial / "TrophyFiles";
+    const auto trophy_dir = GetTrophyDir();
     auto icon_file = trophy_dir / trophy_folder / "Icons" / "ICON0.PNG";
 
     Common::FS::IOFile icon(icon_file, Common::FS::FileAccessMode::Read);
@@ -306,17 +381,13 @@ int PS4_SYSV_ABI sceNpTrophyGetGameInfo(OrbisNpTrophyContext context, OrbisNpTro
     char trophy_folder[9];
     snprintf(trophy_folder, sizeof(trophy_folder), "trophy%02d", contextkey.second);
 
-    const auto trophy_dir =
-        Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) / game_serial / "TrophyFiles";
-    auto trophy_file = trophy_dir / trophy_folder / "Xml" / "TROP.XML";
-
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(trophy_file.native().c_str());
-
-    if (!result) {
-        LOG_ERROR(Lib_NpTrophy, "Failed to parse trophy xml : {}", result.description());
+    const auto trophy_dir = GetTrophyDir();
+    auto* trophy_set = GetTrophySet(trophy_dir, trophy_folder);
+    if (!trophy_set) {
         return ORBIS_OK;
     }
+    std::scoped_lock lk{trophy_set->mutex};
+    const auto& doc = trophy_set->doc;
 
     GameTrophyInfo game_info{};
 
@@ -413,17 +484,13 @@ int PS4_SYSV_ABI sceNpTrophyGetGroupInfo(OrbisNpTrophyContext context, OrbisNpTr
     char trophy_folder[9];
     snprintf(trophy_folder, sizeof(trophy_folder), "trophy%02d", contextkey.second);
 
-    const auto trophy_dir =
-        Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) / game_serial / "TrophyFiles";
-    auto trophy_file = trophy_dir / trophy_folder / "Xml" / "TROP.XML";
-
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(trophy_file.native().c_str());
-
-    if (!result) {
-        LOG_ERROR(Lib_NpTrophy, "Failed to open trophy xml : {}", result.description());
+    const auto trophy_dir = GetTrophyDir();
+    auto* trophy_set = GetTrophySet(trophy_dir, trophy_folder);
+    if (!trophy_set) {
         return ORBIS_OK;
     }
+    std::scoped_lock lk{trophy_set->mutex};
+    const auto& doc = trophy_set->doc;
 
     GroupTrophyInfo group_info{};
 
@@ -524,17 +591,13 @@ int PS4_SYSV_ABI sceNpTrophyGetTrophyInfo(OrbisNpTrophyContext context, OrbisNpT
     char trophy_folder[9];
     snprintf(trophy_folder, sizeof(trophy_folder), "trophy%02d", contextkey.second);
 
-    const auto trophy_dir =
-        Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) / game_serial / "TrophyFiles";
-    auto trophy_file = trophy_dir / trophy_folder / "Xml" / "TROP.XML";
-
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(trophy_file.native().c_str());
-
-    if (!result) {
-        LOG_ERROR(Lib_NpTrophy, "Failed to open trophy xml : {}", result.description());
+    const auto trophy_dir = GetTrophyDir();
+    auto* trophy_set = GetTrophySet(trophy_dir, trophy_folder);
+    if (!trophy_set) {
         return ORBIS_OK;
     }
+    std::scoped_lock lk{trophy_set->mutex};
+    const auto& doc = trophy_set->doc;
 
     auto trophyconf = doc.child("trophyconf");
 
@@ -598,18 +661,14 @@ s32 PS4_SYSV_ABI sceNpTrophyGetTrophyUnlockState(OrbisNpTrophyContext context,
     char trophy_folder[9];
     snprintf(trophy_folder, sizeof(trophy_folder), "trophy%02d", contextkey.second);
 
-    const auto trophy_dir =
-        Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) / game_serial / "TrophyFiles";
-    auto trophy_file = trophy_dir / trophy_folder / "Xml" / "TROP.XML";
-
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(trophy_file.native().c_str());
-
-    if (!result) {
-        LOG_ERROR(Lib_NpTrophy, "Failed to open trophy XML: {}", result.description());
+    const auto trophy_dir = GetTrophyDir();
+    auto* trophy_set = GetTrophySet(trophy_dir, trophy_folder);
+    if (!trophy_set) {
         *count = 0;
         return ORBIS_OK;
     }
+    std::scoped_lock lk{trophy_set->mutex};
+    const auto& doc = trophy_set->doc;
 
     int num_trophies = 0;
     auto trophyconf = doc.child("trophyconf");
@@ -966,17 +1025,13 @@ int PS4_SYSV_ABI sceNpTrophyUnlockTrophy(OrbisNpTrophyContext context, OrbisNpTr
     char trophy_folder[9];
     snprintf(trophy_folder, sizeof(trophy_folder), "trophy%02d", contextkey.second);
 
-    const auto trophy_dir =
-        Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) / game_serial / "TrophyFiles";
-    auto trophy_file = trophy_dir / trophy_folder / "Xml" / "TROP.XML";
-
-    pugi::xml_document doc;
-    pugi::xml_parse_result result = doc.load_file(trophy_file.native().c_str());
-
-    if (!result) {
-        LOG_ERROR(Lib_NpTrophy, "Failed to parse trophy xml : {}", result.description());
+    const auto trophy_dir = GetTrophyDir();
+    auto* trophy_set = GetTrophySet(trophy_dir, trophy_folder);
+    if (!trophy_set) {
         return ORBIS_OK;
     }
+    std::scoped_lock lk{trophy_set->mutex};
+    auto& doc = trophy_set->doc;
 
     *platinumId = ORBIS_NP_TROPHY_INVALID_TROPHY_ID;
 
@@ -1080,7 +1135,7 @@ int PS4_SYSV_ABI sceNpTrophyUnlockTrophy(OrbisNpTrophyContext context, OrbisNpTr
         }
     }
 
-    doc.save_file((trophy_dir / trophy_folder / "Xml" / "TROP.XML").native().c_str());
+    SaveTrophySet(*trophy_set);
 
     return ORBIS_OK;
 }
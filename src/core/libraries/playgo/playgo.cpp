@@ -310,6 +310,9 @@ s32 PS4_SYSV_ABI scePlayGoPrefetch(OrbisPlayGoHandle handle, const OrbisPlayGoCh
     default:
         return ORBIS_PLAYGO_ERROR_BAD_LOCUS;
     }
+
+    // Chunk locations in playgo-chunk.dat are offsets into the package image, while games run
+    // from the extracted app0 directory, so there are no host file ranges to read ahead here.
     return ORBIS_OK;
 }
 
@@ -9,6 +9,7 @@
 
 #include "save_backup.h"
 #include "save_instance.h"
+#include "save_memory.h"
 
 #include "common/logging/log.h"
 #include "common/logging/log_entry.h"
@@ -36,6 +37,40 @@ static std::deque<BackupRequest> g_result_queue;
 static std::atomic_int g_backup_progress = 0;
 static std::atomic g_backup_status = WorkerStatus::NotStarted;
 
+static bool IsUnchanged(const fs::directory_entry& entry, const fs::path& previous) {
+    std::error_code ec;
+    const auto previous_size = fs::file_size(previous, ec);
+    if (ec || previous_size != entry.file_size()) {
+        return false;
+    }
+    const auto previous_time = fs::last_write_time(previous, ec);
+    return !ec && previous_time == entry.last_write_time();
+}
+
+// Adds a file or directory to the in-progress backup. Files that didn't change since the
+// previous backup are linked to its copy instead of being copied again.
+static void BackupEntry(const fs::directory_entry& entry, const fs::path& target,
+                        const fs::path& previous) {
+    if (entry.is_directory()) {
+        fs::create_directory(target);
+        for (const auto& child : fs::directory_iterator(entry.path())) {
+            const auto filename = child.path().filename();
+            BackupEntry(child, target / filename, previous / filename);
+        }
+        return;
+    }
+    if (IsUnchanged(entry, previous)) {
+        std::error_code ec;
+        fs::create_hard_link(previous, target, ec);
+        if (!ec) {
+            return;
+        }
+    }
+    fs::copy_file(entry.path(), target, fs::copy_options::overwrite_existing);
+    // Keep the time of the original to detect unchanged files in the next backup.
+    fs::last_write_time(target, entry.last_write_time());
+}
+
 static void backup(const std::filesystem::path& dir_name) {
     std::unique_lock lk{g_backup_running_mutex};
     if (!fs::exists(dir_name)) {
@@ -49,11 +84,11 @@ static void backup(const std::filesystem::path& dir_name) {
     fs::remove_all(backup_dir_tmp);
     fs::remove_all(backup_dir_old);
 
-    std::vector<std::filesystem::path> backup_files;
+    std::vector<fs::directory_entry> backup_files;
     for (const auto& entry : fs::directory_iterator(dir_name)) {
         const auto filename = entry.path().filename();
         if (filename != ::backup_dir) {
-            backup_files.push_back(entry.path());
+            backup_files.push_back(entry);
         }
     }
 
@@ -64,7 +99,8 @@ static void backup(const std::filesystem::path& dir_name) {
 
     fs::create_directory(backup_dir_tmp);
     for (const auto& file : backup_files) {
-        fs::copy(file, backup_dir_tmp / file.filename(), fs::copy_options::recursive);
+        const auto filename = file.path().filename();
+        BackupEntry(file, backup_dir_tmp / filename, backup_dir / filename);
         current_count++;
         g_backup_progress = current_count * 100 / total_count;
     }
@@ -107,6 +143,9 @@ static void BackupThreadBody() {
         }
         g_backup_status = WorkerStatus::Running;
 
+        // Save memory written since the request was queued is persisted with a single write.
+        SaveMemory::PersistMemoryAt(req.save_path);
+
         LOG_INFO(Lib_SaveData, "Backing up the following directory: {}",
                  fmt::UTF(req.save_path.u8string()));
         try {
@@ -133,6 +172,8 @@ static void BackupThreadBody() {
         }
         std::this_thread::sleep_for(std::chrono::seconds(5)); // Don't backup too often
     }
+    // Requests still queued are dropped, don't lose the save memory they would have written.
+    SaveMemory::PersistAllMemory();
     g_backup_status = WorkerStatus::NotStarted;
 }
 
@@ -180,8 +221,8 @@ bool NewRequest(OrbisUserServiceUserId user_id, std::string_view title_id,
         std::scoped_lock lk{g_backup_queue_mutex};
         for (const auto& it : g_backup_queue) {
             if (it.dir_name == dir_name) {
-                LOG_TRACE(Lib_SaveData, "Backup request to {} ignored. Already queued", dir_name);
-                return false;
+                LOG_TRACE(Lib_SaveData, "Backup request to {} merged. Already queued", dir_name);
+                return true;
             }
         }
         g_backup_queue.push_back(BackupRequest{
@@ -45,6 +45,7 @@ void StartThread();
 
 void StopThread();
 
+// Returns false if the thread is not running, a request to a queued directory is merged into it
 bool NewRequest(OrbisUserServiceUserId user_id, std::string_view title_id,
                 std::string_view dir_name, OrbisSaveDataEventType origin);
 
@@ -26,6 +26,7 @@ namespace fs = std::filesystem;
 constexpr std::string_view sce_sys = "sce_sys"; // system folder inside save
 constexpr std::string_view StandardDirnameSaveDataMemory = "sce_sdmemory";
 constexpr std::string_view FilenameSaveDataMemory = "memory.dat";
+constexpr std::string_view FilenameSaveDataMemoryTmp = "memory.dat.tmp";
 constexpr std::string_view IconName = "icon0.png";
 constexpr std::string_view CorruptFileName = "corrupted";
 
@@ -40,18 +41,35 @@ struct SlotData {
     PSF sfo;
     std::vector<u8> memory_cache;
     size_t memory_cache_size{};
+    // Range of memory_cache changed since it was last persisted, empty if dirty_end is 0
+    size_t dirty_begin{};
+    size_t dirty_end{};
 };
 
 static std::mutex g_slot_mtx;
 static std::unordered_map<u32, SlotData> g_attached_slots;
+// Serializes the writers so an older snapshot never replaces a newer one
+static std::mutex g_persist_mtx;
 
-void PersistMemory(u32 slot_id, bool lock) {
-    std::unique_lock lck{g_slot_mtx, std::defer_lock};
-    if (lock) {
-        lck.lock();
+void PersistMemory(u32 slot_id) {
+    std::lock_guard persist_lck{g_persist_mtx};
+    std::vector<u8> memory;
+    fs::path memoryPath;
+    {
+        // Write a snapshot, the game can keep changing the cache while the file is written
+        std::lock_guard lck{g_slot_mtx};
+        auto& data = g_attached_slots[slot_id];
+        if (data.dirty_end == 0) {
+            return;
+        }
+        LOG_DEBUG(Lib_SaveData, "Persisting save memory {}, changed range {:#x}-{:#x}", slot_id,
+                  data.dirty_begin, data.dirty_end);
+        data.dirty_begin = 0;
+        data.dirty_end = 0;
+        memory = data.memory_cache;
+        memoryPath = data.folder_path / FilenameSaveDataMemory;
     }
-    auto& data = g_attached_slots[slot_id];
-    auto memoryPath = data.folder_path / FilenameSaveDataMemory;
+    const auto tmpPath = memoryPath.parent_path() / FilenameSaveDataMemoryTmp;
     fs::create_directories(memoryPath.parent_path());
 
     int n = 0;
@@ -59,10 +77,12 @@ void PersistMemory(u32 slot_id, bool lock) {
     while (n++ < 10) {
         try {
             IOFile f;
-            int r = f.Open(memoryPath, Common::FS::FileAccessMode::Write);
+            int r = f.Open(tmpPath, Common::FS::FileAccessMode::Write);
             if (f.IsOpen()) {
-                f.WriteRaw<u8>(data.memory_cache.data(), data.memory_cache.size());
+                f.WriteRaw<u8>(memory.data(), memory.size());
                 f.Close();
+                // Replace the old file at once so a crash never leaves a partial save behind
+                fs::rename(tmpPath, memoryPath);
                 return;
             }
             const auto err = std::error_code{r, std::iostream_category()};
@@ -80,6 +100,34 @@ void PersistMemory(u32 slot_id, bool lock) {
     MsgDialog::ShowMsgDialog(dialog);
 }
 
+void PersistMemoryAt(const std::filesystem::path& save_path) {
+    std::vector<u32> slots;
+    {
+        std::lock_guard lck{g_slot_mtx};
+        for (const auto& [slot_id, data] : g_attached_slots) {
+            if (data.folder_path == save_path) {
+                slots.push_back(slot_id);
+            }
+        }
+    }
+    for (const u32 slot_id : slots) {
+        PersistMemory(slot_id);
+    }
+}
+
+void PersistAllMemory() {
+    std::vector<u32> slots;
+    {
+        std::lock_guard lck{g_slot_mtx};
+        for (const auto& [slot_id, data] : g_attached_slots) {
+            slots.push_back(slot_id);
+        }
+    }
+    for (const u32 slot_id : slots) {
+        PersistMemory(slot_id);
+    }
+}
+
 std::string GetSaveDir(u32 slot_id) {
     std::string dir(StandardDirnameSaveDataMemory);
     if (slot_id > 0) {
@@ -213,15 +261,29 @@ void ReadMemory(u32 slot_id, void* buf, size_t buf_size, int64_t offset) {
 }
 
 void WriteMemory(u32 slot_id, void* buf, size_t buf_size, int64_t offset) {
-    std::lock_guard lk{g_slot_mtx};
+    std::unique_lock lk{g_slot_mtx};
     auto& data = g_attached_slots[slot_id];
     auto& memory = data.memory_cache;
     if (offset + buf_size > memory.size()) {
         memory.resize(offset + buf_size);
+    } else if (std::memcmp(memory.data() + offset, buf, buf_size) == 0) {
+        return; // Games often set the same data again, nothing to persist
     }
     std::memcpy(memory.data() + offset, buf, buf_size);
-    PersistMemory(slot_id, false);
-    Backup::NewRequest(data.user_id, data.game_serial, GetSaveDir(slot_id),
-                       Backup::OrbisSaveDataEventType::__DO_NOT_SAVE);
+    if (data.dirty_end == 0) {
+        data.dirty_begin = offset;
+        data.dirty_end = offset + buf_size;
+    } else {
+        data.dirty_begin = std::min<size_t>(data.dirty_begin, offset);
+        data.dirty_end = std::max<size_t>(data.dirty_end, offset + buf_size);
+    }
+    // The backup thread persists the memory before backing it up. Writes made while the request
+    // is queued are coalesced into the same request and persisted together.
+    const bool queued = Backup::NewRequest(data.user_id, data.game_serial, GetSaveDir(slot_id),
+                                           Backup::OrbisSaveDataEventType::__DO_NOT_SAVE);
+    if (!queued) {
+        lk.unlock();
+        PersistMemory(slot_id);
+    }
 }
 } // namespace Libraries::SaveData::SaveMemory
\ No newline at end of file
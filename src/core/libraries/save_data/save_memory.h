@@ -14,7 +14,13 @@ using OrbisUserServiceUserId = s32;
 
 namespace Libraries::SaveData::SaveMemory {
 
-void PersistMemory(u32 slot_id, bool lock = true);
+// Writes the save memory if it changed since it was last persisted
+void PersistMemory(u32 slot_id);
+
+// Persists the save memory slots stored at save_path
+void PersistMemoryAt(const std::filesystem::path& save_path);
+
+void PersistAllMemory();
 
 [[nodiscard]] std::string GetSaveDir(u32 slot_id);
 
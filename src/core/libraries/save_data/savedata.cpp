@@ -823,7 +823,7 @@ Error PS4_SYSV_ABI sceSaveDataDirNameSearch(const OrbisSaveDataDirNameSearchCond
         const auto dir_path = SaveInstance::MakeDirSavePath(cond->userId, title_id, dir_name);
         const auto sfo_path = SaveInstance::GetParamSFOPath(dir_path);
         PSF sfo;
-        if (!sfo.Open(sfo_path)) {
+        if (!sfo.OpenMapped(sfo_path)) {
             LOG_ERROR(Lib_SaveData, "Failed to read SFO: {}", fmt::UTF(sfo_path.u8string()));
             ASSERT_MSG(false, "Failed to read SFO");
         }
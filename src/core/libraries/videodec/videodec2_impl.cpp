@@ -4,8 +4,10 @@
 #include "videodec2_impl.h"
 
 #include "common/assert.h"
+#include "common/config.h"
 #include "common/logging/log.h"
 #include "core/libraries/videodec/videodec_error.h"
+#include "core/libraries/videodec/videodec_hwaccel.h"
 
 #include "common/support/avdec.h"
 
@@ -44,11 +46,21 @@ VdecDecoder::VdecDecoder(const OrbisVideodec2DecoderConfigInfo& configInfo,
     ASSERT(mCodecContext);
     mCodecContext->width = configInfo.maxFrameWidth;
     mCodecContext->height = configInfo.maxFrameHeight;
+    Videodec::SetupHwAccel(mCodecContext, codec);
 
     avcodec_open2(mCodecContext, codec, nullptr);
+
+    // Reused for every access unit, decoded pictures come from the decoder's own buffer pool.
+    mPacket = av_packet_alloc();
+    mFrame = av_frame_alloc();
+    mSwFrame = av_frame_alloc();
+    ASSERT(mPacket && mFrame && mSwFrame);
 }
 
 VdecDecoder::~VdecDecoder() {
+    av_packet_free(&mPacket);
+    av_frame_free(&mFrame);
+    av_frame_free(&mSwFrame);
     avcodec_free_context(&mCodecContext);
     sws_freeContext(mSwsContext);
 
@@ -75,50 +87,34 @@ s32 VdecDecoder::Decode(const OrbisVideodec2InputData& inputData,
         return ORBIS_VIDEODEC2_ERROR_ACCESS_UNIT_SIZE;
     }
 
-    AVPacket* packet = av_packet_alloc();
-    if (!packet) {
-        LOG_ERROR(Lib_Vdec2, "Failed to allocate packet");
-        return ORBIS_VIDEODEC2_ERROR_API_FAIL;
-    }
-
-    packet->data = (u8*)inputData.auData;
-    packet->size = inputData.auSize;
-    packet->pts = inputData.ptsData;
-    packet->dts = inputData.dtsData;
+    // The packet only points at the guest access unit, the decoder copies what it keeps.
+    mPacket->data = (u8*)inputData.auData;
+    mPacket->size = inputData.auSize;
+    mPacket->pts = inputData.ptsData;
+    mPacket->dts = inputData.dtsData;
 
-    int ret = avcodec_send_packet(mCodecContext, packet);
+    int ret = avcodec_send_packet(mCodecContext, mPacket);
+    mPacket->data = nullptr;
+    mPacket->size = 0;
     if (ret < 0) {
         LOG_ERROR(Lib_Vdec2, "Error sending packet to decoder: {}", ret);
-        av_packet_free(&packet);
-        return ORBIS_VIDEODEC2_ERROR_API_FAIL;
-    }
-
-    AVFrame* frame = av_frame_alloc();
-    if (frame == nullptr) {
-        LOG_ERROR(Lib_Vdec2, "Failed to allocate frame");
-        av_packet_free(&packet);
         return ORBIS_VIDEODEC2_ERROR_API_FAIL;
     }
 
     while (true) {
-        ret = avcodec_receive_frame(mCodecContext, frame);
+        ret = avcodec_receive_frame(mCodecContext, mFrame);
         if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
             break;
         } else if (ret < 0) {
             LOG_ERROR(Lib_Vdec2, "Error receiving frame from decoder: {}", ret);
-            av_packet_free(&packet);
-            av_frame_free(&frame);
             return ORBIS_VIDEODEC2_ERROR_API_FAIL;
         }
 
-        if (frame->format != AV_PIX_FMT_NV12) {
-            AVFrame* nv12_frame = ConvertNV12Frame(*frame);
-            ASSERT(nv12_frame);
-            av_frame_free(&frame);
-            frame = nv12_frame;
+        const AVFrame* frame = mFrame;
+        if (!WriteFrame(*frame, (u8*)frameBuffer.frameBuffer)) {
+            av_frame_unref(mFrame);
+            return ORBIS_VIDEODEC2_ERROR_API_FAIL;
         }
-
-        CopyNV12Data((u8*)frameBuffer.frameBuffer, *frame);
         frameBuffer.isAccepted = true;
 
         outputInfo.codecType = 1; // FIXME: Hardcoded to AVC
@@ -173,10 +169,9 @@ s32 VdecDecoder::Decode(const OrbisVideodec2InputData& inputData,
                 gLegacyPictureInfos.push_back(pictureInfo);
             }
         }
+        av_frame_unref(mFrame);
     }
 
-    av_packet_free(&packet);
-    av_frame_free(&frame);
     return ORBIS_OK;
 }
 
@@ -192,36 +187,26 @@ s32 VdecDecoder::Flush(OrbisVideodec2FrameBuffer& frameBuffer,
         outputInfo.frameFormat = 0;
     }
 
-    AVFrame* frame = av_frame_alloc();
-    if (!frame) {
-        LOG_ERROR(Lib_Vdec2, "Failed to allocate frame");
-        return ORBIS_VIDEODEC2_ERROR_API_FAIL;
-    }
-
     while (true) {
-        int ret = avcodec_receive_frame(mCodecContext, frame);
+        int ret = avcodec_receive_frame(mCodecContext, mFrame);
         if (ret == AVERROR(EAGAIN) || ret == AVERROR_EOF) {
             break;
         } else if (ret < 0) {
             LOG_ERROR(Lib_Vdec2, "Error receiving frame from decoder: {}", ret);
-            av_frame_free(&frame);
             return ORBIS_VIDEODEC2_ERROR_API_FAIL;
         }
 
-        if (frame->format != AV_PIX_FMT_NV12) {
-            AVFrame* nv12_frame = ConvertNV12Frame(*frame);
-            ASSERT(nv12_frame);
-            av_frame_free(&frame);
-            frame = nv12_frame;
+        const AVFrame* frame = mFrame;
+        if (!WriteFrame(*frame, (u8*)frameBuffer.frameBuffer)) {
+            av_frame_unref(mFrame);
+            return ORBIS_VIDEODEC2_ERROR_API_FAIL;
         }
-
-        CopyNV12Data((u8*)frameBuffer.frameBuffer, *frame);
         frameBuffer.isAccepted = true;
 
         outputInfo.codecType = 1; // FIXME: Hardcoded to AVC
         outputInfo.frameWidth = frame->width;
         outputInfo.frameHeight = frame->height;
-        outputInfo.framePitch = frame->linesize[0];
+        outputInfo.framePitch = frame->width;
         outputInfo.frameBufferSize = frameBuffer.frameBufferSize;
         outputInfo.frameBuffer = frameBuffer.frameBuffer;
 
@@ -231,13 +216,13 @@ s32 VdecDecoder::Flush(OrbisVideodec2FrameBuffer& frameBuffer,
 
         // Only set framePitchInBytes if the game uses the newer struct version.
         if (outputInfo.thisSize == sizeof(OrbisVideodec2OutputInfo)) {
-            outputInfo.framePitchInBytes = frame->linesize[0];
+            outputInfo.framePitchInBytes = frame->width;
         }
 
         // FIXME: Should we add picture info here too?
+        av_frame_unref(mFrame);
     }
 
-    av_frame_free(&frame);
     return ORBIS_OK;
 }
 
@@ -247,35 +232,73 @@ s32 VdecDecoder::Reset() {
     return ORBIS_OK;
 }
 
-AVFrame* VdecDecoder::ConvertNV12Frame(AVFrame& frame) {
-    AVFrame* nv12_frame = av_frame_alloc();
-    nv12_frame->pts = frame.pts;
-    nv12_frame->pkt_dts = frame.pkt_dts < 0 ? 0 : frame.pkt_dts;
-    nv12_frame->format = AV_PIX_FMT_NV12;
-    nv12_frame->width = frame.width;
-    nv12_frame->height = frame.height;
-    nv12_frame->sample_aspect_ratio = frame.sample_aspect_ratio;
-    nv12_frame->crop_top = frame.crop_top;
-    nv12_frame->crop_bottom = frame.crop_bottom;
-    nv12_frame->crop_left = frame.crop_left;
-    nv12_frame->crop_right = frame.crop_right;
-
-    av_frame_get_buffer(nv12_frame, 0);
-
-    if (mSwsContext == nullptr) {
-        mSwsContext = sws_getContext(frame.width, frame.height, AVPixelFormat(frame.format),
-                                     nv12_frame->width, nv12_frame->height, AV_PIX_FMT_NV12,
-                                     SWS_FAST_BILINEAR, nullptr, nullptr, nullptr);
+bool VdecDecoder::WriteFrame(const AVFrame& frame, u8* dst) {
+    const AVFrame* src = &frame;
+    if (frame.hw_frames_ctx) {
+        if (!Config::isVideoGpuConversionEnabled() &&
+            Videodec::TransferNV12(frame, dst, frame.width, frame.width * frame.height)) {
+            return true;
+        }
+        if (!DownloadFrame(frame)) {
+            return false;
+        }
+        src = mSwFrame;
+    }
+
+    if (Videodec::UploadToGpu(*src, dst, src->width, src->width * src->height)) {
+        return true;
+    }
+
+    if (src->format == AV_PIX_FMT_NV12) {
+        CopyNV12Data(dst, *src);
+        return true;
+    }
+    return ConvertNV12Frame(*src, dst);
+}
+
+bool VdecDecoder::DownloadFrame(const AVFrame& frame) {
+    // The download target keeps its buffers for as long as the stream format does not change.
+    const auto* frames = reinterpret_cast<const AVHWFramesContext*>(frame.hw_frames_ctx->data);
+    if (mSwFrame->format != frames->sw_format || mSwFrame->width != frame.width ||
+        mSwFrame->height != frame.height) {
+        av_frame_unref(mSwFrame);
+        mSwFrame->format = frames->sw_format;
+        mSwFrame->width = frame.width;
+        mSwFrame->height = frame.height;
+        if (const int ret = av_frame_get_buffer(mSwFrame, 0); ret < 0) {
+            LOG_ERROR(Lib_Vdec2, "Could not allocate download frame: {}", av_err2str(ret));
+            av_frame_unref(mSwFrame);
+            return false;
+        }
+    }
+    if (const int ret = av_hwframe_transfer_data(mSwFrame, &frame, 0); ret < 0) {
+        LOG_ERROR(Lib_Vdec2, "Could not download frame: {}", av_err2str(ret));
+        return false;
+    }
+    return true;
+}
+
+bool VdecDecoder::ConvertNV12Frame(const AVFrame& frame, u8* dst) {
+    mSwsContext = sws_getCachedContext(mSwsContext, frame.width, frame.height,
+                                       AVPixelFormat(frame.format), frame.width, frame.height,
+                                       AV_PIX_FMT_NV12, SWS_FAST_BILINEAR, nullptr, nullptr,
+                                       nullptr);
+    if (!mSwsContext) {
+        LOG_ERROR(Lib_Vdec2, "Could not create NV12 conversion context");
+        return false;
     }
 
+    // Convert straight into the guest frame buffer, laid out the same way as CopyNV12Data.
+    u8* const dst_planes[4] = {dst, dst + frame.width * frame.height, nullptr, nullptr};
+    const int dst_strides[4] = {frame.width, frame.width, 0, 0};
     const auto res = sws_scale(mSwsContext, frame.data, frame.linesize, 0, frame.height,
-                               nv12_frame->data, nv12_frame->linesize);
+                               dst_planes, dst_strides);
     if (res < 0) {
         LOG_ERROR(Lib_Vdec2, "Could not convert to NV12: {}", av_err2str(res));
-        return nullptr;
+        return false;
     }
 
-    return nv12_frame;
+    return true;
 }
 
 } // namespace Libraries::Vdec2
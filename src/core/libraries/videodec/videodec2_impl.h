@@ -9,6 +9,7 @@
 
 extern "C" {
 #include <libavcodec/avcodec.h>
+#include <libavutil/hwcontext.h>
 #include <libavutil/imgutils.h>
 #include <libswscale/swscale.h>
 }
@@ -30,11 +31,18 @@ public:
     s32 Reset();
 
 private:
-    AVFrame* ConvertNV12Frame(AVFrame& frame);
+    /// Writes a decoded frame as NV12 to dst.
+    bool WriteFrame(const AVFrame& frame, u8* dst);
+    /// Downloads a hardware frame that is not NV12 into mSwFrame.
+    bool DownloadFrame(const AVFrame& frame);
+    bool ConvertNV12Frame(const AVFrame& frame, u8* dst);
 
 private:
     AVCodecContext* mCodecContext = nullptr;
     SwsContext* mSwsContext = nullptr;
+    AVPacket* mPacket = nullptr;
+    AVFrame* mFrame = nullptr;
+    AVFrame* mSwFrame = nullptr;
 };
 
 } // namespace Libraries::Vdec2
\ No newline at end of file
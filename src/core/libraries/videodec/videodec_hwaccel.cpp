@@ -0,0 +1,205 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "common/config.h"
+#include "common/logging/log.h"
+#include "core/libraries/videodec/videodec_hwaccel.h"
+#include "video_core/amdgpu/liverpool.h"
+#include "video_core/renderer_vulkan/vk_presenter.h"
+#include "video_core/renderer_vulkan/vk_rasterizer.h"
+
+extern "C" {
+#include <libavutil/hwcontext.h>
+#include <libavutil/pixdesc.h>
+}
+
+#include "common/support/avdec.h"
+
+extern std::unique_ptr<Vulkan::Presenter> presenter;
+extern std::unique_ptr<AmdGpu::Liverpool> liverpool;
+
+namespace Libraries::Videodec {
+
+namespace {
+
+struct HwDevice {
+    AVBufferRef* device{};
+    AVHWDeviceType type{AV_HWDEVICE_TYPE_NONE};
+    AVPixelFormat format{AV_PIX_FMT_NONE};
+};
+
+std::vector<AVHWDeviceType> CandidateDevices() {
+    const std::string name = Config::getVideoHwAccel();
+    if (name == "none") {
+        return {};
+    }
+    if (name != "auto") {
+        const AVHWDeviceType type = av_hwdevice_find_type_by_name(name.c_str());
+        if (type == AV_HWDEVICE_TYPE_NONE) {
+            LOG_WARNING(Lib_Videodec, "Unknown video decoding device type: {}", name);
+            return {};
+        }
+        return {type};
+    }
+#if defined(_WIN32)
+    return {AV_HWDEVICE_TYPE_D3D11VA, AV_HWDEVICE_TYPE_VULKAN};
+#elif defined(__APPLE__)
+    return {AV_HWDEVICE_TYPE_VIDEOTOOLBOX};
+#else
+    return {AV_HWDEVICE_TYPE_VAAPI, AV_HWDEVICE_TYPE_VULKAN};
+#endif
+}
+
+AVPixelFormat FindHwFormat(const AVCodec* codec, AVHWDeviceType type) {
+    for (int i = 0;; i++) {
+        const AVCodecHWConfig* config = avcodec_get_hw_config(codec, i);
+        if (!config) {
+            return AV_PIX_FMT_NONE;
+        }
+        if ((config->methods & AV_CODEC_HW_CONFIG_METHOD_HW_DEVICE_CTX) &&
+            config->device_type == type) {
+            return config->pix_fmt;
+        }
+    }
+}
+
+/// Devices are created once and shared by all decoders, creating one takes a while.
+const HwDevice& GetDevice(const AVCodec* codec) {
+    static std::mutex mutex;
+    static HwDevice device;
+    static bool initialized = false;
+    std::scoped_lock lk{mutex};
+    if (initialized) {
+        return device;
+    }
+    initialized = true;
+    for (const AVHWDeviceType type : CandidateDevices()) {
+        const AVPixelFormat format = FindHwFormat(codec, type);
+        if (format == AV_PIX_FMT_NONE) {
+            continue;
+        }
+        AVBufferRef* ref = nullptr;
+        if (const int ret = av_hwdevice_ctx_create(&ref, type, nullptr, nullptr, 0); ret < 0) {
+            LOG_WARNING(Lib_Videodec, "Failed to create {} device: {}",
+                        av_hwdevice_get_type_name(type), av_err2str(ret));
+            continue;
+        }
+        device = {ref, type, format};
+        LOG_INFO(Lib_Videodec, "Using {} for video decoding", av_hwdevice_get_type_name(type));
+        break;
+    }
+    return device;
+}
+
+AVPixelFormat GetFormat(AVCodecContext* context, const AVPixelFormat* formats) {
+    const auto hw_format = static_cast<AVPixelFormat>(reinterpret_cast<intptr_t>(context->opaque));
+    for (const AVPixelFormat* format = formats; *format != AV_PIX_FMT_NONE; format++) {
+        if (*format == hw_format) {
+            return *format;
+        }
+    }
+    // The device may not support the stream, e.g. due to its profile or size.
+    LOG_WARNING(Lib_Videodec, "Stream not supported by the video decoding device, using software");
+    for (const AVPixelFormat* format = formats; *format != AV_PIX_FMT_NONE; format++) {
+        if (!(av_pix_fmt_desc_get(*format)->flags & AV_PIX_FMT_FLAG_HWACCEL)) {
+            return *format;
+        }
+    }
+    return AV_PIX_FMT_NONE;
+}
+
+} // Anonymous namespace
+
+void SetupHwAccel(AVCodecContext* context, const AVCodec* codec) {
+    const HwDevice& device = GetDevice(codec);
+    if (!device.device) {
+        return;
+    }
+    context->hw_device_ctx = av_buffer_ref(device.device);
+    context->opaque = reinterpret_cast<void*>(static_cast<intptr_t>(device.format));
+    context->get_format = GetFormat;
+}
+
+bool TransferNV12(const AVFrame& frame, u8* dst, u32 pitch, u32 chroma_offset) {
+    const auto* frames = reinterpret_cast<const AVHWFramesContext*>(frame.hw_frames_ctx->data);
+    if (frames->sw_format != AV_PIX_FMT_NV12) {
+        return false;
+    }
+    AVFrame* out = av_frame_alloc();
+    if (!out) {
+        return false;
+    }
+    out->format = AV_PIX_FMT_NV12;
+    out->width = frame.width;
+    out->height = frame.height;
+    // Wrapping the guest buffer keeps the transfer from allocating its own.
+    const size_t size = chroma_offset + static_cast<size_t>(pitch) * ((frame.height + 1) / 2);
+    out->buf[0] = av_buffer_create(dst, size, [](void*, u8*) {}, nullptr, 0);
+    out->data[0] = dst;
+    out->data[1] = dst + chroma_offset;
+    out->linesize[0] = static_cast<int>(pitch);
+    out->linesize[1] = static_cast<int>(pitch);
+    const int ret = out->buf[0] ? av_hwframe_transfer_data(out, &frame, 0) : AVERROR(ENOMEM);
+    av_frame_free(&out);
+    if (ret < 0) {
+        LOG_ERROR(Lib_Videodec, "Failed to download video frame: {}", av_err2str(ret));
+        return false;
+    }
+    return true;
+}
+
+AVFrame* TransferFrame(const AVFrame& frame) {
+    AVFrame* out = av_frame_alloc();
+    if (!out) {
+        return nullptr;
+    }
+    int ret = av_hwframe_transfer_data(out, &frame, 0);
+    if (ret >= 0) {
+        ret = av_frame_copy_props(out, &frame);
+    }
+    if (ret < 0) {
+        LOG_ERROR(Lib_Videodec, "Failed to download video frame: {}", av_err2str(ret));
+        av_frame_free(&out);
+        return nullptr;
+    }
+    return out;
+}
+
+bool UploadToGpu(const AVFrame& frame, u8* dst, u32 pitch, u32 chroma_offset) {
+    if (!Config::isVideoGpuConversionEnabled() || !presenter || !liverpool) {
+        return false;
+    }
+    const bool is_nv12 = frame.format == AV_PIX_FMT_NV12;
+    if (!is_nv12 && frame.format != AV_PIX_FMT_YUV420P && frame.format != AV_PIX_FMT_YUVJ420P) {
+        return false;
+    }
+    const u32 num_planes = is_nv12 ? 2 : 3;
+    for (u32 plane = 0; plane < num_planes; ++plane) {
+        if (frame.linesize[plane] <= 0) {
+            return false;
+        }
+    }
+    const VideoCore::VideoFrame video_frame = {
+        .address = reinterpret_cast<VAddr>(dst),
+        .width = static_cast<u32>(frame.width),
+        .height = static_cast<u32>(frame.height),
+        .pitch = pitch,
+        .chroma_offset = chroma_offset,
+        .is_nv12 = is_nv12,
+        .planes = {frame.data[0], frame.data[1], frame.data[2]},
+        .strides = {static_cast<u32>(frame.linesize[0]), static_cast<u32>(frame.linesize[1]),
+                    static_cast<u32>(frame.linesize[2])},
+    };
+    // The upload is recorded by the GPU thread ahead of the guest submissions that sample the
+    // frame. Waiting for it keeps the decoder planes alive until they are staged.
+    liverpool->SendCommand<true>([&video_frame] {
+        presenter->GetRasterizer().GetTextureCache().UploadVideoFrame(video_frame);
+    });
+    return true;
+}
+
+} // namespace Libraries::Videodec
@@ -0,0 +1,30 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include "common/types.h"
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+namespace Libraries::Videodec {
+
+/// Attaches the configured hardware device to a decoder before it is opened. Decoding stays in
+/// software when hardware decoding is disabled or no device could be created.
+void SetupHwAccel(AVCodecContext* context, const AVCodec* codec);
+
+/// Downloads a hardware frame straight into a guest NV12 buffer. Returns false when the surface
+/// is not stored as NV12 and has to be converted in system memory instead.
+bool TransferNV12(const AVFrame& frame, u8* dst, u32 pitch, u32 chroma_offset);
+
+/// Downloads a hardware frame into a new frame in system memory.
+AVFrame* TransferFrame(const AVFrame& frame);
+
+/// Hands an NV12 or YUV420P frame in system memory to the GPU, which writes it into the texture
+/// cache images backing the guest NV12 buffer at dst instead of the buffer itself. Returns false
+/// when GPU conversion is disabled or the format is not supported.
+bool UploadToGpu(const AVFrame& frame, u8* dst, u32 pitch, u32 chroma_offset);
+
+} // namespace Libraries::Videodec
@@ -7,6 +7,7 @@
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "core/libraries/videodec/videodec_error.h"
+#include "core/libraries/videodec/videodec_hwaccel.h"
 
 #include "common/support/avdec.h"
 
@@ -29,6 +30,7 @@ VdecDecoder::VdecDecoder(const OrbisVideodecConfigInfo& pCfgInfoIn,
     ASSERT(mCodecContext);
     mCodecContext->width = pCfgInfoIn.maxFrameWidth;
     mCodecContext->height = pCfgInfoIn.maxFrameHeight;
+    SetupHwAccel(mCodecContext, codec);
 
     avcodec_open2(mCodecContext, codec, nullptr);
 }
@@ -88,19 +90,16 @@ s32 VdecDecoder::Decode(const OrbisVideodecInputData& pInputDataIn,
             return ORBIS_VIDEODEC_ERROR_API_FAIL;
         }
 
-        if (frame->format != AV_PIX_FMT_NV12) {
-            AVFrame* nv12_frame = ConvertNV12Frame(*frame);
-            ASSERT(nv12_frame);
+        if (!WriteFrame(frame, (u8*)pFrameBufferInOut.pFrameBuffer)) {
+            av_packet_free(&packet);
             av_frame_free(&frame);
-            frame = nv12_frame;
+            return ORBIS_VIDEODEC_ERROR_API_FAIL;
         }
 
-        CopyNV12Data((u8*)pFrameBufferInOut.pFrameBuffer, *frame);
-
         pPictureInfoOut.codecType = 0;
         pPictureInfoOut.frameWidth = Common::AlignUp((u32)frame->width, 16);
         pPictureInfoOut.frameHeight = Common::AlignUp((u32)frame->height, 16);
-        pPictureInfoOut.framePitch = frame->linesize[0];
+        pPictureInfoOut.framePitch = frame->hw_frames_ctx ? frame->width : frame->linesize[0];
 
         pPictureInfoOut.isValid = true;
         pPictureInfoOut.isErrorPic = false;
@@ -138,19 +137,15 @@ s32 VdecDecoder::Flush(OrbisVideodecFrameBuffer& pFrameBufferInOut,
             return ORBIS_VIDEODEC_ERROR_API_FAIL;
         }
 
-        if (frame->format != AV_PIX_FMT_NV12) {
-            AVFrame* nv12_frame = ConvertNV12Frame(*frame);
-            ASSERT(nv12_frame);
+        if (!WriteFrame(frame, (u8*)pFrameBufferInOut.pFrameBuffer)) {
             av_frame_free(&frame);
-            frame = nv12_frame;
+            return ORBIS_VIDEODEC_ERROR_API_FAIL;
         }
 
-        CopyNV12Data((u8*)pFrameBufferInOut.pFrameBuffer, *frame);
-
         pPictureInfoOut.codecType = 0;
         pPictureInfoOut.frameWidth = Common::AlignUp((u32)frame->width, 16);
         pPictureInfoOut.frameHeight = Common::AlignUp((u32)frame->height, 16);
-        pPictureInfoOut.framePitch = frame->linesize[0];
+        pPictureInfoOut.framePitch = frame->hw_frames_ctx ? frame->width : frame->linesize[0];
 
         pPictureInfoOut.isValid = true;
         pPictureInfoOut.isErrorPic = false;
@@ -179,6 +174,31 @@ s32 VdecDecoder::Reset() {
     return ORBIS_OK;
 }
 
+bool VdecDecoder::WriteFrame(AVFrame*& frame, u8* dst) {
+    if (frame->hw_frames_ctx) {
+        const u32 height = Common::AlignUp((u32)frame->height, 16);
+        if (TransferNV12(*frame, dst, frame->width, frame->width * height)) {
+            return true;
+        }
+        AVFrame* sw_frame = TransferFrame(*frame);
+        if (!sw_frame) {
+            return false;
+        }
+        av_frame_free(&frame);
+        frame = sw_frame;
+    }
+
+    if (frame->format != AV_PIX_FMT_NV12) {
+        AVFrame* nv12_frame = ConvertNV12Frame(*frame);
+        ASSERT(nv12_frame);
+        av_frame_free(&frame);
+        frame = nv12_frame;
+    }
+
+    CopyNV12Data(dst, *frame);
+    return true;
+}
+
 AVFrame* VdecDecoder::ConvertNV12Frame(AVFrame& frame) {
     AVFrame* nv12_frame = av_frame_alloc();
     nv12_frame->pts = frame.pts;
@@ -28,6 +28,8 @@ public:
     s32 Reset();
 
 private:
+    /// Writes a decoded frame as NV12 to dst, frame may be replaced by a converted copy.
+    bool WriteFrame(AVFrame*& frame, u8* dst);
     AVFrame* ConvertNV12Frame(AVFrame& frame);
 
 private:
@@ -60,7 +60,7 @@ int VideoOutDriver::Open(const ServiceThreadParams* params) {
 }
 
 void VideoOutDriver::Close(s32 handle) {
-    std::scoped_lock lock{mutex};
+    std::scoped_lock lock{main_port.port_mutex};
 
     main_port.is_open = false;
     main_port.flip_rate = 0;
@@ -169,6 +169,16 @@ void VideoOutDriver::Flip(const Request& req) {
     // Update HDR status before presenting.
     presenter->SetHDR(req.port->is_hdr);
 
+    // Games flipping every other vblank get an interpolated frame for the vblank in between, it
+    // is queued to the swapchain ahead of the flipped frame.
+    if (req.port->flip_rate == 1) {
+        if (auto* interpolated_frame = presenter->PrepareInterpolatedFrame(req.frame)) {
+            presenter->Present(interpolated_frame, true);
+        }
+    } else {
+        presenter->ResetFrameInterpolation();
+    }
+
     // Present the frame.
     presenter->Present(req.frame);
 
@@ -256,8 +266,8 @@ void VideoOutDriver::SubmitFlipInternal(VideoOutPort* port, s32 index, s64 flip_
         frame = presenter->PrepareFrame(group, buffer.address_left);
     }
 
-    std::scoped_lock lock{mutex};
-    requests.push({
+    // Waits for the present thread only if it fell a whole queue of flips behind.
+    requests.EmplaceWait(Request{
         .frame = frame,
         .port = port,
         .flip_arg = flip_arg,
@@ -275,13 +285,9 @@ void VideoOutDriver::PresentThread(std::stop_token token) {
     Common::AccurateTimer timer{vblank_period};
 
     const auto receive_request = [this] -> Request {
-        std::scoped_lock lk{mutex};
-        if (!requests.empty()) {
-            const auto request = requests.front();
-            requests.pop();
-            return request;
-        }
-        return {};
+        Request request{};
+        requests.TryPop(request);
+        return request;
     };
 
     while (!token.stop_requested()) {
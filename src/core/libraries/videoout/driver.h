@@ -3,13 +3,13 @@
 
 #pragma once
 
+#include "common/bounded_threadsafe_queue.h"
 #include "common/debug.h"
 #include "common/polyfill_thread.h"
 #include "core/libraries/videoout/video_out.h"
 
 #include <condition_variable>
 #include <mutex>
-#include <queue>
 
 namespace Vulkan {
 struct Frame;
@@ -92,11 +92,11 @@ public:
 
 private:
     struct Request {
-        Vulkan::Frame* frame;
-        VideoOutPort* port;
-        s64 flip_arg;
-        s32 index;
-        bool eop;
+        Vulkan::Frame* frame{};
+        VideoOutPort* port{};
+        s64 flip_arg{};
+        s32 index{};
+        bool eop{};
 
         operator bool() const noexcept {
             return frame != nullptr;
@@ -109,10 +109,10 @@ private:
     void SubmitFlipInternal(VideoOutPort* port, s32 index, s64 flip_arg, bool is_eop = false);
     void PresentThread(std::stop_token token);
 
-    std::mutex mutex;
     VideoOutPort main_port{};
     std::jthread present_thread;
-    std::queue<Request> requests;
+    // Flips are only queued from the GPU thread and only taken by the present thread.
+    Common::SPSCQueue<Request, 64> requests;
 };
 
 } // namespace Libraries::VideoOut
@@ -1,14 +1,17 @@
 // SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <array>
+#include <bit>
+
 #include "common/alignment.h"
 #include "common/arch.h"
 #include "common/assert.h"
 #include "common/config.h"
 #include "common/elf_info.h"
+#include "common/job_system.h"
 #include "common/logging/log.h"
 #include "common/path_util.h"
-#include "common/string_util.h"
 #include "common/thread.h"
 #include "core/aerolib/aerolib.h"
 #include "core/aerolib/stubs.h"
@@ -21,8 +24,16 @@
 #include "core/tls.h"
 #include "ipc/ipc.h"
 
+#ifdef ARCH_X86_64
+#include <xbyak/xbyak.h>
+#endif
+
 namespace Core {
 
+// Each lazy trampoline loads its slot and jumps to the shared resolver.
+static constexpr u64 LazyCodeSize = 4_MB;
+static constexpr u64 LazyTrampolineSize = 16;
+
 static PS4_SYSV_ABI void ProgramExitFunc() {
     LOG_ERROR(Core_Linker, "Exit function called");
 }
@@ -64,10 +75,15 @@ void Linker::Execute(const std::vector<std::string>& args) {
     Module* module = m_modules[0].get();
     static_tls_size = module->tls.offset = module->tls.image_size;
 
-    // Relocate all modules
+    // Relocate all modules. Relocations only write into their own module and resolve against
+    // exports that are all loaded by now, so the modules are relocated in parallel.
+    Common::JobGroup relocations;
     for (const auto& m : m_modules) {
-        Relocate(m.get());
+        Common::JobSystem::Get().Schedule(
+            Common::JobPriority::FrameCritical, [this, m = m.get()] { Relocate(m); },
+            &relocations);
     }
+    relocations.Wait();
 
     // Configure the direct and flexible memory regions.
     u64 fmem_size = ORBIS_FLEXIBLE_MEMORY_SIZE;
@@ -165,6 +181,9 @@ s32 Linker::LoadModule(const std::filesystem::path& elf_name, bool is_dynamic) {
     }
 
     num_static_modules += !is_dynamic;
+    for (const auto& library : module->GetExportLibs()) {
+        m_export_index[library.name].push_back(module.get());
+    }
     m_modules.emplace_back(std::move(module));
 
     Core::Devtools::Widget::ModuleList::AddModule(elf_name.filename().string(), elf_name);
@@ -212,163 +231,285 @@ Module* Linker::FindByAddress(VAddr address) {
 }
 
 void Linker::Relocate(Module* module) {
+#ifdef ARCH_X86_64
+    const bool allow_lazy = Config::isLazySymbolBindingEnabled();
+#else
+    const bool allow_lazy = false;
+#endif
     module->ForEachRelocation([&](elf_relocation* rel, u32 i, bool is_jmp_rel) {
-        const u32 num_relocs = module->dynamic_info.relocation_table_size / sizeof(elf_relocation);
-        const u32 bit_idx = (is_jmp_rel ? num_relocs : 0) + i;
-        if (module->TestRelaBit(bit_idx)) {
-            return;
-        }
-        auto type = rel->GetType();
-        auto symbol = rel->GetSymbol();
-        auto addend = rel->rel_addend;
-        auto* symbol_table = module->dynamic_info.symbol_table;
-        auto* names_tlb = module->dynamic_info.str_table;
-
-        const VAddr rel_base_virtual_addr = module->GetBaseAddress();
-        const VAddr rel_virtual_addr = rel_base_virtual_addr + rel->rel_offset;
-        bool rel_is_resolved = false;
-        u64 rel_value = 0;
-        Loader::SymbolType rel_sym_type = Loader::SymbolType::Unknown;
-        std::string rel_name;
-
-        switch (type) {
-        case R_X86_64_RELATIVE:
-            rel_value = rel_base_virtual_addr + addend;
-            rel_is_resolved = true;
-            module->SetRelaBit(bit_idx);
+        RelocateEntry(module, rel, i, is_jmp_rel, allow_lazy);
+    });
+}
+
+void Linker::RelocateEntry(Module* module, elf_relocation* rel, u32 i, bool is_jmp_rel,
+                           bool allow_lazy) {
+    const u32 num_relocs = module->dynamic_info.relocation_table_size / sizeof(elf_relocation);
+    const u32 bit_idx = (is_jmp_rel ? num_relocs : 0) + i;
+    if (module->TestRelaBit(bit_idx)) {
+        return;
+    }
+    auto type = rel->GetType();
+    auto symbol = rel->GetSymbol();
+    auto addend = rel->rel_addend;
+    auto* symbol_table = module->dynamic_info.symbol_table;
+    auto* names_tlb = module->dynamic_info.str_table;
+
+    const VAddr rel_base_virtual_addr = module->GetBaseAddress();
+    const VAddr rel_virtual_addr = rel_base_virtual_addr + rel->rel_offset;
+    bool rel_is_resolved = false;
+    u64 rel_value = 0;
+    Loader::SymbolType rel_sym_type = Loader::SymbolType::Unknown;
+    std::string rel_name;
+
+    switch (type) {
+    case R_X86_64_RELATIVE:
+        rel_value = rel_base_virtual_addr + addend;
+        rel_is_resolved = true;
+        module->SetRelaBit(bit_idx);
+        break;
+    case R_X86_64_DTPMOD64:
+        rel_value = static_cast<u64>(module->tls.modid);
+        rel_is_resolved = true;
+        rel_sym_type = Loader::SymbolType::Tls;
+        module->SetRelaBit(bit_idx);
+        break;
+    case R_X86_64_GLOB_DAT:
+    case R_X86_64_JUMP_SLOT:
+        addend = 0;
+    case R_X86_64_64: {
+        auto sym = symbol_table[symbol];
+        auto sym_bind = sym.GetBind();
+        auto sym_type = sym.GetType();
+        auto sym_visibility = sym.GetVisibility();
+        u64 symbol_virtual_addr = 0;
+        Loader::SymbolRecord symrec{};
+        switch (sym_type) {
+        case STT_FUN:
+            rel_sym_type = Loader::SymbolType::Function;
             break;
-        case R_X86_64_DTPMOD64:
-            rel_value = static_cast<u64>(module->tls.modid);
-            rel_is_resolved = true;
-            rel_sym_type = Loader::SymbolType::Tls;
-            module->SetRelaBit(bit_idx);
+        case STT_OBJECT:
+            rel_sym_type = Loader::SymbolType::Object;
             break;
-        case R_X86_64_GLOB_DAT:
-        case R_X86_64_JUMP_SLOT:
-            addend = 0;
-        case R_X86_64_64: {
-            auto sym = symbol_table[symbol];
-            auto sym_bind = sym.GetBind();
-            auto sym_type = sym.GetType();
-            auto sym_visibility = sym.GetVisibility();
-            u64 symbol_virtual_addr = 0;
-            Loader::SymbolRecord symrec{};
-            switch (sym_type) {
-            case STT_FUN:
-                rel_sym_type = Loader::SymbolType::Function;
-                break;
-            case STT_OBJECT:
-                rel_sym_type = Loader::SymbolType::Object;
-                break;
-            case STT_NOTYPE:
-                rel_sym_type = Loader::SymbolType::NoType;
-                break;
-            default:
-                ASSERT_MSG(0, "unknown symbol type {}", sym_type);
-            }
+        case STT_NOTYPE:
+            rel_sym_type = Loader::SymbolType::NoType;
+            break;
+        default:
+            ASSERT_MSG(0, "unknown symbol type {}", sym_type);
+        }
 
-            if (sym_visibility != 0) {
-                LOG_INFO(Core_Linker, "symbol visibility !=0");
-            }
+        if (sym_visibility != 0) {
+            LOG_INFO(Core_Linker, "symbol visibility !=0");
+        }
 
-            switch (sym_bind) {
-            case STB_LOCAL:
-                symbol_virtual_addr = rel_base_virtual_addr + sym.st_value;
-                module->SetRelaBit(bit_idx);
-                break;
-            case STB_GLOBAL:
-            case STB_WEAK: {
-                rel_name = names_tlb + sym.st_name;
+        switch (sym_bind) {
+        case STB_LOCAL:
+            symbol_virtual_addr = rel_base_virtual_addr + sym.st_value;
+            module->SetRelaBit(bit_idx);
+            break;
+        case STB_GLOBAL:
+        case STB_WEAK: {
+            rel_name = names_tlb + sym.st_name;
+            if (type == R_X86_64_JUMP_SLOT && allow_lazy) {
+                // Imported functions are resolved on their first call.
+                std::scoped_lock lk{relocation_mutex};
+                symbol_virtual_addr = GetLazyTrampoline(module, i, rel_virtual_addr);
+                symrec.name = rel_name;
+            }
+            if (symbol_virtual_addr == 0) {
                 if (Resolve(rel_name, rel_sym_type, module, &symrec)) {
                     // Only set the rela bit if the symbol was actually resolved and not stubbed.
                     module->SetRelaBit(bit_idx);
                 }
                 symbol_virtual_addr = symrec.virtual_address;
-                break;
-            }
-            default:
-                UNREACHABLE_MSG("Unknown bind type {}", sym_bind);
             }
-            rel_is_resolved = (symbol_virtual_addr != 0);
-            rel_value = (rel_is_resolved ? symbol_virtual_addr + addend : 0);
-            rel_name = symrec.name;
             break;
         }
         default:
-            LOG_INFO(Core_Linker, "UNK type {:#010x} rel symbol : {:#010x}", type, symbol);
+            UNREACHABLE_MSG("Unknown bind type {}", sym_bind);
         }
+        rel_is_resolved = (symbol_virtual_addr != 0);
+        rel_value = (rel_is_resolved ? symbol_virtual_addr + addend : 0);
+        rel_name = symrec.name;
+        break;
+    }
+    default:
+        LOG_INFO(Core_Linker, "UNK type {:#010x} rel symbol : {:#010x}", type, symbol);
+    }
 
-        if (rel_is_resolved) {
-            std::memcpy(reinterpret_cast<void*>(rel_virtual_addr), &rel_value, sizeof(rel_value));
-        } else {
-            LOG_INFO(Core_Linker, "Function not patched! {}", rel_name);
+    if (rel_is_resolved) {
+        std::memcpy(reinterpret_cast<void*>(rel_virtual_addr), &rel_value, sizeof(rel_value));
+    } else {
+        LOG_INFO(Core_Linker, "Function not patched! {}", rel_name);
+    }
+}
+
+VAddr Linker::GetLazyTrampoline(Module* module, u32 index, VAddr slot_addr) {
+#ifdef ARCH_X86_64
+    const VAddr current = *reinterpret_cast<const VAddr*>(slot_addr);
+    if (IsLazyTrampoline(current)) {
+        // The slot was not called since an earlier relocation pass.
+        return current;
+    }
+
+    using namespace Xbyak::util;
+    if (!lazy_code) {
+        lazy_code = std::make_unique<Xbyak::CodeGenerator>(LazyCodeSize);
+        auto& c = *lazy_code;
+        lazy_resolver = reinterpret_cast<VAddr>(c.getCurr());
+
+        // Preserve the argument registers of the guest call, the stack is 16 byte aligned after
+        // the frame pointer and the eight pushes.
+        static constexpr u32 NumVectorArgs = 8;
+        static constexpr u32 VectorArgSize = 32;
+        const std::array<Xbyak::Reg64, 8> saved_regs{rax, rdi, rsi, rdx, rcx, r8, r9, r10};
+        c.push(rbp);
+        c.mov(rbp, rsp);
+        for (const auto& reg : saved_regs) {
+            c.push(reg);
         }
-    });
+        c.sub(rsp, NumVectorArgs * VectorArgSize);
+        for (u32 i = 0; i < NumVectorArgs; i++) {
+            c.vmovdqu(ptr[rsp + i * VectorArgSize], Xbyak::Ymm(i));
+        }
+
+        c.mov(rdi, r11);
+        c.mov(rax, reinterpret_cast<u64>(&BindLazySlot));
+        c.call(rax);
+        c.mov(r11, rax);
+
+        for (u32 i = 0; i < NumVectorArgs; i++) {
+            c.vmovdqu(Xbyak::Ymm(i), ptr[rsp + i * VectorArgSize]);
+        }
+        c.add(rsp, NumVectorArgs * VectorArgSize);
+        for (auto it = saved_regs.rbegin(); it != saved_regs.rend(); ++it) {
+            c.pop(*it);
+        }
+        c.pop(rbp);
+        c.jmp(r11);
+    }
+
+    auto& c = *lazy_code;
+    if (c.getSize() + LazyTrampolineSize > LazyCodeSize) {
+        LOG_WARNING(Core_Linker, "Lazy binding code is full, binding remaining slots eagerly");
+        return 0;
+    }
+    LazySlot& slot = lazy_slots.emplace_back(this, module, index);
+    const VAddr trampoline = reinterpret_cast<VAddr>(c.getCurr());
+    c.mov(r11, reinterpret_cast<u64>(&slot));
+    c.jmp(reinterpret_cast<const void*>(lazy_resolver), Xbyak::CodeGenerator::LabelType::T_NEAR);
+    return trampoline;
+#else
+    return 0;
+#endif
+}
+
+bool Linker::IsLazyTrampoline(VAddr addr) const {
+#ifdef ARCH_X86_64
+    if (!lazy_code) {
+        return false;
+    }
+    const VAddr base = reinterpret_cast<VAddr>(lazy_code->getCode());
+    return addr >= base && addr < base + LazyCodeSize;
+#else
+    return false;
+#endif
+}
+
+PS4_SYSV_ABI VAddr Linker::BindLazySlot(LazySlot* slot) {
+    Linker& linker = *slot->linker;
+    Module* module = slot->module;
+    elf_relocation* rel = &module->dynamic_info.jmp_relocation_table[slot->index];
+    const auto* slot_addr = reinterpret_cast<const VAddr*>(module->GetBaseAddress() +
+                                                          rel->rel_offset);
+
+    std::scoped_lock lk{linker.mutex};
+    // Another thread may have bound the slot while this one was waiting.
+    if (linker.IsLazyTrampoline(*slot_addr)) {
+        linker.RelocateEntry(module, rel, slot->index, true, false);
+    }
+    const VAddr target = *slot_addr;
+    ASSERT_MSG(!linker.IsLazyTrampoline(target), "Unable to bind jump slot {}", slot->index);
+    return target;
 }
 
 const Module* Linker::FindExportedModule(const ModuleInfo& module, const LibraryInfo& library) {
-    const auto it = std::ranges::find_if(m_modules, [&](const auto& m) {
+    const auto exporters = m_export_index.find(library.name);
+    if (exporters == m_export_index.end()) {
+        return nullptr;
+    }
+    const auto it = std::ranges::find_if(exporters->second, [&](const Module* m) {
         return std::ranges::contains(m->GetExportLibs(), library) &&
                std::ranges::contains(m->GetExportModules(), module);
     });
-    return it == m_modules.end() ? nullptr : it->get();
+    return it == exporters->second.end() ? nullptr : *it;
 }
 
 bool Linker::Resolve(const std::string& name, Loader::SymbolType sym_type, Module* m,
                      Loader::SymbolRecord* return_info) {
-    const auto ids = Common::SplitString(name, '#');
-    if (ids.size() != 3) {
+    // Imported symbol names are made of the NID, the library id and the module id.
+    const std::string_view full_name{name};
+    const size_t lib_pos = full_name.find('#');
+    const size_t mod_pos =
+        lib_pos == std::string_view::npos ? lib_pos : full_name.find('#', lib_pos + 1);
+    if (mod_pos == std::string_view::npos ||
+        full_name.find('#', mod_pos + 1) != std::string_view::npos) {
         return_info->virtual_address = 0;
         return_info->name = name;
         LOG_ERROR(Core_Linker, "Not Resolved {}", name);
         return false;
     }
 
-    const LibraryInfo* library = m->FindLibrary(ids[1]);
-    const ModuleInfo* module = m->FindModule(ids[2]);
+    const std::string_view nid = full_name.substr(0, lib_pos);
+    const std::string_view library_id = full_name.substr(lib_pos + 1, mod_pos - lib_pos - 1);
+    const LibraryInfo* library = m->FindLibrary(library_id);
+    const ModuleInfo* module = m->FindModule(full_name.substr(mod_pos + 1));
     ASSERT_MSG(library && module, "Unable to find library and module");
 
-    Loader::SymbolResolver sr{};
-    sr.name = ids.at(0);
-    sr.library = library->name;
-    sr.library_version = library->version;
-    sr.module = module->name;
-    sr.type = sym_type;
-
-    const auto* record = m_hle_symbols.FindSymbol(sr);
+    const auto* record =
+        m_hle_symbols.FindSymbol(nid, library->name, library->version, module->name, sym_type);
     if (record) {
         *return_info = *record;
-        Core::Devtools::Widget::ModuleList::AddModule(sr.library);
+        Core::Devtools::Widget::ModuleList::AddModule(library->name);
         return true;
     }
 
     // Check if it an export function
     const auto* p = FindExportedModule(*module, *library);
     if (p && p->export_sym.GetSize() > 0) {
-        record = p->export_sym.FindSymbol(sr);
+        record =
+            p->export_sym.FindSymbol(nid, library->name, library->version, module->name, sym_type);
         if (record) {
             *return_info = *record;
             return true;
         }
     }
 
-    const auto aeronid = AeroLib::FindByNid(sr.name.c_str());
+    const std::string nid_str{nid};
+    const auto aeronid = AeroLib::FindByNid(nid_str.c_str());
+    std::scoped_lock lk{relocation_mutex};
     if (aeronid) {
         return_info->name = aeronid->name;
         return_info->virtual_address = AeroLib::GetStub(aeronid->nid);
     } else {
-        return_info->virtual_address = AeroLib::GetStub(sr.name.c_str());
+        return_info->virtual_address = AeroLib::GetStub(nid_str.c_str());
         return_info->name = "Unknown !!!";
     }
-    LOG_ERROR(Core_Linker, "Linker: Stub resolved {} as {} (lib: {}, mod: {})", sr.name,
+    LOG_ERROR(Core_Linker, "Linker: Stub resolved {} as {} (lib: {}, mod: {})", nid,
               return_info->name, library->name, module->name);
     return false;
 }
 
 void* Linker::TlsGetAddr(u64 module_index, u64 offset) {
-    std::scoped_lock lk{mutex};
-
+    // The DTV of a thread is only modified by the thread itself, so a block that is already
+    // present can be returned without locking or checking the generation counter.
     DtvEntry* dtv_table = GetTcbBase()->tcb_dtv;
+    if (module_index <= dtv_table[1].counter) {
+        if (u8* addr = dtv_table[module_index + 1].pointer) {
+            return addr + offset;
+        }
+    }
+
+    std::scoped_lock lk{mutex};
     if (dtv_table[0].counter != dtv_generation_counter) {
         // Generation counter changed, a dynamic module was either loaded or unloaded.
         const u32 old_num_dtvs = dtv_table[1].counter;
@@ -390,8 +531,7 @@ void* Linker::TlsGetAddr(u64 module_index, u64 offset) {
     if (!addr) {
         // Module was just loaded by above code. Allocate TLS block for it.
         const u32 init_image_size = module->tls.init_image_size;
-        u8* dest = reinterpret_cast<u8*>(
-            Core::ExecuteGuest(heap_api->heap_malloc, module->tls.image_size));
+        u8* dest = reinterpret_cast<u8*>(AllocateHeap(module->tls.image_size));
         const u8* src = reinterpret_cast<const u8*>(module->tls.image_virtual_addr);
         std::memcpy(dest, src, init_image_size);
         std::memset(dest + init_image_size, 0, module->tls.image_size - init_image_size);
@@ -421,18 +561,60 @@ void* Linker::AllocateTlsForThread(bool is_primary) {
         const int ret = Libraries::Kernel::sceKernelMapNamedFlexibleMemory(
             &addr_out, tls_aligned, 3, 0, "SceKernelPrimaryTcbTls");
         ASSERT_MSG(ret == 0, "Unable to allocate TLS+TCB for the primary thread");
+        primary_tls = addr_out;
     } else {
-        if (heap_api) {
-            addr_out = Core::ExecuteGuest(heap_api->heap_malloc, total_tls_size);
-        } else {
-            addr_out = std::malloc(total_tls_size);
-        }
+        addr_out = AllocateHeap(total_tls_size);
     }
     return addr_out;
 }
 
 void Linker::FreeTlsForNonPrimaryThread(void* pointer) {
-    if (heap_api) {
+    FreeHeap(pointer);
+}
+
+void* Linker::AllocateHeap(size_t size) {
+    static constexpr u32 MinSizeClass = 6;
+    const u32 size_class = std::max<u32>(std::bit_width(std::max<size_t>(size, 1) - 1),
+                                         MinSizeClass);
+    {
+        std::scoped_lock lk{heap_mutex};
+        auto& blocks = free_heap_blocks[size_class];
+        if (!blocks.empty()) {
+            void* const pointer = blocks.back();
+            blocks.pop_back();
+            return pointer;
+        }
+    }
+    // The allocator in use is recorded, the guest heap may only be registered after the first
+    // threads were created.
+    const size_t class_size = size_t(1) << size_class;
+    const bool is_guest = heap_api != nullptr;
+    void* const pointer = is_guest ? Core::ExecuteGuest(heap_api->heap_malloc, class_size)
+                                   : std::malloc(class_size);
+    if (pointer) {
+        std::scoped_lock lk{heap_mutex};
+        heap_blocks.emplace(pointer, HeapBlock{size_class, is_guest});
+    }
+    return pointer;
+}
+
+void Linker::FreeHeap(void* pointer) {
+    static constexpr size_t MaxFreeBlocksPerClass = 64;
+    bool is_guest = heap_api != nullptr;
+    {
+        std::scoped_lock lk{heap_mutex};
+        const auto it = heap_blocks.find(pointer);
+        if (it != heap_blocks.end()) {
+            auto& blocks = free_heap_blocks[it->second.size_class];
+            if (blocks.size() < MaxFreeBlocksPerClass) {
+                blocks.push_back(pointer);
+                return;
+            }
+            is_guest = it->second.is_guest;
+            heap_blocks.erase(it);
+        }
+    }
+    if (is_guest) {
         Core::ExecuteGuest(heap_api->heap_free, pointer);
     } else {
         std::free(pointer);
@@ -443,20 +625,27 @@ void Linker::DebugDump() {
     const auto& log_dir = Common::FS::GetUserPath(Common::FS::PathType::LogDir);
     const std::filesystem::path debug(log_dir / "debugdump");
     std::filesystem::create_directory(debug);
+    // The dumps only read what was parsed at load time, so they are written in the background
+    // instead of delaying boot. Modules are never unloaded, the pointers stay valid.
+    std::vector<Module*> modules;
     for (const auto& m : m_modules) {
-        Module* module = m.get();
-        auto& elf = module->elf;
-        const std::filesystem::path filepath(debug / module->file.stem());
-        std::filesystem::create_directory(filepath);
-        module->import_sym.DebugDump(filepath / "imports.txt");
-        module->export_sym.DebugDump(filepath / "exports.txt");
-        if (elf.IsSelfFile()) {
-            elf.SelfHeaderDebugDump(filepath / "selfHeader.txt");
-            elf.SelfSegHeaderDebugDump(filepath / "selfSegHeaders.txt");
-        }
-        elf.ElfHeaderDebugDump(filepath / "elfHeader.txt");
-        elf.PHeaderDebugDump(filepath / "elfPHeaders.txt");
+        modules.push_back(m.get());
     }
+    Common::JobSystem::Get().Schedule(Common::JobPriority::Background, [debug, modules] {
+        for (Module* module : modules) {
+            auto& elf = module->elf;
+            const std::filesystem::path filepath(debug / module->file.stem());
+            std::filesystem::create_directory(filepath);
+            module->import_sym.DebugDump(filepath / "imports.txt");
+            module->export_sym.DebugDump(filepath / "exports.txt");
+            if (elf.IsSelfFile()) {
+                elf.SelfHeaderDebugDump(filepath / "selfHeader.txt");
+                elf.SelfSegHeaderDebugDump(filepath / "selfSegHeaders.txt");
+            }
+            elf.ElfHeaderDebugDump(filepath / "elfHeader.txt");
+            elf.PHeaderDebugDump(filepath / "elfPHeaders.txt");
+        }
+    });
 }
 
 } // namespace Core
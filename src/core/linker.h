@@ -4,11 +4,19 @@
 #pragma once
 
 #include <algorithm>
+#include <array>
+#include <deque>
 #include <mutex>
+#include <unordered_map>
 #include <vector>
+#include "common/arch.h"
 #include "core/libraries/kernel/threads.h"
 #include "core/module.h"
 
+namespace Xbyak {
+class CodeGenerator;
+}
+
 namespace Core {
 
 struct DynamicModuleInfo;
@@ -145,6 +153,10 @@ public:
     void* AllocateTlsForThread(bool is_primary);
     void FreeTlsForNonPrimaryThread(void* pointer);
 
+    bool IsPrimaryTls(const void* pointer) const noexcept {
+        return pointer == primary_tls;
+    }
+
     s32 LoadModule(const std::filesystem::path& elf_name, bool is_dynamic = false);
     s32 LoadAndStartModule(const std::filesystem::path& path, u64 args, const void* argp,
                            int* pRes);
@@ -157,18 +169,58 @@ public:
     void DebugDump();
 
 private:
+    /// Jump slot that is bound on the first call through its trampoline.
+    struct LazySlot {
+        Linker* linker;
+        Module* module;
+        u32 index;
+    };
+
+    /// Block of guest heap memory allocated by the emulator itself.
+    struct HeapBlock {
+        u32 size_class;
+        bool is_guest;
+    };
+
+    /// Allocates memory on the guest's behalf. Freed blocks are kept per power of two size
+    /// class and handed out again, so thread churn does not call back into the guest malloc.
+    void* AllocateHeap(size_t size);
+    void FreeHeap(void* pointer);
+
     const Module* FindExportedModule(const ModuleInfo& m, const LibraryInfo& l);
 
+    void RelocateEntry(Module* module, elf_relocation* rel, u32 index, bool is_jmp_rel,
+                       bool allow_lazy);
+
+    /// Returns the trampoline that binds the jump slot at slot_addr, zero when none can be made.
+    VAddr GetLazyTrampoline(Module* module, u32 index, VAddr slot_addr);
+    bool IsLazyTrampoline(VAddr addr) const;
+    static PS4_SYSV_ABI VAddr BindLazySlot(LazySlot* slot);
+
     MemoryManager* memory;
     Libraries::Kernel::Thread main_thread;
     std::mutex mutex;
+    /// Guards the state shared by relocations of different modules, the lazy binding code and
+    /// the stub table.
+    std::mutex relocation_mutex;
     u32 dtv_generation_counter{1};
     size_t static_tls_size{};
     u32 max_tls_index{};
     u32 num_static_modules{};
+    void* primary_tls{};
     AppHeapAPI heap_api{};
+    std::mutex heap_mutex;
+    std::unordered_map<void*, HeapBlock> heap_blocks;
+    std::array<std::vector<void*>, 64> free_heap_blocks;
     std::vector<std::unique_ptr<Module>> m_modules;
+    /// Modules that export each library, by library name.
+    std::unordered_map<std::string, std::vector<const Module*>> m_export_index;
     Loader::SymbolsResolver m_hle_symbols{};
+#ifdef ARCH_X86_64
+    std::unique_ptr<Xbyak::CodeGenerator> lazy_code;
+#endif
+    std::deque<LazySlot> lazy_slots;
+    VAddr lazy_resolver{};
 };
 
 } // namespace Core
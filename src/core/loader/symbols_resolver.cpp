@@ -1,7 +1,11 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <array>
+#include <bit>
 #include <fmt/format.h>
+#include "common/hash.h"
 #include "common/io_file.h"
 #include "common/string_util.h"
 #include "common/types.h"
@@ -11,7 +15,42 @@
 namespace Core::Loader {
 
 void SymbolsResolver::AddSymbol(const SymbolResolver& s, u64 virtual_addr) {
+    // Keep the table at most half full so probe sequences stay short.
+    if ((m_symbols.size() + 1) * 2 > m_index.size()) {
+        const auto old_index = std::move(m_index);
+        m_index.assign(std::max<size_t>(std::bit_ceil((m_symbols.size() + 1) * 4), 1024),
+                       IndexEntry{0, InvalidIndex});
+        for (const IndexEntry& entry : old_index) {
+            if (entry.index != InvalidIndex) {
+                InsertIndex(entry.hash, entry.index);
+            }
+        }
+    }
+    const u32 index = static_cast<u32>(m_symbols.size());
     m_symbols.emplace_back(GenerateName(s), s.nidName, virtual_addr);
+    if (!FindSymbol(s)) {
+        // The first registration of a symbol takes precedence.
+        InsertIndex(HashKey(s.name, s.library, s.library_version, s.module, s.type), index);
+    }
+}
+
+u64 SymbolsResolver::HashKey(std::string_view nid, std::string_view library, u16 library_version,
+                             std::string_view module, SymbolType type) {
+    const std::hash<std::string_view> hasher{};
+    u64 hash = hasher(nid);
+    hash = HashCombine(hash, hasher(library));
+    hash = HashCombine(hash, hasher(module));
+    return HashCombine(hash, (static_cast<u64>(library_version) << 8) | static_cast<u64>(type));
+}
+
+void SymbolsResolver::InsertIndex(u64 hash, u32 index) {
+    const size_t mask = m_index.size() - 1;
+    for (size_t slot = hash & mask;; slot = (slot + 1) & mask) {
+        if (m_index[slot].index == InvalidIndex) {
+            m_index[slot] = {hash, index};
+            return;
+        }
+    }
 }
 
 std::string SymbolsResolver::GenerateName(const SymbolResolver& s) {
@@ -20,14 +59,36 @@ std::string SymbolsResolver::GenerateName(const SymbolResolver& s) {
 }
 
 const SymbolRecord* SymbolsResolver::FindSymbol(const SymbolResolver& s) const {
-    const std::string name = GenerateName(s);
-    for (u32 i = 0; i < m_symbols.size(); i++) {
-        if (m_symbols[i].name == name) {
-            return &m_symbols[i];
+    return FindSymbol(s.name, s.library, s.library_version, s.module, s.type);
+}
+
+const SymbolRecord* SymbolsResolver::FindSymbol(std::string_view nid, std::string_view library,
+                                                u16 library_version, std::string_view module,
+                                                SymbolType type) const {
+    if (m_index.empty()) {
+        return nullptr;
+    }
+
+    // Hash matches are confirmed against the full name, formatted on the stack.
+    std::array<char, 256> name;
+    const auto result = fmt::format_to_n(name.data(), name.size(), "{}#{}#{}#{}#{}", nid,
+                                         library, library_version, module, SymbolTypeToS(type));
+    if (result.size > name.size()) {
+        return nullptr;
+    }
+    const std::string_view full_name{name.data(), result.size};
+
+    const u64 hash = HashKey(nid, library, library_version, module, type);
+    const size_t mask = m_index.size() - 1;
+    for (size_t slot = hash & mask; m_index[slot].index != InvalidIndex;
+         slot = (slot + 1) & mask) {
+        const IndexEntry& entry = m_index[slot];
+        if (entry.hash == hash && m_symbols[entry.index].name == full_name) {
+            return &m_symbols[entry.index];
         }
     }
 
-    // LOG_INFO(Core_Linker, "Unresolved! {}", name);
+    // LOG_INFO(Core_Linker, "Unresolved! {}", full_name);
     return nullptr;
 }
 
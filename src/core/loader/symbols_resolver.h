@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include "common/assert.h"
 #include "common/types.h"
@@ -42,6 +43,9 @@ public:
 
     void AddSymbol(const SymbolResolver& s, u64 virtual_addr);
     const SymbolRecord* FindSymbol(const SymbolResolver& s) const;
+    const SymbolRecord* FindSymbol(std::string_view nid, std::string_view library,
+                                   u16 library_version, std::string_view module,
+                                   SymbolType type) const;
 
     void DebugDump(const std::filesystem::path& file_name);
 
@@ -73,7 +77,21 @@ public:
     }
 
 private:
+    static constexpr u32 InvalidIndex = ~0U;
+
+    struct IndexEntry {
+        u64 hash;
+        u32 index;
+    };
+
+    static u64 HashKey(std::string_view nid, std::string_view library, u16 library_version,
+                       std::string_view module, SymbolType type);
+
+    void InsertIndex(u64 hash, u32 index);
+
     std::vector<SymbolRecord> m_symbols;
+    /// Open addressing table over m_symbols with linear probing, its size is a power of two.
+    std::vector<IndexEntry> m_index;
 };
 
 } // namespace Core::Loader
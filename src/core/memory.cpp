@@ -5,6 +5,7 @@
 #include "common/assert.h"
 #include "common/config.h"
 #include "common/debug.h"
+#include "common/memory_copy.h"
 #include "core/file_sys/fs.h"
 #include "core/libraries/kernel/memory.h"
 #include "core/libraries/kernel/orbis_error.h"
@@ -14,6 +15,15 @@
 
 namespace Core {
 
+static constexpr std::array<const char*, NumVMATypes> VMATypeNames = {
+    "Free", "Reserved", "Direct", "Flexible", "Pooled", "PoolReserved", "Stack", "Code", "File",
+};
+
+static constexpr std::array<const char*, NumHostMirrors> HostMirrorNames = {
+    "BufferCache",
+    "TextureCache",
+};
+
 MemoryManager::MemoryManager() {
     LOG_INFO(Kernel_Vmm, "Virtual memory space initialized with regions:");
 
@@ -112,14 +122,16 @@ void MemoryManager::SetPrtArea(u32 id, VAddr address, u64 size) {
     rasterizer->MapMemory(address, size);
 }
 
-void MemoryManager::CopySparseMemory(VAddr virtual_addr, u8* dest, u64 size) {
+void MemoryManager::CopySparseMemory(VAddr virtual_addr, u8* dest, u64 size, bool streaming) {
     ASSERT_MSG(IsValidMapping(virtual_addr), "Attempted to access invalid address {:#x}",
                virtual_addr);
 
     auto vma = FindVMA(virtual_addr);
     while (size) {
         u64 copy_size = std::min<u64>(vma->second.size - (virtual_addr - vma->first), size);
-        if (vma->second.IsMapped()) {
+        if (vma->second.IsMapped() && streaming) {
+            Common::StreamCopy(dest, std::bit_cast<const u8*>(virtual_addr), copy_size);
+        } else if (vma->second.IsMapped()) {
             std::memcpy(dest, std::bit_cast<const u8*>(virtual_addr), copy_size);
         } else {
             std::memset(dest, 0, copy_size);
@@ -171,6 +183,7 @@ PAddr MemoryManager::PoolExpand(PAddr search_start, PAddr search_end, u64 size,
     if (dmem_area == dmem_map.end()) {
         // There are no suitable mappings in this range
         LOG_ERROR(Kernel_Vmm, "Unable to find free direct memory area: size = {:#x}", size);
+        LogMemoryUsageImpl();
         return -1;
     }
 
@@ -213,6 +226,7 @@ PAddr MemoryManager::Allocate(PAddr search_start, PAddr search_end, u64 size, u6
     if (dmem_area == dmem_map.end()) {
         // There are no suitable mappings in this range
         LOG_ERROR(Kernel_Vmm, "Unable to find free direct memory area: size = {:#x}", size);
+        LogMemoryUsageImpl();
         return -1;
     }
 
@@ -249,6 +263,9 @@ void MemoryManager::Free(PAddr phys_addr, u64 size) {
         UnmapMemoryImpl(addr, size);
     }
 
+    // Return the released physical memory to the host.
+    impl.Discard(phys_addr, size);
+
     // Unmap all dmem areas within this area.
     auto phys_addr_to_search = phys_addr;
     auto remaining_size = size;
@@ -303,6 +320,7 @@ s32 MemoryManager::PoolCommit(VAddr virtual_addr, u64 size, MemoryProt prot, s32
     if (pool_budget <= size) {
         // If there isn't enough pooled memory to perform the mapping, return ENOMEM
         LOG_ERROR(Kernel_Vmm, "Not enough pooled memory to perform mapping");
+        LogMemoryUsageImpl();
         return ORBIS_KERNEL_ERROR_ENOMEM;
     } else {
         // Track how much pooled memory this commit will take
@@ -317,11 +335,13 @@ s32 MemoryManager::PoolCommit(VAddr virtual_addr, u64 size, MemoryProt prot, s32
     // Carve out the new VMA representing this mapping
     const auto new_vma_handle = CarveVMA(mapped_addr, size);
     auto& new_vma = new_vma_handle->second;
+    AccountVMA(new_vma, false);
     new_vma.disallow_merge = false;
     new_vma.prot = prot;
     new_vma.name = "anon";
     new_vma.type = Core::VMAType::Pooled;
     new_vma.is_exec = false;
+    AccountVMA(new_vma, true);
 
     // Find a suitable physical address
     auto handle = dmem_map.begin();
@@ -461,6 +481,7 @@ s32 MemoryManager::MapMemory(void** out_addr, VAddr virtual_addr, u64 size, Memo
         mapped_addr = SearchFree(mapped_addr, size, alignment);
         if (mapped_addr == -1) {
             // No suitable memory areas to map to
+            LogMemoryUsageImpl();
             return ORBIS_KERNEL_ERROR_ENOMEM;
         }
     }
@@ -499,12 +520,14 @@ s32 MemoryManager::MapMemory(void** out_addr, VAddr virtual_addr, u64 size, Memo
     }
 
     const bool is_exec = True(prot & MemoryProt::CpuExec);
+    AccountVMA(new_vma, false);
     new_vma.disallow_merge = True(flags & MemoryMapFlags::NoCoalesce);
     new_vma.prot = prot;
     new_vma.name = name;
     new_vma.type = type;
     new_vma.phys_base = phys_addr == -1 ? 0 : phys_addr;
     new_vma.is_exec = is_exec;
+    AccountVMA(new_vma, true);
 
     if (type == VMAType::Reserved) {
         // Technically this should be done for direct and flexible mappings too,
@@ -576,11 +599,13 @@ s32 MemoryManager::MapFile(void** out_addr, VAddr virtual_addr, u64 size, Memory
 
     // Add virtual memory area
     auto& new_vma = CarveVMA(mapped_addr, size)->second;
+    AccountVMA(new_vma, false);
     new_vma.disallow_merge = True(flags & MemoryMapFlags::NoCoalesce);
     new_vma.prot = prot;
     new_vma.name = "File";
     new_vma.fd = fd;
     new_vma.type = VMAType::File;
+    AccountVMA(new_vma, true);
 
     *out_addr = std::bit_cast<void*>(mapped_addr);
     return ORBIS_OK;
@@ -619,6 +644,7 @@ s32 MemoryManager::PoolDecommit(VAddr virtual_addr, u64 size) {
 
         // Re-pool the direct memory used by this mapping
         const auto unmap_phys_base = phys_base + start_in_vma;
+        impl.Discard(unmap_phys_base, size);
         const auto new_dmem_handle = CarveDmemArea(unmap_phys_base, size);
         auto& new_dmem_area = new_dmem_handle->second;
         new_dmem_area.dma_type = DMAType::Pooled;
@@ -630,11 +656,13 @@ s32 MemoryManager::PoolDecommit(VAddr virtual_addr, u64 size) {
     // Mark region as pool reserved and attempt to coalesce it with neighbours.
     const auto new_it = CarveVMA(virtual_addr, size);
     auto& vma = new_it->second;
+    AccountVMA(vma, false);
     vma.type = VMAType::PoolReserved;
     vma.prot = MemoryProt::NoAccess;
     vma.phys_base = 0;
     vma.disallow_merge = false;
     vma.name = "anon";
+    AccountVMA(vma, true);
     MergeAdjacent(vma_map, new_it);
 
     if (type != VMAType::PoolReserved) {
@@ -701,10 +729,13 @@ u64 MemoryManager::UnmapBytesFromEntry(VAddr virtual_addr, VirtualMemoryArea vma
     if (type == VMAType::Flexible) {
         flexible_usage -= adjusted_size;
 
-        // Now that there is a physical backing used for flexible memory,
-        // manually erase the contents before unmapping to prevent possible issues.
-        const auto unmap_hardware_address = impl.BackingBase() + phys_base + start_in_vma;
-        std::memset(unmap_hardware_address, 0, adjusted_size);
+        // Now that there is a physical backing used for flexible memory, erase the contents
+        // before unmapping to prevent possible issues. Discarding the backing clears it without
+        // touching the pages where the host supports it.
+        if (!impl.Discard(phys_base + start_in_vma, adjusted_size)) {
+            const auto unmap_hardware_address = impl.BackingBase() + phys_base + start_in_vma;
+            std::memset(unmap_hardware_address, 0, adjusted_size);
+        }
 
         // Address space unmap needs the physical_base from the start of the vma,
         // so calculate the phys_base to unmap from here.
@@ -718,6 +749,7 @@ u64 MemoryManager::UnmapBytesFromEntry(VAddr virtual_addr, VirtualMemoryArea vma
     // Mark region as free and attempt to coalesce it with neighbours.
     const auto new_it = CarveVMA(virtual_addr, adjusted_size);
     auto& vma = new_it->second;
+    AccountVMA(vma, false);
     vma.type = VMAType::Free;
     vma.prot = MemoryProt::NoAccess;
     vma.phys_base = 0;
@@ -755,7 +787,7 @@ s32 MemoryManager::UnmapMemoryImpl(VAddr virtual_addr, u64 size) {
 
 s32 MemoryManager::QueryProtection(VAddr addr, void** start, void** end, u32* prot) {
     ASSERT_MSG(IsValidMapping(addr), "Attempted to access invalid address {:#x}", addr);
-    std::scoped_lock lk{mutex};
+    std::shared_lock lk{mutex};
 
     const auto it = FindVMA(addr);
     const auto& vma = it->second;
@@ -868,7 +900,7 @@ s32 MemoryManager::Protect(VAddr addr, u64 size, MemoryProt prot) {
 
 s32 MemoryManager::VirtualQuery(VAddr addr, s32 flags,
                                 ::Libraries::Kernel::OrbisVirtualQueryInfo* info) {
-    std::scoped_lock lk{mutex};
+    std::shared_lock lk{mutex};
 
     // FindVMA on addresses before the vma_map return garbage data.
     auto query_addr =
@@ -913,7 +945,7 @@ s32 MemoryManager::VirtualQuery(VAddr addr, s32 flags,
 
 s32 MemoryManager::DirectMemoryQuery(PAddr addr, bool find_next,
                                      ::Libraries::Kernel::OrbisQueryInfo* out_info) {
-    std::scoped_lock lk{mutex};
+    std::shared_lock lk{mutex};
 
     if (addr >= total_direct_size) {
         LOG_WARNING(Kernel_Vmm, "Unable to find allocated direct memory region to query!");
@@ -948,7 +980,7 @@ s32 MemoryManager::DirectMemoryQuery(PAddr addr, bool find_next,
 
 s32 MemoryManager::DirectQueryAvailable(PAddr search_start, PAddr search_end, u64 alignment,
                                         PAddr* phys_addr_out, u64* size_out) {
-    std::scoped_lock lk{mutex};
+    std::shared_lock lk{mutex};
 
     auto dmem_area = FindDmemArea(search_start);
     PAddr paddr{};
@@ -1071,6 +1103,8 @@ void MemoryManager::NameVirtualRange(VAddr virtual_addr, u64 size, std::string_v
 
 s32 MemoryManager::GetDirectMemoryType(PAddr addr, s32* directMemoryTypeOut,
                                        void** directMemoryStartOut, void** directMemoryEndOut) {
+    std::shared_lock lk{mutex};
+
     if (addr >= total_direct_size) {
         LOG_ERROR(Kernel_Vmm, "Unable to find allocated direct memory region to check type!");
         return ORBIS_KERNEL_ERROR_ENOENT;
@@ -1089,6 +1123,8 @@ s32 MemoryManager::GetDirectMemoryType(PAddr addr, s32* directMemoryTypeOut,
 }
 
 s32 MemoryManager::IsStack(VAddr addr, void** start, void** end) {
+    std::shared_lock lk{mutex};
+
     ASSERT_MSG(IsValidMapping(addr), "Attempted to access invalid address {:#x}", addr);
     const auto& vma = FindVMA(addr)->second;
     if (vma.IsFree()) {
@@ -1114,7 +1150,7 @@ s32 MemoryManager::IsStack(VAddr addr, void** start, void** end) {
 }
 
 s32 MemoryManager::GetMemoryPoolStats(::Libraries::Kernel::OrbisKernelMemoryPoolBlockStats* stats) {
-    std::scoped_lock lk{mutex};
+    std::shared_lock lk{mutex};
 
     // Run through dmem_map, determine how much physical memory is currently committed
     constexpr u64 block_size = 64_KB;
@@ -1142,6 +1178,73 @@ void MemoryManager::InvalidateMemory(const VAddr addr, const u64 size) const {
     }
 }
 
+MemoryUsage MemoryManager::GetMemoryUsage() {
+    std::shared_lock lk{mutex};
+    return GetMemoryUsageImpl();
+}
+
+void MemoryManager::LogMemoryUsage() {
+    std::shared_lock lk{mutex};
+    LogMemoryUsageImpl();
+}
+
+void MemoryManager::TrackHostMirror(HostMirror mirror, s64 delta) {
+    auto& usage = host_mirror_usage[static_cast<u32>(mirror)];
+    const u64 total = usage.fetch_add(delta, std::memory_order_relaxed) + delta;
+    DETAILED_PLOT(HostMirrorNames[static_cast<u32>(mirror)], static_cast<s64>(total));
+}
+
+void MemoryManager::AccountVMA(const VirtualMemoryArea& vma, bool add) {
+    if (vma.IsFree()) {
+        return;
+    }
+    const u32 type = static_cast<u32>(vma.type);
+    if (add) {
+        vma_type_usage[type] += vma.size;
+    } else {
+        vma_type_usage[type] -= vma.size;
+    }
+    DETAILED_PLOT(VMATypeNames[type], static_cast<s64>(vma_type_usage[type]));
+}
+
+MemoryUsage MemoryManager::GetMemoryUsageImpl() {
+    MemoryUsage usage{};
+    usage.vma_bytes = vma_type_usage;
+    for (u32 i = 0; i < NumHostMirrors; ++i) {
+        usage.host_mirror_bytes[i] = host_mirror_usage[i].load(std::memory_order_relaxed);
+    }
+    // Names are not considered when areas are merged, so the totals are gathered here instead of
+    // being tracked with the type totals.
+    for (const auto& [base, vma] : vma_map) {
+        if (vma.IsFree()) {
+            continue;
+        }
+        const auto it = usage.named_bytes.find(vma.name);
+        if (it != usage.named_bytes.end()) {
+            it->second += vma.size;
+        } else {
+            usage.named_bytes.emplace(vma.name, vma.size);
+        }
+    }
+    return usage;
+}
+
+void MemoryManager::LogMemoryUsageImpl() {
+    const MemoryUsage usage = GetMemoryUsageImpl();
+    LOG_INFO(Kernel_Vmm, "Memory usage: direct = {:#x}/{:#x}, flexible = {:#x}/{:#x}",
+             usage.vma_bytes[static_cast<u32>(VMAType::Direct)], total_direct_size,
+             flexible_usage, total_flexible_size);
+    for (u32 i = 1; i < NumVMATypes; ++i) {
+        LOG_INFO(Kernel_Vmm, "  {}: {:#x}", VMATypeNames[i], usage.vma_bytes[i]);
+    }
+    for (u32 i = 0; i < NumHostMirrors; ++i) {
+        LOG_INFO(Kernel_Vmm, "  Host {}: {:#x}", HostMirrorNames[i], usage.host_mirror_bytes[i]);
+    }
+    for (const auto& [name, size] : usage.named_bytes) {
+        LOG_INFO(Kernel_Vmm, "  Named \"{}\": {:#x}", name, size);
+    }
+}
+
 VAddr MemoryManager::SearchFree(VAddr virtual_addr, u64 size, u32 alignment) {
     // Calculate the minimum and maximum addresses present in our address space.
     auto min_search_address = impl.SystemManagedVirtualBase();
@@ -3,10 +3,15 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <map>
+#include <memory_resource>
 #include <mutex>
+#include <shared_mutex>
 #include <string>
 #include <string_view>
+#include "common/debug.h"
 #include "common/enum.h"
 #include "common/singleton.h"
 #include "common/types.h"
@@ -70,6 +75,22 @@ enum class VMAType : u32 {
     Code = 7,
     File = 8,
 };
+constexpr u32 NumVMATypes = 9;
+
+/// Host allocations that shadow guest memory.
+enum class HostMirror : u32 {
+    BufferCache = 0,
+    TextureCache = 1,
+};
+constexpr u32 NumHostMirrors = 2;
+
+struct MemoryUsage {
+    /// Bytes of virtual address space per VMA type, free space is not counted.
+    std::array<u64, NumVMATypes> vma_bytes{};
+    /// Mapped and reserved bytes per VMA name.
+    std::map<std::string, u64, std::less<>> named_bytes;
+    std::array<u64, NumHostMirrors> host_mirror_bytes{};
+};
 
 struct DirectMemoryArea {
     PAddr base = 0;
@@ -157,13 +178,15 @@ struct VirtualMemoryArea {
 };
 
 class MemoryManager {
-    using DMemMap = std::map<PAddr, DirectMemoryArea>;
+    // Areas are carved, split and merged on every mapping call, their nodes come from a pool
+    // owned by the manager instead of the global heap.
+    using DMemMap = std::pmr::map<PAddr, DirectMemoryArea>;
     using DMemHandle = DMemMap::iterator;
 
-    using FMemMap = std::map<PAddr, FlexibleMemoryArea>;
+    using FMemMap = std::pmr::map<PAddr, FlexibleMemoryArea>;
     using FMemHandle = FMemMap::iterator;
 
-    using VMAMap = std::map<VAddr, VirtualMemoryArea>;
+    using VMAMap = std::pmr::map<VAddr, VirtualMemoryArea>;
     using VMAHandle = VMAMap::iterator;
 
 public:
@@ -240,7 +263,9 @@ public:
 
     void SetPrtArea(u32 id, VAddr address, u64 size);
 
-    void CopySparseMemory(VAddr source, u8* dest, u64 size);
+    /// Copies guest memory, unmapped areas read as zero. Streaming copies write dest with
+    /// non-temporal stores, for destinations the CPU does not read back like staging memory.
+    void CopySparseMemory(VAddr source, u8* dest, u64 size, bool streaming = false);
 
     bool TryWriteBacking(void* address, const void* data, u32 num_bytes);
 
@@ -292,6 +317,15 @@ public:
 
     void InvalidateMemory(VAddr addr, u64 size) const;
 
+    /// Returns a snapshot of the guest and host mirror memory totals.
+    MemoryUsage GetMemoryUsage();
+
+    /// Logs the memory totals, used when an allocation runs out of memory.
+    void LogMemoryUsage();
+
+    /// Accounts host memory allocated or released to shadow guest memory.
+    void TrackHostMirror(HostMirror mirror, s64 delta);
+
 private:
     VMAHandle FindVMA(VAddr target) {
         return std::prev(vma_map.upper_bound(target));
@@ -348,16 +382,27 @@ private:
 
     s32 UnmapMemoryImpl(VAddr virtual_addr, u64 size);
 
+    /// Adds or removes the area from the per type totals, the area must not be modified between.
+    void AccountVMA(const VirtualMemoryArea& vma, bool add);
+
+    MemoryUsage GetMemoryUsageImpl();
+
+    void LogMemoryUsageImpl();
+
 private:
     AddressSpace impl;
-    DMemMap dmem_map;
-    FMemMap fmem_map;
-    VMAMap vma_map;
-    std::mutex mutex;
+    std::pmr::unsynchronized_pool_resource area_pool;
+    DMemMap dmem_map{&area_pool};
+    FMemMap fmem_map{&area_pool};
+    VMAMap vma_map{&area_pool};
+    /// Queries take the mutex shared, anything that modifies the maps takes it exclusively.
+    PROFILED_SHARED_MUTEX(std::shared_mutex, mutex);
     u64 total_direct_size{};
     u64 total_flexible_size{};
     u64 flexible_usage{};
     u64 pool_budget{};
+    std::array<u64, NumVMATypes> vma_type_usage{};
+    std::array<std::atomic<u64>, NumHostMirrors> host_mirror_usage{};
     Vulkan::Rasterizer* rasterizer{};
 
     struct PrtArea {
@@ -0,0 +1,207 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fmt/format.h>
+
+#include "common/logging/log.h"
+#include "common/path_util.h"
+#include "common/polyfill_thread.h"
+#include "common/signal_context.h"
+#include "common/singleton.h"
+#include "common/thread.h"
+#include "core/debug_state.h"
+#include "core/linker.h"
+#include "core/sampling_profiler.h"
+#include "core/signals.h"
+
+namespace Core::SamplingProfiler {
+
+namespace {
+
+/// Samples are pushed by the interrupted threads and drained by the sampler after every tick.
+constexpr size_t RingSize = 1 << 16;
+std::array<std::atomic<u64>, RingSize> g_ring{};
+std::atomic<u64> g_write_pos{};
+u64 g_read_pos{};
+
+std::mutex g_mutex;
+std::jthread g_sampler;
+std::unordered_map<u64, u64> g_counts;
+std::atomic<u64> g_num_samples{};
+
+void PushSample(u64 address) {
+    const u64 index = g_write_pos.fetch_add(1, std::memory_order_relaxed);
+    g_ring[index % RingSize].store(address, std::memory_order_release);
+}
+
+[[maybe_unused]] void SampleHandler(void* context) {
+    PushSample(reinterpret_cast<u64>(Common::GetRip(context)));
+}
+
+void SampleGuestThreads() {
+    for (const ThreadID id : DebugState.GetGuestThreads()) {
+#ifdef _WIN32
+        const HANDLE handle = OpenThread(THREAD_SUSPEND_RESUME | THREAD_GET_CONTEXT, FALSE, id);
+        if (!handle) {
+            continue;
+        }
+        if (SuspendThread(handle) != static_cast<DWORD>(-1)) {
+            CONTEXT context{};
+            context.ContextFlags = CONTEXT_CONTROL;
+            if (GetThreadContext(handle, &context)) {
+                PushSample(context.Rip);
+            }
+            ResumeThread(handle);
+        }
+        CloseHandle(handle);
+#else
+        pthread_kill(id, SIGPROF);
+#endif
+    }
+}
+
+void DrainSamples() {
+    const u64 end = g_write_pos.load(std::memory_order_acquire);
+    // Samples that were overwritten before they could be drained are dropped.
+    g_read_pos = std::max(g_read_pos, end > RingSize ? end - RingSize : 0);
+    for (; g_read_pos < end; g_read_pos++) {
+        const u64 address = g_ring[g_read_pos % RingSize].exchange(0, std::memory_order_acquire);
+        if (address != 0) {
+            g_counts[address]++;
+            g_num_samples.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+void SamplerThread(std::stop_token stop, std::chrono::nanoseconds period) {
+    Common::SetCurrentThreadName("shadPS4:Sampler");
+    auto next = std::chrono::steady_clock::now();
+    while (!stop.stop_requested()) {
+        next += period;
+        SampleGuestThreads();
+        {
+            std::scoped_lock lock{g_mutex};
+            DrainSamples();
+        }
+        std::this_thread::sleep_until(next);
+    }
+}
+
+struct ModuleSymbols {
+    VAddr base;
+    VAddr end;
+    std::string name;
+    /// Exported functions sorted by address.
+    std::vector<std::pair<VAddr, std::string>> symbols;
+};
+
+std::vector<ModuleSymbols> CollectModules() {
+    std::vector<ModuleSymbols> modules;
+    auto* linker = Common::Singleton<Linker>::Instance();
+    for (s32 i = 0; const auto* module = linker->GetModule(i); i++) {
+        auto& entry = modules.emplace_back();
+        entry.base = module->GetBaseAddress();
+        entry.end = entry.base + module->aligned_base_size;
+        entry.name = module->name;
+        for (const auto& symbol : module->export_sym.GetSymbols()) {
+            if (symbol.virtual_address < entry.base || symbol.virtual_address >= entry.end) {
+                continue;
+            }
+            entry.symbols.emplace_back(symbol.virtual_address,
+                                       symbol.nid_name != "UNK" ? symbol.nid_name : symbol.name);
+        }
+        std::ranges::sort(entry.symbols, {}, &std::pair<VAddr, std::string>::first);
+    }
+    return modules;
+}
+
+/// Folded stack of a sample, symbols that are not exported are grouped per 4 KiB page.
+std::string GetStack(const std::vector<ModuleSymbols>& modules, VAddr address) {
+    const auto module = std::ranges::find_if(
+        modules, [&](const ModuleSymbols& m) { return address >= m.base && address < m.end; });
+    if (module == modules.end()) {
+        return "[host]";
+    }
+    const auto symbol = std::ranges::upper_bound(module->symbols, address, {},
+                                                 &std::pair<VAddr, std::string>::first);
+    if (symbol != module->symbols.begin()) {
+        return fmt::format("{};{}", module->name, std::prev(symbol)->second);
+    }
+    return fmt::format("{};{}+{:#x}", module->name, module->name,
+                       (address - module->base) & ~VAddr{0xFFF});
+}
+
+} // Anonymous namespace
+
+void Start(u32 frequency) {
+    std::scoped_lock lock{g_mutex};
+    if (g_sampler.joinable()) {
+        return;
+    }
+    g_counts.clear();
+    g_num_samples = 0;
+    g_read_pos = g_write_pos.load();
+#ifndef _WIN32
+    Signals::Instance()->SetSampleHandler(SampleHandler);
+#endif
+    const auto period = std::chrono::nanoseconds{std::chrono::seconds{1}} / std::max(frequency, 1U);
+    g_sampler = std::jthread{SamplerThread, period};
+    LOG_INFO(Core, "Sampling guest threads at {} Hz", frequency);
+}
+
+bool Stop(const std::filesystem::path& path) {
+    std::unordered_map<u64, u64> counts;
+    {
+        std::unique_lock lock{g_mutex};
+        if (!g_sampler.joinable()) {
+            return false;
+        }
+        g_sampler.request_stop();
+        lock.unlock();
+        g_sampler.join();
+        lock.lock();
+        DrainSamples();
+        counts = std::move(g_counts);
+        g_counts.clear();
+    }
+
+    const auto modules = CollectModules();
+    std::unordered_map<std::string, u64> stacks;
+    for (const auto& [address, count] : counts) {
+        stacks[GetStack(modules, address)] += count;
+    }
+    std::vector<std::pair<std::string, u64>> sorted{stacks.begin(), stacks.end()};
+    std::ranges::sort(sorted, std::ranges::greater{}, &std::pair<std::string, u64>::second);
+
+    std::ofstream file{path, std::ios::trunc};
+    for (const auto& [stack, count] : sorted) {
+        file << stack << ' ' << count << '\n';
+    }
+    if (!file) {
+        LOG_ERROR(Core, "Unable to write CPU profile {}", Common::FS::PathToUTF8String(path));
+        return false;
+    }
+    LOG_INFO(Core, "Wrote {} samples to {}", g_num_samples.load(),
+             Common::FS::PathToUTF8String(path));
+    return true;
+}
+
+bool IsRunning() {
+    std::scoped_lock lock{g_mutex};
+    return g_sampler.joinable();
+}
+
+u64 GetNumSamples() {
+    return g_num_samples.load(std::memory_order_relaxed);
+}
+
+} // namespace Core::SamplingProfiler
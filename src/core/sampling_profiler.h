@@ -0,0 +1,28 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+
+#include "common/types.h"
+
+/**
+ * Samples the instruction pointers of the registered guest threads at a fixed rate, to see where
+ * a CPU bound title spends its time. Samples in guest modules are attributed to the nearest
+ * exported symbol, everything else to the host, which covers HLE and emulator overhead.
+ */
+namespace Core::SamplingProfiler {
+
+constexpr u32 DefaultFrequency = 1000;
+
+void Start(u32 frequency = DefaultFrequency);
+
+/// Stops sampling and writes the samples in the folded stack format of flamegraph.pl.
+bool Stop(const std::filesystem::path& path);
+
+[[nodiscard]] bool IsRunning();
+
+[[nodiscard]] u64 GetNumSamples();
+
+} // namespace Core::SamplingProfiler
@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <chrono>
+
 #include "common/arch.h"
 #include "common/assert.h"
 #include "common/decoder.h"
@@ -94,6 +97,9 @@ static void SignalHandler(int sig, siginfo_t* info, void* raw_context) {
                             DisassembleInstruction(code_address));
         }
         break;
+    case SIGPROF:
+        signals->DispatchSample(raw_context);
+        break;
     case SIGUSR1: { // Sleep thread until signal is received
         sigset_t sigset;
         sigemptyset(&sigset);
@@ -124,6 +130,11 @@ SignalDispatch::SignalDispatch() {
                "Failed to register illegal instruction signal handler.");
     ASSERT_MSG(sigaction(SIGUSR1, &action, nullptr) == 0,
                "Failed to register sleep signal handler.");
+
+    // Samples must not interrupt the blocking calls of the guest.
+    action.sa_flags |= SA_RESTART;
+    ASSERT_MSG(sigaction(SIGPROF, &action, nullptr) == 0,
+               "Failed to register profiling signal handler.");
 #endif
 }
 
@@ -144,13 +155,87 @@ SignalDispatch::~SignalDispatch() {
 #endif
 }
 
+void SignalDispatch::SetAccessViolationOwner(VAddr address, size_t size,
+                                             AccessViolationHandler handler) {
+    std::scoped_lock lk{owner_mutex};
+    size_t index = 0;
+    while (index < MaxOwners) {
+        const auto owner = owners[index].load(std::memory_order_relaxed);
+        if (owner == handler) {
+            break;
+        }
+        if (!owner) {
+            owners[index].store(handler, std::memory_order_release);
+            break;
+        }
+        ++index;
+    }
+    ASSERT_MSG(index < MaxOwners, "Too many access violation owners");
+    const size_t first = address >> OwnerBlockBits;
+    const size_t last = std::min((address + size - 1) >> OwnerBlockBits, NumOwnerBlocks - 1);
+    for (size_t block = first; block <= last; ++block) {
+        owner_blocks[block].store(static_cast<u8>(index + 1), std::memory_order_release);
+    }
+}
+
+void SignalDispatch::ClearAccessViolationOwner(VAddr address, size_t size) {
+    std::scoped_lock lk{owner_mutex};
+    // Blocks only partially covered may still hold memory of the owner.
+    const size_t first = (address + (1ULL << OwnerBlockBits) - 1) >> OwnerBlockBits;
+    const size_t end = std::min((address + size) >> OwnerBlockBits, NumOwnerBlocks);
+    for (size_t block = first; block < end; ++block) {
+        owner_blocks[block].store(0, std::memory_order_relaxed);
+    }
+}
+
+SignalDispatch::AccessViolationStats SignalDispatch::GetAccessViolationStats() const {
+    return {
+        .num_faults = num_faults.load(std::memory_order_relaxed),
+        .num_owner_hits = num_owner_hits.load(std::memory_order_relaxed),
+        .total_ns = fault_total_ns.load(std::memory_order_relaxed),
+        .max_ns = fault_max_ns.load(std::memory_order_relaxed),
+    };
+}
+
+AccessViolationHandler SignalDispatch::FindOwner(void* fault_address) const noexcept {
+    const size_t block = reinterpret_cast<VAddr>(fault_address) >> OwnerBlockBits;
+    if (block >= NumOwnerBlocks) {
+        return nullptr;
+    }
+    const u8 owner = owner_blocks[block].load(std::memory_order_acquire);
+    return owner != 0 ? owners[owner - 1].load(std::memory_order_acquire) : nullptr;
+}
+
 bool SignalDispatch::DispatchAccessViolation(void* context, void* fault_address) const {
-    for (const auto& [handler, _] : access_violation_handlers) {
-        if (handler(context, fault_address)) {
-            return true;
+    using Clock = std::chrono::steady_clock;
+    const bool timed = fault_timing.load(std::memory_order_relaxed);
+    const auto start = timed ? Clock::now() : Clock::time_point{};
+    num_faults.fetch_add(1, std::memory_order_relaxed);
+
+    // Faults on tracked memory go straight to its owner, without walking the handler chain.
+    const auto owner = FindOwner(fault_address);
+    bool handled = owner && owner(context, fault_address);
+    if (handled) {
+        num_owner_hits.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        for (const auto& [handler, _] : access_violation_handlers) {
+            if (handler != owner && handler(context, fault_address)) {
+                handled = true;
+                break;
+            }
         }
     }
-    return false;
+
+    if (timed) {
+        const auto elapsed_ns = static_cast<u64>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        fault_total_ns.fetch_add(elapsed_ns, std::memory_order_relaxed);
+        u64 max_ns = fault_max_ns.load(std::memory_order_relaxed);
+        while (elapsed_ns > max_ns &&
+               !fault_max_ns.compare_exchange_weak(max_ns, elapsed_ns, std::memory_order_relaxed)) {
+        }
+    }
+    return handled;
 }
 
 bool SignalDispatch::DispatchIllegalInstruction(void* context) const {
@@ -3,6 +3,9 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <mutex>
 #include <set>
 #include "common/singleton.h"
 #include "common/types.h"
@@ -11,6 +14,7 @@ namespace Core {
 
 using AccessViolationHandler = bool (*)(void* context, void* fault_address);
 using IllegalInstructionHandler = bool (*)(void* context);
+using SampleHandler = void (*)(void* context);
 
 /// Receives OS signals and dispatches to the appropriate handlers.
 class SignalDispatch {
@@ -23,11 +27,45 @@ public:
         access_violation_handlers.emplace(handler, priority);
     }
 
+    /// Makes handler, which must also be registered, the first one tried for faults in the given
+    /// range. Ownership is tracked in coarse blocks, faults the owner declines fall back to the
+    /// ordered handlers.
+    void SetAccessViolationOwner(VAddr address, size_t size, AccessViolationHandler handler);
+
+    /// Removes the owner of the blocks fully covered by the given range.
+    void ClearAccessViolationOwner(VAddr address, size_t size);
+
+    /// Enables measuring the time spent dispatching access violations.
+    void SetFaultTiming(bool enabled) {
+        fault_timing.store(enabled, std::memory_order_relaxed);
+    }
+
+    struct AccessViolationStats {
+        u64 num_faults;
+        u64 num_owner_hits;
+        u64 total_ns;
+        u64 max_ns;
+    };
+
+    [[nodiscard]] AccessViolationStats GetAccessViolationStats() const;
+
     /// Registers a handler for illegal instruction signals.
     void RegisterIllegalInstructionHandler(const IllegalInstructionHandler& handler, u32 priority) {
         illegal_instruction_handlers.emplace(handler, priority);
     }
 
+    /// Sets the handler that receives the context of guest threads interrupted for profiling.
+    void SetSampleHandler(SampleHandler handler) {
+        sample_handler = handler;
+    }
+
+    /// Dispatches a profiling sample signal to the sample handler, if any.
+    void DispatchSample(void* context) const {
+        if (const auto handler = sample_handler.load(std::memory_order_acquire)) {
+            handler(context);
+        }
+    }
+
     /// Dispatches an access violation signal, returning whether it was successfully handled.
     bool DispatchAccessViolation(void* context, void* fault_address) const;
 
@@ -44,8 +82,25 @@ private:
             return priority <=> right.priority;
         }
     };
+    static constexpr size_t OwnerBlockBits = 21;
+    static constexpr size_t OwnerAddressBits = 40;
+    static constexpr size_t NumOwnerBlocks = 1ULL << (OwnerAddressBits - OwnerBlockBits);
+    static constexpr size_t MaxOwners = 8;
+
+    AccessViolationHandler FindOwner(void* fault_address) const noexcept;
+
     std::set<HandlerEntry<AccessViolationHandler>> access_violation_handlers;
+    /// Index plus one of the owning handler of each block, read lock-free by the signal handler.
+    std::array<std::atomic<u8>, NumOwnerBlocks> owner_blocks{};
+    std::array<std::atomic<AccessViolationHandler>, MaxOwners> owners{};
+    std::mutex owner_mutex;
+    std::atomic<bool> fault_timing{};
+    mutable std::atomic<u64> num_faults{};
+    mutable std::atomic<u64> num_owner_hits{};
+    mutable std::atomic<u64> fault_total_ns{};
+    mutable std::atomic<u64> fault_max_ns{};
     std::set<HandlerEntry<IllegalInstructionHandler>> illegal_instruction_handlers;
+    std::atomic<SampleHandler> sample_handler{};
 
 #ifdef _WIN32
     void* handle{};
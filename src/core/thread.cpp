@@ -1,7 +1,19 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <array>
+#include <charconv>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
 #include "common/alignment.h"
+#include "common/config.h"
+#include "common/logging/log.h"
+#include "common/thread.h"
 #include "core/libraries/kernel/threads/pthread.h"
 #include "thread.h"
 #ifdef _WIN64
@@ -10,15 +22,169 @@
 #else
 #include <csignal>
 #include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 #include <xmmintrin.h>
 #endif
+#ifdef __linux__
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#endif
 
 namespace Core {
 
 static constexpr u32 ORBIS_MXCSR = 0x9fc0;
 static constexpr u32 ORBIS_FPUCW = 0x037f;
 
+// Games run on seven of the console's eight cores.
+static constexpr u32 NumGuestCores = 7;
+
+/// Maps an Orbis priority, 256 (highest) to 767 (lowest) with 700 as default, to a host level.
+static Common::ThreadPriority MapGuestPriority(int guest_prio) {
+    if (guest_prio < 448) {
+        return Common::ThreadPriority::VeryHigh;
+    }
+    if (guest_prio < 640) {
+        return Common::ThreadPriority::High;
+    }
+    if (guest_prio <= 700) {
+        return Common::ThreadPriority::Normal;
+    }
+    return Common::ThreadPriority::Low;
+}
+
+/// Returns the logical processor mask of every physical host core, ordered by first processor.
+static std::vector<u64> GetPhysicalCoreMasks() {
+    std::vector<u64> cores;
+#ifdef _WIN64
+    DWORD length = 0;
+    GetLogicalProcessorInformationEx(RelationProcessorCore, nullptr, &length);
+    std::vector<u8> buffer(length);
+    auto* info = reinterpret_cast<SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data());
+    if (!GetLogicalProcessorInformationEx(RelationProcessorCore, info, &length)) {
+        return cores;
+    }
+    for (DWORD offset = 0; offset < length;) {
+        const auto* core =
+            reinterpret_cast<const SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*>(buffer.data() + offset);
+        // Only the first processor group is addressable with a 64-bit mask.
+        if (core->Processor.GroupMask[0].Group == 0) {
+            cores.push_back(static_cast<u64>(core->Processor.GroupMask[0].Mask));
+        }
+        offset += core->Size;
+    }
+#elif defined(__linux__)
+    const auto read_id = [](u32 cpu, const char* name) {
+        std::ifstream file{fmt::format("/sys/devices/system/cpu/cpu{}/topology/{}", cpu, name)};
+        int id = -1;
+        file >> id;
+        return id;
+    };
+    std::map<std::pair<int, int>, u64> core_masks;
+    std::vector<std::pair<int, int>> order;
+    const u32 num_cpus = std::min(std::thread::hardware_concurrency(), 64U);
+    for (u32 cpu = 0; cpu < num_cpus; ++cpu) {
+        std::pair key{read_id(cpu, "physical_package_id"), read_id(cpu, "core_id")};
+        if (key.second < 0) {
+            // Topology is not exposed, treat every processor as its own core.
+            key = {-1, static_cast<int>(cpu)};
+        }
+        if (!core_masks.contains(key)) {
+            order.push_back(key);
+        }
+        core_masks[key] |= 1ULL << cpu;
+    }
+    for (const auto& key : order) {
+        cores.push_back(core_masks[key]);
+    }
+#endif
+    return cores;
+}
+
+/// Returns the host processor mask each guest core is placed on, empty when affinity cannot be
+/// applied on this host.
+static const std::vector<u64>& GetGuestCoreMasks() {
+    static const std::vector<u64> guest_masks = [] {
+        std::vector<u64> host_cores;
+        const std::string host_cpus = Config::getHostCpuCores();
+        if (!host_cpus.empty()) {
+            // A comma separated list of logical processors, one per guest core.
+            const char* it = host_cpus.data();
+            const char* const end = it + host_cpus.size();
+            while (it < end) {
+                u32 cpu{};
+                const auto [next, ec] = std::from_chars(it, end, cpu);
+                if (ec != std::errc{} || cpu >= 64) {
+                    LOG_ERROR(Kernel_Pthread, "Invalid host CPU list \"{}\"", host_cpus);
+                    host_cores.clear();
+                    break;
+                }
+                host_cores.push_back(1ULL << cpu);
+                it = next + 1;
+            }
+        } else {
+            // Give every guest core its own physical core, SMT siblings are only shared once
+            // there are fewer physical cores than guest cores. The first core is left to host
+            // threads when there are enough.
+            host_cores = GetPhysicalCoreMasks();
+            if (host_cores.size() > NumGuestCores) {
+                host_cores.erase(host_cores.begin());
+            }
+        }
+        std::vector<u64> masks;
+        if (host_cores.empty()) {
+            return masks;
+        }
+        masks.resize(NumGuestCores);
+        for (u32 core = 0; core < NumGuestCores; ++core) {
+            masks[core] = host_cores[core % host_cores.size()];
+            LOG_INFO(Kernel_Pthread, "Guest core {} is mapped to host processors {:#x}", core,
+                     masks[core]);
+        }
+        return masks;
+    }();
+    return guest_masks;
+}
+
+#ifndef _WIN64
+/// Signal stacks of exited threads, handed to new threads instead of allocating fresh ones.
+static std::mutex SignalStackMutex;
+static std::vector<void*> FreeSignalStacks;
+
+static size_t SignalStackSize() {
+    static const size_t size =
+        Common::AlignUp(std::max<size_t>(64_KB, MINSIGSTKSZ), getpagesize());
+    return size;
+}
+
+static void* AllocateSignalStack() {
+    {
+        std::scoped_lock lk{SignalStackMutex};
+        if (!FreeSignalStacks.empty()) {
+            void* const stack = FreeSignalStacks.back();
+            FreeSignalStacks.pop_back();
+            return stack;
+        }
+    }
+    void* stack{};
+    ASSERT_MSG(posix_memalign(&stack, getpagesize(), SignalStackSize()) == 0,
+               "Failed to allocate signal stack: {}", errno);
+    return stack;
+}
+
+static void FreeSignalStack(void* stack) {
+    static constexpr size_t MaxFreeSignalStacks = 64;
+    {
+        std::scoped_lock lk{SignalStackMutex};
+        if (FreeSignalStacks.size() < MaxFreeSignalStacks) {
+            FreeSignalStacks.push_back(stack);
+            return;
+        }
+    }
+    free(stack);
+}
+#endif
+
 #ifdef _WIN64
 #define KGDT64_R3_DATA (0x28)
 #define KGDT64_R3_CODE (0x30)
@@ -116,7 +282,7 @@ void NativeThread::Exit() {
     sigaltstack(&sig_stack, nullptr);
 
     if (sig_stack_ptr) {
-        free(sig_stack_ptr);
+        FreeSignalStack(sig_stack_ptr);
         sig_stack_ptr = nullptr;
     }
 
@@ -132,19 +298,84 @@ void NativeThread::Initialize() {
     tid = GetCurrentThreadId();
 #else
     tid = (u64)pthread_self();
+#ifdef __linux__
+    host_tid = static_cast<int>(syscall(SYS_gettid));
+#endif
 
     // Set up an alternate signal handler stack to avoid overflowing small thread stacks.
-    const size_t page_size = getpagesize();
-    const size_t sig_stack_size = Common::AlignUp(std::max<size_t>(64_KB, MINSIGSTKSZ), page_size);
-    ASSERT_MSG(posix_memalign(&sig_stack_ptr, page_size, sig_stack_size) == 0,
-               "Failed to allocate signal stack: {}", errno);
+    sig_stack_ptr = AllocateSignalStack();
 
     stack_t sig_stack;
     sig_stack.ss_sp = sig_stack_ptr;
-    sig_stack.ss_size = sig_stack_size;
+    sig_stack.ss_size = SignalStackSize();
     sig_stack.ss_flags = 0;
     ASSERT_MSG(sigaltstack(&sig_stack, nullptr) == 0, "Failed to set signal stack: {}", errno);
 #endif
 }
 
+void NativeThread::SetPriority(int guest_prio) {
+    if (!Config::isThreadPriorityMappingEnabled() || !native_handle) {
+        return;
+    }
+    const auto priority = MapGuestPriority(guest_prio);
+#ifdef _WIN64
+    static constexpr std::array<int, 4> WindowsPriorities = {
+        THREAD_PRIORITY_BELOW_NORMAL,
+        THREAD_PRIORITY_NORMAL,
+        THREAD_PRIORITY_ABOVE_NORMAL,
+        THREAD_PRIORITY_HIGHEST,
+    };
+    SetThreadPriority(native_handle, WindowsPriorities[static_cast<u32>(priority)]);
+#elif defined(__linux__)
+    // Thread nice values apply per kernel thread id, which is known once the thread has started.
+    if (host_tid == 0) {
+        return;
+    }
+    static constexpr std::array<int, 4> NiceValues = {4, 0, -2, -4};
+    const int nice = NiceValues[static_cast<u32>(priority)];
+    if (setpriority(PRIO_PROCESS, host_tid, nice) != 0 && nice < 0) {
+        // Raising priority requires CAP_SYS_NICE, higher guest priorities stay at the default.
+        setpriority(PRIO_PROCESS, host_tid, 0);
+    }
+#else
+    sched_param param{};
+    const s32 min_prio = sched_get_priority_min(SCHED_OTHER);
+    const s32 max_prio = sched_get_priority_max(SCHED_OTHER);
+    param.sched_priority = min_prio + (max_prio - min_prio) * static_cast<s32>(priority) / 3;
+    pthread_setschedparam(static_cast<pthread_t>(native_handle), SCHED_OTHER, &param);
+#endif
+}
+
+int NativeThread::SetAffinity(u64 guest_mask) {
+    if (!Config::isThreadAffinityMappingEnabled() || !native_handle) {
+        return 0;
+    }
+    const auto& guest_masks = GetGuestCoreMasks();
+    u64 host_mask = 0;
+    for (u32 core = 0; core < guest_masks.size(); ++core) {
+        if (guest_mask & (1ULL << core)) {
+            host_mask |= guest_masks[core];
+        }
+    }
+    if (host_mask == 0) {
+        return 0;
+    }
+#ifdef _WIN64
+    if (!SetThreadAffinityMask(native_handle, static_cast<DWORD_PTR>(host_mask))) {
+        return -1;
+    }
+#elif defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (u32 cpu = 0; cpu < 64; ++cpu) {
+        if (host_mask & (1ULL << cpu)) {
+            CPU_SET(cpu, &cpu_set);
+        }
+    }
+    return pthread_setaffinity_np(static_cast<pthread_t>(native_handle), sizeof(cpu_set),
+                                  &cpu_set);
+#endif
+    return 0;
+}
+
 } // namespace Core
@@ -24,6 +24,13 @@ public:
 
     void Initialize();
 
+    /// Applies a guest thread priority to the host thread when priority mapping is enabled.
+    void SetPriority(int guest_prio);
+
+    /// Restricts the host thread to the host cores the guest cores of the mask are mapped to,
+    /// when affinity mapping is enabled.
+    int SetAffinity(u64 guest_mask);
+
     uintptr_t GetHandle() {
         return reinterpret_cast<uintptr_t>(native_handle);
     }
@@ -38,6 +45,7 @@ private:
 #else
     uintptr_t native_handle;
     void* sig_stack_ptr;
+    int host_tid{};
 #endif
     u64 tid;
 };
@@ -19,7 +19,9 @@
 #include <pthread.h>
 #endif
 #if defined(__linux__) && defined(ARCH_X86_64)
+#include <asm/hwcap2.h>
 #include <asm/prctl.h>
+#include <sys/auxv.h>
 #include <sys/prctl.h>
 #endif
 
@@ -158,17 +160,32 @@ Tcb* GetTcbBase() {
 #elif defined(ARCH_X86_64)
 
 // Other POSIX x86_64
+// The host owns FS, so guest FS accesses are patched to GS and GS points to the TCB.
+
+/// Whether the kernel lets user space write the segment base registers directly.
+static bool HasUserFsGsBase() {
+#ifdef __linux__
+    static const bool has_fsgsbase = (getauxval(AT_HWCAP2) & HWCAP2_FSGSBASE) != 0;
+    return has_fsgsbase;
+#else
+    return false;
+#endif
+}
 
 void SetTcbBase(void* image_address) {
+    if (HasUserFsGsBase()) {
+        asm volatile("wrgsbase %0" ::"r"(image_address) : "memory");
+        return;
+    }
     const int ret = syscall(SYS_arch_prctl, ARCH_SET_GS, (unsigned long)image_address);
     ASSERT_MSG(ret == 0, "Failed to set GS base: errno {}", errno);
 }
 
 Tcb* GetTcbBase() {
-    void* tcb = nullptr;
-    const int ret = syscall(SYS_arch_prctl, ARCH_GET_GS, &tcb);
-    ASSERT_MSG(ret == 0, "Failed to get GS base: errno {}", errno);
-    return static_cast<Tcb*>(tcb);
+    // The TCB starts with a pointer to itself, read it like guest code does.
+    Tcb* tcb;
+    asm volatile("mov %%gs:0x0, %0" : "=r"(tcb));
+    return tcb;
 }
 
 #else
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <chrono>
 #include <filesystem>
 #include <fstream>
 #include <iostream>
@@ -23,12 +24,14 @@
 #include "common/discord_rpc_handler.h"
 #endif
 #include "common/elf_info.h"
+#include "common/job_system.h"
 #include "common/memory_patcher.h"
 #include "common/ntapi.h"
 #include "common/path_util.h"
 #include "common/polyfill_thread.h"
 #include "common/scm_rev.h"
 #include "common/singleton.h"
+#include "core/benchmark.h"
 #include "core/debugger.h"
 #include "core/devtools/widget/module_list.h"
 #include "core/file_format/psf.h"
@@ -44,7 +47,10 @@
 #include "core/linker.h"
 #include "core/memory.h"
 #include "emulator.h"
+#include "input/input_recording.h"
 #include "video_core/renderdoc.h"
+#include "video_core/renderer_vulkan/vk_presenter.h"
+#include "video_core/renderer_vulkan/vk_rasterizer.h"
 
 #ifdef _WIN32
 #include <WinSock2.h>
@@ -56,9 +62,17 @@
 #endif
 
 Frontend::WindowSDL* g_window = nullptr;
+extern std::unique_ptr<Vulkan::Presenter> presenter;
 
 namespace Core {
 
+/// Writes renderer caches to disk, the emulator never unwinds on exit or restart.
+static void SaveRendererCaches() {
+    if (presenter) {
+        presenter->GetRasterizer().GetPipelineCache().SaveDiskCache();
+    }
+}
+
 Emulator::Emulator() {
     // Initialize NT API functions and set high priority
 #ifdef _WIN32
@@ -102,6 +116,16 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
 
     std::filesystem::path eboot_name = std::filesystem::relative(file, game_folder);
 
+    // Time spent in each step of the startup, logged once the game is about to start.
+    using StartupClock = std::chrono::steady_clock;
+    std::vector<std::pair<const char*, StartupClock::duration>> startup_steps;
+    auto step_start = StartupClock::now();
+    const auto end_step = [&](const char* name) {
+        const auto now = StartupClock::now();
+        startup_steps.emplace_back(name, now - step_start);
+        step_start = now;
+    };
+
     // Applications expect to be run from /app0 so mount the file's parent path as app0.
     auto* mnt = Common::Singleton<Core::FileSys::MntPoints>::Instance();
     mnt->Mount(game_folder, "/app0", true);
@@ -146,6 +170,7 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
         Common::Log::Initialize();
     }
     Common::Log::Start();
+    end_step("Config and logging");
     if (!std::filesystem::exists(file)) {
         LOG_CRITICAL(Loader, "eboot.bin does not exist: {}",
                      std::filesystem::absolute(file).string());
@@ -184,16 +209,19 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     LOG_INFO(Config, "Vulkan guestMarkers: {}", Config::getVkGuestMarkersEnabled());
     LOG_INFO(Config, "Vulkan rdocEnable: {}", Config::isRdocEnabled());
 
-    hwinfo::Memory ram;
-    hwinfo::OS os;
-    const auto cpus = hwinfo::getAllCPUs();
-    for (const auto& cpu : cpus) {
-        LOG_INFO(Config, "CPU Model: {}", cpu.modelName());
-        LOG_INFO(Config, "CPU Physical Cores: {}, Logical Cores: {}", cpu.numPhysicalCores(),
-                 cpu.numLogicalCores());
-    }
-    LOG_INFO(Config, "Total RAM: {} GB", std::round(ram.total_Bytes() / pow(1024, 3)));
-    LOG_INFO(Config, "Operating System: {}", os.name());
+    // Querying the hardware can take a while (WMI on Windows), nothing waits on it.
+    Common::JobSystem::Get().Schedule(Common::JobPriority::Background, [] {
+        hwinfo::Memory ram;
+        hwinfo::OS os;
+        const auto cpus = hwinfo::getAllCPUs();
+        for (const auto& cpu : cpus) {
+            LOG_INFO(Config, "CPU Model: {}", cpu.modelName());
+            LOG_INFO(Config, "CPU Physical Cores: {}, Logical Cores: {}", cpu.numPhysicalCores(),
+                     cpu.numLogicalCores());
+        }
+        LOG_INFO(Config, "Total RAM: {} GB", std::round(ram.total_Bytes() / pow(1024, 3)));
+        LOG_INFO(Config, "Operating System: {}", os.name());
+    });
 
     if (param_sfo_exists) {
         LOG_INFO(Loader, "Game id: {} Title: {}", id, title);
@@ -227,14 +255,8 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
         MemoryPatcher::g_game_serial = id;
         Libraries::Np::NpTrophy::game_serial = id;
 
-        const auto trophyDir =
-            Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) / id / "TrophyFiles";
-        if (!std::filesystem::exists(trophyDir)) {
-            TRP trp;
-            if (!trp.Extract(game_folder, id)) {
-                LOG_ERROR(Loader, "Couldn't extract trophies");
-            }
-        }
+        // Trophies are extracted while the game boots, the trophy library waits for them.
+        TRP::ExtractAsync(game_folder, id);
     }
 
     auto& game_info = Common::ElfInfo::Instance();
@@ -277,6 +299,7 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
         Config::getWindowWidth(), Config::getWindowHeight(), controller, window_title);
 
     g_window = window.get();
+    end_step("Window");
 
     const auto& mount_data_dir = Common::FS::GetUserPath(Common::FS::PathType::GameDataDir) / id;
     if (!std::filesystem::exists(mount_data_dir)) {
@@ -306,9 +329,11 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
         std::filesystem::create_directory(mount_captures_dir);
     }
     VideoCore::SetOutputDir(mount_captures_dir, id);
+    end_step("Mounts");
 
     // Initialize kernel and library facilities.
     Libraries::InitHLELibs(&linker->GetHLESymbols());
+    end_step("HLE libraries");
 
     // Load the module with the linker
     auto guest_eboot_path = "/app0/" + eboot_name.generic_string();
@@ -329,6 +354,7 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
             linker->LoadModule(path);
         }
     });
+    end_step("Modules");
 
 #ifdef ENABLE_DISCORD_RPC
     // Discord RPC
@@ -356,8 +382,21 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     }
 #endif
 
+    Input::Recording::Start(controller);
+    Benchmark::Start();
+
     args.insert(args.begin(), eboot_name.generic_string());
     linker->Execute(args);
+    end_step("Relocation");
+
+    StartupClock::duration startup_total{};
+    for (const auto& [name, duration] : startup_steps) {
+        LOG_INFO(Loader, "Startup: {} took {} ms", name,
+                 std::chrono::duration_cast<std::chrono::milliseconds>(duration).count());
+        startup_total += duration;
+    }
+    LOG_INFO(Loader, "Startup took {} ms",
+             std::chrono::duration_cast<std::chrono::milliseconds>(startup_total).count());
 
     window->InitTimers();
     while (window->IsOpen()) {
@@ -368,6 +407,7 @@ void Emulator::Run(std::filesystem::path file, std::vector<std::string> args,
     UpdatePlayTime(id);
 #endif
 
+    SaveRendererCaches();
     std::quick_exit(0);
 }
 
@@ -409,6 +449,8 @@ void Emulator::Restart(std::filesystem::path eboot_path,
     }
 
     LOG_INFO(Common, "Restarting the emulator with args: {}", fmt::join(args, " "));
+    // Persist the pipelines compiled this session so the new instance starts warm.
+    SaveRendererCaches();
     Libraries::SaveData::Backup::StopThread();
     Common::Log::Denitializer();
 
@@ -214,7 +214,7 @@ void Render(const vk::CommandBuffer& cmdbuf, const vk::ImageView& image_view,
         return;
     }
 
-    if (Config::getVkHostMarkersEnabled()) {
+    if (Config::GetSnapshot().vk_host_markers) {
         cmdbuf.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT{
             .pLabelName = "ImGui Render",
         });
@@ -239,7 +239,7 @@ void Render(const vk::CommandBuffer& cmdbuf, const vk::ImageView& image_view,
     cmdbuf.beginRendering(render_info);
     Vulkan::RenderDrawData(*draw_data, cmdbuf);
     cmdbuf.endRendering();
-    if (Config::getVkHostMarkersEnabled()) {
+    if (Config::GetSnapshot().vk_host_markers) {
         cmdbuf.endDebugUtilsLabelEXT();
     }
 }
@@ -22,6 +22,9 @@ struct RenderBuffer {
     vk::DeviceMemory buffer_memory{};
     vk::DeviceSize buffer_size{};
     vk::Buffer buffer{};
+    // Mapped for the whole lifetime of the buffer
+    void* mapped{};
+    bool coherent{};
 };
 
 // Reusable buffers used for rendering 1 current in-flight frame, for RenderDrawData()
@@ -483,11 +486,13 @@ static void CreateOrResizeBuffer(RenderBuffer& rb, size_t new_size, vk::BufferUs
         v.device.destroyBuffer(rb.buffer, v.allocator);
     }
     if (rb.buffer_memory != VK_NULL_HANDLE) {
+        v.device.unmapMemory(rb.buffer_memory);
         v.device.freeMemory(rb.buffer_memory, v.allocator);
     }
 
-    const vk::DeviceSize buffer_size_aligned =
-        AlignBufferSize(IM_MAX(v.min_allocation_size, new_size), bd->buffer_memory_alignment);
+    // Grow with some headroom so windows that slowly gain vertices don't reallocate every frame
+    const vk::DeviceSize buffer_size_aligned = AlignBufferSize(
+        IM_MAX(v.min_allocation_size, new_size + new_size / 2), bd->buffer_memory_alignment);
     vk::BufferCreateInfo buffer_info{
         .size = buffer_size_aligned,
         .usage = usage,
@@ -497,15 +502,24 @@ static void CreateOrResizeBuffer(RenderBuffer& rb, size_t new_size, vk::BufferUs
 
     const vk::MemoryRequirements req = v.device.getBufferMemoryRequirements(rb.buffer);
     bd->buffer_memory_alignment = IM_MAX(bd->buffer_memory_alignment, req.alignment);
+    // Coherent memory saves flushing the whole buffer every frame
+    uint32_t memory_type = FindMemoryType(
+        vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent,
+        req.memoryTypeBits);
+    rb.coherent = memory_type != 0xFFFFFFFF;
+    if (!rb.coherent) {
+        memory_type = FindMemoryType(vk::MemoryPropertyFlagBits::eHostVisible, req.memoryTypeBits);
+    }
     vk::MemoryAllocateInfo alloc_info{
         .allocationSize = req.size,
-        .memoryTypeIndex =
-            FindMemoryType(vk::MemoryPropertyFlagBits::eHostVisible, req.memoryTypeBits),
+        .memoryTypeIndex = memory_type,
     };
     rb.buffer_memory = CheckVkResult(v.device.allocateMemory(alloc_info, v.allocator));
 
     CheckVkErr(v.device.bindBufferMemory(rb.buffer, rb.buffer_memory, 0));
     rb.buffer_size = buffer_size_aligned;
+    rb.mapped = CheckVkResult(
+        v.device.mapMemory(rb.buffer_memory, 0, VK_WHOLE_SIZE, vk::MemoryMapFlags{}));
 }
 
 static void SetupRenderState(ImDrawData& draw_data, vk::Pipeline pipeline, vk::CommandBuffer cmdbuf,
@@ -593,10 +607,8 @@ void RenderDrawData(ImDrawData& draw_data, vk::CommandBuffer command_buffer,
         // Upload vertex/index data into a single contiguous GPU buffer
         ImDrawVert* vtx_dst = nullptr;
         ImDrawIdx* idx_dst = nullptr;
-        vtx_dst = (ImDrawVert*)CheckVkResult(
-            v.device.mapMemory(frb.vertex.buffer_memory, 0, vertex_size, vk::MemoryMapFlags{}));
-        idx_dst = (ImDrawIdx*)CheckVkResult(
-            v.device.mapMemory(frb.index.buffer_memory, 0, index_size, vk::MemoryMapFlags{}));
+        vtx_dst = static_cast<ImDrawVert*>(frb.vertex.mapped);
+        idx_dst = static_cast<ImDrawIdx*>(frb.index.mapped);
         for (int n = 0; n < draw_data.CmdListsCount; n++) {
             const ImDrawList* cmd_list = draw_data.CmdLists[n];
             memcpy(vtx_dst, cmd_list->VtxBuffer.Data,
@@ -605,19 +617,19 @@ void RenderDrawData(ImDrawData& draw_data, vk::CommandBuffer command_buffer,
             vtx_dst += cmd_list->VtxBuffer.Size;
             idx_dst += cmd_list->IdxBuffer.Size;
         }
-        vk::MappedMemoryRange range[2]{
-            {
-                .memory = frb.vertex.buffer_memory,
-                .size = VK_WHOLE_SIZE,
-            },
-            {
-                .memory = frb.index.buffer_memory,
-                .size = VK_WHOLE_SIZE,
-            },
-        };
-        CheckVkErr(v.device.flushMappedMemoryRanges({range}));
-        v.device.unmapMemory(frb.vertex.buffer_memory);
-        v.device.unmapMemory(frb.index.buffer_memory);
+        if (!frb.vertex.coherent || !frb.index.coherent) {
+            vk::MappedMemoryRange range[2]{
+                {
+                    .memory = frb.vertex.buffer_memory,
+                    .size = VK_WHOLE_SIZE,
+                },
+                {
+                    .memory = frb.index.buffer_memory,
+                    .size = VK_WHOLE_SIZE,
+                },
+            };
+            CheckVkErr(v.device.flushMappedMemoryRanges({range}));
+        }
     }
 
     // Setup desired Vulkan state
@@ -924,10 +936,12 @@ static void DestroyFrameRenderBuffers(vk::Device device, RenderBuffer& rb,
         rb.buffer = VK_NULL_HANDLE;
     }
     if (rb.buffer_memory) {
+        device.unmapMemory(rb.buffer_memory);
         device.freeMemory(rb.buffer_memory, allocator);
         rb.buffer_memory = VK_NULL_HANDLE;
     }
     rb.buffer_size = 0;
+    rb.mapped = nullptr;
 }
 
 static void DestroyWindowRenderBuffers(vk::Device device, WindowRenderBuffers& buffers,
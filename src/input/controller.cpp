@@ -1,12 +1,14 @@
 ﻿// SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <cstring>
 #include <SDL3/SDL.h>
 #include "common/config.h"
 #include "common/logging/log.h"
 #include "core/libraries/kernel/time.h"
 #include "core/libraries/pad/pad.h"
 #include "input/controller.h"
+#include "input/input_recording.h"
 
 static std::string SelectedGamepad = "";
 
@@ -62,68 +64,84 @@ void State::OnAccel(const float accel[3]) {
 }
 
 GameController::GameController() {
-    m_states_num = 0;
     m_last_state = State();
 }
 
-void GameController::ReadState(State* state, bool* isConnected, int* connectedCount) {
-    std::scoped_lock lock{m_mutex};
+bool GameController::ReadSlot(u64 number, State* state) const {
+    const auto& slot = m_slots[number % MAX_STATES];
+    const u64 seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != number * 2 + 2) {
+        return false;
+    }
+    std::memcpy(static_cast<void*>(state), &slot.state, sizeof(State));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == seq;
+}
 
+void GameController::ReadState(State* state, bool* isConnected, int* connectedCount) {
     *isConnected = m_connected;
     *connectedCount = m_connected_count;
-    *state = GetLastState();
+
+    // Retries only when the writers went around the whole ring during the copy.
+    while (true) {
+        const u64 count = m_write_count.load(std::memory_order_acquire);
+        if (count == 0) {
+            *state = State();
+            return;
+        }
+        if (ReadSlot(count - 1, state)) {
+            return;
+        }
+    }
 }
 
 int GameController::ReadStates(State* states, int states_num, bool* isConnected,
                                int* connectedCount) {
-    std::scoped_lock lock{m_mutex};
-
     *isConnected = m_connected;
     *connectedCount = m_connected_count;
 
-    int ret_num = 0;
+    if (!m_connected) {
+        return 0;
+    }
+
+    while (true) {
+        u64 read = m_read_count.load(std::memory_order_acquire);
+        const u64 written = m_write_count.load(std::memory_order_acquire);
+        if (written == 0) {
+            states[0] = State();
+            return 1;
+        }
 
-    if (m_connected) {
-        if (m_states_num == 0) {
-            ret_num = 1;
-            states[0] = m_last_state;
-        } else {
-            for (uint32_t i = 0; i < m_states_num; i++) {
-                if (ret_num >= states_num) {
-                    break;
-                }
-                auto index = (m_first_state + i) % MAX_STATES;
-                if (!m_private[index].obtained) {
-                    m_private[index].obtained = true;
-
-                    states[ret_num++] = m_states[index];
-                }
-            }
+        // The oldest slot may already be overwritten by a writer, only newer states are kept.
+        const u64 first = std::max(read, written > MAX_STATES ? written - MAX_STATES + 1 : 0);
+        const u64 count = std::min<u64>(written - first, std::max(states_num, 0));
+        bool complete = true;
+        for (u64 i = 0; i < count && complete; i++) {
+            complete = ReadSlot(first + i, &states[i]);
+        }
+        if (!complete) {
+            continue;
+        }
+        // Another reader may have consumed the same states meanwhile.
+        if (m_read_count.compare_exchange_weak(read, first + count, std::memory_order_acq_rel)) {
+            return static_cast<int>(count);
         }
     }
-
-    return ret_num;
 }
 
 State GameController::GetLastState() const {
-    if (m_states_num == 0) {
-        return m_last_state;
-    }
-    const u32 last = (m_first_state + m_states_num - 1) % MAX_STATES;
-    return m_states[last];
+    return m_last_state;
 }
 
 void GameController::AddState(const State& state) {
-    if (m_states_num >= MAX_STATES) {
-        m_states_num = MAX_STATES - 1;
-        m_first_state = (m_first_state + 1) % MAX_STATES;
-    }
-
-    const u32 index = (m_first_state + m_states_num) % MAX_STATES;
-    m_states[index] = state;
+    const u64 number = m_write_count.load(std::memory_order_relaxed);
+    auto& slot = m_slots[number % MAX_STATES];
+    slot.seq.store(number * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.state = state;
+    slot.seq.store(number * 2 + 2, std::memory_order_release);
     m_last_state = state;
-    m_private[index].obtained = false;
-    m_states_num++;
+    m_write_count.store(number + 1, std::memory_order_release);
 }
 
 void GameController::CheckButton(int id, OrbisPadButtonDataOffset button, bool is_pressed) {
@@ -132,6 +150,9 @@ void GameController::CheckButton(int id, OrbisPadButtonDataOffset button, bool i
 
     state.time = Libraries::Kernel::sceKernelGetProcessTime();
     state.OnButton(button, is_pressed);
+    if (Recording::IsRecording()) {
+        Recording::RecordButton(button, is_pressed);
+    }
 
     AddState(state);
 }
@@ -142,11 +163,14 @@ void GameController::Axis(int id, Input::Axis axis, int value) {
 
     state.time = Libraries::Kernel::sceKernelGetProcessTime();
     state.OnAxis(axis, value);
+    if (Recording::IsRecording()) {
+        Recording::RecordAxis(axis, value);
+    }
 
     AddState(state);
 }
 
-void GameController::Gyro(int id, const float gyro[3]) {
+void GameController::Gyro(int id, const float gyro[3], u64 timestamp) {
     std::scoped_lock lock{m_mutex};
     auto state = GetLastState();
     state.time = Libraries::Kernel::sceKernelGetProcessTime();
@@ -154,8 +178,21 @@ void GameController::Gyro(int id, const float gyro[3]) {
     // Update the angular velocity (gyro data)
     state.OnGyro(gyro);
 
+    // Every sample is integrated over the interval to the previous one, taken from the sensor
+    // timestamps. Gaps longer than MAX_SENSOR_INTERVAL, like after a reconnect, are skipped.
+    if (m_last_gyro_timestamp != 0 && timestamp > m_last_gyro_timestamp) {
+        const float delta_time = static_cast<float>(timestamp - m_last_gyro_timestamp) / 1e9f;
+        if (delta_time <= MAX_SENSOR_INTERVAL) {
+            FuseOrientation(state.acceleration, state.angularVelocity, delta_time,
+                            m_orientation);
+        }
+    }
+    m_last_gyro_timestamp = timestamp;
+    state.orientation = m_orientation;
+
     AddState(state);
 }
+
 void GameController::Acceleration(int id, const float acceleration[3]) {
     std::scoped_lock lock{m_mutex};
     auto state = GetLastState();
@@ -167,38 +204,52 @@ void GameController::Acceleration(int id, const float acceleration[3]) {
     AddState(state);
 }
 
-void GameController::CalculateOrientation(Libraries::Pad::OrbisFVector3& acceleration,
-                                          Libraries::Pad::OrbisFVector3& angularVelocity,
-                                          float deltaTime,
-                                          Libraries::Pad::OrbisFQuaternion& lastOrientation,
-                                          Libraries::Pad::OrbisFQuaternion& orientation) {
-    Libraries::Pad::OrbisFQuaternion q = lastOrientation;
+void GameController::FuseOrientation(const Libraries::Pad::OrbisFVector3& acceleration,
+                                     const Libraries::Pad::OrbisFVector3& angularVelocity,
+                                     float deltaTime,
+                                     Libraries::Pad::OrbisFQuaternion& orientation) {
+    // Gain of the accelerometer correction, pulls the estimated gravity towards the measured one
+    // with a time constant of about two seconds.
+    constexpr float CorrectionGain = 0.5f;
+    constexpr float Gravity = 9.81f;
+
+    Libraries::Pad::OrbisFQuaternion q = orientation;
     Libraries::Pad::OrbisFQuaternion ω = {angularVelocity.x, angularVelocity.y, angularVelocity.z,
                                           0.0f};
 
+    // Mahony filter, the gyro is corrected by the error between the measured gravity and the
+    // world up direction in the sensor frame. The correction is skipped while the pad is shaken.
+    const float accel_norm =
+        std::sqrt(acceleration.x * acceleration.x + acceleration.y * acceleration.y +
+                  acceleration.z * acceleration.z);
+    if (accel_norm > 0.5f * Gravity && accel_norm < 1.5f * Gravity) {
+        const float ax = acceleration.x / accel_norm;
+        const float ay = acceleration.y / accel_norm;
+        const float az = acceleration.z / accel_norm;
+        const float vx = 2.0f * (q.x * q.y + q.w * q.z);
+        const float vy = 1.0f - 2.0f * (q.x * q.x + q.z * q.z);
+        const float vz = 2.0f * (q.y * q.z - q.w * q.x);
+        ω.x += CorrectionGain * (ay * vz - az * vy);
+        ω.y += CorrectionGain * (az * vx - ax * vz);
+        ω.z += CorrectionGain * (ax * vy - ay * vx);
+    }
+
     Libraries::Pad::OrbisFQuaternion qω = {q.w * ω.x + q.x * ω.w + q.y * ω.z - q.z * ω.y,
                                            q.w * ω.y + q.y * ω.w + q.z * ω.x - q.x * ω.z,
                                            q.w * ω.z + q.z * ω.w + q.x * ω.y - q.y * ω.x,
                                            q.w * ω.w - q.x * ω.x - q.y * ω.y - q.z * ω.z};
 
-    Libraries::Pad::OrbisFQuaternion qDot = {0.5f * qω.x, 0.5f * qω.y, 0.5f * qω.z, 0.5f * qω.w};
-
-    q.x += qDot.x * deltaTime;
-    q.y += qDot.y * deltaTime;
-    q.z += qDot.z * deltaTime;
-    q.w += qDot.w * deltaTime;
+    q.x += 0.5f * qω.x * deltaTime;
+    q.y += 0.5f * qω.y * deltaTime;
+    q.z += 0.5f * qω.z * deltaTime;
+    q.w += 0.5f * qω.w * deltaTime;
 
     float norm = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
-    q.x /= norm;
-    q.y /= norm;
-    q.z /= norm;
-    q.w /= norm;
-
-    orientation.x = q.x;
-    orientation.y = q.y;
-    orientation.z = q.z;
-    orientation.w = q.w;
-    LOG_DEBUG(Lib_Pad, "Calculated orientation: {:.2f} {:.2f} {:.2f} {:.2f}", orientation.x,
+    orientation.x = q.x / norm;
+    orientation.y = q.y / norm;
+    orientation.z = q.z / norm;
+    orientation.w = q.w / norm;
+    LOG_TRACE(Lib_Pad, "Fused orientation: {:.2f} {:.2f} {:.2f} {:.2f}", orientation.x,
               orientation.y, orientation.z, orientation.w);
 }
 
@@ -273,24 +324,13 @@ void GameController::UnsetSecondaryTouchResetBool() {
     m_was_secondary_reset = false;
 }
 
-void GameController::SetLastOrientation(Libraries::Pad::OrbisFQuaternion& orientation) {
-    std::scoped_lock lock{m_mutex};
-    m_orientation = orientation;
-}
-
-Libraries::Pad::OrbisFQuaternion GameController::GetLastOrientation() {
+void GameController::ResetOrientation() {
     std::scoped_lock lock{m_mutex};
-    return m_orientation;
-}
-
-std::chrono::steady_clock::time_point GameController::GetLastUpdate() {
-    std::scoped_lock lock{m_mutex};
-    return m_last_update;
-}
-
-void GameController::SetLastUpdate(std::chrono::steady_clock::time_point lastUpdate) {
-    std::scoped_lock lock{m_mutex};
-    m_last_update = lastUpdate;
+    m_orientation = {0.0f, 0.0f, 0.0f, 1.0f};
+    auto state = GetLastState();
+    state.time = Libraries::Kernel::sceKernelGetProcessTime();
+    state.orientation = m_orientation;
+    AddState(state);
 }
 
 void GameController::SetEngine(std::unique_ptr<Engine> engine) {
@@ -309,17 +349,12 @@ u32 GameController::Poll() {
     if (m_connected) {
         std::scoped_lock lock{m_mutex};
         auto time = Libraries::Kernel::sceKernelGetProcessTime();
-        if (m_states_num == 0) {
-            auto diff = (time - m_last_state.time) / 1000;
-            if (diff >= 100) {
-                AddState(GetLastState());
-            }
-        } else {
-            auto index = (m_first_state - 1 + m_states_num) % MAX_STATES;
-            auto diff = (time - m_states[index].time) / 1000;
-            if (m_private[index].obtained && diff >= 100) {
-                AddState(GetLastState());
-            }
+        // Repeats the last state once it was read, so reads see a fresh timestamp.
+        const bool consumed = m_read_count.load(std::memory_order_acquire) ==
+                              m_write_count.load(std::memory_order_relaxed);
+        auto diff = (time - m_last_state.time) / 1000;
+        if (consumed && diff >= 100) {
+            AddState(GetLastState());
         }
     }
     return 100;
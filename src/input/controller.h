@@ -4,6 +4,7 @@
 #pragma once
 
 #include <algorithm>
+#include <atomic>
 #include <memory>
 #include <mutex>
 #include <SDL3/SDL_gamepad.h>
@@ -65,6 +66,9 @@ inline int GetAxis(int min, int max, int value) {
 
 constexpr u32 MAX_STATES = 32;
 
+/// Longest gap between two gyro samples that is still integrated, in seconds.
+constexpr float MAX_SENSOR_INTERVAL = 0.1f;
+
 class GameController {
 public:
     GameController();
@@ -76,7 +80,9 @@ public:
     void CheckButton(int id, Libraries::Pad::OrbisPadButtonDataOffset button, bool isPressed);
     void AddState(const State& state);
     void Axis(int id, Input::Axis axis, int value);
-    void Gyro(int id, const float gyro[3]);
+    /// Adds a gyro sample taken at the sensor timestamp in nanoseconds and fuses it into the
+    /// orientation.
+    void Gyro(int id, const float gyro[3], u64 timestamp);
     void Acceleration(int id, const float acceleration[3]);
     void SetLightBarRGB(u8 r, u8 g, u8 b);
     void SetVibration(u8 smallMotor, u8 largeMotor);
@@ -94,35 +100,35 @@ public:
     bool WasSecondaryTouchReset();
     void UnsetSecondaryTouchResetBool();
 
-    void SetLastOrientation(Libraries::Pad::OrbisFQuaternion& orientation);
-    Libraries::Pad::OrbisFQuaternion GetLastOrientation();
-    std::chrono::steady_clock::time_point GetLastUpdate();
-    void SetLastUpdate(std::chrono::steady_clock::time_point lastUpdate);
-    static void CalculateOrientation(Libraries::Pad::OrbisFVector3& acceleration,
-                                     Libraries::Pad::OrbisFVector3& angularVelocity,
-                                     float deltaTime,
-                                     Libraries::Pad::OrbisFQuaternion& lastOrientation,
-                                     Libraries::Pad::OrbisFQuaternion& orientation);
+    void ResetOrientation();
+    static void FuseOrientation(const Libraries::Pad::OrbisFVector3& acceleration,
+                                const Libraries::Pad::OrbisFVector3& angularVelocity,
+                                float deltaTime, Libraries::Pad::OrbisFQuaternion& orientation);
 
 private:
-    struct StateInternal {
-        bool obtained = false;
+    /// Ring entry published with a sequence lock, seq is odd while the state is written and
+    /// twice the state number plus two once it is complete.
+    struct StateSlot {
+        std::atomic<u64> seq{};
+        State state;
     };
 
+    bool ReadSlot(u64 number, State* state) const;
+
+    /// Serializes the writers, readers only go through the ring.
     std::mutex m_mutex;
     bool m_connected = true;
     State m_last_state;
     int m_connected_count = 0;
-    u32 m_states_num = 0;
-    u32 m_first_state = 0;
+    std::atomic<u64> m_write_count{};
+    std::atomic<u64> m_read_count{};
     u8 m_touch_count = 0;
     u8 m_secondary_touch_count = 0;
     u8 m_previous_touch_count = 0;
     u8 m_previous_touchnum = 0;
     bool m_was_secondary_reset = false;
-    std::array<State, MAX_STATES> m_states;
-    std::array<StateInternal, MAX_STATES> m_private;
-    std::chrono::steady_clock::time_point m_last_update = {};
+    std::array<StateSlot, MAX_STATES> m_slots;
+    u64 m_last_gyro_timestamp = 0;
     Libraries::Pad::OrbisFQuaternion m_orientation = {0.0f, 0.0f, 0.0f, 1.0f};
 
     std::unique_ptr<Engine> m_engine = nullptr;
@@ -13,6 +13,7 @@
 #include <string_view>
 #include <typeinfo>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "SDL3/SDL_events.h"
@@ -60,6 +61,13 @@ std::pair<int, int> leftjoystick_deadzone, rightjoystick_deadzone, lefttrigger_d
 std::list<std::pair<InputEvent, bool>> pressed_keys;
 std::list<InputID> toggled_keys;
 static std::vector<BindingConnection> connections;
+// Every input that appears in a binding, filled in when the config is parsed.
+// Events of other inputs can't change any output, so they are dropped right away.
+static std::unordered_set<u64> bound_inputs;
+
+static u64 GetInputKey(const InputID& input) {
+    return static_cast<u64>(input.type) << 32 | input.sdl_id;
+}
 
 auto output_array = std::array{
     // Important: these have to be the first, or else they will update in the wrong order
@@ -428,9 +436,19 @@ void ParseInputConfig(const std::string game_id = "") {
     }
     config_stream.close();
     std::sort(connections.begin(), connections.end());
+    bound_inputs.clear();
     for (auto& c : connections) {
         LOG_DEBUG(Input, "Binding: {} : {}", c.output->ToString(), c.binding.ToString());
+        for (const auto& key : c.binding.keys) {
+            if (key.IsValid()) {
+                bound_inputs.insert(GetInputKey(key));
+            }
+        }
     }
+    // Held inputs that lost their bindings would never be released otherwise
+    std::erase_if(pressed_keys, [](const std::pair<InputEvent, bool>& e) {
+        return !bound_inputs.contains(GetInputKey(e.first.input));
+    });
     LOG_DEBUG(Input, "Done parsing the input config!");
 }
 
@@ -642,7 +660,7 @@ void ControllerOutput::FinalizeUpdate() {
 bool UpdatePressedKeys(InputEvent event) {
     // Skip invalid inputs
     InputID input = event.input;
-    if (input.sdl_id == SDL_UNMAPPED) {
+    if (input.sdl_id == SDL_UNMAPPED || !bound_inputs.contains(GetInputKey(input))) {
         return false;
     }
     if (input.type == InputType::Axis) {
@@ -710,16 +728,15 @@ InputEvent BindingConnection::ProcessBinding() {
     }
 
     // Extract keys from InputBinding and ignore unused or toggled keys
-    std::list<InputID> input_keys = {binding.keys[0], binding.keys[1], binding.keys[2]};
-    input_keys.remove(InputID());
-    for (auto key = input_keys.begin(); key != input_keys.end();) {
-        if (std::find(toggled_keys.begin(), toggled_keys.end(), *key) != toggled_keys.end()) {
-            key = input_keys.erase(key); // Use the returned iterator
-        } else {
-            ++key; // Increment only if no erase happened
+    std::array<InputID, 3> input_keys;
+    size_t num_keys = 0;
+    for (const auto& key : binding.keys) {
+        if (key.IsValid() &&
+            std::find(toggled_keys.begin(), toggled_keys.end(), key) == toggled_keys.end()) {
+            input_keys[num_keys++] = key;
         }
     }
-    if (input_keys.empty()) {
+    if (num_keys == 0) {
         LOG_DEBUG(Input, "No actual inputs to check, returning true");
         event.active = true;
         return event;
@@ -729,17 +746,19 @@ InputEvent BindingConnection::ProcessBinding() {
     auto pressed_it = pressed_keys.begin();
 
     // Store pointers to flags in pressed_keys that need to be set if all keys are active
-    std::list<bool*> flags_to_set;
+    std::array<bool*, 3> flags_to_set;
+    size_t num_flags = 0;
 
     // Check if all keys in input_keys are active
-    for (InputID key : input_keys) {
+    for (size_t i = 0; i < num_keys; i++) {
+        const InputID key = input_keys[i];
         bool key_found = false;
 
         while (pressed_it != pressed_keys.end()) {
             if (pressed_it->first.input == key && (pressed_it->second == false)) {
                 key_found = true;
                 if (output->positive_axis) {
-                    flags_to_set.push_back(&pressed_it->second);
+                    flags_to_set[num_flags++] = &pressed_it->second;
                 }
                 if (pressed_it->first.input.type == InputType::Axis) {
                     event.axis_value = pressed_it->first.axis_value;
@@ -754,8 +773,8 @@ InputEvent BindingConnection::ProcessBinding() {
         }
     }
 
-    for (bool* flag : flags_to_set) {
-        *flag = true;
+    for (size_t i = 0; i < num_flags; i++) {
+        *flags_to_set[i] = true;
     }
     if (binding.keys[0].type != InputType::Axis) { // the axes spam inputs, making this unreadable
         LOG_DEBUG(Input, "Input found: {}", binding.ToString());
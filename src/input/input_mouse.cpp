@@ -43,7 +43,31 @@ void SetMouseGyroRollMode(bool mode) {
     mouse_gyro_roll_mode = mode;
 }
 
+// Mouse deltas are smoothed over a few polls and scaled to the rate the sensitivity settings
+// were tuned for, so moving the polling to a higher rate keeps the stick response the same.
+constexpr float SMOOTHING_TIME_MS = 16.0f;
+constexpr float REFERENCE_INTERVAL_MS = 33.0f;
+
+static float smoothed_x = 0.0f, smoothed_y = 0.0f;
+
+static void SmoothMouseDelta(u32 interval, float* d_x, float* d_y) {
+    float raw_x = 0, raw_y = 0;
+    SDL_GetRelativeMouseState(&raw_x, &raw_y);
+    const float scale = REFERENCE_INTERVAL_MS / static_cast<float>(interval);
+    const float alpha = static_cast<float>(interval) / (SMOOTHING_TIME_MS + interval);
+    smoothed_x += (raw_x * scale - smoothed_x) * alpha;
+    smoothed_y += (raw_y * scale - smoothed_y) * alpha;
+    // Snap to rest so the stick returns to the center instead of decaying forever.
+    if (raw_x == 0 && raw_y == 0 && std::abs(smoothed_x) < 0.01f &&
+        std::abs(smoothed_y) < 0.01f) {
+        smoothed_x = smoothed_y = 0.0f;
+    }
+    *d_x = smoothed_x;
+    *d_y = smoothed_y;
+}
+
 void EmulateJoystick(GameController* controller, u32 interval) {
+    static int last_binding = 0, last_x = -1, last_y = -1;
 
     Axis axis_x, axis_y;
     switch (mouse_joystick_binding) {
@@ -59,8 +83,13 @@ void EmulateJoystick(GameController* controller, u32 interval) {
         return; // no update needed
     }
 
+    if (mouse_joystick_binding != last_binding) {
+        last_binding = mouse_joystick_binding;
+        last_x = last_y = -1;
+    }
+
     float d_x = 0, d_y = 0;
-    SDL_GetRelativeMouseState(&d_x, &d_y);
+    SmoothMouseDelta(interval, &d_x, &d_y);
 
     float output_speed =
         SDL_clamp((sqrt(d_x * d_x + d_y * d_y) + mouse_speed_offset * 128) * mouse_speed,
@@ -69,12 +98,19 @@ void EmulateJoystick(GameController* controller, u32 interval) {
     float angle = atan2(d_y, d_x);
     float a_x = cos(angle) * output_speed, a_y = sin(angle) * output_speed;
 
+    int x = GetAxis(-0x80, 0x7f, 0), y = GetAxis(-0x80, 0x7f, 0);
     if (d_x != 0 || d_y != 0) {
-        controller->Axis(0, axis_x, GetAxis(-0x80, 0x7f, a_x));
-        controller->Axis(0, axis_y, GetAxis(-0x80, 0x7f, a_y));
-    } else {
-        controller->Axis(0, axis_x, GetAxis(-0x80, 0x7f, 0));
-        controller->Axis(0, axis_y, GetAxis(-0x80, 0x7f, 0));
+        x = GetAxis(-0x80, 0x7f, a_x);
+        y = GetAxis(-0x80, 0x7f, a_y);
+    }
+    // Only changes are published, an unchanged stick would just push duplicate pad states.
+    if (x != last_x) {
+        controller->Axis(0, axis_x, x);
+        last_x = x;
+    }
+    if (y != last_y) {
+        controller->Axis(0, axis_y, y);
+        last_y = y;
     }
 }
 
@@ -82,14 +118,14 @@ constexpr float constant_down_accel[3] = {0.0f, 10.0f, 0.0f};
 void EmulateGyro(GameController* controller, u32 interval) {
     // LOG_INFO(Input, "todo gyro");
     float d_x = 0, d_y = 0;
-    SDL_GetRelativeMouseState(&d_x, &d_y);
+    SmoothMouseDelta(interval, &d_x, &d_y);
     controller->Acceleration(1, constant_down_accel);
     float gyro_from_mouse[3] = {-d_y / 100, -d_x / 100, 0.0f};
     if (mouse_gyro_roll_mode) {
         gyro_from_mouse[1] = 0.0f;
         gyro_from_mouse[2] = -d_x / 100;
     }
-    controller->Gyro(1, gyro_from_mouse);
+    controller->Gyro(1, gyro_from_mouse, SDL_GetTicksNS());
 }
 
 Uint32 MousePolling(void* param, Uint32 id, Uint32 interval) {
@@ -22,6 +22,9 @@ void SetMouseGyroRollMode(bool mode);
 void EmulateJoystick(GameController* controller, u32 interval);
 void EmulateGyro(GameController* controller, u32 interval);
 
+/// Interval of the mouse polling timer, in milliseconds.
+constexpr u32 MOUSE_POLLING_INTERVAL = 4;
+
 // Polls the mouse for changes
 Uint32 MousePolling(void* param, Uint32 id, Uint32 interval);
 
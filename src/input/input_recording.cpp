@@ -0,0 +1,195 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <fmt/core.h>
+
+#include "common/logging/log.h"
+#include "common/path_util.h"
+#include "input/controller.h"
+#include "input/input_recording.h"
+
+namespace Input::Recording {
+
+using Libraries::Pad::OrbisPadButtonDataOffset;
+
+namespace {
+
+struct Event {
+    u64 frame;
+    bool is_axis;
+    u32 target;
+    int value;
+};
+
+const std::unordered_map<std::string, OrbisPadButtonDataOffset> ButtonNames = {
+    {"cross", OrbisPadButtonDataOffset::Cross},
+    {"circle", OrbisPadButtonDataOffset::Circle},
+    {"square", OrbisPadButtonDataOffset::Square},
+    {"triangle", OrbisPadButtonDataOffset::Triangle},
+    {"l1", OrbisPadButtonDataOffset::L1},
+    {"r1", OrbisPadButtonDataOffset::R1},
+    {"l2", OrbisPadButtonDataOffset::L2},
+    {"r2", OrbisPadButtonDataOffset::R2},
+    {"l3", OrbisPadButtonDataOffset::L3},
+    {"r3", OrbisPadButtonDataOffset::R3},
+    {"options", OrbisPadButtonDataOffset::Options},
+    {"up", OrbisPadButtonDataOffset::Up},
+    {"down", OrbisPadButtonDataOffset::Down},
+    {"left", OrbisPadButtonDataOffset::Left},
+    {"right", OrbisPadButtonDataOffset::Right},
+    {"touchpad", OrbisPadButtonDataOffset::TouchPad},
+};
+
+const std::unordered_map<std::string, Axis> AxisNames = {
+    {"lx", Axis::LeftX},       {"ly", Axis::LeftY},
+    {"rx", Axis::RightX},      {"ry", Axis::RightY},
+    {"lt", Axis::TriggerLeft}, {"rt", Axis::TriggerRight},
+};
+
+struct RecordingState {
+    std::filesystem::path record_path;
+    std::filesystem::path replay_path;
+    GameController* controller{};
+    std::vector<Event> events;
+    size_t next_event{};
+
+    std::mutex record_mutex;
+    std::ofstream record_file;
+    bool has_pending_writes{};
+    std::atomic<bool> is_recording{};
+    std::atomic<u64> frame{};
+} g_state;
+
+std::vector<Event> LoadReplay(const std::filesystem::path& path) {
+    std::vector<Event> events;
+    std::ifstream file{path};
+    if (!file) {
+        LOG_ERROR(Input, "Unable to open input replay {}", Common::FS::PathToUTF8String(path));
+        return events;
+    }
+    std::string line;
+    for (u32 line_num = 1; std::getline(file, line); line_num++) {
+        if (line.empty() || line.starts_with('#')) {
+            continue;
+        }
+        std::istringstream stream{line};
+        Event event{};
+        std::string name;
+        if (!(stream >> event.frame >> name >> event.value)) {
+            LOG_WARNING(Input, "Ignoring malformed replay input on line {}", line_num);
+            continue;
+        }
+        if (const auto it = ButtonNames.find(name); it != ButtonNames.end()) {
+            event.target = static_cast<u32>(it->second);
+        } else if (const auto axis = AxisNames.find(name); axis != AxisNames.end()) {
+            event.is_axis = true;
+            event.target = static_cast<u32>(axis->second);
+            event.value = std::clamp(event.value, 0, 255);
+        } else {
+            LOG_WARNING(Input, "Ignoring unknown replay input {} on line {}", name, line_num);
+            continue;
+        }
+        events.push_back(event);
+    }
+    std::ranges::stable_sort(events, {}, &Event::frame);
+    return events;
+}
+
+void PlayEvents(u64 frame) {
+    auto& events = g_state.events;
+    for (; g_state.next_event < events.size(); g_state.next_event++) {
+        const auto& event = events[g_state.next_event];
+        if (event.frame > frame) {
+            break;
+        }
+        if (event.is_axis) {
+            g_state.controller->Axis(0, static_cast<Axis>(event.target), event.value);
+        } else {
+            g_state.controller->CheckButton(0, static_cast<OrbisPadButtonDataOffset>(event.target),
+                                            event.value != 0);
+        }
+    }
+}
+
+template <typename Map, typename Value>
+std::string_view FindName(const Map& names, Value value) {
+    const auto it = std::ranges::find(names, value, &Map::value_type::second);
+    return it != names.end() ? std::string_view{it->first} : std::string_view{};
+}
+
+void Write(std::string_view name, int value) {
+    if (name.empty()) {
+        return;
+    }
+    std::scoped_lock lock{g_state.record_mutex};
+    g_state.record_file << fmt::format("{} {} {}\n", g_state.frame.load(), name, value);
+    g_state.has_pending_writes = true;
+}
+
+} // Anonymous namespace
+
+void SetRecordPath(const std::filesystem::path& path) {
+    g_state.record_path = path;
+}
+
+void SetReplayPath(const std::filesystem::path& path) {
+    g_state.replay_path = path;
+}
+
+void Start(GameController* controller) {
+    g_state.controller = controller;
+    if (!g_state.replay_path.empty()) {
+        g_state.events = LoadReplay(g_state.replay_path);
+        LOG_INFO(Input, "Replaying {} inputs from {}", g_state.events.size(),
+                 Common::FS::PathToUTF8String(g_state.replay_path));
+        PlayEvents(0);
+    }
+    if (!g_state.record_path.empty()) {
+        g_state.record_file.open(g_state.record_path, std::ios::trunc);
+        if (!g_state.record_file) {
+            LOG_ERROR(Input, "Unable to create input recording {}",
+                      Common::FS::PathToUTF8String(g_state.record_path));
+            return;
+        }
+        g_state.is_recording = true;
+        LOG_INFO(Input, "Recording input to {}",
+                 Common::FS::PathToUTF8String(g_state.record_path));
+    }
+}
+
+bool IsRecording() {
+    return g_state.is_recording.load(std::memory_order_relaxed);
+}
+
+void RecordButton(OrbisPadButtonDataOffset button, bool is_pressed) {
+    Write(FindName(ButtonNames, button), is_pressed ? 1 : 0);
+}
+
+void RecordAxis(Axis axis, int value) {
+    Write(FindName(AxisNames, axis), value);
+}
+
+void OnFlip(u64 frame) {
+    g_state.frame.store(frame, std::memory_order_relaxed);
+    if (g_state.controller) {
+        PlayEvents(frame);
+    }
+    if (IsRecording()) {
+        // The process ends with quick_exit, so the recording is flushed every frame.
+        std::scoped_lock lock{g_state.record_mutex};
+        if (g_state.has_pending_writes) {
+            g_state.record_file.flush();
+            g_state.has_pending_writes = false;
+        }
+    }
+}
+
+} // namespace Input::Recording
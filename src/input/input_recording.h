@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+
+#include "common/types.h"
+#include "core/libraries/pad/pad.h"
+
+namespace Input {
+
+class GameController;
+enum class Axis;
+
+/**
+ * Records the pad input of a session against the number of presented frames and plays such
+ * recordings back, so that runs of different builds see the same input. Recordings are text,
+ * one "<frame> <button|axis> <value>" entry per line, buttons take 0 or 1 and axes 0-255. An
+ * entry is applied once that many frames have been presented.
+ */
+namespace Recording {
+
+void SetRecordPath(const std::filesystem::path& path);
+void SetReplayPath(const std::filesystem::path& path);
+
+/// Opens the recording and loads the replay onto the controller, called before the game starts.
+void Start(GameController* controller);
+
+[[nodiscard]] bool IsRecording();
+
+void RecordButton(Libraries::Pad::OrbisPadButtonDataOffset button, bool is_pressed);
+void RecordAxis(Axis axis, int value);
+
+/// Advances to the next presented frame, plays back its input and flushes the recording.
+void OnFlip(u64 frame);
+
+} // namespace Recording
+
+} // namespace Input
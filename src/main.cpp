@@ -12,10 +12,12 @@
 #include "common/logging/backend.h"
 #include "common/memory_patcher.h"
 #include "common/path_util.h"
+#include "core/benchmark.h"
 #include "core/debugger.h"
 #include "core/file_sys/fs.h"
 #include "core/ipc/ipc.h"
 #include "emulator.h"
+#include "input/input_recording.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -39,6 +41,9 @@ int main(int argc, char* argv[]) {
     bool waitForDebugger = false;
     std::optional<int> waitPid;
 
+    bool benchmark = false;
+    Core::Benchmark::Options benchmark_options{};
+
     // Map of argument strings to lambda functions
     std::unordered_map<std::string, std::function<void(int&)>> arg_map = {
         {"-h",
@@ -62,6 +67,13 @@ int main(int argc, char* argv[]) {
                     "parent of game path\n"
                     "  --wait-for-debugger           Wait for debugger to attach\n"
                     "  --wait-for-pid <pid>          Wait for process with specified PID to stop\n"
+                    "  --benchmark <frames|seconds>s Run for a number of frames, or seconds with "
+                    "an s suffix, then write a JSON report and exit\n"
+                    "  --record-input <file>         Record pad input against the frame "
+                    "number\n"
+                    "  --replay-input <file>         Play back recorded or scripted pad input\n"
+                    "  --benchmark-report <file>     Path of the benchmark report, default is "
+                    "benchmark.json\n"
                     "  --config-clean                Run the emulator with the default config "
                     "values, ignores the config file(s) entirely.\n"
                     "  --config-global               Run the emulator with the base config file "
@@ -178,6 +190,53 @@ int main(int argc, char* argv[]) {
                  exit(1);
              }
              waitPid = std::stoi(argv[i]);
+         }},
+        {"--benchmark",
+         [&](int& i) {
+             if (++i >= argc) {
+                 std::cerr << "Error: Missing argument for --benchmark\n";
+                 exit(1);
+             }
+             std::string length{argv[i]};
+             try {
+                 if (length.ends_with('s')) {
+                     length.pop_back();
+                     benchmark_options.num_seconds = std::stod(length);
+                 } else {
+                     benchmark_options.num_frames = std::stoull(length);
+                 }
+             } catch (const std::exception&) {
+                 std::cerr << "Error: Invalid argument for --benchmark: " << argv[i] << "\n";
+                 exit(1);
+             }
+             if (benchmark_options.num_frames == 0 && benchmark_options.num_seconds <= 0.0) {
+                 std::cerr << "Error: Benchmark length must be positive\n";
+                 exit(1);
+             }
+             benchmark = true;
+         }},
+        {"--record-input",
+         [&](int& i) {
+             if (++i >= argc) {
+                 std::cerr << "Error: Missing argument for --record-input\n";
+                 exit(1);
+             }
+             Input::Recording::SetRecordPath(argv[i]);
+         }},
+        {"--replay-input",
+         [&](int& i) {
+             if (++i >= argc) {
+                 std::cerr << "Error: Missing argument for --replay-input\n";
+                 exit(1);
+             }
+             Input::Recording::SetReplayPath(argv[i]);
+         }},
+        {"--benchmark-report", [&](int& i) {
+             if (++i >= argc) {
+                 std::cerr << "Error: Missing argument for --benchmark-report\n";
+                 exit(1);
+             }
+             benchmark_options.report_path = argv[i];
          }}};
 
     if (argc == 1) {
@@ -252,6 +311,10 @@ int main(int argc, char* argv[]) {
         Core::Debugger::WaitForPid(waitPid.value());
     }
 
+    if (benchmark) {
+        Core::Benchmark::Configure(benchmark_options);
+    }
+
     // Run the emulator with the resolved eboot path
     Core::Emulator* emulator = Common::Singleton<Core::Emulator>::Instance();
     emulator->executableName = argv[0];
@@ -4,6 +4,7 @@
 #include "common/path_util.h"
 #include "game_grid_frame.h"
 #include "qt_gui/compatibility_info.h"
+#include "thumbnail_cache.h"
 
 GameGridFrame::GameGridFrame(std::shared_ptr<gui_settings> gui_settings,
                              std::shared_ptr<GameInfoClass> game_info_get,
@@ -33,6 +34,20 @@ GameGridFrame::GameGridFrame(std::shared_ptr<gui_settings> gui_settings,
             &GameGridFrame::RefreshGridBackgroundImage);
     connect(this->horizontalScrollBar(), &QScrollBar::valueChanged, this,
             &GameGridFrame::RefreshGridBackgroundImage);
+    connect(this->verticalScrollBar(), &QScrollBar::valueChanged, this,
+            &GameGridFrame::LoadVisibleIcons);
+    connect(&ThumbnailCache::getInstance(), &ThumbnailCache::ThumbnailReady, this,
+            &GameGridFrame::LoadVisibleIcons);
+    connect(&ThumbnailCache::getInstance(), &ThumbnailCache::BackgroundReady, this,
+            [this](const QString& path, int opacity, const QImage& image) {
+                QString current_path;
+                Common::FS::PathToQString(current_path, m_current_game_path);
+                if (image.isNull() || path != current_path || opacity != m_last_opacity) {
+                    return;
+                }
+                backgroundImage = image;
+                RefreshGridBackgroundImage();
+            });
     connect(this, &QTableWidget::customContextMenuRequested, this, [=, this](const QPoint& pos) {
         m_gui_context_menus.RequestGameMenu(pos, m_game_info->m_games, m_compat_info,
                                             m_gui_settings, this, false);
@@ -119,11 +134,10 @@ void GameGridFrame::PopulateGameGrid(QVector<GameInfo> m_games_search, bool from
         QWidget* image_container = new QWidget();
         image_container->setFixedSize(icon_size, icon_size);
 
+        // Icons are loaded once their cell is scrolled into view.
         QLabel* image_label = new QLabel(image_container);
-        QImage icon = m_games_[gameCounter].icon.scaled(
-            QSize(icon_size, icon_size), Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
-        image_label->setFixedSize(icon.width(), icon.height());
-        image_label->setPixmap(QPixmap::fromImage(icon));
+        image_label->setObjectName("gameIcon");
+        image_label->setFixedSize(icon_size, icon_size);
         image_label->move(0, 0);
         SetFavoriteIcon(image_container, m_games_, gameCounter);
         SetGameConfigIcon(image_container, m_games_, gameCounter);
@@ -173,6 +187,38 @@ void GameGridFrame::PopulateGameGrid(QVector<GameInfo> m_games_search, bool from
     m_games_.clear();
     this->resizeRowsToContents();
     this->resizeColumnsToContents();
+    LoadVisibleIcons();
+}
+
+void GameGridFrame::LoadVisibleIcons() {
+    if (!m_games_shared || this->rowCount() == 0 || this->columnCount() == 0) {
+        return;
+    }
+    const int first_row = std::max(this->rowAt(0), 0);
+    int last_row = this->rowAt(this->viewport()->height() - 1);
+    if (last_row < 0) {
+        last_row = this->rowCount() - 1;
+    }
+
+    auto& thumbnail_cache = ThumbnailCache::getInstance();
+    for (int row = first_row; row <= last_row; row++) {
+        for (int column = 0; column < this->columnCount(); column++) {
+            const int index = row * this->columnCount() + column;
+            if (index >= m_games_shared->size()) {
+                return;
+            }
+            QWidget* widget = this->cellWidget(row, column);
+            QLabel* image_label = widget ? widget->findChild<QLabel*>("gameIcon") : nullptr;
+            if (!image_label || !image_label->pixmap().isNull()) {
+                continue;
+            }
+            const QPixmap icon =
+                thumbnail_cache.Request((*m_games_shared)[index].icon_path, icon_size);
+            if (!icon.isNull()) {
+                image_label->setPixmap(icon);
+            }
+        }
+    }
 }
 
 void GameGridFrame::SetGridBackgroundImage(int row, int column) {
@@ -195,15 +241,12 @@ void GameGridFrame::SetGridBackgroundImage(int row, int column) {
     const auto& game = (*m_games_shared)[itemID];
     const int opacity = m_gui_settings->GetValue(gui::gl_backgroundImageOpacity).toInt();
 
-    // Recompute if opacity changed or we switched to a different game
+    // Recompute if opacity changed or we switched to a different game, the image is decoded in
+    // the background and shown once ready
     if (opacity != m_last_opacity || game.pic_path != m_current_game_path) {
-        QImage original_image(QString::fromStdString(game.pic_path.string()));
-        if (!original_image.isNull()) {
-            backgroundImage = m_game_list_utils.ChangeImageOpacity(
-                original_image, original_image.rect(), opacity / 100.0f);
-            m_last_opacity = opacity;
-            m_current_game_path = game.pic_path;
-        }
+        m_last_opacity = opacity;
+        m_current_game_path = game.pic_path;
+        ThumbnailCache::getInstance().RequestBackground(game.pic_path, opacity);
     }
 
     RefreshGridBackgroundImage();
@@ -214,16 +257,21 @@ void GameGridFrame::RefreshGridBackgroundImage() {
     if (!backgroundImage.isNull() &&
         m_gui_settings->GetValue(gui::gl_showBackgroundImage).toBool()) {
         QSize widgetSize = size();
-        QPixmap scaledPixmap =
-            QPixmap::fromImage(backgroundImage)
-                .scaled(widgetSize, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
-        int x = (widgetSize.width() - scaledPixmap.width()) / 2;
-        int y = (widgetSize.height() - scaledPixmap.height()) / 2;
-        QPixmap finalPixmap(widgetSize);
-        finalPixmap.fill(Qt::transparent);
-        QPainter painter(&finalPixmap);
-        painter.drawPixmap(x, y, scaledPixmap);
-        palette.setBrush(QPalette::Base, QBrush(finalPixmap));
+        // Scaling the full size image is slow, only redo it when the image or size changed.
+        if (widgetSize != m_background_size || backgroundImage.cacheKey() != m_background_key) {
+            QPixmap scaledPixmap =
+                QPixmap::fromImage(backgroundImage)
+                    .scaled(widgetSize, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+            int x = (widgetSize.width() - scaledPixmap.width()) / 2;
+            int y = (widgetSize.height() - scaledPixmap.height()) / 2;
+            m_background_pixmap = QPixmap(widgetSize);
+            m_background_pixmap.fill(Qt::transparent);
+            QPainter painter(&m_background_pixmap);
+            painter.drawPixmap(x, y, scaledPixmap);
+            m_background_size = widgetSize;
+            m_background_key = backgroundImage.cacheKey();
+        }
+        palette.setBrush(QPalette::Base, QBrush(m_background_pixmap));
     }
     QColor transparentColor = QColor(135, 206, 235, 40);
     palette.setColor(QPalette::Highlight, transparentColor);
@@ -233,6 +281,7 @@ void GameGridFrame::RefreshGridBackgroundImage() {
 void GameGridFrame::resizeEvent(QResizeEvent* event) {
     QTableWidget::resizeEvent(event);
     RefreshGridBackgroundImage();
+    LoadVisibleIcons();
 }
 
 bool GameGridFrame::IsValidCellSelected() {
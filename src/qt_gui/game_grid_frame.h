@@ -27,9 +27,13 @@ public Q_SLOTS:
     void PlayBackgroundMusic(QString path);
     void onCurrentCellChanged(int currentRow, int currentColumn, int previousRow,
                               int previousColumn);
+    void LoadVisibleIcons();
 
 private:
     QImage backgroundImage;
+    QPixmap m_background_pixmap; // Background scaled to m_background_size
+    QSize m_background_size;
+    qint64 m_background_key = 0;
     GameListUtils m_game_list_utils;
     GuiContextMenus m_gui_context_menus;
     std::shared_ptr<GameInfoClass> m_game_info;
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <QFileInfo>
+#include <QJsonDocument>
 #include <QProgressDialog>
 
 #include "common/path_util.h"
@@ -34,40 +36,197 @@ void ScanDirectoryRecursively(const QString& dir, QStringList& filePaths, int cu
     }
 }
 
-GameInfoClass::GameInfoClass() = default;
+namespace {
+
+qint64 LastModified(const std::filesystem::path& path) {
+    QString qpath;
+    Common::FS::PathToQString(qpath, path);
+    return QFileInfo(qpath).lastModified().toMSecsSinceEpoch();
+}
+
+QString PathToString(const std::filesystem::path& path) {
+    QString qpath;
+    Common::FS::PathToQString(qpath, path);
+    return qpath;
+}
+
+} // namespace
+
+GameInfoClass::GameInfoClass() {
+    Common::FS::PathToQString(m_index_filename,
+                              Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) /
+                                  "game_library.json");
+    // Installing a game touches the directory several times, refresh once it settles.
+    m_change_timer.setSingleShot(true);
+    m_change_timer.setInterval(1000);
+    connect(&m_watcher, &QFileSystemWatcher::directoryChanged, &m_change_timer,
+            qOverload<>(&QTimer::start));
+    connect(&m_change_timer, &QTimer::timeout, this, &GameInfoClass::LibraryChanged);
+}
+
 GameInfoClass::~GameInfoClass() = default;
 
+GameInfoClass::ScannedGame GameInfoClass::ScanGame(const std::filesystem::path& path) const {
+    std::filesystem::path game_path = path;
+    std::filesystem::path update_path = path;
+    update_path += "-UPDATE";
+    std::filesystem::path patch_path = path;
+    patch_path += "-patch";
+    std::filesystem::path param_sfo_path;
+    SceUpdateChecker("param.sfo", param_sfo_path, update_path, patch_path, game_path);
+
+    // Files are only reread when the param.sfo in use or the game directory changed.
+    const QJsonObject stamps{
+        {"param_sfo", PathToString(param_sfo_path)},
+        {"param_sfo_mtime", LastModified(param_sfo_path)},
+        {"dir_mtime", LastModified(path)},
+        {"has_size", Config::GetLoadGameSizeEnabled()},
+    };
+
+    const auto it = m_library_index.find(PathToString(path));
+    if (it == m_library_index.end() || it->value("param_sfo") != stamps["param_sfo"] ||
+        it->value("param_sfo_mtime") != stamps["param_sfo_mtime"] ||
+        it->value("dir_mtime") != stamps["dir_mtime"] ||
+        it->value("has_size") != stamps["has_size"]) {
+        return {readGameInfo(path), stamps, false};
+    }
+
+    const QJsonObject& entry = *it;
+    GameInfo game;
+    game.path = path;
+    game.icon_path = Common::FS::PathFromQString(entry["icon_path"].toString());
+    game.pic_path = Common::FS::PathFromQString(entry["pic_path"].toString());
+    game.snd0_path = Common::FS::PathFromQString(entry["snd0_path"].toString());
+    game.size = entry["size"].toString().toStdString();
+    game.name = entry["name"].toString().toStdString();
+    game.serial = entry["serial"].toString().toStdString();
+    game.version = entry["version"].toString().toStdString();
+    game.region = entry["region"].toString().toStdString();
+    game.fw = entry["fw"].toString().toStdString();
+    game.save_dir = entry["save_dir"].toString().toStdString();
+    game.play_time = entry["play_time"].toString().toStdString();
+    return {std::move(game), stamps, true};
+}
+
+void GameInfoClass::LoadLibraryIndex() {
+    m_index_loaded = true;
+    QFile index_file(m_index_filename);
+    if (!index_file.open(QIODevice::ReadOnly)) {
+        return;
+    }
+    const QJsonDocument json_doc = QJsonDocument::fromJson(index_file.readAll());
+    index_file.close();
+
+    const QJsonObject index = json_doc.object();
+    for (auto it = index.begin(); it != index.end(); ++it) {
+        m_library_index.insert(it.key(), it.value().toObject());
+    }
+}
+
+void GameInfoClass::SaveLibraryIndex() const {
+    QJsonObject index;
+    for (auto it = m_library_index.begin(); it != m_library_index.end(); ++it) {
+        index.insert(it.key(), it.value());
+    }
+    QFile index_file(m_index_filename);
+    if (!index_file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return;
+    }
+    index_file.write(QJsonDocument(index).toJson(QJsonDocument::Compact));
+    index_file.close();
+}
+
+void GameInfoClass::WatchInstallDirs(const QStringList& install_dirs) {
+    if (const auto watched = m_watcher.directories(); !watched.isEmpty()) {
+        m_watcher.removePaths(watched);
+    }
+    for (const auto& dir : install_dirs) {
+        if (QFileInfo::exists(dir)) {
+            m_watcher.addPath(dir);
+        }
+    }
+}
+
 void GameInfoClass::GetGameInfo(QWidget* parent) {
-    QStringList filePaths;
+    if (!m_index_loaded) {
+        LoadLibraryIndex();
+    }
+
+    QStringList installDirs;
     for (const auto& installLoc : Config::getGameInstallDirs()) {
         QString installDir;
         Common::FS::PathToQString(installDir, installLoc);
-        ScanDirectoryRecursively(installDir, filePaths, 0);
+        installDirs.append(installDir);
+    }
+    WatchInstallDirs(installDirs);
+
+    QStringList filePaths;
+    const auto dirPaths = QtConcurrent::mapped(installDirs, [](const QString& installDir) {
+                              QStringList paths;
+                              ScanDirectoryRecursively(installDir, paths, 0);
+                              return paths;
+                          }).results();
+    for (const auto& paths : dirPaths) {
+        filePaths.append(paths);
     }
 
-    m_games = QtConcurrent::mapped(filePaths, [&](const QString& path) {
-                  return readGameInfo(Common::FS::PathFromQString(path));
-              }).results();
+    auto scanned = QtConcurrent::mapped(filePaths, [this](const QString& path) {
+                       return ScanGame(Common::FS::PathFromQString(path));
+                   }).results();
 
+    // Only games that are new or changed need their folder size to be calculated.
+    QList<GameInfo*> unsized;
+    for (auto& game : scanned) {
+        if (!game.is_cached) {
+            unsized.append(&game.game);
+        }
+    }
+
+    if (!unsized.isEmpty()) {
+        // Progress bar, please be patient :)
+        QProgressDialog dialog(tr("Loading game list, please wait :3"), tr("Cancel"), 0, 0,
+                               parent);
+        dialog.setWindowTitle(tr("Loading..."));
+
+        QFutureWatcher<void> futureWatcher;
+        futureWatcher.setFuture(QtConcurrent::map(
+            unsized, [](GameInfo* game) { GameListUtils::GetFolderSize(*game); }));
+        connect(&futureWatcher, &QFutureWatcher<void>::finished, [&]() { dialog.reset(); });
+        connect(&dialog, &QProgressDialog::canceled, &futureWatcher,
+                &QFutureWatcher<void>::cancel);
+        dialog.setRange(0, unsized.size());
+        connect(&futureWatcher, &QFutureWatcher<void>::progressValueChanged, &dialog,
+                &QProgressDialog::setValue);
+
+        dialog.exec();
+        futureWatcher.waitForFinished();
+    }
+
+    m_games.clear();
+    m_library_index.clear();
+    for (auto& [game, stamps, is_cached] : scanned) {
+        QJsonObject entry = std::move(stamps);
+        entry["icon_path"] = PathToString(game.icon_path);
+        entry["pic_path"] = PathToString(game.pic_path);
+        entry["snd0_path"] = PathToString(game.snd0_path);
+        entry["size"] = QString::fromStdString(game.size);
+        if (game.size.empty()) {
+            // Sizing was cancelled, calculate it on the next scan.
+            entry.remove("has_size");
+        }
+        entry["name"] = QString::fromStdString(game.name);
+        entry["serial"] = QString::fromStdString(game.serial);
+        entry["version"] = QString::fromStdString(game.version);
+        entry["region"] = QString::fromStdString(game.region);
+        entry["fw"] = QString::fromStdString(game.fw);
+        entry["save_dir"] = QString::fromStdString(game.save_dir);
+        entry["play_time"] = QString::fromStdString(game.play_time);
+        m_library_index.insert(PathToString(game.path), entry);
+        m_games.append(std::move(game));
+    }
+    SaveLibraryIndex();
+
+    std::sort(m_games.begin(), m_games.end(), CompareStrings);
     // used to retrieve values after performing a search
     m_games_backup = m_games;
-
-    // Progress bar, please be patient :)
-    QProgressDialog dialog(tr("Loading game list, please wait :3"), tr("Cancel"), 0, 0, parent);
-    dialog.setWindowTitle(tr("Loading..."));
-
-    QFutureWatcher<void> futureWatcher;
-    GameListUtils game_util;
-    bool finished = false;
-    futureWatcher.setFuture(QtConcurrent::map(m_games, game_util.GetFolderSize));
-    connect(&futureWatcher, &QFutureWatcher<void>::finished, [&]() {
-        dialog.reset();
-        std::sort(m_games.begin(), m_games.end(), CompareStrings);
-    });
-    connect(&dialog, &QProgressDialog::canceled, &futureWatcher, &QFutureWatcher<void>::cancel);
-    dialog.setRange(0, m_games.size());
-    connect(&futureWatcher, &QFutureWatcher<void>::progressValueChanged, &dialog,
-            &QProgressDialog::setValue);
-
-    dialog.exec();
 }
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <QFileSystemWatcher>
 #include <QFutureWatcher>
+#include <QJsonObject>
+#include <QTimer>
 #include <QtConcurrent>
 
 #include "common/config.h"
@@ -19,6 +22,12 @@ public:
     QVector<GameInfo> m_games;
     QVector<GameInfo> m_games_backup;
 
+signals:
+    /// Emitted shortly after the contents of an install directory changed.
+    void LibraryChanged();
+
+public:
+
     static void SceUpdateChecker(const std::string sceItem, std::filesystem::path& gameItem,
                                  std::filesystem::path& update_folder,
                                  std::filesystem::path& patch_folder,
@@ -50,12 +59,9 @@ public:
         SceUpdateChecker("param.sfo", param_sfo_path, game_update_path, game_patch_path, game.path);
 
         PSF psf;
-        if (psf.Open(param_sfo_path)) {
+        if (psf.OpenMapped(param_sfo_path)) {
             SceUpdateChecker("icon0.png", game.icon_path, game_update_path, game_patch_path,
                              game.path);
-            QString iconpath;
-            Common::FS::PathToQString(iconpath, game.icon_path);
-            game.icon = QImage(iconpath);
             SceUpdateChecker("pic1.png", game.pic_path, game_update_path, game_patch_path,
                              game.path);
             SceUpdateChecker("snd0.at9", game.snd0_path, game_update_path, game_patch_path,
@@ -97,4 +103,24 @@ public:
         }
         return game;
     }
+
+private:
+    struct ScannedGame {
+        GameInfo game;
+        QJsonObject stamps;
+        bool is_cached;
+    };
+
+    /// Returns the game from the library index if its files are unchanged, or reads it anew.
+    ScannedGame ScanGame(const std::filesystem::path& path) const;
+
+    void LoadLibraryIndex();
+    void SaveLibraryIndex() const;
+    void WatchInstallDirs(const QStringList& install_dirs);
+
+    QString m_index_filename;
+    QHash<QString, QJsonObject> m_library_index;
+    bool m_index_loaded = false;
+    QFileSystemWatcher m_watcher;
+    QTimer m_change_timer;
 };
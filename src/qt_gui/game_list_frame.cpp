@@ -8,6 +8,7 @@
 #include "common/string_util.h"
 #include "game_list_frame.h"
 #include "game_list_utils.h"
+#include "thumbnail_cache.h"
 
 GameListFrame::GameListFrame(std::shared_ptr<gui_settings> gui_settings,
                              std::shared_ptr<GameInfoClass> game_info_get,
@@ -60,6 +61,20 @@ GameListFrame::GameListFrame(std::shared_ptr<gui_settings> gui_settings,
             &GameListFrame::RefreshListBackgroundImage);
     connect(this->horizontalScrollBar(), &QScrollBar::valueChanged, this,
             &GameListFrame::RefreshListBackgroundImage);
+    connect(this->verticalScrollBar(), &QScrollBar::valueChanged, this,
+            &GameListFrame::LoadVisibleIcons);
+    connect(&ThumbnailCache::getInstance(), &ThumbnailCache::ThumbnailReady, this,
+            &GameListFrame::LoadVisibleIcons);
+    connect(&ThumbnailCache::getInstance(), &ThumbnailCache::BackgroundReady, this,
+            [this](const QString& path, int opacity, const QImage& image) {
+                QString current_path;
+                Common::FS::PathToQString(current_path, m_current_game_path);
+                if (image.isNull() || path != current_path || opacity != m_last_opacity) {
+                    return;
+                }
+                backgroundImage = image;
+                RefreshListBackgroundImage();
+            });
 
     this->horizontalHeader()->setSortIndicatorShown(true);
     this->horizontalHeader()->setSectionsClickable(true);
@@ -215,16 +230,12 @@ void GameListFrame::SetListBackgroundImage(QTableWidgetItem* item) {
     const auto& game = m_game_info->m_games[item->row()];
     const int opacity = m_gui_settings->GetValue(gui::gl_backgroundImageOpacity).toInt();
 
-    // Recompute if opacity changed or we switched to a different game
+    // Recompute if opacity changed or we switched to a different game, the image is decoded in
+    // the background and shown once ready
     if (opacity != m_last_opacity || game.pic_path != m_current_game_path) {
-        auto image_path = game.pic_path.u8string();
-        QImage original_image(QString::fromStdString({image_path.begin(), image_path.end()}));
-        if (!original_image.isNull()) {
-            backgroundImage = m_game_list_utils.ChangeImageOpacity(
-                original_image, original_image.rect(), opacity / 100.0f);
-            m_last_opacity = opacity;
-            m_current_game_path = game.pic_path;
-        }
+        m_last_opacity = opacity;
+        m_current_game_path = game.pic_path;
+        ThumbnailCache::getInstance().RequestBackground(game.pic_path, opacity);
     }
 
     RefreshListBackgroundImage();
@@ -235,16 +246,21 @@ void GameListFrame::RefreshListBackgroundImage() {
     if (!backgroundImage.isNull() &&
         m_gui_settings->GetValue(gui::gl_showBackgroundImage).toBool()) {
         QSize widgetSize = size();
-        QPixmap scaledPixmap =
-            QPixmap::fromImage(backgroundImage)
-                .scaled(widgetSize, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
-        int x = (widgetSize.width() - scaledPixmap.width()) / 2;
-        int y = (widgetSize.height() - scaledPixmap.height()) / 2;
-        QPixmap finalPixmap(widgetSize);
-        finalPixmap.fill(Qt::transparent);
-        QPainter painter(&finalPixmap);
-        painter.drawPixmap(x, y, scaledPixmap);
-        palette.setBrush(QPalette::Base, QBrush(finalPixmap));
+        // Scaling the full size image is slow, only redo it when the image or size changed.
+        if (widgetSize != m_background_size || backgroundImage.cacheKey() != m_background_key) {
+            QPixmap scaledPixmap =
+                QPixmap::fromImage(backgroundImage)
+                    .scaled(widgetSize, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+            int x = (widgetSize.width() - scaledPixmap.width()) / 2;
+            int y = (widgetSize.height() - scaledPixmap.height()) / 2;
+            m_background_pixmap = QPixmap(widgetSize);
+            m_background_pixmap.fill(Qt::transparent);
+            QPainter painter(&m_background_pixmap);
+            painter.drawPixmap(x, y, scaledPixmap);
+            m_background_size = widgetSize;
+            m_background_key = backgroundImage.cacheKey();
+        }
+        palette.setBrush(QPalette::Base, QBrush(m_background_pixmap));
     }
     QColor transparentColor = QColor(135, 206, 235, 40);
     palette.setColor(QPalette::Highlight, transparentColor);
@@ -254,6 +270,7 @@ void GameListFrame::RefreshListBackgroundImage() {
 void GameListFrame::resizeEvent(QResizeEvent* event) {
     QTableWidget::resizeEvent(event);
     RefreshListBackgroundImage();
+    LoadVisibleIcons();
 }
 
 bool GameListFrame::CompareWithFavorite(GameInfo a, GameInfo b, int columnIndex, bool ascending) {
@@ -301,17 +318,40 @@ void GameListFrame::ApplyLastSorting(bool isInitialPopulation) {
 }
 
 void GameListFrame::ResizeIcons(int iconSize) {
-    for (int index = 0; auto& game : m_game_info->m_games) {
-        QImage scaledPixmap = game.icon.scaled(QSize(iconSize, iconSize), Qt::KeepAspectRatio,
-                                               Qt::SmoothTransformation);
+    // Icons are loaded once their row is scrolled into view, the items reserve their size.
+    for (int index = 0; index < m_game_info->m_games.size(); index++) {
         QTableWidgetItem* iconItem = new QTableWidgetItem();
-        this->verticalHeader()->resizeSection(index, scaledPixmap.height());
-        this->horizontalHeader()->resizeSection(0, scaledPixmap.width());
-        iconItem->setData(Qt::DecorationRole, scaledPixmap);
+        iconItem->setSizeHint(QSize(iconSize, iconSize));
+        this->verticalHeader()->resizeSection(index, iconSize);
         this->setItem(index, 0, iconItem);
-        index++;
     }
+    this->horizontalHeader()->resizeSection(0, iconSize);
     this->horizontalHeader()->setSectionResizeMode(8, QHeaderView::ResizeToContents);
+    LoadVisibleIcons();
+}
+
+void GameListFrame::LoadVisibleIcons() {
+    if (this->rowCount() == 0) {
+        return;
+    }
+    const int first_row = std::max(this->rowAt(0), 0);
+    int last_row = this->rowAt(this->viewport()->height() - 1);
+    if (last_row < 0) {
+        last_row = this->rowCount() - 1;
+    }
+
+    auto& thumbnail_cache = ThumbnailCache::getInstance();
+    for (int row = first_row; row <= last_row && row < m_game_info->m_games.size(); row++) {
+        QTableWidgetItem* iconItem = this->item(row, 0);
+        if (!iconItem || !iconItem->data(Qt::DecorationRole).isNull()) {
+            continue;
+        }
+        const QPixmap icon =
+            thumbnail_cache.Request(m_game_info->m_games[row].icon_path, icon_size);
+        if (!icon.isNull()) {
+            iconItem->setData(Qt::DecorationRole, icon);
+        }
+    }
 }
 
 void GameListFrame::SetCompatibilityItem(int row, int column, CompatibilityEntry entry) {
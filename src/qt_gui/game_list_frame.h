@@ -38,6 +38,7 @@ public Q_SLOTS:
     void PlayBackgroundMusic(QTableWidgetItem* item);
     void onCurrentCellChanged(int currentRow, int currentColumn, int previousRow,
                               int previousColumn);
+    void LoadVisibleIcons();
 
 private:
     void SetTableItem(int row, int column, QString itemStr);
@@ -51,6 +52,9 @@ private:
     int sortColumn = 1;
     QTableWidgetItem* m_current_item = nullptr;
     int m_last_opacity = -1; // Track last opacity to avoid unnecessary recomputation
+    QPixmap m_background_pixmap; // Background scaled to m_background_size
+    QSize m_background_size;
+    qint64 m_background_key = 0;
     std::filesystem::path m_current_game_path; // Track current game path to detect changes
     std::shared_ptr<gui_settings> m_gui_settings;
 
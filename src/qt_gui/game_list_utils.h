@@ -17,7 +17,6 @@ struct GameInfo {
     std::filesystem::path icon_path; // path of icon0.png
     std::filesystem::path pic_path;  // path of pic1.png
     std::filesystem::path snd0_path; // path of snd0.at9
-    QImage icon;
     std::string size;
     // variables extracted from param.sfo
     std::string name = "Unknown";
@@ -120,13 +120,14 @@ SettingsDialog::SettingsDialog(std::shared_ptr<gui_settings> gui_settings,
     ui->buttonBox->button(QDialogButtonBox::StandardButton::Close)->setFocus();
 
     channelMap = {{tr("Release"), "Release"}, {tr("Nightly"), "Nightly"}};
-    logTypeMap = {{tr("async"), "async"}, {tr("sync"), "sync"}};
+    logTypeMap = {{tr("async"), "async"}, {tr("sync"), "sync"}, {tr("binary"), "binary"}};
     screenModeMap = {{tr("Fullscreen (Borderless)"), "Fullscreen (Borderless)"},
                      {tr("Windowed"), "Windowed"},
                      {tr("Fullscreen"), "Fullscreen"}};
     presentModeMap = {{tr("Mailbox (Vsync)"), "Mailbox"},
                       {tr("Fifo (Vsync)"), "Fifo"},
-                      {tr("Immediate (No Vsync)"), "Immediate"}};
+                      {tr("Immediate (No Vsync)"), "Immediate"},
+                      {tr("Auto (Vsync, adaptive)"), "Auto"}};
     chooseHomeTabMap = {{tr("General"), "General"},
                         {tr("Frontend"), "Frontend"},
                         {tr("Graphics"), "Graphics"},
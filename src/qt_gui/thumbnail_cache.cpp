@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFileInfo>
+#include <QFutureWatcher>
+#include <QImageReader>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+#include "common/path_util.h"
+#include "game_list_utils.h"
+#include "thumbnail_cache.h"
+
+namespace {
+
+/// Decoded thumbnails kept in memory, in KiB.
+constexpr int MaxCachedPixmaps = 64 * 1024;
+
+/// Sizes of the thumbnails on disk, requests are scaled down from the next larger one.
+constexpr int ThumbnailSizes[] = {64, 128, 256, 512};
+
+} // namespace
+
+ThumbnailCache::ThumbnailCache(QObject* parent) : QObject(parent) {
+    m_pixmaps.setMaxCost(MaxCachedPixmaps);
+    Common::FS::PathToQString(m_cache_dir,
+                              Common::FS::GetUserPath(Common::FS::PathType::MetaDataDir) /
+                                  "thumbnails");
+    QDir().mkpath(m_cache_dir);
+}
+
+QPixmap ThumbnailCache::Request(const std::filesystem::path& path, int size) {
+    QString source;
+    Common::FS::PathToQString(source, path);
+    if (source.isEmpty() || size <= 0) {
+        return {};
+    }
+
+    const QString key = QString("%1@%2").arg(source).arg(size);
+    if (const QPixmap* pixmap = m_pixmaps.object(key)) {
+        return *pixmap;
+    }
+    if (m_pending.contains(key)) {
+        return {};
+    }
+    m_pending.insert(key);
+
+    auto* watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, key, source, size] {
+        const QImage image = watcher->result();
+        watcher->deleteLater();
+        m_pending.remove(key);
+        // Images that fail to load are cached as null pixmaps to not retry them on every scroll.
+        const int cost = std::max<int>(1, image.sizeInBytes() / 1024);
+        m_pixmaps.insert(key, new QPixmap(QPixmap::fromImage(image)), cost);
+        emit ThumbnailReady(source, size);
+    });
+    watcher->setFuture(QtConcurrent::run([cache_dir = m_cache_dir, source, size] {
+        return LoadThumbnail(cache_dir, source, size);
+    }));
+    return {};
+}
+
+void ThumbnailCache::RequestBackground(const std::filesystem::path& path, int opacity) {
+    QString source;
+    Common::FS::PathToQString(source, path);
+
+    auto* watcher = new QFutureWatcher<QImage>(this);
+    connect(watcher, &QFutureWatcher<QImage>::finished, this, [this, watcher, source, opacity] {
+        const QImage image = watcher->result();
+        watcher->deleteLater();
+        emit BackgroundReady(source, opacity, image);
+    });
+    watcher->setFuture(QtConcurrent::run([source, opacity] {
+        const QImage image(source);
+        if (image.isNull()) {
+            return image;
+        }
+        return GameListUtils::ChangeImageOpacity(image, image.rect(), opacity / 100.0f);
+    }));
+}
+
+QImage ThumbnailCache::LoadThumbnail(const QString& cache_dir, const QString& path, int size) {
+    const QFileInfo source_info(path);
+    if (!source_info.exists()) {
+        return {};
+    }
+
+    int thumbnail_size = ThumbnailSizes[std::size(ThumbnailSizes) - 1];
+    for (const int bucket : ThumbnailSizes) {
+        if (bucket >= size) {
+            thumbnail_size = bucket;
+            break;
+        }
+    }
+    const QString hash =
+        QCryptographicHash::hash(path.toUtf8(), QCryptographicHash::Md5).toHex();
+    const QString thumbnail_path = QString("%1/%2_%3.png").arg(cache_dir, hash).arg(thumbnail_size);
+
+    QImage image;
+    const QFileInfo thumbnail_info(thumbnail_path);
+    if (thumbnail_info.exists() && thumbnail_info.lastModified() >= source_info.lastModified()) {
+        image.load(thumbnail_path);
+    }
+    if (image.isNull()) {
+        QImageReader reader(path);
+        image = reader.read();
+        if (image.isNull()) {
+            return {};
+        }
+        if (image.width() > thumbnail_size || image.height() > thumbnail_size) {
+            image = image.scaled(thumbnail_size, thumbnail_size, Qt::KeepAspectRatio,
+                                 Qt::SmoothTransformation);
+        }
+        // Requests of another size can write the same thumbnail concurrently.
+        QSaveFile thumbnail_file(thumbnail_path);
+        if (thumbnail_file.open(QIODevice::WriteOnly) && image.save(&thumbnail_file, "PNG")) {
+            thumbnail_file.commit();
+        }
+    }
+
+    if (image.width() != size && image.height() != size) {
+        image = image.scaled(size, size, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+    }
+    return image;
+}
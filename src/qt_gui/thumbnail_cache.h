@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <filesystem>
+#include <QCache>
+#include <QImage>
+#include <QObject>
+#include <QPixmap>
+#include <QSet>
+
+/**
+ * Scaled images of the game list views. Images are decoded on the global thread pool and their
+ * thumbnails are kept on disk at a few fixed sizes, so each icon only has to be decoded in full
+ * once.
+ */
+class ThumbnailCache : public QObject {
+    Q_OBJECT
+
+public:
+    static ThumbnailCache& getInstance() {
+        static ThumbnailCache instance;
+        return instance;
+    }
+
+    /// Returns the image scaled to fit size, or a null pixmap while it is being loaded.
+    QPixmap Request(const std::filesystem::path& path, int size);
+
+    /// Loads a background image with an opacity in percent, emitting BackgroundReady when done.
+    void RequestBackground(const std::filesystem::path& path, int opacity);
+
+signals:
+    void ThumbnailReady(const QString& path, int size);
+    void BackgroundReady(const QString& path, int opacity, const QImage& image);
+
+private:
+    ThumbnailCache(QObject* parent = nullptr);
+
+    static QImage LoadThumbnail(const QString& cache_dir, const QString& path, int size);
+
+    QCache<QString, QPixmap> m_pixmaps;
+    QSet<QString> m_pending;
+    QString m_cache_dir;
+};
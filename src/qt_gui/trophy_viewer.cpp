@@ -286,7 +286,7 @@ void TrophyViewer::PopulateTrophyWidget(QString title) {
     QDir dir(trophyDirQt);
     if (!dir.exists()) {
         std::filesystem::path path = Common::FS::PathFromQString(gameTrpPath_);
-        if (!trp.Extract(path, title.toStdString())) {
+        if (!TRP::ExtractAsync(path, title.toStdString()).get()) {
             QMessageBox::critical(this, "Trophy Data Extraction Error",
                                   "Unable to extract Trophy data, please ensure you have "
                                   "inputted a trophy key in the settings menu.");
@@ -58,7 +58,6 @@ private:
     QStringList headers;
     QString gameTrpPath_;
     QString currentGameName_;
-    TRP trp;
     QLabel* trophyInfoLabel;
     QCheckBox* showEarnedCheck;
     QCheckBox* showNotEarnedCheck;
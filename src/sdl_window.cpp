@@ -318,8 +318,9 @@ WindowSDL::WindowSDL(s32 width_, s32 height_, Input::GameController* controller_
         error = true;
     }
     if (!error) {
-        SDL_SetWindowFullscreenMode(
-            window, Config::getFullscreenMode() == "Fullscreen" ? displayMode : NULL);
+        const bool exclusive =
+            Config::GetSnapshot().fullscreen_mode == Config::FullscreenMode::Fullscreen;
+        SDL_SetWindowFullscreenMode(window, exclusive ? displayMode : NULL);
     }
     SDL_SetWindowFullscreen(window, Config::getIsFullscreen());
 
@@ -419,7 +420,9 @@ void WindowSDL::WaitEvent() {
     case SDL_EVENT_GAMEPAD_SENSOR_UPDATE:
         switch ((SDL_SensorType)event.gsensor.sensor) {
         case SDL_SENSOR_GYRO:
-            controller->Gyro(0, event.gsensor.data);
+            controller->Gyro(0, event.gsensor.data,
+                             event.gsensor.sensor_timestamp != 0 ? event.gsensor.sensor_timestamp
+                                                                 : event.gsensor.timestamp);
             break;
         case SDL_SENSOR_ACCEL:
             controller->Acceleration(0, event.gsensor.data);
@@ -478,7 +481,7 @@ void WindowSDL::WaitEvent() {
 
 void WindowSDL::InitTimers() {
     SDL_AddTimer(100, &PollController, controller);
-    SDL_AddTimer(33, Input::MousePolling, (void*)controller);
+    SDL_AddTimer(Input::MOUSE_POLLING_INTERVAL, Input::MousePolling, (void*)controller);
 }
 
 void WindowSDL::RequestKeyboard() {
@@ -15,6 +15,7 @@ void EmitPrologue(EmitContext& ctx) {
         ctx.DefineWorkgroupIndex();
     }
     ctx.DefineBufferProperties();
+    ctx.DefineTextureHeapImages();
 }
 
 void ConvertDepthMode(EmitContext& ctx) {
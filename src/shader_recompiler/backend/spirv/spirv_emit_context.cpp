@@ -299,6 +299,25 @@ void EmitContext::DefineBufferProperties() {
     }
 }
 
+void EmitContext::DefineTextureHeapImages() {
+    if (!info.uses_texture_heap) {
+        return;
+    }
+    const auto [indices_id, indices_pointer_type] =
+        buffers[texture_heap_index].Alias(PointerType::U32);
+    for (u32 i = 0; i < images.size(); i++) {
+        auto& image = images[i];
+        if (!image.heap_array.value) {
+            continue;
+        }
+        const Id slot_ptr{
+            OpAccessChain(indices_pointer_type, indices_id, u32_zero_value, ConstU32(i))};
+        const Id slot{OpLoad(U32[1], slot_ptr)};
+        Name(slot, fmt::format("img{}_heap_slot", i));
+        image.id = OpAccessChain(image.pointer_type, image.heap_array, slot);
+    }
+}
+
 void EmitContext::DefineAmdPerVertexAttribs() {
     if (!profile.supports_amd_shader_explicit_vertex_parameter) {
         return;
@@ -774,6 +793,12 @@ EmitContext::BufferSpv EmitContext::DefineBuffer(bool is_storage, bool is_writte
     case BufferType::SharedMemory:
         Name(id, "ssbo_shmem");
         break;
+    case BufferType::ProfilingBuffer:
+        Name(id, "profiling_buffer");
+        break;
+    case BufferType::TextureHeapIndices:
+        Name(id, "texture_heap_indices");
+        break;
     default:
         Name(id, fmt::format("{}_{}", is_storage ? "ssbo" : "ubo", binding.buffer));
         break;
@@ -794,6 +819,8 @@ void EmitContext::DefineBuffers() {
             bda_pagetable_index = buffers.size();
         } else if (desc.buffer_type == BufferType::FaultBuffer) {
             fault_buffer_index = buffers.size();
+        } else if (desc.buffer_type == BufferType::TextureHeapIndices) {
+            texture_heap_index = buffers.size();
         }
 
         // Define aliases depending on the shader usage.
@@ -924,6 +951,7 @@ Id ImageType(EmitContext& ctx, const ImageResource& desc, Id sampled_type) {
 }
 
 void EmitContext::DefineImagesAndSamplers() {
+    std::unordered_map<u32, Id> heap_arrays;
     for (const auto& image_desc : info.images) {
         const auto sharp = image_desc.GetSharp(info);
         const auto nfmt = sharp.GetNumberFmt();
@@ -933,6 +961,31 @@ void EmitContext::DefineImagesAndSamplers() {
         const Id sampled_type = data_types[1];
         const Id image_type{ImageType(*this, image_desc, sampled_type)};
         const Id pointer_type{TypePointer(spv::StorageClass::UniformConstant, image_type)};
+        if (info.IsTextureHeapImage(image_desc)) {
+            // Images of the same type share one view of the heap, the element is selected in
+            // the prologue once the slot of the image has been loaded.
+            auto [it, is_new] = heap_arrays.try_emplace(image_type.value);
+            if (is_new) {
+                const Id array_pointer_type{TypePointer(spv::StorageClass::UniformConstant,
+                                                        TypeRuntimeArray(image_type))};
+                it->second =
+                    AddGlobalVariable(array_pointer_type, spv::StorageClass::UniformConstant);
+                Decorate(it->second, spv::Decoration::Binding, 0U);
+                Decorate(it->second, spv::Decoration::DescriptorSet, 1U);
+                Name(it->second, fmt::format("{}_texture_heap{}", stage, heap_arrays.size() - 1));
+                interfaces.push_back(it->second);
+            }
+            images.push_back({
+                .data_types = &data_types,
+                .sampled_type = TypeSampledImage(image_type),
+                .pointer_type = pointer_type,
+                .image_type = image_type,
+                .heap_array = it->second,
+                .view_type = sharp.GetViewType(image_desc.is_array),
+                .is_integer = is_integer,
+            });
+            continue;
+        }
         const Id id{AddGlobalVariable(pointer_type, spv::StorageClass::UniformConstant)};
         Decorate(id, spv::Decoration::Binding, binding.unified++);
         Decorate(id, spv::Decoration::DescriptorSet, 0U);
@@ -979,7 +1032,7 @@ void EmitContext::DefineSharedMemory() {
         return;
     }
     ASSERT(info.stage == Stage::Compute);
-    const u32 shared_memory_size = runtime_info.cs_info.shared_memory_size;
+    const u32 shared_memory_size = info.shared_memory_size;
 
     const auto make_type = [&](IR::Type type, Id element_type, u32 element_size,
                                std::string_view name) {
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <array>
+#include <bit>
 #include <unordered_map>
 #include <sirit/sirit.h>
 
@@ -47,6 +48,7 @@ public:
     void DefineBufferProperties();
     void DefineAmdPerVertexAttribs();
     void DefineWorkgroupIndex();
+    void DefineTextureHeapImages();
 
     [[nodiscard]] Id DefineInput(Id type, std::optional<u32> location = std::nullopt,
                                  std::optional<spv::BuiltIn> builtin = std::nullopt) {
@@ -96,7 +98,11 @@ public:
     }
 
     [[nodiscard]] Id ConstU32(u32 value) {
-        return Constant(U32[1], value);
+        const auto [it, is_new] = u32_constants.try_emplace(value);
+        if (is_new) {
+            it->second = Constant(U32[1], value);
+        }
+        return it->second;
     }
 
     template <typename... Args>
@@ -122,7 +128,11 @@ public:
     }
 
     [[nodiscard]] Id ConstF32(f32 value) {
-        return Constant(F32[1], value);
+        const auto [it, is_new] = f32_constants.try_emplace(std::bit_cast<u32>(value));
+        if (is_new) {
+            it->second = Constant(F32[1], value);
+        }
+        return it->second;
     }
 
     template <typename... Args>
@@ -295,6 +305,7 @@ public:
         Id sampled_type;
         Id pointer_type;
         Id image_type;
+        Id heap_array;
         AmdGpu::ImageType view_type;
         bool is_integer = false;
         bool is_storage = false;
@@ -356,6 +367,7 @@ public:
     size_t flatbuf_index{};
     size_t bda_pagetable_index{};
     size_t fault_buffer_index{};
+    size_t texture_heap_index{};
     Id physical_pointer_type_u32;
 
     Id sampler_type{};
@@ -415,6 +427,11 @@ private:
     Id DefineReadConst(bool dynamic);
 
     Id GetBufferSize(u32 sharp_idx);
+
+    /// Scalar constants by value. Immediates repeat a lot within a shader and a hit here skips
+    /// building and hashing a new declaration in the module.
+    std::unordered_map<u32, Id> u32_constants;
+    std::unordered_map<u32, Id> f32_constants;
 };
 
 } // namespace Shader::Backend::SPIRV
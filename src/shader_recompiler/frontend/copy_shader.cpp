@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <mutex>
+#include <unordered_map>
+
 #include "shader_recompiler/frontend/copy_shader.h"
 #include "shader_recompiler/frontend/decode.h"
 #include "shader_recompiler/ir/attribute.h"
@@ -88,4 +91,16 @@ CopyShaderData ParseCopyShader(std::span<const u32> code) {
     return data;
 }
 
+const CopyShaderData& GetCopyShaderData(std::span<const u32> code, u64 hash) {
+    // Every variant of a geometry shader is compiled against the same copy shader.
+    static std::mutex mutex;
+    static std::unordered_map<u64, CopyShaderData> cache;
+    std::scoped_lock lock{mutex};
+    const auto [it, is_new] = cache.try_emplace(hash);
+    if (is_new) {
+        it->second = ParseCopyShader(code);
+    }
+    return it->second;
+}
+
 } // namespace Shader
@@ -19,4 +19,7 @@ struct CopyShaderData {
 
 CopyShaderData ParseCopyShader(std::span<const u32> code);
 
+/// Returns the parsed copy shader with the given hash, parsing it only on first use.
+const CopyShaderData& GetCopyShaderData(std::span<const u32> code, u64 hash);
+
 } // namespace Shader
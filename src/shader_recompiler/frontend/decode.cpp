@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <array>
 #include "common/assert.h"
 #include "shader_recompiler/frontend/decode.h"
 
@@ -16,7 +17,9 @@ T extract(T value, u32 lst, u32 fst) {
 }
 } // namespace bit
 
-InstEncoding GetInstructionEncoding(u32 token) {
+namespace {
+
+constexpr InstEncoding ClassifyEncoding(u32 token) {
     auto encoding = static_cast<InstEncoding>(token & (u32)EncodingMask::MASK_9bit);
     switch (encoding) {
     case InstEncoding::SOP1:
@@ -82,10 +85,29 @@ InstEncoding GetInstructionEncoding(u32 token) {
         break;
     }
 
-    UNREACHABLE();
     return InstEncoding::ILLEGAL;
 }
 
+// The encoding is fully determined by the top 9 bits of the first token.
+constexpr u32 EncodingShift = 23;
+constexpr auto EncodingTable = [] {
+    std::array<InstEncoding, (1U << (32 - EncodingShift))> table{};
+    for (u32 i = 0; i < table.size(); i++) {
+        table[i] = ClassifyEncoding(i << EncodingShift);
+    }
+    return table;
+}();
+
+} // Anonymous namespace
+
+InstEncoding GetInstructionEncoding(u32 token) {
+    const InstEncoding encoding = EncodingTable[token >> EncodingShift];
+    if (encoding == InstEncoding::ILLEGAL) [[unlikely]] {
+        UNREACHABLE();
+    }
+    return encoding;
+}
+
 bool HasAdditionalLiteral(InstEncoding encoding, Opcode opcode) {
     switch (encoding) {
     case InstEncoding::SOPK: {
@@ -168,94 +190,8 @@ uint32_t GcnDecodeContext::getEncodingLength(InstEncoding encoding) {
     return instLength;
 }
 
-uint32_t GcnDecodeContext::getOpMapOffset(InstEncoding encoding) {
-    uint32_t offset = 0;
-    switch (encoding) {
-    case InstEncoding::SOP1:
-        offset = (uint32_t)OpcodeMap::OP_MAP_SOP1;
-        break;
-    case InstEncoding::SOPP:
-        offset = (uint32_t)OpcodeMap::OP_MAP_SOPP;
-        break;
-    case InstEncoding::SOPC:
-        offset = (uint32_t)OpcodeMap::OP_MAP_SOPC;
-        break;
-    case InstEncoding::VOP1:
-        offset = (uint32_t)OpcodeMap::OP_MAP_VOP1;
-        break;
-    case InstEncoding::VOPC:
-        offset = (uint32_t)OpcodeMap::OP_MAP_VOPC;
-        break;
-    case InstEncoding::VOP3:
-        offset = (uint32_t)OpcodeMap::OP_MAP_VOP3;
-        break;
-    case InstEncoding::EXP:
-        offset = (uint32_t)OpcodeMap::OP_MAP_EXP;
-        break;
-    case InstEncoding::VINTRP:
-        offset = (uint32_t)OpcodeMap::OP_MAP_VINTRP;
-        break;
-    case InstEncoding::DS:
-        offset = (uint32_t)OpcodeMap::OP_MAP_DS;
-        break;
-    case InstEncoding::MUBUF:
-        offset = (uint32_t)OpcodeMap::OP_MAP_MUBUF;
-        break;
-    case InstEncoding::MTBUF:
-        offset = (uint32_t)OpcodeMap::OP_MAP_MTBUF;
-        break;
-    case InstEncoding::MIMG:
-        offset = (uint32_t)OpcodeMap::OP_MAP_MIMG;
-        break;
-    case InstEncoding::SMRD:
-        offset = (uint32_t)OpcodeMap::OP_MAP_SMRD;
-        break;
-    case InstEncoding::SOPK:
-        offset = (uint32_t)OpcodeMap::OP_MAP_SOPK;
-        break;
-    case InstEncoding::SOP2:
-        offset = (uint32_t)OpcodeMap::OP_MAP_SOP2;
-        break;
-    case InstEncoding::VOP2:
-        offset = (uint32_t)OpcodeMap::OP_MAP_VOP2;
-        break;
-    default:
-        break;
-    }
-    return offset;
-}
-
-uint32_t GcnDecodeContext::mapEncodingOp(InstEncoding encoding, Opcode opcode) {
-    // Map from uniform opcode to encoding specific opcode.
-    uint32_t encodingOp = 0;
-    if (encoding == InstEncoding::VOP3) {
-        if (opcode >= Opcode::V_CMP_F_F32 && opcode <= Opcode::V_CMPX_T_U64) {
-            uint32_t op =
-                static_cast<uint32_t>(opcode) - static_cast<uint32_t>(OpcodeMap::OP_MAP_VOPC);
-            encodingOp = op + static_cast<uint32_t>(OpMapVOP3VOPX::VOP3_TO_VOPC);
-        } else if (opcode >= Opcode::V_CNDMASK_B32 && opcode <= Opcode::V_CVT_PK_I16_I32) {
-            uint32_t op =
-                static_cast<uint32_t>(opcode) - static_cast<uint32_t>(OpcodeMap::OP_MAP_VOP2);
-            encodingOp = op + static_cast<uint32_t>(OpMapVOP3VOPX::VOP3_TO_VOP2);
-        } else if (opcode >= Opcode::V_NOP && opcode <= Opcode::V_MOVRELSD_B32) {
-            uint32_t op =
-                static_cast<uint32_t>(opcode) - static_cast<uint32_t>(OpcodeMap::OP_MAP_VOP1);
-            encodingOp = op + static_cast<uint32_t>(OpMapVOP3VOPX::VOP3_TO_VOP1);
-        } else {
-            encodingOp =
-                static_cast<uint32_t>(opcode) - static_cast<uint32_t>(OpcodeMap::OP_MAP_VOP3);
-        }
-    } else {
-        uint32_t mapOffset = getOpMapOffset(encoding);
-        encodingOp = static_cast<uint32_t>(opcode) - mapOffset;
-    }
-
-    return encodingOp;
-}
-
 void GcnDecodeContext::updateInstructionMeta(InstEncoding encoding) {
-    uint32_t encodingOp = mapEncodingOp(encoding, m_instruction.opcode);
-    InstFormat instFormat = InstructionFormat(encoding, encodingOp);
+    const InstFormat& instFormat = OpcodeFormat(encoding, m_instruction.opcode);
 
     ASSERT_MSG(instFormat.src_type != ScalarType::Undefined &&
                    instFormat.dst_type != ScalarType::Undefined,
@@ -403,8 +339,7 @@ void GcnDecodeContext::decodeInstruction64(InstEncoding encoding, GcnCodeSlice&
 
 void GcnDecodeContext::decodeLiteralConstant(InstEncoding encoding, GcnCodeSlice& code) {
     if (HasAdditionalLiteral(encoding, m_instruction.opcode)) {
-        u32 encoding_op = mapEncodingOp(encoding, m_instruction.opcode);
-        InstFormat instFormat = InstructionFormat(encoding, encoding_op);
+        const InstFormat& instFormat = OpcodeFormat(encoding, m_instruction.opcode);
         m_instruction.src[m_instruction.src_count].field = OperandField::LiteralConst;
         m_instruction.src[m_instruction.src_count].type = instFormat.src_type;
         m_instruction.src[m_instruction.src_count].code = code.readu32();
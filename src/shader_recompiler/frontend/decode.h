@@ -22,6 +22,9 @@ u32 GetEncodingLength(InstEncoding encoding);
 
 InstFormat InstructionFormat(InstEncoding encoding, u32 opcode);
 
+/// Returns the format of an instruction from its unified opcode, a single table read.
+const InstFormat& OpcodeFormat(InstEncoding encoding, Opcode opcode);
+
 Opcode DecodeOpcode(u32 token);
 
 class GcnCodeSlice {
@@ -59,8 +62,6 @@ public:
 
 private:
     uint32_t getEncodingLength(InstEncoding encoding);
-    uint32_t getOpMapOffset(InstEncoding encoding);
-    uint32_t mapEncodingOp(InstEncoding encoding, Opcode opcode);
     void updateInstructionMeta(InstEncoding encoding);
     uint32_t getMimgModifier(Opcode opcode);
     void repairOperandType();
@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <limits>
+
 #include "common/assert.h"
 #include "shader_recompiler/frontend/decode.h"
 
@@ -3725,4 +3728,87 @@ InstFormat InstructionFormat(InstEncoding encoding, uint32_t opcode) {
     return {};
 }
 
+namespace {
+
+constexpr u32 NumOpcodes =
+    static_cast<u32>(OpcodeMap::OP_MAP_EXP) + static_cast<u32>(OpcodeEXP::OP_RANGE_EXP);
+constexpr u32 Vop3OpcodeBase = static_cast<u32>(OpcodeMap::OP_MAP_VOPC);
+constexpr u32 Vop3OpcodeEnd = static_cast<u32>(OpcodeMap::OP_MAP_VINTRP);
+
+template <size_t N>
+constexpr void FillFormats(std::array<InstFormat, NumOpcodes>& formats, OpcodeMap base, auto range,
+                           const std::array<InstFormat, N>& encoding_formats) {
+    const u32 count = std::min<u32>(N, static_cast<u32>(range));
+    for (u32 op = 0; op < count; op++) {
+        formats[static_cast<u32>(base) + op] = encoding_formats[op];
+    }
+}
+
+/// Formats of all instructions in their native encoding, indexed by the unified opcode.
+constexpr auto OpcodeFormats = [] {
+    std::array<InstFormat, NumOpcodes> formats{};
+    FillFormats(formats, OpcodeMap::OP_MAP_SOP2, OpcodeSOP2::OP_RANGE_SOP2, InstructionFormatSOP2);
+    FillFormats(formats, OpcodeMap::OP_MAP_SOPK, OpcodeSOPK::OP_RANGE_SOPK, InstructionFormatSOPK);
+    FillFormats(formats, OpcodeMap::OP_MAP_SOP1, OpcodeSOP1::OP_RANGE_SOP1, InstructionFormatSOP1);
+    FillFormats(formats, OpcodeMap::OP_MAP_SOPC, OpcodeSOPC::OP_RANGE_SOPC, InstructionFormatSOPC);
+    FillFormats(formats, OpcodeMap::OP_MAP_SOPP, OpcodeSOPP::OP_RANGE_SOPP, InstructionFormatSOPP);
+    FillFormats(formats, OpcodeMap::OP_MAP_VOPC, OpcodeVOPC::OP_RANGE_VOPC, InstructionFormatVOPC);
+    FillFormats(formats, OpcodeMap::OP_MAP_VOP2, OpcodeVOP2::OP_RANGE_VOP2, InstructionFormatVOP2);
+    FillFormats(formats, OpcodeMap::OP_MAP_VOP1, OpcodeVOP1::OP_RANGE_VOP1, InstructionFormatVOP1);
+    FillFormats(formats, OpcodeMap::OP_MAP_VINTRP, OpcodeVINTRP::OP_RANGE_VINTRP,
+                InstructionFormatVINTRP);
+    FillFormats(formats, OpcodeMap::OP_MAP_SMRD, OpcodeSMRD::OP_RANGE_SMRD, InstructionFormatSMRD);
+    FillFormats(formats, OpcodeMap::OP_MAP_DS, OpcodeDS::OP_RANGE_DS, InstructionFormatDS);
+    FillFormats(formats, OpcodeMap::OP_MAP_MUBUF, OpcodeMUBUF::OP_RANGE_MUBUF,
+                InstructionFormatMUBUF);
+    FillFormats(formats, OpcodeMap::OP_MAP_MTBUF, OpcodeMTBUF::OP_RANGE_MTBUF,
+                InstructionFormatMTBUF);
+    FillFormats(formats, OpcodeMap::OP_MAP_MIMG, OpcodeMIMG::OP_RANGE_MIMG, InstructionFormatMIMG);
+    FillFormats(formats, OpcodeMap::OP_MAP_EXP, OpcodeEXP::OP_RANGE_EXP, InstructionFormatEXP);
+    return formats;
+}();
+
+/// Maps a unified vector ALU opcode to its opcode in the VOP3 encoding.
+constexpr u32 Vop3EncodingOpcode(u32 opcode) {
+    const auto offset = [opcode](auto base) { return opcode - static_cast<u32>(base); };
+    if (opcode >= static_cast<u32>(Opcode::V_CMP_F_F32) &&
+        opcode <= static_cast<u32>(Opcode::V_CMPX_T_U64)) {
+        return offset(OpcodeMap::OP_MAP_VOPC) + static_cast<u32>(OpMapVOP3VOPX::VOP3_TO_VOPC);
+    }
+    if (opcode >= static_cast<u32>(Opcode::V_CNDMASK_B32) &&
+        opcode <= static_cast<u32>(Opcode::V_CVT_PK_I16_I32)) {
+        return offset(OpcodeMap::OP_MAP_VOP2) + static_cast<u32>(OpMapVOP3VOPX::VOP3_TO_VOP2);
+    }
+    if (opcode >= static_cast<u32>(Opcode::V_NOP) &&
+        opcode <= static_cast<u32>(Opcode::V_MOVRELSD_B32)) {
+        return offset(OpcodeMap::OP_MAP_VOP1) + static_cast<u32>(OpMapVOP3VOPX::VOP3_TO_VOP1);
+    }
+    if (opcode >= static_cast<u32>(OpcodeMap::OP_MAP_VOP3)) {
+        return offset(OpcodeMap::OP_MAP_VOP3);
+    }
+    return std::numeric_limits<u32>::max();
+}
+
+/// Formats of vector ALU instructions in the VOP3 encoding, indexed by the unified opcode.
+constexpr auto Vop3Formats = [] {
+    std::array<InstFormat, Vop3OpcodeEnd - Vop3OpcodeBase> formats{};
+    for (u32 opcode = Vop3OpcodeBase; opcode < Vop3OpcodeEnd; opcode++) {
+        const u32 encoding_op = Vop3EncodingOpcode(opcode);
+        if (encoding_op < InstructionFormatVOP3.size()) {
+            formats[opcode - Vop3OpcodeBase] = InstructionFormatVOP3[encoding_op];
+        }
+    }
+    return formats;
+}();
+
+} // Anonymous namespace
+
+const InstFormat& OpcodeFormat(InstEncoding encoding, Opcode opcode) {
+    const u32 op = static_cast<u32>(opcode);
+    if (encoding == InstEncoding::VOP3) {
+        return Vop3Formats[op - Vop3OpcodeBase];
+    }
+    return OpcodeFormats[op];
+}
+
 } // namespace Shader::Gcn
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <memory_resource>
 #include "shader_recompiler/frontend/control_flow_graph.h"
 #include "shader_recompiler/ir/abstract_syntax_list.h"
 #include "shader_recompiler/ir/basic_block.h"
@@ -17,7 +18,8 @@ struct RuntimeInfo;
 namespace Shader::Gcn {
 
 [[nodiscard]] IR::AbstractSyntaxList BuildASL(Common::ObjectPool<IR::Inst>& inst_pool,
-                                              Common::ObjectPool<IR::Block>& block_pool, CFG& cfg,
+                                              Common::ObjectPool<IR::Block>& block_pool,
+                                              std::pmr::memory_resource* arena, CFG& cfg,
                                               Info& info, const RuntimeInfo& runtime_info,
                                               const Profile& profile);
 
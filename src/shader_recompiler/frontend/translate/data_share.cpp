@@ -3,6 +3,7 @@
 
 #include "shader_recompiler/frontend/translate/translate.h"
 #include "shader_recompiler/ir/reg.h"
+#include "shader_recompiler/profile.h"
 #include "shader_recompiler/runtime_info.h"
 
 namespace Shader::Gcn {
@@ -277,8 +278,20 @@ void Translator::DS_SWIZZLE_B32(const GcnInst& inst) {
     const u8 offset0 = inst.control.ds.offset0;
     const u8 offset1 = inst.control.ds.offset1;
     const IR::U32 src{GetSrc(inst.src[0])};
-    // ASSERT(offset1 & 0x80);
     const IR::U32 lane_id = ir.LaneId();
+    if (!(offset1 & 0x80) && profile.supports_subgroup_shuffle) {
+        // Bit mask mode, lanes are permuted within groups of 32 so the result is the same when
+        // the host runs the wave as two 32 wide subgroups.
+        const u32 offset = (u32(offset1) << 8) | offset0;
+        const u32 and_mask = offset & 0x1f;
+        const u32 or_mask = (offset >> 5) & 0x1f;
+        const u32 xor_mask = (offset >> 10) & 0x1f;
+        const IR::U32 group_base = ir.BitwiseAnd(lane_id, ir.Imm32(~0x1fU));
+        IR::U32 index = ir.BitwiseAnd(lane_id, ir.Imm32(and_mask));
+        index = ir.BitwiseXor(ir.BitwiseOr(index, ir.Imm32(or_mask)), ir.Imm32(xor_mask));
+        SetDst(inst.dst[0], ir.Shuffle(src, ir.BitwiseOr(group_base, index)));
+        return;
+    }
     const IR::U32 id_in_group = ir.BitwiseAnd(lane_id, ir.Imm32(0b11));
     const IR::U32 base = ir.ShiftLeftLogical(id_in_group, ir.Imm32(1));
     const IR::U32 index = ir.BitFieldExtract(ir.Imm32(offset0), base, ir.Imm32(2));
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <span>
 #include <vector>
 #include <boost/container/static_vector.hpp>
@@ -104,6 +105,9 @@ struct Info {
     LogicalStage l_stage;
 
     u64 pgm_hash{};
+    /// Hash of the shape of the optimized IR, which unlike pgm_hash does not change with
+    /// register allocation or scheduling of an otherwise identical shader.
+    u64 ir_fingerprint{};
     VAddr pgm_base;
     bool has_storage_images{};
     bool has_discard{};
@@ -115,7 +119,10 @@ struct Info {
     bool uses_lane_id{};
     bool uses_group_quad{};
     bool uses_group_ballot{};
+    bool uses_group_shuffle{};
     IR::Type shared_types{};
+    /// Size of the part of shared memory that is backed by host shared memory.
+    u32 shared_memory_size{};
     bool uses_fp16{};
     bool uses_fp64{};
     bool uses_pack_10_11_11{};
@@ -127,6 +134,10 @@ struct Info {
     bool translation_failed{};
     u8 mrt_mask{0u};
     bool has_fetch_shader{false};
+    /// Number of block execution counters written to the profiling buffer.
+    u32 num_block_counters{};
+    /// Region of the renderer's profiling buffer reserved for this shader.
+    u32 profiling_slot{~0U};
     u32 fetch_shader_sgpr_base{0u};
 
     enum class ReadConstType {
@@ -136,6 +147,7 @@ struct Info {
     };
     ReadConstType readconst_types{};
     bool uses_dma{};
+    bool uses_texture_heap{};
 
     explicit Info(Stage stage_, LogicalStage l_stage_, ShaderParams params)
         : stage{stage_}, l_stage{l_stage_}, pgm_hash{params.hash}, pgm_base{params.Base()},
@@ -158,6 +170,11 @@ struct Info {
         return data;
     }
 
+    /// Returns true when the image is sampled from the texture heap instead of its own binding.
+    bool IsTextureHeapImage(const ImageResource& image) const noexcept {
+        return uses_texture_heap && !image.is_written;
+    }
+
     void PushUd(Backend::Bindings& bnd, PushData& push) const {
         u32 mask = ud_mask.mask;
         while (mask) {
@@ -170,7 +187,10 @@ struct Info {
 
     void AddBindings(Backend::Bindings& bnd) const {
         bnd.buffer += buffers.size();
-        bnd.unified += buffers.size() + images.size() + samplers.size();
+        // Images sampled from the texture heap do not take a binding of their own.
+        const auto num_images = std::ranges::count_if(
+            images, [this](const auto& image) { return !IsTextureHeapImage(image); });
+        bnd.unified += buffers.size() + num_images + samplers.size();
         bnd.user_data += ud_mask.NumRegs();
     }
 
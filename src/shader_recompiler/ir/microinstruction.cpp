@@ -132,6 +132,26 @@ bool Inst::MayHaveSideEffects() const noexcept {
     }
 }
 
+bool Inst::IsPure() const noexcept {
+    // Everything from the composite instructions up to the conversions is plain arithmetic
+    // without side effects or memory accesses.
+    if (op >= Opcode::CompositeConstructU32x2 && op <= Opcode::ConvertS32S16) {
+        return true;
+    }
+    switch (op) {
+    case Opcode::ReadConst:
+    case Opcode::GetUserData:
+    case Opcode::GetAttribute:
+    case Opcode::GetAttributeU32:
+    case Opcode::CubeFaceIndex:
+    case Opcode::LaneId:
+    case Opcode::WarpId:
+        return true;
+    default:
+        return false;
+    }
+}
+
 bool Inst::AreAllArgsImmediates() const {
     if (op == Opcode::Phi) {
         UNREACHABLE_MSG("Testing for all arguments are immediates on phi instruction");
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <memory_resource>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <boost/container/small_vector.hpp>
+#include "common/hash.h"
+#include "shader_recompiler/ir/ir_emitter.h"
+#include "shader_recompiler/ir/program.h"
+
+namespace Shader::Optimization {
+
+// Merges dword loads from consecutive addresses of the same buffer into a single vector load.
+// Vertex fetch and constant reads are usually split by games into one BUFFER_LOAD_DWORD per
+// component, which otherwise results in repeated address and bounds check code per component.
+
+namespace {
+
+constexpr size_t MaxComponents = 4;
+
+struct LoadKey {
+    IR::Opcode op;
+    u32 handle;
+    u32 flags;
+    IR::Value base;
+    u32 epoch;
+
+    bool operator==(const LoadKey&) const = default;
+};
+
+struct HashLoadKey {
+    size_t operator()(const LoadKey& key) const {
+        u64 h = HashCombine(static_cast<u64>(key.op), static_cast<u64>(key.handle));
+        h = HashCombine(static_cast<u64>(key.flags), h);
+        h = HashCombine(static_cast<u64>(std::hash<IR::Value>{}(key.base)), h);
+        return HashCombine(static_cast<u64>(key.epoch), h);
+    }
+};
+
+struct Load {
+    IR::Inst* inst;
+    u32 offset;
+    u32 order;
+};
+
+bool IsDwordLoad(const IR::Inst& inst) {
+    return inst.GetOpcode() == IR::Opcode::LoadBufferU32 ||
+           inst.GetOpcode() == IR::Opcode::LoadBufferF32;
+}
+
+/// Splits a dword address into a base value and a constant dword offset.
+std::pair<IR::Value, u32> SplitAddress(const IR::Value& address) {
+    const IR::Value resolved = address.Resolve();
+    if (resolved.IsImmediate()) {
+        return {IR::Value{}, resolved.U32()};
+    }
+    IR::Inst* const inst = resolved.InstRecursive();
+    if (inst->GetOpcode() == IR::Opcode::IAdd32) {
+        const IR::Value lhs = inst->Arg(0).Resolve();
+        const IR::Value rhs = inst->Arg(1).Resolve();
+        if (rhs.IsImmediate() && !lhs.IsImmediate()) {
+            return {lhs, rhs.U32()};
+        }
+        if (lhs.IsImmediate() && !rhs.IsImmediate()) {
+            return {rhs, lhs.U32()};
+        }
+    }
+    return {resolved, 0};
+}
+
+void MergeLoads(IR::Block& block, std::span<const Load> loads) {
+    const Load& first = *std::ranges::min_element(loads, {}, &Load::order);
+    const Load& lowest = loads.front();
+    IR::Inst* const base_inst = lowest.inst;
+    IR::IREmitter ir{block, IR::Block::InstructionList::s_iterator_to(*first.inst)};
+
+    IR::Value address = base_inst->Arg(1);
+    if (first.inst != lowest.inst) {
+        // The address of the lowest load may be computed after the first load in the block.
+        const auto [base, offset] = SplitAddress(address);
+        if (base.IsEmpty()) {
+            address = ir.Imm32(offset);
+        } else {
+            address = offset == 0 ? base : ir.IAdd(IR::U32{base}, ir.Imm32(offset));
+        }
+    }
+    const auto flags = base_inst->Flags<IR::BufferInstInfo>();
+    const IR::Value handle = base_inst->Arg(0);
+    const int num_dwords = static_cast<int>(loads.size());
+    const IR::Value merged = base_inst->GetOpcode() == IR::Opcode::LoadBufferF32
+                                 ? ir.LoadBufferF32(num_dwords, handle, address, flags)
+                                 : ir.LoadBufferU32(num_dwords, handle, address, flags);
+    for (size_t i = 0; i < loads.size(); ++i) {
+        loads[i].inst->ReplaceUsesWithAndRemove(ir.CompositeExtract(merged, i));
+    }
+}
+
+void CoalesceBlock(IR::Block& block, std::pmr::memory_resource* arena) {
+    std::pmr::unordered_map<LoadKey, boost::container::small_vector<Load, 4>, HashLoadKey> groups{
+        arena};
+    u32 epoch = 0;
+    u32 order = 0;
+    for (IR::Inst& inst : block.Instructions()) {
+        ++order;
+        if (inst.MayHaveSideEffects()) {
+            // Loads are never merged across anything that may write memory.
+            ++epoch;
+            continue;
+        }
+        if (!IsDwordLoad(inst) || !inst.Arg(0).IsImmediate()) {
+            continue;
+        }
+        auto flags = inst.Flags<IR::BufferInstInfo>();
+        if (flags.typed) {
+            // Typed loads have a single bounds check for all components.
+            continue;
+        }
+        flags.inst_offset.Assign(0);
+        const auto [base, offset] = SplitAddress(inst.Arg(1));
+        const LoadKey key{inst.GetOpcode(), inst.Arg(0).U32(), flags.raw, base, epoch};
+        groups[key].push_back({&inst, offset, order});
+    }
+
+    for (auto& [key, loads] : groups) {
+        if (loads.size() < 2) {
+            continue;
+        }
+        std::ranges::sort(loads, {}, &Load::offset);
+        size_t start = 0;
+        while (start < loads.size()) {
+            size_t end = start + 1;
+            while (end < loads.size() && end - start < MaxComponents &&
+                   loads[end].offset == loads[end - 1].offset + 1) {
+                ++end;
+            }
+            if (end - start >= 2) {
+                MergeLoads(block, std::span<const Load>{loads.data() + start, end - start});
+            }
+            start = end;
+        }
+    }
+}
+
+} // Anonymous namespace
+
+void BufferLoadCoalescingPass(IR::Program& program) {
+    for (IR::Block* const block : program.blocks) {
+        CoalesceBlock(*block, program.arena);
+    }
+}
+
+} // namespace Shader::Optimization
@@ -114,14 +114,17 @@ struct PassInfo {
     // map offset to inst
     using PtrUserList = boost::container::flat_map<u32, Shader::IR::Inst*>;
 
+    explicit PassInfo(std::pmr::memory_resource* arena)
+        : gvn_table{arena}, pointer_uses{arena}, vn_to_inst{arena} {}
+
     Optimization::SrtGvnTable gvn_table;
     // keys are GetUserData or ReadConst instructions that are used as pointers
-    std::unordered_map<IR::Inst*, PtrUserList> pointer_uses;
+    std::pmr::unordered_map<IR::Inst*, PtrUserList> pointer_uses;
     // GetUserData instructions corresponding to sgpr_base of SRT roots
     boost::container::small_flat_map<IR::ScalarReg, IR::Inst*, 1> srt_roots;
 
     // pick a single inst for a given value number
-    std::unordered_map<u32, IR::Inst*> vn_to_inst;
+    std::pmr::unordered_map<u32, IR::Inst*> vn_to_inst;
 
     // Bumped during codegen to assign offsets to readconsts
     u32 dst_off_dw;
@@ -227,7 +230,7 @@ static void GenerateSrtProgram(Info& info, PassInfo& pass_info) {
 
 void FlattenExtendedUserdataPass(IR::Program& program) {
     Shader::Info& info = program.info;
-    PassInfo pass_info;
+    PassInfo pass_info{program.arena};
 
     // traverse at end and assign offsets to duplicate readconsts, using
     // vn_to_inst as the source
@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory_resource>
+#include <unordered_map>
+#include <utility>
+#include <boost/container/small_vector.hpp>
+#include "common/hash.h"
+#include "shader_recompiler/ir/program.h"
+
+namespace Shader::Optimization {
+
+// Dominator based global value numbering. Pure instructions that compute the same operation on
+// the same operands are replaced by the first of them that dominates the others, which mostly
+// removes the address math games repeat before every buffer access.
+
+namespace {
+
+bool IsCommutative(IR::Opcode op) {
+    switch (op) {
+    case IR::Opcode::FPAdd32:
+    case IR::Opcode::FPAdd64:
+    case IR::Opcode::FPMul32:
+    case IR::Opcode::FPMul64:
+    case IR::Opcode::IAdd32:
+    case IR::Opcode::IAdd64:
+    case IR::Opcode::IMul32:
+    case IR::Opcode::IMul64:
+    case IR::Opcode::BitwiseAnd32:
+    case IR::Opcode::BitwiseAnd64:
+    case IR::Opcode::BitwiseOr32:
+    case IR::Opcode::BitwiseOr64:
+    case IR::Opcode::BitwiseXor32:
+    case IR::Opcode::SMin32:
+    case IR::Opcode::UMin32:
+    case IR::Opcode::SMax32:
+    case IR::Opcode::UMax32:
+    case IR::Opcode::IEqual32:
+    case IR::Opcode::IEqual64:
+    case IR::Opcode::INotEqual32:
+    case IR::Opcode::INotEqual64:
+    case IR::Opcode::LogicalOr:
+    case IR::Opcode::LogicalAnd:
+    case IR::Opcode::LogicalXor:
+        return true;
+    default:
+        return false;
+    }
+}
+
+struct InstKey {
+    IR::Opcode op;
+    u32 flags;
+    boost::container::small_vector<IR::Value, 4> args;
+
+    bool operator==(const InstKey&) const = default;
+};
+
+struct HashInstKey {
+    size_t operator()(const InstKey& key) const {
+        u64 h = HashCombine(static_cast<u64>(key.op), static_cast<u64>(key.flags));
+        for (const IR::Value& arg : key.args) {
+            h = HashCombine(static_cast<u64>(std::hash<IR::Value>{}(arg)), h);
+        }
+        return h;
+    }
+};
+
+InstKey MakeKey(const IR::Inst& inst) {
+    InstKey key{inst.GetOpcode(), inst.Flags<u32>(), {}};
+    const size_t num_args = inst.NumArgs();
+    for (size_t i = 0; i < num_args; ++i) {
+        key.args.push_back(inst.Arg(i).Resolve());
+    }
+    if (IsCommutative(key.op)) {
+        // Immediates go last and instructions are sorted by address, so both operand orders
+        // produce the same key.
+        IR::Value& lhs = key.args[0];
+        IR::Value& rhs = key.args[1];
+        const bool swap = lhs.IsImmediate() != rhs.IsImmediate()
+                              ? lhs.IsImmediate()
+                              : !lhs.IsImmediate() && lhs.Inst() > rhs.Inst();
+        if (swap) {
+            std::swap(lhs, rhs);
+        }
+    }
+    return key;
+}
+
+class DominatorTree {
+public:
+    explicit DominatorTree(const IR::BlockList& post_order, std::pmr::memory_resource* arena)
+        : order(arena), idom(post_order.size(), Undefined, arena) {
+        for (u32 i = 0; i < post_order.size(); ++i) {
+            order.emplace(post_order[i], i);
+        }
+        // Cooper, Harvey and Kennedy, "A Simple, Fast Dominance Algorithm".
+        const u32 entry = static_cast<u32>(post_order.size() - 1);
+        idom[entry] = entry;
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (u32 index = entry; index-- > 0;) {
+                u32 new_idom = Undefined;
+                for (const IR::Block* pred : post_order[index]->ImmPredecessors()) {
+                    const auto it = order.find(pred);
+                    if (it == order.end() || idom[it->second] == Undefined) {
+                        continue;
+                    }
+                    new_idom = new_idom == Undefined ? it->second : Intersect(it->second, new_idom);
+                }
+                if (idom[index] != new_idom) {
+                    idom[index] = new_idom;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    bool Dominates(const IR::Block* dominator, const IR::Block* block) const {
+        const u32 target = order.at(dominator);
+        u32 index = order.at(block);
+        while (index != target) {
+            const u32 parent = idom[index];
+            if (parent == index || parent == Undefined) {
+                return false;
+            }
+            index = parent;
+        }
+        return true;
+    }
+
+private:
+    static constexpr u32 Undefined = ~0U;
+
+    u32 Intersect(u32 lhs, u32 rhs) const {
+        while (lhs != rhs) {
+            while (lhs < rhs) {
+                lhs = idom[lhs];
+            }
+            while (rhs < lhs) {
+                rhs = idom[rhs];
+            }
+        }
+        return lhs;
+    }
+
+    std::pmr::unordered_map<const IR::Block*, u32> order;
+    std::pmr::vector<u32> idom;
+};
+
+} // Anonymous namespace
+
+void GlobalValueNumberingPass(IR::Program& program) {
+    const IR::BlockList& post_order = program.post_order_blocks;
+    if (post_order.empty()) {
+        return;
+    }
+    const DominatorTree dom_tree{post_order, program.arena};
+
+    // Candidates for every key, in the order they were visited. Visiting blocks in reverse post
+    // order guarantees that a dominating definition is always seen before its dominated copies.
+    std::pmr::unordered_map<InstKey, boost::container::small_vector<IR::Inst*, 2>, HashInstKey>
+        values{program.arena};
+    for (auto block_it = post_order.rbegin(); block_it != post_order.rend(); ++block_it) {
+        IR::Block* const block = *block_it;
+        for (IR::Inst& inst : block->Instructions()) {
+            if (!inst.IsPure()) {
+                continue;
+            }
+            auto& candidates = values[MakeKey(inst)];
+            IR::Inst* leader = nullptr;
+            for (IR::Inst* const candidate : candidates) {
+                if (dom_tree.Dominates(candidate->GetParent(), block)) {
+                    leader = candidate;
+                    break;
+                }
+            }
+            if (leader) {
+                // Leaves an identity behind, removed by the identity removal pass.
+                inst.ReplaceUsesWith(IR::Value{leader});
+            } else {
+                candidates.push_back(&inst);
+            }
+        }
+    }
+}
+
+} // namespace Shader::Optimization
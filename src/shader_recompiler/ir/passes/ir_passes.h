@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <memory_resource>
 #include "shader_recompiler/ir/basic_block.h"
 #include "shader_recompiler/ir/program.h"
 
@@ -12,16 +13,21 @@ struct Profile;
 
 namespace Shader::Optimization {
 
-void SsaRewritePass(IR::BlockList& program);
+void SsaRewritePass(IR::BlockList& program, std::pmr::memory_resource* arena);
 void IdentityRemovalPass(IR::BlockList& program);
 void DeadCodeEliminationPass(IR::Program& program);
 void ConstantPropagationPass(IR::BlockList& program);
+void GlobalValueNumberingPass(IR::Program& program);
+void LoopInvariantCodeMotionPass(IR::Program& program);
 void FlattenExtendedUserdataPass(IR::Program& program);
 void ReadLaneEliminationPass(IR::Program& program);
 void ResourceTrackingPass(IR::Program& program);
 void CollectShaderInfoPass(IR::Program& program, const Profile& profile);
 void LowerBufferFormatToRaw(IR::Program& program);
+void BufferLoadCoalescingPass(IR::Program& program);
 void LowerFp64ToFp32(IR::Program& program);
+void LowerFp64ToFloat2(IR::Program& program);
+void ShaderProfilingPass(IR::Program& program);
 void RingAccessElimination(const IR::Program& program, const RuntimeInfo& runtime_info);
 void TessellationPreprocess(IR::Program& program, RuntimeInfo& runtime_info);
 void HullShaderTransform(IR::Program& program, RuntimeInfo& runtime_info);
@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <memory_resource>
+#include <unordered_set>
+#include <vector>
+#include "common/assert.h"
+#include "shader_recompiler/info.h"
+#include "shader_recompiler/ir/program.h"
+
+namespace Shader::Optimization {
+
+// Hoists loop invariant instructions out of structured loops into the block that enters them.
+// Most of what this catches is uniform math derived from scalar registers that GCN code keeps
+// inside the loop body, plus loads from buffers the shader never writes.
+
+namespace {
+
+struct Loop {
+    explicit Loop(IR::Block* header_, std::pmr::memory_resource* arena)
+        : header{header_}, blocks{arena}, members{arena}, always_executed{arena} {}
+
+    IR::Block* header;
+    std::pmr::vector<IR::Block*> blocks;
+    std::pmr::unordered_set<const IR::Block*> members;
+    /// Blocks that run on every iteration, loads are only hoisted from these.
+    std::pmr::unordered_set<const IR::Block*> always_executed;
+    u32 depth{};
+    bool has_exit{};
+    bool writes_memory{};
+};
+
+bool IsBufferLoad(const IR::Inst& inst) {
+    switch (inst.GetOpcode()) {
+    case IR::Opcode::LoadBufferU8:
+    case IR::Opcode::LoadBufferU16:
+    case IR::Opcode::LoadBufferU32:
+    case IR::Opcode::LoadBufferU32x2:
+    case IR::Opcode::LoadBufferU32x3:
+    case IR::Opcode::LoadBufferU32x4:
+    case IR::Opcode::LoadBufferU64:
+    case IR::Opcode::LoadBufferF32:
+    case IR::Opcode::LoadBufferF32x2:
+    case IR::Opcode::LoadBufferF32x3:
+    case IR::Opcode::LoadBufferF32x4:
+    case IR::Opcode::LoadBufferFormatF32:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool WritesMemory(const IR::Inst& inst) {
+    if (!inst.MayHaveSideEffects()) {
+        return false;
+    }
+    switch (inst.GetOpcode()) {
+    case IR::Opcode::ConditionRef:
+    case IR::Opcode::Reference:
+    case IR::Opcode::PhiMove:
+    case IR::Opcode::Prologue:
+    case IR::Opcode::Epilogue:
+    case IR::Opcode::Discard:
+    case IR::Opcode::DiscardCond:
+    case IR::Opcode::SetAttribute:
+    case IR::Opcode::SetPatch:
+    case IR::Opcode::DebugPrint:
+    case IR::Opcode::EmitVertex:
+    case IR::Opcode::EmitPrimitive:
+        return false;
+    default:
+        // Stores, atomics and barriers, after which loads may observe other values.
+        return true;
+    }
+}
+
+std::pmr::vector<Loop> CollectLoops(const IR::AbstractSyntaxList& syntax_list,
+                                    std::pmr::memory_resource* arena) {
+    // Loops are returned innermost first, so code hoisted out of an inner loop is considered
+    // again by the loop that contains it.
+    std::pmr::vector<Loop> loops{arena};
+    std::pmr::vector<Loop> open_loops{arena};
+    for (size_t index = 0; index < syntax_list.size(); ++index) {
+        const IR::AbstractSyntaxNode& node = syntax_list[index];
+        switch (node.type) {
+        case IR::AbstractSyntaxNode::Type::Block:
+            for (Loop& loop : open_loops) {
+                loop.blocks.push_back(node.data.block);
+                loop.members.insert(node.data.block);
+                if (loop.depth == 0 && !loop.has_exit) {
+                    loop.always_executed.insert(node.data.block);
+                }
+            }
+            break;
+        case IR::AbstractSyntaxNode::Type::If:
+            for (Loop& loop : open_loops) {
+                ++loop.depth;
+            }
+            break;
+        case IR::AbstractSyntaxNode::Type::EndIf:
+            for (Loop& loop : open_loops) {
+                --loop.depth;
+            }
+            break;
+        case IR::AbstractSyntaxNode::Type::Loop: {
+            for (Loop& loop : open_loops) {
+                ++loop.depth;
+            }
+            // The header is always emitted right before its loop node.
+            IR::Block* const header = syntax_list[index - 1].data.block;
+            Loop& loop = open_loops.emplace_back(header, arena);
+            loop.blocks.push_back(header);
+            loop.members.insert(header);
+            loop.always_executed.insert(header);
+            break;
+        }
+        case IR::AbstractSyntaxNode::Type::Repeat:
+            ASSERT(!open_loops.empty() && open_loops.back().header == node.data.repeat.loop_header);
+            loops.push_back(std::move(open_loops.back()));
+            open_loops.pop_back();
+            for (Loop& loop : open_loops) {
+                --loop.depth;
+            }
+            break;
+        case IR::AbstractSyntaxNode::Type::Break:
+        case IR::AbstractSyntaxNode::Type::Return:
+        case IR::AbstractSyntaxNode::Type::Unreachable:
+            for (Loop& loop : open_loops) {
+                loop.has_exit = true;
+            }
+            break;
+        }
+    }
+    return loops;
+}
+
+IR::Block* FindPreheader(const Loop& loop) {
+    // Structured loops are entered from a single block that only branches to the header.
+    IR::Block* preheader = nullptr;
+    for (IR::Block* const pred : loop.header->ImmPredecessors()) {
+        if (loop.members.contains(pred)) {
+            continue;
+        }
+        if (preheader || pred->ImmSuccessors().size() != 1) {
+            return nullptr;
+        }
+        preheader = pred;
+    }
+    return preheader;
+}
+
+bool IsInvariant(const IR::Inst& inst, const Loop& loop) {
+    const size_t num_args = inst.NumArgs();
+    for (size_t i = 0; i < num_args; ++i) {
+        const IR::Value arg = inst.Arg(i).Resolve();
+        if (!arg.IsImmediate() && loop.members.contains(arg.InstRecursive()->GetParent())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CanHoist(const IR::Inst& inst, const IR::Block* block, const Loop& loop, const Info& info) {
+    if (inst.IsPure()) {
+        return true;
+    }
+    if (!IsBufferLoad(inst) || loop.writes_memory || !loop.always_executed.contains(block)) {
+        return false;
+    }
+    // Resource tracking has replaced the handle with the binding, a buffer that is never written
+    // by this shader always returns the same data.
+    const IR::Value handle = inst.Arg(0);
+    return handle.IsImmediate() && !info.buffers[handle.U32()].is_written;
+}
+
+void HoistLoop(Loop& loop, const Info& info) {
+    IR::Block* const preheader = FindPreheader(loop);
+    if (!preheader) {
+        return;
+    }
+    for (const IR::Block* const block : loop.blocks) {
+        for (const IR::Inst& inst : block->Instructions()) {
+            loop.writes_memory |= WritesMemory(inst);
+        }
+    }
+    // Blocks are in program order, so the definitions of an instruction's arguments were already
+    // visited and possibly hoisted when the instruction itself is reached.
+    for (IR::Block* const block : loop.blocks) {
+        auto& instructions = block->Instructions();
+        for (auto it = instructions.begin(); it != instructions.end();) {
+            IR::Inst& inst = *it;
+            if (!CanHoist(inst, block, loop, info) || !IsInvariant(inst, loop)) {
+                ++it;
+                continue;
+            }
+            it = instructions.erase(it);
+            preheader->Instructions().push_back(inst);
+            inst.SetParent(preheader);
+        }
+    }
+}
+
+} // Anonymous namespace
+
+void LoopInvariantCodeMotionPass(IR::Program& program) {
+    auto loops = CollectLoops(program.syntax_list, program.arena);
+    for (Loop& loop : loops) {
+        HoistLoop(loop, program.info);
+    }
+}
+
+} // namespace Shader::Optimization
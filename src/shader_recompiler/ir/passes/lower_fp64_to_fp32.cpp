@@ -157,4 +157,397 @@ void LowerFp64ToFp32(IR::Program& program) {
     }
 }
 
+
+// Emulated doubles are stored as the unevaluated sum of two floats, hi + lo with |lo| at most
+// half an ulp of hi. This gives about 48 bits of precision, using the algorithms from
+// Dekker, "A floating-point technique for extending the available precision" and
+// Joldes, Muller and Popescu, "Tight and rigorous error bounds for basic building blocks of
+// double-word arithmetic". Floating point arithmetic is emitted without contraction, which the
+// error free transformations below rely on.
+
+namespace {
+
+struct Float2 {
+    IR::F32 hi;
+    IR::F32 lo;
+};
+
+class Float2Emitter {
+public:
+    explicit Float2Emitter(IR::IREmitter& ir_) : ir{ir_} {}
+
+    Float2 Get(const IR::Value& value) {
+        const IR::Value resolved = value.Resolve();
+        if (resolved.IsImmediate()) {
+            const f64 imm = resolved.F64();
+            const f32 hi = static_cast<f32>(imm);
+            return {ir.Imm32(hi), ir.Imm32(static_cast<f32>(imm - static_cast<f64>(hi)))};
+        }
+        return {IR::F32{ir.CompositeExtract(resolved, 0)},
+                IR::F32{ir.CompositeExtract(resolved, 1)}};
+    }
+
+    IR::Value Make(const Float2& value) {
+        return ir.CompositeConstruct(value.hi, value.lo);
+    }
+
+    Float2 FromFloat(const IR::F32& value) {
+        return {value, ir.Imm32(0.f)};
+    }
+
+    Float2 QuickTwoSum(const IR::F32& a, const IR::F32& b) {
+        const IR::F32 sum{ir.FPAdd(a, b)};
+        return {sum, IR::F32{ir.FPSub(b, ir.FPSub(sum, a))}};
+    }
+
+    Float2 TwoSum(const IR::F32& a, const IR::F32& b) {
+        const IR::F32 sum{ir.FPAdd(a, b)};
+        const IR::F32 b_virtual{ir.FPSub(sum, a)};
+        const IR::F32 a_virtual{ir.FPSub(sum, b_virtual)};
+        const IR::F32 error{ir.FPAdd(ir.FPSub(a, a_virtual), ir.FPSub(b, b_virtual))};
+        return {sum, error};
+    }
+
+    Float2 TwoProd(const IR::F32& a, const IR::F32& b) {
+        const IR::F32 product{ir.FPMul(a, b)};
+        return {product, IR::F32{ir.FPFma(a, b, IR::F32{ir.FPNeg(product)})}};
+    }
+
+    Float2 Add(const Float2& a, const Float2& b) {
+        const Float2 s = TwoSum(a.hi, b.hi);
+        const Float2 t = TwoSum(a.lo, b.lo);
+        const Float2 u = QuickTwoSum(s.hi, IR::F32{ir.FPAdd(s.lo, t.hi)});
+        return QuickTwoSum(u.hi, IR::F32{ir.FPAdd(u.lo, t.lo)});
+    }
+
+    Float2 Neg(const Float2& value) {
+        return {IR::F32{ir.FPNeg(value.hi)}, IR::F32{ir.FPNeg(value.lo)}};
+    }
+
+    Float2 Sub(const Float2& a, const Float2& b) {
+        return Add(a, Neg(b));
+    }
+
+    Float2 Mul(const Float2& a, const Float2& b) {
+        const Float2 p = TwoProd(a.hi, b.hi);
+        IR::F32 error{ir.FPFma(a.hi, b.lo, p.lo)};
+        error = IR::F32{ir.FPFma(a.lo, b.hi, error)};
+        return QuickTwoSum(p.hi, error);
+    }
+
+    Float2 Div(const Float2& a, const Float2& b) {
+        const IR::F32 q1{ir.FPDiv(a.hi, b.hi)};
+        const Float2 r = Sub(a, Mul(b, FromFloat(q1)));
+        const IR::F32 q2{ir.FPDiv(r.hi, b.hi)};
+        return QuickTwoSum(q1, q2);
+    }
+
+    Float2 RecipSqrt(const Float2& value) {
+        // One Newton-Raphson step on the float estimate doubles its precision.
+        const IR::F32 y{ir.FPRecipSqrt(value.hi)};
+        const Float2 error = Sub(FromFloat(ir.Imm32(1.f)), Mul(value, TwoProd(y, y)));
+        return QuickTwoSum(y, IR::F32{ir.FPMul(ir.FPMul(y, error.hi), ir.Imm32(0.5f))});
+    }
+
+    Float2 Select(const IR::U1& cond, const Float2& a, const Float2& b) {
+        return {IR::F32{ir.Select(cond, a.hi, b.hi)}, IR::F32{ir.Select(cond, a.lo, b.lo)}};
+    }
+
+    Float2 Abs(const Float2& value) {
+        return Select(ir.FPLessThan(value.hi, ir.Imm32(0.f)), Neg(value), value);
+    }
+
+    IR::U1 Equal(const Float2& a, const Float2& b) {
+        return ir.LogicalAnd(ir.FPEqual(a.hi, b.hi), ir.FPEqual(a.lo, b.lo));
+    }
+
+    IR::U1 LessThan(const Float2& a, const Float2& b) {
+        return ir.LogicalOr(ir.FPLessThan(a.hi, b.hi),
+                            ir.LogicalAnd(ir.FPEqual(a.hi, b.hi), ir.FPLessThan(a.lo, b.lo)));
+    }
+
+    IR::U1 Compare(IR::Opcode op, const Float2& a, const Float2& b) {
+        // Only the high halves can be NaN, so they alone decide whether operands are ordered.
+        const auto unordered = [&](const IR::U1& ordered_result) {
+            return ir.LogicalOr(ordered_result, ir.FPUnordered(a.hi, b.hi));
+        };
+        switch (op) {
+        case IR::Opcode::FPOrdEqual64:
+            return Equal(a, b);
+        case IR::Opcode::FPUnordEqual64:
+            return unordered(Equal(a, b));
+        case IR::Opcode::FPOrdNotEqual64:
+            return ir.LogicalAnd(ir.FPOrdered(a.hi, b.hi), ir.LogicalNot(Equal(a, b)));
+        case IR::Opcode::FPUnordNotEqual64:
+            return ir.LogicalNot(Equal(a, b));
+        case IR::Opcode::FPOrdLessThan64:
+            return LessThan(a, b);
+        case IR::Opcode::FPUnordLessThan64:
+            return unordered(LessThan(a, b));
+        case IR::Opcode::FPOrdGreaterThan64:
+            return LessThan(b, a);
+        case IR::Opcode::FPUnordGreaterThan64:
+            return unordered(LessThan(b, a));
+        case IR::Opcode::FPOrdLessThanEqual64:
+            return ir.LogicalOr(LessThan(a, b), Equal(a, b));
+        case IR::Opcode::FPUnordLessThanEqual64:
+            return unordered(ir.LogicalOr(LessThan(a, b), Equal(a, b)));
+        case IR::Opcode::FPOrdGreaterThanEqual64:
+            return ir.LogicalOr(LessThan(b, a), Equal(a, b));
+        case IR::Opcode::FPUnordGreaterThanEqual64:
+            return unordered(ir.LogicalOr(LessThan(b, a), Equal(a, b)));
+        default:
+            UNREACHABLE_MSG("Invalid comparison {}", op);
+        }
+    }
+
+    Float2 Min(const Float2& a, const Float2& b) {
+        return Select(LessThan(b, a), b, a);
+    }
+
+    Float2 Max(const Float2& a, const Float2& b) {
+        return Select(LessThan(a, b), b, a);
+    }
+
+    Float2 Floor(const Float2& value) {
+        // The low half only matters when the high half is already integral.
+        const IR::F32 hi{ir.FPFloor(value.hi)};
+        return Select(ir.FPEqual(hi, value.hi), QuickTwoSum(hi, IR::F32{ir.FPFloor(value.lo)}),
+                      FromFloat(hi));
+    }
+
+    Float2 Ceil(const Float2& value) {
+        const IR::F32 hi{ir.FPCeil(value.hi)};
+        return Select(ir.FPEqual(hi, value.hi), QuickTwoSum(hi, IR::F32{ir.FPCeil(value.lo)}),
+                      FromFloat(hi));
+    }
+
+    Float2 Trunc(const Float2& value) {
+        return Select(ir.FPLessThan(value.hi, ir.Imm32(0.f)), Ceil(value), Floor(value));
+    }
+
+    Float2 RoundEven(const Float2& value) {
+        const IR::F32 hi{ir.FPRoundEven(value.hi)};
+        const Float2 integral = QuickTwoSum(hi, IR::F32{ir.FPRoundEven(value.lo)});
+        // A tie in the high half is broken by the sign of the low half.
+        const IR::F32 diff{ir.FPSub(value.hi, hi)};
+        const IR::U1 round_up{ir.LogicalAnd(ir.FPEqual(diff, ir.Imm32(0.5f)),
+                                            ir.FPGreaterThan(value.lo, ir.Imm32(0.f)))};
+        const IR::U1 round_down{ir.LogicalAnd(ir.FPEqual(diff, ir.Imm32(-0.5f)),
+                                              ir.FPLessThan(value.lo, ir.Imm32(0.f)))};
+        const IR::F32 adjusted{
+            ir.Select(round_up, ir.FPAdd(hi, ir.Imm32(1.f)),
+                      ir.Select(round_down, ir.FPSub(hi, ir.Imm32(1.f)), hi))};
+        return Select(ir.FPEqual(hi, value.hi), integral, FromFloat(adjusted));
+    }
+
+    Float2 Ldexp(const Float2& value, const IR::U32& exp) {
+        return {ir.FPLdexp(value.hi, exp), ir.FPLdexp(value.lo, exp)};
+    }
+
+    Float2 FromS32(const IR::U32& value) {
+        // Both halves convert exactly and their sum is exact as well.
+        const IR::F32 hi{ir.ConvertSToF(32, 32, ir.BitwiseAnd(value, ir.Imm32(0xffff0000U)))};
+        const IR::F32 lo{ir.ConvertUToF(32, 32, ir.BitwiseAnd(value, ir.Imm32(0xffffU)))};
+        return TwoSum(hi, lo);
+    }
+
+    Float2 FromU32(const IR::U32& value) {
+        const IR::F32 hi{ir.ConvertUToF(32, 32, ir.BitwiseAnd(value, ir.Imm32(0xffff0000U)))};
+        const IR::F32 lo{ir.ConvertUToF(32, 32, ir.BitwiseAnd(value, ir.Imm32(0xffffU)))};
+        return TwoSum(hi, lo);
+    }
+
+    IR::U32 ToS32(const Float2& value) {
+        const Float2 truncated = Trunc(value);
+        return IR::U32{ir.IAdd(IR::U32{ir.ConvertFToS(32, truncated.hi)},
+                               IR::U32{ir.ConvertFToS(32, truncated.lo)})};
+    }
+
+    Float2 Unpack(const IR::Value& packed) {
+        // Splits the 52 bit mantissa into the 23 bits that fit the high float and the rest.
+        const IR::U32 lo{ir.CompositeExtract(packed, 0)};
+        const IR::U32 hi{ir.CompositeExtract(packed, 1)};
+        const IR::U32 exp{ir.BitFieldExtract(hi, ir.Imm32(20), ir.Imm32(11))};
+        const IR::U32 mantissa_top{ir.BitFieldExtract(hi, ir.Imm32(0), ir.Imm32(20))};
+        const IR::U32 mantissa_mid{ir.BitFieldExtract(lo, ir.Imm32(29), ir.Imm32(3))};
+        const IR::U32 mantissa_hi{ir.BitwiseOr(
+            ir.Imm32(1U << 23),
+            ir.BitwiseOr(ir.ShiftLeftLogical(mantissa_top, ir.Imm32(3)), mantissa_mid))};
+        const IR::U32 mantissa_lo{ir.BitwiseAnd(lo, ir.Imm32((1U << 29) - 1))};
+        const IR::U32 unbiased_exp{ir.ISub(exp, ir.Imm32(1023))};
+        const IR::F32 value_hi{ir.FPLdexp(IR::F32{ir.ConvertUToF(32, 32, mantissa_hi)},
+                                          IR::U32{ir.ISub(unbiased_exp, ir.Imm32(23))})};
+        const IR::F32 value_lo{ir.FPLdexp(IR::F32{ir.ConvertUToF(32, 32, mantissa_lo)},
+                                          IR::U32{ir.ISub(unbiased_exp, ir.Imm32(52))})};
+        Float2 value = QuickTwoSum(value_hi, value_lo);
+        // Zeros and denormals flush to zero, infinities and NaNs keep their float equivalent.
+        value = Select(ir.IEqual(exp, ir.Imm32(0)), FromFloat(ir.Imm32(0.f)), value);
+        value = Select(ir.IEqual(exp, ir.Imm32(0x7ff)), FromFloat(PackedF64ToF32(ir, packed)),
+                       value);
+        return Select(ir.INotEqual(ir.BitFieldExtract(hi, ir.Imm32(31), ir.Imm32(1)), ir.Imm32(0)),
+                      Neg(value), value);
+    }
+
+    IR::Value Pack(const Float2& raw_value) {
+        const Float2 value = QuickTwoSum(raw_value.hi, raw_value.lo);
+        const IR::Value base{F32ToPackedF64(ir, value.hi)};
+        const IR::U32 base_lo{ir.CompositeExtract(base, 0)};
+        const IR::U32 base_hi{ir.CompositeExtract(base, 1)};
+
+        // The low half is added to the bits of the high half as a signed count of double ulps.
+        // Positive doubles order like integers, so carries into the exponent are correct.
+        const IR::U32 exp{ir.BitFieldExtract(ir.BitCast<IR::U32>(value.hi), ir.Imm32(23),
+                                             ir.Imm32(8))};
+        const IR::F32 magnitude_lo{ir.Select(ir.FPLessThan(value.hi, ir.Imm32(0.f)),
+                                             ir.FPNeg(value.lo), value.lo)};
+        const IR::F32 ulps{ir.FPRoundEven(
+            ir.FPLdexp(magnitude_lo, IR::U32{ir.ISub(ir.Imm32(127 + 52), exp)}))};
+        const IR::U1 is_finite{ir.LogicalAnd(ir.INotEqual(exp, ir.Imm32(0)),
+                                             ir.INotEqual(exp, ir.Imm32(0xff)))};
+        const IR::U32 delta{ir.Select(is_finite, ir.ConvertFToS(32, ulps), ir.Imm32(0))};
+        const IR::U32 lo{ir.IAdd(base_lo, delta)};
+        const IR::U1 is_negative{ir.ILessThan(delta, ir.Imm32(0), true)};
+        const IR::U1 carry{
+            ir.LogicalAnd(ir.LogicalNot(is_negative), ir.ILessThan(lo, base_lo, false))};
+        const IR::U1 borrow{ir.LogicalAnd(is_negative, ir.IGreaterThan(lo, base_lo, false))};
+        const IR::U32 hi{ir.IAdd(
+            base_hi, IR::U32{ir.Select(carry, ir.Imm32(1),
+                                       ir.Select(borrow, ir.Imm32(~0U), ir.Imm32(0)))})};
+        return ir.CompositeConstruct(lo, hi);
+    }
+
+private:
+    IR::IREmitter& ir;
+};
+
+void LowerToFloat2(IR::Block& block, IR::Inst& inst) {
+    const IR::Opcode op = inst.GetOpcode();
+    IR::IREmitter ir(block, IR::Block::InstructionList::s_iterator_to(inst));
+    Float2Emitter f2{ir};
+    const auto arg = [&](size_t index) { return f2.Get(inst.Arg(index)); };
+    const auto replace = [&](const Float2& value) {
+        inst.ReplaceUsesWithAndRemove(f2.Make(value));
+    };
+    switch (op) {
+    case IR::Opcode::PackDouble2x32:
+        replace(f2.Unpack(inst.Arg(0)));
+        break;
+    case IR::Opcode::UnpackDouble2x32:
+        inst.ReplaceUsesWithAndRemove(f2.Pack(arg(0)));
+        break;
+    case IR::Opcode::FPAbs64:
+        replace(f2.Abs(arg(0)));
+        break;
+    case IR::Opcode::FPAdd64:
+        replace(f2.Add(arg(0), arg(1)));
+        break;
+    case IR::Opcode::FPFma64:
+        replace(f2.Add(f2.Mul(arg(0), arg(1)), arg(2)));
+        break;
+    case IR::Opcode::FPMax64:
+        replace(f2.Max(arg(0), arg(1)));
+        break;
+    case IR::Opcode::FPMin64:
+        replace(f2.Min(arg(0), arg(1)));
+        break;
+    case IR::Opcode::FPMul64:
+        replace(f2.Mul(arg(0), arg(1)));
+        break;
+    case IR::Opcode::FPDiv64:
+        replace(f2.Div(arg(0), arg(1)));
+        break;
+    case IR::Opcode::FPNeg64:
+        replace(f2.Neg(arg(0)));
+        break;
+    case IR::Opcode::FPRecip64:
+        replace(f2.Div(f2.FromFloat(ir.Imm32(1.f)), arg(0)));
+        break;
+    case IR::Opcode::FPRecipSqrt64:
+        replace(f2.RecipSqrt(arg(0)));
+        break;
+    case IR::Opcode::FPSaturate64:
+        replace(f2.Min(f2.Max(arg(0), f2.FromFloat(ir.Imm32(0.f))), f2.FromFloat(ir.Imm32(1.f))));
+        break;
+    case IR::Opcode::FPClamp64:
+        replace(f2.Min(f2.Max(arg(0), arg(1)), arg(2)));
+        break;
+    case IR::Opcode::FPRoundEven64:
+        replace(f2.RoundEven(arg(0)));
+        break;
+    case IR::Opcode::FPFloor64:
+        replace(f2.Floor(arg(0)));
+        break;
+    case IR::Opcode::FPCeil64:
+        replace(f2.Ceil(arg(0)));
+        break;
+    case IR::Opcode::FPTrunc64:
+        replace(f2.Trunc(arg(0)));
+        break;
+    case IR::Opcode::FPFract64: {
+        const Float2 value = arg(0);
+        replace(f2.Sub(value, f2.Floor(value)));
+        break;
+    }
+    case IR::Opcode::FPFrexpSig64: {
+        const Float2 value = arg(0);
+        const IR::U32 exp{ir.FPFrexpExp(value.hi)};
+        replace(f2.Ldexp(value, IR::U32{ir.ISub(ir.Imm32(0), exp)}));
+        break;
+    }
+    case IR::Opcode::FPFrexpExp64:
+        inst.ReplaceUsesWithAndRemove(ir.FPFrexpExp(arg(0).hi));
+        break;
+    case IR::Opcode::FPOrdEqual64:
+    case IR::Opcode::FPUnordEqual64:
+    case IR::Opcode::FPOrdNotEqual64:
+    case IR::Opcode::FPUnordNotEqual64:
+    case IR::Opcode::FPOrdLessThan64:
+    case IR::Opcode::FPUnordLessThan64:
+    case IR::Opcode::FPOrdGreaterThan64:
+    case IR::Opcode::FPUnordGreaterThan64:
+    case IR::Opcode::FPOrdLessThanEqual64:
+    case IR::Opcode::FPUnordLessThanEqual64:
+    case IR::Opcode::FPOrdGreaterThanEqual64:
+    case IR::Opcode::FPUnordGreaterThanEqual64:
+        inst.ReplaceUsesWithAndRemove(f2.Compare(op, arg(0), arg(1)));
+        break;
+    case IR::Opcode::FPIsNan64:
+        inst.ReplaceUsesWithAndRemove(ir.FPIsNan(arg(0).hi));
+        break;
+    case IR::Opcode::FPIsInf64:
+        inst.ReplaceUsesWithAndRemove(ir.FPIsInf(arg(0).hi));
+        break;
+    case IR::Opcode::ConvertS32F64:
+        inst.ReplaceUsesWithAndRemove(f2.ToS32(arg(0)));
+        break;
+    case IR::Opcode::ConvertF32F64: {
+        const Float2 value = arg(0);
+        inst.ReplaceUsesWithAndRemove(ir.FPAdd(value.hi, value.lo));
+        break;
+    }
+    case IR::Opcode::ConvertF64F32:
+        replace(f2.FromFloat(IR::F32{inst.Arg(0)}));
+        break;
+    case IR::Opcode::ConvertF64S32:
+        replace(f2.FromS32(IR::U32{inst.Arg(0)}));
+        break;
+    case IR::Opcode::ConvertF64U32:
+        replace(f2.FromU32(IR::U32{inst.Arg(0)}));
+        break;
+    default:
+        break;
+    }
+}
+
+} // Anonymous namespace
+
+void LowerFp64ToFloat2(IR::Program& program) {
+    for (IR::Block* const block : program.blocks) {
+        for (IR::Inst& inst : block->Instructions()) {
+            LowerToFloat2(*block, inst);
+        }
+    }
+}
+
 } // namespace Shader::Optimization
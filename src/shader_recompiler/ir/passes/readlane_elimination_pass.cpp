@@ -55,7 +55,7 @@ static bool IsPossibleToEliminate(IR::Inst* inst, u32 lane) {
     return true;
 }
 
-using PhiMap = std::unordered_map<IR::Inst*, IR::Inst*>;
+using PhiMap = std::pmr::unordered_map<IR::Inst*, IR::Inst*>;
 
 static IR::Value GetRealValue(PhiMap& phi_map, IR::Inst* inst, u32 lane) {
     // If this is a WriteLane op search the chain for a possible candidate.
@@ -100,7 +100,7 @@ static IR::Value GetRealValue(PhiMap& phi_map, IR::Inst* inst, u32 lane) {
 }
 
 void ReadLaneEliminationPass(IR::Program& program) {
-    PhiMap phi_map;
+    PhiMap phi_map{program.arena};
     for (IR::Block* const block : program.blocks) {
         for (IR::Inst& inst : block->Instructions()) {
             if (inst.GetOpcode() != IR::Opcode::ReadLane) {
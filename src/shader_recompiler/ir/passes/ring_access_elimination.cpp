@@ -90,7 +90,7 @@ void RingAccessElimination(const IR::Program& program, const RuntimeInfo& runtim
     }
     case Stage::Geometry: {
         const auto& gs_info = runtime_info.gs_info;
-        info.gs_copy_data = Shader::ParseCopyShader(gs_info.vs_copy);
+        info.gs_copy_data = Shader::GetCopyShaderData(gs_info.vs_copy, gs_info.vs_copy_hash);
 
         u32 output_vertices = gs_info.output_vertices;
         if (info.gs_copy_data.output_vertices &&
@@ -1,7 +1,10 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+
 #include "common/config.h"
+#include "common/hash.h"
 #include "shader_recompiler/ir/program.h"
 #include "shader_recompiler/profile.h"
 #include "video_core/buffer_cache/buffer_cache.h"
@@ -88,6 +91,9 @@ void Visit(Info& info, const IR::Inst& inst) {
     case IR::Opcode::QuadShuffle:
         info.uses_group_quad = true;
         break;
+    case IR::Opcode::Shuffle:
+        info.uses_group_shuffle = true;
+        break;
     case IR::Opcode::ReadLane:
     case IR::Opcode::ReadFirstLane:
     case IR::Opcode::WriteLane:
@@ -154,13 +160,31 @@ void Visit(Info& info, const IR::Inst& inst) {
     }
 }
 
+/// Hashes the opcode of an instruction with the kind of each argument, immediates are hashed
+/// by value and other instructions by opcode.
+u64 FingerprintInst(const IR::Inst& inst) {
+    u64 hash = static_cast<u64>(inst.GetOpcode());
+    for (size_t i = 0; i < inst.NumArgs(); i++) {
+        const IR::Value arg = inst.Arg(i);
+        if (arg.IsImmediate()) {
+            hash = HashCombine(hash, static_cast<u64>(std::hash<IR::Value>{}(arg)));
+        } else if (const IR::Inst* const producer = arg.TryInstRecursive()) {
+            hash = HashCombine(hash, static_cast<u64>(producer->GetOpcode()));
+        }
+    }
+    return hash;
+}
+
 void CollectShaderInfoPass(IR::Program& program, const Profile& profile) {
     auto& info = program.info;
+    u64 fingerprint = 0;
     for (IR::Block* const block : program.post_order_blocks) {
         for (IR::Inst& inst : block->Instructions()) {
             Visit(info, inst);
+            fingerprint = HashCombine(fingerprint, FingerprintInst(inst));
         }
     }
+    info.ir_fingerprint = fingerprint;
 
     // In case Flatbuf has not already been bound by IR and is needed
     // to query buffer sizes, bind it now.
@@ -176,6 +200,17 @@ void CollectShaderInfoPass(IR::Program& program, const Profile& profile) {
         // info.readconst_types |= Info::ReadConstType::Immediate;
     }
 
+    if (profile.supports_texture_heap &&
+        std::ranges::any_of(info.images, [](const auto& image) { return !image.is_written; })) {
+        // Sampled images are indexed from the texture heap with slots written per draw.
+        info.uses_texture_heap = true;
+        info.buffers.push_back({
+            .used_types = IR::Type::U32,
+            .inline_cbuf = AmdGpu::Buffer::Placeholder(NUM_IMAGES * sizeof(u32)),
+            .buffer_type = BufferType::TextureHeapIndices,
+        });
+    }
+
     if (!Config::directMemoryAccess()) {
         info.uses_dma = false;
         info.readconst_types = Info::ReadConstType::None;
@@ -0,0 +1,40 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "shader_recompiler/ir/ir_emitter.h"
+#include "shader_recompiler/ir/program.h"
+
+namespace Shader::Optimization {
+
+// Counts how many times every block of the shader runs. Each block atomically increments its own
+// dword of the profiling buffer, which the renderer binds to a region reserved for this shader
+// and reads back to attribute GPU time to the blocks executing most.
+
+void ShaderProfilingPass(IR::Program& program) {
+    const u32 num_blocks = static_cast<u32>(program.blocks.size());
+    if (num_blocks == 0) {
+        return;
+    }
+    const u32 binding = static_cast<u32>(program.info.buffers.size());
+    program.info.buffers.push_back({
+        .used_types = IR::Type::U32,
+        .inline_cbuf = AmdGpu::Buffer::Placeholder(num_blocks * sizeof(u32)),
+        .buffer_type = BufferType::ProfilingBuffer,
+        .is_written = true,
+    });
+    program.info.num_block_counters = num_blocks;
+
+    for (u32 index = 0; index < num_blocks; ++index) {
+        IR::Block* const block = program.blocks[index];
+        // Phi nodes must stay at the start of the block.
+        auto it = block->begin();
+        while (it != block->end() && it->GetOpcode() == IR::Opcode::Phi) {
+            ++it;
+        }
+        IR::IREmitter ir{*block, it};
+        static_cast<void>(
+            ir.BufferAtomicIAdd(ir.Imm32(binding), ir.Imm32(index * 4), ir.Imm32(1), {}));
+    }
+}
+
+} // namespace Shader::Optimization
@@ -1,6 +1,13 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <memory_resource>
+#include <optional>
+#include <vector>
+#include "common/alignment.h"
 #include "shader_recompiler/ir/ir_emitter.h"
 #include "shader_recompiler/ir/program.h"
 #include "shader_recompiler/profile.h"
@@ -44,54 +51,235 @@ static bool IsSharedAccess(const IR::Inst& inst) {
     }
 }
 
+static IR::Type AccessType(const IR::Inst& inst) {
+    switch (inst.GetOpcode()) {
+    case IR::Opcode::LoadSharedU16:
+    case IR::Opcode::WriteSharedU16:
+        return IR::Type::U16;
+    case IR::Opcode::LoadSharedU64:
+    case IR::Opcode::WriteSharedU64:
+    case IR::Opcode::SharedAtomicIAdd64:
+    case IR::Opcode::SharedAtomicISub64:
+    case IR::Opcode::SharedAtomicSMin64:
+    case IR::Opcode::SharedAtomicUMin64:
+    case IR::Opcode::SharedAtomicSMax64:
+    case IR::Opcode::SharedAtomicUMax64:
+    case IR::Opcode::SharedAtomicInc64:
+    case IR::Opcode::SharedAtomicDec64:
+    case IR::Opcode::SharedAtomicAnd64:
+    case IR::Opcode::SharedAtomicOr64:
+    case IR::Opcode::SharedAtomicXor64:
+        return IR::Type::U64;
+    default:
+        return IR::Type::U32;
+    }
+}
+
 IR::Type CalculateSharedMemoryTypes(IR::Program& program) {
     IR::Type used_types{IR::Type::Void};
     for (IR::Block* const block : program.blocks) {
         for (IR::Inst& inst : block->Instructions()) {
+            if (IsSharedAccess(inst)) {
+                used_types |= AccessType(inst);
+            }
+        }
+    }
+    return used_types;
+}
+
+struct AddressRange {
+    u64 min;
+    u64 max;
+};
+
+/// Computes the range of values an address can take, nullopt if it could not be bounded.
+static std::optional<AddressRange> CalculateAddressRange(const IR::Value& value,
+                                                         const RuntimeInfo& runtime_info,
+                                                         u32 depth = 0) {
+    constexpr u32 MaxDepth = 16;
+    const IR::Value resolved = value.Resolve();
+    if (resolved.IsImmediate()) {
+        return AddressRange{resolved.U32(), resolved.U32()};
+    }
+    if (depth == MaxDepth) {
+        return std::nullopt;
+    }
+    const IR::Inst* const inst = resolved.InstRecursive();
+    const auto arg_range = [&](size_t index) {
+        return CalculateAddressRange(inst->Arg(index), runtime_info, depth + 1);
+    };
+    const auto imm_arg = [&](size_t index) -> std::optional<u32> {
+        const IR::Value arg = inst->Arg(index).Resolve();
+        return arg.IsImmediate() ? std::optional{arg.U32()} : std::nullopt;
+    };
+    const auto checked = [](AddressRange range) -> std::optional<AddressRange> {
+        // Anything that may wrap around is not bounded.
+        return range.max <= std::numeric_limits<u32>::max() ? std::optional{range} : std::nullopt;
+    };
+    const auto& workgroup_size = runtime_info.cs_info.workgroup_size;
+    switch (inst->GetOpcode()) {
+    case IR::Opcode::GetAttributeU32:
+        if (inst->Arg(0).Attribute() == IR::Attribute::LocalInvocationId) {
+            return AddressRange{0, workgroup_size[inst->Arg(1).U32()] - 1U};
+        }
+        if (inst->Arg(0).Attribute() == IR::Attribute::LocalInvocationIndex) {
+            const u64 num_threads = u64(workgroup_size[0]) * workgroup_size[1] * workgroup_size[2];
+            return AddressRange{0, num_threads - 1};
+        }
+        return std::nullopt;
+    case IR::Opcode::IAdd32: {
+        const auto lhs = arg_range(0);
+        const auto rhs = arg_range(1);
+        if (!lhs || !rhs) {
+            return std::nullopt;
+        }
+        return checked({lhs->min + rhs->min, lhs->max + rhs->max});
+    }
+    case IR::Opcode::IMul32: {
+        const auto lhs = arg_range(0);
+        const auto rhs = arg_range(1);
+        if (!lhs || !rhs) {
+            return std::nullopt;
+        }
+        return checked({lhs->min * rhs->min, lhs->max * rhs->max});
+    }
+    case IR::Opcode::ShiftLeftLogical32: {
+        const auto base = arg_range(0);
+        const auto shift = imm_arg(1);
+        if (!base || !shift || *shift >= 32) {
+            return std::nullopt;
+        }
+        return checked({base->min << *shift, base->max << *shift});
+    }
+    case IR::Opcode::ShiftRightLogical32: {
+        const auto base = arg_range(0);
+        const auto shift = imm_arg(1);
+        if (!base || !shift || *shift >= 32) {
+            return std::nullopt;
+        }
+        return AddressRange{base->min >> *shift, base->max >> *shift};
+    }
+    case IR::Opcode::BitwiseAnd32: {
+        // A constant mask bounds the result even when the other operand is unknown.
+        const auto lhs = arg_range(0);
+        const auto rhs = arg_range(1);
+        if (!lhs && !rhs) {
+            return std::nullopt;
+        }
+        return AddressRange{0, std::min(lhs ? lhs->max : rhs->max, rhs ? rhs->max : lhs->max)};
+    }
+    case IR::Opcode::BitwiseOr32: {
+        const auto lhs = arg_range(0);
+        const auto rhs = arg_range(1);
+        if (!lhs || !rhs) {
+            return std::nullopt;
+        }
+        return AddressRange{std::max(lhs->min, rhs->min),
+                            std::bit_ceil(std::max(lhs->max, rhs->max) + 1) - 1};
+    }
+    case IR::Opcode::BitFieldUExtract: {
+        const auto count = imm_arg(2);
+        if (!count || *count >= 32) {
+            return std::nullopt;
+        }
+        return AddressRange{0, (1ULL << *count) - 1};
+    }
+    default:
+        return std::nullopt;
+    }
+}
+
+/// Returns the range of bytes touched by a shared memory access.
+static std::optional<AddressRange> CalculateAccessRange(const IR::Inst& inst,
+                                                        const RuntimeInfo& runtime_info) {
+    const auto range = CalculateAddressRange(inst.Arg(0), runtime_info);
+    if (!range) {
+        return std::nullopt;
+    }
+    const IR::Type type = AccessType(inst);
+    const u32 size = type == IR::Type::U16 ? 2 : (type == IR::Type::U64 ? 8 : 4);
+    return AddressRange{range->min, range->max + size - 1};
+}
+
+struct SharedMemoryWindow {
+    u32 begin{};
+    u32 size{};
+
+    bool Contains(const AddressRange& range) const {
+        return range.min >= begin && range.max < begin + size;
+    }
+
+    bool Overlaps(const AddressRange& range) const {
+        return range.max >= begin && range.min < begin + size;
+    }
+};
+
+/// Picks the part of shared memory that stays in host shared memory when the guest workgroup
+/// needs more than the host has. Every access must provably stay either inside or outside of it,
+/// as the two parts are different memories. Accesses in loops are weighted higher, so the hot
+/// part of shared memory is the one that stays on chip. Returns an empty window on failure.
+static SharedMemoryWindow FindSharedMemoryWindow(IR::Program& program,
+                                                 const RuntimeInfo& runtime_info,
+                                                 const Profile& profile) {
+    // Keep vector accesses at the alignment, and bank, they had on the guest.
+    constexpr u32 Alignment = 16;
+    const u32 shared_memory_size = runtime_info.cs_info.shared_memory_size;
+    const u32 window_size = Common::AlignDown(profile.max_shared_memory_size, Alignment);
+    if (window_size == 0) {
+        return {};
+    }
+
+    struct Access {
+        AddressRange range;
+        u64 weight;
+    };
+    std::pmr::vector<Access> accesses{program.arena};
+    u32 loop_depth = 0;
+    for (const IR::AbstractSyntaxNode& node : program.syntax_list) {
+        if (node.type == IR::AbstractSyntaxNode::Type::Loop) {
+            ++loop_depth;
+        } else if (node.type == IR::AbstractSyntaxNode::Type::Repeat) {
+            --loop_depth;
+        }
+        if (node.type != IR::AbstractSyntaxNode::Type::Block) {
+            continue;
+        }
+        const u64 weight = 1ULL << (3 * std::min(loop_depth, 4U));
+        for (const IR::Inst& inst : node.data.block->Instructions()) {
             if (!IsSharedAccess(inst)) {
                 continue;
             }
-            switch (inst.GetOpcode()) {
-            case IR::Opcode::LoadSharedU16:
-            case IR::Opcode::WriteSharedU16:
-                used_types |= IR::Type::U16;
-                break;
-            case IR::Opcode::LoadSharedU32:
-            case IR::Opcode::WriteSharedU32:
-            case IR::Opcode::SharedAtomicIAdd32:
-            case IR::Opcode::SharedAtomicISub32:
-            case IR::Opcode::SharedAtomicSMin32:
-            case IR::Opcode::SharedAtomicUMin32:
-            case IR::Opcode::SharedAtomicSMax32:
-            case IR::Opcode::SharedAtomicUMax32:
-            case IR::Opcode::SharedAtomicInc32:
-            case IR::Opcode::SharedAtomicDec32:
-            case IR::Opcode::SharedAtomicAnd32:
-            case IR::Opcode::SharedAtomicOr32:
-            case IR::Opcode::SharedAtomicXor32:
-                used_types |= IR::Type::U32;
-                break;
-            case IR::Opcode::LoadSharedU64:
-            case IR::Opcode::WriteSharedU64:
-            case IR::Opcode::SharedAtomicIAdd64:
-            case IR::Opcode::SharedAtomicISub64:
-            case IR::Opcode::SharedAtomicSMin64:
-            case IR::Opcode::SharedAtomicUMin64:
-            case IR::Opcode::SharedAtomicSMax64:
-            case IR::Opcode::SharedAtomicUMax64:
-            case IR::Opcode::SharedAtomicInc64:
-            case IR::Opcode::SharedAtomicDec64:
-            case IR::Opcode::SharedAtomicAnd64:
-            case IR::Opcode::SharedAtomicOr64:
-            case IR::Opcode::SharedAtomicXor64:
-                used_types |= IR::Type::U64;
-                break;
-            default:
-                break;
+            const auto range = CalculateAccessRange(inst, runtime_info);
+            if (!range || range->max >= shared_memory_size) {
+                return {};
             }
+            accesses.push_back({*range, weight});
         }
     }
-    return used_types;
+
+    SharedMemoryWindow best{};
+    u64 best_weight = 0;
+    for (const Access& candidate : accesses) {
+        const SharedMemoryWindow window{
+            .begin = Common::AlignDown(std::min<u32>(static_cast<u32>(candidate.range.min),
+                                                     shared_memory_size - window_size),
+                                       Alignment),
+            .size = window_size,
+        };
+        u64 weight = 0;
+        const bool is_valid = std::ranges::all_of(accesses, [&](const Access& access) {
+            if (window.Contains(access.range)) {
+                weight += access.weight;
+                return true;
+            }
+            return !window.Overlaps(access.range);
+        });
+        if (is_valid && weight > best_weight) {
+            best = window;
+            best_weight = weight;
+        }
+    }
+    return best;
 }
 
 void SharedMemoryToStoragePass(IR::Program& program, const RuntimeInfo& runtime_info,
@@ -106,6 +294,7 @@ void SharedMemoryToStoragePass(IR::Program& program, const RuntimeInfo& runtime_
     //   * Requested shared memory size is too large for the host shared memory.
     //   * Workgroup explicit memory is not supported and multiple shared memory types are used.
     const u32 shared_memory_size = runtime_info.cs_info.shared_memory_size;
+    program.info.shared_memory_size = shared_memory_size;
     const auto used_types = CalculateSharedMemoryTypes(program);
     if (used_types == IR::Type::Void || (shared_memory_size <= profile.max_shared_memory_size &&
                                          (profile.supports_workgroup_explicit_memory_layout ||
@@ -113,11 +302,22 @@ void SharedMemoryToStoragePass(IR::Program& program, const RuntimeInfo& runtime_
         return;
     }
 
+    // When only the size is the problem, the part of shared memory that fits stays on chip and
+    // the rest is spilled. Otherwise everything goes to the storage buffer.
+    SharedMemoryWindow window{};
+    if (shared_memory_size > profile.max_shared_memory_size &&
+        (profile.supports_workgroup_explicit_memory_layout ||
+         std::popcount(static_cast<u32>(used_types)) == 1)) {
+        window = FindSharedMemoryWindow(program, runtime_info, profile);
+    }
+    const u32 spill_size = shared_memory_size - window.size;
+    program.info.shared_memory_size = window.size;
+
     // Add a buffer binding for shared memory storage buffer.
     const u32 binding = static_cast<u32>(program.info.buffers.size());
     program.info.buffers.push_back({
         .used_types = used_types,
-        .inline_cbuf = AmdGpu::Buffer::Null(),
+        .inline_cbuf = AmdGpu::Buffer::Placeholder(spill_size),
         .buffer_type = BufferType::SharedMemory,
         .is_written = true,
     });
@@ -128,10 +328,25 @@ void SharedMemoryToStoragePass(IR::Program& program, const RuntimeInfo& runtime_
                 continue;
             }
             IR::IREmitter ir{*block, IR::Block::InstructionList::s_iterator_to(inst)};
+            IR::U32 address{inst.Arg(0)};
+            if (window.size != 0) {
+                const auto range = CalculateAccessRange(inst, runtime_info);
+                ASSERT(range);
+                if (window.Contains(*range)) {
+                    if (window.begin != 0) {
+                        inst.SetArg(0, IR::U32{ir.ISub(address, ir.Imm32(window.begin))});
+                    }
+                    continue;
+                }
+                if (range->min >= window.begin + window.size) {
+                    // The spilled part does not include the window.
+                    address = IR::U32{ir.ISub(address, ir.Imm32(window.size))};
+                }
+            }
             const IR::U32 handle = ir.Imm32(binding);
             const IR::U32 offset = ir.IMul(ir.GetAttributeU32(IR::Attribute::WorkgroupIndex),
-                                           ir.Imm32(shared_memory_size));
-            const IR::U32 address = ir.IAdd(IR::U32{inst.Arg(0)}, offset);
+                                           ir.Imm32(spill_size));
+            address = ir.IAdd(address, offset);
             switch (inst.GetOpcode()) {
             case IR::Opcode::SharedAtomicIAdd32:
             case IR::Opcode::SharedAtomicIAdd64:
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <memory_resource>
 #include <string>
 #include "shader_recompiler/frontend/instruction.h"
 #include "shader_recompiler/info.h"
@@ -12,13 +13,17 @@
 namespace Shader::IR {
 
 struct Program {
-    explicit Program(Info& info_) : info{info_} {}
+    explicit Program(Info& info_,
+                     std::pmr::memory_resource* arena_ = std::pmr::get_default_resource())
+        : info{info_}, arena{arena_} {}
 
     AbstractSyntaxList syntax_list;
     BlockList blocks;
     BlockList post_order_blocks;
     std::vector<Gcn::GcnInst> ins_list;
     Info& info;
+    /// Allocator for temporary pass data, lives as long as the translation.
+    std::pmr::memory_resource* arena;
 };
 
 void DumpProgram(const Program& program, const Info& info, const std::string& type = "");
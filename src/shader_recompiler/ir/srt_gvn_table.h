@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <memory_resource>
 #include <unordered_map>
 #include <boost/container/set.hpp>
 #include <boost/container/small_vector.hpp>
@@ -19,10 +20,11 @@ namespace Shader::Optimization {
 
 class SrtGvnTable {
 public:
-    using ValueNumberTable = std::unordered_map<IR::Value, u32>;
+    using ValueNumberTable = std::pmr::unordered_map<IR::Value, u32>;
     using ValueNum = u32;
 
-    SrtGvnTable() : value_numbers(), next_num(0) {}
+    explicit SrtGvnTable(std::pmr::memory_resource* arena)
+        : value_numbers(arena), next_num(0), iv_to_vn(arena) {}
 
     u32 GetValueNumber(IR::Inst* inst) {
         return GetValueNumber(IR::Value{inst});
@@ -119,7 +121,7 @@ private:
         }
     };
 
-    std::unordered_map<InstVector, u32, HashInstVector> iv_to_vn;
+    std::pmr::unordered_map<InstVector, u32, HashInstVector> iv_to_vn;
 };
 
 } // namespace Shader::Optimization
\ No newline at end of file
@@ -158,6 +158,10 @@ public:
     /// Determines whether or not this instruction may have side effects.
     [[nodiscard]] bool MayHaveSideEffects() const noexcept;
 
+    /// Determines whether the result only depends on the arguments, so equal instructions can be
+    /// merged and the instruction can be moved anywhere its arguments are available.
+    [[nodiscard]] bool IsPure() const noexcept;
+
     /// Determines if all arguments of this instruction are immediates.
     [[nodiscard]] bool AreAllArgsImmediates() const;
 
@@ -7,6 +7,15 @@
 
 namespace Shader {
 
+enum class Fp64Mode : u32 {
+    /// Native doubles, requires shaderFloat64.
+    Exact,
+    /// Pairs of floats, about 48 bits of precision at several times the cost of a float.
+    Emulated,
+    /// Plain floats.
+    Demote,
+};
+
 struct Profile {
     u32 supported_spirv{0x00010000};
     u32 subgroup_size{};
@@ -15,6 +24,9 @@ struct Profile {
     bool support_int64{};
     bool support_float16{};
     bool support_float64{};
+    Fp64Mode fp64_mode{};
+    bool enable_block_counters{};
+    bool supports_texture_heap{};
     bool support_fp32_denorm_preserve{};
     bool support_fp32_denorm_flush{};
     bool support_fp32_round_to_zero{};
@@ -22,6 +34,7 @@ struct Profile {
     bool supports_image_load_store_lod{};
     bool supports_native_cube_calc{};
     bool supports_trinary_minmax{};
+    bool supports_subgroup_shuffle{};
     bool supports_robust_buffer_access{};
     bool supports_buffer_fp32_atomic_min_max{};
     bool supports_image_fp32_atomic_min_max{};
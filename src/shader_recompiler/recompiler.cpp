@@ -11,6 +11,38 @@
 
 namespace Shader {
 
+std::string_view PassName(Pass pass) {
+    static constexpr std::array<std::string_view, static_cast<size_t>(Pass::Count)> Names = {
+        "decode",
+        "control_flow_graph",
+        "structurize",
+        "lower_fp64",
+        "ssa_rewrite",
+        "constant_propagation",
+        "identity_removal",
+        "tessellation",
+        "ring_access_elimination",
+        "read_lane_elimination",
+        "flatten_extended_userdata",
+        "resource_tracking",
+        "lower_buffer_format",
+        "shared_memory",
+        "global_value_numbering",
+        "buffer_load_coalescing",
+        "loop_invariant_code_motion",
+        "dead_code_elimination",
+        "shader_profiling",
+        "collect_shader_info",
+        "emit_spirv",
+    };
+    return Names[static_cast<size_t>(pass)];
+}
+
+PassStats& GetPassStats() {
+    static PassStats stats;
+    return stats;
+}
+
 IR::BlockList GenerateBlocks(const IR::AbstractSyntaxList& syntax_list) {
     size_t num_syntax_blocks{};
     for (const auto& node : syntax_list) {
@@ -39,9 +71,10 @@ IR::Program TranslateProgram(std::span<const u32> code, Pools& pools, Info& info
 
     Gcn::GcnCodeSlice slice(code.data(), code.data() + code.size());
     Gcn::GcnDecodeContext decoder;
+    PassClock clock;
 
     // Decode and save instructions
-    IR::Program program{info};
+    IR::Program program{info, &pools.arena};
     program.ins_list.reserve(code.size());
     while (!slice.atEnd()) {
         program.ins_list.emplace_back(decoder.decodeInstruction(slice));
@@ -49,24 +82,33 @@ IR::Program TranslateProgram(std::span<const u32> code, Pools& pools, Info& info
 
     // Clear any previous pooled data.
     pools.ReleaseContents();
+    clock.Lap(Pass::Decode);
 
     // Create control flow graph
     Common::ObjectPool<Gcn::Block> gcn_block_pool{64};
     Gcn::CFG cfg{gcn_block_pool, program.ins_list};
+    clock.Lap(Pass::ControlFlowGraph);
 
     // Structurize control flow graph and create program.
-    program.syntax_list = Shader::Gcn::BuildASL(pools.inst_pool, pools.block_pool, cfg,
-                                                program.info, runtime_info, profile);
+    program.syntax_list = Shader::Gcn::BuildASL(pools.inst_pool, pools.block_pool, program.arena,
+                                                cfg, program.info, runtime_info, profile);
     program.blocks = GenerateBlocks(program.syntax_list);
     program.post_order_blocks = Shader::IR::PostOrder(program.syntax_list.front());
+    clock.Lap(Pass::Structurize);
 
     // Run optimization passes
-    if (!profile.support_float64) {
+    if (profile.fp64_mode == Fp64Mode::Emulated) {
+        Shader::Optimization::LowerFp64ToFloat2(program);
+    } else if (profile.fp64_mode == Fp64Mode::Demote) {
         Shader::Optimization::LowerFp64ToFp32(program);
     }
-    Shader::Optimization::SsaRewritePass(program.post_order_blocks);
+    clock.Lap(Pass::LowerFp64);
+    Shader::Optimization::SsaRewritePass(program.post_order_blocks, program.arena);
+    clock.Lap(Pass::SsaRewrite);
     Shader::Optimization::ConstantPropagationPass(program.post_order_blocks);
+    clock.Lap(Pass::ConstantPropagation);
     Shader::Optimization::IdentityRemovalPass(program.blocks);
+    clock.Lap(Pass::IdentityRemoval);
     if (info.l_stage == LogicalStage::TessellationControl) {
         Shader::Optimization::TessellationPreprocess(program, runtime_info);
         Shader::Optimization::HullShaderTransform(program, runtime_info);
@@ -74,18 +116,40 @@ IR::Program TranslateProgram(std::span<const u32> code, Pools& pools, Info& info
         Shader::Optimization::TessellationPreprocess(program, runtime_info);
         Shader::Optimization::DomainShaderTransform(program, runtime_info);
     }
+    clock.Lap(Pass::Tessellation);
     Shader::Optimization::RingAccessElimination(program, runtime_info);
+    clock.Lap(Pass::RingAccessElimination);
     Shader::Optimization::ReadLaneEliminationPass(program);
+    clock.Lap(Pass::ReadLaneElimination);
     Shader::Optimization::FlattenExtendedUserdataPass(program);
+    clock.Lap(Pass::FlattenExtendedUserdata);
     Shader::Optimization::ResourceTrackingPass(program);
+    clock.Lap(Pass::ResourceTracking);
     Shader::Optimization::LowerBufferFormatToRaw(program);
+    clock.Lap(Pass::LowerBufferFormat);
     Shader::Optimization::SharedMemorySimplifyPass(program, profile);
     Shader::Optimization::SharedMemoryToStoragePass(program, runtime_info, profile);
     Shader::Optimization::SharedMemoryBarrierPass(program, runtime_info, profile);
+    clock.Lap(Pass::SharedMemory);
+    Shader::Optimization::GlobalValueNumberingPass(program);
+    clock.Lap(Pass::GlobalValueNumbering);
+    Shader::Optimization::BufferLoadCoalescingPass(program);
+    clock.Lap(Pass::BufferLoadCoalescing);
+    Shader::Optimization::LoopInvariantCodeMotionPass(program);
+    clock.Lap(Pass::LoopInvariantCodeMotion);
     Shader::Optimization::IdentityRemovalPass(program.blocks);
+    clock.Lap(Pass::IdentityRemoval);
     Shader::Optimization::DeadCodeEliminationPass(program);
+    clock.Lap(Pass::DeadCodeElimination);
     Shader::Optimization::ConstantPropagationPass(program.post_order_blocks);
+    clock.Lap(Pass::ConstantPropagation);
+    if (profile.enable_block_counters) {
+        Shader::Optimization::ShaderProfilingPass(program);
+    }
+    clock.Lap(Pass::ShaderProfiling);
     Shader::Optimization::CollectShaderInfoPass(program, profile);
+    clock.Lap(Pass::CollectShaderInfo);
+    GetPassStats().num_programs.fetch_add(1, std::memory_order_relaxed);
 
     Shader::IR::DumpProgram(program, info);
 
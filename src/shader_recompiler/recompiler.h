@@ -3,7 +3,14 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <memory_resource>
+#include <string_view>
 #include "common/object_pool.h"
+#include "common/types.h"
 #include "shader_recompiler/ir/basic_block.h"
 #include "shader_recompiler/ir/program.h"
 
@@ -15,18 +22,80 @@ struct RuntimeInfo;
 struct Pools {
     static constexpr u32 InstPoolSize = 8192;
     static constexpr u32 BlockPoolSize = 32;
+    static constexpr size_t ArenaSize = 1_MB;
 
     Common::ObjectPool<IR::Inst> inst_pool;
     Common::ObjectPool<IR::Block> block_pool;
+    /// Backs the temporary containers of the frontend and the IR passes of one translation.
+    /// Nothing is freed until the next translation, which drops everything at once.
+    std::unique_ptr<std::byte[]> arena_buffer;
+    std::pmr::monotonic_buffer_resource arena;
 
-    explicit Pools() : inst_pool{InstPoolSize}, block_pool{BlockPoolSize} {}
+    explicit Pools()
+        : inst_pool{InstPoolSize}, block_pool{BlockPoolSize},
+          arena_buffer{std::make_unique<std::byte[]>(ArenaSize)},
+          arena{arena_buffer.get(), ArenaSize} {}
 
     void ReleaseContents() {
         inst_pool.ReleaseContents();
         block_pool.ReleaseContents();
+        arena.release();
     }
 };
 
+/// Stages of a translation that are timed, EmitSpirv is timed by the caller of the backend.
+enum class Pass : u32 {
+    Decode,
+    ControlFlowGraph,
+    Structurize,
+    LowerFp64,
+    SsaRewrite,
+    ConstantPropagation,
+    IdentityRemoval,
+    Tessellation,
+    RingAccessElimination,
+    ReadLaneElimination,
+    FlattenExtendedUserdata,
+    ResourceTracking,
+    LowerBufferFormat,
+    SharedMemory,
+    GlobalValueNumbering,
+    BufferLoadCoalescing,
+    LoopInvariantCodeMotion,
+    DeadCodeElimination,
+    ShaderProfiling,
+    CollectShaderInfo,
+    EmitSpirv,
+    Count,
+};
+
+[[nodiscard]] std::string_view PassName(Pass pass);
+
+/// Time spent in each pass over all translations since startup.
+struct PassStats {
+    std::array<std::atomic<u64>, static_cast<size_t>(Pass::Count)> time_ns{};
+    std::atomic<u64> num_programs{};
+};
+
+[[nodiscard]] PassStats& GetPassStats();
+
+/// Adds the time since the last lap, or since construction, to a pass.
+class PassClock {
+public:
+    PassClock() : last{std::chrono::steady_clock::now()} {}
+
+    void Lap(Pass pass) {
+        const auto now = std::chrono::steady_clock::now();
+        const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last);
+        GetPassStats().time_ns[static_cast<size_t>(pass)].fetch_add(elapsed.count(),
+                                                                     std::memory_order_relaxed);
+        last = now;
+    }
+
+private:
+    std::chrono::steady_clock::time_point last;
+};
+
 [[nodiscard]] IR::Program TranslateProgram(std::span<const u32> code, Pools& pools, Info& info,
                                            RuntimeInfo& runtime_info, const Profile& profile);
 
@@ -24,6 +24,8 @@ enum class BufferType : u32 {
     FaultBuffer,
     GdsBuffer,
     SharedMemory,
+    ProfilingBuffer,
+    TextureHeapIndices,
 };
 
 struct Info;
@@ -155,6 +155,21 @@ struct StageSpecialization {
                          spec.force_degamma = sharp.force_degamma;
                      });
 
+        // Formats of render targets the shader never exports to do not affect its code, drop
+        // them so they do not create permutations.
+        if (info->stage == Stage::Fragment) {
+            u32 consumed_mask = info->mrt_mask;
+            if (runtime_info.fs_info.dual_source_blending && (consumed_mask & 0b10)) {
+                // The second blend source is exported through MRT1 with the format of MRT0.
+                consumed_mask |= 0b1;
+            }
+            for (u32 i = 0; i < MaxColorBuffers; ++i) {
+                if (!(consumed_mask & (1u << i))) {
+                    runtime_info.fs_info.color_buffers[i] = {};
+                }
+            }
+        }
+
         // Initialize runtime_info fields that rely on analysis in tessellation passes
         if (info->l_stage == LogicalStage::TessellationControl ||
             info->l_stage == LogicalStage::TessellationEval) {
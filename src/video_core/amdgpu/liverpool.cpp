@@ -67,6 +67,9 @@ static std::span<const u32> NextPacket(std::span<const u32> span, size_t offset)
 
 Liverpool::Liverpool() {
     num_counter_pairs = Libraries::Kernel::sceKernelIsNeoMode() ? 16 : 8;
+    if (Config::isPm4PreParseEnabled()) {
+        pm4_parser = std::make_unique<Pm4Parser>();
+    }
     process_thread = std::jthread{std::bind_front(&Liverpool::Process, this)};
 }
 
@@ -122,7 +125,15 @@ void Liverpool::Process(std::stop_token stoken) {
                 }
                 task = queue.submits.front();
             }
-            task.resume();
+            DETAILED_PLOT("Liverpool pending submits", static_cast<s64>(num_submits.load()));
+            {
+#ifndef TRACY_FIBERS
+                // Zones can't span the fiber switches the tasks do when fibers are enabled.
+                DETAILED_TRACE("Liverpool::ProcessQueue", GpuMarkerColor);
+                DETAILED_TRACE_VALUE(curr_qid);
+#endif
+                task.resume();
+            }
 
             if (task.done()) {
                 task.destroy();
@@ -143,6 +154,7 @@ void Liverpool::Process(std::stop_token stoken) {
                 rasterizer->Flush();
             }
             submit_done = false;
+            DETAILED_FRAME_MARK("Guest submit");
         }
 
         Platform::IrqC::Instance()->Signal(Platform::InterruptId::GpuIdle);
@@ -215,7 +227,8 @@ Liverpool::Task Liverpool::ProcessCeUpdate(std::span<const u32> ccb) {
     FIBER_EXIT;
 }
 
-Liverpool::Task Liverpool::ProcessGraphics(std::span<const u32> dcb, std::span<const u32> ccb) {
+Liverpool::Task Liverpool::ProcessGraphics(std::span<const u32> dcb, std::span<const u32> ccb,
+                                           std::shared_ptr<Pm4Stream> stream) {
     FIBER_ENTER(dcb_task_name);
 
     cblock.Reset();
@@ -231,9 +244,33 @@ Liverpool::Task Liverpool::ProcessGraphics(std::span<const u32> dcb, std::span<c
     }
 
     const auto base_addr = reinterpret_cast<uintptr_t>(dcb.data());
+    const u32* const dcb_begin = dcb.data();
+    size_t packet_index = 0;
+    if (stream) {
+        stream->Wait();
+    }
     while (!dcb.empty()) {
         ProcessCommands();
 
+        if (stream) {
+            // Skip straight to the next packet found by the parser, packets that were jumped
+            // over by a conditional execution are left behind.
+            const u32 offset = static_cast<u32>(dcb.data() - dcb_begin);
+            if (offset < stream->parsed_words) {
+                const auto& packets = stream->packets;
+                while (packet_index < packets.size() && packets[packet_index].offset < offset) {
+                    ++packet_index;
+                }
+                const u32 next_offset = packet_index < packets.size()
+                                            ? packets[packet_index].offset
+                                            : stream->parsed_words;
+                if (next_offset != offset) {
+                    dcb = NextPacket(dcb, next_offset - offset);
+                    continue;
+                }
+            }
+        }
+
         const auto* header = reinterpret_cast<const PM4Header*>(dcb.data());
         const u32 type = header->type;
 
@@ -897,6 +934,7 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
             if (dma_data->dst_addr_lo == 0x3022C || !rasterizer) {
                 break;
             }
+            rasterizer->BeginAsyncCompute();
             if (dma_data->src_sel == DmaDataSrc::Data && dma_data->dst_sel == DmaDataDst::Gds) {
                 rasterizer->InlineData(dma_data->dst_addr_lo, &dma_data->data, sizeof(u32), true);
             } else if ((dma_data->src_sel == DmaDataSrc::Memory ||
@@ -924,6 +962,7 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
                 UNREACHABLE_MSG("WriteData src_sel = {}, dst_sel = {}",
                                 u32(dma_data->src_sel.Value()), u32(dma_data->dst_sel.Value()));
             }
+            rasterizer->EndAsyncCompute();
             break;
         }
         case PM4ItOpcode::AcquireMem: {
@@ -974,10 +1013,12 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
             }
             if (rasterizer && (cs_program.dispatch_initiator & 1)) {
                 const auto cmd_address = reinterpret_cast<const void*>(header);
+                rasterizer->BeginAsyncCompute();
                 rasterizer->ScopeMarkerBegin(
                     fmt::format("asc[{}]:{}:DispatchDirect", vqid, cmd_address));
                 rasterizer->DispatchDirect();
                 rasterizer->ScopeMarkerEnd();
+                rasterizer->EndAsyncCompute();
             }
             break;
         }
@@ -993,10 +1034,12 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
             }
             if (rasterizer && (cs_program.dispatch_initiator & 1)) {
                 const auto cmd_address = reinterpret_cast<const void*>(header);
+                rasterizer->BeginAsyncCompute();
                 rasterizer->ScopeMarkerBegin(
                     fmt::format("asc[{}]:{}:DispatchIndirect", vqid, cmd_address));
                 rasterizer->DispatchIndirect(ib_address, 0, size);
                 rasterizer->ScopeMarkerEnd();
+                rasterizer->EndAsyncCompute();
             }
             break;
         }
@@ -1016,6 +1059,9 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
             if (mem_semaphore->IsSignaling()) {
                 mem_semaphore->Signal();
             } else {
+                if (rasterizer) {
+                    rasterizer->SyncAsyncCompute();
+                }
                 while (!mem_semaphore->Signaled()) {
                     YIELD_ASC(vqid);
                 }
@@ -1026,6 +1072,10 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
         case PM4ItOpcode::WaitRegMem: {
             const auto* wait_reg_mem = reinterpret_cast<const PM4CmdWaitRegMem*>(header);
             ASSERT(wait_reg_mem->engine.Value() == PM4CmdWaitRegMem::Engine::Me);
+            if (rasterizer) {
+                // Dispatches after the wait depend on the work that released the label.
+                rasterizer->SyncAsyncCompute();
+            }
             while (!wait_reg_mem->Test(regs.reg_array)) {
                 YIELD_ASC(vqid);
             }
@@ -1033,6 +1083,9 @@ Liverpool::Task Liverpool::ProcessCompute(std::span<const u32> acb, u32 vqid) {
         }
         case PM4ItOpcode::ReleaseMem: {
             const auto* release_mem = reinterpret_cast<const PM4CmdReleaseMem*>(header);
+            if (rasterizer) {
+                rasterizer->SyncAsyncCompute();
+            }
             release_mem->SignalFence([pipe_id = queue.pipe_id] {
                 Platform::IrqC::Instance()->Signal(static_cast<Platform::InterruptId>(pipe_id));
             });
@@ -1098,7 +1151,7 @@ void Liverpool::SubmitGfx(std::span<const u32> dcb, std::span<const u32> ccb) {
         std::tie(dcb, ccb) = CopyCmdBuffers(dcb, ccb);
     }
 
-    auto task = ProcessGraphics(dcb, ccb);
+    auto task = ProcessGraphics(dcb, ccb, pm4_parser ? pm4_parser->Parse(dcb) : nullptr);
     {
         std::scoped_lock lock{queue.m_access};
         queue.submits.emplace(task.handle);
@@ -0,0 +1,56 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "video_core/amdgpu/pm4_cmds.h"
+#include "video_core/amdgpu/pm4_stream.h"
+
+namespace AmdGpu {
+
+static void DecodeStream(std::span<const u32> cmds, Pm4Stream& stream) {
+    stream.packets.reserve(cmds.size() / 4);
+    u32 offset = 0;
+    while (offset < cmds.size()) {
+        const auto* header = reinterpret_cast<const PM4Header*>(cmds.data() + offset);
+        if (header->type == 2) {
+            ++offset;
+            continue;
+        }
+        if (header->type != 3) {
+            // Leave malformed packets to the command processor so it can report them.
+            break;
+        }
+        const PM4ItOpcode opcode = header->type3.opcode;
+        if (opcode == PM4ItOpcode::Rewind) {
+            // Anything past a rewind may be written by the guest after submission.
+            break;
+        }
+        const u32 num_words = header->type3.NumWords() + 1;
+        if (offset + num_words > cmds.size()) {
+            break;
+        }
+        const bool is_empty_nop =
+            opcode == PM4ItOpcode::Nop &&
+            reinterpret_cast<const PM4CmdNop*>(header)->header.count.Value() == 0;
+        if (!is_empty_nop) {
+            stream.packets.push_back({offset, num_words, opcode});
+        }
+        offset += num_words;
+    }
+    stream.parsed_words = offset;
+}
+
+Pm4Parser::Pm4Parser() : worker{1, "shadPS4:GpuCommandParser"} {}
+
+Pm4Parser::~Pm4Parser() = default;
+
+std::shared_ptr<Pm4Stream> Pm4Parser::Parse(std::span<const u32> cmds) {
+    auto stream = std::make_shared<Pm4Stream>();
+    worker.QueueWork([cmds, stream] {
+        DecodeStream(cmds, *stream);
+        stream->ready.store(true, std::memory_order_release);
+        stream->ready.notify_all();
+    });
+    return stream;
+}
+
+} // namespace AmdGpu
@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "common/thread_worker.h"
+#include "common/types.h"
+#include "video_core/amdgpu/pm4_opcodes.h"
+
+namespace AmdGpu {
+
+/// Location of a single type 3 packet inside a command buffer.
+struct Pm4Packet {
+    u32 offset;
+    u32 num_words;
+    PM4ItOpcode opcode;
+};
+
+/**
+ * Compact packet stream of a command buffer produced by the pre-parser.
+ * Only packets that carry work are recorded, padding and empty NOPs are dropped.
+ * Packets past parsed_words must be decoded inline as their contents may still change after
+ * submission (e.g. behind a rewind packet).
+ */
+struct Pm4Stream {
+    std::vector<Pm4Packet> packets;
+    u32 parsed_words{};
+    std::atomic<bool> ready{};
+
+    /// Blocks until the parser thread has finished with this stream.
+    void Wait() const {
+        ready.wait(false, std::memory_order_acquire);
+    }
+};
+
+/// Decodes the framing of submitted command buffers ahead of the command processor.
+class Pm4Parser {
+public:
+    explicit Pm4Parser();
+    ~Pm4Parser();
+
+    /// Queues the command buffer for pre-parsing and returns the stream being filled.
+    std::shared_ptr<Pm4Stream> Parse(std::span<const u32> cmds);
+
+private:
+    Common::ThreadWorker worker;
+};
+
+} // namespace AmdGpu
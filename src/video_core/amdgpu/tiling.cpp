@@ -518,10 +518,22 @@ u32 GetPipeCount(PipeConfig pipe_cfg) {
     switch (pipe_cfg) {
     case PipeConfig::P2:
         return 2;
+    case PipeConfig::P4_8x16:
+    case PipeConfig::P4_16x16:
+    case PipeConfig::P4_16x32:
+    case PipeConfig::P4_32x32:
+        return 4;
+    case PipeConfig::P8_16x16_8x16:
+    case PipeConfig::P8_16x32_8x16:
     case PipeConfig::P8_32x32_8x16:
+    case PipeConfig::P8_16x32_16x16:
     case PipeConfig::P8_32x32_16x16:
+    case PipeConfig::P8_32x32_16x32:
+    case PipeConfig::P8_32x64_32x32:
         return 8;
     case PipeConfig::P16_32x32_8x16:
+    case PipeConfig::P16_32x32_16x16:
+    case PipeConfig::P16:
         return 16;
     default:
         UNREACHABLE_MSG("Unknown pipe config = {}", u32(pipe_cfg));
@@ -3,6 +3,7 @@
 
 #include "common/alignment.h"
 #include "common/assert.h"
+#include "core/debug_state.h"
 #include "video_core/buffer_cache/buffer.h"
 #include "video_core/renderer_vulkan/liverpool_to_vk.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
@@ -69,16 +70,18 @@ UniqueBuffer::~UniqueBuffer() {
 }
 
 void UniqueBuffer::Create(const vk::BufferCreateInfo& buffer_ci, MemoryUsage usage,
-                          VmaAllocationInfo* out_alloc_info) {
+                          VmaAllocationInfo* out_alloc_info, VmaPool pool) {
     const bool with_bda = bool(buffer_ci.usage & vk::BufferUsageFlagBits::eShaderDeviceAddress);
-    const VmaAllocationCreateFlags bda_flag =
-        with_bda ? VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT : 0;
-    const VmaAllocationCreateInfo alloc_ci = {
-        .flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT | bda_flag | MemoryUsageVmaFlags(usage),
+    const bool is_dedicated = with_bda && buffer_ci.size > DedicatedAllocationThreshold;
+    const VmaAllocationCreateFlags dedicated_flag =
+        is_dedicated ? VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT : 0;
+    VmaAllocationCreateInfo alloc_ci = {
+        .flags = VMA_ALLOCATION_CREATE_WITHIN_BUDGET_BIT | dedicated_flag |
+                 MemoryUsageVmaFlags(usage),
         .usage = MemoryUsageVma(usage),
         .requiredFlags = 0,
         .preferredFlags = MemoryUsagePreferredVmaFlags(usage),
-        .pool = VK_NULL_HANDLE,
+        .pool = is_dedicated ? VK_NULL_HANDLE : pool,
         .pUserData = nullptr,
     };
 
@@ -86,6 +89,12 @@ void UniqueBuffer::Create(const vk::BufferCreateInfo& buffer_ci, MemoryUsage usa
     VkBuffer unsafe_buffer{};
     VkResult result = vmaCreateBuffer(allocator, &buffer_ci_unsafe, &alloc_ci, &unsafe_buffer,
                                       &allocation, out_alloc_info);
+    if (result != VK_SUCCESS && alloc_ci.pool) {
+        // The pool is full or its memory type does not fit, fall back to the default pools.
+        alloc_ci.pool = VK_NULL_HANDLE;
+        result = vmaCreateBuffer(allocator, &buffer_ci_unsafe, &alloc_ci, &unsafe_buffer,
+                                 &allocation, out_alloc_info);
+    }
     ASSERT_MSG(result == VK_SUCCESS, "Failed allocating buffer with error {}",
                vk::to_string(vk::Result{result}));
     buffer = vk::Buffer{unsafe_buffer};
@@ -104,13 +113,24 @@ Buffer::Buffer(const Vulkan::Instance& instance_, Vulkan::Scheduler& scheduler_,
                VAddr cpu_addr_, vk::BufferUsageFlags flags, u64 size_bytes_)
     : cpu_addr{cpu_addr_}, size_bytes{size_bytes_}, instance{&instance_}, scheduler{&scheduler_},
       usage{usage_}, buffer{instance->GetDevice(), instance->GetAllocator()} {
-    // Create buffer object.
+    // Create buffer object. Device local buffers may also be written by the transfer queue.
+    const bool is_shared = usage == MemoryUsage::DeviceLocal && scheduler->GetTransferScheduler();
+    const std::array<u32, 2> queue_family_indices = {
+        instance->GetGraphicsQueueFamilyIndex(),
+        is_shared ? instance->GetTransferQueueFamilyIndex() : 0U,
+    };
     const vk::BufferCreateInfo buffer_ci = {
         .size = size_bytes,
         .usage = flags,
+        .sharingMode = is_shared ? vk::SharingMode::eConcurrent : vk::SharingMode::eExclusive,
+        .queueFamilyIndexCount = is_shared ? static_cast<u32>(queue_family_indices.size()) : 0U,
+        .pQueueFamilyIndices = is_shared ? queue_family_indices.data() : nullptr,
     };
+    const bool is_small = usage == MemoryUsage::DeviceLocal &&
+                          size_bytes <= DedicatedAllocationThreshold;
     VmaAllocationInfo alloc_info{};
-    buffer.Create(buffer_ci, usage, &alloc_info);
+    buffer.Create(buffer_ci, usage, &alloc_info,
+                  is_small ? instance->GetSmallBufferPool() : VK_NULL_HANDLE);
 
     const auto device = instance->GetDevice();
     Vulkan::SetObjectName(device, Handle(), "Buffer {:#x}:{:#x}", cpu_addr, size_bytes);
@@ -164,8 +184,8 @@ constexpr u64 WATCHES_INITIAL_RESERVE = 0x4000;
 constexpr u64 WATCHES_RESERVE_CHUNK = 0x1000;
 
 StreamBuffer::StreamBuffer(const Vulkan::Instance& instance, Vulkan::Scheduler& scheduler,
-                           MemoryUsage usage, u64 size_bytes)
-    : Buffer{instance, scheduler, usage, 0, AllFlags, size_bytes} {
+                           MemoryUsage usage, u64 size_bytes, vk::BufferUsageFlags flags)
+    : Buffer{instance, scheduler, usage, 0, flags, size_bytes} {
     ReserveWatches(current_watches, WATCHES_INITIAL_RESERVE);
     ReserveWatches(previous_watches, WATCHES_INITIAL_RESERVE);
     const auto device = instance.GetDevice();
@@ -209,6 +229,21 @@ std::pair<u8*, u64> StreamBuffer::Map(u64 size, u64 alignment, bool allow_wait)
 }
 
 void StreamBuffer::Commit() {
+    switch (usage) {
+    case MemoryUsage::Stream:
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::StreamBytes, mapped_size);
+        break;
+    case MemoryUsage::Upload:
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::StagingBytes,
+                                         mapped_size);
+        break;
+    case MemoryUsage::Download:
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::ReadbackBytes,
+                                         mapped_size);
+        break;
+    default:
+        break;
+    }
     if (!is_coherent) {
         if (usage == MemoryUsage::Download) {
             vmaInvalidateAllocation(instance->GetAllocator(), buffer.allocation, offset,
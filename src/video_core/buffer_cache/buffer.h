@@ -18,6 +18,7 @@ class Scheduler;
 
 VK_DEFINE_HANDLE(VmaAllocation)
 VK_DEFINE_HANDLE(VmaAllocator)
+VK_DEFINE_HANDLE(VmaPool)
 
 struct VmaAllocationInfo;
 
@@ -31,13 +32,19 @@ enum class MemoryUsage {
     Stream,      ///< Requests device local host visible buffer, falling back host memory.
 };
 
+// Buffers up to this size are sub-allocated from shared memory blocks instead of getting their
+// own allocation, guest ranges of a few pages are created and joined often.
+constexpr u64 DedicatedAllocationThreshold = 4_MB;
+
 constexpr vk::BufferUsageFlags ReadFlags =
     vk::BufferUsageFlagBits::eTransferSrc | vk::BufferUsageFlagBits::eUniformBuffer |
     vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eVertexBuffer |
     vk::BufferUsageFlagBits::eIndirectBuffer;
 
+// Every buffer has an address so it can be bound through a descriptor buffer.
 constexpr vk::BufferUsageFlags AllFlags =
-    ReadFlags | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eStorageBuffer;
+    ReadFlags | vk::BufferUsageFlagBits::eTransferDst | vk::BufferUsageFlagBits::eStorageBuffer |
+    vk::BufferUsageFlagBits::eShaderDeviceAddress;
 
 struct UniqueBuffer {
     explicit UniqueBuffer(vk::Device device, VmaAllocator allocator);
@@ -58,7 +65,7 @@ struct UniqueBuffer {
     }
 
     void Create(const vk::BufferCreateInfo& image_ci, MemoryUsage usage,
-                VmaAllocationInfo* out_alloc_info);
+                VmaAllocationInfo* out_alloc_info, VmaPool pool = VK_NULL_HANDLE);
 
     operator vk::Buffer() const {
         return buffer;
@@ -154,6 +161,7 @@ public:
     bool is_picked{};
     bool is_coherent{};
     bool is_deleted{};
+    bool is_fresh{};
     int stream_score = 0;
     size_t size_bytes = 0;
     u64 lru_id = 0;
@@ -171,7 +179,8 @@ public:
 class StreamBuffer : public Buffer {
 public:
     explicit StreamBuffer(const Vulkan::Instance& instance, Vulkan::Scheduler& scheduler,
-                          MemoryUsage usage, u64 size_bytes_);
+                          MemoryUsage usage, u64 size_bytes_,
+                          vk::BufferUsageFlags flags = AllFlags);
 
     /// Reserves a region of memory from the stream buffer.
     std::pair<u8*, u64> Map(u64 size, u64 alignment = 0, bool allow_wait = true);
@@ -2,11 +2,17 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <chrono>
 #include <mutex>
+#include <thread>
+#include <xxhash.h>
 #include "common/alignment.h"
+#include "common/config.h"
 #include "common/debug.h"
 #include "common/scope_exit.h"
+#include "common/thread_worker.h"
 #include "common/types.h"
+#include "core/debug_state.h"
 #include "core/memory.h"
 #include "video_core/amdgpu/liverpool.h"
 #include "video_core/buffer_cache/buffer_cache.h"
@@ -17,6 +23,7 @@
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/renderer_vulkan/vk_shader_util.h"
+#include "video_core/renderer_vulkan/vk_transfer_scheduler.h"
 #include "video_core/texture_cache/texture_cache.h"
 
 namespace VideoCore {
@@ -27,6 +34,10 @@ static constexpr size_t UboStreamBufferSize = 64_MB;
 static constexpr size_t DownloadBufferSize = 128_MB;
 static constexpr size_t DeviceBufferSize = 128_MB;
 static constexpr size_t MaxPageFaults = 1024;
+static constexpr size_t AsyncUploadThreshold = 256_KB;
+static constexpr size_t MaxInlineWriteRun = 64_KB;
+static constexpr size_t ParallelCopyThreshold = 4_MB;
+static constexpr u32 MaxCopyWorkers = 4;
 
 BufferCache::BufferCache(const Vulkan::Instance& instance_, Vulkan::Scheduler& scheduler_,
                          AmdGpu::Liverpool* liverpool_, TextureCache& texture_cache_,
@@ -48,6 +59,15 @@ BufferCache::BufferCache(const Vulkan::Instance& instance_, Vulkan::Scheduler& s
 
     memory_tracker = std::make_unique<MemoryTracker>(tracker);
 
+    if (const u32 num_workers = std::min(std::thread::hardware_concurrency() / 4, MaxCopyWorkers);
+        num_workers > 1) {
+        copy_worker = std::make_unique<Common::ThreadWorker>(num_workers - 1, "StagingCopy");
+    }
+
+    if (Config::isAsyncTransferEnabled()) {
+        transfer_scheduler = scheduler.EnableAsyncTransfer();
+    }
+
     std::memset(gds_buffer.mapped_data.data(), 0, DataShareBufferSize);
 
     // Ensure the first slot is used for the null buffer
@@ -164,13 +184,66 @@ void BufferCache::InvalidateMemory(VAddr device_addr, u64 size) {
 
 void BufferCache::ReadMemory(VAddr device_addr, u64 size, bool is_write) {
     liverpool->SendCommand<true>([this, device_addr, size, is_write] {
+        if (Config::GetSnapshot().predictive_readbacks) {
+            if (pending_readbacks.Intersects(device_addr, size)) {
+                // The data is already being downloaded, wait for the copy instead of a new one.
+                scheduler.Wait(pending_readback_tick);
+            }
+            PredictReadback(device_addr, size);
+        }
         Buffer& buffer = slot_buffers[FindBuffer(device_addr, size)];
         DownloadBufferMemory<false>(buffer, device_addr, size, is_write);
     });
 }
 
+void BufferCache::PredictReadback(VAddr device_addr, u64 size) {
+    const u64 page_end = Common::DivCeil(device_addr + size, TRACKER_BYTES_PER_PAGE);
+    for (u64 page = device_addr >> TRACKER_PAGE_BITS; page < page_end; ++page) {
+        if (predicted_readbacks.size() >= MAX_PREDICTED_READBACKS &&
+            !predicted_readbacks.contains(page)) {
+            return;
+        }
+        predicted_readbacks[page] = readback_submit;
+    }
+}
+
+void BufferCache::DownloadPredictedReadbacks() {
+    ++readback_submit;
+    if (predicted_readbacks.empty()) {
+        return;
+    }
+    // Pages are dropped after a while so that data the CPU stopped reading is no longer copied.
+    // Pages that are still read fault once more and are predicted again.
+    std::erase_if(predicted_readbacks, [this](const auto& entry) {
+        return readback_submit - entry.second > READBACK_PREDICTION_SUBMITS;
+    });
+    bool has_downloads = false;
+    for (const auto& [page, last_read] : predicted_readbacks) {
+        const VAddr page_addr = page << TRACKER_PAGE_BITS;
+        if (!gpu_modified_ranges.Intersects(page_addr, TRACKER_BYTES_PER_PAGE)) {
+            continue;
+        }
+        ForEachBufferInRange(page_addr, TRACKER_BYTES_PER_PAGE, [&](BufferId, Buffer& buffer) {
+            const VAddr start = std::max(page_addr, buffer.CpuAddr());
+            const VAddr end =
+                std::min(page_addr + TRACKER_BYTES_PER_PAGE, buffer.CpuAddr() + buffer.SizeBytes());
+            DownloadBufferMemory<true>(buffer, start, end - start, false);
+        });
+        pending_readbacks.Add(page_addr, TRACKER_BYTES_PER_PAGE);
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::PredictedReadbacks);
+        has_downloads = true;
+    }
+    if (!has_downloads) {
+        return;
+    }
+    // Runs after the write backs of the downloads, which are deferred to the same tick.
+    pending_readback_tick = scheduler.CurrentTick();
+    scheduler.DeferOperation([this] { pending_readbacks.Clear(); });
+}
+
 template <bool async>
 void BufferCache::DownloadBufferMemory(Buffer& buffer, VAddr device_addr, u64 size, bool is_write) {
+    FlushInlineWrites();
     boost::container::small_vector<vk::BufferCopy, 1> copies;
     u64 total_size_bytes = 0;
     memory_tracker->ForEachDownloadRange<false>(
@@ -195,6 +268,7 @@ void BufferCache::DownloadBufferMemory(Buffer& buffer, VAddr device_addr, u64 si
     if (total_size_bytes == 0) {
         return;
     }
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::BufferDownloads);
     const auto [download, offset] = download_buffer.Map(total_size_bytes);
     for (auto& copy : copies) {
         // Modify copies to have the staging offset in mind
@@ -204,14 +278,19 @@ void BufferCache::DownloadBufferMemory(Buffer& buffer, VAddr device_addr, u64 si
     scheduler.EndRendering();
     const auto cmdbuf = scheduler.CommandBuffer();
     cmdbuf.copyBuffer(buffer.buffer, download_buffer.Handle(), copies);
-    const auto write_data = [&]() {
+    const auto write_data = [this, copies, buffer_addr = buffer.CpuAddr(), download, offset,
+                             device_addr, size, is_write] {
         auto* memory = Core::Memory::Instance();
         for (const auto& copy : copies) {
-            const VAddr copy_device_addr = buffer.CpuAddr() + copy.srcOffset;
+            const VAddr copy_device_addr = buffer_addr + copy.srcOffset;
             const u64 dst_offset = copy.dstOffset - offset;
             memory->TryWriteBacking(std::bit_cast<u8*>(copy_device_addr), download + dst_offset,
                                     copy.size);
         }
+        if (async && gpu_modified_ranges.Intersects(device_addr, size)) {
+            // The GPU wrote the range again after the copy, it stays GPU modified.
+            return;
+        }
         memory_tracker->UnmarkRegionAsGpuModified(device_addr, size);
         if (is_write) {
             memory_tracker->MarkRegionAsCpuModified(device_addr, size);
@@ -220,28 +299,54 @@ void BufferCache::DownloadBufferMemory(Buffer& buffer, VAddr device_addr, u64 si
     if constexpr (async) {
         scheduler.DeferOperation(write_data);
     } else {
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::DownloadStalls);
+        const auto start = std::chrono::steady_clock::now();
         scheduler.Finish();
         write_data();
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        DebugState.AddStall(
+            DebugStateType::StallCause::BufferDownload,
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
     }
 }
 
 void BufferCache::BindVertexBuffers(const Vulkan::GraphicsPipeline& pipeline) {
+    Vulkan::VertexBindings vertex_bindings;
+    ObtainVertexBuffers(pipeline, vertex_bindings);
+    BindVertexBuffers(vertex_bindings);
+}
+
+void BufferCache::ObtainVertexBuffers(const Vulkan::GraphicsPipeline& pipeline,
+                                      Vulkan::VertexBindings& vertex_bindings) {
     const auto& regs = liverpool->regs;
-    Vulkan::VertexInputs<vk::VertexInputAttributeDescription2EXT> attributes;
-    Vulkan::VertexInputs<vk::VertexInputBindingDescription2EXT> bindings;
+    auto& attributes = vertex_bindings.attributes;
+    auto& bindings = vertex_bindings.bindings;
     Vulkan::VertexInputs<vk::VertexInputBindingDivisorDescriptionEXT> divisors;
     Vulkan::VertexInputs<AmdGpu::Buffer> guest_buffers;
     pipeline.GetVertexInputs(attributes, bindings, divisors, guest_buffers,
                              regs.vgt_instance_step_rate_0, regs.vgt_instance_step_rate_1);
 
-    if (instance.IsVertexInputDynamicState()) {
-        // Update current vertex inputs.
-        const auto cmdbuf = scheduler.CommandBuffer();
-        cmdbuf.setVertexInputEXT(bindings, attributes);
+    XXH3_state_t state;
+    XXH3_64bits_reset(&state);
+    const auto hash_value = [&state](const auto value) {
+        XXH3_64bits_update(&state, &value, sizeof(value));
+    };
+    for (const auto& attribute : attributes) {
+        hash_value(attribute.location);
+        hash_value(attribute.binding);
+        hash_value(attribute.format);
+        hash_value(attribute.offset);
+    }
+    for (const auto& binding : bindings) {
+        hash_value(binding.binding);
+        hash_value(binding.stride);
+        hash_value(binding.inputRate);
+        hash_value(binding.divisor);
     }
 
     if (bindings.empty()) {
         // If there are no bindings, there is nothing further to do.
+        vertex_bindings.hash = XXH3_64bits_digest(&state);
         return;
     }
 
@@ -289,11 +394,7 @@ void BufferCache::BindVertexBuffers(const Vulkan::GraphicsPipeline& pipeline) {
         range.offset = offset;
     }
 
-    // Bind vertex buffers
-    Vulkan::VertexInputs<vk::Buffer> host_buffers;
-    Vulkan::VertexInputs<vk::DeviceSize> host_offsets;
-    Vulkan::VertexInputs<vk::DeviceSize> host_sizes;
-    Vulkan::VertexInputs<vk::DeviceSize> host_strides;
+    // Resolve host vertex buffers
     const auto null_buffer =
         instance.IsNullDescriptorSupported() ? VK_NULL_HANDLE : GetBuffer(NULL_BUFFER_ID).Handle();
     for (const auto& buffer : guest_buffers) {
@@ -304,28 +405,55 @@ void BufferCache::BindVertexBuffers(const Vulkan::GraphicsPipeline& pipeline) {
                            buffer.base_address < range.end_address;
                 });
             ASSERT(host_buffer_info != ranges_merged.cend());
-            host_buffers.emplace_back(host_buffer_info->vk_buffer);
-            host_offsets.push_back(host_buffer_info->offset + buffer.base_address -
-                                   host_buffer_info->base_address);
+            vertex_bindings.buffers.emplace_back(host_buffer_info->vk_buffer);
+            vertex_bindings.offsets.push_back(host_buffer_info->offset + buffer.base_address -
+                                              host_buffer_info->base_address);
         } else {
-            host_buffers.emplace_back(null_buffer);
-            host_offsets.push_back(0);
+            vertex_bindings.buffers.emplace_back(null_buffer);
+            vertex_bindings.offsets.push_back(0);
         }
-        host_sizes.push_back(buffer.GetSize());
-        host_strides.push_back(buffer.GetStride());
+        vertex_bindings.sizes.push_back(buffer.GetSize());
+        vertex_bindings.strides.push_back(buffer.GetStride());
     }
+    XXH3_64bits_update(&state, vertex_bindings.buffers.data(),
+                       vertex_bindings.buffers.size() * sizeof(vk::Buffer));
+    XXH3_64bits_update(&state, vertex_bindings.offsets.data(),
+                       vertex_bindings.offsets.size() * sizeof(vk::DeviceSize));
+    XXH3_64bits_update(&state, vertex_bindings.sizes.data(),
+                       vertex_bindings.sizes.size() * sizeof(vk::DeviceSize));
+    XXH3_64bits_update(&state, vertex_bindings.strides.data(),
+                       vertex_bindings.strides.size() * sizeof(vk::DeviceSize));
+    vertex_bindings.hash = XXH3_64bits_digest(&state);
+}
 
+void BufferCache::BindVertexBuffers(const Vulkan::VertexBindings& vertex_bindings) {
     const auto cmdbuf = scheduler.CommandBuffer();
-    const auto num_buffers = guest_buffers.size();
     if (instance.IsVertexInputDynamicState()) {
-        cmdbuf.bindVertexBuffers(0, num_buffers, host_buffers.data(), host_offsets.data());
+        // Update current vertex inputs.
+        cmdbuf.setVertexInputEXT(vertex_bindings.bindings, vertex_bindings.attributes);
+    }
+
+    const auto num_buffers = vertex_bindings.buffers.size();
+    if (num_buffers == 0) {
+        return;
+    }
+    if (instance.IsVertexInputDynamicState()) {
+        cmdbuf.bindVertexBuffers(0, num_buffers, vertex_bindings.buffers.data(),
+                                 vertex_bindings.offsets.data());
     } else {
-        cmdbuf.bindVertexBuffers2(0, num_buffers, host_buffers.data(), host_offsets.data(),
-                                  host_sizes.data(), host_strides.data());
+        cmdbuf.bindVertexBuffers2(0, num_buffers, vertex_bindings.buffers.data(),
+                                  vertex_bindings.offsets.data(), vertex_bindings.sizes.data(),
+                                  vertex_bindings.strides.data());
     }
 }
 
 void BufferCache::BindIndexBuffer(u32 index_offset) {
+    const auto [buffer, offset, index_type] = ObtainIndexBuffer(index_offset);
+    const auto cmdbuf = scheduler.CommandBuffer();
+    cmdbuf.bindIndexBuffer(buffer, offset, index_type);
+}
+
+BufferCache::IndexBinding BufferCache::ObtainIndexBuffer(u32 index_offset) {
     const auto& regs = liverpool->regs;
 
     // Figure out index type and size.
@@ -335,11 +463,10 @@ void BufferCache::BindIndexBuffer(u32 index_offset) {
     const VAddr index_address =
         regs.index_base_address.Address<VAddr>() + index_offset * index_size;
 
-    // Bind index buffer.
+    // Obtain index buffer.
     const u32 index_buffer_size = regs.num_indices * index_size;
     const auto [vk_buffer, offset] = ObtainBuffer(index_address, index_buffer_size, false);
-    const auto cmdbuf = scheduler.CommandBuffer();
-    cmdbuf.bindIndexBuffer(vk_buffer->Handle(), offset, index_type);
+    return {vk_buffer->Handle(), offset, index_type};
 }
 
 void BufferCache::InlineData(VAddr address, const void* value, u32 num_bytes, bool is_gds) {
@@ -360,10 +487,36 @@ void BufferCache::InlineData(VAddr address, const void* value, u32 num_bytes, bo
         const BufferId buffer_id = FindBuffer(address, num_bytes);
         return &slot_buffers[buffer_id];
     }();
-    InlineDataBuffer(*buffer, address, value, num_bytes);
+    CombineInlineWrite(*buffer, address, value, num_bytes);
+}
+
+void BufferCache::CombineInlineWrite(Buffer& buffer, VAddr address, const void* value,
+                                     u32 num_bytes) {
+    // Engines emit runs of dword writes to consecutive addresses, a run is recorded as a single
+    // update between one pair of barriers.
+    if (inline_write_buffer != &buffer ||
+        inline_write_address + inline_write_data.size() != address ||
+        inline_write_data.size() + num_bytes > MaxInlineWriteRun) {
+        FlushInlineWrites();
+        inline_write_buffer = &buffer;
+        inline_write_address = address;
+    }
+    const auto* bytes = static_cast<const u8*>(value);
+    inline_write_data.insert(inline_write_data.end(), bytes, bytes + num_bytes);
+}
+
+void BufferCache::FlushInlineWrites() {
+    if (!inline_write_buffer) {
+        return;
+    }
+    Buffer& buffer = *std::exchange(inline_write_buffer, nullptr);
+    InlineDataBuffer(buffer, inline_write_address, inline_write_data.data(),
+                     static_cast<u32>(inline_write_data.size()));
+    inline_write_data.clear();
 }
 
 void BufferCache::CopyBuffer(VAddr dst, VAddr src, u32 num_bytes, bool dst_gds, bool src_gds) {
+    FlushInlineWrites();
     if (!dst_gds && !IsRegionGpuModified(dst, num_bytes)) {
         if (!src_gds && !IsRegionGpuModified(src, num_bytes) &&
             !texture_cache.FindImageFromRange(src, num_bytes)) {
@@ -390,6 +543,13 @@ void BufferCache::CopyBuffer(VAddr dst, VAddr src, u32 num_bytes, bool dst_gds,
         }
         const auto buffer_id = FindBuffer(dst, num_bytes);
         auto& buffer = slot_buffers[buffer_id];
+        // Pages fully covered by the copy are overwritten, so pending CPU writes are only
+        // uploaded for the partially covered pages at its edges.
+        const VAddr inner_begin = Common::AlignUp(dst, TRACKER_BYTES_PER_PAGE);
+        const VAddr inner_end = Common::AlignDown(dst + num_bytes, TRACKER_BYTES_PER_PAGE);
+        if (inner_begin < inner_end) {
+            memory_tracker->MarkRegionAsGpuOverwritten(inner_begin, inner_end - inner_begin);
+        }
         SynchronizeBuffer(buffer, dst, num_bytes, true, true);
         gpu_modified_ranges.Add(dst, num_bytes);
         return buffer;
@@ -473,6 +633,7 @@ std::pair<Buffer*, u32> BufferCache::ObtainBuffer(VAddr device_addr, u32 size, b
 }
 
 std::pair<Buffer*, u32> BufferCache::ObtainBufferForImage(VAddr gpu_addr, u32 size) {
+    FlushInlineWrites();
     // Check if any buffer contains the full requested range.
     const BufferId buffer_id = page_table[gpu_addr >> CACHING_PAGEBITS].buffer_id;
     if (buffer_id) {
@@ -487,14 +648,27 @@ std::pair<Buffer*, u32> BufferCache::ObtainBufferForImage(VAddr gpu_addr, u32 si
     }
     // In all other cases, just do a CPU copy to the staging buffer.
     const auto [data, offset] = staging_buffer.Map(size, 16);
-    memory->CopySparseMemory(gpu_addr, data, size);
+    CopyToStaging(gpu_addr, data, size);
     staging_buffer.Commit();
     return {&staging_buffer, offset};
 }
 
 bool BufferCache::IsRegionRegistered(VAddr addr, size_t size) {
-    // Check if we are missing some edge case here
-    return buffer_ranges.Intersects(addr, size);
+    // This is called by the fault handlers concurrently with the GPU thread, so only consult the
+    // page table which is safe to read without locks.
+    const u64 page_end = Common::DivCeil(addr + size, CACHING_PAGESIZE);
+    for (u64 page = addr >> CACHING_PAGEBITS; page < page_end;) {
+        const PageData* const entry = page_table.find(page);
+        if (!entry) {
+            page = PageTable::next_table_page(page);
+            continue;
+        }
+        if (entry->buffer_id.load(std::memory_order_acquire)) {
+            return true;
+        }
+        ++page;
+    }
+    return false;
 }
 
 bool BufferCache::IsRegionCpuModified(VAddr addr, size_t size) {
@@ -651,17 +825,20 @@ void BufferCache::JoinOverlap(BufferId new_buffer_id, BufferId overlap_id,
 }
 
 BufferId BufferCache::CreateBuffer(VAddr device_addr, u32 wanted_size) {
+    // Pending writes must reach the overlapped buffers before they are joined.
+    FlushInlineWrites();
     const VAddr device_addr_end = Common::AlignUp(device_addr + wanted_size, CACHING_PAGESIZE);
     device_addr = Common::AlignDown(device_addr, CACHING_PAGESIZE);
     wanted_size = static_cast<u32>(device_addr_end - device_addr);
     const OverlapResult overlap = ResolveOverlaps(device_addr, wanted_size);
     const u32 size = static_cast<u32>(overlap.end - overlap.begin);
-    const BufferId new_buffer_id = [&] {
-        std::scoped_lock lk{slot_buffers_mutex};
-        return slot_buffers.insert(instance, scheduler, MemoryUsage::DeviceLocal, overlap.begin,
-                                   AllFlags | vk::BufferUsageFlagBits::eShaderDeviceAddress, size);
-    }();
+    const BufferId new_buffer_id =
+        slot_buffers.insert(instance, scheduler, MemoryUsage::DeviceLocal, overlap.begin, AllFlags,
+                            size);
     auto& new_buffer = slot_buffers[new_buffer_id];
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::BuffersCreated);
+    // Until a command references it, the initial upload may be done ahead of the graphics queue.
+    new_buffer.is_fresh = overlap.ids.empty();
     const size_t size_bytes = new_buffer.SizeBytes();
     const auto cmdbuf = scheduler.CommandBuffer();
     for (const BufferId overlap_id : overlap.ids) {
@@ -674,11 +851,15 @@ BufferId BufferCache::CreateBuffer(VAddr device_addr, u32 wanted_size) {
 void BufferCache::ProcessFaultBuffer() {
     // Run fault processing shader
     const auto [mapped, offset] = download_buffer.Map(MaxPageFaults * sizeof(u64));
+    // Faults are only reported by guest shaders.
+    constexpr auto shader_stages = vk::PipelineStageFlagBits2::ePreRasterizationShaders |
+                                   vk::PipelineStageFlagBits2::eFragmentShader |
+                                   vk::PipelineStageFlagBits2::eComputeShader;
     vk::BufferMemoryBarrier2 fault_buffer_barrier{
-        .srcStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+        .srcStageMask = shader_stages,
         .srcAccessMask = vk::AccessFlagBits2::eShaderWrite,
         .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
-        .dstAccessMask = vk::AccessFlagBits2::eShaderRead,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite,
         .buffer = fault_buffer.Handle(),
         .offset = 0,
         .size = FAULT_BUFFER_SIZE,
@@ -737,21 +918,12 @@ void BufferCache::ProcessFaultBuffer() {
     constexpr u32 num_workgroups = Common::DivCeil(num_threads, 64u);
     cmdbuf.dispatch(num_workgroups, 1, 1);
 
-    // Reset fault buffer
-    const vk::BufferMemoryBarrier2 reset_pre_barrier = {
+    // The shader cleared the words it processed, later shaders may report new faults.
+    const vk::BufferMemoryBarrier2 reset_barrier = {
         .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
-        .srcAccessMask = vk::AccessFlagBits2::eShaderRead,
-        .dstStageMask = vk::PipelineStageFlagBits2::eTransfer,
-        .dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
-        .buffer = fault_buffer.Handle(),
-        .offset = 0,
-        .size = FAULT_BUFFER_SIZE,
-    };
-    const vk::BufferMemoryBarrier2 reset_post_barrier = {
-        .srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
-        .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
-        .dstStageMask = vk::PipelineStageFlagBits2::eAllCommands,
-        .dstAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
+        .srcAccessMask = vk::AccessFlagBits2::eShaderWrite,
+        .dstStageMask = shader_stages,
+        .dstAccessMask = vk::AccessFlagBits2::eShaderRead | vk::AccessFlagBits2::eShaderWrite,
         .buffer = fault_buffer.Handle(),
         .offset = 0,
         .size = FAULT_BUFFER_SIZE,
@@ -759,13 +931,7 @@ void BufferCache::ProcessFaultBuffer() {
     cmdbuf.pipelineBarrier2(vk::DependencyInfo{
         .dependencyFlags = vk::DependencyFlagBits::eByRegion,
         .bufferMemoryBarrierCount = 1,
-        .pBufferMemoryBarriers = &reset_pre_barrier,
-    });
-    cmdbuf.fillBuffer(fault_buffer.buffer, 0, FAULT_BUFFER_SIZE, 0);
-    cmdbuf.pipelineBarrier2(vk::DependencyInfo{
-        .dependencyFlags = vk::DependencyFlagBits::eByRegion,
-        .bufferMemoryBarrierCount = 1,
-        .pBufferMemoryBarriers = &reset_post_barrier,
+        .pBufferMemoryBarriers = &reset_barrier,
     });
 
     // Defer creating buffers
@@ -813,13 +979,15 @@ void BufferCache::ChangeRegister(BufferId buffer_id) {
     const u64 size_pages = page_end - page_begin;
     for (u64 page = page_begin; page != page_end; ++page) {
         if constexpr (insert) {
-            page_table[page].buffer_id = buffer_id;
+            page_table[page].buffer_id.store(buffer_id, std::memory_order_release);
         } else {
-            page_table[page].buffer_id = BufferId{};
+            page_table[page].buffer_id.store(BufferId{}, std::memory_order_release);
         }
     }
     if constexpr (insert) {
         total_used_memory += Common::AlignUp(size, CACHING_PAGESIZE);
+        memory->TrackHostMirror(Core::HostMirror::BufferCache,
+                                Common::AlignUp(size, CACHING_PAGESIZE));
         buffer.SetLRUId(lru_cache.Insert(buffer_id, gc_tick));
         boost::container::small_vector<vk::DeviceAddress, 128> bda_addrs;
         bda_addrs.reserve(size_pages);
@@ -829,13 +997,13 @@ void BufferCache::ChangeRegister(BufferId buffer_id) {
         }
         WriteDataBuffer(bda_pagetable_buffer, page_begin * sizeof(vk::DeviceAddress),
                         bda_addrs.data(), bda_addrs.size() * sizeof(vk::DeviceAddress));
-        buffer_ranges.Add(buffer.CpuAddr(), buffer.SizeBytes(), buffer_id);
     } else {
         total_used_memory -= Common::AlignUp(size, CACHING_PAGESIZE);
+        memory->TrackHostMirror(Core::HostMirror::BufferCache,
+                                -static_cast<s64>(Common::AlignUp(size, CACHING_PAGESIZE)));
         lru_cache.Free(buffer.LRUId());
         const u64 offset = bda_pagetable_buffer.Offset(page_begin * sizeof(vk::DeviceAddress));
         bda_pagetable_buffer.Fill(offset, size_pages * sizeof(vk::DeviceAddress), 0);
-        buffer_ranges.Subtract(buffer.CpuAddr(), buffer.SizeBytes());
     }
 }
 
@@ -845,15 +1013,31 @@ bool BufferCache::SynchronizeBuffer(Buffer& buffer, VAddr device_addr, u32 size,
     size_t total_size_bytes = 0;
     VAddr buffer_start = buffer.CpuAddr();
     vk::Buffer src_buffer = VK_NULL_HANDLE;
+    const bool is_fresh = std::exchange(buffer.is_fresh, false);
+    bool is_async = false;
     memory_tracker->ForEachUploadRange(
         device_addr, size, is_written,
         [&](u64 device_addr_out, u64 range_size) {
             copies.emplace_back(total_size_bytes, device_addr_out - buffer_start, range_size);
             total_size_bytes += range_size;
         },
-        [&] { src_buffer = UploadCopies(buffer, copies, total_size_bytes); });
+        [&] {
+            if (total_size_bytes != 0) {
+                auto& counters = DebugState.renderer_counters;
+                counters.Add(DebugStateType::RendererCounter::BufferSyncs);
+                counters.Add(DebugStateType::RendererCounter::BufferUploadBytes, total_size_bytes);
+            }
+            if (is_fresh && transfer_scheduler && total_size_bytes >= AsyncUploadThreshold) {
+                is_async = UploadCopiesAsync(buffer, copies, total_size_bytes);
+            }
+            if (!is_async) {
+                src_buffer = UploadCopies(buffer, copies, total_size_bytes);
+            }
+        });
 
-    if (src_buffer) {
+    if (is_async) {
+        TouchBuffer(buffer);
+    } else if (src_buffer) {
         scheduler.EndRendering();
         const auto cmdbuf = scheduler.CommandBuffer();
         const vk::BufferMemoryBarrier2 pre_barrier = {
@@ -895,6 +1079,24 @@ bool BufferCache::SynchronizeBuffer(Buffer& buffer, VAddr device_addr, u32 size,
     return false;
 }
 
+bool BufferCache::UploadCopiesAsync(Buffer& buffer, std::span<vk::BufferCopy> copies,
+                                    size_t total_size_bytes) {
+    // Nothing in the current submission references the buffer yet, so the copies can be executed
+    // on the transfer queue before it, without any barrier on the graphics side.
+    const auto allocation = transfer_scheduler->Map(total_size_bytes);
+    if (!allocation) {
+        return false;
+    }
+    for (auto& copy : copies) {
+        u8* const dst_pointer = allocation->data + copy.srcOffset;
+        const VAddr device_addr = buffer.CpuAddr() + copy.dstOffset;
+        CopyToStaging(device_addr, dst_pointer, copy.size);
+        copy.srcOffset += allocation->offset;
+    }
+    transfer_scheduler->Copy(buffer.Handle(), copies);
+    return true;
+}
+
 vk::Buffer BufferCache::UploadCopies(Buffer& buffer, std::span<vk::BufferCopy> copies,
                                      size_t total_size_bytes) {
     if (copies.empty()) {
@@ -905,7 +1107,7 @@ vk::Buffer BufferCache::UploadCopies(Buffer& buffer, std::span<vk::BufferCopy> c
         for (auto& copy : copies) {
             u8* const src_pointer = staging + copy.srcOffset;
             const VAddr device_addr = buffer.CpuAddr() + copy.dstOffset;
-            memory->CopySparseMemory(device_addr, src_pointer, copy.size);
+            CopyToStaging(device_addr, src_pointer, copy.size);
             // Apply the staging offset
             copy.srcOffset += offset;
         }
@@ -921,13 +1123,33 @@ vk::Buffer BufferCache::UploadCopies(Buffer& buffer, std::span<vk::BufferCopy> c
         for (const auto& copy : copies) {
             u8* const src_pointer = staging + copy.srcOffset;
             const VAddr device_addr = buffer.CpuAddr() + copy.dstOffset;
-            memory->CopySparseMemory(device_addr, src_pointer, copy.size);
+            CopyToStaging(device_addr, src_pointer, copy.size);
         }
         scheduler.DeferOperation([buffer = std::move(temp_buffer)]() mutable { buffer.reset(); });
         return src_buffer;
     }
 }
 
+void BufferCache::CopyToStaging(VAddr device_addr, u8* dst, u64 size) {
+    if (!copy_worker || size < ParallelCopyThreshold) {
+        memory->CopySparseMemory(device_addr, dst, size, true);
+        return;
+    }
+    // The calling thread copies the last chunk itself while the workers copy the others.
+    const u64 num_chunks = copy_worker->NumWorkers() + 1;
+    const u64 chunk_size = Common::AlignUp(Common::DivCeil(size, num_chunks), 4_KB);
+    u64 chunk_offset = 0;
+    for (; chunk_offset + chunk_size < size; chunk_offset += chunk_size) {
+        copy_worker->QueueWork([this, device_addr, dst, chunk_offset, chunk_size] {
+            memory->CopySparseMemory(device_addr + chunk_offset, dst + chunk_offset, chunk_size,
+                                     true);
+        });
+    }
+    memory->CopySparseMemory(device_addr + chunk_offset, dst + chunk_offset, size - chunk_offset,
+                             true);
+    copy_worker->WaitForRequests();
+}
+
 bool BufferCache::SynchronizeBufferFromImage(Buffer& buffer, VAddr device_addr, u32 size) {
     const ImageId image_id = texture_cache.FindImageFromRange(device_addr, size);
     if (!image_id) {
@@ -1002,6 +1224,7 @@ void BufferCache::MemoryBarrier() {
 
 void BufferCache::InlineDataBuffer(Buffer& buffer, VAddr address, const void* value,
                                    u32 num_bytes) {
+    buffer.is_fresh = false;
     scheduler.EndRendering();
     const auto cmdbuf = scheduler.CommandBuffer();
     const vk::BufferMemoryBarrier2 pre_barrier = {
@@ -1044,6 +1267,7 @@ void BufferCache::InlineDataBuffer(Buffer& buffer, VAddr address, const void* va
 }
 
 void BufferCache::WriteDataBuffer(Buffer& buffer, VAddr address, const void* value, u32 num_bytes) {
+    buffer.is_fresh = false;
     vk::BufferCopy copy = {
         .srcOffset = 0,
         .dstOffset = buffer.Offset(address),
@@ -1129,6 +1353,7 @@ void BufferCache::TouchBuffer(const Buffer& buffer) {
 }
 
 void BufferCache::DeleteBuffer(BufferId buffer_id) {
+    FlushInlineWrites();
     Buffer& buffer = slot_buffers[buffer_id];
     Unregister(buffer_id);
     scheduler.DeferOperation([this, buffer_id] { slot_buffers.erase(buffer_id); });
@@ -3,8 +3,11 @@
 
 #pragma once
 
-#include <shared_mutex>
+#include <atomic>
+#include <unordered_map>
+#include <vector>
 #include <boost/container/small_vector.hpp>
+#include "common/div_ceil.h"
 #include "common/lru_cache.h"
 #include "common/slot_vector.h"
 #include "common/types.h"
@@ -16,12 +19,18 @@ namespace AmdGpu {
 struct Liverpool;
 }
 
+namespace Common {
+class ThreadWorker;
+}
+
 namespace Core {
 class MemoryManager;
 }
 
 namespace Vulkan {
 class GraphicsPipeline;
+struct VertexBindings;
+class TransferScheduler;
 }
 
 namespace VideoCore {
@@ -49,8 +58,13 @@ public:
     static constexpr s64 DEFAULT_CRITICAL_GC_MEMORY = 2_GB;
     static constexpr s64 TARGET_GC_THRESHOLD = 8_GB;
 
+    // Pages read back by the CPU are downloaded ahead of time for this many guest submissions.
+    static constexpr u64 READBACK_PREDICTION_SUBMITS = 256;
+    static constexpr size_t MAX_PREDICTED_READBACKS = 4096;
+
     struct PageData {
-        BufferId buffer_id{};
+        // Read without locks by the fault handlers, written only by the GPU thread.
+        std::atomic<BufferId> buffer_id{};
     };
 
     struct Traits {
@@ -119,15 +133,39 @@ public:
     /// Flushes any GPU modified buffer in the logical page range back to CPU memory.
     void ReadMemory(VAddr device_addr, u64 size, bool is_write = false);
 
+    /// Queues downloads of the pages the CPU recently read back, called at the end of a guest
+    /// submission so the copies run right after the commands that produced the data.
+    void DownloadPredictedReadbacks();
+
     /// Binds host vertex buffers for the current draw.
     void BindVertexBuffers(const Vulkan::GraphicsPipeline& pipeline);
 
+    /// Resolves the host vertex buffers for the current draw without recording any command.
+    void ObtainVertexBuffers(const Vulkan::GraphicsPipeline& pipeline,
+                             Vulkan::VertexBindings& vertex_bindings);
+
+    /// Records vertex buffers resolved by ObtainVertexBuffers.
+    void BindVertexBuffers(const Vulkan::VertexBindings& vertex_bindings);
+
+    struct IndexBinding {
+        vk::Buffer buffer;
+        u64 offset;
+        vk::IndexType index_type;
+    };
+
     /// Bind host index buffer for the current draw.
     void BindIndexBuffer(u32 index_offset);
 
+    /// Resolves the host index buffer for the current draw without recording any command.
+    [[nodiscard]] IndexBinding ObtainIndexBuffer(u32 index_offset);
+
     /// Writes a value to GPU buffer. (uses command buffer to temporarily store the data)
     void InlineData(VAddr address, const void* value, u32 num_bytes, bool is_gds);
 
+    /// Records the inline writes combined so far, they must land before any command that may
+    /// access their buffer.
+    void FlushInlineWrites();
+
     /// Performs buffer to buffer data copy on the GPU.
     void CopyBuffer(VAddr dst, VAddr src, u32 num_bytes, bool dst_gds, bool src_gds);
 
@@ -169,11 +207,24 @@ public:
 private:
     template <typename Func>
     void ForEachBufferInRange(VAddr device_addr, u64 size, Func&& func) {
-        buffer_ranges.ForEachInRange(device_addr, size,
-                                     [&](u64 page_start, u64 page_end, BufferId id) {
-                                         Buffer& buffer = slot_buffers[id];
-                                         func(id, buffer);
-                                     });
+        // Registered buffers never overlap, so each page maps to at most one buffer and the walk
+        // can jump over the remaining pages of every buffer it visits.
+        const u64 page_end = Common::DivCeil(device_addr + size, CACHING_PAGESIZE);
+        for (u64 page = device_addr >> CACHING_PAGEBITS; page < page_end;) {
+            const PageData* const entry = page_table.find(page);
+            if (!entry) {
+                page = PageTable::next_table_page(page);
+                continue;
+            }
+            const BufferId buffer_id = entry->buffer_id.load(std::memory_order_relaxed);
+            if (!buffer_id) {
+                ++page;
+                continue;
+            }
+            Buffer& buffer = slot_buffers[buffer_id];
+            func(buffer_id, buffer);
+            page = Common::DivCeil(buffer.CpuAddr() + buffer.SizeBytes(), CACHING_PAGESIZE);
+        }
     }
 
     inline bool IsBufferInvalid(BufferId buffer_id) const {
@@ -183,6 +234,9 @@ private:
     template <bool async>
     void DownloadBufferMemory(Buffer& buffer, VAddr device_addr, u64 size, bool is_write);
 
+    /// Remembers the pages of a CPU readback so they are downloaded ahead of the next ones.
+    void PredictReadback(VAddr device_addr, u64 size);
+
     [[nodiscard]] OverlapResult ResolveOverlaps(VAddr device_addr, u32 wanted_size);
 
     void JoinOverlap(BufferId new_buffer_id, BufferId overlap_id, bool accumulate_stream_score);
@@ -202,10 +256,19 @@ private:
     vk::Buffer UploadCopies(Buffer& buffer, std::span<vk::BufferCopy> copies,
                             size_t total_size_bytes);
 
+    bool UploadCopiesAsync(Buffer& buffer, std::span<vk::BufferCopy> copies,
+                           size_t total_size_bytes);
+
+    /// Copies guest memory to staging memory, large copies are split across the copy workers.
+    void CopyToStaging(VAddr device_addr, u8* dst, u64 size);
+
     bool SynchronizeBufferFromImage(Buffer& buffer, VAddr device_addr, u32 size);
 
     void InlineDataBuffer(Buffer& buffer, VAddr address, const void* value, u32 num_bytes);
 
+    /// Appends an inline write to the pending run when it continues it, otherwise starts a new one.
+    void CombineInlineWrite(Buffer& buffer, VAddr address, const void* value, u32 num_bytes);
+
     void WriteDataBuffer(Buffer& buffer, VAddr address, const void* value, u32 num_bytes);
 
     void TouchBuffer(const Buffer& buffer);
@@ -214,10 +277,12 @@ private:
 
     const Vulkan::Instance& instance;
     Vulkan::Scheduler& scheduler;
+    Vulkan::TransferScheduler* transfer_scheduler{};
     AmdGpu::Liverpool* liverpool;
     Core::MemoryManager* memory;
     TextureCache& texture_cache;
     std::unique_ptr<MemoryTracker> memory_tracker;
+    std::unique_ptr<Common::ThreadWorker> copy_worker;
     StreamBuffer staging_buffer;
     StreamBuffer stream_buffer;
     StreamBuffer download_buffer;
@@ -225,7 +290,6 @@ private:
     Buffer gds_buffer;
     Buffer bda_pagetable_buffer;
     Buffer fault_buffer;
-    std::shared_mutex slot_buffers_mutex;
     Common::SlotVector<Buffer> slot_buffers;
     u64 total_used_memory = 0;
     u64 trigger_gc_memory = 0;
@@ -233,7 +297,13 @@ private:
     u64 gc_tick = 0;
     Common::LeastRecentlyUsedCache<BufferId, u64> lru_cache;
     RangeSet gpu_modified_ranges;
-    SplitRangeMap<BufferId> buffer_ranges;
+    Buffer* inline_write_buffer{};
+    VAddr inline_write_address = 0;
+    std::vector<u8> inline_write_data;
+    std::unordered_map<u64, u64> predicted_readbacks; ///< Tracker page to submission of last read
+    RangeSet pending_readbacks;
+    u64 pending_readback_tick = 0;
+    u64 readback_submit = 0;
     PageTable page_table;
     vk::UniqueDescriptorSetLayout fault_process_desc_layout;
     vk::UniquePipeline fault_process_pipeline;
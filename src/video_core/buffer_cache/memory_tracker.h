@@ -61,6 +61,18 @@ public:
                             });
     }
 
+    /// Mark region as modified from the host GPU, dropping any CPU modifications. Used for
+    /// regions the GPU is about to overwrite entirely.
+    void MarkRegionAsGpuOverwritten(VAddr dirty_cpu_addr, u64 query_size) {
+        IteratePages<true>(dirty_cpu_addr, query_size,
+                           [](RegionManager* manager, u64 offset, size_t size) {
+                               std::scoped_lock lk{manager->lock};
+                               const VAddr addr = manager->GetCpuAddr() + offset;
+                               manager->template ChangeRegionState<Type::CPU, false>(addr, size);
+                               manager->template ChangeRegionState<Type::GPU, true>(addr, size);
+                           });
+    }
+
     /// Removes all protection from a page and ensures GPU data has been flushed if requested
     void InvalidateRegion(VAddr cpu_addr, u64 size, auto&& on_flush) noexcept {
         IteratePages<false>(
@@ -71,7 +83,7 @@ public:
                     // modified. If we need to flush the flush function is going to perform CPU
                     // state change.
                     std::scoped_lock lk{manager->lock};
-                    if (Config::readbacks() &&
+                    if (Config::GetSnapshot().readbacks &&
                         manager->template IsRegionModified<Type::GPU>(offset, size)) {
                         return true;
                     }
@@ -95,7 +95,7 @@ public:
         }
         if constexpr (type == Type::CPU) {
             UpdateProtection<!enable, false>();
-        } else if (Config::readbacks()) {
+        } else if (Config::GetSnapshot().readbacks) {
             UpdateProtection<enable, true>();
         }
     }
@@ -120,13 +120,16 @@ public:
         }
 
         RegionBits& bits = GetRegionBits<type>();
+        if (!bits.AnyInRange(start_page, end_page)) {
+            return;
+        }
         RegionBits mask(bits, start_page, end_page);
 
         if constexpr (clear) {
             bits.UnsetRange(start_page, end_page);
             if constexpr (type == Type::CPU) {
                 UpdateProtection<true, false>();
-            } else if (Config::readbacks()) {
+            } else if (Config::GetSnapshot().readbacks) {
                 UpdateProtection<false, true>();
             }
         }
@@ -152,9 +155,7 @@ public:
             return false;
         }
 
-        const RegionBits& bits = GetRegionBits<type>();
-        RegionBits test(bits, start_page, end_page);
-        return test.Any();
+        return GetRegionBits<type>().AnyInRange(start_page, end_page);
     }
 
     LockType lock;
@@ -0,0 +1,31 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#version 450
+
+layout (location = 0) in vec2 uv;
+layout (location = 0) out vec4 color;
+
+layout (binding = 0) uniform sampler2D prev_frame;
+layout (binding = 1) uniform sampler2D next_frame;
+layout (binding = 2) uniform sampler2D motion;
+
+layout (push_constant) uniform constants {
+    vec2 inv_size;
+    float phase;
+} pc;
+
+void main() {
+    // Motion moves content from the previous frame to the next one, both frames are warped
+    // towards the position of the content at the interpolated point in time.
+    const vec4 field = textureLod(motion, uv, 0.0);
+    const vec2 offset = field.xy * pc.inv_size;
+    const vec4 prev = textureLod(prev_frame, uv - offset * pc.phase, 0.0);
+    const vec4 next = textureLod(next_frame, uv + offset * (1.0 - pc.phase), 0.0);
+    const vec4 warped = mix(prev, next, pc.phase);
+
+    // Blocks without a reliable match fall back to blending the frames in place.
+    const vec4 blended =
+        mix(textureLod(prev_frame, uv, 0.0), textureLod(next_frame, uv, 0.0), pc.phase);
+    color = mix(blended, warped, field.z);
+}
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <memory>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -26,49 +28,60 @@ class MultiLevelPageTable final {
     using L1Page = std::array<Entry, NumEntriesPerL1Page>;
 
 public:
-    explicit MultiLevelPageTable() : first_level_map{1ULL << FirstLevelBits, nullptr} {}
+    explicit MultiLevelPageTable()
+        : first_level_map{std::make_unique<std::atomic<L1Page*>[]>(1ULL << FirstLevelBits)} {}
 
     ~MultiLevelPageTable() noexcept = default;
 
+    /// Finds the entry of an allocated page. Never allocates, so it can be called concurrently
+    /// with a single writer; entries must be atomic if they are modified at the same time.
     [[nodiscard]] Entry* find(size_t page) {
         const size_t l1_page = page >> SecondLevelBits;
         const size_t l2_page = page & (NumEntriesPerL1Page - 1);
-        if (!first_level_map[l1_page]) {
+        L1Page* const l1 = first_level_map[l1_page].load(std::memory_order_acquire);
+        if (!l1) {
             return nullptr;
         }
-        return &(*first_level_map[l1_page])[l2_page];
+        return &(*l1)[l2_page];
     }
 
     [[nodiscard]] const Entry* find(size_t page) const {
         const size_t l1_page = page >> SecondLevelBits;
         const size_t l2_page = page & (NumEntriesPerL1Page - 1);
-        if (!first_level_map[l1_page]) {
+        const L1Page* const l1 = first_level_map[l1_page].load(std::memory_order_acquire);
+        if (!l1) {
             return nullptr;
         }
-        return &(*first_level_map[l1_page])[l2_page];
+        return &(*l1)[l2_page];
+    }
+
+    /// Returns the first page of the table following the one that holds the provided page.
+    [[nodiscard]] static constexpr size_t next_table_page(size_t page) {
+        return (page | (NumEntriesPerL1Page - 1)) + 1;
     }
 
     [[nodiscard]] const Entry& operator[](size_t page) const {
-        const size_t l1_page = page >> SecondLevelBits;
-        const size_t l2_page = page & (NumEntriesPerL1Page - 1);
-        if (!first_level_map[l1_page]) {
-            first_level_map[l1_page] = page_alloc.Create();
-        }
-        return (*first_level_map[l1_page])[l2_page];
+        return (*GetOrCreate(page >> SecondLevelBits))[page & (NumEntriesPerL1Page - 1)];
     }
 
     [[nodiscard]] Entry& operator[](size_t page) {
-        const size_t l1_page = page >> SecondLevelBits;
-        const size_t l2_page = page & (NumEntriesPerL1Page - 1);
-        if (!first_level_map[l1_page]) {
-            first_level_map[l1_page] = page_alloc.Create();
+        return (*GetOrCreate(page >> SecondLevelBits))[page & (NumEntriesPerL1Page - 1)];
+    }
+
+private:
+    L1Page* GetOrCreate(size_t l1_page) const {
+        L1Page* l1 = first_level_map[l1_page].load(std::memory_order_relaxed);
+        if (!l1) {
+            // Publish the zeroed table before it can be observed by concurrent readers.
+            l1 = page_alloc.Create();
+            first_level_map[l1_page].store(l1, std::memory_order_release);
         }
-        return (*first_level_map[l1_page])[l2_page];
+        return l1;
     }
 
 private:
-    std::vector<L1Page*> first_level_map{};
-    Common::ObjectPool<L1Page> page_alloc;
+    std::unique_ptr<std::atomic<L1Page*>[]> first_level_map;
+    mutable Common::ObjectPool<L1Page> page_alloc;
 };
 
 } // namespace VideoCore
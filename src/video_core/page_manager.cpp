@@ -1,12 +1,15 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <boost/container/small_vector.hpp>
 #include "common/assert.h"
+#include "common/config.h"
 #include "common/debug.h"
 #include "common/div_ceil.h"
 #include "common/range_lock.h"
 #include "common/signal_context.h"
+#include "core/debug_state.h"
 #include "core/memory.h"
 #include "core/signals.h"
 #include "video_core/page_manager.h"
@@ -15,17 +18,29 @@
 #ifndef _WIN64
 #include <sys/mman.h>
 #include "common/adaptive_mutex.h"
-#ifdef ENABLE_USERFAULTFD
+#else
+#include <windows.h>
+#include "common/spin_lock.h"
+#endif
+
+#if defined(__linux__) && __has_include(<linux/userfaultfd.h>)
+#define HAS_USERFAULTFD
 #include <thread>
 #include <fcntl.h>
 #include <linux/userfaultfd.h>
 #include <poll.h>
+#include <sys/eventfd.h>
 #include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 #include "common/error.h"
+#include "common/thread.h"
+#ifndef UFFD_USER_MODE_ONLY
+#define UFFD_USER_MODE_ONLY 1
+#endif
+#ifndef UFFD_FEATURE_WP_HUGETLBFS_SHMEM
+#define UFFD_FEATURE_WP_HUGETLBFS_SHMEM (1 << 12)
 #endif
-#else
-#include <windows.h>
-#include "common/spin_lock.h"
 #endif
 
 #ifdef __linux__
@@ -88,136 +103,246 @@ struct PageManager::Impl {
     static constexpr size_t NUM_ADDRESS_PAGES = 1ULL << (40 - PAGE_BITS);
     static constexpr size_t NUM_ADDRESS_LOCKS = NUM_ADDRESS_PAGES / PAGES_PER_LOCK;
     inline static Vulkan::Rasterizer* rasterizer;
-#ifdef ENABLE_USERFAULTFD
+    enum class Backend {
+        /// Pages are mprotect-ed and accesses are reported through the access violation handler.
+        Signal,
+        /// Writes are tracked with userfaultfd write-protect mode and serviced on a dedicated
+        /// thread. Read watchers still rely on mprotect, as userfaultfd cannot trap reads of
+        /// present pages.
+        Userfaultfd,
+    };
+
     Impl(Vulkan::Rasterizer* rasterizer_) {
         rasterizer = rasterizer_;
-        uffd = syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY);
-        ASSERT_MSG(uffd != -1, "{}", Common::GetLastErrorMsg());
 
-        // Request uffdio features from kernel.
-        uffdio_api api;
-        api.api = UFFD_API;
-        api.features = UFFD_FEATURE_THREAD_ID;
-        const int ret = ioctl(uffd, UFFDIO_API, &api);
-        ASSERT(ret == 0 && api.api == UFFD_API);
+        // Should be called first. Read watchers are serviced by it with every backend.
+        constexpr auto priority = std::numeric_limits<u32>::min();
+        Core::Signals::Instance()->RegisterAccessViolationHandler(GuestFaultSignalHandler,
+                                                                  priority);
+
+        const auto requested = Config::getPageTracking();
+        if (requested == "userfaultfd") {
+#ifdef HAS_USERFAULTFD
+            if (InitUserfaultfd()) {
+                backend = Backend::Userfaultfd;
+            }
+#else
+            LOG_WARNING(Render, "userfaultfd page tracking is not supported on this platform");
+#endif
+        } else if (requested != "signal") {
+            LOG_WARNING(Render, "Unknown page tracking backend '{}'", requested);
+        }
+        LOG_INFO(Render, "Using {} page tracking",
+                 backend == Backend::Userfaultfd ? "userfaultfd" : "signal");
+    }
 
-        // Create uffd handler thread
-        ufd_thread = std::jthread([&](std::stop_token token) { UffdHandler(token); });
+    ~Impl() {
+#ifdef HAS_USERFAULTFD
+        if (backend == Backend::Userfaultfd) {
+            uffd_thread.request_stop();
+            const u64 value = 1;
+            const ssize_t ret = write(stop_fd, &value, sizeof(value));
+            ASSERT_MSG(ret == sizeof(value), "Failed to signal uffd handler: {}",
+                       Common::GetLastErrorMsg());
+            uffd_thread.join();
+            close(stop_fd);
+            close(uffd);
+        }
+#endif
     }
 
     void OnMap(VAddr address, size_t size) {
-        uffdio_register reg;
-        reg.range.start = address;
-        reg.range.len = size;
-        reg.mode = UFFDIO_REGISTER_MODE_WP;
-        const int ret = ioctl(uffd, UFFDIO_REGISTER, &reg);
-        ASSERT_MSG(ret != -1, "Uffdio register failed");
+        Core::Signals::Instance()->SetAccessViolationOwner(address, size, GuestFaultSignalHandler);
+#ifdef HAS_USERFAULTFD
+        if (backend == Backend::Userfaultfd) {
+            uffdio_register reg{};
+            reg.range.start = address;
+            reg.range.len = size;
+            reg.mode = UFFDIO_REGISTER_MODE_WP;
+            const int ret = ioctl(uffd, UFFDIO_REGISTER, &reg);
+            ASSERT_MSG(ret != -1, "Uffdio register failed: {}", Common::GetLastErrorMsg());
+        }
+#endif
     }
 
     void OnUnmap(VAddr address, size_t size) {
-        uffdio_range range;
-        range.start = address;
-        range.len = size;
-        const int ret = ioctl(uffd, UFFDIO_UNREGISTER, &range);
-        ASSERT_MSG(ret != -1, "Uffdio unregister failed");
+        Core::Signals::Instance()->ClearAccessViolationOwner(address, size);
+#ifdef HAS_USERFAULTFD
+        if (backend == Backend::Userfaultfd) {
+            uffdio_range range{};
+            range.start = address;
+            range.len = size;
+            const int ret = ioctl(uffd, UFFDIO_UNREGISTER, &range);
+            ASSERT_MSG(ret != -1, "Uffdio unregister failed: {}", Common::GetLastErrorMsg());
+        }
+#endif
     }
 
+    template <bool is_read>
     void Protect(VAddr address, size_t size, Core::MemoryPermission perms) {
-        bool allow_write = True(perms & Core::MemoryPermission::Write);
-        uffdio_writeprotect wp;
+        RENDERER_TRACE;
+#ifdef HAS_USERFAULTFD
+        if (backend == Backend::Userfaultfd) {
+            if constexpr (is_read) {
+                // Write permission is owned by userfaultfd, only toggle page accessibility.
+                const bool allow_read = True(perms & Core::MemoryPermission::Read);
+                ProtectHost(address, size,
+                            allow_read ? Core::MemoryPermission::ReadWrite
+                                       : Core::MemoryPermission::None);
+            } else {
+                WriteProtect(address, size, False(perms & Core::MemoryPermission::Write));
+            }
+            return;
+        }
+#endif
+        ProtectHost(address, size, perms);
+    }
+
+    void ProtectHost(VAddr address, size_t size, Core::MemoryPermission perms) {
+        auto* memory = Core::Memory::Instance();
+        auto& impl = memory->GetAddressSpace();
+        ASSERT_MSG(perms != Core::MemoryPermission::Write,
+                   "Attempted to protect region as write-only which is not a valid permission");
+        impl.Protect(address, size, perms);
+    }
+
+    static bool GuestFaultSignalHandler(void* context, void* fault_address) {
+        const auto addr = reinterpret_cast<VAddr>(fault_address);
+        DebugState.AddStall(DebugStateType::StallCause::PageFault);
+        if (Common::IsWriteError(context)) {
+            return rasterizer->InvalidateMemory(addr, 8);
+        } else {
+            return rasterizer->ReadMemory(addr, 8);
+        }
+        return false;
+    }
+
+#ifdef HAS_USERFAULTFD
+    static constexpr size_t MaxFaultBatch = 64;
+
+    bool InitUserfaultfd() {
+        uffd = static_cast<int>(
+            syscall(__NR_userfaultfd, O_CLOEXEC | O_NONBLOCK | UFFD_USER_MODE_ONLY));
+        if (uffd == -1) {
+            LOG_WARNING(Render, "Unable to open userfaultfd, falling back to signals: {}",
+                        Common::GetLastErrorMsg());
+            return false;
+        }
+
+        // Guest memory is backed by a shared memory file, so write protection of shmem is needed.
+        constexpr u64 required_features =
+            UFFD_FEATURE_PAGEFAULT_FLAG_WP | UFFD_FEATURE_WP_HUGETLBFS_SHMEM;
+        uffdio_api api{};
+        api.api = UFFD_API;
+        api.features = required_features;
+        if (ioctl(uffd, UFFDIO_API, &api) != 0 || api.api != UFFD_API ||
+            (api.features & required_features) != required_features) {
+            LOG_WARNING(Render,
+                        "userfaultfd write-protect mode is not supported by the kernel, falling "
+                        "back to signals");
+            close(uffd);
+            uffd = -1;
+            return false;
+        }
+
+        stop_fd = eventfd(0, EFD_CLOEXEC);
+        ASSERT_MSG(stop_fd != -1, "Unable to create eventfd: {}", Common::GetLastErrorMsg());
+        uffd_thread = std::jthread([this](std::stop_token token) { UffdHandler(token); });
+        return true;
+    }
+
+    void WriteProtect(VAddr address, size_t size, bool protect) {
+        uffdio_writeprotect wp{};
         wp.range.start = address;
         wp.range.len = size;
-        wp.mode = allow_write ? 0 : UFFDIO_WRITEPROTECT_MODE_WP;
+        // Nothing can be waiting on a range that is being protected, skip the wake up.
+        wp.mode = protect ? UFFDIO_WRITEPROTECT_MODE_WP | UFFDIO_WRITEPROTECT_MODE_DONTWAKE : 0;
         const int ret = ioctl(uffd, UFFDIO_WRITEPROTECT, &wp);
         ASSERT_MSG(ret != -1, "Uffdio writeprotect failed with error: {}",
                    Common::GetLastErrorMsg());
     }
 
+    void Wake(VAddr address, size_t size) {
+        uffdio_range range{};
+        range.start = address;
+        range.len = size;
+        const int ret = ioctl(uffd, UFFDIO_WAKE, &range);
+        ASSERT_MSG(ret != -1, "Uffdio wake failed with error: {}", Common::GetLastErrorMsg());
+    }
+
     void UffdHandler(std::stop_token token) {
+        Common::SetCurrentThreadName("shadPS4:UffdHandler");
+
+        std::array<uffd_msg, MaxFaultBatch> msgs;
+        boost::container::small_vector<VAddr, MaxFaultBatch> fault_pages;
         while (!token.stop_requested()) {
-            pollfd pollfd;
-            pollfd.fd = uffd;
-            pollfd.events = POLLIN;
-
-            // Block until the descriptor is ready for data reads.
-            const int pollres = poll(&pollfd, 1, -1);
-            switch (pollres) {
-            case -1:
-                perror("Poll userfaultfd");
-                continue;
-                break;
-            case 0:
+            std::array<pollfd, 2> fds{};
+            fds[0].fd = uffd;
+            fds[0].events = POLLIN;
+            fds[1].fd = stop_fd;
+            fds[1].events = POLLIN;
+
+            // Block until the descriptor is ready for data reads or we are asked to stop.
+            if (poll(fds.data(), fds.size(), -1) == -1) {
+                ASSERT_MSG(errno == EINTR, "Poll userfaultfd failed: {}",
+                           Common::GetLastErrorMsg());
                 continue;
-            case 1:
+            }
+            if (fds[1].revents & POLLIN) {
                 break;
-            default:
-                UNREACHABLE_MSG("Unexpected number of descriptors {} out of poll", pollres);
             }
 
             // We don't want an error condition to have occured.
-            ASSERT_MSG(!(pollfd.revents & POLLERR), "POLLERR on userfaultfd");
-
-            // We waited until there is data to read, we don't care about anything else.
-            if (!(pollfd.revents & POLLIN)) {
+            ASSERT_MSG(!(fds[0].revents & POLLERR), "POLLERR on userfaultfd");
+            if (!(fds[0].revents & POLLIN)) {
                 continue;
             }
 
-            // Read message from kernel.
-            uffd_msg msg;
-            const int readret = read(uffd, &msg, sizeof(msg));
-            ASSERT_MSG(readret != -1 || errno == EAGAIN, "Unexpected result of uffd read");
-            if (errno == EAGAIN) {
+            // Drain as many messages as possible in one go.
+            const ssize_t readret = read(uffd, msgs.data(), sizeof(msgs));
+            if (readret == -1) {
+                ASSERT_MSG(errno == EAGAIN, "Unexpected result of uffd read: {}",
+                           Common::GetLastErrorMsg());
                 continue;
             }
-            ASSERT_MSG(readret == sizeof(msg), "Unexpected short read, exiting");
-            ASSERT(msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WP);
+            ASSERT_MSG(readret % sizeof(uffd_msg) == 0, "Unexpected short read of uffd message");
+
+            fault_pages.clear();
+            const size_t num_msgs = static_cast<size_t>(readret) / sizeof(uffd_msg);
+            for (size_t i = 0; i < num_msgs; ++i) {
+                const auto& msg = msgs[i];
+                if (msg.event != UFFD_EVENT_PAGEFAULT) {
+                    continue;
+                }
+                ASSERT(msg.arg.pagefault.flags & UFFD_PAGEFAULT_FLAG_WP);
+                fault_pages.push_back(GetPageAddr(msg.arg.pagefault.address));
+            }
 
-            // Notify rasterizer about the fault.
-            const VAddr addr = msg.arg.pagefault.address;
-            rasterizer->InvalidateMemory(addr, 1);
+            // Several threads may have faulted on the same page, only invalidate it once.
+            std::ranges::sort(fault_pages);
+            const auto [first, last] = std::ranges::unique(fault_pages);
+            fault_pages.erase(first, last);
+            for (const VAddr page : fault_pages) {
+                DebugState.AddStall(DebugStateType::StallCause::PageFault);
+                if (!rasterizer->InvalidateMemory(page, 1)) {
+                    // The page is no longer watched, drop the stale protection.
+                    WriteProtect(page, PAGE_SIZE, false);
+                    continue;
+                }
+                // Invalidation usually unprotects and wakes the page already, ensure that the
+                // faulting threads resume even if other watchers keep it protected.
+                Wake(page, PAGE_SIZE);
+            }
         }
     }
 
-    std::jthread ufd_thread;
-    int uffd;
-#else
-    Impl(Vulkan::Rasterizer* rasterizer_) {
-        rasterizer = rasterizer_;
-
-        // Should be called first.
-        constexpr auto priority = std::numeric_limits<u32>::min();
-        Core::Signals::Instance()->RegisterAccessViolationHandler(GuestFaultSignalHandler,
-                                                                  priority);
-    }
-
-    void OnMap(VAddr address, size_t size) {
-        // No-op
-    }
-
-    void OnUnmap(VAddr address, size_t size) {
-        // No-op
-    }
-
-    void Protect(VAddr address, size_t size, Core::MemoryPermission perms) {
-        RENDERER_TRACE;
-        auto* memory = Core::Memory::Instance();
-        auto& impl = memory->GetAddressSpace();
-        ASSERT_MSG(perms != Core::MemoryPermission::Write,
-                   "Attempted to protect region as write-only which is not a valid permission");
-        impl.Protect(address, size, perms);
-    }
-
-    static bool GuestFaultSignalHandler(void* context, void* fault_address) {
-        const auto addr = reinterpret_cast<VAddr>(fault_address);
-        if (Common::IsWriteError(context)) {
-            return rasterizer->InvalidateMemory(addr, 8);
-        } else {
-            return rasterizer->ReadMemory(addr, 8);
-        }
-        return false;
-    }
+    std::jthread uffd_thread;
+    int uffd{-1};
+    int stop_fd{-1};
 #endif
 
+    Backend backend{Backend::Signal};
+
     template <bool track, bool is_read>
     void UpdatePageWatchers(VAddr addr, u64 size) {
         RENDERER_TRACE;
@@ -239,7 +364,7 @@ struct PageManager::Impl {
             if (range_bytes > 0) {
                 RENDERER_TRACE;
                 // Perform pending (un)protect action
-                Protect(range_begin << PAGE_BITS, range_bytes, perms);
+                Protect<is_read>(range_begin << PAGE_BITS, range_bytes, perms);
                 range_bytes = 0;
                 potential_range_bytes = 0;
             }
@@ -310,7 +435,7 @@ struct PageManager::Impl {
             if (range_bytes > 0) {
                 RENDERER_TRACE;
                 // Perform pending (un)protect action
-                Protect((range_begin << PAGE_BITS), range_bytes, perms);
+                Protect<is_read>((range_begin << PAGE_BITS), range_bytes, perms);
                 range_bytes = 0;
                 potential_range_bytes = 0;
             }
@@ -0,0 +1,565 @@
+//  SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "video_core/renderer_vulkan/host_passes/fi_pass.h"
+
+#include <algorithm>
+
+#include "common/assert.h"
+#include "common/config.h"
+#include "video_core/host_shaders/frame_interpolate_frag.h"
+#include "video_core/host_shaders/frame_motion_comp.h"
+#include "video_core/host_shaders/fs_tri_vert.h"
+#include "video_core/renderer_vulkan/vk_platform.h"
+#include "video_core/renderer_vulkan/vk_presenter.h"
+#include "video_core/renderer_vulkan/vk_shader_util.h"
+
+namespace Vulkan::HostPasses {
+
+namespace {
+
+struct MotionConstants {
+    float inv_size[2];
+};
+
+struct InterpolateConstants {
+    float inv_size[2];
+    float phase;
+};
+
+constexpr vk::ImageSubresourceRange SimpleSubresource = {
+    .aspectMask = vk::ImageAspectFlagBits::eColor,
+    .levelCount = 1,
+    .layerCount = 1,
+};
+
+constexpr vk::Format MotionFormat = vk::Format::eR16G16B16A16Sfloat;
+
+} // Anonymous namespace
+
+void FrameInterpolationPass::Create(vk::Device device, VmaAllocator allocator,
+                                    vk::Format surface_format) {
+    this->device = device;
+    this->allocator = allocator;
+    format = surface_format;
+
+    sampler = Check<"create interpolation sampler">(device.createSamplerUnique({
+        .magFilter = vk::Filter::eLinear,
+        .minFilter = vk::Filter::eLinear,
+        .mipmapMode = vk::SamplerMipmapMode::eNearest,
+        .addressModeU = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeV = vk::SamplerAddressMode::eClampToEdge,
+        .addressModeW = vk::SamplerAddressMode::eClampToEdge,
+        .maxAnisotropy = 1.0f,
+        .minLod = -1000.0f,
+        .maxLod = 1000.0f,
+    }));
+
+    { // motion estimation
+        const std::array<vk::DescriptorSetLayoutBinding, 3> bindings{{
+            {
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            },
+            {
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            },
+            {
+                .binding = 2,
+                .descriptorType = vk::DescriptorType::eStorageImage,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            },
+        }};
+        motion_set_layout =
+            Check<"create motion descriptor set layout">(device.createDescriptorSetLayoutUnique({
+                .flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR,
+                .bindingCount = bindings.size(),
+                .pBindings = bindings.data(),
+            }));
+
+        const vk::PushConstantRange push_constants{
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+            .offset = 0,
+            .size = sizeof(MotionConstants),
+        };
+        motion_pipeline_layout =
+            Check<"create motion pipeline layout">(device.createPipelineLayoutUnique({
+                .setLayoutCount = 1,
+                .pSetLayouts = &motion_set_layout.get(),
+                .pushConstantRangeCount = 1,
+                .pPushConstantRanges = &push_constants,
+            }));
+        SetObjectName(device, motion_pipeline_layout.get(), "frame motion pipeline layout");
+
+        const auto& cs_module =
+            Compile(HostShaders::FRAME_MOTION_COMP, vk::ShaderStageFlagBits::eCompute, device);
+        ASSERT(cs_module);
+        SetObjectName(device, cs_module, "frame_motion.comp");
+
+        const vk::ComputePipelineCreateInfo pipeline_info{
+            .stage{
+                .stage = vk::ShaderStageFlagBits::eCompute,
+                .module = cs_module,
+                .pName = "main",
+            },
+            .layout = motion_pipeline_layout.get(),
+        };
+        motion_pipeline = Check<"create frame motion pipeline">(
+            device.createComputePipelineUnique({}, pipeline_info));
+        SetObjectName(device, motion_pipeline.get(), "frame motion pipeline");
+        device.destroyShaderModule(cs_module);
+    }
+
+    { // interpolation
+        const std::array<vk::DescriptorSetLayoutBinding, 3> bindings{{
+            {
+                .binding = 0,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eFragment,
+            },
+            {
+                .binding = 1,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eFragment,
+            },
+            {
+                .binding = 2,
+                .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                .descriptorCount = 1,
+                .stageFlags = vk::ShaderStageFlagBits::eFragment,
+            },
+        }};
+        interpolate_set_layout = Check<"create interpolation descriptor set layout">(
+            device.createDescriptorSetLayoutUnique({
+                .flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR,
+                .bindingCount = bindings.size(),
+                .pBindings = bindings.data(),
+            }));
+
+        const vk::PushConstantRange push_constants{
+            .stageFlags = vk::ShaderStageFlagBits::eFragment,
+            .offset = 0,
+            .size = sizeof(InterpolateConstants),
+        };
+        interpolate_pipeline_layout =
+            Check<"create interpolation pipeline layout">(device.createPipelineLayoutUnique({
+                .setLayoutCount = 1,
+                .pSetLayouts = &interpolate_set_layout.get(),
+                .pushConstantRangeCount = 1,
+                .pPushConstantRanges = &push_constants,
+            }));
+        SetObjectName(device, interpolate_pipeline_layout.get(),
+                      "frame interpolation pipeline layout");
+
+        const auto& vs_module =
+            Compile(HostShaders::FS_TRI_VERT, vk::ShaderStageFlagBits::eVertex, device);
+        ASSERT(vs_module);
+        SetObjectName(device, vs_module, "fs_tri.vert");
+
+        const auto& fs_module = Compile(HostShaders::FRAME_INTERPOLATE_FRAG,
+                                        vk::ShaderStageFlagBits::eFragment, device);
+        ASSERT(fs_module);
+        SetObjectName(device, fs_module, "frame_interpolate.frag");
+
+        const std::array shaders_ci{
+            vk::PipelineShaderStageCreateInfo{
+                .stage = vk::ShaderStageFlagBits::eVertex,
+                .module = vs_module,
+                .pName = "main",
+            },
+            vk::PipelineShaderStageCreateInfo{
+                .stage = vk::ShaderStageFlagBits::eFragment,
+                .module = fs_module,
+                .pName = "main",
+            },
+        };
+
+        const vk::PipelineRenderingCreateInfo pipeline_rendering_ci{
+            .colorAttachmentCount = 1,
+            .pColorAttachmentFormats = &format,
+        };
+
+        const vk::PipelineVertexInputStateCreateInfo vertex_input_info{};
+
+        const vk::PipelineInputAssemblyStateCreateInfo input_assembly{
+            .topology = vk::PrimitiveTopology::eTriangleList,
+        };
+
+        const vk::PipelineViewportStateCreateInfo viewport_info{
+            .viewportCount = 1,
+            .scissorCount = 1,
+        };
+
+        const vk::PipelineRasterizationStateCreateInfo raster_state{
+            .depthClampEnable = false,
+            .rasterizerDiscardEnable = false,
+            .polygonMode = vk::PolygonMode::eFill,
+            .cullMode = vk::CullModeFlagBits::eBack,
+            .frontFace = vk::FrontFace::eClockwise,
+            .depthBiasEnable = false,
+            .lineWidth = 1.0f,
+        };
+
+        const vk::PipelineMultisampleStateCreateInfo multisampling{
+            .rasterizationSamples = vk::SampleCountFlagBits::e1,
+        };
+
+        const vk::PipelineColorBlendAttachmentState attachment{
+            .blendEnable = false,
+            .colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                              vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA,
+        };
+
+        const vk::PipelineColorBlendStateCreateInfo color_blending{
+            .logicOpEnable = false,
+            .attachmentCount = 1,
+            .pAttachments = &attachment,
+        };
+
+        const std::array dynamic_states{
+            vk::DynamicState::eViewport,
+            vk::DynamicState::eScissor,
+        };
+
+        const vk::PipelineDynamicStateCreateInfo dynamic_info{
+            .dynamicStateCount = dynamic_states.size(),
+            .pDynamicStates = dynamic_states.data(),
+        };
+
+        const vk::GraphicsPipelineCreateInfo pipeline_info{
+            .pNext = &pipeline_rendering_ci,
+            .stageCount = shaders_ci.size(),
+            .pStages = shaders_ci.data(),
+            .pVertexInputState = &vertex_input_info,
+            .pInputAssemblyState = &input_assembly,
+            .pViewportState = &viewport_info,
+            .pRasterizationState = &raster_state,
+            .pMultisampleState = &multisampling,
+            .pColorBlendState = &color_blending,
+            .pDynamicState = &dynamic_info,
+            .layout = interpolate_pipeline_layout.get(),
+        };
+        interpolate_pipeline = Check<"create frame interpolation pipeline">(
+            device.createGraphicsPipelineUnique({}, pipeline_info));
+        SetObjectName(device, interpolate_pipeline.get(), "frame interpolation pipeline");
+
+        device.destroyShaderModule(vs_module);
+        device.destroyShaderModule(fs_module);
+    }
+}
+
+bool FrameInterpolationPass::Render(vk::CommandBuffer cmdbuf, const Frame& next, Frame& output,
+                                    float phase) {
+    const vk::Extent2D size{next.width, next.height};
+    if (size != cur_size) {
+        CreateResources(size);
+    }
+    auto& res = *resources;
+
+    if (Config::GetSnapshot().vk_host_markers) {
+        cmdbuf.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT{
+            .pLabelName = "Host/Frame interpolation",
+        });
+    }
+
+    // Store the next frame in the older history slot, the other one holds the previous frame.
+    const u32 prev_index = cur_history;
+    const u32 next_index = cur_history ^ 1;
+    cur_history = next_index;
+    num_frames = std::min(num_frames + 1, 2U);
+
+    const auto copy_barrier = vk::ImageMemoryBarrier2{
+        .srcStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+        .srcAccessMask = vk::AccessFlagBits2::eNone,
+        .dstStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .dstAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .oldLayout = vk::ImageLayout::eUndefined,
+        .newLayout = vk::ImageLayout::eTransferDstOptimal,
+        .image = res.history[next_index],
+        .subresourceRange = SimpleSubresource,
+    };
+    cmdbuf.pipelineBarrier2(vk::DependencyInfo{
+        .imageMemoryBarrierCount = 1,
+        .pImageMemoryBarriers = &copy_barrier,
+    });
+    const vk::ImageCopy copy{
+        .srcSubresource{
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .layerCount = 1,
+        },
+        .dstSubresource{
+            .aspectMask = vk::ImageAspectFlagBits::eColor,
+            .layerCount = 1,
+        },
+        .extent = {size.width, size.height, 1},
+    };
+    cmdbuf.copyImage(next.image, vk::ImageLayout::eGeneral, res.history[next_index],
+                     vk::ImageLayout::eTransferDstOptimal, copy);
+
+    const bool can_interpolate = num_frames == 2;
+    const u32 motion_width = (size.width + BlockSize - 1) / BlockSize;
+    const u32 motion_height = (size.height + BlockSize - 1) / BlockSize;
+    const std::array stored_barriers{
+        vk::ImageMemoryBarrier2{
+            .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+            .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+            .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader |
+                            vk::PipelineStageFlagBits2::eFragmentShader,
+            .dstAccessMask = vk::AccessFlagBits2::eShaderRead,
+            .oldLayout = vk::ImageLayout::eTransferDstOptimal,
+            .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+            .image = res.history[next_index],
+            .subresourceRange = SimpleSubresource,
+        },
+        vk::ImageMemoryBarrier2{
+            .srcStageMask = vk::PipelineStageFlagBits2::eFragmentShader,
+            .srcAccessMask = vk::AccessFlagBits2::eShaderRead,
+            .dstStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+            .dstAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+            .oldLayout = vk::ImageLayout::eUndefined,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .image = res.motion,
+            .subresourceRange = SimpleSubresource,
+        },
+    };
+    cmdbuf.pipelineBarrier2(vk::DependencyInfo{
+        .imageMemoryBarrierCount = can_interpolate ? 2U : 1U,
+        .pImageMemoryBarriers = stored_barriers.data(),
+    });
+
+    if (can_interpolate) {
+        { // motion estimation
+            const std::array<vk::DescriptorImageInfo, 3> img_info{{
+                {
+                    .sampler = sampler.get(),
+                    .imageView = res.history_views[prev_index].get(),
+                    .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                },
+                {
+                    .sampler = sampler.get(),
+                    .imageView = res.history_views[next_index].get(),
+                    .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                },
+                {
+                    .imageView = res.motion_view.get(),
+                    .imageLayout = vk::ImageLayout::eGeneral,
+                },
+            }};
+            const std::array<vk::WriteDescriptorSet, 3> set_writes{{
+                {
+                    .dstBinding = 0,
+                    .descriptorCount = 1,
+                    .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                    .pImageInfo = &img_info[0],
+                },
+                {
+                    .dstBinding = 1,
+                    .descriptorCount = 1,
+                    .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                    .pImageInfo = &img_info[1],
+                },
+                {
+                    .dstBinding = 2,
+                    .descriptorCount = 1,
+                    .descriptorType = vk::DescriptorType::eStorageImage,
+                    .pImageInfo = &img_info[2],
+                },
+            }};
+            const MotionConstants consts{
+                .inv_size = {1.0f / size.width, 1.0f / size.height},
+            };
+            cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, motion_pipeline.get());
+            cmdbuf.pushDescriptorSetKHR(vk::PipelineBindPoint::eCompute,
+                                        motion_pipeline_layout.get(), 0, set_writes);
+            cmdbuf.pushConstants(motion_pipeline_layout.get(), vk::ShaderStageFlagBits::eCompute,
+                                 0, sizeof(consts), &consts);
+            cmdbuf.dispatch((motion_width + 7) / 8, (motion_height + 7) / 8, 1);
+        }
+
+        const std::array motion_barriers{
+            vk::ImageMemoryBarrier2{
+                .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+                .srcAccessMask = vk::AccessFlagBits2::eShaderStorageWrite,
+                .dstStageMask = vk::PipelineStageFlagBits2::eFragmentShader,
+                .dstAccessMask = vk::AccessFlagBits2::eShaderRead,
+                .oldLayout = vk::ImageLayout::eGeneral,
+                .newLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                .image = res.motion,
+                .subresourceRange = SimpleSubresource,
+            },
+            vk::ImageMemoryBarrier2{
+                .srcStageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                .srcAccessMask = vk::AccessFlagBits2::eColorAttachmentRead,
+                .dstStageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                .dstAccessMask = vk::AccessFlagBits2::eColorAttachmentWrite,
+                .oldLayout = vk::ImageLayout::eUndefined,
+                .newLayout = vk::ImageLayout::eColorAttachmentOptimal,
+                .image = output.image,
+                .subresourceRange = SimpleSubresource,
+            },
+        };
+        cmdbuf.pipelineBarrier2(vk::DependencyInfo{
+            .imageMemoryBarrierCount = motion_barriers.size(),
+            .pImageMemoryBarriers = motion_barriers.data(),
+        });
+
+        { // interpolation
+            const vk::RenderingAttachmentInfo attachment{
+                .imageView = output.image_view,
+                .imageLayout = vk::ImageLayout::eColorAttachmentOptimal,
+                .loadOp = vk::AttachmentLoadOp::eDontCare,
+                .storeOp = vk::AttachmentStoreOp::eStore,
+            };
+            const vk::RenderingInfo rendering_info{
+                .renderArea{
+                    .extent{
+                        .width = output.width,
+                        .height = output.height,
+                    },
+                },
+                .layerCount = 1,
+                .colorAttachmentCount = 1,
+                .pColorAttachments = &attachment,
+            };
+
+            const std::array<vk::DescriptorImageInfo, 3> img_info{{
+                {
+                    .sampler = sampler.get(),
+                    .imageView = res.history_views[prev_index].get(),
+                    .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                },
+                {
+                    .sampler = sampler.get(),
+                    .imageView = res.history_views[next_index].get(),
+                    .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                },
+                {
+                    .sampler = sampler.get(),
+                    .imageView = res.motion_view.get(),
+                    .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal,
+                },
+            }};
+            std::array<vk::WriteDescriptorSet, 3> set_writes{};
+            for (u32 i = 0; i < set_writes.size(); ++i) {
+                set_writes[i] = vk::WriteDescriptorSet{
+                    .dstBinding = i,
+                    .descriptorCount = 1,
+                    .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+                    .pImageInfo = &img_info[i],
+                };
+            }
+            const InterpolateConstants consts{
+                .inv_size = {1.0f / size.width, 1.0f / size.height},
+                .phase = phase,
+            };
+
+            cmdbuf.bindPipeline(vk::PipelineBindPoint::eGraphics, interpolate_pipeline.get());
+            cmdbuf.setViewport(0, vk::Viewport{
+                                      .width = static_cast<float>(output.width),
+                                      .height = static_cast<float>(output.height),
+                                      .minDepth = 0.0f,
+                                      .maxDepth = 1.0f,
+                                  });
+            cmdbuf.setScissor(0, vk::Rect2D{
+                                     .extent{
+                                         .width = output.width,
+                                         .height = output.height,
+                                     },
+                                 });
+            cmdbuf.pushDescriptorSetKHR(vk::PipelineBindPoint::eGraphics,
+                                        interpolate_pipeline_layout.get(), 0, set_writes);
+            cmdbuf.pushConstants(interpolate_pipeline_layout.get(),
+                                 vk::ShaderStageFlagBits::eFragment, 0, sizeof(consts), &consts);
+            cmdbuf.beginRendering(rendering_info);
+            cmdbuf.draw(3, 1, 0, 0);
+            cmdbuf.endRendering();
+        }
+
+        const auto post_barrier = vk::ImageMemoryBarrier2{
+            .srcStageMask = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+            .srcAccessMask = vk::AccessFlagBits2::eColorAttachmentWrite,
+            .dstStageMask = vk::PipelineStageFlagBits2::eFragmentShader,
+            .dstAccessMask = vk::AccessFlagBits2::eShaderRead,
+            .oldLayout = vk::ImageLayout::eColorAttachmentOptimal,
+            .newLayout = vk::ImageLayout::eGeneral,
+            .image = output.image,
+            .subresourceRange = SimpleSubresource,
+        };
+        cmdbuf.pipelineBarrier2(vk::DependencyInfo{
+            .imageMemoryBarrierCount = 1,
+            .pImageMemoryBarriers = &post_barrier,
+        });
+    }
+
+    // The copy must finish reading the next frame before presentation changes its layout.
+    const vk::MemoryBarrier2 read_barrier{
+        .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .dstStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+    };
+    cmdbuf.pipelineBarrier2(vk::DependencyInfo{
+        .memoryBarrierCount = 1,
+        .pMemoryBarriers = &read_barrier,
+    });
+
+    if (Config::GetSnapshot().vk_host_markers) {
+        cmdbuf.endDebugUtilsLabelEXT();
+    }
+    return can_interpolate;
+}
+
+void FrameInterpolationPass::CreateResources(vk::Extent2D size) {
+    cur_size = size;
+    cur_history = 0;
+    num_frames = 0;
+    resources.reset();
+    auto& res = resources.emplace(device, allocator);
+
+    vk::ImageCreateInfo image_create_info{
+        .imageType = vk::ImageType::e2D,
+        .format = format,
+        .extent{
+            .width = size.width,
+            .height = size.height,
+            .depth = 1,
+        },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = vk::SampleCountFlagBits::e1,
+        .usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst,
+        .initialLayout = vk::ImageLayout::eUndefined,
+    };
+    vk::ImageViewCreateInfo image_view_create_info{
+        .viewType = vk::ImageViewType::e2D,
+        .format = format,
+        .subresourceRange = SimpleSubresource,
+    };
+    for (u32 i = 0; i < res.history.size(); ++i) {
+        res.history[i].Create(image_create_info);
+        SetObjectName(device, static_cast<vk::Image>(res.history[i]),
+                      "Frame Interpolation History Image #{}", i);
+        image_view_create_info.image = res.history[i];
+        res.history_views[i] = Check<"create interpolation history image view">(
+            device.createImageViewUnique(image_view_create_info));
+    }
+
+    image_create_info.format = MotionFormat;
+    image_create_info.extent.width = (size.width + BlockSize - 1) / BlockSize;
+    image_create_info.extent.height = (size.height + BlockSize - 1) / BlockSize;
+    image_create_info.usage = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eStorage;
+    res.motion.Create(image_create_info);
+    SetObjectName(device, static_cast<vk::Image>(res.motion), "Frame Interpolation Motion Image");
+    image_view_create_info.image = res.motion;
+    image_view_create_info.format = MotionFormat;
+    res.motion_view = Check<"create interpolation motion image view">(
+        device.createImageViewUnique(image_view_create_info));
+}
+
+} // namespace Vulkan::HostPasses
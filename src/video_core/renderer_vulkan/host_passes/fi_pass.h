@@ -0,0 +1,83 @@
+//  SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+//  SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <optional>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+#include "video_core/texture_cache/image.h"
+
+namespace Vulkan {
+struct Frame;
+}
+
+namespace Vulkan::HostPasses {
+
+/**
+ * Generates intermediate frames from the last two presented frames. Block matching in compute
+ * estimates the motion between them and both frames are warped along it to the requested point
+ * in time, areas without a reliable match are blended in place. The pass keeps copies of the
+ * frames it has seen, so the interpolation does not depend on presentation frames being retained.
+ */
+class FrameInterpolationPass {
+public:
+    struct Settings {
+        bool enable{false};
+    };
+
+    void Create(vk::Device device, VmaAllocator allocator, vk::Format surface_format);
+
+    /// Returns the size of the stored frames, zero before the first frame.
+    [[nodiscard]] vk::Extent2D GetSize() const noexcept {
+        return cur_size;
+    }
+
+    /// Stores the next frame and renders the frame at phase between the previous one and it into
+    /// output. Returns false when there is no previous frame of the same size, only the next
+    /// frame is stored then. The next frame must be in general layout and is left untouched.
+    bool Render(vk::CommandBuffer cmdbuf, const Frame& next, Frame& output, float phase);
+
+    /// Forgets the stored frames, the next frame starts a new sequence.
+    void Reset() noexcept {
+        num_frames = 0;
+    }
+
+private:
+    static constexpr u32 BlockSize = 16;
+
+    struct Resources {
+        explicit Resources(vk::Device device, VmaAllocator allocator)
+            : history{VideoCore::UniqueImage{device, allocator},
+                      VideoCore::UniqueImage{device, allocator}},
+              motion{device, allocator} {}
+
+        std::array<VideoCore::UniqueImage, 2> history;
+        std::array<vk::UniqueImageView, 2> history_views;
+        VideoCore::UniqueImage motion;
+        vk::UniqueImageView motion_view;
+    };
+
+    void CreateResources(vk::Extent2D size);
+
+    vk::Device device{};
+    VmaAllocator allocator{};
+    vk::Format format{};
+
+    vk::UniqueSampler sampler{};
+    vk::UniqueDescriptorSetLayout motion_set_layout{};
+    vk::UniquePipelineLayout motion_pipeline_layout{};
+    vk::UniquePipeline motion_pipeline{};
+    vk::UniqueDescriptorSetLayout interpolate_set_layout{};
+    vk::UniquePipelineLayout interpolate_pipeline_layout{};
+    vk::UniquePipeline interpolate_pipeline{};
+
+    std::optional<Resources> resources;
+    vk::Extent2D cur_size{};
+    u32 cur_history{};
+    u32 num_frames{};
+};
+
+} // namespace Vulkan::HostPasses
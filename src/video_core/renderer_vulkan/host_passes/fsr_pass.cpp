@@ -164,7 +164,7 @@ vk::ImageView FsrPass::Render(vk::CommandBuffer cmdbuf, vk::ImageView input,
         CreateImages(img);
     }
 
-    if (Config::getVkHostMarkersEnabled()) {
+    if (Config::GetSnapshot().vk_host_markers) {
         cmdbuf.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT{
             .pLabelName = "Host/FSR",
         });
@@ -387,7 +387,7 @@ vk::ImageView FsrPass::Render(vk::CommandBuffer cmdbuf, vk::ImageView input,
         .pImageMemoryBarriers = return_barrier.data(),
     });
 
-    if (Config::getVkHostMarkersEnabled()) {
+    if (Config::GetSnapshot().vk_host_markers) {
         cmdbuf.endDebugUtilsLabelEXT();
     }
 
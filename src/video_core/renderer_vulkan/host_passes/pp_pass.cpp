@@ -188,7 +188,7 @@ void PostProcessingPass::Create(vk::Device device, const vk::Format surface_form
 
 void PostProcessingPass::Render(vk::CommandBuffer cmdbuf, vk::ImageView input,
                                 vk::Extent2D input_size, Frame& frame, Settings settings) {
-    if (Config::getVkHostMarkersEnabled()) {
+    if (Config::GetSnapshot().vk_host_markers) {
         cmdbuf.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT{
             .pLabelName = "Host/Post processing",
         });
@@ -279,7 +279,7 @@ void PostProcessingPass::Render(vk::CommandBuffer cmdbuf, vk::ImageView input,
         .pImageMemoryBarriers = &post_barrier,
     });
 
-    if (Config::getVkHostMarkersEnabled()) {
+    if (Config::GetSnapshot().vk_host_markers) {
         cmdbuf.endDebugUtilsLabelEXT();
     }
 }
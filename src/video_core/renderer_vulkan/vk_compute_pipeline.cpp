@@ -7,30 +7,30 @@
 #include "video_core/renderer_vulkan/vk_compute_pipeline.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/texture_cache/texture_heap.h"
 
 namespace Vulkan {
 
 ComputePipeline::ComputePipeline(const Instance& instance, Scheduler& scheduler,
-                                 DescriptorHeap& desc_heap, const Shader::Profile& profile,
-                                 vk::PipelineCache pipeline_cache, ComputePipelineKey compute_key_,
-                                 const Shader::Info& info_, vk::ShaderModule module)
-    : Pipeline{instance, scheduler, desc_heap, profile, pipeline_cache, true},
+                                 DescriptorHeap& desc_heap,
+                                 const VideoCore::TextureHeap* texture_heap,
+                                 const Shader::Profile& profile, vk::PipelineCache pipeline_cache,
+                                 ComputePipelineKey compute_key_, const Shader::Info& info_,
+                                 vk::ShaderModule module)
+    : Pipeline{instance, scheduler, desc_heap, texture_heap, profile, pipeline_cache, true},
       compute_key{compute_key_} {
     auto& info = stages[int(Shader::LogicalStage::Compute)];
     info = &info_;
-    const auto debug_str = GetDebugString();
-
-    const vk::PipelineShaderStageCreateInfo shader_ci = {
-        .stage = vk::ShaderStageFlagBits::eCompute,
-        .module = module,
-        .pName = "main",
-    };
+    // Cross lane operations were written for 64 wide waves, run them the same way when the host
+    // allows it instead of letting the driver pick a narrower subgroup.
+    require_wave64 = instance.IsComputeWave64Supported() &&
+                     (info->uses_lane_id || info->uses_group_quad || info->uses_group_ballot ||
+                      info->uses_group_shuffle);
 
     u32 binding{};
-    boost::container::small_vector<vk::DescriptorSetLayoutBinding, 32> bindings;
     for (const auto& buffer : info->buffers) {
         const auto sharp = buffer.GetSharp(*info);
-        bindings.push_back({
+        layout_bindings.push_back({
             .binding = binding++,
             .descriptorType = buffer.IsStorage(sharp) ? vk::DescriptorType::eStorageBuffer
                                                       : vk::DescriptorType::eUniformBuffer,
@@ -39,7 +39,10 @@ ComputePipeline::ComputePipeline(const Instance& instance, Scheduler& scheduler,
         });
     }
     for (const auto& image : info->images) {
-        bindings.push_back({
+        if (info->IsTextureHeapImage(image)) {
+            continue;
+        }
+        layout_bindings.push_back({
             .binding = binding++,
             .descriptorType = image.is_written ? vk::DescriptorType::eStorageImage
                                                : vk::DescriptorType::eSampledImage,
@@ -48,7 +51,7 @@ ComputePipeline::ComputePipeline(const Instance& instance, Scheduler& scheduler,
         });
     }
     for (const auto& sampler : info->samplers) {
-        bindings.push_back({
+        layout_bindings.push_back({
             .binding = binding++,
             .descriptorType = vk::DescriptorType::eSampler,
             .descriptorCount = 1,
@@ -56,33 +59,52 @@ ComputePipeline::ComputePipeline(const Instance& instance, Scheduler& scheduler,
         });
     }
 
+    Create(pipeline_cache, module);
+}
+
+ComputePipeline::ComputePipeline(const Instance& instance, Scheduler& scheduler,
+                                 DescriptorHeap& desc_heap,
+                                 const VideoCore::TextureHeap* texture_heap,
+                                 const Shader::Profile& profile, vk::PipelineCache pipeline_cache,
+                                 const ComputePipelineRecipe& recipe, vk::ShaderModule module)
+    : Pipeline{instance, scheduler, desc_heap, texture_heap, profile, pipeline_cache, true},
+      compute_key{},
+      require_wave64{recipe.require_wave64 && instance.IsComputeWave64Supported()} {
+    layout_bindings.assign(recipe.layout_bindings.begin(), recipe.layout_bindings.end());
+    Create(pipeline_cache, module);
+}
+
+void ComputePipeline::Create(vk::PipelineCache pipeline_cache, vk::ShaderModule module) {
+    const auto device = instance.GetDevice();
+    const auto debug_str = GetDebugString();
+
+    const vk::PipelineShaderStageRequiredSubgroupSizeCreateInfo subgroup_size_ci = {
+        .requiredSubgroupSize = 64,
+    };
+    const vk::PipelineShaderStageCreateInfo shader_ci = {
+        .pNext = require_wave64 ? &subgroup_size_ci : nullptr,
+        .stage = vk::ShaderStageFlagBits::eCompute,
+        .module = module,
+        .pName = "main",
+    };
+
     const vk::PushConstantRange push_constants = {
         .stageFlags = vk::ShaderStageFlagBits::eCompute,
         .offset = 0,
         .size = sizeof(Shader::PushData),
     };
 
-    uses_push_descriptors = binding < instance.MaxPushDescriptors();
-    const auto flags = uses_push_descriptors
-                           ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR
-                           : vk::DescriptorSetLayoutCreateFlagBits{};
-    const vk::DescriptorSetLayoutCreateInfo desc_layout_ci = {
-        .flags = flags,
-        .bindingCount = static_cast<u32>(bindings.size()),
-        .pBindings = bindings.data(),
-    };
-    const auto device = instance.GetDevice();
-    auto [descriptor_set_result, descriptor_set] =
-        device.createDescriptorSetLayoutUnique(desc_layout_ci);
-    ASSERT_MSG(descriptor_set_result == vk::Result::eSuccess,
-               "Failed to create compute descriptor set layout: {}",
-               vk::to_string(descriptor_set_result));
-    desc_layout = std::move(descriptor_set);
+    CreateDescSetLayout();
 
-    const vk::DescriptorSetLayout set_layout = *desc_layout;
+    // The texture heap is bound to the second set of every pipeline when enabled.
+    std::array<vk::DescriptorSetLayout, 2> set_layouts{*desc_layout};
+    const u32 num_set_layouts = texture_heap ? 2U : 1U;
+    if (texture_heap) {
+        set_layouts[1] = texture_heap->Layout();
+    }
     const vk::PipelineLayoutCreateInfo layout_info = {
-        .setLayoutCount = 1U,
-        .pSetLayouts = &set_layout,
+        .setLayoutCount = num_set_layouts,
+        .pSetLayouts = set_layouts.data(),
         .pushConstantRangeCount = 1U,
         .pPushConstantRanges = &push_constants,
     };
@@ -93,6 +115,7 @@ ComputePipeline::ComputePipeline(const Instance& instance, Scheduler& scheduler,
     SetObjectName(device, *pipeline_layout, "Compute PipelineLayout {}", debug_str);
 
     const vk::ComputePipelineCreateInfo compute_pipeline_ci = {
+        .flags = GetLayoutPipelineFlags(),
         .stage = shader_ci,
         .layout = *pipeline_layout,
     };
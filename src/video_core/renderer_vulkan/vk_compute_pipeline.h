@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "video_core/renderer_vulkan/vk_common.h"
 #include "video_core/renderer_vulkan/vk_pipeline_common.h"
 
@@ -28,16 +30,37 @@ struct ComputePipelineKey {
     }
 };
 
+/// Subset of pipeline state that allows recreating a compute pipeline without guest state.
+struct ComputePipelineRecipe {
+    u64 spirv_key;
+    std::vector<vk::DescriptorSetLayoutBinding> layout_bindings;
+    bool require_wave64{};
+};
+
 class ComputePipeline : public Pipeline {
 public:
     ComputePipeline(const Instance& instance, Scheduler& scheduler, DescriptorHeap& desc_heap,
-                    const Shader::Profile& profile, vk::PipelineCache pipeline_cache,
-                    ComputePipelineKey compute_key, const Shader::Info& info,
+                    const VideoCore::TextureHeap* texture_heap, const Shader::Profile& profile,
+                    vk::PipelineCache pipeline_cache, ComputePipelineKey compute_key,
+                    const Shader::Info& info, vk::ShaderModule module);
+    /// Builds a pipeline from a recorded recipe, used to warm up the driver pipeline cache.
+    ComputePipeline(const Instance& instance, Scheduler& scheduler, DescriptorHeap& desc_heap,
+                    const VideoCore::TextureHeap* texture_heap, const Shader::Profile& profile,
+                    vk::PipelineCache pipeline_cache, const ComputePipelineRecipe& recipe,
                     vk::ShaderModule module);
     ~ComputePipeline();
 
+    /// Returns true when the pipeline was created with 64 wide subgroups.
+    bool RequiresWave64() const noexcept {
+        return require_wave64;
+    }
+
+private:
+    void Create(vk::PipelineCache pipeline_cache, vk::ShaderModule module);
+
 private:
     ComputePipelineKey compute_key;
+    bool require_wave64{};
 };
 
 } // namespace Vulkan
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "common/assert.h"
+#include "common/debug.h"
+#include "video_core/renderer_vulkan/vk_compute_scheduler.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+
+namespace Vulkan {
+
+ComputeScheduler::ComputeScheduler(const Instance& instance_)
+    : instance{instance_}, master_semaphore{instance},
+      command_pool{instance, &master_semaphore, vk::CommandBufferLevel::ePrimary,
+                   instance.GetGraphicsQueueFamilyIndex()} {}
+
+ComputeScheduler::~ComputeScheduler() {
+    Submit();
+    master_semaphore.Wait(master_semaphore.CurrentTick() - 1);
+}
+
+vk::CommandBuffer ComputeScheduler::Begin(vk::Semaphore graphics_timeline, u64 graphics_tick) {
+    if (current_cmdbuf) {
+        return current_cmdbuf;
+    }
+    current_cmdbuf = command_pool.Commit();
+    const vk::CommandBufferBeginInfo begin_info = {
+        .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+    };
+    const auto begin_result = current_cmdbuf.begin(begin_info);
+    ASSERT_MSG(begin_result == vk::Result::eSuccess, "Failed to begin compute command buffer: {}",
+               vk::to_string(begin_result));
+    wait_semaphore = graphics_timeline;
+    wait_tick = graphics_tick;
+    return current_cmdbuf;
+}
+
+u64 ComputeScheduler::Submit() {
+    if (!current_cmdbuf) {
+        return 0;
+    }
+    RENDERER_TRACE;
+    const auto end_result = current_cmdbuf.end();
+    ASSERT_MSG(end_result == vk::Result::eSuccess, "Failed to end compute command buffer: {}",
+               vk::to_string(end_result));
+
+    const u64 signal_value = master_semaphore.NextTick();
+    const vk::Semaphore timeline = master_semaphore.Handle();
+    const vk::PipelineStageFlags wait_stage_mask = vk::PipelineStageFlagBits::eAllCommands;
+    const vk::TimelineSemaphoreSubmitInfo timeline_si = {
+        .waitSemaphoreValueCount = 1,
+        .pWaitSemaphoreValues = &wait_tick,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &signal_value,
+    };
+    const vk::SubmitInfo submit_info = {
+        .pNext = &timeline_si,
+        .waitSemaphoreCount = 1,
+        .pWaitSemaphores = &wait_semaphore,
+        .pWaitDstStageMask = &wait_stage_mask,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &current_cmdbuf,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &timeline,
+    };
+    const auto submit_result = instance.GetComputeQueue().submit(submit_info);
+    ASSERT_MSG(submit_result != vk::Result::eErrorDeviceLost, "Device lost during submit");
+
+    current_cmdbuf = vk::CommandBuffer{};
+    unwaited_tick = signal_value;
+    master_semaphore.Refresh();
+    return signal_value;
+}
+
+} // namespace Vulkan
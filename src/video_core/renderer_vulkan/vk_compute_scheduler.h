@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <utility>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_master_semaphore.h"
+#include "video_core/renderer_vulkan/vk_resource_pool.h"
+
+namespace Vulkan {
+
+class Instance;
+
+/**
+ * Records guest compute ring dispatches on the async compute queue, so they run alongside the
+ * graphics work submitted after them. A batch waits for the graphics submission that precedes its
+ * first dispatch and is submitted on the next release or wait packet of the ring, or right before
+ * the next graphics submission at the latest. The graphics timeline is only signaled once every
+ * batch submitted ahead of it has completed, so resources retired by graphics ticks stay valid.
+ */
+class ComputeScheduler {
+public:
+    explicit ComputeScheduler(const Instance& instance);
+    ~ComputeScheduler();
+
+    ComputeScheduler(const ComputeScheduler&) = delete;
+    ComputeScheduler& operator=(const ComputeScheduler&) = delete;
+
+    /// Returns the command buffer of the open batch, opening one that waits for the given
+    /// graphics tick if needed.
+    [[nodiscard]] vk::CommandBuffer Begin(vk::Semaphore graphics_timeline, u64 graphics_tick);
+
+    /// Returns true while a batch is being recorded.
+    [[nodiscard]] bool IsRecording() const noexcept {
+        return static_cast<bool>(current_cmdbuf);
+    }
+
+    /// Submits the open batch to the compute queue and returns its tick, zero if none was open.
+    u64 Submit();
+
+    /// Returns the tick of the last batch the graphics timeline has not waited for yet, zero if
+    /// every batch was already waited for.
+    u64 Flush() noexcept {
+        return std::exchange(unwaited_tick, 0);
+    }
+
+    /// Returns the compute timeline semaphore.
+    [[nodiscard]] vk::Semaphore Semaphore() const noexcept {
+        return master_semaphore.Handle();
+    }
+
+private:
+    const Instance& instance;
+    MasterSemaphore master_semaphore;
+    CommandPool command_pool;
+    vk::CommandBuffer current_cmdbuf{};
+    vk::Semaphore wait_semaphore{};
+    u64 wait_tick{};
+    u64 unwaited_tick{};
+};
+
+} // namespace Vulkan
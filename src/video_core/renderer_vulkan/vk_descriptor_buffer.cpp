@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+
+#include "common/assert.h"
+#include "video_core/buffer_cache/buffer.h"
+#include "video_core/renderer_vulkan/vk_descriptor_buffer.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_platform.h"
+
+namespace Vulkan {
+
+constexpr vk::BufferUsageFlags RingFlags =
+    vk::BufferUsageFlagBits::eResourceDescriptorBufferEXT |
+    vk::BufferUsageFlagBits::eSamplerDescriptorBufferEXT |
+    vk::BufferUsageFlagBits::eShaderDeviceAddress;
+
+DescriptorBuffer::DescriptorBuffer(const Instance& instance_, Scheduler& scheduler)
+    : instance{instance_} {
+    const auto& props = instance.GetDescriptorBufferProperties();
+    const u64 ring_size = std::min({MaxRingSize, props.maxResourceDescriptorBufferRange,
+                                    props.maxSamplerDescriptorBufferRange});
+    ring = std::make_unique<VideoCore::StreamBuffer>(
+        instance, scheduler, VideoCore::MemoryUsage::Stream, ring_size, RingFlags);
+    ring_address = ring->BufferDeviceAddress();
+    offset_alignment = props.descriptorBufferOffsetAlignment;
+    SetObjectName(instance.GetDevice(), ring->Handle(), "DescriptorBuffer");
+}
+
+DescriptorBuffer::~DescriptorBuffer() = default;
+
+bool DescriptorBuffer::IsSupported(const Instance& instance) {
+    // Null descriptors are needed for unbound resources, descriptor buffers have no equivalent of
+    // binding a whole buffer.
+    return instance.IsDescriptorBufferSupported() && instance.IsNullDescriptorSupported();
+}
+
+DescriptorBuffer::SetLayout DescriptorBuffer::GetSetLayout(vk::DescriptorSetLayout layout,
+                                                           u32 num_bindings) const {
+    const vk::Device device = instance.GetDevice();
+    SetLayout set_layout{device.getDescriptorSetLayoutSizeEXT(layout), {}};
+    set_layout.binding_offsets.resize(num_bindings);
+    for (u32 binding = 0; binding < num_bindings; ++binding) {
+        set_layout.binding_offsets[binding] =
+            device.getDescriptorSetLayoutBindingOffsetEXT(layout, binding);
+    }
+    return set_layout;
+}
+
+void DescriptorBuffer::Bind(vk::CommandBuffer cmdbuf, vk::PipelineBindPoint bind_point,
+                            vk::PipelineLayout layout, const SetLayout& set_layout,
+                            std::span<const vk::WriteDescriptorSet> set_writes) {
+    const vk::Device device = instance.GetDevice();
+    const auto [data, offset] = ring->Map(set_layout.size, offset_alignment);
+    ASSERT_MSG(data, "Descriptor set of {} bytes does not fit the descriptor buffer",
+               set_layout.size);
+
+    for (const auto& set_write : set_writes) {
+        const auto type = set_write.descriptorType;
+        vk::DescriptorGetInfoEXT get_info = {.type = type};
+        vk::DescriptorAddressInfoEXT address_info{};
+        switch (type) {
+        case vk::DescriptorType::eUniformBuffer:
+        case vk::DescriptorType::eStorageBuffer: {
+            // Addresses are not tracked per buffer object, the handle is all the write holds.
+            const auto& buffer_info = *set_write.pBufferInfo;
+            const vk::DescriptorAddressInfoEXT* address = nullptr;
+            if (buffer_info.buffer) {
+                address_info.address =
+                    device.getBufferAddress({.buffer = buffer_info.buffer}) + buffer_info.offset;
+                address_info.range = buffer_info.range;
+                address = &address_info;
+            }
+            if (type == vk::DescriptorType::eUniformBuffer) {
+                get_info.data.pUniformBuffer = address;
+            } else {
+                get_info.data.pStorageBuffer = address;
+            }
+            break;
+        }
+        case vk::DescriptorType::eSampledImage:
+            get_info.data.pSampledImage = set_write.pImageInfo;
+            break;
+        case vk::DescriptorType::eStorageImage:
+            get_info.data.pStorageImage = set_write.pImageInfo;
+            break;
+        case vk::DescriptorType::eSampler:
+            get_info.data.pSampler = &set_write.pImageInfo->sampler;
+            break;
+        default:
+            UNREACHABLE_MSG("Unsupported descriptor type {}", vk::to_string(type));
+        }
+        device.getDescriptorEXT(get_info, DescriptorSize(type),
+                                data + set_layout.binding_offsets[set_write.dstBinding]);
+    }
+    ring->Commit();
+
+    if (!is_bound) {
+        cmdbuf.bindDescriptorBuffersEXT(vk::DescriptorBufferBindingInfoEXT{
+            .address = ring_address,
+            .usage = RingFlags,
+        });
+        is_bound = true;
+    }
+    const u32 buffer_index = 0;
+    const vk::DeviceSize set_offset = offset;
+    cmdbuf.setDescriptorBufferOffsetsEXT(bind_point, layout, 0, buffer_index, set_offset);
+}
+
+size_t DescriptorBuffer::DescriptorSize(vk::DescriptorType type) const {
+    const auto& props = instance.GetDescriptorBufferProperties();
+    const bool robust = instance.IsRobustBufferAccessEnabled();
+    switch (type) {
+    case vk::DescriptorType::eUniformBuffer:
+        return robust ? props.robustUniformBufferDescriptorSize
+                      : props.uniformBufferDescriptorSize;
+    case vk::DescriptorType::eStorageBuffer:
+        return robust ? props.robustStorageBufferDescriptorSize
+                      : props.storageBufferDescriptorSize;
+    case vk::DescriptorType::eSampledImage:
+        return props.sampledImageDescriptorSize;
+    case vk::DescriptorType::eStorageImage:
+        return props.storageImageDescriptorSize;
+    case vk::DescriptorType::eSampler:
+        return props.samplerDescriptorSize;
+    default:
+        UNREACHABLE_MSG("Unsupported descriptor type {}", vk::to_string(type));
+    }
+}
+
+} // namespace Vulkan
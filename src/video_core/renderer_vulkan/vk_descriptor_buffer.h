@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <span>
+#include <boost/container/small_vector.hpp>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace VideoCore {
+class StreamBuffer;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * Binds descriptor sets with VK_EXT_descriptor_buffer. The descriptors of every draw and dispatch
+ * are written straight into a host visible ring and bound by offset, which avoids allocating sets
+ * from pools and the driver side work of descriptor set updates. The ring is bound once per
+ * command buffer, sets only change its offset afterwards.
+ */
+class DescriptorBuffer {
+public:
+    static constexpr u64 MaxRingSize = 32_MB;
+
+    struct SetLayout {
+        u64 size{};
+        boost::container::small_vector<u64, 32> binding_offsets;
+    };
+
+    explicit DescriptorBuffer(const Instance& instance, Scheduler& scheduler);
+    ~DescriptorBuffer();
+
+    DescriptorBuffer(const DescriptorBuffer&) = delete;
+    DescriptorBuffer& operator=(const DescriptorBuffer&) = delete;
+
+    /// Returns true if the device can bind every descriptor the pipelines use from a buffer.
+    [[nodiscard]] static bool IsSupported(const Instance& instance);
+
+    /// Queries the size and binding offsets of a layout created for descriptor buffers.
+    [[nodiscard]] SetLayout GetSetLayout(vk::DescriptorSetLayout layout, u32 num_bindings) const;
+
+    /// Writes the descriptors of a set into the ring and binds them to set 0 of the layout.
+    void Bind(vk::CommandBuffer cmdbuf, vk::PipelineBindPoint bind_point,
+              vk::PipelineLayout layout, const SetLayout& set_layout,
+              std::span<const vk::WriteDescriptorSet> set_writes);
+
+    /// Called when a new command buffer begins, the ring has to be bound to it again.
+    void Invalidate() noexcept {
+        is_bound = false;
+    }
+
+private:
+    [[nodiscard]] size_t DescriptorSize(vk::DescriptorType type) const;
+
+    const Instance& instance;
+    std::unique_ptr<VideoCore::StreamBuffer> ring;
+    vk::DeviceAddress ring_address{};
+    vk::DeviceSize offset_alignment{};
+    bool is_bound{};
+};
+
+} // namespace Vulkan
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <utility>
+
+#include "common/assert.h"
+#include "video_core/buffer_cache/buffer.h"
+#include "video_core/renderer_vulkan/vk_draw_batcher.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_platform.h"
+
+namespace Vulkan {
+
+constexpr u64 CommandRingSize = 4_MB;
+
+DrawBatcher::DrawBatcher(const Instance& instance_, Scheduler& scheduler) : instance{instance_} {
+    if (instance.IsMultiDrawIndirectSupported()) {
+        command_buffer = std::make_unique<VideoCore::StreamBuffer>(
+            instance, scheduler, VideoCore::MemoryUsage::Stream, CommandRingSize,
+            vk::BufferUsageFlagBits::eIndirectBuffer);
+        SetObjectName(instance.GetDevice(), command_buffer->Handle(), "DrawBatchCommands");
+    }
+    draws.reserve(MaxDraws);
+}
+
+DrawBatcher::~DrawBatcher() = default;
+
+void DrawBatcher::Begin(const Key& new_key, u64 new_index_offset) {
+    ASSERT_MSG(draws.empty(), "Draw batch was not recorded before the next one");
+    key = new_key;
+    index_offset = new_index_offset;
+}
+
+void DrawBatcher::Flush(vk::CommandBuffer cmdbuf) {
+    if (draws.empty()) {
+        return;
+    }
+    const u32 num_draws = static_cast<u32>(draws.size());
+    const u32 stride = key.is_indexed ? sizeof(vk::DrawIndexedIndirectCommand)
+                                      : sizeof(vk::DrawIndirectCommand);
+    // Never wait for the ring here, the command buffer may be in the middle of a submission.
+    const auto [data, offset] = num_draws > 1 && command_buffer
+                                    ? command_buffer->Map(num_draws * stride, stride, false)
+                                    : std::pair<u8*, u64>{};
+    if (!data) {
+        for (const Draw& draw : draws) {
+            if (key.is_indexed) {
+                cmdbuf.drawIndexed(draw.count, draw.num_instances, draw.first, draw.vertex_offset,
+                                   draw.first_instance);
+            } else {
+                cmdbuf.draw(draw.count, draw.num_instances, draw.first, draw.first_instance);
+            }
+        }
+        draws.clear();
+        return;
+    }
+
+    if (key.is_indexed) {
+        auto* commands = reinterpret_cast<vk::DrawIndexedIndirectCommand*>(data);
+        for (u32 i = 0; i < num_draws; ++i) {
+            const Draw& draw = draws[i];
+            commands[i] = vk::DrawIndexedIndirectCommand{
+                draw.count, draw.num_instances, draw.first, draw.vertex_offset, draw.first_instance,
+            };
+        }
+        command_buffer->Commit();
+        cmdbuf.drawIndexedIndirect(command_buffer->Handle(), offset, num_draws, stride);
+    } else {
+        auto* commands = reinterpret_cast<vk::DrawIndirectCommand*>(data);
+        for (u32 i = 0; i < num_draws; ++i) {
+            const Draw& draw = draws[i];
+            commands[i] = vk::DrawIndirectCommand{draw.count, draw.num_instances, draw.first,
+                                                  draw.first_instance};
+        }
+        command_buffer->Commit();
+        cmdbuf.drawIndirect(command_buffer->Handle(), offset, num_draws, stride);
+    }
+    draws.clear();
+}
+
+} // namespace Vulkan
@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace VideoCore {
+class StreamBuffer;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * Merges consecutive draws that only differ in their draw parameters. The first draw of a batch
+ * records its bindings as usual but its draw command is held back, following draws with the
+ * same key only append their parameters. The batch is recorded as a single multi draw indirect
+ * call whenever any other command is about to be recorded, or as plain draws if the device
+ * cannot source the first instance from indirect commands.
+ */
+class DrawBatcher {
+public:
+    static constexpr u32 MaxDraws = 1024;
+
+    /// Draws share a key when they record the same pipeline, resources and buffer bindings.
+    struct Key {
+        const void* pipeline;
+        u64 bindings_hash;
+        u64 vertex_hash;
+        vk::Buffer index_buffer;
+        vk::IndexType index_type;
+        bool is_indexed;
+
+        bool operator==(const Key&) const = default;
+    };
+
+    /// Count and first are in indices for indexed draws.
+    struct Draw {
+        u32 count;
+        u32 num_instances;
+        u32 first;
+        s32 vertex_offset;
+        u32 first_instance;
+    };
+
+    explicit DrawBatcher(const Instance& instance, Scheduler& scheduler);
+    ~DrawBatcher();
+
+    DrawBatcher(const DrawBatcher&) = delete;
+    DrawBatcher& operator=(const DrawBatcher&) = delete;
+
+    /// Returns true if a draw with the provided key can be appended to the open batch.
+    [[nodiscard]] bool CanAppend(const Key& new_key) const noexcept {
+        return !draws.empty() && draws.size() < MaxDraws && key == new_key;
+    }
+
+    /// Returns the offset the index buffer of the open batch is bound at.
+    [[nodiscard]] u64 GetIndexOffset() const noexcept {
+        return index_offset;
+    }
+
+    /// Opens a new batch, the previous one must have been recorded.
+    void Begin(const Key& new_key, u64 new_index_offset);
+
+    /// Appends a draw to the open batch.
+    void Append(const Draw& draw) {
+        draws.push_back(draw);
+    }
+
+    /// Records the open batch into the command buffer.
+    void Flush(vk::CommandBuffer cmdbuf);
+
+private:
+    const Instance& instance;
+    std::unique_ptr<VideoCore::StreamBuffer> command_buffer;
+    std::vector<Draw> draws;
+    Key key{};
+    u64 index_offset{};
+};
+
+} // namespace Vulkan
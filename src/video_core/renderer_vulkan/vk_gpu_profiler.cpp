@@ -0,0 +1,226 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cstring>
+
+#include "common/assert.h"
+#include "common/debug.h"
+#include "video_core/renderer_vulkan/vk_gpu_profiler.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_platform.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+
+namespace Vulkan {
+
+namespace {
+
+/// Splits a range of the query ring in at most two ranges that do not wrap around.
+template <typename Func>
+void ForEachQueryRange(u32 first, u32 count, Func&& func) {
+    const u32 head = std::min(count, GpuProfiler::MaxQueries - first);
+    func(first, head, 0U);
+    if (head < count) {
+        func(0U, count - head, head);
+    }
+}
+
+} // Anonymous namespace
+
+GpuProfiler::GpuProfiler(const Instance& instance_, Scheduler& scheduler_)
+    : instance{instance_}, scheduler{scheduler_} {
+    const vk::Device device = instance.GetDevice();
+    const vk::QueryPoolCreateInfo pool_ci = {
+        .queryType = vk::QueryType::eTimestamp,
+        .queryCount = MaxQueries,
+    };
+    auto [pool_result, pool] = device.createQueryPoolUnique(pool_ci);
+    ASSERT_MSG(pool_result == vk::Result::eSuccess, "Failed to create query pool: {}",
+               vk::to_string(pool_result));
+    query_pool = std::move(pool);
+    device.resetQueryPool(*query_pool, 0, MaxQueries);
+    SetObjectName(device, *query_pool, "GpuProfilerQueries");
+
+    frames.push_back({WriteTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, true), InvalidQuery,
+                      0, {}});
+}
+
+GpuProfiler::~GpuProfiler() {
+    SuspendTracyZones();
+}
+
+void GpuProfiler::BeginZone(std::string_view name) {
+    PendingFrame& frame = frames.back();
+    const u32 depth = static_cast<u32>(open_zones.size()) + 1;
+    const u32 query = WriteTimestamp(vk::PipelineStageFlagBits::eTopOfPipe);
+    open_zones.push_back(static_cast<u32>(frame.zones.size()));
+    frame.zones.push_back({std::string{name}, depth, query, InvalidQuery});
+#if TRACY_GPU_ENABLED
+    if (auto* profiler_ctx = instance.GetProfilerContext()) {
+        tracy_zones.push_back(new tracy::VkCtxScope{
+            profiler_ctx, TracyLine, TracyFile, std::strlen(TracyFile), TracyFunction,
+            std::strlen(TracyFunction), name.data(), name.size(), scheduler.CommandBuffer(), true});
+    }
+#endif
+}
+
+void GpuProfiler::EndZone() {
+    if (open_zones.empty()) {
+        // Guest markers are not guaranteed to be balanced.
+        return;
+    }
+    const u32 index = open_zones.back();
+    open_zones.pop_back();
+    frames.back().zones[index].end_query =
+        WriteTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe);
+#if TRACY_GPU_ENABLED
+    if (!tracy_zones.empty()) {
+        delete tracy_zones.back();
+        tracy_zones.pop_back();
+    }
+#endif
+}
+
+void GpuProfiler::BeginRenderPass() {
+    if (open_pass != InvalidQuery) {
+        return;
+    }
+    PendingFrame& frame = frames.back();
+    open_pass = static_cast<u32>(frame.zones.size());
+    frame.zones.push_back(
+        {"RenderPass", 0, WriteTimestamp(vk::PipelineStageFlagBits::eTopOfPipe), InvalidQuery});
+}
+
+void GpuProfiler::EndRenderPass() {
+    if (open_pass == InvalidQuery) {
+        return;
+    }
+    frames.back().zones[open_pass].end_query =
+        WriteTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe);
+    open_pass = InvalidQuery;
+}
+
+void GpuProfiler::EndFrame() {
+    const u32 query = WriteTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, true);
+    if (query == InvalidQuery) {
+        // Every query is in flight, the frame keeps growing until some are resolved.
+        return;
+    }
+    PendingFrame& frame = frames.back();
+    frame.end_query = query;
+    frame.tick = scheduler.CurrentTick();
+
+    // The boundary timestamp ends the open zones and starts their continuation.
+    PendingFrame next{query, InvalidQuery, 0, {}};
+    const auto split = [&](u32& index) {
+        PendingZone& zone = frame.zones[index];
+        zone.end_query = query;
+        index = static_cast<u32>(next.zones.size());
+        next.zones.push_back({zone.name, zone.depth, query, InvalidQuery});
+    };
+    if (open_pass != InvalidQuery) {
+        split(open_pass);
+    }
+    for (u32& index : open_zones) {
+        split(index);
+    }
+    frames.push_back(std::move(next));
+}
+
+void GpuProfiler::Collect() {
+    const vk::Device device = instance.GetDevice();
+    while (frames.size() > 1) {
+        const PendingFrame& frame = frames.front();
+        if (!scheduler.IsFree(frame.tick)) {
+            break;
+        }
+        ResolveFrame(frame);
+        // The end query is the beginning of the next frame and is released with it.
+        const u32 count = (frame.end_query + MaxQueries - frame.begin_query) % MaxQueries;
+        ForEachQueryRange(frame.begin_query, count, [&](u32 first, u32 num, u32) {
+            device.resetQueryPool(*query_pool, first, num);
+        });
+        num_used_queries -= count;
+        frames.pop_front();
+    }
+}
+
+void GpuProfiler::SuspendTracyZones() {
+#if TRACY_GPU_ENABLED
+    while (!tracy_zones.empty()) {
+        delete tracy_zones.back();
+        tracy_zones.pop_back();
+    }
+#endif
+}
+
+void GpuProfiler::ResumeTracyZones(vk::CommandBuffer cmdbuf) {
+#if TRACY_GPU_ENABLED
+    auto* profiler_ctx = instance.GetProfilerContext();
+    if (!profiler_ctx) {
+        return;
+    }
+    for (const u32 index : open_zones) {
+        const std::string& name = frames.back().zones[index].name;
+        tracy_zones.push_back(new tracy::VkCtxScope{
+            profiler_ctx, TracyLine, TracyFile, std::strlen(TracyFile), TracyFunction,
+            std::strlen(TracyFunction), name.data(), name.size(), cmdbuf, true});
+    }
+#endif
+}
+
+GpuProfiler::Frame GpuProfiler::GetLastFrame() const {
+    std::scoped_lock lk{frame_mutex};
+    return last_frame;
+}
+
+u32 GpuProfiler::WriteTimestamp(vk::PipelineStageFlagBits stage, bool is_frame_boundary) {
+    const u32 reserved = is_frame_boundary ? 0 : 1;
+    if (num_used_queries + reserved >= MaxQueries) {
+        return InvalidQuery;
+    }
+    const u32 query = next_query;
+    next_query = (next_query + 1) % MaxQueries;
+    ++num_used_queries;
+    scheduler.CommandBuffer().writeTimestamp(stage, *query_pool, query);
+    return query;
+}
+
+void GpuProfiler::ReadQueries(u32 first, u32 count, std::span<u64> results) const {
+    const vk::Device device = instance.GetDevice();
+    ForEachQueryRange(first, count, [&](u32 range_first, u32 num, u32 offset) {
+        const auto result = device.getQueryPoolResults(
+            *query_pool, range_first, num, num * sizeof(u64), results.data() + offset,
+            sizeof(u64), vk::QueryResultFlagBits::e64);
+        if (result != vk::Result::eSuccess) {
+            std::fill_n(results.begin() + offset, num, 0);
+        }
+    });
+}
+
+void GpuProfiler::ResolveFrame(const PendingFrame& frame) {
+    const u32 count = (frame.end_query + MaxQueries - frame.begin_query) % MaxQueries + 1;
+    std::vector<u64> timestamps(count);
+    ReadQueries(frame.begin_query, count, timestamps);
+
+    const double period = instance.TimestampPeriod();
+    const u64 base = timestamps[0];
+    const auto to_ns = [&](u32 query) -> u64 {
+        const u64 timestamp = timestamps[(query + MaxQueries - frame.begin_query) % MaxQueries];
+        return timestamp > base ? static_cast<u64>((timestamp - base) * period) : 0;
+    };
+
+    Frame resolved{to_ns(frame.end_query), {}};
+    resolved.zones.reserve(frame.zones.size());
+    for (const PendingZone& zone : frame.zones) {
+        if (zone.begin_query == InvalidQuery || zone.end_query == InvalidQuery) {
+            continue;
+        }
+        resolved.zones.push_back({zone.name, zone.depth, to_ns(zone.begin_query),
+                                  to_ns(zone.end_query)});
+    }
+    std::scoped_lock lk{frame_mutex};
+    last_frame = std::move(resolved);
+}
+
+} // namespace Vulkan
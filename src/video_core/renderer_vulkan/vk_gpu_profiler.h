@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace tracy {
+class VkCtxScope;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * Measures GPU time of scope markers and render passes with timestamp queries. Zones are grouped
+ * into frames that end on every guest submit, a frame is resolved once the GPU has finished its
+ * last submission so reading the results never waits. Only the latest resolved frame is kept for
+ * the devtools timeline, scope zones are also forwarded to Tracy when GPU zones are enabled.
+ */
+class GpuProfiler {
+public:
+    static constexpr u32 MaxQueries = 16384;
+
+    struct Zone {
+        std::string name;
+        /// Zero for render passes, scope markers start at one.
+        u32 depth;
+        u64 begin_ns;
+        u64 end_ns;
+    };
+
+    struct Frame {
+        u64 duration_ns{};
+        std::vector<Zone> zones;
+    };
+
+    explicit GpuProfiler(const Instance& instance, Scheduler& scheduler);
+    ~GpuProfiler();
+
+    GpuProfiler(const GpuProfiler&) = delete;
+    GpuProfiler& operator=(const GpuProfiler&) = delete;
+
+    /// Opens a zone nested in the currently open ones.
+    void BeginZone(std::string_view name);
+
+    /// Closes the innermost open zone.
+    void EndZone();
+
+    /// Opens and closes the zone of a render pass, these are tracked apart from scope markers.
+    void BeginRenderPass();
+    void EndRenderPass();
+
+    /// Ends the frame being recorded, zones that are still open continue in the next one.
+    void EndFrame();
+
+    /// Resolves all frames whose submissions have completed.
+    void Collect();
+
+    /// Ends the Tracy zones recorded in the command buffer that is about to be submitted.
+    void SuspendTracyZones();
+
+    /// Reopens the Tracy zones of the open zones in a new command buffer.
+    void ResumeTracyZones(vk::CommandBuffer cmdbuf);
+
+    /// Returns the most recently resolved frame.
+    [[nodiscard]] Frame GetLastFrame() const;
+
+private:
+    static constexpr u32 InvalidQuery = ~0U;
+
+    struct PendingZone {
+        std::string name;
+        u32 depth;
+        u32 begin_query;
+        u32 end_query;
+    };
+
+    struct PendingFrame {
+        u32 begin_query;
+        u32 end_query;
+        u64 tick;
+        std::vector<PendingZone> zones;
+    };
+
+    /// Writes a timestamp and returns its query, InvalidQuery when all queries are in flight.
+    /// One query is always kept for the frame boundary.
+    u32 WriteTimestamp(vk::PipelineStageFlagBits stage, bool is_frame_boundary = false);
+
+    void ReadQueries(u32 first, u32 count, std::span<u64> results) const;
+    void ResolveFrame(const PendingFrame& frame);
+
+    const Instance& instance;
+    Scheduler& scheduler;
+    vk::UniqueQueryPool query_pool;
+    std::deque<PendingFrame> frames;
+    std::vector<u32> open_zones;
+    /// Index of the open render pass zone in the frame being recorded.
+    u32 open_pass{InvalidQuery};
+    u32 next_query{};
+    u32 num_used_queries{};
+    mutable std::mutex frame_mutex;
+    Frame last_frame;
+    std::vector<tracy::VkCtxScope*> tracy_zones;
+};
+
+} // namespace Vulkan
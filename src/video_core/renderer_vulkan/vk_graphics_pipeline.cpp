@@ -2,16 +2,20 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <algorithm>
+#include <type_traits>
 #include <utility>
 #include <boost/container/small_vector.hpp>
 
 #include "common/assert.h"
+#include "common/thread_worker.h"
 #include "shader_recompiler/backend/spirv/emit_spirv_quad_rect.h"
 #include "video_core/renderer_vulkan/liverpool_to_vk.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_pipeline_library.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/renderer_vulkan/vk_shader_util.h"
+#include "video_core/texture_cache/texture_heap.h"
 
 namespace Vulkan {
 
@@ -26,6 +30,34 @@ static constexpr std::array LogicalStageToStageBit = {
     vk::ShaderStageFlagBits::eCompute,
 };
 
+/// Accumulates the state consumed by a pipeline library part into a single hash.
+class LibraryStateHash {
+public:
+    LibraryStateHash() {
+        XXH3_64bits_reset(&state);
+    }
+
+    template <typename T>
+    LibraryStateHash& Add(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        XXH3_64bits_update(&state, &value, sizeof(value));
+        return *this;
+    }
+
+    template <typename T, size_t Extent>
+    LibraryStateHash& Add(std::span<T, Extent> values) {
+        XXH3_64bits_update(&state, values.data(), values.size_bytes());
+        return *this;
+    }
+
+    u64 Digest() const {
+        return XXH3_64bits_digest(&state);
+    }
+
+private:
+    XXH3_state_t state;
+};
+
 static bool IsPrimitiveTopologyList(const vk::PrimitiveTopology topology) {
     return topology == vk::PrimitiveTopology::ePointList ||
            topology == vk::PrimitiveTopology::eLineList ||
@@ -37,28 +69,140 @@ static bool IsPrimitiveTopologyList(const vk::PrimitiveTopology topology) {
 
 GraphicsPipeline::GraphicsPipeline(
     const Instance& instance, Scheduler& scheduler, DescriptorHeap& desc_heap,
-    const Shader::Profile& profile, const GraphicsPipelineKey& key_,
-    vk::PipelineCache pipeline_cache, std::span<const Shader::Info*, MaxShaderStages> infos,
+    const VideoCore::TextureHeap* texture_heap, const Shader::Profile& profile,
+    const GraphicsPipelineKey& key_, vk::PipelineCache pipeline_cache,
+    std::span<const Shader::Info*, MaxShaderStages> infos,
     std::span<const Shader::RuntimeInfo, MaxShaderStages> runtime_infos,
     std::optional<const Shader::Gcn::FetchShaderData> fetch_shader_,
-    std::span<const vk::ShaderModule> modules)
-    : Pipeline{instance, scheduler, desc_heap, profile, pipeline_cache}, key{key_},
-      fetch_shader{std::move(fetch_shader_)} {
-    const vk::Device device = instance.GetDevice();
+    std::span<const vk::ShaderModule> modules, Common::ThreadWorker* worker,
+    PipelineLibraryCache* library_cache_)
+    : Pipeline{instance, scheduler, desc_heap, texture_heap, profile, pipeline_cache}, key{key_},
+      library_cache{library_cache_}, fetch_shader{std::move(fetch_shader_)} {
     std::ranges::copy(infos, stages.begin());
     BuildDescSetLayout();
-    const auto debug_str = GetDebugString();
+    CreateLayout();
 
+    VertexInputs<AmdGpu::Buffer> guest_buffers;
+    if (!instance.IsVertexInputDynamicState()) {
+        const auto& vs_info = runtime_infos[u32(Shader::LogicalStage::Vertex)].vs_info;
+        GetVertexInputs(vertex_attributes, vertex_bindings, vertex_divisors, guest_buffers,
+                        vs_info.step_rate_0, vs_info.step_rate_1);
+    }
+
+    // Everything that depends on guest state has been captured at this point, the remaining work
+    // only consumes copies and can be moved off the GPU processing thread.
+    const auto& fs_info = runtime_infos[u32(Shader::LogicalStage::Fragment)].fs_info;
+    StageModules stage_modules{};
+    for (u32 i = 0; i < std::min<size_t>(modules.size(), MaxShaderStages); ++i) {
+        stage_modules[i] = infos[i] ? modules[i] : vk::ShaderModule{};
+    }
+    if (!worker) {
+        Create(pipeline_cache, fs_info, stage_modules);
+        return;
+    }
+    is_ready.store(false, std::memory_order_relaxed);
+    worker->QueueWork([this, pipeline_cache, fs_info, stage_modules] {
+        Create(pipeline_cache, fs_info, stage_modules);
+        is_ready.store(true, std::memory_order_release);
+    });
+}
+
+GraphicsPipeline::GraphicsPipeline(const Instance& instance, Scheduler& scheduler,
+                                   DescriptorHeap& desc_heap,
+                                   const VideoCore::TextureHeap* texture_heap,
+                                   const Shader::Profile& profile,
+                                   vk::PipelineCache pipeline_cache,
+                                   const GraphicsPipelineRecipe& recipe,
+                                   const StageModules& modules)
+    : Pipeline{instance, scheduler, desc_heap, texture_heap, profile, pipeline_cache},
+      key{recipe.key} {
+    layout_bindings.assign(recipe.layout_bindings.begin(), recipe.layout_bindings.end());
+    CreateDescSetLayout();
+    CreateLayout();
+    vertex_attributes.assign(recipe.vertex_attributes.begin(), recipe.vertex_attributes.end());
+    vertex_bindings.assign(recipe.vertex_bindings.begin(), recipe.vertex_bindings.end());
+    vertex_divisors.assign(recipe.vertex_divisors.begin(), recipe.vertex_divisors.end());
+    Create(pipeline_cache, recipe.fs_info, modules);
+}
+
+vk::ColorBlendEquationEXT GraphicsPipeline::GetBlendEquation(const GraphicsPipelineKey& key,
+                                                             u32 index) {
+    const auto& control = key.blend_controls[index];
+
+    const auto src_color = LiverpoolToVK::BlendFactor(control.color_src_factor);
+    const auto dst_color = LiverpoolToVK::BlendFactor(control.color_dst_factor);
+    const auto color_blend = LiverpoolToVK::BlendOp(control.color_func);
+
+    const auto src_alpha = control.separate_alpha_blend
+                               ? LiverpoolToVK::BlendFactor(control.alpha_src_factor)
+                               : src_color;
+    const auto dst_alpha = control.separate_alpha_blend
+                               ? LiverpoolToVK::BlendFactor(control.alpha_dst_factor)
+                               : dst_color;
+    const auto alpha_blend =
+        control.separate_alpha_blend ? LiverpoolToVK::BlendOp(control.alpha_func) : color_blend;
+
+    const auto color_scaled_min_max =
+        (color_blend == vk::BlendOp::eMin || color_blend == vk::BlendOp::eMax) &&
+        (src_color != vk::BlendFactor::eOne || dst_color != vk::BlendFactor::eOne);
+    const auto alpha_scaled_min_max =
+        (alpha_blend == vk::BlendOp::eMin || alpha_blend == vk::BlendOp::eMax) &&
+        (src_alpha != vk::BlendFactor::eOne || dst_alpha != vk::BlendFactor::eOne);
+    if (color_scaled_min_max || alpha_scaled_min_max) {
+        LOG_WARNING(Render_Vulkan,
+                    "Unimplemented use of min/max blend op with blend factor not equal to one.");
+    }
+
+    vk::ColorBlendEquationEXT equation = {
+        .srcColorBlendFactor = src_color,
+        .dstColorBlendFactor = dst_color,
+        .colorBlendOp = color_blend,
+        .srcAlphaBlendFactor = src_alpha,
+        .dstAlphaBlendFactor = dst_alpha,
+        .alphaBlendOp = alpha_blend,
+    };
+
+    // On GCN GPU there is an additional mask which allows to control color components exported
+    // from a pixel shader. A situation possible, when the game may mask out the alpha channel,
+    // while it is still need to be used in blending ops. For such cases, HW will default alpha
+    // to 1 and perform the blending, while shader normally outputs 0 in the last component.
+    // Unfortunatelly, Vulkan doesn't provide any control on blend inputs, so below we detecting
+    // such cases and override alpha value in order to emulate HW behaviour.
+    const auto has_alpha_masked_out =
+        (key.cb_shader_mask.GetMask(index) & AmdGpu::ColorBufferMask::ComponentA) == 0;
+    const auto has_src_alpha_in_src_blend = src_color == vk::BlendFactor::eSrcAlpha ||
+                                            src_color == vk::BlendFactor::eOneMinusSrcAlpha;
+    const auto has_src_alpha_in_dst_blend = dst_color == vk::BlendFactor::eSrcAlpha ||
+                                            dst_color == vk::BlendFactor::eOneMinusSrcAlpha;
+    if (has_alpha_masked_out && has_src_alpha_in_src_blend) {
+        equation.srcColorBlendFactor = src_color == vk::BlendFactor::eSrcAlpha
+                                           ? vk::BlendFactor::eOne
+                                           : vk::BlendFactor::eZero; // 1-A
+    }
+    if (has_alpha_masked_out && has_src_alpha_in_dst_blend) {
+        equation.dstColorBlendFactor = dst_color == vk::BlendFactor::eSrcAlpha
+                                           ? vk::BlendFactor::eOne
+                                           : vk::BlendFactor::eZero; // 1-A
+    }
+    return equation;
+}
+
+void GraphicsPipeline::CreateLayout() {
     const vk::PushConstantRange push_constants = {
         .stageFlags = AllGraphicsStageBits,
         .offset = 0,
         .size = sizeof(Shader::PushData),
     };
 
-    const vk::DescriptorSetLayout set_layout = *desc_layout;
+    // The texture heap is bound to the second set of every pipeline when enabled.
+    std::array<vk::DescriptorSetLayout, 2> set_layouts{*desc_layout};
+    const u32 num_set_layouts = texture_heap ? 2U : 1U;
+    if (texture_heap) {
+        set_layouts[1] = texture_heap->Layout();
+    }
     const vk::PipelineLayoutCreateInfo layout_info = {
-        .setLayoutCount = 1U,
-        .pSetLayouts = &set_layout,
+        .setLayoutCount = num_set_layouts,
+        .pSetLayouts = set_layouts.data(),
         .pushConstantRangeCount = 1,
         .pPushConstantRanges = &push_constants,
     };
@@ -66,25 +210,21 @@ GraphicsPipeline::GraphicsPipeline(
     ASSERT_MSG(layout_result == vk::Result::eSuccess,
                "Failed to create graphics pipeline layout: {}", vk::to_string(layout_result));
     pipeline_layout = std::move(layout);
-    SetObjectName(device, *pipeline_layout, "Graphics PipelineLayout {}", debug_str);
-
-    VertexInputs<vk::VertexInputAttributeDescription> vertex_attributes;
-    VertexInputs<vk::VertexInputBindingDescription> vertex_bindings;
-    VertexInputs<vk::VertexInputBindingDivisorDescriptionEXT> divisors;
-    VertexInputs<AmdGpu::Buffer> guest_buffers;
-    if (!instance.IsVertexInputDynamicState()) {
-        const auto& vs_info = runtime_infos[u32(Shader::LogicalStage::Vertex)].vs_info;
-        GetVertexInputs(vertex_attributes, vertex_bindings, divisors, guest_buffers,
-                        vs_info.step_rate_0, vs_info.step_rate_1);
-    }
+    SetObjectName(instance.GetDevice(), *pipeline_layout, "Graphics PipelineLayout {}",
+                  GetDebugString());
+}
 
+void GraphicsPipeline::Create(vk::PipelineCache pipeline_cache,
+                              const Shader::FragmentRuntimeInfo& fs_info,
+                              const StageModules& modules) {
+    const vk::Device device = instance.GetDevice();
     const vk::PipelineVertexInputDivisorStateCreateInfo divisor_state = {
-        .vertexBindingDivisorCount = static_cast<u32>(divisors.size()),
-        .pVertexBindingDivisors = divisors.data(),
+        .vertexBindingDivisorCount = static_cast<u32>(vertex_divisors.size()),
+        .pVertexBindingDivisors = vertex_divisors.data(),
     };
 
     const vk::PipelineVertexInputStateCreateInfo vertex_input_info = {
-        .pNext = divisors.empty() ? nullptr : &divisor_state,
+        .pNext = vertex_divisors.empty() ? nullptr : &divisor_state,
         .vertexBindingDescriptionCount = static_cast<u32>(vertex_bindings.size()),
         .pVertexBindingDescriptions = vertex_bindings.data(),
         .vertexAttributeDescriptionCount = static_cast<u32>(vertex_attributes.size()),
@@ -102,7 +242,6 @@ GraphicsPipeline::GraphicsPipeline(
 
     const bool is_rect_list = key.prim_type == AmdGpu::PrimitiveType::RectList;
     const bool is_quad_list = key.prim_type == AmdGpu::PrimitiveType::QuadList;
-    const auto& fs_info = runtime_infos[u32(Shader::LogicalStage::Fragment)].fs_info;
     const vk::PipelineTessellationStateCreateInfo tessellation_state = {
         .patchControlPoints = is_rect_list ? 3U : (is_quad_list ? 4U : key.patch_control_points),
     };
@@ -112,7 +251,9 @@ GraphicsPipeline::GraphicsPipeline(
             .depthClampEnable = key.depth_clamp_enable &&
                                 (!key.depth_clip_enable || instance.IsDepthClipEnableSupported()),
             .rasterizerDiscardEnable = false,
-            .polygonMode = LiverpoolToVK::PolygonMode(key.polygon_mode),
+            .polygonMode = instance.IsDynamicPolygonModeSupported()
+                               ? vk::PolygonMode::eFill
+                               : LiverpoolToVK::PolygonMode(key.polygon_mode),
             .lineWidth = 1.0f,
         },
         vk::PipelineRasterizationProvokingVertexStateCreateInfoEXT{
@@ -133,8 +274,11 @@ GraphicsPipeline::GraphicsPipeline(
     }
 
     const vk::PipelineMultisampleStateCreateInfo multisampling = {
-        .rasterizationSamples = LiverpoolToVK::NumSamples(
-            key.num_samples, instance.GetColorSampleCounts() & instance.GetDepthSampleCounts()),
+        .rasterizationSamples =
+            instance.IsDynamicRasterizationSamplesSupported()
+                ? vk::SampleCountFlagBits::e1
+                : LiverpoolToVK::NumSamples(key.num_samples, instance.GetColorSampleCounts() &
+                                                                 instance.GetDepthSampleCounts()),
         .sampleShadingEnable =
             fs_info.addr_flags.persp_sample_ena || fs_info.addr_flags.linear_sample_ena,
     };
@@ -169,6 +313,20 @@ GraphicsPipeline::GraphicsPipeline(
     if (instance.IsDynamicColorWriteMaskSupported()) {
         dynamic_states.push_back(vk::DynamicState::eColorWriteMaskEXT);
     }
+    if (instance.IsDynamicColorBlendSupported()) {
+        dynamic_states.push_back(vk::DynamicState::eColorBlendEnableEXT);
+        dynamic_states.push_back(vk::DynamicState::eColorBlendEquationEXT);
+    }
+    if (instance.IsDynamicLogicOpSupported()) {
+        dynamic_states.push_back(vk::DynamicState::eLogicOpEnableEXT);
+        dynamic_states.push_back(vk::DynamicState::eLogicOpEXT);
+    }
+    if (instance.IsDynamicPolygonModeSupported()) {
+        dynamic_states.push_back(vk::DynamicState::ePolygonModeEXT);
+    }
+    if (instance.IsDynamicRasterizationSamplesSupported()) {
+        dynamic_states.push_back(vk::DynamicState::eRasterizationSamplesEXT);
+    }
     if (instance.IsVertexInputDynamicState()) {
         dynamic_states.push_back(vk::DynamicState::eVertexInputEXT);
     } else if (!vertex_bindings.empty()) {
@@ -183,7 +341,7 @@ GraphicsPipeline::GraphicsPipeline(
     boost::container::static_vector<vk::PipelineShaderStageCreateInfo, MaxShaderStages>
         shader_stages;
     auto stage = u32(Shader::LogicalStage::Vertex);
-    if (infos[stage]) {
+    if (modules[stage]) {
         shader_stages.emplace_back(vk::PipelineShaderStageCreateInfo{
             .stage = vk::ShaderStageFlagBits::eVertex,
             .module = modules[stage],
@@ -191,7 +349,7 @@ GraphicsPipeline::GraphicsPipeline(
         });
     }
     stage = u32(Shader::LogicalStage::Geometry);
-    if (infos[stage]) {
+    if (modules[stage]) {
         shader_stages.emplace_back(vk::PipelineShaderStageCreateInfo{
             .stage = vk::ShaderStageFlagBits::eGeometry,
             .module = modules[stage],
@@ -199,7 +357,7 @@ GraphicsPipeline::GraphicsPipeline(
         });
     }
     stage = u32(Shader::LogicalStage::TessellationControl);
-    if (infos[stage]) {
+    if (modules[stage]) {
         shader_stages.emplace_back(vk::PipelineShaderStageCreateInfo{
             .stage = vk::ShaderStageFlagBits::eTessellationControl,
             .module = modules[stage],
@@ -215,7 +373,7 @@ GraphicsPipeline::GraphicsPipeline(
         });
     }
     stage = u32(Shader::LogicalStage::TessellationEval);
-    if (infos[stage]) {
+    if (modules[stage]) {
         shader_stages.emplace_back(vk::PipelineShaderStageCreateInfo{
             .stage = vk::ShaderStageFlagBits::eTessellationEvaluation,
             .module = modules[stage],
@@ -231,7 +389,7 @@ GraphicsPipeline::GraphicsPipeline(
         });
     }
     stage = u32(Shader::LogicalStage::Fragment);
-    if (infos[stage]) {
+    if (modules[stage]) {
         shader_stages.emplace_back(vk::PipelineShaderStageCreateInfo{
             .stage = vk::ShaderStageFlagBits::eFragment,
             .module = modules[stage],
@@ -258,7 +416,7 @@ GraphicsPipeline::GraphicsPipeline(
     }
 
     std::array<vk::SampleCountFlagBits, AmdGpu::NUM_COLOR_BUFFERS> color_samples;
-    std::ranges::transform(key.color_samples, color_samples.begin(), [&instance](u8 num_samples) {
+    std::ranges::transform(key.color_samples, color_samples.begin(), [this](u8 num_samples) {
         return num_samples ? LiverpoolToVK::NumSamples(num_samples, instance.GetColorSampleCounts())
                            : vk::SampleCountFlagBits::e1;
     });
@@ -283,83 +441,42 @@ GraphicsPipeline::GraphicsPipeline(
 
     std::array<vk::PipelineColorBlendAttachmentState, AmdGpu::NUM_COLOR_BUFFERS> attachments;
     for (u32 i = 0; i < key.num_color_attachments; i++) {
-        const auto& control = key.blend_controls[i];
-
-        const auto src_color = LiverpoolToVK::BlendFactor(control.color_src_factor);
-        const auto dst_color = LiverpoolToVK::BlendFactor(control.color_dst_factor);
-        const auto color_blend = LiverpoolToVK::BlendOp(control.color_func);
-
-        const auto src_alpha = control.separate_alpha_blend
-                                   ? LiverpoolToVK::BlendFactor(control.alpha_src_factor)
-                                   : src_color;
-        const auto dst_alpha = control.separate_alpha_blend
-                                   ? LiverpoolToVK::BlendFactor(control.alpha_dst_factor)
-                                   : dst_color;
-        const auto alpha_blend =
-            control.separate_alpha_blend ? LiverpoolToVK::BlendOp(control.alpha_func) : color_blend;
-
-        const auto color_scaled_min_max =
-            (color_blend == vk::BlendOp::eMin || color_blend == vk::BlendOp::eMax) &&
-            (src_color != vk::BlendFactor::eOne || dst_color != vk::BlendFactor::eOne);
-        const auto alpha_scaled_min_max =
-            (alpha_blend == vk::BlendOp::eMin || alpha_blend == vk::BlendOp::eMax) &&
-            (src_alpha != vk::BlendFactor::eOne || dst_alpha != vk::BlendFactor::eOne);
-        if (color_scaled_min_max || alpha_scaled_min_max) {
-            LOG_WARNING(
-                Render_Vulkan,
-                "Unimplemented use of min/max blend op with blend factor not equal to one.");
+        if (instance.IsDynamicColorBlendSupported()) {
+            // Blending is set per draw, see Rasterizer::UpdateColorBlendingState.
+            attachments[i] = {.colorWriteMask = key.write_masks[i]};
+        } else {
+            const auto equation = GetBlendEquation(key, i);
+            attachments[i] = vk::PipelineColorBlendAttachmentState{
+                .blendEnable = key.blend_controls[i].enable,
+                .srcColorBlendFactor = equation.srcColorBlendFactor,
+                .dstColorBlendFactor = equation.dstColorBlendFactor,
+                .colorBlendOp = equation.colorBlendOp,
+                .srcAlphaBlendFactor = equation.srcAlphaBlendFactor,
+                .dstAlphaBlendFactor = equation.dstAlphaBlendFactor,
+                .alphaBlendOp = equation.alphaBlendOp,
+                .colorWriteMask = key.write_masks[i],
+            };
         }
-
-        attachments[i] = vk::PipelineColorBlendAttachmentState{
-            .blendEnable = control.enable,
-            .srcColorBlendFactor = src_color,
-            .dstColorBlendFactor = dst_color,
-            .colorBlendOp = color_blend,
-            .srcAlphaBlendFactor = src_alpha,
-            .dstAlphaBlendFactor = dst_alpha,
-            .alphaBlendOp = alpha_blend,
-            .colorWriteMask =
-                instance.IsDynamicColorWriteMaskSupported()
-                    ? vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
-                          vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA
-                    : key.write_masks[i],
-        };
-
-        // On GCN GPU there is an additional mask which allows to control color components exported
-        // from a pixel shader. A situation possible, when the game may mask out the alpha channel,
-        // while it is still need to be used in blending ops. For such cases, HW will default alpha
-        // to 1 and perform the blending, while shader normally outputs 0 in the last component.
-        // Unfortunatelly, Vulkan doesn't provide any control on blend inputs, so below we detecting
-        // such cases and override alpha value in order to emulate HW behaviour.
-        const auto has_alpha_masked_out =
-            (key.cb_shader_mask.GetMask(i) & AmdGpu::ColorBufferMask::ComponentA) == 0;
-        const auto has_src_alpha_in_src_blend = src_color == vk::BlendFactor::eSrcAlpha ||
-                                                src_color == vk::BlendFactor::eOneMinusSrcAlpha;
-        const auto has_src_alpha_in_dst_blend = dst_color == vk::BlendFactor::eSrcAlpha ||
-                                                dst_color == vk::BlendFactor::eOneMinusSrcAlpha;
-        if (has_alpha_masked_out && has_src_alpha_in_src_blend) {
-            attachments[i].srcColorBlendFactor = src_color == vk::BlendFactor::eSrcAlpha
-                                                     ? vk::BlendFactor::eOne
-                                                     : vk::BlendFactor::eZero; // 1-A
-        }
-        if (has_alpha_masked_out && has_src_alpha_in_dst_blend) {
-            attachments[i].dstColorBlendFactor = dst_color == vk::BlendFactor::eSrcAlpha
-                                                     ? vk::BlendFactor::eOne
-                                                     : vk::BlendFactor::eZero; // 1-A
+        if (instance.IsDynamicColorWriteMaskSupported()) {
+            attachments[i].colorWriteMask =
+                vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
         }
     }
 
     const vk::PipelineColorBlendStateCreateInfo color_blending = {
-        .logicOpEnable =
-            instance.IsLogicOpSupported() && key.logic_op != AmdGpu::ColorControl::LogicOp::Copy,
+        .logicOpEnable = !instance.IsDynamicLogicOpSupported() && instance.IsLogicOpSupported() &&
+                         key.logic_op != AmdGpu::ColorControl::LogicOp::Copy,
         .logicOp = LiverpoolToVK::LogicOp(key.logic_op),
         .attachmentCount = key.num_color_attachments,
         .pAttachments = attachments.data(),
         .blendConstants = std::array{1.0f, 1.0f, 1.0f, 1.0f},
     };
 
+    const vk::PipelineCreateFlags pipeline_flags = GetLayoutPipelineFlags();
     const vk::GraphicsPipelineCreateInfo pipeline_info = {
         .pNext = &pipeline_rendering_ci,
+        .flags = pipeline_flags,
         .stageCount = static_cast<u32>(shader_stages.size()),
         .pStages = shader_stages.data(),
         .pVertexInputState = !instance.IsVertexInputDynamicState() ? &vertex_input_info : nullptr,
@@ -373,16 +490,152 @@ GraphicsPipeline::GraphicsPipeline(
         .layout = *pipeline_layout,
     };
 
+    if (library_cache) {
+        // Every part only hashes the state it consumes, so e.g. a blend change reuses the already
+        // compiled shader libraries and only costs a fast link.
+        using Part = PipelineLibraryCache::Part;
+        const std::span<const vk::DynamicState> dynamic_span{dynamic_states};
+        const std::span<const vk::DescriptorSetLayoutBinding> bindings_span{layout_bindings};
+        const bool has_fragment = bool(modules[u32(Shader::LogicalStage::Fragment)]);
+        const u32 num_pre_raster_stages =
+            static_cast<u32>(shader_stages.size()) - (has_fragment ? 1 : 0);
+
+        LibraryStateHash vertex_input_hash;
+        vertex_input_hash.Add(dynamic_span)
+            .Add(input_assembly.topology)
+            .Add(input_assembly.primitiveRestartEnable);
+        if (!instance.IsVertexInputDynamicState()) {
+            vertex_input_hash.Add(std::span<const vk::VertexInputAttributeDescription>{
+                                      vertex_attributes})
+                .Add(std::span<const vk::VertexInputBindingDescription>{vertex_bindings})
+                .Add(std::span<const vk::VertexInputBindingDivisorDescriptionEXT>{
+                    vertex_divisors});
+        }
+
+        LibraryStateHash pre_raster_hash;
+        pre_raster_hash.Add(dynamic_span).Add(bindings_span);
+        for (const auto stage : {Shader::LogicalStage::Vertex, Shader::LogicalStage::Geometry,
+                                 Shader::LogicalStage::TessellationControl,
+                                 Shader::LogicalStage::TessellationEval}) {
+            pre_raster_hash.Add(static_cast<VkShaderModule>(modules[u32(stage)]));
+        }
+        pre_raster_hash.Add(u32(key.prim_type))
+            .Add(key.patch_control_points)
+            .Add(u32(key.polygon_mode))
+            .Add(u32(key.clip_space))
+            .Add(u32(key.provoking_vtx_last))
+            .Add(u32(key.depth_clamp_enable))
+            .Add(u32(key.depth_clip_enable));
+        if (is_rect_list || is_quad_list) {
+            // Auxiliary tessellation shaders are generated from the fragment inputs.
+            pre_raster_hash.Add(fs_info);
+        }
+
+        LibraryStateHash fragment_shader_hash;
+        fragment_shader_hash.Add(dynamic_span)
+            .Add(bindings_span)
+            .Add(static_cast<VkShaderModule>(modules[u32(Shader::LogicalStage::Fragment)]))
+            .Add(multisampling.rasterizationSamples)
+            .Add(multisampling.sampleShadingEnable)
+            .Add(pipeline_rendering_ci.depthAttachmentFormat)
+            .Add(pipeline_rendering_ci.stencilAttachmentFormat);
+
+        LibraryStateHash fragment_output_hash;
+        fragment_output_hash.Add(dynamic_span)
+            .Add(multisampling.rasterizationSamples)
+            .Add(multisampling.sampleShadingEnable)
+            .Add(pipeline_rendering_ci.depthAttachmentFormat)
+            .Add(pipeline_rendering_ci.stencilAttachmentFormat)
+            .Add(std::span{color_formats.data(), key.num_color_attachments})
+            .Add(std::span{attachments.data(), key.num_color_attachments})
+            .Add(color_blending.logicOpEnable)
+            .Add(color_blending.logicOp);
+        if (instance.IsMixedDepthSamplesSupported()) {
+            fragment_output_hash.Add(std::span{color_samples.data(), key.num_color_attachments})
+                .Add(mixed_samples.depthStencilAttachmentSamples);
+        }
+
+        const PipelineLibraryCache::Libraries libraries = {
+            library_cache->GetLibrary(
+                Part::VertexInput, vertex_input_hash.Digest(),
+                {
+                    .flags = pipeline_flags,
+                    .pVertexInputState =
+                        !instance.IsVertexInputDynamicState() ? &vertex_input_info : nullptr,
+                    .pInputAssemblyState = &input_assembly,
+                    .pDynamicState = &dynamic_info,
+                }),
+            library_cache->GetLibrary(Part::PreRasterization, pre_raster_hash.Digest(),
+                                      {
+                                          .pNext = &pipeline_rendering_ci,
+                                          .flags = pipeline_flags,
+                                          .stageCount = num_pre_raster_stages,
+                                          .pStages = shader_stages.data(),
+                                          .pTessellationState = &tessellation_state,
+                                          .pViewportState = &viewport_info,
+                                          .pRasterizationState = &raster_chain.get(),
+                                          .pDynamicState = &dynamic_info,
+                                          .layout = *pipeline_layout,
+                                      }),
+            library_cache->GetLibrary(
+                Part::FragmentShader, fragment_shader_hash.Digest(),
+                {
+                    .pNext = &pipeline_rendering_ci,
+                    .flags = pipeline_flags,
+                    .stageCount = has_fragment ? 1U : 0U,
+                    .pStages = has_fragment ? &shader_stages.back() : nullptr,
+                    .pMultisampleState = &multisampling,
+                    .pDynamicState = &dynamic_info,
+                    .layout = *pipeline_layout,
+                }),
+            library_cache->GetLibrary(Part::FragmentOutput, fragment_output_hash.Digest(),
+                                      {
+                                          .pNext = &pipeline_rendering_ci,
+                                          .flags = pipeline_flags,
+                                          .pMultisampleState = &multisampling,
+                                          .pColorBlendState = &color_blending,
+                                          .pDynamicState = &dynamic_info,
+                                      }),
+        };
+        pipeline = library_cache->Link(libraries, *pipeline_layout, pipeline_flags, false);
+        SetObjectName(device, *pipeline, "Graphics Pipeline {}", GetDebugString());
+
+        // The fast linked pipeline is usable right away, the optimized one replaces it once done.
+        library_cache->QueueOptimize([this, libraries, pipeline_flags] {
+            optimized_pipeline =
+                library_cache->Link(libraries, *pipeline_layout, pipeline_flags, true);
+            SetObjectName(instance.GetDevice(), *optimized_pipeline, "Graphics Pipeline {}",
+                          GetDebugString());
+            is_optimized.store(true, std::memory_order_release);
+        });
+        return;
+    }
+
     auto [pipeline_result, pipe] =
         device.createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
     ASSERT_MSG(pipeline_result == vk::Result::eSuccess, "Failed to create graphics pipeline: {}",
                vk::to_string(pipeline_result));
     pipeline = std::move(pipe);
-    SetObjectName(device, *pipeline, "Graphics Pipeline {}", debug_str);
+    SetObjectName(device, *pipeline, "Graphics Pipeline {}", GetDebugString());
 }
 
 GraphicsPipeline::~GraphicsPipeline() = default;
 
+GraphicsPipelineRecipe GraphicsPipeline::GetRecipe(
+    const Shader::FragmentRuntimeInfo& fs_info,
+    std::span<const u64, MaxShaderStages> spirv_keys) const {
+    GraphicsPipelineRecipe recipe{
+        .key = key,
+        .fs_info = fs_info,
+        .vertex_attributes = {vertex_attributes.begin(), vertex_attributes.end()},
+        .vertex_bindings = {vertex_bindings.begin(), vertex_bindings.end()},
+        .vertex_divisors = {vertex_divisors.begin(), vertex_divisors.end()},
+        .layout_bindings = {layout_bindings.begin(), layout_bindings.end()},
+    };
+    std::ranges::copy(spirv_keys, recipe.spirv_keys.begin());
+    return recipe;
+}
+
 template <typename Attribute, typename Binding>
 void GraphicsPipeline::GetVertexInputs(
     VertexInputs<Attribute>& attributes, VertexInputs<Binding>& bindings,
@@ -393,29 +646,86 @@ void GraphicsPipeline::GetVertexInputs(
         return;
     }
     const auto& vs_info = GetStage(Shader::LogicalStage::Vertex);
+
+    // With dynamic vertex input the layout is rebuilt every draw, so attributes interleaved in
+    // the same buffer can share one binding and address their elements with a relative offset,
+    // the way a native vertex layout would. Static pipelines keep one binding per attribute, as
+    // the distance between attribute base addresses may change from draw to draw.
+    bool merge_bindings = false;
+    if constexpr (std::is_same_v<Binding, vk::VertexInputBindingDescription2EXT>) {
+        merge_bindings = instance.IsVertexInputDynamicState();
+    }
+    // Minimum maxVertexInputAttributeOffset guaranteed by the specification.
+    constexpr u64 MaxAttributeOffset = 2047;
+
+    VertexInputs<const Shader::Gcn::VertexAttribute*> ordered_attribs;
     for (const auto& attrib : fetch_shader->attributes) {
-        const auto step_rate = attrib.GetStepRate();
-        const auto buffer = attrib.GetSharp(vs_info);
+        ordered_attribs.push_back(&attrib);
+    }
+    if (merge_bindings) {
+        // Visit attributes by address, so the lowest one of a buffer always starts its binding.
+        std::ranges::sort(ordered_attribs, {}, [&](const Shader::Gcn::VertexAttribute* attrib) {
+            return u64(attrib->GetSharp(vs_info).base_address);
+        });
+    }
+
+    for (const auto* attrib : ordered_attribs) {
+        const auto step_rate = attrib->GetStepRate();
+        const auto buffer = attrib->GetSharp(vs_info);
+        const u32 stride = buffer.GetStride();
+        const auto input_rate = step_rate == InstanceIdType::None ? vk::VertexInputRate::eVertex
+                                                                  : vk::VertexInputRate::eInstance;
+        const u32 divisor = step_rate == InstanceIdType::OverStepRate0
+                                ? step_rate_0
+                                : (step_rate == InstanceIdType::OverStepRate1 ? step_rate_1 : 1);
+        const auto format =
+            LiverpoolToVK::SurfaceFormat(buffer.GetDataFmt(), buffer.GetNumberFmt());
+
+        if constexpr (std::is_same_v<Binding, vk::VertexInputBindingDescription2EXT>) {
+            if (merge_bindings && stride != 0) {
+                const auto it = std::ranges::find_if(bindings, [&](const Binding& binding) {
+                    const auto& guest_buffer = guest_buffers[binding.binding];
+                    const u64 offset = buffer.base_address - guest_buffer.base_address;
+                    return binding.stride == stride && binding.inputRate == input_rate &&
+                           binding.divisor == divisor && offset < stride &&
+                           offset <= MaxAttributeOffset;
+                });
+                if (it != bindings.end()) {
+                    auto& guest_buffer = guest_buffers[it->binding];
+                    const u64 offset = buffer.base_address - guest_buffer.base_address;
+                    attributes.push_back(Attribute{
+                        .location = attrib->semantic,
+                        .binding = it->binding,
+                        .format = format,
+                        .offset = static_cast<u32>(offset),
+                    });
+                    // Grow the shared buffer so it covers the elements of every attribute in it.
+                    const u64 end = offset + buffer.GetSize();
+                    guest_buffer.num_records =
+                        std::max<u32>(guest_buffer.num_records, (end + stride - 1) / stride);
+                    continue;
+                }
+            }
+        }
+
+        // Merged bindings are numbered in the order the buffers are bound.
+        const u32 binding = merge_bindings ? static_cast<u32>(bindings.size()) : attrib->semantic;
         attributes.push_back(Attribute{
-            .location = attrib.semantic,
-            .binding = attrib.semantic,
-            .format = LiverpoolToVK::SurfaceFormat(buffer.GetDataFmt(), buffer.GetNumberFmt()),
+            .location = attrib->semantic,
+            .binding = binding,
+            .format = format,
             .offset = 0,
         });
         bindings.push_back(Binding{
-            .binding = attrib.semantic,
-            .stride = buffer.GetStride(),
-            .inputRate = step_rate == InstanceIdType::None ? vk::VertexInputRate::eVertex
-                                                           : vk::VertexInputRate::eInstance,
+            .binding = binding,
+            .stride = stride,
+            .inputRate = input_rate,
         });
-        const u32 divisor = step_rate == InstanceIdType::OverStepRate0
-                                ? step_rate_0
-                                : (step_rate == InstanceIdType::OverStepRate1 ? step_rate_1 : 1);
         if constexpr (std::is_same_v<Binding, vk::VertexInputBindingDescription2EXT>) {
             bindings.back().divisor = divisor;
         } else if (step_rate != InstanceIdType::None) {
             divisors.push_back(vk::VertexInputBindingDivisorDescriptionEXT{
-                .binding = attrib.semantic,
+                .binding = binding,
                 .divisor = divisor,
             });
         }
@@ -436,7 +746,7 @@ template void GraphicsPipeline::GetVertexInputs(
     VertexInputs<AmdGpu::Buffer>& guest_buffers, u32 step_rate_0, u32 step_rate_1) const;
 
 void GraphicsPipeline::BuildDescSetLayout() {
-    boost::container::small_vector<vk::DescriptorSetLayoutBinding, 32> bindings;
+    layout_bindings.clear();
     u32 binding{};
 
     for (const auto* stage : stages) {
@@ -446,7 +756,7 @@ void GraphicsPipeline::BuildDescSetLayout() {
         const auto stage_bit = LogicalStageToStageBit[u32(stage->l_stage)];
         for (const auto& buffer : stage->buffers) {
             const auto sharp = buffer.GetSharp(*stage);
-            bindings.push_back({
+            layout_bindings.push_back({
                 .binding = binding++,
                 .descriptorType = buffer.IsStorage(sharp) ? vk::DescriptorType::eStorageBuffer
                                                           : vk::DescriptorType::eUniformBuffer,
@@ -455,7 +765,10 @@ void GraphicsPipeline::BuildDescSetLayout() {
             });
         }
         for (const auto& image : stage->images) {
-            bindings.push_back({
+            if (stage->IsTextureHeapImage(image)) {
+                continue;
+            }
+            layout_bindings.push_back({
                 .binding = binding++,
                 .descriptorType = image.is_written ? vk::DescriptorType::eStorageImage
                                                    : vk::DescriptorType::eSampledImage,
@@ -464,7 +777,7 @@ void GraphicsPipeline::BuildDescSetLayout() {
             });
         }
         for (const auto& sampler : stage->samplers) {
-            bindings.push_back({
+            layout_bindings.push_back({
                 .binding = binding++,
                 .descriptorType = vk::DescriptorType::eSampler,
                 .descriptorCount = 1,
@@ -472,20 +785,7 @@ void GraphicsPipeline::BuildDescSetLayout() {
             });
         }
     }
-    uses_push_descriptors = binding < instance.MaxPushDescriptors();
-    const auto flags = uses_push_descriptors
-                           ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR
-                           : vk::DescriptorSetLayoutCreateFlagBits{};
-    const vk::DescriptorSetLayoutCreateInfo desc_layout_ci = {
-        .flags = flags,
-        .bindingCount = static_cast<u32>(bindings.size()),
-        .pBindings = bindings.data(),
-    };
-    auto [layout_result, layout] =
-        instance.GetDevice().createDescriptorSetLayoutUnique(desc_layout_ci);
-    ASSERT_MSG(layout_result == vk::Result::eSuccess,
-               "Failed to create graphics descriptor set layout: {}", vk::to_string(layout_result));
-    desc_layout = std::move(layout);
+    CreateDescSetLayout();
 }
 
 } // namespace Vulkan
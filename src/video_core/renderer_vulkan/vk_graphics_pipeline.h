@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <vector>
 #include <boost/container/static_vector.hpp>
 #include <xxhash.h>
 
@@ -12,6 +13,10 @@
 #include "video_core/amdgpu/regs_primitive.h"
 #include "video_core/renderer_vulkan/vk_pipeline_common.h"
 
+namespace Common {
+class ThreadWorker;
+}
+
 namespace VideoCore {
 class BufferCache;
 class TextureCache;
@@ -25,10 +30,22 @@ static constexpr u32 MaxVertexBufferCount = 32;
 class Instance;
 class Scheduler;
 class DescriptorHeap;
+class PipelineLibraryCache;
 
 template <typename T>
 using VertexInputs = boost::container::static_vector<T, MaxVertexBufferCount>;
 
+/// Host vertex buffers and input state resolved for a draw.
+struct VertexBindings {
+    VertexInputs<vk::VertexInputAttributeDescription2EXT> attributes;
+    VertexInputs<vk::VertexInputBindingDescription2EXT> bindings;
+    VertexInputs<vk::Buffer> buffers;
+    VertexInputs<vk::DeviceSize> offsets;
+    VertexInputs<vk::DeviceSize> sizes;
+    VertexInputs<vk::DeviceSize> strides;
+    u64 hash{};
+};
+
 struct GraphicsPipelineKey {
     std::array<size_t, MaxShaderStages> stage_hashes;
     std::array<vk::Format, MaxVertexBufferCount> vertex_buffer_formats;
@@ -65,15 +82,36 @@ struct GraphicsPipelineKey {
     }
 };
 
+/// Subset of pipeline state that allows recreating a graphics pipeline without guest state.
+struct GraphicsPipelineRecipe {
+    GraphicsPipelineKey key;
+    std::array<u64, MaxShaderStages> spirv_keys;
+    Shader::FragmentRuntimeInfo fs_info;
+    std::vector<vk::VertexInputAttributeDescription> vertex_attributes;
+    std::vector<vk::VertexInputBindingDescription> vertex_bindings;
+    std::vector<vk::VertexInputBindingDivisorDescriptionEXT> vertex_divisors;
+    std::vector<vk::DescriptorSetLayoutBinding> layout_bindings;
+};
+
 class GraphicsPipeline : public Pipeline {
 public:
+    using StageModules = std::array<vk::ShaderModule, MaxShaderStages>;
+
     GraphicsPipeline(const Instance& instance, Scheduler& scheduler, DescriptorHeap& desc_heap,
-                     const Shader::Profile& profile, const GraphicsPipelineKey& key,
+                     const VideoCore::TextureHeap* texture_heap, const Shader::Profile& profile,
+                     const GraphicsPipelineKey& key,
                      vk::PipelineCache pipeline_cache,
                      std::span<const Shader::Info*, MaxShaderStages> stages,
                      std::span<const Shader::RuntimeInfo, MaxShaderStages> runtime_infos,
                      std::optional<const Shader::Gcn::FetchShaderData> fetch_shader,
-                     std::span<const vk::ShaderModule> modules);
+                     std::span<const vk::ShaderModule> modules,
+                     Common::ThreadWorker* worker = nullptr,
+                     PipelineLibraryCache* library_cache = nullptr);
+    /// Builds a pipeline from a recorded recipe, used to warm up the driver pipeline cache.
+    GraphicsPipeline(const Instance& instance, Scheduler& scheduler, DescriptorHeap& desc_heap,
+                     const VideoCore::TextureHeap* texture_heap, const Shader::Profile& profile,
+                     vk::PipelineCache pipeline_cache, const GraphicsPipelineRecipe& recipe,
+                     const StageModules& modules);
     ~GraphicsPipeline();
 
     const std::optional<const Shader::Gcn::FetchShaderData>& GetFetchShader() const noexcept {
@@ -84,6 +122,13 @@ public:
         return key;
     }
 
+    /// Returns the blend equation of a color attachment, shared by static and dynamic blending.
+    static vk::ColorBlendEquationEXT GetBlendEquation(const GraphicsPipelineKey& key, u32 index);
+
+    /// Returns the recipe used to recreate this pipeline without guest state.
+    GraphicsPipelineRecipe GetRecipe(const Shader::FragmentRuntimeInfo& fs_info,
+                                     std::span<const u64, MaxShaderStages> spirv_keys) const;
+
     /// Gets the attributes and bindings for vertex inputs.
     template <typename Attribute, typename Binding>
     void GetVertexInputs(VertexInputs<Attribute>& attributes, VertexInputs<Binding>& bindings,
@@ -93,10 +138,17 @@ public:
 
 private:
     void BuildDescSetLayout();
+    void CreateLayout();
+    void Create(vk::PipelineCache pipeline_cache, const Shader::FragmentRuntimeInfo& fs_info,
+                const StageModules& modules);
 
 private:
     GraphicsPipelineKey key;
+    PipelineLibraryCache* library_cache{};
     std::optional<const Shader::Gcn::FetchShaderData> fetch_shader{};
+    VertexInputs<vk::VertexInputAttributeDescription> vertex_attributes;
+    VertexInputs<vk::VertexInputBindingDescription> vertex_bindings;
+    VertexInputs<vk::VertexInputBindingDivisorDescriptionEXT> vertex_divisors;
 };
 
 } // namespace Vulkan
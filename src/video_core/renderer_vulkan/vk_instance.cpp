@@ -9,6 +9,7 @@
 #include "common/debug.h"
 #include "common/types.h"
 #include "sdl_window.h"
+#include "video_core/buffer_cache/buffer.h"
 #include "video_core/renderer_vulkan/liverpool_to_vk.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_platform.h"
@@ -183,6 +184,9 @@ Instance::Instance(Frontend::WindowSDL& window, s32 physical_device_index,
 }
 
 Instance::~Instance() {
+    if (small_buffer_pool) {
+        vmaDestroyPool(allocator, small_buffer_pool);
+    }
     vmaDestroyAllocator(allocator);
 }
 
@@ -211,19 +215,32 @@ bool Instance::CreateDevice() {
             .getFeatures2<vk::PhysicalDeviceFeatures2, vk::PhysicalDeviceVulkan11Features,
                           vk::PhysicalDeviceVulkan12Features, vk::PhysicalDeviceVulkan13Features,
                           vk::PhysicalDeviceRobustness2FeaturesEXT,
+                          vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT,
                           vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT,
                           vk::PhysicalDevicePrimitiveTopologyListRestartFeaturesEXT,
                           vk::PhysicalDevicePortabilitySubsetFeaturesKHR,
                           vk::PhysicalDeviceShaderAtomicFloat2FeaturesEXT,
-                          vk::PhysicalDeviceWorkgroupMemoryExplicitLayoutFeaturesKHR>();
+                          vk::PhysicalDeviceWorkgroupMemoryExplicitLayoutFeaturesKHR,
+                          vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT,
+                          vk::PhysicalDeviceDescriptorBufferFeaturesEXT,
+                          vk::PhysicalDevicePresentIdFeaturesKHR,
+                          vk::PhysicalDevicePresentWaitFeaturesKHR>();
     features = feature_chain.get().features;
 
     const vk::StructureChain properties_chain = physical_device.getProperties2<
         vk::PhysicalDeviceProperties2, vk::PhysicalDeviceVulkan11Properties,
-        vk::PhysicalDeviceVulkan12Properties, vk::PhysicalDevicePushDescriptorPropertiesKHR>();
+        vk::PhysicalDeviceVulkan12Properties, vk::PhysicalDeviceVulkan13Properties,
+        vk::PhysicalDevicePushDescriptorPropertiesKHR,
+        vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT,
+        vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
     vk11_props = properties_chain.get<vk::PhysicalDeviceVulkan11Properties>();
     vk12_props = properties_chain.get<vk::PhysicalDeviceVulkan12Properties>();
+    vk13_props = properties_chain.get<vk::PhysicalDeviceVulkan13Properties>();
     push_descriptor_props = properties_chain.get<vk::PhysicalDevicePushDescriptorPropertiesKHR>();
+    graphics_pipeline_library_props =
+        properties_chain.get<vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT>();
+    descriptor_buffer_props =
+        properties_chain.get<vk::PhysicalDeviceDescriptorBufferPropertiesEXT>();
     LOG_INFO(Render_Vulkan, "Physical device subgroup size {}", vk11_props.subgroupSize);
 
     if (available_extensions.empty()) {
@@ -231,7 +248,7 @@ bool Instance::CreateDevice() {
         return false;
     }
 
-    boost::container::static_vector<const char*, 32> enabled_extensions;
+    boost::container::static_vector<const char*, 40> enabled_extensions;
     const auto add_extension = [&](std::string_view extension) -> bool {
         const auto result =
             std::find_if(available_extensions.begin(), available_extensions.end(),
@@ -264,12 +281,29 @@ bool Instance::CreateDevice() {
         }
     }
     depth_range_unrestricted = add_extension(VK_EXT_DEPTH_RANGE_UNRESTRICTED_EXTENSION_NAME);
+    dynamic_state_2 = add_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+    if (dynamic_state_2) {
+        dynamic_state_2_features =
+            feature_chain.get<vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT>();
+        LOG_INFO(Render_Vulkan, "- extendedDynamicState2LogicOp: {}",
+                 dynamic_state_2_features.extendedDynamicState2LogicOp);
+    }
     dynamic_state_3 = add_extension(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
     if (dynamic_state_3) {
         dynamic_state_3_features =
             feature_chain.get<vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>();
         LOG_INFO(Render_Vulkan, "- extendedDynamicState3ColorWriteMask: {}",
                  dynamic_state_3_features.extendedDynamicState3ColorWriteMask);
+        LOG_INFO(Render_Vulkan, "- extendedDynamicState3ColorBlendEnable: {}",
+                 dynamic_state_3_features.extendedDynamicState3ColorBlendEnable);
+        LOG_INFO(Render_Vulkan, "- extendedDynamicState3ColorBlendEquation: {}",
+                 dynamic_state_3_features.extendedDynamicState3ColorBlendEquation);
+        LOG_INFO(Render_Vulkan, "- extendedDynamicState3PolygonMode: {}",
+                 dynamic_state_3_features.extendedDynamicState3PolygonMode);
+        LOG_INFO(Render_Vulkan, "- extendedDynamicState3LogicOpEnable: {}",
+                 dynamic_state_3_features.extendedDynamicState3LogicOpEnable);
+        LOG_INFO(Render_Vulkan, "- extendedDynamicState3RasterizationSamples: {}",
+                 dynamic_state_3_features.extendedDynamicState3RasterizationSamples);
     }
     robustness2 = add_extension(VK_EXT_ROBUSTNESS_2_EXTENSION_NAME);
     if (robustness2) {
@@ -322,6 +356,39 @@ bool Instance::CreateDevice() {
             Render_Vulkan, "- workgroupMemoryExplicitLayout16BitAccess: {}",
             workgroup_memory_explicit_layout_features.workgroupMemoryExplicitLayout16BitAccess);
     }
+    if (add_extension(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        graphics_pipeline_library =
+            add_extension(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+        if (!graphics_pipeline_library) {
+            enabled_extensions.pop_back();
+        }
+    }
+    if (graphics_pipeline_library) {
+        graphics_pipeline_library_features =
+            feature_chain.get<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+        LOG_INFO(Render_Vulkan, "- graphicsPipelineLibrary: {}",
+                 graphics_pipeline_library_features.graphicsPipelineLibrary);
+        LOG_INFO(Render_Vulkan, "- graphicsPipelineLibraryFastLinking: {}",
+                 graphics_pipeline_library_props.graphicsPipelineLibraryFastLinking);
+    }
+    descriptor_buffer = add_extension(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+    if (descriptor_buffer) {
+        descriptor_buffer_features =
+            feature_chain.get<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>();
+        LOG_INFO(Render_Vulkan, "- descriptorBuffer: {}",
+                 descriptor_buffer_features.descriptorBuffer);
+    }
+    if (add_extension(VK_KHR_PRESENT_ID_EXTENSION_NAME)) {
+        present_wait = add_extension(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        if (!present_wait) {
+            enabled_extensions.pop_back();
+        }
+    }
+    if (present_wait) {
+        present_wait = feature_chain.get<vk::PhysicalDevicePresentIdFeaturesKHR>().presentId &&
+                       feature_chain.get<vk::PhysicalDevicePresentWaitFeaturesKHR>().presentWait;
+        LOG_INFO(Render_Vulkan, "- presentWait: {}", present_wait);
+    }
     const bool calibrated_timestamps =
         TRACY_GPU_ENABLED ? add_extension(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) : false;
 
@@ -355,22 +422,46 @@ bool Instance::CreateDevice() {
         return false;
     }
 
-    static constexpr std::array queue_priorities = {1.0f};
-    const vk::DeviceQueueCreateInfo queue_info = {
+    // A transfer only family usually maps to a separate DMA engine that can run alongside
+    // rendering.
+    for (std::size_t i = 0; i < family_properties.size(); i++) {
+        const auto flags = family_properties[i].queueFlags;
+        if ((flags & vk::QueueFlagBits::eTransfer) &&
+            !(flags & (vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute))) {
+            transfer_queue_family_index = static_cast<u32>(i);
+            break;
+        }
+    }
+
+    // A second queue of the graphics family runs guest compute rings alongside rendering. Both
+    // queues share the family, so resources never need ownership transfers between them.
+    has_compute_queue = family_properties[queue_family_index].queueCount > 1;
+
+    static constexpr std::array queue_priorities = {1.0f, 1.0f};
+    boost::container::static_vector<vk::DeviceQueueCreateInfo, 2> queue_infos;
+    queue_infos.push_back({
         .queueFamilyIndex = queue_family_index,
-        .queueCount = static_cast<u32>(queue_priorities.size()),
+        .queueCount = has_compute_queue ? 2U : 1U,
         .pQueuePriorities = queue_priorities.data(),
-    };
+    });
+    if (transfer_queue_family_index) {
+        queue_infos.push_back({
+            .queueFamilyIndex = *transfer_queue_family_index,
+            .queueCount = 1,
+            .pQueuePriorities = queue_priorities.data(),
+        });
+    }
 
     const auto topology_list_restart_features =
         feature_chain.get<vk::PhysicalDevicePrimitiveTopologyListRestartFeaturesEXT>();
     const auto vk11_features = feature_chain.get<vk::PhysicalDeviceVulkan11Features>();
     vk12_features = feature_chain.get<vk::PhysicalDeviceVulkan12Features>();
     const auto vk13_features = feature_chain.get<vk::PhysicalDeviceVulkan13Features>();
+    subgroup_size_control = vk13_features.subgroupSizeControl;
     vk::StructureChain device_chain = {
         vk::DeviceCreateInfo{
-            .queueCreateInfoCount = 1u,
-            .pQueueCreateInfos = &queue_info,
+            .queueCreateInfoCount = static_cast<u32>(queue_infos.size()),
+            .pQueueCreateInfos = queue_infos.data(),
             .enabledExtensionCount = static_cast<u32>(enabled_extensions.size()),
             .ppEnabledExtensionNames = enabled_extensions.data(),
         },
@@ -385,6 +476,7 @@ bool Instance::CreateDevice() {
                 .dualSrcBlend = features.dualSrcBlend,
                 .logicOp = features.logicOp,
                 .multiDrawIndirect = features.multiDrawIndirect,
+                .drawIndirectFirstInstance = features.drawIndirectFirstInstance,
                 .depthClamp = features.depthClamp,
                 .depthBiasClamp = features.depthBiasClamp,
                 .fillModeNonSolid = features.fillModeNonSolid,
@@ -397,6 +489,8 @@ bool Instance::CreateDevice() {
                 .shaderImageGatherExtended = features.shaderImageGatherExtended,
                 .shaderStorageImageExtendedFormats = features.shaderStorageImageExtendedFormats,
                 .shaderStorageImageMultisample = features.shaderStorageImageMultisample,
+                .shaderSampledImageArrayDynamicIndexing =
+                    features.shaderSampledImageArrayDynamicIndexing,
                 .shaderClipDistance = features.shaderClipDistance,
                 .shaderFloat64 = features.shaderFloat64,
                 .shaderInt64 = features.shaderInt64,
@@ -417,6 +511,12 @@ bool Instance::CreateDevice() {
             .shaderSharedInt64Atomics = vk12_features.shaderSharedInt64Atomics,
             .shaderFloat16 = vk12_features.shaderFloat16,
             .shaderInt8 = vk12_features.shaderInt8,
+            .descriptorBindingSampledImageUpdateAfterBind =
+                vk12_features.descriptorBindingSampledImageUpdateAfterBind,
+            .descriptorBindingUpdateUnusedWhilePending =
+                vk12_features.descriptorBindingUpdateUnusedWhilePending,
+            .descriptorBindingPartiallyBound = vk12_features.descriptorBindingPartiallyBound,
+            .runtimeDescriptorArray = vk12_features.runtimeDescriptorArray,
             .scalarBlockLayout = vk12_features.scalarBlockLayout,
             .uniformBufferStandardLayout = vk12_features.uniformBufferStandardLayout,
             .separateDepthStencilLayouts = vk12_features.separateDepthStencilLayouts,
@@ -427,6 +527,7 @@ bool Instance::CreateDevice() {
         },
         vk::PhysicalDeviceVulkan13Features{
             .robustImageAccess = vk13_features.robustImageAccess,
+            .subgroupSizeControl = vk13_features.subgroupSizeControl,
             .shaderDemoteToHelperInvocation = vk13_features.shaderDemoteToHelperInvocation,
             .synchronization2 = vk13_features.synchronization2,
             .dynamicRendering = vk13_features.dynamicRendering,
@@ -437,7 +538,20 @@ bool Instance::CreateDevice() {
             .customBorderColors = true,
             .customBorderColorWithoutFormat = true,
         },
+        vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT{
+            .extendedDynamicState2LogicOp = dynamic_state_2_features.extendedDynamicState2LogicOp,
+        },
         vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT{
+            .extendedDynamicState3PolygonMode =
+                dynamic_state_3_features.extendedDynamicState3PolygonMode,
+            .extendedDynamicState3RasterizationSamples =
+                dynamic_state_3_features.extendedDynamicState3RasterizationSamples,
+            .extendedDynamicState3LogicOpEnable =
+                dynamic_state_3_features.extendedDynamicState3LogicOpEnable,
+            .extendedDynamicState3ColorBlendEnable =
+                dynamic_state_3_features.extendedDynamicState3ColorBlendEnable,
+            .extendedDynamicState3ColorBlendEquation =
+                dynamic_state_3_features.extendedDynamicState3ColorBlendEquation,
             .extendedDynamicState3ColorWriteMask =
                 dynamic_state_3_features.extendedDynamicState3ColorWriteMask,
         },
@@ -496,6 +610,18 @@ bool Instance::CreateDevice() {
             .workgroupMemoryExplicitLayout16BitAccess =
                 workgroup_memory_explicit_layout_features.workgroupMemoryExplicitLayout16BitAccess,
         },
+        vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT{
+            .graphicsPipelineLibrary = graphics_pipeline_library_features.graphicsPipelineLibrary,
+        },
+        vk::PhysicalDeviceDescriptorBufferFeaturesEXT{
+            .descriptorBuffer = descriptor_buffer_features.descriptorBuffer,
+        },
+        vk::PhysicalDevicePresentIdFeaturesKHR{
+            .presentId = true,
+        },
+        vk::PhysicalDevicePresentWaitFeaturesKHR{
+            .presentWait = true,
+        },
 #ifdef __APPLE__
         vk::PhysicalDevicePortabilitySubsetFeaturesKHR{
             .constantAlphaColorBlendFactors = portability_features.constantAlphaColorBlendFactors,
@@ -522,6 +648,9 @@ bool Instance::CreateDevice() {
     if (!custom_border_color) {
         device_chain.unlink<vk::PhysicalDeviceCustomBorderColorFeaturesEXT>();
     }
+    if (!dynamic_state_2) {
+        device_chain.unlink<vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT>();
+    }
     if (!dynamic_state_3) {
         device_chain.unlink<vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT>();
     }
@@ -562,6 +691,16 @@ bool Instance::CreateDevice() {
     if (!workgroup_memory_explicit_layout) {
         device_chain.unlink<vk::PhysicalDeviceWorkgroupMemoryExplicitLayoutFeaturesKHR>();
     }
+    if (!graphics_pipeline_library) {
+        device_chain.unlink<vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT>();
+    }
+    if (!descriptor_buffer) {
+        device_chain.unlink<vk::PhysicalDeviceDescriptorBufferFeaturesEXT>();
+    }
+    if (!present_wait) {
+        device_chain.unlink<vk::PhysicalDevicePresentIdFeaturesKHR>();
+        device_chain.unlink<vk::PhysicalDevicePresentWaitFeaturesKHR>();
+    }
 
     auto [device_result, dev] = physical_device.createDeviceUnique(device_chain.get());
     if (device_result != vk::Result::eSuccess) {
@@ -574,6 +713,12 @@ bool Instance::CreateDevice() {
 
     graphics_queue = device->getQueue(queue_family_index, 0);
     present_queue = device->getQueue(queue_family_index, 0);
+    if (has_compute_queue) {
+        compute_queue = device->getQueue(queue_family_index, 1);
+    }
+    if (transfer_queue_family_index) {
+        transfer_queue = device->getQueue(*transfer_queue_family_index, 0);
+    }
 
     if (calibrated_timestamps) {
         const auto [time_domains_result, time_domains] =
@@ -616,8 +761,13 @@ void Instance::CreateAllocator() {
         .vkGetDeviceProcAddr = VULKAN_HPP_DEFAULT_DISPATCHER.vkGetDeviceProcAddr,
     };
 
+    VmaAllocatorCreateFlags flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
+    if (supports_memory_budget) {
+        // Lets vmaGetHeapBudgets report the usage of the whole process instead of an estimate.
+        flags |= VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT;
+    }
     const VmaAllocatorCreateInfo allocator_info = {
-        .flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT,
+        .flags = flags,
         .physicalDevice = physical_device,
         .device = *device,
         .pVulkanFunctions = &functions,
@@ -630,6 +780,39 @@ void Instance::CreateAllocator() {
         UNREACHABLE_MSG("Failed to initialize VMA with error {}",
                         vk::to_string(vk::Result{result}));
     }
+
+    CreateSmallBufferPool();
+}
+
+void Instance::CreateSmallBufferPool() {
+    // Guest ranges of a few pages are created and destroyed all the time. Keeping them in their
+    // own blocks stops the holes they leave from splitting the blocks of images and large buffers.
+    const VkBufferCreateInfo buffer_info = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .size = VideoCore::DedicatedAllocationThreshold,
+        .usage = static_cast<VkBufferUsageFlags>(VideoCore::AllFlags),
+    };
+    const VmaAllocationCreateInfo alloc_info = {
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE,
+    };
+    u32 memory_type_index{};
+    VkResult result = vmaFindMemoryTypeIndexForBufferInfo(allocator, &buffer_info, &alloc_info,
+                                                          &memory_type_index);
+    if (result != VK_SUCCESS) {
+        LOG_WARNING(Render_Vulkan, "No memory type for small buffer pool: {}",
+                    vk::to_string(vk::Result{result}));
+        return;
+    }
+    const VmaPoolCreateInfo pool_info = {
+        .memoryTypeIndex = memory_type_index,
+        .blockSize = 8 * VideoCore::DedicatedAllocationThreshold,
+    };
+    result = vmaCreatePool(allocator, &pool_info, &small_buffer_pool);
+    if (result != VK_SUCCESS) {
+        LOG_WARNING(Render_Vulkan, "Failed to create small buffer pool: {}",
+                    vk::to_string(vk::Result{result}));
+        small_buffer_pool = VK_NULL_HANDLE;
+    }
 }
 
 void Instance::CollectDeviceParameters() {
@@ -718,7 +901,7 @@ void Instance::CollectToolingInfo() const {
     }
 }
 
-u64 Instance::GetDeviceMemoryUsage() const {
+Instance::MemoryStatus Instance::GetDeviceMemoryStatus() const {
     vk::PhysicalDeviceMemoryBudgetPropertiesEXT memory_budget_props{};
     vk::PhysicalDeviceMemoryProperties2 props = {
         .pNext = &memory_budget_props,
@@ -726,10 +909,17 @@ u64 Instance::GetDeviceMemoryUsage() const {
     physical_device.getMemoryProperties2(&props);
 
     u64 total_usage = 0;
+    u64 total_budget = 0;
     for (const size_t heap : valid_heaps) {
         total_usage += memory_budget_props.heapUsage[heap];
+        total_budget += memory_budget_props.heapBudget[heap];
+    }
+    if (!IsIntegrated()) {
+        total_budget -= std::min<u64>(total_budget / 8, 1_GB);
     }
-    return total_usage;
+    // The budget shrinks when other processes allocate video memory, but never let it grow past
+    // what was available at startup.
+    return {total_usage, std::min(total_budget, total_memory_budget)};
 }
 
 vk::FormatFeatureFlags2 Instance::GetFormatFeatureFlags(vk::Format format) const {
@@ -3,6 +3,7 @@
 
 #pragma once
 
+#include <optional>
 #include <span>
 #include <unordered_map>
 
@@ -16,6 +17,7 @@ class WindowSDL;
 }
 
 VK_DEFINE_HANDLE(VmaAllocator)
+VK_DEFINE_HANDLE(VmaPool)
 
 namespace Vulkan {
 
@@ -53,6 +55,11 @@ public:
         return allocator;
     }
 
+    /// Returns the VMA pool of small device local buffers, null if it could not be created
+    VmaPool GetSmallBufferPool() const {
+        return small_buffer_pool;
+    }
+
     /// Returns a list of the available physical devices
     std::span<const vk::PhysicalDevice> GetPhysicalDevices() const {
         return physical_devices;
@@ -75,6 +82,28 @@ public:
         return present_queue;
     }
 
+    /// Returns true when the device exposes a queue family dedicated to transfers.
+    bool HasDedicatedTransferQueue() const {
+        return transfer_queue_family_index.has_value();
+    }
+
+    u32 GetTransferQueueFamilyIndex() const {
+        return *transfer_queue_family_index;
+    }
+
+    vk::Queue GetTransferQueue() const {
+        return transfer_queue;
+    }
+
+    /// Returns true when the graphics family provides a second queue for async compute work.
+    bool HasAsyncComputeQueue() const {
+        return has_compute_queue;
+    }
+
+    vk::Queue GetComputeQueue() const {
+        return compute_queue;
+    }
+
     TracyVkCtx GetProfilerContext() const {
         return profiler_context;
     }
@@ -84,6 +113,11 @@ public:
         return features.samplerAnisotropy;
     }
 
+    /// Returns true if several indirect draws with their own first instance can be issued at once
+    bool IsMultiDrawIndirectSupported() const {
+        return features.multiDrawIndirect && features.drawIndirectFirstInstance;
+    }
+
     /// Returns true if depth bounds testing is supported
     bool IsDepthBoundsSupported() const {
         return features.depthBounds;
@@ -155,11 +189,73 @@ public:
         return dynamic_state_3 && dynamic_state_3_features.extendedDynamicState3ColorWriteMask;
     }
 
+    /// Returns true when blend enables and equations of VK_EXT_extended_dynamic_state3 are
+    /// supported.
+    bool IsDynamicColorBlendSupported() const {
+        return dynamic_state_3 && dynamic_state_3_features.extendedDynamicState3ColorBlendEnable &&
+               dynamic_state_3_features.extendedDynamicState3ColorBlendEquation;
+    }
+
+    /// Returns true when the extendedDynamicState3PolygonMode feature is supported.
+    bool IsDynamicPolygonModeSupported() const {
+        return dynamic_state_3 && dynamic_state_3_features.extendedDynamicState3PolygonMode;
+    }
+
+    /// Returns true when the logic op enable of VK_EXT_extended_dynamic_state3 and the logic op
+    /// of VK_EXT_extended_dynamic_state2 are supported.
+    bool IsDynamicLogicOpSupported() const {
+        return dynamic_state_3 && dynamic_state_3_features.extendedDynamicState3LogicOpEnable &&
+               dynamic_state_2 && dynamic_state_2_features.extendedDynamicState2LogicOp;
+    }
+
+    /// Returns true when the extendedDynamicState3RasterizationSamples feature is supported.
+    bool IsDynamicRasterizationSamplesSupported() const {
+        return dynamic_state_3 &&
+               dynamic_state_3_features.extendedDynamicState3RasterizationSamples;
+    }
+
     /// Returns true when VK_EXT_vertex_input_dynamic_state is supported.
     bool IsVertexInputDynamicState() const {
         return vertex_input_dynamic_state;
     }
 
+    /// Returns true when VK_EXT_graphics_pipeline_library is supported with fast linking.
+    bool IsGraphicsPipelineLibrarySupported() const {
+        return graphics_pipeline_library &&
+               graphics_pipeline_library_features.graphicsPipelineLibrary &&
+               graphics_pipeline_library_props.graphicsPipelineLibraryFastLinking;
+    }
+
+    /// Returns true when sampled images can be indexed from a partially bound runtime array that
+    /// is updated while in use.
+    bool IsSampledImageIndexingSupported() const {
+        return features.shaderSampledImageArrayDynamicIndexing &&
+               vk12_features.runtimeDescriptorArray &&
+               vk12_features.descriptorBindingPartiallyBound &&
+               vk12_features.descriptorBindingSampledImageUpdateAfterBind &&
+               vk12_features.descriptorBindingUpdateUnusedWhilePending;
+    }
+
+    /// Returns true when VK_EXT_descriptor_buffer is supported.
+    bool IsDescriptorBufferSupported() const {
+        return descriptor_buffer && descriptor_buffer_features.descriptorBuffer;
+    }
+
+    /// Returns true when VK_KHR_present_id and VK_KHR_present_wait are supported.
+    bool IsPresentWaitSupported() const {
+        return present_wait;
+    }
+
+    /// Returns the descriptor sizes and limits of VK_EXT_descriptor_buffer.
+    const vk::PhysicalDeviceDescriptorBufferPropertiesEXT& GetDescriptorBufferProperties() const {
+        return descriptor_buffer_props;
+    }
+
+    /// Returns true when the robustBufferAccess feature is enabled.
+    bool IsRobustBufferAccessEnabled() const {
+        return features.robustBufferAccess;
+    }
+
     /// Returns true when the robustBufferAccess2 feature of VK_EXT_robustness2 is supported.
     bool IsRobustBufferAccess2Supported() const {
         return robustness2 && robustness2_features.robustBufferAccess2;
@@ -210,6 +306,21 @@ public:
         return amd_shader_trinary_minmax;
     }
 
+    /// Returns true when subgroup shuffles are supported in compute and fragment shaders.
+    bool IsSubgroupShuffleSupported() const {
+        constexpr auto stages =
+            vk::ShaderStageFlagBits::eCompute | vk::ShaderStageFlagBits::eFragment;
+        return (vk11_props.subgroupSupportedOperations & vk::SubgroupFeatureFlagBits::eShuffle) &&
+               (vk11_props.subgroupSupportedStages & stages) == stages;
+    }
+
+    /// Returns true when compute shaders can be made to run in 64 wide subgroups like GCN waves.
+    bool IsComputeWave64Supported() const {
+        return subgroup_size_control && vk13_props.minSubgroupSize <= 64 &&
+               vk13_props.maxSubgroupSize >= 64 &&
+               (vk13_props.requiredSubgroupSizeStages & vk::ShaderStageFlagBits::eCompute);
+    }
+
     /// Returns true when the shaderBufferFloat32AtomicMinMax feature of
     /// VK_EXT_shader_atomic_float2 is supported.
     bool IsShaderAtomicFloatBuffer32MinMaxSupported() const {
@@ -335,6 +446,16 @@ public:
         return properties.limits.minStorageBufferOffsetAlignment;
     }
 
+    /// Returns true when timestamp queries can be written and reset from the host.
+    bool IsTimestampQuerySupported() const {
+        return properties.limits.timestampComputeAndGraphics && vk12_features.hostQueryReset;
+    }
+
+    /// Returns the number of nanoseconds per timestamp query tick.
+    float TimestampPeriod() const {
+        return properties.limits.timestampPeriod;
+    }
+
     /// Returns the minimum alignemt required for accessing host-mapped device memory
     vk::DeviceSize NonCoherentAtomSize() const {
         return properties.limits.nonCoherentAtomSize;
@@ -426,8 +547,18 @@ public:
         return supports_memory_budget;
     }
 
+    struct MemoryStatus {
+        u64 usage;
+        u64 budget;
+    };
+
+    /// Returns the current memory usage and the budget the driver is willing to give us.
+    [[nodiscard]] MemoryStatus GetDeviceMemoryStatus() const;
+
     /// Returns the amount of memory used.
-    [[nodiscard]] u64 GetDeviceMemoryUsage() const;
+    [[nodiscard]] u64 GetDeviceMemoryUsage() const {
+        return GetDeviceMemoryStatus().usage;
+    }
 
     /// Returns the total memory budget available to the device.
     [[nodiscard]] u64 GetTotalMemoryBudget() const {
@@ -444,6 +575,9 @@ private:
     /// Creates the VMA allocator handle
     void CreateAllocator();
 
+    /// Creates the VMA pool that small device local buffers are allocated from
+    void CreateSmallBufferPool();
+
     /// Collects various information from the device.
     void CollectDeviceParameters();
     void CollectPhysicalMemoryInfo();
@@ -460,31 +594,43 @@ private:
     vk::PhysicalDeviceMemoryProperties memory_properties;
     vk::PhysicalDeviceVulkan11Properties vk11_props;
     vk::PhysicalDeviceVulkan12Properties vk12_props;
+    vk::PhysicalDeviceVulkan13Properties vk13_props;
     vk::PhysicalDevicePushDescriptorPropertiesKHR push_descriptor_props;
     vk::PhysicalDeviceFeatures features;
     vk::PhysicalDeviceVulkan12Features vk12_features;
     vk::PhysicalDevicePortabilitySubsetFeaturesKHR portability_features;
+    vk::PhysicalDeviceExtendedDynamicState2FeaturesEXT dynamic_state_2_features;
     vk::PhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state_3_features;
     vk::PhysicalDeviceRobustness2FeaturesEXT robustness2_features;
     vk::PhysicalDeviceShaderAtomicFloat2FeaturesEXT shader_atomic_float2_features;
+    vk::PhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library_features;
+    vk::PhysicalDeviceGraphicsPipelineLibraryPropertiesEXT graphics_pipeline_library_props;
+    vk::PhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features;
+    vk::PhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_props;
     vk::PhysicalDeviceWorkgroupMemoryExplicitLayoutFeaturesKHR
         workgroup_memory_explicit_layout_features;
     vk::DriverIdKHR driver_id;
     vk::UniqueDebugUtilsMessengerEXT debug_callback{};
     std::string vendor_name;
     VmaAllocator allocator{};
+    VmaPool small_buffer_pool{};
     vk::Queue present_queue;
     vk::Queue graphics_queue;
+    vk::Queue transfer_queue;
+    vk::Queue compute_queue;
     std::vector<vk::PhysicalDevice> physical_devices;
     std::vector<std::string> available_extensions;
     std::unordered_map<vk::Format, vk::FormatProperties3> format_properties;
     TracyVkCtx profiler_context{};
     u32 queue_family_index{0};
+    std::optional<u32> transfer_queue_family_index;
+    bool has_compute_queue{};
     bool custom_border_color{};
     bool fragment_shader_barycentric{};
     bool amd_shader_explicit_vertex_parameter{};
     bool depth_clip_control{};
     bool depth_clip_enable{};
+    bool dynamic_state_2{};
     bool dynamic_state_3{};
     bool depth_range_unrestricted{};
     bool vertex_input_dynamic_state{};
@@ -496,10 +642,14 @@ private:
     bool image_load_store_lod{};
     bool amd_gcn_shader{};
     bool amd_shader_trinary_minmax{};
+    bool subgroup_size_control{};
     bool nv_framebuffer_mixed_samples{};
     bool amd_mixed_attachment_samples{};
     bool shader_atomic_float2{};
     bool workgroup_memory_explicit_layout{};
+    bool graphics_pipeline_library{};
+    bool descriptor_buffer{};
+    bool present_wait{};
     bool portability_subset{};
     bool maintenance_8{};
     bool attachment_feedback_loop{};
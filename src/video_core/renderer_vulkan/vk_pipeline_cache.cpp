@@ -2,11 +2,14 @@
 // SPDX-License-Identifier: GPL-2.0-or-later
 
 #include <ranges>
+#include <xxhash.h>
 
 #include "common/config.h"
 #include "common/hash.h"
 #include "common/io_file.h"
+#include "common/job_system.h"
 #include "common/path_util.h"
+#include "common/scope_exit.h"
 #include "core/debug_state.h"
 #include "shader_recompiler/backend/spirv/emit_spirv.h"
 #include "shader_recompiler/info.h"
@@ -16,7 +19,9 @@
 #include "video_core/renderer_vulkan/liverpool_to_vk.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/renderer_vulkan/vk_pipeline_library.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_shader_profiler.h"
 #include "video_core/renderer_vulkan/vk_shader_util.h"
 
 namespace Vulkan {
@@ -27,6 +32,9 @@ using Shader::Stage;
 
 constexpr static auto SpirvVersion1_6 = 0x00010600U;
 
+/// Number of newly created pipelines after which the pipeline cache blob is written to disk.
+constexpr static u32 PipelineSaveInterval = 64;
+
 constexpr static std::array DescriptorHeapSizes = {
     vk::DescriptorPoolSize{vk::DescriptorType::eUniformBuffer, 512},
     vk::DescriptorPoolSize{vk::DescriptorType::eStorageBuffer, 8192},
@@ -86,6 +94,51 @@ static u32 MapOutputs(std::span<Shader::OutputMap, 3> outputs, const AmdGpu::VsO
     return num_outputs;
 }
 
+/// Clears the state that is set with dynamic state commands, so draws that only differ in it
+/// share a pipeline.
+static GraphicsPipelineKey StripDynamicState(const Instance& instance, GraphicsPipelineKey key) {
+    if (instance.IsDynamicColorBlendSupported()) {
+        key.blend_controls.fill({});
+        key.cb_shader_mask = {};
+    }
+    if (instance.IsDynamicColorWriteMaskSupported()) {
+        key.write_masks.fill({});
+    }
+    if (instance.IsDynamicLogicOpSupported()) {
+        key.logic_op = {};
+    }
+    if (instance.IsDynamicPolygonModeSupported()) {
+        key.polygon_mode = {};
+    }
+    if (instance.IsDynamicRasterizationSamplesSupported()) {
+        key.num_samples = 0;
+        if (!instance.IsMixedDepthSamplesSupported()) {
+            // Attachment sample counts are only part of the pipeline with mixed samples.
+            key.color_samples.fill(0);
+            key.depth_samples = 0;
+        }
+    }
+    return key;
+}
+
+static Shader::Fp64Mode GetFp64Mode(bool support_float64) {
+    const auto requested = Config::getFp64Mode();
+    if (requested == "emulated") {
+        return Shader::Fp64Mode::Emulated;
+    }
+    if (requested == "demote") {
+        return Shader::Fp64Mode::Demote;
+    }
+    if (requested != "exact") {
+        LOG_WARNING(Render_Vulkan, "Unknown fp64 mode '{}'", requested);
+    }
+    if (!support_float64) {
+        LOG_INFO(Render_Vulkan, "No shaderFloat64 support, demoting doubles to floats");
+        return Shader::Fp64Mode::Demote;
+    }
+    return Shader::Fp64Mode::Exact;
+}
+
 const Shader::RuntimeInfo& PipelineCache::BuildRuntimeInfo(Stage stage, LogicalStage l_stage) {
     auto& info = runtime_infos[u32(l_stage)];
     const auto& regs = liverpool->regs;
@@ -218,9 +271,12 @@ const Shader::RuntimeInfo& PipelineCache::BuildRuntimeInfo(Stage stage, LogicalS
 }
 
 PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
-                             AmdGpu::Liverpool* liverpool_)
+                             AmdGpu::Liverpool* liverpool_, ShaderProfiler* shader_profiler_,
+                             const VideoCore::TextureHeap* texture_heap_)
     : instance{instance_}, scheduler{scheduler_}, liverpool{liverpool_},
-      desc_heap{instance, scheduler.GetMasterSemaphore(), DescriptorHeapSizes} {
+      shader_profiler{shader_profiler_}, texture_heap{texture_heap_},
+      desc_heap{instance, scheduler.GetMasterSemaphore(), DescriptorHeapSizes},
+      disk_cache{instance} {
     const auto& vk12_props = instance.GetVk12Properties();
     profile = Shader::Profile{
         .supported_spirv = SpirvVersion1_6,
@@ -237,6 +293,7 @@ PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
         .supports_image_load_store_lod = instance_.IsImageLoadStoreLodSupported(),
         .supports_native_cube_calc = instance_.IsAmdGcnShaderSupported(),
         .supports_trinary_minmax = instance_.IsAmdShaderTrinaryMinMaxSupported(),
+        .supports_subgroup_shuffle = instance_.IsSubgroupShuffleSupported(),
         // TODO: Emitted bounds checks cause problems with phi control flow; needs to be fixed.
         .supports_robust_buffer_access = true, // instance_.IsRobustBufferAccess2Supported(),
         .supports_buffer_fp32_atomic_min_max =
@@ -266,36 +323,170 @@ PipelineCache::PipelineCache(const Instance& instance_, Scheduler& scheduler_,
         .max_viewport_height = instance.GetMaxViewportHeight(),
         .max_shared_memory_size = instance.MaxComputeSharedMemorySize(),
     };
-    auto [cache_result, cache] = instance.GetDevice().createPipelineCacheUnique({});
+    profile.fp64_mode = GetFp64Mode(profile.support_float64);
+    profile.enable_block_counters = shader_profiler != nullptr;
+    profile.supports_texture_heap = texture_heap != nullptr;
+    const auto cache_data = disk_cache.LoadPipelineData();
+    const vk::PipelineCacheCreateInfo cache_ci = {
+        .initialDataSize = cache_data.size(),
+        .pInitialData = cache_data.data(),
+    };
+    auto [cache_result, cache] = instance.GetDevice().createPipelineCacheUnique(cache_ci);
+    if (cache_result != vk::Result::eSuccess && !cache_data.empty()) {
+        LOG_WARNING(Render_Vulkan, "Driver rejected stored pipeline cache: {}",
+                    vk::to_string(cache_result));
+        auto [retry_result, retry_cache] = instance.GetDevice().createPipelineCacheUnique({});
+        cache_result = retry_result;
+        cache = std::move(retry_cache);
+    }
     ASSERT_MSG(cache_result == vk::Result::eSuccess, "Failed to create pipeline cache: {}",
                vk::to_string(cache_result));
     pipeline_cache = std::move(cache);
+
+    if (instance.IsGraphicsPipelineLibrarySupported()) {
+        library_cache = std::make_unique<PipelineLibraryCache>(instance, *pipeline_cache);
+        LOG_INFO(Render_Vulkan, "Building graphics pipelines from pipeline libraries");
+    }
+    if (Config::isAsyncPipelineCompileEnabled()) {
+        const u32 num_workers = std::max(1U, std::thread::hardware_concurrency() / 4);
+        compile_worker = std::make_unique<Common::ThreadWorker>(num_workers, "PipelineCompiler");
+        LOG_INFO(Render_Vulkan, "Compiling graphics pipelines asynchronously on {} threads",
+                 num_workers);
+    }
+    shader_worker = std::make_unique<Common::ThreadWorker>(
+        std::clamp(std::thread::hardware_concurrency() / 4, 1U, MaxShaderStages), "ShaderEmitter");
+    const auto default_fp64_mode =
+        profile.support_float64 ? Shader::Fp64Mode::Exact : Shader::Fp64Mode::Demote;
+    if (profile.fp64_mode != default_fp64_mode) {
+        // Doubles are lowered differently than the default for this device.
+        spirv_key_seed = HashCombine(spirv_key_seed, static_cast<u64>(profile.fp64_mode) + 1);
+    }
+    if (profile.enable_block_counters) {
+        // Instrumented shaders must never be mixed with plain ones.
+        spirv_key_seed = HashCombine(spirv_key_seed, u64(profile.enable_block_counters));
+    }
+    if (profile.supports_texture_heap) {
+        // Heap indexed images have no binding of their own, plain shaders cannot be reused.
+        spirv_key_seed = HashCombine(spirv_key_seed, u64(profile.supports_texture_heap) + 1);
+    }
+    spirv_opt_passes = Config::getSpirvOptPasses();
+    if (!spirv_opt_passes.empty()) {
+#ifdef ENABLE_SPIRV_OPT
+        // Optimized code is not interchangeable with plain emitter output in the disk cache.
+        spirv_key_seed = HashCombine(spirv_key_seed,
+                                     XXH3_64bits(spirv_opt_passes.data(), spirv_opt_passes.size()));
+        LOG_INFO(Render_Vulkan, "Optimizing shaders with spirv-opt passes: {}", spirv_opt_passes);
+#else
+        LOG_WARNING(Render_Vulkan, "spirvOptPasses is set but this build has no spirv-opt support");
+        spirv_opt_passes.clear();
+#endif
+    }
+    if (Config::isDescriptorBufferEnabled()) {
+        // Must be enabled before any pipeline layout is created.
+        scheduler.EnableDescriptorBuffer();
+    }
+    if (disk_cache.IsEnabled() && Config::isPipelineWarmupEnabled()) {
+        warmup = std::make_unique<PipelineWarmup>(instance, scheduler, desc_heap, texture_heap,
+                                                  profile, *pipeline_cache, disk_cache);
+    }
+}
+
+PipelineCache::~PipelineCache() {
+    shader_worker->WaitForRequests();
+    if (pipelines_since_save != 0) {
+        disk_cache.SavePipelineData(*pipeline_cache);
+    }
+}
+
+void PipelineCache::SaveDiskCache() {
+    disk_cache.SavePipelineData(*pipeline_cache);
+    pipelines_since_save = 0;
+}
+
+void PipelineCache::RecordRecipe(const GraphicsPipeline& pipeline) {
+    if (!disk_cache.IsEnabled()) {
+        return;
+    }
+    std::array<u64, MaxShaderStages> spirv_keys{};
+    for (u32 stage = 0; stage < MaxShaderStages; ++stage) {
+        if (!infos[stage]) {
+            continue;
+        }
+        const auto it = module_spirv_keys.find(modules[stage]);
+        if (it == module_spirv_keys.end()) {
+            // Patched or replaced modules cannot be rebuilt from the SPIR-V store.
+            return;
+        }
+        spirv_keys[stage] = it->second;
+    }
+    const auto& fs_info = runtime_infos[u32(LogicalStage::Fragment)].fs_info;
+    disk_cache.StoreRecipe(pipeline.GetRecipe(fs_info, spirv_keys));
+}
+
+void PipelineCache::RecordRecipe(const ComputePipeline& pipeline) {
+    if (!disk_cache.IsEnabled()) {
+        return;
+    }
+    const auto it = module_spirv_keys.find(modules[0]);
+    if (it == module_spirv_keys.end()) {
+        return;
+    }
+    const auto& layout_bindings = pipeline.GetLayoutBindings();
+    disk_cache.StoreRecipe(ComputePipelineRecipe{
+        .spirv_key = it->second,
+        .layout_bindings = {layout_bindings.begin(), layout_bindings.end()},
+        .require_wave64 = pipeline.RequiresWave64(),
+    });
 }
 
-PipelineCache::~PipelineCache() = default;
+void PipelineCache::OnPipelineCreated() {
+    // The emulator exits without unwinding, so flush the driver cache at a regular interval.
+    if (disk_cache.IsEnabled() && ++pipelines_since_save >= PipelineSaveInterval) {
+        disk_cache.SavePipelineData(*pipeline_cache);
+        pipelines_since_save = 0;
+    }
+}
 
 const GraphicsPipeline* PipelineCache::GetGraphicsPipeline() {
     if (!RefreshGraphicsKey()) {
         return nullptr;
     }
-    const auto [it, is_new] = graphics_pipelines.try_emplace(graphics_key);
+    const auto key = StripDynamicState(instance, graphics_key);
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::PipelineLookups);
+    // Consecutive draws mostly keep the same state, comparing against the last key avoids
+    // hashing it for the map lookup.
+    if (last_graphics_pipeline && key == last_graphics_key) {
+        return last_graphics_pipeline;
+    }
+    const auto [it, is_new] = graphics_pipelines.try_emplace(key);
     if (is_new) {
-        const auto pipeline_hash = std::hash<GraphicsPipelineKey>{}(graphics_key);
+        const auto pipeline_hash = std::hash<GraphicsPipelineKey>{}(key);
         LOG_INFO(Render_Vulkan, "Compiling graphics pipeline {:#x}", pipeline_hash);
 
-        it.value() = std::make_unique<GraphicsPipeline>(instance, scheduler, desc_heap, profile,
-                                                        graphics_key, *pipeline_cache, infos,
-                                                        runtime_infos, fetch_shader, modules);
-        if (Config::collectShadersForDebug()) {
+        it.value() = std::make_unique<GraphicsPipeline>(
+            instance, scheduler, desc_heap, texture_heap, profile, key, *pipeline_cache, infos,
+            runtime_infos, fetch_shader, modules, compile_worker.get(), library_cache.get());
+        RecordRecipe(*it->second);
+        OnPipelineCreated();
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::PipelinesCreated);
+        DebugState.AddStall(DebugStateType::StallCause::PipelineCompile);
+        if (Config::GetSnapshot().collect_shaders_for_debug) {
             for (auto stage = 0; stage < MaxShaderStages; ++stage) {
                 if (infos[stage]) {
                     auto& m = modules[stage];
-                    module_related_pipelines[m].emplace_back(graphics_key);
+                    module_related_pipelines[m].emplace_back(key);
                 }
             }
         }
     }
-    return it->second.get();
+    if (!it->second->IsReady()) {
+        // Still being compiled in the background, the draw is skipped until it gets published.
+        LOG_TRACE(Render_Vulkan, "Skipping draw with pending graphics pipeline");
+        return nullptr;
+    }
+    last_graphics_key = key;
+    last_graphics_pipeline = it->second.get();
+    return last_graphics_pipeline;
 }
 
 const ComputePipeline* PipelineCache::GetComputePipeline() {
@@ -303,14 +494,19 @@ const ComputePipeline* PipelineCache::GetComputePipeline() {
         return nullptr;
     }
     const auto [it, is_new] = compute_pipelines.try_emplace(compute_key);
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::PipelineLookups);
     if (is_new) {
         const auto pipeline_hash = std::hash<ComputePipelineKey>{}(compute_key);
         LOG_INFO(Render_Vulkan, "Compiling compute pipeline {:#x}", pipeline_hash);
 
         it.value() =
-            std::make_unique<ComputePipeline>(instance, scheduler, desc_heap, profile,
+            std::make_unique<ComputePipeline>(instance, scheduler, desc_heap, texture_heap, profile,
                                               *pipeline_cache, compute_key, *infos[0], modules[0]);
-        if (Config::collectShadersForDebug()) {
+        RecordRecipe(*it->second);
+        OnPipelineCreated();
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::PipelinesCreated);
+        DebugState.AddStall(DebugStateType::StallCause::PipelineCompile);
+        if (Config::GetSnapshot().collect_shaders_for_debug) {
             auto& m = modules[0];
             module_related_pipelines[m].emplace_back(compute_key);
         }
@@ -417,6 +613,14 @@ bool PipelineCache::RefreshGraphicsStages() {
     auto& key = graphics_key;
     fetch_shader = std::nullopt;
 
+    // Stages are translated in order as the runtime info and bindings of one stage depend on the
+    // previous ones, but their SPIR-V is emitted concurrently and collected before returning.
+    defer_modules = true;
+    SCOPE_EXIT {
+        defer_modules = false;
+        FlushPendingModules();
+    };
+
     Shader::Backend::Bindings binding{};
     const auto bind_stage = [&](Shader::Stage stage_in, Shader::LogicalStage stage_out) -> bool {
         const auto stage_in_idx = static_cast<u32>(stage_in);
@@ -515,37 +719,154 @@ bool PipelineCache::RefreshComputeKey() {
     return true;
 }
 
-vk::ShaderModule PipelineCache::CompileModule(Shader::Info& info, Shader::RuntimeInfo& runtime_info,
+vk::ShaderModule PipelineCache::CompileModule(Program& program,
+                                              std::unique_ptr<Shader::Info> perm_info,
+                                              Shader::RuntimeInfo& runtime_info,
                                               std::span<const u32> code, size_t perm_idx,
                                               Shader::Backend::Bindings& binding) {
+    auto& info = perm_info ? *perm_info : program.info;
     LOG_INFO(Render_Vulkan, "Compiling {} shader {:#x} {}", info.stage, info.pgm_hash,
              perm_idx != 0 ? "(permutation)" : "");
     DumpShader(code, info.pgm_hash, info.stage, perm_idx, "bin");
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::ShaderCompiles);
+    DebugState.AddStall(DebugStateType::StallCause::ShaderCompile);
+
+    // A deferred stage keeps its IR alive until emission is done, so it gets its own pools.
+    const bool defer = defer_modules;
+    auto& ir_pools = [&]() -> Shader::Pools& {
+        if (!defer) {
+            return pools;
+        }
+        auto& slot_pools = stage_pools[num_pending_modules];
+        if (!slot_pools) {
+            slot_pools = std::make_unique<Shader::Pools>();
+        }
+        return *slot_pools;
+    }();
+
+    // Translation always runs as it fills the shader info and generates the SRT walker, but
+    // emission is skipped when a previous session already produced this permutation.
+    auto ir_program = Shader::TranslateProgram(code, ir_pools, info, runtime_info, profile);
+    if (shader_profiler && info.num_block_counters != 0) {
+        info.profiling_slot = shader_profiler->Register(
+            GetShaderName(info.stage, info.pgm_hash, perm_idx), info.num_block_counters);
+    }
+    const u64 spirv_key =
+        disk_cache.IsEnabled()
+            ? PipelineDiskCache::ComputeSpirvKey(
+                  spirv_key_seed ? HashCombine(info.pgm_hash, spirv_key_seed) : info.pgm_hash,
+                  Shader::StageSpecialization(info, runtime_info, profile, binding))
+            : 0;
+    if (auto cached_spv = disk_cache.IsEnabled() ? disk_cache.FindSpirv(spirv_key) : std::nullopt) {
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::SpirvCacheHits);
+        info.AddBindings(binding);
+        return CreateModule(info, code, perm_idx, spirv_key, *cached_spv);
+    }
+    if (disk_cache.IsEnabled()) {
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::SpirvCacheMisses);
+    }
+    if (!defer) {
+        Shader::PassClock clock;
+        auto spv = Shader::Backend::SPIRV::EmitSPIRV(profile, runtime_info, ir_program, binding);
+        clock.Lap(Shader::Pass::EmitSpirv);
+        OptimizeSpirv(spv);
+        disk_cache.StoreSpirv(spirv_key, spv);
+        return CreateModule(info, code, perm_idx, spirv_key, spv);
+    }
+
+    auto& pending = pending_modules[num_pending_modules++];
+    pending.program = &program;
+    pending.perm_idx = perm_idx;
+    pending.code = code;
+    pending.spirv_key = spirv_key;
+    pending.perm_info = std::move(perm_info);
+    pending.ir_program.emplace(std::move(ir_program));
+    pending.runtime_info = runtime_info;
+    pending.binding = binding;
+    // Emission advances the bindings exactly like this, the next stage can be set up right away.
+    info.AddBindings(binding);
+    shader_worker->QueueWork([this, &pending] {
+        Shader::PassClock clock;
+        pending.spv = Shader::Backend::SPIRV::EmitSPIRV(profile, pending.runtime_info,
+                                                        *pending.ir_program, pending.binding);
+        clock.Lap(Shader::Pass::EmitSpirv);
+        OptimizeSpirv(pending.spv);
+    });
+    // The module is filled in by FlushPendingModules.
+    return {};
+}
 
-    const auto ir_program = Shader::TranslateProgram(code, pools, info, runtime_info, profile);
-    auto spv = Shader::Backend::SPIRV::EmitSPIRV(profile, runtime_info, ir_program, binding);
+vk::ShaderModule PipelineCache::CreateModule(const Shader::Info& info, std::span<const u32> code,
+                                             size_t perm_idx, u64 spirv_key,
+                                             std::span<const u32> spv) {
     DumpShader(spv, info.pgm_hash, info.stage, perm_idx, "spv");
 
     vk::ShaderModule module;
 
-    auto patch = GetShaderPatch(info.pgm_hash, info.stage, perm_idx, "spv");
-    const bool is_patched = patch && Config::patchShaders();
+    const auto patch = Config::patchShaders()
+                           ? GetShaderPatch(info.pgm_hash, info.stage, perm_idx, "spv")
+                           : std::nullopt;
+    const bool is_patched = patch.has_value();
     if (is_patched) {
         LOG_INFO(Loader, "Loaded patch for {} shader {:#x}", info.stage, info.pgm_hash);
         module = CompileSPV(*patch, instance.GetDevice());
     } else {
+        // Permutations that only differ in state the shader does not consume emit the same code,
+        // let them share one module so pipelines built from them can be shared too.
+        const u64 spv_hash = XXH3_64bits(spv.data(), spv.size_bytes());
+        const auto [it, is_new] = spirv_modules.try_emplace(spv_hash);
+        if (!is_new) {
+            LOG_DEBUG(Render_Vulkan, "Permutation {} of {} shader {:#x} reuses existing module",
+                      perm_idx, info.stage, info.pgm_hash);
+            return it->second;
+        }
         module = CompileSPV(spv, instance.GetDevice());
+        it.value() = module;
+        if (disk_cache.IsEnabled()) {
+            module_spirv_keys.emplace(module, spirv_key);
+        }
     }
 
     const auto name = GetShaderName(info.stage, info.pgm_hash, perm_idx);
     Vulkan::SetObjectName(instance.GetDevice(), module, name);
-    if (Config::collectShadersForDebug()) {
+    if (Config::GetSnapshot().collect_shaders_for_debug) {
         DebugState.CollectShader(name, info.l_stage, module, spv, code,
                                  patch ? *patch : std::span<const u32>{}, is_patched);
     }
     return module;
 }
 
+void PipelineCache::OptimizeSpirv(std::vector<u32>& spv) const {
+    if (spirv_opt_passes.empty()) {
+        return;
+    }
+    if (auto optimized = OptimizeSPV(spv, spirv_opt_passes)) {
+        spv = std::move(*optimized);
+    } else {
+        LOG_ERROR(Render_Vulkan, "spirv-opt failed, using unoptimized shader");
+    }
+}
+
+void PipelineCache::FlushPendingModules() {
+    if (num_pending_modules == 0) {
+        return;
+    }
+    shader_worker->WaitForRequests();
+    for (u32 i = 0; i < num_pending_modules; ++i) {
+        auto& pending = pending_modules[i];
+        const auto& info = pending.ir_program->info;
+        disk_cache.StoreSpirv(pending.spirv_key, pending.spv);
+        const auto module =
+            CreateModule(info, pending.code, pending.perm_idx, pending.spirv_key, pending.spv);
+        pending.program->modules[pending.perm_idx].module = module;
+        modules[static_cast<u32>(info.l_stage)] = module;
+        pending.ir_program.reset();
+        pending.perm_info.reset();
+        pending.spv.clear();
+    }
+    num_pending_modules = 0;
+}
+
 PipelineCache::Result PipelineCache::GetProgram(Stage stage, LogicalStage l_stage,
                                                 Shader::ShaderParams params,
                                                 Shader::Backend::Bindings& binding) {
@@ -555,7 +876,7 @@ PipelineCache::Result PipelineCache::GetProgram(Stage stage, LogicalStage l_stag
         it_pgm.value() = std::make_unique<Program>(stage, l_stage, params);
         auto& program = it_pgm.value();
         auto start = binding;
-        const auto module = CompileModule(program->info, runtime_info, params.code, 0, binding);
+        const auto module = CompileModule(*program, nullptr, runtime_info, params.code, 0, binding);
         const auto spec = Shader::StageSpecialization(program->info, runtime_info, profile, start);
         program->AddPermut(module, std::move(spec));
         return std::make_tuple(&program->info, module, spec.fetch_shader_data,
@@ -572,10 +893,15 @@ PipelineCache::Result PipelineCache::GetProgram(Stage stage, LogicalStage l_stag
 
     const auto it = std::ranges::find(program->modules, spec, &Program::Module::spec);
     if (it == program->modules.end()) {
-        auto new_info = Shader::Info(stage, l_stage, params);
-        module = CompileModule(new_info, runtime_info, params.code, perm_idx, binding);
+        auto new_info = std::make_unique<Shader::Info>(stage, l_stage, params);
+        module = CompileModule(*program, std::move(new_info), runtime_info, params.code, perm_idx,
+                               binding);
         program->AddPermut(module, std::move(spec));
     } else {
+        if (!it->module) {
+            // This permutation is still being emitted for another stage of the pipeline.
+            FlushPendingModules();
+        }
         info.AddBindings(binding);
         module = it->module;
         perm_idx = std::distance(program->modules.begin(), it);
@@ -586,18 +912,36 @@ PipelineCache::Result PipelineCache::GetProgram(Stage stage, LogicalStage l_stag
 
 std::optional<vk::ShaderModule> PipelineCache::ReplaceShader(vk::ShaderModule module,
                                                              std::span<const u32> spv_code) {
+    if (compile_worker) {
+        // Pipelines referencing the old module might still be under construction.
+        compile_worker->WaitForRequests();
+    }
+    if (library_cache) {
+        // Libraries are keyed by module handles which may be reused after destruction.
+        library_cache->Clear();
+    }
     std::optional<vk::ShaderModule> new_module{};
+    const auto& d = instance.GetDevice();
     for (const auto& [_, program] : program_cache) {
         for (auto& m : program->modules) {
+            // Deduplicated modules are shared between permutations, replace them all at once.
             if (m.module == module) {
-                const auto& d = instance.GetDevice();
-                d.destroyShaderModule(m.module);
-                m.module = CompileSPV(spv_code, d);
-                new_module = m.module;
+                if (!new_module) {
+                    new_module = CompileSPV(spv_code, d);
+                }
+                m.module = *new_module;
             }
         }
     }
+    if (new_module) {
+        d.destroyShaderModule(module);
+        module_spirv_keys.erase(module);
+        for (auto it = spirv_modules.begin(); it != spirv_modules.end();) {
+            it = it->second == module ? spirv_modules.erase(it) : std::next(it);
+        }
+    }
     if (module_related_pipelines.contains(module)) {
+        last_graphics_pipeline = nullptr;
         auto& pipeline_keys = module_related_pipelines[module];
         for (auto& key : pipeline_keys) {
             if (std::holds_alternative<GraphicsPipelineKey>(key)) {
@@ -628,12 +972,16 @@ void PipelineCache::DumpShader(std::span<const u32> code, u64 hash, Shader::Stag
 
     using namespace Common::FS;
     const auto dump_dir = GetUserPath(PathType::ShaderDir) / "dumps";
-    if (!std::filesystem::exists(dump_dir)) {
-        std::filesystem::create_directories(dump_dir);
-    }
     const auto filename = fmt::format("{}.{}", GetShaderName(stage, hash, perm_idx), ext);
-    const auto file = IOFile{dump_dir / filename, FileAccessMode::Write};
-    file.WriteSpan(code);
+    // Written in the background so that dumping does not add to the compile times.
+    Common::JobSystem::Get().Schedule(
+        Common::JobPriority::Background,
+        [path = dump_dir / filename, code = std::vector<u32>(code.begin(), code.end())] {
+            std::error_code ec;
+            std::filesystem::create_directories(path.parent_path(), ec);
+            const auto file = IOFile{path, FileAccessMode::Write};
+            file.WriteSpan<u32>(code);
+        });
 }
 
 std::optional<std::vector<u32>> PipelineCache::GetShaderPatch(u64 hash, Shader::Stage stage,
@@ -642,12 +990,17 @@ std::optional<std::vector<u32>> PipelineCache::GetShaderPatch(u64 hash, Shader::
 
     using namespace Common::FS;
     const auto patch_dir = GetUserPath(PathType::ShaderDir) / "patch";
-    if (!std::filesystem::exists(patch_dir)) {
-        std::filesystem::create_directories(patch_dir);
+    if (!shader_patches) {
+        // The directory is listed once, instead of probing it for every compiled module.
+        auto& patches = shader_patches.emplace();
+        std::error_code ec;
+        std::filesystem::create_directories(patch_dir, ec);
+        for (const auto& entry : std::filesystem::directory_iterator{patch_dir, ec}) {
+            patches.insert(entry.path().filename().string());
+        }
     }
     const auto filename = fmt::format("{}.{}", GetShaderName(stage, hash, perm_idx), ext);
-    const auto filepath = patch_dir / filename;
-    if (!std::filesystem::exists(filepath)) {
+    if (!shader_patches->contains(filename)) {
         return {};
     }
     const auto file = IOFile{patch_dir / filename, FileAccessMode::Read};
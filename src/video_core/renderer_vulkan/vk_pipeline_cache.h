@@ -3,13 +3,18 @@
 
 #pragma once
 
+#include <string>
 #include <variant>
 #include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
+#include "common/thread_worker.h"
 #include "shader_recompiler/profile.h"
 #include "shader_recompiler/recompiler.h"
 #include "shader_recompiler/specialization.h"
 #include "video_core/renderer_vulkan/vk_compute_pipeline.h"
 #include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
+#include "video_core/renderer_vulkan/vk_pipeline_disk_cache.h"
+#include "video_core/renderer_vulkan/vk_pipeline_warmup.h"
 #include "video_core/renderer_vulkan/vk_resource_pool.h"
 
 template <>
@@ -32,6 +37,8 @@ namespace Vulkan {
 class Instance;
 class Scheduler;
 class ShaderCache;
+class ShaderProfiler;
+class PipelineLibraryCache;
 
 struct Program {
     struct Module {
@@ -54,11 +61,18 @@ struct Program {
 class PipelineCache {
 public:
     explicit PipelineCache(const Instance& instance, Scheduler& scheduler,
-                           AmdGpu::Liverpool* liverpool);
+                           AmdGpu::Liverpool* liverpool, ShaderProfiler* shader_profiler,
+                           const VideoCore::TextureHeap* texture_heap);
     ~PipelineCache();
 
     const GraphicsPipeline* GetGraphicsPipeline();
 
+    /// Returns the graphics state of the last draw, including the state that is dynamic on this
+    /// device and thus cleared from the keys of the pipelines.
+    const GraphicsPipelineKey& GetGraphicsState() const {
+        return graphics_key;
+    }
+
     const ComputePipeline* GetComputePipeline();
 
     using Result = std::tuple<const Shader::Info*, vk::ShaderModule,
@@ -76,6 +90,9 @@ public:
         return profile;
     }
 
+    /// Writes the driver pipeline cache to disk, the emulator exits and restarts without unwinding.
+    void SaveDiskCache();
+
 private:
     bool RefreshGraphicsKey();
     bool RefreshGraphicsStages();
@@ -85,17 +102,28 @@ private:
                     std::string_view ext);
     std::optional<std::vector<u32>> GetShaderPatch(u64 hash, Shader::Stage stage, size_t perm_idx,
                                                    std::string_view ext);
-    vk::ShaderModule CompileModule(Shader::Info& info, Shader::RuntimeInfo& runtime_info,
-                                   std::span<const u32> code, size_t perm_idx,
-                                   Shader::Backend::Bindings& binding);
+    vk::ShaderModule CompileModule(Program& program, std::unique_ptr<Shader::Info> perm_info,
+                                   Shader::RuntimeInfo& runtime_info, std::span<const u32> code,
+                                   size_t perm_idx, Shader::Backend::Bindings& binding);
+    vk::ShaderModule CreateModule(const Shader::Info& info, std::span<const u32> code,
+                                  size_t perm_idx, u64 spirv_key, std::span<const u32> spv);
+    void FlushPendingModules();
+    void OptimizeSpirv(std::vector<u32>& spv) const;
     const Shader::RuntimeInfo& BuildRuntimeInfo(Shader::Stage stage, Shader::LogicalStage l_stage);
+    void OnPipelineCreated();
+    void RecordRecipe(const GraphicsPipeline& pipeline);
+    void RecordRecipe(const ComputePipeline& pipeline);
 
 private:
     const Instance& instance;
     Scheduler& scheduler;
     AmdGpu::Liverpool* liverpool;
+    ShaderProfiler* shader_profiler;
+    const VideoCore::TextureHeap* texture_heap;
     DescriptorHeap desc_heap;
+    PipelineDiskCache disk_cache;
     vk::UniquePipelineCache pipeline_cache;
+    u32 pipelines_since_save{};
     vk::UniquePipelineLayout pipeline_layout;
     Shader::Profile profile{};
     Shader::Pools pools;
@@ -108,6 +136,37 @@ private:
     std::optional<Shader::Gcn::FetchShaderData> fetch_shader{};
     GraphicsPipelineKey graphics_key{};
     ComputePipelineKey compute_key{};
+    /// Key and pipeline of the last draw, checked before looking up the pipeline map.
+    GraphicsPipelineKey last_graphics_key{};
+    const GraphicsPipeline* last_graphics_pipeline{};
+    std::unique_ptr<PipelineLibraryCache> library_cache;
+    tsl::robin_map<vk::ShaderModule, u64> module_spirv_keys;
+    /// File names in the shader patch directory, listed on the first lookup.
+    std::optional<tsl::robin_set<std::string>> shader_patches;
+    tsl::robin_map<u64, vk::ShaderModule> spirv_modules;
+    std::unique_ptr<Common::ThreadWorker> compile_worker;
+    std::unique_ptr<PipelineWarmup> warmup;
+    std::string spirv_opt_passes;
+    /// Mixed into disk cache SPIR-V keys when emitted code differs from the default output.
+    u64 spirv_key_seed{};
+
+    /// Stages whose SPIR-V is being emitted on the shader worker while the next stage translates.
+    struct PendingModule {
+        Program* program;
+        size_t perm_idx;
+        std::span<const u32> code;
+        u64 spirv_key;
+        std::unique_ptr<Shader::Info> perm_info;
+        std::optional<Shader::IR::Program> ir_program;
+        Shader::RuntimeInfo runtime_info;
+        Shader::Backend::Bindings binding;
+        std::vector<u32> spv;
+    };
+    std::array<PendingModule, MaxShaderStages> pending_modules{};
+    std::array<std::unique_ptr<Shader::Pools>, MaxShaderStages> stage_pools;
+    u32 num_pending_modules{};
+    bool defer_modules{};
+    std::unique_ptr<Common::ThreadWorker> shader_worker;
 
     // Only if Config::collectShadersForDebug()
     tsl::robin_map<vk::ShaderModule,
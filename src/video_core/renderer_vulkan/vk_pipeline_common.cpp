@@ -1,21 +1,24 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <boost/container/static_vector.hpp>
 
+#include "core/debug_state.h"
 #include "shader_recompiler/resource.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
 #include "video_core/renderer_vulkan/vk_pipeline_common.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/texture_cache/texture_heap.h"
 
 namespace Vulkan {
 
 Pipeline::Pipeline(const Instance& instance_, Scheduler& scheduler_, DescriptorHeap& desc_heap_,
-                   const Shader::Profile& profile_, vk::PipelineCache pipeline_cache,
-                   bool is_compute_ /*= false*/)
-    : instance{instance_}, scheduler{scheduler_}, desc_heap{desc_heap_}, profile{profile_},
-      is_compute{is_compute_} {}
+                   const VideoCore::TextureHeap* texture_heap_, const Shader::Profile& profile_,
+                   vk::PipelineCache pipeline_cache, bool is_compute_ /*= false*/)
+    : instance{instance_}, scheduler{scheduler_}, desc_heap{desc_heap_},
+      texture_heap{texture_heap_}, profile{profile_}, is_compute{is_compute_} {}
 
 Pipeline::~Pipeline() = default;
 
@@ -26,22 +29,31 @@ void Pipeline::BindResources(DescriptorWrites& set_writes, const BufferBarriers&
         IsCompute() ? vk::PipelineBindPoint::eCompute : vk::PipelineBindPoint::eGraphics;
 
     if (!buffer_barriers.empty()) {
-        const auto dependencies = vk::DependencyInfo{
-            .dependencyFlags = vk::DependencyFlagBits::eByRegion,
-            .bufferMemoryBarrierCount = u32(buffer_barriers.size()),
-            .pBufferMemoryBarriers = buffer_barriers.data(),
-        };
-        scheduler.EndRendering();
-        cmdbuf.pipelineBarrier2(dependencies);
+        // Recorded together with the image transitions of the draw or dispatch.
+        scheduler.DeferBarriers({}, buffer_barriers);
     }
 
     const auto stage_flags = IsCompute() ? vk::ShaderStageFlagBits::eCompute : AllGraphicsStageBits;
     cmdbuf.pushConstants(*pipeline_layout, stage_flags, 0u, sizeof(push_data), &push_data);
 
+    if (texture_heap && std::ranges::any_of(GetStages(), [](const Shader::Info* info) {
+            return info && info->uses_texture_heap;
+        })) {
+        cmdbuf.bindDescriptorSets(bind_point, *pipeline_layout, 1, texture_heap->Set(), {});
+    }
+
     // Bind descriptor set.
     if (set_writes.empty()) {
         return;
     }
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::DescriptorWrites,
+                                     set_writes.size());
+
+    if (uses_descriptor_buffer) {
+        scheduler.GetDescriptorBuffer()->Bind(cmdbuf, bind_point, *pipeline_layout,
+                                              desc_buffer_layout, set_writes);
+        return;
+    }
 
     if (uses_push_descriptors) {
         cmdbuf.pushDescriptorSetKHR(bind_point, *pipeline_layout, 0, set_writes);
@@ -56,6 +68,35 @@ void Pipeline::BindResources(DescriptorWrites& set_writes, const BufferBarriers&
     cmdbuf.bindDescriptorSets(bind_point, *pipeline_layout, 0, desc_set, {});
 }
 
+void Pipeline::CreateDescSetLayout() {
+    // Descriptor buffers replace both push descriptors and the pooled sets when enabled.
+    const auto* descriptor_buffer = scheduler.GetDescriptorBuffer();
+    uses_descriptor_buffer = descriptor_buffer != nullptr;
+    uses_push_descriptors =
+        !uses_descriptor_buffer && layout_bindings.size() < instance.MaxPushDescriptors();
+    vk::DescriptorSetLayoutCreateFlags flags{};
+    if (uses_descriptor_buffer) {
+        flags = vk::DescriptorSetLayoutCreateFlagBits::eDescriptorBufferEXT;
+    } else if (uses_push_descriptors) {
+        flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR;
+    }
+    const vk::DescriptorSetLayoutCreateInfo desc_layout_ci = {
+        .flags = flags,
+        .bindingCount = static_cast<u32>(layout_bindings.size()),
+        .pBindings = layout_bindings.data(),
+    };
+    auto [layout_result, layout] =
+        instance.GetDevice().createDescriptorSetLayoutUnique(desc_layout_ci);
+    ASSERT_MSG(layout_result == vk::Result::eSuccess,
+               "Failed to create {} descriptor set layout: {}",
+               is_compute ? "compute" : "graphics", vk::to_string(layout_result));
+    desc_layout = std::move(layout);
+    if (uses_descriptor_buffer) {
+        desc_buffer_layout = descriptor_buffer->GetSetLayout(
+            *desc_layout, static_cast<u32>(layout_bindings.size()));
+    }
+}
+
 std::string Pipeline::GetDebugString() const {
     std::string stage_desc;
     for (const auto& stage : stages) {
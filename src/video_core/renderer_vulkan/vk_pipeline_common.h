@@ -3,9 +3,12 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "shader_recompiler/profile.h"
 #include "shader_recompiler/runtime_info.h"
 #include "video_core/renderer_vulkan/vk_common.h"
+#include "video_core/renderer_vulkan/vk_descriptor_buffer.h"
 
 #include <boost/container/small_vector.hpp>
 
@@ -14,6 +17,10 @@ struct Info;
 struct PushData;
 } // namespace Shader
 
+namespace VideoCore {
+class TextureHeap;
+}
+
 namespace Vulkan {
 
 static constexpr auto AllGraphicsStageBits =
@@ -28,12 +35,12 @@ class DescriptorHeap;
 class Pipeline {
 public:
     Pipeline(const Instance& instance, Scheduler& scheduler, DescriptorHeap& desc_heap,
-             const Shader::Profile& profile, vk::PipelineCache pipeline_cache,
-             bool is_compute = false);
+             const VideoCore::TextureHeap* texture_heap, const Shader::Profile& profile,
+             vk::PipelineCache pipeline_cache, bool is_compute = false);
     virtual ~Pipeline();
 
     vk::Pipeline Handle() const noexcept {
-        return *pipeline;
+        return is_optimized.load(std::memory_order_acquire) ? *optimized_pipeline : *pipeline;
     }
 
     vk::PipelineLayout GetLayout() const noexcept {
@@ -57,8 +64,18 @@ public:
         return is_compute;
     }
 
+    /// Returns false while the pipeline object is still being built by a compile worker.
+    bool IsReady() const noexcept {
+        return is_ready.load(std::memory_order_acquire);
+    }
+
     using DescriptorWrites = boost::container::small_vector<vk::WriteDescriptorSet, 16>;
     using BufferBarriers = boost::container::small_vector<vk::BufferMemoryBarrier2, 16>;
+    using LayoutBindings = boost::container::small_vector<vk::DescriptorSetLayoutBinding, 32>;
+
+    const LayoutBindings& GetLayoutBindings() const noexcept {
+        return layout_bindings;
+    }
 
     void BindResources(DescriptorWrites& set_writes, const BufferBarriers& buffer_barriers,
                        const Shader::PushData& push_data) const;
@@ -66,16 +83,33 @@ public:
 protected:
     [[nodiscard]] std::string GetDebugString() const;
 
+    /// Creates the descriptor set layout from the current layout bindings.
+    void CreateDescSetLayout();
+
+    /// Returns the flags required by the descriptor set layout for creating the pipeline.
+    [[nodiscard]] vk::PipelineCreateFlags GetLayoutPipelineFlags() const noexcept {
+        return uses_descriptor_buffer ? vk::PipelineCreateFlagBits::eDescriptorBufferEXT
+                                      : vk::PipelineCreateFlags{};
+    }
+
     const Instance& instance;
     Scheduler& scheduler;
     DescriptorHeap& desc_heap;
+    const VideoCore::TextureHeap* texture_heap;
     const Shader::Profile& profile;
     vk::UniquePipeline pipeline;
     vk::UniquePipelineLayout pipeline_layout;
     vk::UniqueDescriptorSetLayout desc_layout;
+    LayoutBindings layout_bindings;
     std::array<const Shader::Info*, Shader::MaxStageTypes> stages{};
+    DescriptorBuffer::SetLayout desc_buffer_layout;
     bool uses_push_descriptors{};
+    bool uses_descriptor_buffer{};
     bool is_compute;
+    std::atomic<bool> is_ready{true};
+    /// Link time optimized replacement for pipelines fast linked from libraries.
+    vk::UniquePipeline optimized_pipeline;
+    std::atomic<bool> is_optimized{};
 };
 
 } // namespace Vulkan
@@ -0,0 +1,542 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+#include <type_traits>
+#include <xxhash.h>
+
+#include "common/config.h"
+#include "common/elf_info.h"
+#include "common/logging/log.h"
+#include "common/path_util.h"
+#include "common/scm_rev.h"
+#include "shader_recompiler/specialization.h"
+#include "video_core/renderer_vulkan/vk_compute_pipeline.h"
+#include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_pipeline_disk_cache.h"
+
+namespace Vulkan {
+
+using namespace Common::FS;
+
+constexpr u32 CacheMagic = 0x43505053; // "SPPC"
+constexpr u32 CacheVersion = 3;
+
+constexpr std::string_view SpirvStoreName = "spirv.bin";
+constexpr std::string_view PipelineDataName = "pipelines.bin";
+constexpr std::string_view RecipeStoreName = "warmup.bin";
+constexpr std::string_view SharedDirName = "shared";
+
+struct SpirvEntryHeader {
+    u64 key;
+    u32 num_words;
+    u32 checksum;
+};
+static_assert(sizeof(SpirvEntryHeader) == 16);
+
+enum class RecipeType : u32 {
+    Graphics = 0,
+    Compute = 1,
+};
+
+struct RecipeEntryHeader {
+    RecipeType type;
+    u32 size;
+    u64 checksum;
+};
+static_assert(sizeof(RecipeEntryHeader) == 16);
+
+static u32 Checksum(std::span<const u32> spv) {
+    return static_cast<u32>(XXH3_64bits(spv.data(), spv.size_bytes()));
+}
+
+namespace {
+
+/// Flat byte writer for recipe records, all serialized members are trivially copyable.
+class RecipeWriter {
+public:
+    template <typename T>
+    void Write(const T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const auto* bytes = reinterpret_cast<const u8*>(&value);
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    void WriteList(const std::vector<T>& list) {
+        Write(static_cast<u32>(list.size()));
+        for (const auto& value : list) {
+            Write(value);
+        }
+    }
+
+    std::vector<u8> data;
+};
+
+class RecipeReader {
+public:
+    explicit RecipeReader(std::span<const u8> data_) : data{data_} {}
+
+    template <typename T>
+    bool Read(T& value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        if (offset + sizeof(T) > data.size()) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    template <typename T>
+    bool ReadList(std::vector<T>& list) {
+        u32 count{};
+        if (!Read(count) || offset + u64(count) * sizeof(T) > data.size()) {
+            return false;
+        }
+        list.resize(count);
+        for (auto& value : list) {
+            Read(value);
+        }
+        return true;
+    }
+
+    bool AtEnd() const {
+        return offset == data.size();
+    }
+
+private:
+    std::span<const u8> data;
+    size_t offset{};
+};
+
+u64 RecipeHash(const GraphicsPipelineRecipe& recipe) {
+    return XXH3_64bits(&recipe.key, sizeof(recipe.key));
+}
+
+u64 RecipeHash(const ComputePipelineRecipe& recipe) {
+    return recipe.spirv_key;
+}
+
+bool Deserialize(RecipeReader& reader, GraphicsPipelineRecipe& recipe) {
+    return reader.Read(recipe.key) && reader.Read(recipe.spirv_keys) &&
+           reader.Read(recipe.fs_info) && reader.ReadList(recipe.vertex_attributes) &&
+           reader.ReadList(recipe.vertex_bindings) && reader.ReadList(recipe.vertex_divisors) &&
+           reader.ReadList(recipe.layout_bindings) && reader.AtEnd();
+}
+
+bool Deserialize(RecipeReader& reader, ComputePipelineRecipe& recipe) {
+    return reader.Read(recipe.spirv_key) && reader.ReadList(recipe.layout_bindings) &&
+           reader.Read(recipe.require_wave64) && reader.AtEnd();
+}
+
+} // Anonymous namespace
+
+PipelineDiskCache::PipelineDiskCache(const Instance& instance_) : instance{instance_} {
+    if (!Config::isPipelineCacheEnabled()) {
+        return;
+    }
+    const auto serial = Common::ElfInfo::Instance().GameSerial();
+    if (serial.empty()) {
+        LOG_WARNING(Render_Vulkan, "Unknown title serial, pipeline disk cache is disabled");
+        return;
+    }
+
+    cache_dir = GetUserPath(PathType::ShaderDir) / "cache" / serial;
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+    if (ec) {
+        LOG_ERROR(Render_Vulkan, "Failed to create pipeline cache directory {}: {}",
+                  cache_dir.string(), ec.message());
+        return;
+    }
+
+    header.magic = CacheMagic;
+    header.version = CacheVersion;
+    header.vendor_id = instance.GetVendorID();
+    header.device_id = instance.GetDeviceID();
+    header.driver_version = instance.GetDriverVersion();
+    header.pipeline_cache_uuid = instance.GetPipelineCacheUUID();
+    header.build_hash = XXH3_64bits(Common::g_scm_rev, std::strlen(Common::g_scm_rev));
+
+    enabled = true;
+    OpenSpirvStore();
+    OpenSharedSpirvStore();
+    OpenRecipeStore();
+}
+
+PipelineDiskCache::~PipelineDiskCache() = default;
+
+void PipelineDiskCache::OpenSpirvStore() {
+    const auto path = cache_dir / SpirvStoreName;
+    if (std::filesystem::exists(path)) {
+        spirv_file.Open(path, FileAccessMode::ReadAppend);
+        spirv_file.Seek(0);
+        Header file_header{};
+        if (!spirv_file.ReadObject(file_header) || file_header != header) {
+            LOG_INFO(Render_Vulkan, "Discarding incompatible SPIR-V cache {}", path.string());
+            spirv_file.Close();
+        }
+    }
+
+    if (spirv_file.IsOpen()) {
+        const u64 file_size = spirv_file.GetSize();
+        u64 valid_size = sizeof(Header);
+        SpirvEntryHeader entry{};
+        while (spirv_file.ReadObject(entry)) {
+            const u64 entry_end = valid_size + sizeof(entry) + u64(entry.num_words) * sizeof(u32);
+            if (entry_end > file_size) {
+                break;
+            }
+            std::vector<u32> spv(entry.num_words);
+            if (spirv_file.ReadSpan<u32>(spv) != spv.size() || Checksum(spv) != entry.checksum) {
+                break;
+            }
+            spirv_entries.insert_or_assign(entry.key, std::move(spv));
+            valid_size = entry_end;
+        }
+        if (valid_size != file_size) {
+            // A previous session was interrupted while appending, drop the partial entry.
+            LOG_WARNING(Render_Vulkan, "Truncating damaged SPIR-V cache at offset {:#x}",
+                        valid_size);
+            spirv_file.SetSize(valid_size);
+        }
+        LOG_INFO(Render_Vulkan, "Loaded {} cached SPIR-V modules for {}", spirv_entries.size(),
+                 cache_dir.filename().string());
+        return;
+    }
+
+    spirv_file.Open(path, FileAccessMode::Write);
+    if (!spirv_file.IsOpen() || !spirv_file.WriteObject(header)) {
+        LOG_ERROR(Render_Vulkan, "Failed to create SPIR-V cache {}", path.string());
+        spirv_file.Close();
+        return;
+    }
+    spirv_file.Flush();
+}
+
+void PipelineDiskCache::OpenSharedSpirvStore() {
+    const auto shared_dir = GetUserPath(PathType::ShaderDir) / "cache" / SharedDirName;
+    std::error_code ec;
+    std::filesystem::create_directories(shared_dir, ec);
+    if (ec) {
+        LOG_ERROR(Render_Vulkan, "Failed to create shared SPIR-V cache directory {}: {}",
+                  shared_dir.string(), ec.message());
+        return;
+    }
+
+    const auto path = shared_dir / SpirvStoreName;
+    if (std::filesystem::exists(path)) {
+        shared_spirv_file.Open(path, FileAccessMode::ReadAppend);
+        shared_spirv_file.Seek(0);
+        Header file_header{};
+        if (!shared_spirv_file.ReadObject(file_header) || file_header != header) {
+            LOG_INFO(Render_Vulkan, "Discarding incompatible shared SPIR-V cache {}",
+                     path.string());
+            shared_spirv_file.Close();
+        }
+    }
+
+    if (shared_spirv_file.IsOpen()) {
+        // The store holds the modules of every title, only index it and read modules on demand.
+        const u64 file_size = shared_spirv_file.GetSize();
+        u64 valid_size = sizeof(Header);
+        SpirvEntryHeader entry{};
+        while (shared_spirv_file.ReadObject(entry)) {
+            const u64 data_offset = valid_size + sizeof(entry);
+            const u64 entry_end = data_offset + u64(entry.num_words) * sizeof(u32);
+            if (entry_end > file_size) {
+                break;
+            }
+            shared_spirv_index.insert_or_assign(
+                entry.key, SharedSpirvEntry{data_offset, entry.num_words, entry.checksum});
+            valid_size = entry_end;
+            shared_spirv_file.Seek(entry_end);
+        }
+        if (valid_size != file_size) {
+            LOG_WARNING(Render_Vulkan, "Truncating damaged shared SPIR-V cache at offset {:#x}",
+                        valid_size);
+            shared_spirv_file.SetSize(valid_size);
+        }
+        LOG_INFO(Render_Vulkan, "Indexed {} shared SPIR-V modules", shared_spirv_index.size());
+        return;
+    }
+
+    shared_spirv_file.Open(path, FileAccessMode::Write);
+    if (!shared_spirv_file.IsOpen() || !shared_spirv_file.WriteObject(header)) {
+        LOG_ERROR(Render_Vulkan, "Failed to create shared SPIR-V cache {}", path.string());
+        shared_spirv_file.Close();
+        return;
+    }
+    // Reopen for reading too, modules stored in this session are read back on demand.
+    shared_spirv_file.Close();
+    shared_spirv_file.Open(path, FileAccessMode::ReadAppend);
+}
+
+void PipelineDiskCache::OpenRecipeStore() {
+    const auto path = cache_dir / RecipeStoreName;
+    if (std::filesystem::exists(path)) {
+        recipe_file.Open(path, FileAccessMode::ReadAppend);
+        recipe_file.Seek(0);
+        Header file_header{};
+        if (recipe_file.ReadObject(file_header) && file_header == header) {
+            return;
+        }
+        LOG_INFO(Render_Vulkan, "Discarding incompatible pipeline recipes {}", path.string());
+        recipe_file.Close();
+    }
+
+    recipe_file.Open(path, FileAccessMode::Write);
+    if (!recipe_file.IsOpen() || !recipe_file.WriteObject(header)) {
+        LOG_ERROR(Render_Vulkan, "Failed to create pipeline recipe store {}", path.string());
+        recipe_file.Close();
+        return;
+    }
+    recipe_file.Flush();
+}
+
+void PipelineDiskCache::LoadRecipes(std::vector<GraphicsPipelineRecipe>& graphics,
+                                    std::vector<ComputePipelineRecipe>& compute) {
+    std::scoped_lock lk{recipe_mutex};
+    if (!enabled || !recipe_file.IsOpen()) {
+        return;
+    }
+    const u64 file_size = recipe_file.GetSize();
+    u64 valid_size = sizeof(Header);
+    recipe_file.Seek(valid_size);
+
+    RecipeEntryHeader entry{};
+    std::vector<u8> data;
+    while (recipe_file.ReadObject(entry)) {
+        const u64 entry_end = valid_size + sizeof(entry) + entry.size;
+        if (entry_end > file_size) {
+            break;
+        }
+        data.resize(entry.size);
+        if (recipe_file.ReadSpan<u8>(data) != data.size() ||
+            XXH3_64bits(data.data(), data.size()) != entry.checksum) {
+            break;
+        }
+        RecipeReader reader{data};
+        if (entry.type == RecipeType::Graphics) {
+            auto& recipe = graphics.emplace_back();
+            if (!Deserialize(reader, recipe)) {
+                graphics.pop_back();
+                break;
+            }
+            recorded_recipes.insert(RecipeHash(recipe));
+        } else if (entry.type == RecipeType::Compute) {
+            auto& recipe = compute.emplace_back();
+            if (!Deserialize(reader, recipe)) {
+                compute.pop_back();
+                break;
+            }
+            recorded_recipes.insert(RecipeHash(recipe));
+        } else {
+            break;
+        }
+        valid_size = entry_end;
+    }
+    if (valid_size != file_size) {
+        LOG_WARNING(Render_Vulkan, "Truncating damaged pipeline recipe store at offset {:#x}",
+                    valid_size);
+        recipe_file.SetSize(valid_size);
+    }
+    // Layout bindings never carry immutable samplers, make sure no stale pointer survives.
+    const auto clear_samplers = [](auto& bindings) {
+        for (auto& binding : bindings) {
+            binding.pImmutableSamplers = nullptr;
+        }
+    };
+    for (auto& recipe : graphics) {
+        clear_samplers(recipe.layout_bindings);
+    }
+    for (auto& recipe : compute) {
+        clear_samplers(recipe.layout_bindings);
+    }
+    LOG_INFO(Render_Vulkan, "Loaded {} graphics and {} compute pipeline recipes", graphics.size(),
+             compute.size());
+}
+
+template <typename Serialize>
+static void AppendRecipe(Common::FS::IOFile& file, RecipeType type, Serialize&& serialize) {
+    RecipeWriter writer;
+    serialize(writer);
+    const RecipeEntryHeader entry = {
+        .type = type,
+        .size = static_cast<u32>(writer.data.size()),
+        .checksum = XXH3_64bits(writer.data.data(), writer.data.size()),
+    };
+    file.Seek(0, SeekOrigin::End);
+    file.WriteObject(entry);
+    file.WriteSpan<u8>(writer.data);
+    file.Flush();
+}
+
+void PipelineDiskCache::StoreRecipe(const GraphicsPipelineRecipe& recipe) {
+    std::scoped_lock lk{recipe_mutex};
+    if (!enabled || !recipe_file.IsOpen() || !recorded_recipes.insert(RecipeHash(recipe)).second) {
+        return;
+    }
+    AppendRecipe(recipe_file, RecipeType::Graphics, [&](auto& writer) {
+        writer.Write(recipe.key);
+        writer.Write(recipe.spirv_keys);
+        writer.Write(recipe.fs_info);
+        writer.WriteList(recipe.vertex_attributes);
+        writer.WriteList(recipe.vertex_bindings);
+        writer.WriteList(recipe.vertex_divisors);
+        writer.WriteList(recipe.layout_bindings);
+    });
+}
+
+void PipelineDiskCache::StoreRecipe(const ComputePipelineRecipe& recipe) {
+    std::scoped_lock lk{recipe_mutex};
+    if (!enabled || !recipe_file.IsOpen() || !recorded_recipes.insert(RecipeHash(recipe)).second) {
+        return;
+    }
+    AppendRecipe(recipe_file, RecipeType::Compute, [&](auto& writer) {
+        writer.Write(recipe.spirv_key);
+        writer.WriteList(recipe.layout_bindings);
+        writer.Write(recipe.require_wave64);
+    });
+}
+
+std::vector<u8> PipelineDiskCache::LoadPipelineData() const {
+    if (!enabled) {
+        return {};
+    }
+    const auto path = cache_dir / PipelineDataName;
+    if (!std::filesystem::exists(path)) {
+        return {};
+    }
+    const IOFile file{path, FileAccessMode::Read};
+    Header file_header{};
+    if (!file.ReadObject(file_header) || file_header != header) {
+        LOG_INFO(Render_Vulkan, "Discarding incompatible pipeline cache {}", path.string());
+        return {};
+    }
+    std::vector<u8> data(file.GetSize() - sizeof(Header));
+    if (file.ReadSpan<u8>(data) != data.size()) {
+        return {};
+    }
+    LOG_INFO(Render_Vulkan, "Loaded {} KB of pipeline cache data", data.size() / 1024);
+    return data;
+}
+
+void PipelineDiskCache::SavePipelineData(vk::PipelineCache pipeline_cache) {
+    if (!enabled) {
+        return;
+    }
+    std::scoped_lock lk{pipeline_data_mutex};
+    const auto device = instance.GetDevice();
+    const auto [result, data] = device.getPipelineCacheData(pipeline_cache);
+    if (result != vk::Result::eSuccess || data.empty()) {
+        LOG_WARNING(Render_Vulkan, "Failed to retrieve pipeline cache data: {}",
+                    vk::to_string(result));
+        return;
+    }
+
+    // Write to a temporary file first so an interrupted save never leaves a torn cache behind.
+    const auto path = cache_dir / PipelineDataName;
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        const IOFile file{temp_path, FileAccessMode::Write};
+        if (!file.WriteObject(header) || file.WriteSpan<u8>(data) != data.size()) {
+            LOG_ERROR(Render_Vulkan, "Failed to write pipeline cache {}", temp_path.string());
+            return;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp_path, path, ec);
+    if (ec) {
+        LOG_ERROR(Render_Vulkan, "Failed to replace pipeline cache {}: {}", path.string(),
+                  ec.message());
+    }
+}
+
+std::optional<std::vector<u32>> PipelineDiskCache::FindSpirv(u64 key) const {
+    std::scoped_lock lk{spirv_mutex};
+    if (const auto it = spirv_entries.find(key); it != spirv_entries.end()) {
+        return it->second;
+    }
+    const auto it = shared_spirv_index.find(key);
+    if (it == shared_spirv_index.end()) {
+        return std::nullopt;
+    }
+    const auto& entry = it->second;
+    std::vector<u32> spv(entry.num_words);
+    if (!shared_spirv_file.Seek(entry.offset) ||
+        shared_spirv_file.ReadSpan<u32>(spv) != spv.size() || Checksum(spv) != entry.checksum) {
+        LOG_WARNING(Render_Vulkan, "Damaged shared SPIR-V module {:#x}", key);
+        return std::nullopt;
+    }
+    return spv;
+}
+
+void PipelineDiskCache::StoreSpirv(u64 key, std::span<const u32> spv) {
+    std::scoped_lock lk{spirv_mutex};
+    if (!enabled) {
+        return;
+    }
+    const SpirvEntryHeader entry = {
+        .key = key,
+        .num_words = static_cast<u32>(spv.size()),
+        .checksum = Checksum(spv),
+    };
+    if (shared_spirv_file.IsOpen()) {
+        if (spirv_entries.contains(key) || shared_spirv_index.contains(key)) {
+            return;
+        }
+        shared_spirv_file.Seek(0, SeekOrigin::End);
+        const u64 data_offset = shared_spirv_file.Tell() + sizeof(entry);
+        shared_spirv_file.WriteObject(entry);
+        shared_spirv_file.WriteSpan(spv);
+        shared_spirv_file.Flush();
+        shared_spirv_index.emplace(
+            key, SharedSpirvEntry{data_offset, entry.num_words, entry.checksum});
+        return;
+    }
+    if (!spirv_file.IsOpen()) {
+        return;
+    }
+    const auto [it, is_new] = spirv_entries.try_emplace(key, spv.begin(), spv.end());
+    if (!is_new) {
+        return;
+    }
+    spirv_file.Seek(0, SeekOrigin::End);
+    spirv_file.WriteObject(entry);
+    spirv_file.WriteSpan(spv);
+    spirv_file.Flush();
+}
+
+u64 PipelineDiskCache::ComputeSpirvKey(u64 pgm_hash, const Shader::StageSpecialization& spec) {
+    XXH3_state_t state;
+    XXH3_64bits_reset_withSeed(&state, pgm_hash);
+    const auto update = [&state](const auto& value) {
+        XXH3_64bits_update(&state, &value, sizeof(value));
+    };
+    const auto update_list = [&state](const auto& list) {
+        XXH3_64bits_update(&state, list.data(), list.size() * sizeof(*list.data()));
+    };
+
+    update(spec.info->l_stage);
+    // Runtime info is memset on initialization so hashing its bytes is stable.
+    update(spec.runtime_info);
+    update(spec.start);
+    update(spec.bitset);
+    if (spec.fetch_shader_data) {
+        update_list(spec.fetch_shader_data->attributes);
+        update(spec.fetch_shader_data->vertex_offset_sgpr);
+        update(spec.fetch_shader_data->instance_offset_sgpr);
+    }
+    update_list(spec.vs_attribs);
+    update_list(spec.buffers);
+    update_list(spec.images);
+    update_list(spec.fmasks);
+    update_list(spec.samplers);
+    return XXH3_64bits_digest(&state);
+}
+
+} // namespace Vulkan
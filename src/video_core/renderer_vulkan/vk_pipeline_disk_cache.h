@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+#include <tsl/robin_map.h>
+#include <tsl/robin_set.h>
+
+#include "common/io_file.h"
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace Shader {
+struct StageSpecialization;
+}
+
+namespace Vulkan {
+
+class Instance;
+struct ComputePipelineRecipe;
+struct GraphicsPipelineRecipe;
+
+/**
+ * Persists compiled shader and pipeline state between sessions of the same title.
+ * Three files are kept per title inside the user shader directory:
+ *  - spirv.bin: append-only pack of emitted SPIR-V modules keyed by program hash and
+ *    specialization, written as modules are compiled.
+ *  - pipelines.bin: serialized vk::PipelineCache blob, rewritten periodically.
+ *  - warmup.bin: append-only manifest of pipeline recipes used to prewarm the driver cache.
+ * SPIR-V is keyed by content, so modules of middleware shared between titles are stored once in
+ * a spirv.bin under cache/shared. New modules are appended there, the store of the title is
+ * still read for modules of earlier sessions.
+ * All files start with a header that ties them to the emulator build and the physical device,
+ * any mismatch discards the stored contents.
+ */
+class PipelineDiskCache {
+public:
+    explicit PipelineDiskCache(const Instance& instance);
+    ~PipelineDiskCache();
+
+    PipelineDiskCache(const PipelineDiskCache&) = delete;
+    PipelineDiskCache& operator=(const PipelineDiskCache&) = delete;
+
+    /// Returns true when the disk cache is enabled and has a valid storage location.
+    [[nodiscard]] bool IsEnabled() const noexcept {
+        return enabled;
+    }
+
+    /// Returns the pipeline cache blob from a previous session, empty if none is compatible.
+    [[nodiscard]] std::vector<u8> LoadPipelineData() const;
+
+    /// Serializes the provided pipeline cache to disk.
+    void SavePipelineData(vk::PipelineCache pipeline_cache);
+
+    /// Returns the stored SPIR-V for the provided key, if any.
+    [[nodiscard]] std::optional<std::vector<u32>> FindSpirv(u64 key) const;
+
+    /// Appends the SPIR-V of a freshly emitted module to the store.
+    void StoreSpirv(u64 key, std::span<const u32> spv);
+
+    /// Reads every pipeline recipe recorded by previous sessions.
+    void LoadRecipes(std::vector<GraphicsPipelineRecipe>& graphics,
+                     std::vector<ComputePipelineRecipe>& compute);
+
+    /// Appends a pipeline recipe to the warmup manifest, if not already recorded.
+    void StoreRecipe(const GraphicsPipelineRecipe& recipe);
+    void StoreRecipe(const ComputePipelineRecipe& recipe);
+
+    /// Computes a stable key for a shader permutation.
+    [[nodiscard]] static u64 ComputeSpirvKey(u64 pgm_hash,
+                                             const Shader::StageSpecialization& spec);
+
+    struct Header {
+        u32 magic;
+        u32 version;
+        u32 vendor_id;
+        u32 device_id;
+        u32 driver_version;
+        std::array<u8, VK_UUID_SIZE> pipeline_cache_uuid;
+        u32 reserved;
+        u64 build_hash;
+
+        bool operator==(const Header&) const = default;
+    };
+
+private:
+    /// Location of a module in the shared SPIR-V store.
+    struct SharedSpirvEntry {
+        u64 offset;
+        u32 num_words;
+        u32 checksum;
+    };
+
+    void OpenSpirvStore();
+    void OpenSharedSpirvStore();
+    void OpenRecipeStore();
+
+private:
+    const Instance& instance;
+    std::filesystem::path cache_dir;
+    Header header{};
+    std::mutex pipeline_data_mutex;
+    mutable std::mutex spirv_mutex;
+    Common::FS::IOFile spirv_file;
+    tsl::robin_map<u64, std::vector<u32>> spirv_entries;
+    Common::FS::IOFile shared_spirv_file;
+    tsl::robin_map<u64, SharedSpirvEntry> shared_spirv_index;
+    std::mutex recipe_mutex;
+    Common::FS::IOFile recipe_file;
+    tsl::robin_set<u64> recorded_recipes;
+    bool enabled{};
+};
+
+} // namespace Vulkan
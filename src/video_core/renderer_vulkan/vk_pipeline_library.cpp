@@ -0,0 +1,88 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include "common/assert.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_pipeline_library.h"
+
+namespace Vulkan {
+
+using Part = PipelineLibraryCache::Part;
+
+static vk::GraphicsPipelineLibraryFlagsEXT PartFlags(Part part) {
+    switch (part) {
+    case Part::VertexInput:
+        return vk::GraphicsPipelineLibraryFlagBitsEXT::eVertexInputInterface;
+    case Part::PreRasterization:
+        return vk::GraphicsPipelineLibraryFlagBitsEXT::ePreRasterizationShaders;
+    case Part::FragmentShader:
+        return vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentShader;
+    case Part::FragmentOutput:
+        return vk::GraphicsPipelineLibraryFlagBitsEXT::eFragmentOutputInterface;
+    default:
+        UNREACHABLE();
+    }
+}
+
+PipelineLibraryCache::PipelineLibraryCache(const Instance& instance_,
+                                           vk::PipelineCache pipeline_cache_)
+    : instance{instance_}, pipeline_cache{pipeline_cache_}, worker{1, "PipelineLinker"} {}
+
+PipelineLibraryCache::~PipelineLibraryCache() = default;
+
+vk::Pipeline PipelineLibraryCache::GetLibrary(Part part, u64 hash,
+                                              const vk::GraphicsPipelineCreateInfo& pipeline_info) {
+    auto& part_libraries = libraries[static_cast<u32>(part)];
+    {
+        std::scoped_lock lk{mutex};
+        if (const auto it = part_libraries.find(hash); it != part_libraries.end()) {
+            return *it->second;
+        }
+    }
+
+    // Compile outside of the lock, a concurrent miss on the same state only costs a duplicate.
+    const vk::GraphicsPipelineLibraryCreateInfoEXT library_info = {
+        .pNext = pipeline_info.pNext,
+        .flags = PartFlags(part),
+    };
+    auto library_ci = pipeline_info;
+    library_ci.pNext = &library_info;
+    library_ci.flags |= vk::PipelineCreateFlagBits::eLibraryKHR |
+                        vk::PipelineCreateFlagBits::eRetainLinkTimeOptimizationInfoEXT;
+    auto [result, library] =
+        instance.GetDevice().createGraphicsPipelineUnique(pipeline_cache, library_ci);
+    ASSERT_MSG(result == vk::Result::eSuccess, "Failed to create pipeline library: {}",
+               vk::to_string(result));
+
+    std::scoped_lock lk{mutex};
+    const auto [it, _] = part_libraries.try_emplace(hash, std::move(library));
+    return *it->second;
+}
+
+vk::UniquePipeline PipelineLibraryCache::Link(const Libraries& libraries, vk::PipelineLayout layout,
+                                              vk::PipelineCreateFlags flags, bool optimize) const {
+    const vk::PipelineLibraryCreateInfoKHR link_info = {
+        .libraryCount = static_cast<u32>(libraries.size()),
+        .pLibraries = libraries.data(),
+    };
+    const vk::GraphicsPipelineCreateInfo pipeline_info = {
+        .pNext = &link_info,
+        .flags = optimize ? flags | vk::PipelineCreateFlagBits::eLinkTimeOptimizationEXT : flags,
+        .layout = layout,
+    };
+    auto [result, pipeline] =
+        instance.GetDevice().createGraphicsPipelineUnique(pipeline_cache, pipeline_info);
+    ASSERT_MSG(result == vk::Result::eSuccess, "Failed to link graphics pipeline: {}",
+               vk::to_string(result));
+    return std::move(pipeline);
+}
+
+void PipelineLibraryCache::Clear() {
+    worker.WaitForRequests();
+    std::scoped_lock lk{mutex};
+    for (auto& part_libraries : libraries) {
+        part_libraries.clear();
+    }
+}
+
+} // namespace Vulkan
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+#include <mutex>
+#include <tsl/robin_map.h>
+
+#include "common/thread_worker.h"
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace Vulkan {
+
+class Instance;
+
+/**
+ * Cache of VK_EXT_graphics_pipeline_library parts shared between graphics pipelines.
+ * Each part is keyed by a hash of the state it consumes, so pipelines that only differ in one
+ * piece of state reuse the already compiled libraries and only pay for a fast link. The link
+ * time optimized variant of every pipeline is built afterwards on a background worker.
+ */
+class PipelineLibraryCache {
+public:
+    enum class Part : u32 {
+        VertexInput,
+        PreRasterization,
+        FragmentShader,
+        FragmentOutput,
+        Count,
+    };
+    static constexpr size_t NumParts = static_cast<size_t>(Part::Count);
+
+    using Libraries = std::array<vk::Pipeline, NumParts>;
+
+    explicit PipelineLibraryCache(const Instance& instance, vk::PipelineCache pipeline_cache);
+    ~PipelineLibraryCache();
+
+    PipelineLibraryCache(const PipelineLibraryCache&) = delete;
+    PipelineLibraryCache& operator=(const PipelineLibraryCache&) = delete;
+
+    /// Returns the library for the provided part and state hash, compiling it from the state
+    /// in pipeline_info if it does not exist yet.
+    vk::Pipeline GetLibrary(Part part, u64 hash,
+                            const vk::GraphicsPipelineCreateInfo& pipeline_info);
+
+    /// Links the provided libraries into a complete pipeline, flags must match the flags the
+    /// libraries were created with.
+    vk::UniquePipeline Link(const Libraries& libraries, vk::PipelineLayout layout,
+                            vk::PipelineCreateFlags flags, bool optimize) const;
+
+    /// Queues a task on the background link worker.
+    template <typename Func>
+    void QueueOptimize(Func&& func) {
+        worker.QueueWork(std::forward<Func>(func));
+    }
+
+    /// Waits for every queued optimization task and drops all cached libraries.
+    void Clear();
+
+private:
+    const Instance& instance;
+    vk::PipelineCache pipeline_cache;
+    std::mutex mutex;
+    std::array<tsl::robin_map<u64, vk::UniquePipeline>, NumParts> libraries;
+    Common::ThreadWorker worker;
+};
+
+} // namespace Vulkan
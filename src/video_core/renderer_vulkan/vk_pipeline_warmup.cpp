@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <thread>
+#include <imgui.h>
+
+#include "common/logging/log.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_pipeline_disk_cache.h"
+#include "video_core/renderer_vulkan/vk_pipeline_warmup.h"
+#include "video_core/renderer_vulkan/vk_shader_util.h"
+
+namespace Vulkan {
+
+static size_t NumWarmupThreads() {
+    // Leave some room for the emulator threads that are booting the title at the same time.
+    return std::max(1U, std::thread::hardware_concurrency() / 2);
+}
+
+PipelineWarmup::PipelineWarmup(const Instance& instance_, Scheduler& scheduler_,
+                               DescriptorHeap& desc_heap_,
+                               const VideoCore::TextureHeap* texture_heap_,
+                               const Shader::Profile& profile_, vk::PipelineCache pipeline_cache_,
+                               PipelineDiskCache& disk_cache_)
+    : instance{instance_}, scheduler{scheduler_}, desc_heap{desc_heap_},
+      texture_heap{texture_heap_}, profile{profile_}, pipeline_cache{pipeline_cache_},
+      disk_cache{disk_cache_}, worker{NumWarmupThreads(), "PipelineWarmup"} {
+    disk_cache.LoadRecipes(graphics_recipes, compute_recipes);
+    num_total = static_cast<u32>(graphics_recipes.size() + compute_recipes.size());
+    if (num_total == 0) {
+        return;
+    }
+
+    LOG_INFO(Render_Vulkan, "Warming up {} pipelines on {} threads", num_total,
+             worker.NumWorkers());
+    for (const auto& recipe : graphics_recipes) {
+        worker.QueueWork([this, &recipe] { WarmGraphics(recipe); });
+    }
+    for (const auto& recipe : compute_recipes) {
+        worker.QueueWork([this, &recipe] { WarmCompute(recipe); });
+    }
+    ImGui::Layer::AddLayer(this);
+    is_layer_added = true;
+}
+
+PipelineWarmup::~PipelineWarmup() {
+    if (is_layer_added) {
+        ImGui::Layer::RemoveLayer(this);
+    }
+}
+
+void PipelineWarmup::WarmGraphics(const GraphicsPipelineRecipe& recipe) {
+    const auto device = instance.GetDevice();
+    GraphicsPipeline::StageModules modules{};
+    bool has_all_stages = true;
+    for (u32 stage = 0; stage < MaxShaderStages; ++stage) {
+        if (recipe.spirv_keys[stage] == 0) {
+            continue;
+        }
+        const auto spv = disk_cache.FindSpirv(recipe.spirv_keys[stage]);
+        if (!spv) {
+            has_all_stages = false;
+            break;
+        }
+        modules[stage] = CompileSPV(*spv, device);
+    }
+    if (has_all_stages) {
+        // Only the side effect on the driver pipeline cache is wanted.
+        GraphicsPipeline pipeline{instance, scheduler,      desc_heap, texture_heap,
+                                  profile,  pipeline_cache, recipe,    modules};
+    } else {
+        ++num_failed;
+    }
+    for (const auto module : modules) {
+        if (module) {
+            device.destroyShaderModule(module);
+        }
+    }
+    num_done.fetch_add(1, std::memory_order_release);
+}
+
+void PipelineWarmup::WarmCompute(const ComputePipelineRecipe& recipe) {
+    const auto device = instance.GetDevice();
+    if (const auto spv = disk_cache.FindSpirv(recipe.spirv_key)) {
+        const auto module = CompileSPV(*spv, device);
+        {
+            ComputePipeline pipeline{instance, scheduler,      desc_heap, texture_heap,
+                                     profile,  pipeline_cache, recipe,    module};
+        }
+        device.destroyShaderModule(module);
+    } else {
+        ++num_failed;
+    }
+    num_done.fetch_add(1, std::memory_order_release);
+}
+
+void PipelineWarmup::Draw() {
+    using namespace ImGui;
+    if (!is_layer_added) {
+        return;
+    }
+    const u32 done = num_done.load(std::memory_order_acquire);
+    if (done == num_total) {
+        LOG_INFO(Render_Vulkan, "Pipeline warmup finished, {} recipes could not be replayed",
+                 num_failed.load());
+        RemoveLayer(this);
+        is_layer_added = false;
+        return;
+    }
+
+    const auto& io = GetIO();
+    SetNextWindowPos(ImVec2{10.0f, io.DisplaySize.y - 10.0f}, ImGuiCond_Always, ImVec2{0.0f, 1.0f});
+    SetNextWindowBgAlpha(0.6f);
+    if (Begin("Pipeline Warmup##PipelineWarmup", nullptr,
+              ImGuiWindowFlags_NoDecoration | ImGuiWindowFlags_NoSavedSettings |
+                  ImGuiWindowFlags_NoInputs | ImGuiWindowFlags_NoNav |
+                  ImGuiWindowFlags_NoFocusOnAppearing | ImGuiWindowFlags_AlwaysAutoResize)) {
+        Text("Warming up pipelines %u/%u", done, num_total);
+        ProgressBar(float(done) / float(num_total), ImVec2{200.0f, 0.0f});
+    }
+    End();
+}
+
+} // namespace Vulkan
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/thread_worker.h"
+#include "common/types.h"
+#include "imgui/imgui_layer.h"
+#include "video_core/renderer_vulkan/vk_compute_pipeline.h"
+#include "video_core/renderer_vulkan/vk_graphics_pipeline.h"
+
+namespace Shader {
+struct Profile;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+class DescriptorHeap;
+class PipelineDiskCache;
+
+/**
+ * Replays the pipeline recipes recorded by previous sessions so the driver pipeline cache is hot
+ * before the title requests them. Pipelines are built from the stored SPIR-V on background
+ * threads and thrown away, progress is shown in a small overlay until every recipe is processed.
+ */
+class PipelineWarmup final : public ImGui::Layer {
+public:
+    explicit PipelineWarmup(const Instance& instance, Scheduler& scheduler,
+                            DescriptorHeap& desc_heap, const VideoCore::TextureHeap* texture_heap,
+                            const Shader::Profile& profile, vk::PipelineCache pipeline_cache,
+                            PipelineDiskCache& disk_cache);
+    ~PipelineWarmup() override;
+
+    PipelineWarmup(const PipelineWarmup&) = delete;
+    PipelineWarmup& operator=(const PipelineWarmup&) = delete;
+
+    /// Returns true when every recorded recipe has been processed.
+    [[nodiscard]] bool IsDone() const noexcept {
+        return num_done.load(std::memory_order_acquire) == num_total;
+    }
+
+    void Draw() override;
+
+private:
+    void WarmGraphics(const GraphicsPipelineRecipe& recipe);
+    void WarmCompute(const ComputePipelineRecipe& recipe);
+
+private:
+    const Instance& instance;
+    Scheduler& scheduler;
+    DescriptorHeap& desc_heap;
+    const VideoCore::TextureHeap* texture_heap;
+    const Shader::Profile& profile;
+    vk::PipelineCache pipeline_cache;
+    PipelineDiskCache& disk_cache;
+    std::vector<GraphicsPipelineRecipe> graphics_recipes;
+    std::vector<ComputePipelineRecipe> compute_recipes;
+    std::atomic<u32> num_done{};
+    std::atomic<u32> num_failed{};
+    u32 num_total{};
+    bool is_layer_added{};
+    Common::ThreadWorker worker;
+};
+
+} // namespace Vulkan
@@ -317,6 +317,12 @@ vk::UniqueInstance CreateInstance(Frontend::WindowSystemType window_type, bool e
     vk::Bool32 enable_force_barriers = vk::True;
 #ifdef __APPLE__
     const vk::Bool32 mvk_debug_mode = enable_crash_diagnostic ? vk::True : vk::False;
+    // Queue submissions are encoded on MoltenVK's own dispatch queue instead of blocking the
+    // submitting thread, completion is still tracked through our timeline semaphore.
+    const vk::Bool32 mvk_synchronous_submits = vk::False;
+    // Descriptor sets are backed by Metal argument buffers, binding them does not re-encode
+    // every resource.
+    const s32 mvk_use_argument_buffers = 1;
 #endif
 
     const std::array layer_setings = {
@@ -414,6 +420,20 @@ vk::UniqueInstance CreateInstance(Frontend::WindowSystemType window_type, bool e
             .valueCount = 1,
             .pValues = &mvk_debug_mode,
         },
+        vk::LayerSettingEXT{
+            .pLayerName = "MoltenVK",
+            .pSettingName = "MVK_CONFIG_SYNCHRONOUS_QUEUE_SUBMITS",
+            .type = vk::LayerSettingTypeEXT::eBool32,
+            .valueCount = 1,
+            .pValues = &mvk_synchronous_submits,
+        },
+        vk::LayerSettingEXT{
+            .pLayerName = "MoltenVK",
+            .pSettingName = "MVK_CONFIG_USE_METAL_ARGUMENT_BUFFERS",
+            .type = vk::LayerSettingTypeEXT::eInt32,
+            .valueCount = 1,
+            .pValues = &mvk_use_argument_buffers,
+        },
 #endif
     };
 
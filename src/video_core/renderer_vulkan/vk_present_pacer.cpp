@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+
+#include "common/config.h"
+#include "common/logging/log.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_present_pacer.h"
+#include "video_core/renderer_vulkan/vk_swapchain.h"
+
+namespace Vulkan {
+
+using namespace std::chrono_literals;
+
+/// Weight of the latest frame in the smoothed frame time and jitter.
+constexpr double SmoothingFactor = 0.1;
+/// Presents further apart are treated as pauses and not measured.
+constexpr auto MaxFrameTime = 250ms;
+/// A frame counts as missed when it takes this much longer than predicted.
+constexpr double MissedFrameRatio = 1.5;
+/// Number of frames measured before the present mode is reconsidered.
+constexpr u32 ModeWindowFrames = 240;
+/// Number of consecutive windows that must agree before the present mode is switched.
+constexpr u32 ModeSwitchWindows = 2;
+/// Fraction of missed frames above which late frames are presented without waiting for vblank.
+constexpr double RelaxedMissRatio = 0.05;
+
+PresentPacer::PresentPacer(const Instance& instance, Swapchain& swapchain_)
+    : swapchain{swapchain_}, pending_mode{swapchain.GetPresentMode()},
+      low_latency{Config::isLowLatencyModeEnabled()},
+      auto_present_mode{Config::GetSnapshot().present_mode == Config::PresentMode::Auto} {
+    if (low_latency && !instance.IsPresentWaitSupported()) {
+        LOG_WARNING(Render_Vulkan, "Low latency mode requires VK_KHR_present_wait");
+        low_latency = false;
+    }
+    LOG_INFO(Render_Vulkan, "Present pacing: low latency {}, automatic present mode {}",
+             low_latency, auto_present_mode);
+}
+
+PresentPacer::~PresentPacer() = default;
+
+void PresentPacer::OnPresent() {
+    const auto now = Clock::now();
+    const auto frame_time = now - last_present;
+    if (last_present != Clock::time_point{} && frame_time < MaxFrameTime) {
+        const double sample_ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(frame_time).count());
+        if (num_samples++ == 0) {
+            frame_time_ns = sample_ns;
+        }
+        const bool is_missed = sample_ns > frame_time_ns * MissedFrameRatio;
+        frame_time_ns += (sample_ns - frame_time_ns) * SmoothingFactor;
+        jitter_ns += (std::abs(sample_ns - frame_time_ns) - jitter_ns) * SmoothingFactor;
+        if (auto_present_mode) {
+            ++window_frames;
+            window_missed += is_missed ? 1 : 0;
+        }
+    }
+    last_present = now;
+
+    if (low_latency) {
+        WaitForPreviousPresent();
+    }
+    if (auto_present_mode && window_frames >= ModeWindowFrames) {
+        UpdatePresentMode();
+    }
+}
+
+void PresentPacer::WaitForPreviousPresent() {
+    const u64 present_id = swapchain.GetPresentId();
+    if (present_id <= 1) {
+        return;
+    }
+    // Never wait longer than two predicted frames so a stuck present does not stall the guest.
+    const auto timeout =
+        num_samples > 0 ? std::clamp(GetPredictedFrameTime() * 2, std::chrono::nanoseconds{1ms},
+                                     std::chrono::nanoseconds{MaxFrameTime})
+                        : std::chrono::nanoseconds{MaxFrameTime};
+    if (!swapchain.WaitForPresent(present_id - 1, timeout.count())) {
+        LOG_WARNING(Render_Vulkan, "Presents can not be waited on, disabling low latency mode");
+        low_latency = false;
+    }
+}
+
+void PresentPacer::UpdatePresentMode() {
+    const double miss_ratio = static_cast<double>(window_missed) / window_frames;
+    window_frames = 0;
+    window_missed = 0;
+
+    // Uneven frame times stall a whole refresh interval on every late frame, presenting late
+    // frames immediately trades a tear for the stall. Even frame times keep vsync and prefer
+    // the lower latency of mailbox.
+    const auto pick = [this](std::initializer_list<vk::PresentModeKHR> modes) {
+        for (const auto mode : modes) {
+            if (swapchain.IsPresentModeSupported(mode)) {
+                return mode;
+            }
+        }
+        return vk::PresentModeKHR::eFifo;
+    };
+    const auto mode = miss_ratio > RelaxedMissRatio
+                          ? pick({vk::PresentModeKHR::eFifoRelaxed, vk::PresentModeKHR::eFifo})
+                          : pick({vk::PresentModeKHR::eMailbox, vk::PresentModeKHR::eFifo});
+    if (mode == swapchain.GetPresentMode()) {
+        pending_windows = 0;
+        return;
+    }
+    if (mode != pending_mode) {
+        pending_mode = mode;
+        pending_windows = 0;
+    }
+    if (++pending_windows < ModeSwitchWindows) {
+        return;
+    }
+    LOG_INFO(Render_Vulkan, "Frame time {:.2f} ms, jitter {:.2f} ms, {:.1f}% frames missed",
+             frame_time_ns / 1e6, jitter_ns / 1e6, miss_ratio * 100.0);
+    pending_windows = 0;
+    swapchain.SetPresentMode(mode);
+}
+
+} // namespace Vulkan
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <chrono>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace Vulkan {
+
+class Instance;
+class Swapchain;
+
+/**
+ * Paces presentation from measured frame times. The time between presents is smoothed into a
+ * predicted frame time and a jitter estimate. In low latency mode every present waits until the
+ * previous one is displayed, so at most one frame is queued and the guest starts the next frame
+ * as late as possible. With the Auto present mode the swapchain switches between Mailbox, Fifo
+ * and FifoRelaxed depending on how even the measured frame times are.
+ */
+class PresentPacer {
+public:
+    explicit PresentPacer(const Instance& instance, Swapchain& swapchain);
+    ~PresentPacer();
+
+    /// Accounts a present to the swapchain and applies the pacing policy.
+    void OnPresent();
+
+    /// Returns the smoothed time between presents.
+    [[nodiscard]] std::chrono::nanoseconds GetPredictedFrameTime() const {
+        return std::chrono::nanoseconds{static_cast<s64>(frame_time_ns)};
+    }
+
+    /// Returns the smoothed deviation of the frame time from its prediction.
+    [[nodiscard]] std::chrono::nanoseconds GetFrameTimeJitter() const {
+        return std::chrono::nanoseconds{static_cast<s64>(jitter_ns)};
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    /// Waits for the previous present to be displayed.
+    void WaitForPreviousPresent();
+
+    /// Picks the present mode matching the measured frame times.
+    void UpdatePresentMode();
+
+    Swapchain& swapchain;
+    Clock::time_point last_present{};
+    double frame_time_ns{};
+    double jitter_ns{};
+    u32 num_samples{};
+    u32 window_frames{};
+    u32 window_missed{};
+    vk::PresentModeKHR pending_mode{};
+    u32 pending_windows{};
+    bool low_latency{};
+    bool auto_present_mode{};
+};
+
+} // namespace Vulkan
@@ -1,15 +1,19 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <chrono>
+
 #include "common/config.h"
 #include "common/debug.h"
 #include "common/elf_info.h"
 #include "common/singleton.h"
+#include "core/benchmark.h"
 #include "core/debug_state.h"
 #include "core/devtools/layer.h"
 #include "core/libraries/system/systemservice.h"
 #include "imgui/renderer/imgui_core.h"
 #include "imgui/renderer/imgui_impl_vulkan.h"
+#include "input/input_recording.h"
 #include "sdl_window.h"
 #include "video_core/renderer_vulkan/vk_platform.h"
 #include "video_core/renderer_vulkan/vk_presenter.h"
@@ -107,7 +111,7 @@ Presenter::Presenter(Frontend::WindowSDL& window_, AmdGpu::Liverpool* liverpool_
       instance{window, Config::getGpuId(), Config::vkValidationEnabled(),
                Config::getVkCrashDiagnosticEnabled()},
       draw_scheduler{instance}, present_scheduler{instance}, flip_scheduler{instance},
-      swapchain{instance, window},
+      swapchain{instance, window}, present_pacer{instance, swapchain},
       rasterizer{std::make_unique<Rasterizer>(instance, draw_scheduler, liverpool)},
       texture_cache{rasterizer->GetTextureCache()} {
     const u32 num_images = swapchain.GetImageCount();
@@ -123,13 +127,19 @@ Presenter::Presenter(Frontend::WindowSDL& window_, AmdGpu::Liverpool* liverpool_
         frame.present_done = fence;
         free_queue.push(&frame);
     }
+    interpolated_frame.id = static_cast<u8>(num_images);
+    interpolated_frame.present_done = Check<"create present done fence">(
+        device.createFence({.flags = vk::FenceCreateFlagBits::eSignaled}));
 
     fsr_settings.enable = Config::getFsrEnabled();
     fsr_settings.use_rcas = Config::getRcasEnabled();
     fsr_settings.rcas_attenuation = static_cast<float>(Config::getRcasAttenuation() / 1000.f);
 
+    fi_settings.enable = Config::getFrameInterpolationEnabled();
+
     fsr_pass.Create(device, instance.GetAllocator(), num_images);
     pp_pass.Create(device, swapchain.GetSurfaceFormat().format);
+    fi_pass.Create(device, instance.GetAllocator(), swapchain.GetSurfaceFormat().format);
 
     ImGui::Layer::AddLayer(Common::Singleton<Core::Devtools::Layer>::Instance());
 }
@@ -143,6 +153,12 @@ Presenter::~Presenter() {
         device.destroyImageView(frame.image_view);
         device.destroyFence(frame.present_done);
     }
+    if (interpolated_frame.image) {
+        vmaDestroyImage(instance.GetAllocator(), interpolated_frame.image,
+                        interpolated_frame.allocation);
+        device.destroyImageView(interpolated_frame.image_view);
+    }
+    device.destroyFence(interpolated_frame.present_done);
     ImGui::Core::Shutdown(device);
 }
 
@@ -273,6 +289,50 @@ Frame* Presenter::PrepareLastFrame() {
     return frame;
 }
 
+Frame* Presenter::PrepareInterpolatedFrame(const Frame* next) {
+    if (!fi_settings.enable) {
+        fi_pass.Reset();
+        return nullptr;
+    }
+
+    Frame* frame = &interpolated_frame;
+    while (true) {
+        vk::Result result = instance.GetDevice().waitForFences(frame->present_done, false,
+                                                               std::numeric_limits<u64>::max());
+        if (result == vk::Result::eSuccess) {
+            break;
+        }
+        if (result == vk::Result::eTimeout) {
+            continue;
+        }
+        ASSERT_MSG(result != vk::Result::eErrorDeviceLost,
+                   "Device lost during waiting for a frame");
+    }
+
+    auto& scheduler = present_scheduler;
+    const vk::Extent2D size{next->width, next->height};
+    if (fi_pass.GetSize() != size) {
+        // The stored frames may still be read by the last interpolation.
+        scheduler.Wait(frame->ready_tick);
+    }
+    if (frame->width != next->width || frame->height != next->height ||
+        frame->is_hdr != swapchain.GetHDR()) {
+        RecreateFrame(frame, next->width, next->height);
+    }
+
+    scheduler.EndRendering();
+    const auto cmdbuf = scheduler.CommandBuffer();
+    const bool has_frame = fi_pass.Render(cmdbuf, *next, *frame, 0.5f);
+
+    // Flush frame creation commands.
+    frame->ready_semaphore = scheduler.GetMasterSemaphore()->Handle();
+    frame->ready_tick = scheduler.CurrentTick();
+    SubmitInfo info{};
+    info.AddWait(next->ready_semaphore, next->ready_tick);
+    scheduler.Flush(info);
+    return has_frame ? frame : nullptr;
+}
+
 static vk::Format GetFrameViewFormat(const Libraries::VideoOut::PixelFormat format) {
     switch (format) {
     case Libraries::VideoOut::PixelFormat::A8B8G8R8Srgb:
@@ -348,6 +408,23 @@ Frame* Presenter::PrepareFrame(const Libraries::VideoOut::BufferAttributeGroup&
     frame->ready_tick = draw_scheduler.CurrentTick();
     SubmitInfo info{};
     draw_scheduler.Flush(info);
+
+    // Bound how far the guest runs ahead of the GPU by waiting on the oldest queued frame only,
+    // the frames after it keep the GPU busy meanwhile.
+    frames_in_flight.push(frame->ready_tick);
+    while (frames_in_flight.size() > Config::GetSnapshot().frames_in_flight) {
+        const u64 tick = frames_in_flight.front();
+        frames_in_flight.pop();
+        if (draw_scheduler.IsFree(tick)) {
+            continue;
+        }
+        const auto start = std::chrono::steady_clock::now();
+        draw_scheduler.Wait(tick);
+        const auto elapsed = std::chrono::steady_clock::now() - start;
+        DebugState.AddStall(
+            DebugStateType::StallCause::FrameWait,
+            std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count());
+    }
     return frame;
 }
 
@@ -465,7 +542,7 @@ void Presenter::Present(Frame* frame, bool is_reusing_frame) {
     auto& scheduler = present_scheduler;
     const auto cmdbuf = scheduler.CommandBuffer();
 
-    if (Config::getVkHostMarkersEnabled()) {
+    if (Config::GetSnapshot().vk_host_markers) {
         cmdbuf.beginDebugUtilsLabelEXT(vk::DebugUtilsLabelEXT{
             .pLabelName = "Present",
         });
@@ -593,7 +670,7 @@ void Presenter::Present(Frame* frame, bool is_reusing_frame) {
         }
     }
 
-    if (Config::getVkHostMarkersEnabled()) {
+    if (Config::GetSnapshot().vk_host_markers) {
         cmdbuf.endDebugUtilsLabelEXT();
     }
 
@@ -606,17 +683,64 @@ void Presenter::Present(Frame* frame, bool is_reusing_frame) {
     scheduler.Flush(info);
 
     // Present to swapchain.
-    std::scoped_lock submit_lock{Scheduler::submit_mutex};
-    if (!swapchain.Present()) {
-        swapchain.Recreate(window.GetWidth(), window.GetHeight());
+    {
+        std::scoped_lock submit_lock{Scheduler::submit_mutex};
+        if (!swapchain.Present()) {
+            swapchain.Recreate(window.GetWidth(), window.GetHeight());
+        }
     }
+    present_pacer.OnPresent();
 
     free_frame();
     if (!is_reusing_frame) {
         DebugState.IncFlipFrameNum();
+        DebugState.AnalyzeFlip();
+        PublishMemoryStats();
+        Input::Recording::OnFlip(DebugState.GetFrameNum());
+        Core::Benchmark::OnFlip();
     }
 }
 
+void Presenter::PublishMemoryStats() {
+    const VmaAllocator allocator = instance.GetAllocator();
+    const VkPhysicalDeviceMemoryProperties* memory_props{};
+    vmaGetMemoryProperties(allocator, &memory_props);
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    std::vector<DebugStateType::GpuHeap> heaps(memory_props->memoryHeapCount);
+    for (u32 i = 0; i < memory_props->memoryHeapCount; i++) {
+        const auto& budget = budgets[i];
+        auto& heap = heaps[i];
+        heap.size = memory_props->memoryHeaps[i].size;
+        heap.budget = budget.budget;
+        heap.usage = budget.usage;
+        heap.block_bytes = budget.statistics.blockBytes;
+        heap.allocation_bytes = budget.statistics.allocationBytes;
+        heap.num_allocations = budget.statistics.allocationCount;
+        heap.device_local = (memory_props->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT);
+    }
+
+#ifdef TRACY_ENABLE
+    s64 device_local_usage = 0;
+    for (const auto& heap : heaps) {
+        device_local_usage += heap.device_local ? static_cast<s64>(heap.usage) : 0;
+    }
+    TracyPlot("Device local usage", device_local_usage);
+    using DebugStateType::RendererCounter;
+    const auto& counters = DebugState.renderer_counters;
+    const auto plot = [&](const char* name, RendererCounter counter) {
+        TracyPlot(name, static_cast<s64>(counters.LastFrame(counter)));
+    };
+    plot("Stream bytes", RendererCounter::StreamBytes);
+    plot("Staging bytes", RendererCounter::StagingBytes);
+    plot("Readback bytes", RendererCounter::ReadbackBytes);
+    plot("Image upload bytes", RendererCounter::ImageUploadBytes);
+    plot("Buffer upload bytes", RendererCounter::BufferUploadBytes);
+#endif
+    DebugState.SetGpuHeaps(std::move(heaps));
+}
+
 Frame* Presenter::GetRenderFrame() {
     // Wait for free presentation frames
     Frame* frame;
@@ -7,9 +7,11 @@
 
 #include "core/libraries/videoout/buffer.h"
 #include "imgui/imgui_texture.h"
+#include "video_core/renderer_vulkan/host_passes/fi_pass.h"
 #include "video_core/renderer_vulkan/host_passes/fsr_pass.h"
 #include "video_core/renderer_vulkan/host_passes/pp_pass.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_present_pacer.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/renderer_vulkan/vk_swapchain.h"
 #include "video_core/texture_cache/texture_cache.h"
@@ -60,6 +62,10 @@ public:
         return fsr_settings;
     }
 
+    HostPasses::FrameInterpolationPass::Settings& GetFiSettingsRef() {
+        return fi_settings;
+    }
+
     Frontend::WindowSDL& GetWindow() const {
         return window;
     }
@@ -100,6 +106,16 @@ public:
     void Present(Frame* frame, bool is_reusing_frame = false);
     Frame* PrepareLastFrame();
 
+    /// Renders the frame halfway between the previously presented frame and the given one, to be
+    /// presented ahead of it. Returns null when interpolation is disabled or has no previous
+    /// frame yet.
+    Frame* PrepareInterpolatedFrame(const Frame* next);
+
+    /// Drops the frames kept for interpolation, used when frames are not presented in sequence.
+    void ResetFrameInterpolation() {
+        fi_pass.Reset();
+    }
+
 private:
     Frame* GetRenderFrame();
 
@@ -107,6 +123,9 @@ private:
 
     void SetExpectedGameSize(s32 width, s32 height);
 
+    /// Publishes the heap statistics of the allocator and plots the transfer counters to Tracy.
+    void PublishMemoryStats();
+
 private:
     float expected_ratio{1920.0 / 1080.0f};
     u32 expected_frame_width{1920};
@@ -116,6 +135,8 @@ private:
     HostPasses::FsrPass::Settings fsr_settings{};
     HostPasses::PostProcessingPass::Settings pp_settings{};
     HostPasses::PostProcessingPass pp_pass;
+    HostPasses::FrameInterpolationPass fi_pass;
+    HostPasses::FrameInterpolationPass::Settings fi_settings{};
     Frontend::WindowSDL& window;
     AmdGpu::Liverpool* liverpool;
     Instance instance;
@@ -123,11 +144,14 @@ private:
     Scheduler present_scheduler;
     Scheduler flip_scheduler;
     Swapchain swapchain;
+    PresentPacer present_pacer;
     std::unique_ptr<Rasterizer> rasterizer;
     VideoCore::TextureCache& texture_cache;
     vk::UniqueCommandPool command_pool;
     std::vector<Frame> present_frames;
+    Frame interpolated_frame{};
     std::queue<Frame*> free_queue;
+    std::queue<u64> frames_in_flight;
     Frame* last_submit_frame;
     std::mutex free_mutex;
     std::condition_variable free_cv;
@@ -7,6 +7,7 @@
 #include "shader_recompiler/runtime_info.h"
 #include "video_core/amdgpu/liverpool.h"
 #include "video_core/renderer_vulkan/liverpool_to_vk.h"
+#include "video_core/renderer_vulkan/vk_draw_batcher.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
@@ -37,7 +38,21 @@ Rasterizer::Rasterizer(const Instance& instance_, Scheduler& scheduler_,
       buffer_cache{instance, scheduler, liverpool_, texture_cache, page_manager},
       texture_cache{instance, scheduler, liverpool_, buffer_cache, page_manager},
       liverpool{liverpool_}, memory{Core::Memory::Instance()},
-      pipeline_cache{instance, scheduler, liverpool} {
+      shader_profiler{Config::isShaderProfilingEnabled()
+                          ? std::make_unique<ShaderProfiler>(instance, scheduler)
+                          : nullptr},
+      pipeline_cache{instance, scheduler, liverpool, shader_profiler.get(),
+                     texture_cache.GetTextureHeap()} {
+    if (Config::isGpuProfilingEnabled()) {
+        gpu_profiler = scheduler.EnableGpuProfiler();
+    }
+    if (Config::isDrawBatchingEnabled() && !shader_profiler) {
+        // Batched draws can not be timed individually.
+        draw_batcher = scheduler.EnableDrawBatching();
+    }
+    if (Config::isAsyncComputeEnabled()) {
+        scheduler.EnableAsyncCompute();
+    }
     if (!Config::nullGpu()) {
         liverpool->BindRasterizer(this);
     }
@@ -94,6 +109,16 @@ bool Rasterizer::FilterDraw() {
         regs.depth_render_override.force_stencil_valid && regs.depth_buffer.StencilValid() &&
         regs.depth_buffer.StencilWriteValid() &&
         regs.depth_buffer.StencilAddress() != regs.depth_buffer.StencilWriteAddress();
+    const auto& db_render = regs.depth_render_control;
+    const bool depth_decompress =
+        (db_render.depth_compress_disable && db_render.stencil_compress_disable) ||
+        db_render.decompress_enable || db_render.resummarize_enable;
+    if (cb_disabled && depth_decompress && !db_render.depth_clear_enable &&
+        !db_render.stencil_clear_enable && !depth_copy && !stencil_copy) {
+        // Host depth surfaces are never compressed, the pass only has to apply a pending clear.
+        DecompressDepth();
+        return false;
+    }
     if (cb_disabled && (depth_copy || stencil_copy)) {
         // Games may disable color buffer and enable force depth/stencil dirty and valid to
         // do a copy from one depth-stencil surface to another, without a pixel shader.
@@ -185,10 +210,39 @@ void Rasterizer::EliminateFastClear() {
     ScopeMarkerEnd();
 }
 
+void Rasterizer::DecompressDepth() {
+    const auto& regs = liverpool->regs;
+    const auto htile_address = regs.depth_htile_data_base.GetAddress();
+    if (!regs.depth_buffer.DepthValid() ||
+        !texture_cache.IsMetaCleared(htile_address, regs.depth_view.slice_start)) {
+        LOG_TRACE(Render_Vulkan, "Depth decompression pass skipped");
+        ScopedMarkerInsert("DepthDecompress");
+        return;
+    }
+    VideoCore::TextureCache::ImageDesc desc(regs.depth_buffer, regs.depth_view,
+                                            regs.depth_control, htile_address,
+                                            liverpool->last_db_extent);
+    const auto image_id = texture_cache.FindImage(desc);
+    texture_cache.UpdateImage(image_id);
+    for (u32 slice = regs.depth_view.slice_start; slice <= regs.depth_view.slice_max; ++slice) {
+        texture_cache.TouchMeta(htile_address, slice, false);
+    }
+    auto& image = texture_cache.GetImage(image_id);
+    const vk::ClearValue clear_value = {
+        .depthStencil = {.depth = regs.depth_clear, .stencil = regs.stencil_clear},
+    };
+
+    ScopeMarkerBegin(fmt::format("DepthDecompress:DB={:#x}:H={:#x}",
+                                 regs.depth_buffer.DepthAddress(), htile_address));
+    image.Clear(clear_value, desc.view_info.range);
+    ScopeMarkerEnd();
+}
+
 void Rasterizer::Draw(bool is_indexed, u32 index_offset) {
     RENDERER_TRACE;
 
     scheduler.PopPendingOperations();
+    buffer_cache.FlushInlineWrites();
 
     if (!FilterDraw()) {
         return;
@@ -206,6 +260,12 @@ void Rasterizer::Draw(bool is_indexed, u32 index_offset) {
     }
     const auto state = BeginRendering(pipeline);
 
+    if (draw_batcher) {
+        DrawBatched(pipeline, state, is_indexed, index_offset);
+        ResetBindings();
+        return;
+    }
+
     buffer_cache.BindVertexBuffers(*pipeline);
     if (is_indexed) {
         buffer_cache.BindIndexBuffer(index_offset);
@@ -220,7 +280,8 @@ void Rasterizer::Draw(bool is_indexed, u32 index_offset) {
     const auto [vertex_offset, instance_offset] = GetDrawOffsets(regs, vs_info, fetch_shader);
 
     const auto cmdbuf = scheduler.CommandBuffer();
-    cmdbuf.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->Handle());
+    scheduler.BindGraphicsPipeline(pipeline->Handle());
+    BeginShaderProfiling(pipeline);
 
     if (is_indexed) {
         cmdbuf.drawIndexed(regs.num_indices, regs.num_instances.NumInstances(), 0,
@@ -229,15 +290,79 @@ void Rasterizer::Draw(bool is_indexed, u32 index_offset) {
         cmdbuf.draw(regs.num_indices, regs.num_instances.NumInstances(), vertex_offset,
                     instance_offset);
     }
+    EndShaderProfiling();
 
     ResetBindings();
 }
 
+void Rasterizer::DrawBatched(const GraphicsPipeline* pipeline, const RenderState& state,
+                             bool is_indexed, u32 index_offset) {
+    const auto& regs = liverpool->regs;
+    VertexBindings vertex_bindings;
+    buffer_cache.ObtainVertexBuffers(*pipeline, vertex_bindings);
+    VideoCore::BufferCache::IndexBinding index_binding{};
+    if (is_indexed) {
+        index_binding = buffer_cache.ObtainIndexBuffer(index_offset);
+    }
+    SetDynamicState(is_indexed);
+
+    HashBinding(&push_data, sizeof(push_data));
+    const DrawBatcher::Key key{
+        .pipeline = pipeline,
+        .bindings_hash = bindings_hash,
+        .vertex_hash = vertex_bindings.hash,
+        .index_buffer = index_binding.buffer,
+        .index_type = index_binding.index_type,
+        .is_indexed = is_indexed,
+    };
+
+    // A draw is appended to the open batch when nothing it binds differs from the batch, the
+    // index buffer may only move forward by whole indices.
+    auto& dynamic_state = scheduler.GetDynamicState();
+    const u32 index_size = index_binding.index_type == vk::IndexType::eUint16 ? 2 : 4;
+    const u64 index_base = draw_batcher->GetIndexOffset();
+    const u64 index_delta = index_binding.offset - index_base;
+    const bool index_reachable =
+        !is_indexed || (index_binding.offset >= index_base && index_delta % index_size == 0);
+    const bool can_append = draw_batcher->CanAppend(key) && index_reachable &&
+                            buffer_barriers.empty() && scheduler.CanContinueRendering(state) &&
+                            !dynamic_state.IsDirty(instance);
+    if (!can_append) {
+        scheduler.FlushDraws();
+        buffer_cache.BindVertexBuffers(vertex_bindings);
+        if (is_indexed) {
+            scheduler.CommandBuffer().bindIndexBuffer(index_binding.buffer, index_binding.offset,
+                                                      index_binding.index_type);
+        }
+        pipeline->BindResources(set_writes, buffer_barriers, push_data);
+        dynamic_state.Commit(instance, scheduler.CommandBuffer());
+        scheduler.BeginRendering(state);
+        scheduler.BindGraphicsPipeline(pipeline->Handle());
+        draw_batcher->Begin(key, index_binding.offset);
+    }
+
+    const auto& vs_info = pipeline->GetStage(Shader::LogicalStage::Vertex);
+    const auto& fetch_shader = pipeline->GetFetchShader();
+    const auto [vertex_offset, instance_offset] = GetDrawOffsets(regs, vs_info, fetch_shader);
+    const u64 first_index =
+        is_indexed ? (index_binding.offset - draw_batcher->GetIndexOffset()) / index_size : 0;
+    draw_batcher->Append({
+        .count = regs.num_indices,
+        .num_instances = regs.num_instances.NumInstances(),
+        .first = is_indexed ? static_cast<u32>(first_index) : vertex_offset,
+        .vertex_offset = is_indexed ? s32(vertex_offset) : 0,
+        .first_instance = instance_offset,
+    });
+}
+
 void Rasterizer::DrawIndirect(bool is_indexed, VAddr arg_address, u32 offset, u32 stride,
                               u32 max_count, VAddr count_address) {
     RENDERER_TRACE;
 
     scheduler.PopPendingOperations();
+    buffer_cache.FlushInlineWrites();
+    // Held back draws must not observe the bindings recorded for this draw.
+    scheduler.FlushDraws();
 
     if (!FilterDraw()) {
         return;
@@ -276,7 +401,8 @@ void Rasterizer::DrawIndirect(bool is_indexed, VAddr arg_address, u32 offset, u3
     // instance offsets will be automatically applied by Vulkan from indirect args buffer.
 
     const auto cmdbuf = scheduler.CommandBuffer();
-    cmdbuf.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline->Handle());
+    scheduler.BindGraphicsPipeline(pipeline->Handle());
+    BeginShaderProfiling(pipeline);
 
     if (is_indexed) {
         ASSERT(sizeof(VkDrawIndexedIndirectCommand) == stride);
@@ -297,6 +423,7 @@ void Rasterizer::DrawIndirect(bool is_indexed, VAddr arg_address, u32 offset, u3
             cmdbuf.drawIndirect(buffer->Handle(), base, max_count, stride);
         }
     }
+    EndShaderProfiling();
 
     ResetBindings();
 }
@@ -305,6 +432,7 @@ void Rasterizer::DispatchDirect() {
     RENDERER_TRACE;
 
     scheduler.PopPendingOperations();
+    buffer_cache.FlushInlineWrites();
 
     const auto& cs_program = liverpool->GetCsRegs();
     const ComputePipeline* pipeline = pipeline_cache.GetComputePipeline();
@@ -321,20 +449,35 @@ void Rasterizer::DispatchDirect() {
         return;
     }
 
-    scheduler.EndRendering();
     pipeline->BindResources(set_writes, buffer_barriers, push_data);
+    scheduler.EndRendering();
 
     const auto cmdbuf = scheduler.CommandBuffer();
     cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline->Handle());
+    BeginShaderProfiling(pipeline);
     cmdbuf.dispatch(cs_program.dim_x, cs_program.dim_y, cs_program.dim_z);
+    EndShaderProfiling();
 
     ResetBindings();
 }
 
+void Rasterizer::BeginAsyncCompute() {
+    scheduler.BeginAsyncCompute();
+}
+
+void Rasterizer::EndAsyncCompute() {
+    scheduler.EndAsyncCompute();
+}
+
+void Rasterizer::SyncAsyncCompute() {
+    scheduler.SyncAsyncCompute();
+}
+
 void Rasterizer::DispatchIndirect(VAddr address, u32 offset, u32 size) {
     RENDERER_TRACE;
 
     scheduler.PopPendingOperations();
+    buffer_cache.FlushInlineWrites();
 
     const auto& cs_program = liverpool->GetCsRegs();
     const ComputePipeline* pipeline = pipeline_cache.GetComputePipeline();
@@ -348,17 +491,20 @@ void Rasterizer::DispatchIndirect(VAddr address, u32 offset, u32 size) {
 
     const auto [buffer, base] = buffer_cache.ObtainBuffer(address + offset, size, false);
 
-    scheduler.EndRendering();
     pipeline->BindResources(set_writes, buffer_barriers, push_data);
+    scheduler.EndRendering();
 
     const auto cmdbuf = scheduler.CommandBuffer();
     cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, pipeline->Handle());
+    BeginShaderProfiling(pipeline);
     cmdbuf.dispatchIndirect(buffer->Handle(), base);
+    EndShaderProfiling();
 
     ResetBindings();
 }
 
 u64 Rasterizer::Flush() {
+    buffer_cache.FlushInlineWrites();
     const u64 current_tick = scheduler.CurrentTick();
     SubmitInfo info{};
     scheduler.Flush(info);
@@ -366,15 +512,33 @@ u64 Rasterizer::Flush() {
 }
 
 void Rasterizer::Finish() {
+    buffer_cache.FlushInlineWrites();
     scheduler.Finish();
+    if (shader_profiler) {
+        shader_profiler->Collect();
+    }
+    if (gpu_profiler) {
+        gpu_profiler->Collect();
+    }
 }
 
 void Rasterizer::OnSubmit() {
+    buffer_cache.FlushInlineWrites();
+    if (shader_profiler) {
+        shader_profiler->Collect();
+    }
+    if (gpu_profiler) {
+        gpu_profiler->EndFrame();
+        gpu_profiler->Collect();
+    }
     if (fault_process_pending) {
         fault_process_pending = false;
         buffer_cache.ProcessFaultBuffer();
     }
     texture_cache.ProcessDownloadImages();
+    if (Config::GetSnapshot().predictive_readbacks) {
+        buffer_cache.DownloadPredictedReadbacks();
+    }
     texture_cache.RunGarbageCollector();
     buffer_cache.RunGarbageCollector();
 }
@@ -388,6 +552,7 @@ bool Rasterizer::BindResources(const Pipeline* pipeline) {
     buffer_barriers.clear();
     buffer_infos.clear();
     image_infos.clear();
+    bindings_hash = 0;
 
     bool uses_dma = false;
 
@@ -421,6 +586,25 @@ bool Rasterizer::BindResources(const Pipeline* pipeline) {
     return true;
 }
 
+void Rasterizer::BeginShaderProfiling(const Pipeline* pipeline) {
+    if (!shader_profiler) {
+        return;
+    }
+    boost::container::static_vector<u32, Shader::MaxStageTypes> slots;
+    for (const auto* stage : pipeline->GetStages()) {
+        if (stage) {
+            slots.push_back(stage->profiling_slot);
+        }
+    }
+    shader_profiler->BeginWork(slots);
+}
+
+void Rasterizer::EndShaderProfiling() {
+    if (shader_profiler) {
+        shader_profiler->EndWork();
+    }
+}
+
 bool Rasterizer::IsComputeMetaClear(const Pipeline* pipeline) {
     if (!pipeline->IsCompute()) {
         return false;
@@ -432,12 +616,32 @@ bool Rasterizer::IsComputeMetaClear(const Pipeline* pipeline) {
     // will need its full emulation anyways.
     const auto& info = pipeline->GetStage(Shader::LogicalStage::Compute);
 
-    // Assume if a shader reads metadata, it is a copy shader.
+    // Assume if a shader reads metadata, it is a copy shader. The host never reads metadata, so
+    // a copy between metadata surfaces only has to carry over their clear state.
+    VAddr src_meta = 0;
     for (const auto& desc : info.buffers) {
         const VAddr address = desc.GetSharp(info).base_address;
         if (!desc.IsSpecial() && !desc.is_written && texture_cache.IsMeta(address)) {
-            return false;
+            src_meta = address;
+            break;
+        }
+    }
+    if (src_meta != 0) {
+        bool copied = false;
+        for (const auto& desc : info.buffers) {
+            if (desc.IsSpecial() || !desc.is_written) {
+                continue;
+            }
+            if (!texture_cache.CopyMeta(desc.GetSharp(info).base_address, src_meta)) {
+                // Metadata is decoded into a regular surface, the shader has to run.
+                return false;
+            }
+            copied = true;
+        }
+        if (copied) {
+            LOG_TRACE(Render_Vulkan, "Metadata copy skipped");
         }
+        return copied;
     }
 
     // Metadata surfaces are tiled and thus need address calculation to be written properly.
@@ -562,10 +766,18 @@ void Rasterizer::BindBuffers(const Shader::Info& stage, Shader::Backend::Binding
             } else if (desc.buffer_type == Shader::BufferType::SharedMemory) {
                 auto& lds_buffer = buffer_cache.GetUtilityBuffer(VideoCore::MemoryUsage::Stream);
                 const auto& cs_program = liverpool->GetCsRegs();
-                const auto lds_size = cs_program.SharedMemSize() * cs_program.NumWorkgroups();
+                // Only the part of shared memory that did not fit on chip is spilled.
+                const auto lds_size = vsharp.GetSize() * cs_program.NumWorkgroups();
                 const auto [data, offset] = lds_buffer.Map(lds_size, alignment);
                 std::memset(data, 0, lds_size);
                 buffer_infos.emplace_back(lds_buffer.Handle(), offset, lds_size);
+            } else if (desc.buffer_type == Shader::BufferType::ProfilingBuffer &&
+                       shader_profiler && stage.profiling_slot != ShaderProfiler::InvalidSlot) {
+                buffer_infos.push_back(shader_profiler->GetCounters(stage.profiling_slot));
+            } else if (desc.buffer_type == Shader::BufferType::TextureHeapIndices) {
+                // Filled with the heap slots of the stage images once they are bound.
+                buffer_infos.emplace_back();
+                texture_heap_indices = &buffer_infos.back();
             } else if (instance.IsNullDescriptorSupported()) {
                 buffer_infos.emplace_back(VK_NULL_HANDLE, 0, VK_WHOLE_SIZE);
             } else {
@@ -591,6 +803,13 @@ void Rasterizer::BindBuffers(const Shader::Info& stage, Shader::Backend::Binding
             }
         }
 
+        if (desc.buffer_type == Shader::BufferType::Flatbuf) {
+            // Streamed to a new offset on every draw, only its contents identify it.
+            HashBinding(stage.flattened_ud_buf.data(),
+                        stage.flattened_ud_buf.size() * sizeof(u32));
+        } else if (desc.buffer_type != Shader::BufferType::TextureHeapIndices) {
+            HashBinding(&buffer_infos.back(), sizeof(vk::DescriptorBufferInfo));
+        }
         set_writes.push_back({
             .dstSet = VK_NULL_HANDLE,
             .dstBinding = binding.unified++,
@@ -618,9 +837,8 @@ void Rasterizer::BindTextures(const Shader::Info& stage, Shader::Backend::Bindin
             continue;
         }
 
-        auto& [image_id, desc] = image_bindings.emplace_back(std::piecewise_construct, std::tuple{},
-                                                             std::tuple{tsharp, image_desc});
-        image_id = texture_cache.FindImage(desc);
+        auto& [image_id, desc] = image_bindings.emplace_back();
+        image_id = texture_cache.FindTextureImage(tsharp, image_desc, desc);
         auto* image = &texture_cache.GetImage(image_id);
         if (image->depth_id) {
             // If this image has an associated depth image, it's a stencil attachment.
@@ -637,10 +855,15 @@ void Rasterizer::BindTextures(const Shader::Info& stage, Shader::Backend::Bindin
     }
 
     // Second pass to re-bind images that were updated after binding
-    for (auto& [image_id, desc] : image_bindings) {
+    std::array<u32, Shader::NUM_IMAGES> heap_slots{};
+    for (u32 i = 0; i < image_bindings.size(); i++) {
+        auto& [image_id, desc] = image_bindings[i];
         bool is_storage = desc.type == VideoCore::TextureCache::BindingType::Storage;
+        const bool is_heap = stage.IsTextureHeapImage(stage.images[i]);
         if (!image_id) {
-            if (instance.IsNullDescriptorSupported()) {
+            if (is_heap) {
+                heap_slots[i] = VideoCore::TextureHeap::NullSlot;
+            } else if (instance.IsNullDescriptorSupported()) {
                 image_infos.emplace_back(VK_NULL_HANDLE, VK_NULL_HANDLE, vk::ImageLayout::eGeneral);
             } else {
                 auto& null_image_view = texture_cache.FindTexture(VideoCore::NULL_IMAGE_ID, desc);
@@ -664,36 +887,45 @@ void Rasterizer::BindTextures(const Shader::Info& stage, Shader::Backend::Bindin
             // storage and feedback loop doesn't make sense for them
             if ((image.binding.force_general || image.binding.is_target) &&
                 !image.info.props.is_depth) {
-                image.Transit(instance.IsAttachmentFeedbackLoopLayoutSupported() &&
-                                      image.binding.is_target
-                                  ? vk::ImageLayout::eAttachmentFeedbackLoopOptimalEXT
-                                  : vk::ImageLayout::eGeneral,
-                              vk::AccessFlagBits2::eShaderRead |
-                                  (image.info.props.is_depth
-                                       ? vk::AccessFlagBits2::eDepthStencilAttachmentWrite
-                                       : vk::AccessFlagBits2::eColorAttachmentWrite),
-                              {});
+                image.QueueTransit(instance.IsAttachmentFeedbackLoopLayoutSupported() &&
+                                           image.binding.is_target
+                                       ? vk::ImageLayout::eAttachmentFeedbackLoopOptimalEXT
+                                       : vk::ImageLayout::eGeneral,
+                                   vk::AccessFlagBits2::eShaderRead |
+                                       (image.info.props.is_depth
+                                            ? vk::AccessFlagBits2::eDepthStencilAttachmentWrite
+                                            : vk::AccessFlagBits2::eColorAttachmentWrite),
+                                   {});
             } else {
                 if (is_storage) {
-                    image.Transit(vk::ImageLayout::eGeneral,
-                                  vk::AccessFlagBits2::eShaderRead |
-                                      vk::AccessFlagBits2::eShaderWrite,
-                                  desc.view_info.range);
+                    image.QueueTransit(vk::ImageLayout::eGeneral,
+                                       vk::AccessFlagBits2::eShaderRead |
+                                           vk::AccessFlagBits2::eShaderWrite,
+                                       desc.view_info.range);
                 } else {
                     const auto new_layout = image.info.props.is_depth
                                                 ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
                                                 : vk::ImageLayout::eShaderReadOnlyOptimal;
-                    image.Transit(new_layout, vk::AccessFlagBits2::eShaderRead,
-                                  desc.view_info.range);
+                    image.QueueTransit(new_layout, vk::AccessFlagBits2::eShaderRead,
+                                       desc.view_info.range);
                 }
             }
             image.usage.storage |= is_storage;
             image.usage.texture |= !is_storage;
 
-            image_infos.emplace_back(VK_NULL_HANDLE, *image_view.image_view,
-                                     image.backing->state.layout);
+            if (is_heap) {
+                heap_slots[i] = texture_cache.GetHeapSlot(image_view, image.backing->state.layout);
+            } else {
+                image_infos.emplace_back(VK_NULL_HANDLE, *image_view.image_view,
+                                         image.backing->state.layout);
+            }
         }
 
+        if (is_heap) {
+            // Sampled through the texture heap, only the slot is passed to the shader.
+            continue;
+        }
+        HashBinding(&image_infos.back(), sizeof(vk::DescriptorImageInfo));
         set_writes.push_back({
             .dstSet = VK_NULL_HANDLE,
             .dstBinding = binding.unified++,
@@ -705,6 +937,14 @@ void Rasterizer::BindTextures(const Shader::Info& stage, Shader::Backend::Bindin
         });
     }
 
+    if (stage.uses_texture_heap) {
+        HashBinding(heap_slots.data(), stage.images.size() * sizeof(u32));
+        auto& vk_buffer = buffer_cache.GetUtilityBuffer(VideoCore::MemoryUsage::Stream);
+        const u32 size = static_cast<u32>(stage.images.size() * sizeof(u32));
+        const u64 offset = vk_buffer.Copy(heap_slots.data(), size, instance.StorageMinAlignment());
+        *texture_heap_indices = vk::DescriptorBufferInfo{vk_buffer.Handle(), offset, size};
+    }
+
     for (const auto& sampler : stage.samplers) {
         auto ssharp = sampler.GetSharp(stage);
         if (sampler.disable_aniso) {
@@ -715,6 +955,7 @@ void Rasterizer::BindTextures(const Shader::Info& stage, Shader::Backend::Bindin
         }
         const auto vk_sampler = texture_cache.GetSampler(ssharp, liverpool->regs.ta_bc_base);
         image_infos.emplace_back(vk_sampler, VK_NULL_HANDLE, vk::ImageLayout::eGeneral);
+        HashBinding(&vk_sampler, sizeof(vk_sampler));
         set_writes.push_back({
             .dstSet = VK_NULL_HANDLE,
             .dstBinding = binding.unified++,
@@ -746,7 +987,7 @@ RenderState Rasterizer::BeginRendering(const GraphicsPipeline* pipeline) {
             image = &texture_cache.GetImage(image_id);
         }
         texture_cache.UpdateImage(image_id);
-        image->SetBackingSamples(key.color_samples[cb]);
+        image->SetBackingSamples(pipeline_cache.GetGraphicsState().color_samples[cb]);
         const auto& image_view = texture_cache.FindRenderTarget(image_id, desc);
         const auto slice = image_view.info.range.base.layer;
         const auto mip = image_view.info.range.base.level;
@@ -758,16 +999,16 @@ RenderState Rasterizer::BeginRendering(const GraphicsPipeline* pipeline) {
         if (image->binding.is_bound) {
             ASSERT_MSG(!image->binding.force_general,
                        "Having image both as storage and render target is unsupported");
-            image->Transit(instance.IsAttachmentFeedbackLoopLayoutSupported()
-                               ? vk::ImageLayout::eAttachmentFeedbackLoopOptimalEXT
-                               : vk::ImageLayout::eGeneral,
-                           vk::AccessFlagBits2::eColorAttachmentWrite, {});
+            image->QueueTransit(instance.IsAttachmentFeedbackLoopLayoutSupported()
+                                    ? vk::ImageLayout::eAttachmentFeedbackLoopOptimalEXT
+                                    : vk::ImageLayout::eGeneral,
+                                vk::AccessFlagBits2::eColorAttachmentWrite, {});
             attachment_feedback_loop = true;
         } else {
-            image->Transit(vk::ImageLayout::eColorAttachmentOptimal,
-                           vk::AccessFlagBits2::eColorAttachmentWrite |
-                               vk::AccessFlagBits2::eColorAttachmentRead,
-                           desc.view_info.range);
+            image->QueueTransit(vk::ImageLayout::eColorAttachmentOptimal,
+                                vk::AccessFlagBits2::eColorAttachmentWrite |
+                                    vk::AccessFlagBits2::eColorAttachmentRead,
+                                desc.view_info.range);
         }
 
         state.width = std::min<u32>(state.width, std::max(image->info.size.width >> mip, 1u));
@@ -803,10 +1044,10 @@ RenderState Rasterizer::BeginRendering(const GraphicsPipeline* pipeline) {
                                                   : vk::ImageLayout::eDepthAttachmentOptimal
                                 : has_stencil ? vk::ImageLayout::eDepthStencilReadOnlyOptimal
                                               : vk::ImageLayout::eDepthReadOnlyOptimal;
-        image.Transit(new_layout,
-                      vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
-                          vk::AccessFlagBits2::eDepthStencilAttachmentRead,
-                      desc.view_info.range);
+        image.QueueTransit(new_layout,
+                           vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+                               vk::AccessFlagBits2::eDepthStencilAttachmentRead,
+                           desc.view_info.range);
 
         state.width = std::min<u32>(state.width, image.info.size.width);
         state.height = std::min<u32>(state.height, image.info.size.height);
@@ -984,14 +1225,18 @@ void Rasterizer::UnmapMemory(VAddr addr, u64 size) {
 }
 
 void Rasterizer::UpdateDynamicState(const GraphicsPipeline* pipeline, const bool is_indexed) const {
+    SetDynamicState(is_indexed);
+
+    auto& dynamic_state = scheduler.GetDynamicState();
+    dynamic_state.Commit(instance, scheduler.CommandBuffer());
+}
+
+void Rasterizer::SetDynamicState(const bool is_indexed) const {
     UpdateViewportScissorState();
     UpdateDepthStencilState();
     UpdatePrimitiveState(is_indexed);
     UpdateRasterizationState();
-    UpdateColorBlendingState(pipeline);
-
-    auto& dynamic_state = scheduler.GetDynamicState();
-    dynamic_state.Commit(instance, scheduler.CommandBuffer());
+    UpdateColorBlendingState();
 }
 
 void Rasterizer::UpdateViewportScissorState() const {
@@ -1205,21 +1450,43 @@ void Rasterizer::UpdatePrimitiveState(const bool is_indexed) const {
 
 void Rasterizer::UpdateRasterizationState() const {
     const auto& regs = liverpool->regs;
+    const auto& key = pipeline_cache.GetGraphicsState();
     auto& dynamic_state = scheduler.GetDynamicState();
     dynamic_state.SetLineWidth(regs.line_control.Width());
+    dynamic_state.SetPolygonMode(LiverpoolToVK::PolygonMode(key.polygon_mode));
+    dynamic_state.SetRasterizationSamples(LiverpoolToVK::NumSamples(
+        key.num_samples, instance.GetColorSampleCounts() & instance.GetDepthSampleCounts()));
 }
 
-void Rasterizer::UpdateColorBlendingState(const GraphicsPipeline* pipeline) const {
+void Rasterizer::UpdateColorBlendingState() const {
     const auto& regs = liverpool->regs;
+    const auto& key = pipeline_cache.GetGraphicsState();
     auto& dynamic_state = scheduler.GetDynamicState();
     dynamic_state.SetBlendConstants(regs.blend_constants);
-    dynamic_state.SetColorWriteMasks(pipeline->GetGraphicsKey().write_masks);
+    dynamic_state.SetColorWriteMasks(key.write_masks);
+    if (instance.IsDynamicColorBlendSupported()) {
+        ColorBlendEnables blend_enables{};
+        ColorBlendEquations blend_equations{};
+        for (u32 i = 0; i < key.num_color_attachments; ++i) {
+            blend_enables[i] = key.blend_controls[i].enable;
+            blend_equations[i] = GraphicsPipeline::GetBlendEquation(key, i);
+        }
+        dynamic_state.SetColorBlendEnables(blend_enables);
+        dynamic_state.SetColorBlendEquations(blend_equations);
+    }
+    dynamic_state.SetLogicOpEnabled(instance.IsLogicOpSupported() &&
+                                    key.logic_op != AmdGpu::ColorControl::LogicOp::Copy);
+    dynamic_state.SetLogicOp(LiverpoolToVK::LogicOp(key.logic_op));
     dynamic_state.SetAttachmentFeedbackLoopEnabled(attachment_feedback_loop);
 }
 
 void Rasterizer::ScopeMarkerBegin(const std::string_view& str, bool from_guest) {
-    if ((from_guest && !Config::getVkGuestMarkersEnabled()) ||
-        (!from_guest && !Config::getVkHostMarkersEnabled())) {
+    scheduler.FlushDraws();
+    if (gpu_profiler) {
+        gpu_profiler->BeginZone(str);
+    }
+    if ((from_guest && !Config::GetSnapshot().vk_guest_markers) ||
+        (!from_guest && !Config::GetSnapshot().vk_host_markers)) {
         return;
     }
     const auto cmdbuf = scheduler.CommandBuffer();
@@ -1229,8 +1496,12 @@ void Rasterizer::ScopeMarkerBegin(const std::string_view& str, bool from_guest)
 }
 
 void Rasterizer::ScopeMarkerEnd(bool from_guest) {
-    if ((from_guest && !Config::getVkGuestMarkersEnabled()) ||
-        (!from_guest && !Config::getVkHostMarkersEnabled())) {
+    scheduler.FlushDraws();
+    if (gpu_profiler) {
+        gpu_profiler->EndZone();
+    }
+    if ((from_guest && !Config::GetSnapshot().vk_guest_markers) ||
+        (!from_guest && !Config::GetSnapshot().vk_host_markers)) {
         return;
     }
     const auto cmdbuf = scheduler.CommandBuffer();
@@ -1238,8 +1509,9 @@ void Rasterizer::ScopeMarkerEnd(bool from_guest) {
 }
 
 void Rasterizer::ScopedMarkerInsert(const std::string_view& str, bool from_guest) {
-    if ((from_guest && !Config::getVkGuestMarkersEnabled()) ||
-        (!from_guest && !Config::getVkHostMarkersEnabled())) {
+    scheduler.FlushDraws();
+    if ((from_guest && !Config::GetSnapshot().vk_guest_markers) ||
+        (!from_guest && !Config::GetSnapshot().vk_host_markers)) {
         return;
     }
     const auto cmdbuf = scheduler.CommandBuffer();
@@ -1250,8 +1522,9 @@ void Rasterizer::ScopedMarkerInsert(const std::string_view& str, bool from_guest
 
 void Rasterizer::ScopedMarkerInsertColor(const std::string_view& str, const u32 color,
                                          bool from_guest) {
-    if ((from_guest && !Config::getVkGuestMarkersEnabled()) ||
-        (!from_guest && !Config::getVkHostMarkersEnabled())) {
+    scheduler.FlushDraws();
+    if ((from_guest && !Config::GetSnapshot().vk_guest_markers) ||
+        (!from_guest && !Config::GetSnapshot().vk_host_markers)) {
         return;
     }
     const auto cmdbuf = scheduler.CommandBuffer();
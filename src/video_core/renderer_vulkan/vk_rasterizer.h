@@ -3,11 +3,15 @@
 
 #pragma once
 
+#include <xxhash.h>
+
 #include "common/recursive_lock.h"
 #include "common/shared_first_mutex.h"
 #include "video_core/buffer_cache/buffer_cache.h"
 #include "video_core/page_manager.h"
+#include "video_core/renderer_vulkan/vk_gpu_profiler.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
+#include "video_core/renderer_vulkan/vk_shader_profiler.h"
 #include "video_core/texture_cache/texture_cache.h"
 
 namespace AmdGpu {
@@ -23,6 +27,7 @@ namespace Vulkan {
 class Scheduler;
 class RenderState;
 class GraphicsPipeline;
+class DrawBatcher;
 
 class Rasterizer {
 public:
@@ -49,6 +54,14 @@ public:
     void DispatchDirect();
     void DispatchIndirect(VAddr address, u32 offset, u32 size);
 
+    /// Brackets commands of a guest compute ring, they are recorded on the async compute queue
+    /// when it is enabled.
+    void BeginAsyncCompute();
+    void EndAsyncCompute();
+
+    /// Submits the async compute work at a synchronization point of a guest compute ring.
+    void SyncAsyncCompute();
+
     void ScopeMarkerBegin(const std::string_view& str, bool from_guest = false);
     void ScopeMarkerEnd(bool from_guest = false);
     void ScopedMarkerInsert(const std::string_view& str, bool from_guest = false);
@@ -73,6 +86,14 @@ public:
         return pipeline_cache;
     }
 
+    [[nodiscard]] const ShaderProfiler* GetShaderProfiler() const noexcept {
+        return shader_profiler.get();
+    }
+
+    [[nodiscard]] const GpuProfiler* GetGpuProfiler() const noexcept {
+        return gpu_profiler;
+    }
+
     template <typename Func>
     void ForEachMappedRangeInRange(VAddr addr, u64 size, Func&& func) {
         const auto range = decltype(mapped_ranges)::interval_type::right_open(addr, addr + size);
@@ -88,13 +109,18 @@ private:
     void Resolve();
     void DepthStencilCopy(bool is_depth, bool is_stencil);
     void EliminateFastClear();
+    void DecompressDepth();
+
+    void DrawBatched(const GraphicsPipeline* pipeline, const RenderState& state, bool is_indexed,
+                     u32 index_offset);
 
     void UpdateDynamicState(const GraphicsPipeline* pipeline, bool is_indexed) const;
+    void SetDynamicState(bool is_indexed) const;
     void UpdateViewportScissorState() const;
     void UpdateDepthStencilState() const;
     void UpdatePrimitiveState(bool is_indexed) const;
     void UpdateRasterizationState() const;
-    void UpdateColorBlendingState(const GraphicsPipeline* pipeline) const;
+    void UpdateColorBlendingState() const;
 
     bool FilterDraw();
 
@@ -102,6 +128,14 @@ private:
                      Shader::PushData& push_data);
     void BindTextures(const Shader::Info& stage, Shader::Backend::Bindings& binding);
     bool BindResources(const Pipeline* pipeline);
+    void BeginShaderProfiling(const Pipeline* pipeline);
+    void EndShaderProfiling();
+
+    void HashBinding(const void* data, size_t size) {
+        if (draw_batcher) {
+            bindings_hash = XXH3_64bits_withSeed(data, size, bindings_hash);
+        }
+    }
 
     void ResetBindings() {
         for (auto& image_id : bound_images) {
@@ -125,6 +159,9 @@ private:
     Core::MemoryManager* memory;
     boost::icl::interval_set<VAddr> mapped_ranges;
     Common::SharedFirstMutex mapped_ranges_mutex;
+    std::unique_ptr<ShaderProfiler> shader_profiler;
+    GpuProfiler* gpu_profiler{};
+    DrawBatcher* draw_batcher{};
     PipelineCache pipeline_cache;
 
     using RenderTargetInfo = std::pair<VideoCore::ImageId, VideoCore::TextureCache::ImageDesc>;
@@ -132,11 +169,14 @@ private:
     std::pair<VideoCore::ImageId, VideoCore::TextureCache::ImageDesc> db_desc;
     boost::container::static_vector<vk::DescriptorImageInfo, Shader::NUM_IMAGES> image_infos;
     boost::container::static_vector<vk::DescriptorBufferInfo, Shader::NUM_BUFFERS> buffer_infos;
+    vk::DescriptorBufferInfo* texture_heap_indices{};
     boost::container::static_vector<VideoCore::ImageId, Shader::NUM_IMAGES> bound_images;
 
     Pipeline::DescriptorWrites set_writes;
     Pipeline::BufferBarriers buffer_barriers;
     Shader::PushData push_data;
+    /// Hash of the resources bound for the current draw, only tracked when batching draws.
+    u64 bindings_hash{};
 
     using BufferBindingInfo = std::tuple<VideoCore::BufferId, AmdGpu::Buffer, u64>;
     boost::container::static_vector<BufferBindingInfo, Shader::NUM_BUFFERS> buffer_bindings;
@@ -4,6 +4,7 @@
 #pragma once
 
 #include <deque>
+#include <optional>
 #include <vector>
 #include <boost/container/static_vector.hpp>
 #include <tsl/robin_map.h>
@@ -51,7 +52,9 @@ protected:
 
 class CommandPool final : public ResourcePool {
 public:
-    explicit CommandPool(const Instance& instance, MasterSemaphore* master_semaphore);
+    explicit CommandPool(const Instance& instance, MasterSemaphore* master_semaphore,
+                         vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary,
+                         std::optional<u32> queue_family_index = std::nullopt);
     ~CommandPool() override;
 
     void Allocate(std::size_t begin, std::size_t end) override;
@@ -62,6 +65,7 @@ private:
     const Instance& instance;
     vk::UniqueCommandPool cmd_pool;
     std::vector<vk::CommandBuffer> cmd_buffers;
+    vk::CommandBufferLevel level;
 };
 
 class DescriptorHeap final {
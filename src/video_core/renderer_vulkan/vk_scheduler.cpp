@@ -1,11 +1,22 @@
 // SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
+#include <thread>
+#include <utility>
+#include <boost/container/static_vector.hpp>
+
 #include "common/assert.h"
 #include "common/debug.h"
+#include "common/logging/log.h"
 #include "imgui/renderer/texture_manager.h"
+#include "video_core/renderer_vulkan/vk_compute_scheduler.h"
+#include "video_core/renderer_vulkan/vk_descriptor_buffer.h"
+#include "video_core/renderer_vulkan/vk_draw_batcher.h"
+#include "video_core/renderer_vulkan/vk_gpu_profiler.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_transfer_scheduler.h"
 
 namespace Vulkan {
 
@@ -26,8 +37,14 @@ Scheduler::~Scheduler() {
 }
 
 void Scheduler::BeginRendering(const RenderState& new_state) {
-    if (is_rendering && render_state == new_state) {
-        return;
+    if (is_rendering && pending_image_barriers.empty() && pending_buffer_barriers.empty()) {
+        if (render_state == new_state) {
+            return;
+        }
+        FlushDraws();
+        if (ContinueRendering(new_state)) {
+            return;
+        }
     }
     EndRendering();
     is_rendering = true;
@@ -49,14 +66,128 @@ void Scheduler::BeginRendering(const RenderState& new_state) {
     };
 
     current_cmdbuf.beginRendering(rendering_info);
+    if (gpu_profiler) {
+        gpu_profiler->BeginRenderPass();
+    }
 }
 
 void Scheduler::EndRendering() {
-    if (!is_rendering) {
+    if (is_rendering) {
+        FlushDraws();
+        is_rendering = false;
+        if (gpu_profiler) {
+            gpu_profiler->EndRenderPass();
+        }
+        current_cmdbuf.endRendering();
+    }
+    FlushBarriers();
+}
+
+bool Scheduler::ContinueRendering(const RenderState& new_state) {
+    // Attachments that are cleared or loaded continue the current scope, games often clear a
+    // target with the first draw to it and load it in the following ones.
+    RenderState merged = new_state;
+    const auto merge = [](vk::RenderingAttachmentInfo& attachment,
+                          const vk::RenderingAttachmentInfo& current) {
+        attachment.loadOp = current.loadOp;
+        attachment.clearValue = current.clearValue;
+    };
+    for (u32 i = 0; i < new_state.num_color_attachments; ++i) {
+        merge(merged.color_attachments[i], render_state.color_attachments[i]);
+    }
+    merge(merged.depth_attachment, render_state.depth_attachment);
+    merge(merged.stencil_attachment, render_state.stencil_attachment);
+    if (!(merged == render_state)) {
+        return false;
+    }
+
+    const auto needs_clear = [](const vk::RenderingAttachmentInfo& attachment,
+                                const vk::RenderingAttachmentInfo& current) {
+        return attachment.imageView && attachment.loadOp == vk::AttachmentLoadOp::eClear &&
+               current.loadOp != vk::AttachmentLoadOp::eClear;
+    };
+    boost::container::static_vector<vk::ClearAttachment, 9> clears;
+    for (u32 i = 0; i < new_state.num_color_attachments; ++i) {
+        const auto& attachment = new_state.color_attachments[i];
+        if (needs_clear(attachment, render_state.color_attachments[i])) {
+            clears.push_back({
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .colorAttachment = i,
+                .clearValue = attachment.clearValue,
+            });
+        }
+    }
+    const auto& depth = new_state.depth_attachment;
+    const auto& stencil = new_state.stencil_attachment;
+    vk::ImageAspectFlags ds_aspect{};
+    vk::ClearValue ds_value{};
+    if (new_state.has_depth && needs_clear(depth, render_state.depth_attachment)) {
+        ds_aspect |= vk::ImageAspectFlagBits::eDepth;
+        ds_value.depthStencil.depth = depth.clearValue.depthStencil.depth;
+    }
+    if (new_state.has_stencil && needs_clear(stencil, render_state.stencil_attachment)) {
+        ds_aspect |= vk::ImageAspectFlagBits::eStencil;
+        ds_value.depthStencil.stencil = stencil.clearValue.depthStencil.stencil;
+    }
+    if (ds_aspect) {
+        clears.push_back({.aspectMask = ds_aspect, .clearValue = ds_value});
+    }
+    if (!clears.empty()) {
+        const vk::ClearRect rect = {
+            .rect = {.offset = {0, 0}, .extent = {render_state.width, render_state.height}},
+            .baseArrayLayer = 0,
+            .layerCount = render_state.num_layers,
+        };
+        current_cmdbuf.clearAttachments(clears, rect);
+    }
+    return true;
+}
+
+void Scheduler::DeferBarriers(std::span<const vk::ImageMemoryBarrier2> image_barriers,
+                              std::span<const vk::BufferMemoryBarrier2> buffer_barriers) {
+    for (const auto& barrier : image_barriers) {
+        const auto it = std::ranges::find(pending_image_barriers, barrier.image,
+                                          &vk::ImageMemoryBarrier2::image);
+        if (it == pending_image_barriers.end()) {
+            pending_image_barriers.push_back(barrier);
+            continue;
+        }
+        if (it->subresourceRange == barrier.subresourceRange) {
+            // Barriers in one command are not ordered, fold consecutive transitions into one.
+            it->dstStageMask = barrier.dstStageMask;
+            it->dstAccessMask = barrier.dstAccessMask;
+            it->newLayout = barrier.newLayout;
+            continue;
+        }
+        EndRendering();
+        pending_image_barriers.push_back(barrier);
+    }
+    for (const auto& barrier : buffer_barriers) {
+        const auto it = std::ranges::find_if(pending_buffer_barriers, [&](const auto& pending) {
+            return pending.buffer == barrier.buffer && pending.offset == barrier.offset &&
+                   pending.size == barrier.size;
+        });
+        if (it != pending_buffer_barriers.end()) {
+            it->dstStageMask = barrier.dstStageMask;
+            it->dstAccessMask = barrier.dstAccessMask;
+        } else {
+            pending_buffer_barriers.push_back(barrier);
+        }
+    }
+}
+
+void Scheduler::FlushBarriers() {
+    if (pending_image_barriers.empty() && pending_buffer_barriers.empty()) {
         return;
     }
-    is_rendering = false;
-    current_cmdbuf.endRendering();
+    current_cmdbuf.pipelineBarrier2(vk::DependencyInfo{
+        .bufferMemoryBarrierCount = static_cast<u32>(pending_buffer_barriers.size()),
+        .pBufferMemoryBarriers = pending_buffer_barriers.data(),
+        .imageMemoryBarrierCount = static_cast<u32>(pending_image_barriers.size()),
+        .pImageMemoryBarriers = pending_image_barriers.data(),
+    });
+    pending_image_barriers.clear();
+    pending_buffer_barriers.clear();
 }
 
 void Scheduler::Flush(SubmitInfo& info) {
@@ -103,18 +234,194 @@ void Scheduler::PopPendingOperations() {
     }
 }
 
-void Scheduler::AllocateWorkerCommandBuffers() {
+void Scheduler::BeginCommandBuffer(vk::CommandBuffer cmdbuf) {
     const vk::CommandBufferBeginInfo begin_info = {
         .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
     };
-
-    current_cmdbuf = command_pool.Commit();
-    auto begin_result = current_cmdbuf.begin(begin_info);
+    auto begin_result = cmdbuf.begin(begin_info);
     ASSERT_MSG(begin_result == vk::Result::eSuccess, "Failed to begin command buffer: {}",
                vk::to_string(begin_result));
+}
+
+void Scheduler::RecordParallel(Common::UniqueFunction<void, vk::CommandBuffer>&& func) {
+    if (!recording_worker) {
+        const u32 num_workers = std::max(1U, std::thread::hardware_concurrency() / 2);
+        recording_worker = std::make_unique<Common::ThreadWorker>(num_workers, "CmdRecorder");
+    }
+
+    // Close the current segment, the secondary is executed from a dedicated primary command
+    // buffer placed between it and the next segment once recording is done.
+#if TRACY_GPU_ENABLED
+    if (instance.GetProfilerContext()) {
+        profiler_scope->~VkCtxScope();
+    }
+#endif
+    EndRendering();
+    auto end_result = current_cmdbuf.end();
+    ASSERT_MSG(end_result == vk::Result::eSuccess, "Failed to end command buffer: {}",
+               vk::to_string(end_result));
+    submit_cmdbufs.push_back(current_cmdbuf);
+
+    const vk::CommandBuffer stitch_cmdbuf = command_pool.Commit();
+    BeginCommandBuffer(stitch_cmdbuf);
+    submit_cmdbufs.push_back(stitch_cmdbuf);
+
+    if (free_recording_pools.empty()) {
+        free_recording_pools.push_back(static_cast<u32>(recording_pools.size()));
+        recording_pools.emplace_back(std::make_unique<CommandPool>(
+            instance, &master_semaphore, vk::CommandBufferLevel::eSecondary));
+    }
+    const u32 context_index = free_recording_pools.back();
+    free_recording_pools.pop_back();
+    const vk::CommandBuffer secondary_cmdbuf = recording_pools[context_index]->Commit();
+    parallel_recordings.push_back({stitch_cmdbuf, secondary_cmdbuf, context_index});
+
+    recording_worker->QueueWork([secondary_cmdbuf, func = std::move(func)]() mutable {
+        const vk::CommandBufferInheritanceInfo inheritance_info{};
+        const vk::CommandBufferBeginInfo begin_info = {
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+            .pInheritanceInfo = &inheritance_info,
+        };
+        auto begin_result = secondary_cmdbuf.begin(begin_info);
+        ASSERT_MSG(begin_result == vk::Result::eSuccess,
+                   "Failed to begin secondary command buffer: {}", vk::to_string(begin_result));
+        func(vk::CommandBuffer{secondary_cmdbuf});
+        auto end_result = secondary_cmdbuf.end();
+        ASSERT_MSG(end_result == vk::Result::eSuccess, "Failed to end secondary command buffer: {}",
+                   vk::to_string(end_result));
+    });
+
+    AllocateWorkerCommandBuffers();
+}
+
+TransferScheduler* Scheduler::EnableAsyncTransfer() {
+    if (!transfer_scheduler && instance.HasDedicatedTransferQueue()) {
+        transfer_scheduler = std::make_unique<TransferScheduler>(instance, *this);
+        LOG_INFO(Render_Vulkan, "Using dedicated transfer queue family {} for uploads",
+                 instance.GetTransferQueueFamilyIndex());
+    }
+    return transfer_scheduler.get();
+}
+
+GpuProfiler* Scheduler::EnableGpuProfiler() {
+    if (!gpu_profiler && instance.IsTimestampQuerySupported()) {
+        gpu_profiler = std::make_unique<GpuProfiler>(instance, *this);
+        LOG_INFO(Render_Vulkan, "GPU profiling enabled");
+    } else if (!gpu_profiler) {
+        LOG_WARNING(Render_Vulkan, "Timestamp queries are not supported, GPU profiling is "
+                                   "disabled");
+    }
+    return gpu_profiler.get();
+}
+
+DescriptorBuffer* Scheduler::EnableDescriptorBuffer() {
+    if (!descriptor_buffer && DescriptorBuffer::IsSupported(instance)) {
+        descriptor_buffer = std::make_unique<DescriptorBuffer>(instance, *this);
+        LOG_INFO(Render_Vulkan, "Binding descriptors from a descriptor buffer");
+    } else if (!descriptor_buffer) {
+        LOG_WARNING(Render_Vulkan, "Descriptor buffers are not supported, falling back to "
+                                   "descriptor sets");
+    }
+    return descriptor_buffer.get();
+}
+
+DrawBatcher* Scheduler::EnableDrawBatching() {
+    if (!draw_batcher) {
+        draw_batcher = std::make_unique<DrawBatcher>(instance, *this);
+        LOG_INFO(Render_Vulkan, "Batching consecutive draws {}",
+                 instance.IsMultiDrawIndirectSupported() ? "into multi draw indirect calls"
+                                                         : "without multi draw indirect");
+    }
+    return draw_batcher.get();
+}
+
+void Scheduler::FlushDraws() {
+    if (draw_batcher) {
+        draw_batcher->Flush(current_cmdbuf);
+    }
+}
+
+ComputeScheduler* Scheduler::EnableAsyncCompute() {
+    if (!compute_scheduler && instance.HasAsyncComputeQueue()) {
+        compute_scheduler = std::make_unique<ComputeScheduler>(instance);
+        LOG_INFO(Render_Vulkan, "Running guest compute rings on the async compute queue");
+    } else if (!compute_scheduler) {
+        LOG_WARNING(Render_Vulkan, "The graphics queue family has a single queue, guest compute "
+                                   "rings run on the graphics queue");
+    }
+    return compute_scheduler.get();
+}
+
+void Scheduler::BeginAsyncCompute() {
+    if (!compute_scheduler || is_async_compute) {
+        return;
+    }
+    EndRendering();
+    if (!compute_scheduler->IsRecording()) {
+        Flush();
+    }
+    SwitchToAsyncCompute(CurrentTick() - 1);
+}
+
+void Scheduler::EndAsyncCompute() {
+    if (!is_async_compute) {
+        return;
+    }
+    EndRendering();
+    current_cmdbuf = std::exchange(graphics_cmdbuf, vk::CommandBuffer{});
+    is_async_compute = false;
+    if (descriptor_buffer) {
+        descriptor_buffer->Invalidate();
+    }
+}
+
+void Scheduler::SyncAsyncCompute() {
+    if (!compute_scheduler) {
+        return;
+    }
+    EndAsyncCompute();
+    if (const u64 compute_tick = compute_scheduler->Submit()) {
+        // The graphics work recorded so far may still run alongside the batch, only the work
+        // recorded after the synchronization point has to wait for it.
+        Flush();
+        compute_release_tick = compute_tick;
+    }
+}
+
+void Scheduler::SwitchToAsyncCompute(u64 graphics_tick) {
+    graphics_cmdbuf = current_cmdbuf;
+    current_cmdbuf = compute_scheduler->Begin(master_semaphore.Handle(), graphics_tick);
+    is_async_compute = true;
+    if (descriptor_buffer) {
+        descriptor_buffer->Invalidate();
+    }
+}
+
+void Scheduler::StitchParallelRecordings() {
+    if (parallel_recordings.empty()) {
+        return;
+    }
+    recording_worker->WaitForRequests();
+    for (const auto& recording : parallel_recordings) {
+        recording.stitch_cmdbuf.executeCommands(recording.secondary_cmdbuf);
+        auto end_result = recording.stitch_cmdbuf.end();
+        ASSERT_MSG(end_result == vk::Result::eSuccess, "Failed to end command buffer: {}",
+                   vk::to_string(end_result));
+        free_recording_pools.push_back(recording.context_index);
+    }
+    parallel_recordings.clear();
+}
+
+void Scheduler::AllocateWorkerCommandBuffers() {
+    current_cmdbuf = command_pool.Commit();
+    BeginCommandBuffer(current_cmdbuf);
 
     // Invalidate dynamic state so it gets applied to the new command buffer.
     dynamic_state.Invalidate();
+    bound_graphics_pipeline = VK_NULL_HANDLE;
+    if (descriptor_buffer) {
+        descriptor_buffer->Invalidate();
+    }
 
 #if TRACY_GPU_ENABLED
     auto* profiler_ctx = instance.GetProfilerContext();
@@ -122,6 +429,9 @@ void Scheduler::AllocateWorkerCommandBuffers() {
         static const auto scope_loc =
             GPU_SCOPE_LOCATION("Guest Frame", MarkersPalette::GpuMarkerColor);
         new (profiler_scope) tracy::VkCtxScope{profiler_ctx, &scope_loc, current_cmdbuf, true};
+        if (gpu_profiler) {
+            gpu_profiler->ResumeTracyZones(current_cmdbuf);
+        }
     }
 #endif
 }
@@ -130,9 +440,19 @@ void Scheduler::SubmitExecution(SubmitInfo& info) {
     std::scoped_lock lk{submit_mutex};
     const u64 signal_value = master_semaphore.NextTick();
 
+    // Async compute work recorded so far is retired with this tick, so it is submitted first.
+    const bool resume_async_compute = is_async_compute;
+    if (compute_scheduler) {
+        EndAsyncCompute();
+        compute_scheduler->Submit();
+    }
+
 #if TRACY_GPU_ENABLED
     auto* profiler_ctx = instance.GetProfilerContext();
     if (profiler_ctx) {
+        if (gpu_profiler) {
+            gpu_profiler->SuspendTracyZones();
+        }
         profiler_scope->~VkCtxScope();
         TracyVkCollect(profiler_ctx, current_cmdbuf);
     }
@@ -143,18 +463,42 @@ void Scheduler::SubmitExecution(SubmitInfo& info) {
     ASSERT_MSG(end_result == vk::Result::eSuccess, "Failed to end command buffer: {}",
                vk::to_string(end_result));
 
+    StitchParallelRecordings();
+    submit_cmdbufs.push_back(current_cmdbuf);
+
     const vk::Semaphore timeline = master_semaphore.Handle();
     info.AddSignal(timeline, signal_value);
 
-    static constexpr std::array<vk::PipelineStageFlags, 2> wait_stage_masks = {
+    std::array<vk::PipelineStageFlags, 4> wait_stage_masks = {
         vk::PipelineStageFlagBits::eAllCommands,
         vk::PipelineStageFlagBits::eColorAttachmentOutput,
+        vk::PipelineStageFlagBits::eAllCommands,
+        vk::PipelineStageFlagBits::eAllCommands,
     };
+    if (transfer_scheduler) {
+        if (const u64 transfer_tick = transfer_scheduler->Flush()) {
+            // The uploaded data may be consumed by any command of this submission.
+            ASSERT(info.num_wait_semas < wait_stage_masks.size());
+            wait_stage_masks[info.num_wait_semas] = vk::PipelineStageFlagBits::eAllCommands;
+            info.AddWait(transfer_scheduler->Semaphore(), transfer_tick);
+        }
+    }
+    if (compute_release_tick) {
+        // The submission follows a guest synchronization point of a compute ring.
+        ASSERT(info.num_wait_semas < wait_stage_masks.size());
+        wait_stage_masks[info.num_wait_semas] = vk::PipelineStageFlagBits::eAllCommands;
+        info.AddWait(compute_scheduler->Semaphore(), std::exchange(compute_release_tick, 0));
+    }
+
+    // Batches submitted to the compute queue are waited for by a trailing submission that
+    // signals instead of the commands, so they still run alongside them.
+    const u64 compute_tick = compute_scheduler ? compute_scheduler->Flush() : 0;
+    const u32 num_command_signals = compute_tick ? 0 : info.num_signal_semas;
 
     const vk::TimelineSemaphoreSubmitInfo timeline_si = {
         .waitSemaphoreValueCount = info.num_wait_semas,
         .pWaitSemaphoreValues = info.wait_ticks.data(),
-        .signalSemaphoreValueCount = info.num_signal_semas,
+        .signalSemaphoreValueCount = num_command_signals,
         .pSignalSemaphoreValues = info.signal_ticks.data(),
     };
 
@@ -163,23 +507,79 @@ void Scheduler::SubmitExecution(SubmitInfo& info) {
         .waitSemaphoreCount = info.num_wait_semas,
         .pWaitSemaphores = info.wait_semas.data(),
         .pWaitDstStageMask = wait_stage_masks.data(),
-        .commandBufferCount = 1U,
-        .pCommandBuffers = &current_cmdbuf,
-        .signalSemaphoreCount = info.num_signal_semas,
+        .commandBufferCount = static_cast<u32>(submit_cmdbufs.size()),
+        .pCommandBuffers = submit_cmdbufs.data(),
+        .signalSemaphoreCount = num_command_signals,
         .pSignalSemaphores = info.signal_semas.data(),
     };
 
     ImGui::Core::TextureManager::Submit();
-    auto submit_result = instance.GetGraphicsQueue().submit(submit_info, info.fence);
+    vk::Result submit_result;
+    if (compute_tick) {
+        const vk::Semaphore compute_timeline = compute_scheduler->Semaphore();
+        const vk::PipelineStageFlags compute_wait_stage = vk::PipelineStageFlagBits::eAllCommands;
+        const vk::TimelineSemaphoreSubmitInfo retire_timeline_si = {
+            .waitSemaphoreValueCount = 1,
+            .pWaitSemaphoreValues = &compute_tick,
+            .signalSemaphoreValueCount = info.num_signal_semas,
+            .pSignalSemaphoreValues = info.signal_ticks.data(),
+        };
+        const std::array submit_infos = {
+            submit_info,
+            vk::SubmitInfo{
+                .pNext = &retire_timeline_si,
+                .waitSemaphoreCount = 1,
+                .pWaitSemaphores = &compute_timeline,
+                .pWaitDstStageMask = &compute_wait_stage,
+                .signalSemaphoreCount = info.num_signal_semas,
+                .pSignalSemaphores = info.signal_semas.data(),
+            },
+        };
+        submit_result = instance.GetGraphicsQueue().submit(submit_infos, info.fence);
+    } else {
+        submit_result = instance.GetGraphicsQueue().submit(submit_info, info.fence);
+    }
     ASSERT_MSG(submit_result != vk::Result::eErrorDeviceLost, "Device lost during submit");
 
+    submit_cmdbufs.clear();
+
     master_semaphore.Refresh();
     AllocateWorkerCommandBuffers();
+    if (resume_async_compute) {
+        // The submission interrupted a compute ring command, it continues on a new batch.
+        SwitchToAsyncCompute(signal_value);
+    }
 
     // Apply pending operations
     PopPendingOperations();
 }
 
+bool DynamicState::IsDirty(const Instance& instance) const {
+    const auto& dirty = dirty_state;
+    // State that only applies while its test is enabled stays dirty until the test is enabled.
+    const bool depth_dirty = dirty.depth_test_enabled || dirty.depth_write_enabled ||
+                             (depth_test_enabled && dirty.depth_compare_op) ||
+                             dirty.depth_bounds_test_enabled ||
+                             (depth_bounds_test_enabled && dirty.depth_bounds) ||
+                             dirty.depth_bias_enabled || (depth_bias_enabled && dirty.depth_bias);
+    const bool stencil_dirty =
+        dirty.stencil_test_enabled ||
+        (stencil_test_enabled &&
+         (dirty.stencil_front_ops || dirty.stencil_front_reference ||
+          dirty.stencil_front_write_mask || dirty.stencil_front_compare_mask ||
+          dirty.stencil_back_ops || dirty.stencil_back_reference || dirty.stencil_back_write_mask ||
+          dirty.stencil_back_compare_mask));
+    const bool raster_dirty = dirty.primitive_restart_enable || dirty.rasterizer_discard_enable ||
+                              dirty.cull_mode || dirty.front_face || dirty.polygon_mode ||
+                              dirty.rasterization_samples || dirty.line_width;
+    const bool blend_dirty = dirty.blend_constants || dirty.color_write_masks ||
+                             dirty.color_blend_enables || dirty.color_blend_equations ||
+                             dirty.logic_op_enabled || (logic_op_enabled && dirty.logic_op);
+    return dirty.viewports || dirty.scissors || depth_dirty || stencil_dirty || raster_dirty ||
+           blend_dirty ||
+           (dirty.feedback_loop_enabled && instance.IsAttachmentFeedbackLoopLayoutSupported());
+}
+
 void DynamicState::Commit(const Instance& instance, const vk::CommandBuffer& cmdbuf) {
     if (dirty_state.viewports) {
         dirty_state.viewports = false;
@@ -329,6 +729,42 @@ void DynamicState::Commit(const Instance& instance, const vk::CommandBuffer& cmd
             cmdbuf.setColorWriteMaskEXT(0, color_write_masks);
         }
     }
+    if (dirty_state.color_blend_enables) {
+        dirty_state.color_blend_enables = false;
+        if (instance.IsDynamicColorBlendSupported()) {
+            cmdbuf.setColorBlendEnableEXT(0, color_blend_enables);
+        }
+    }
+    if (dirty_state.color_blend_equations) {
+        dirty_state.color_blend_equations = false;
+        if (instance.IsDynamicColorBlendSupported()) {
+            cmdbuf.setColorBlendEquationEXT(0, color_blend_equations);
+        }
+    }
+    if (dirty_state.logic_op_enabled) {
+        dirty_state.logic_op_enabled = false;
+        if (instance.IsDynamicLogicOpSupported()) {
+            cmdbuf.setLogicOpEnableEXT(logic_op_enabled);
+        }
+    }
+    if (logic_op_enabled && dirty_state.logic_op) {
+        dirty_state.logic_op = false;
+        if (instance.IsDynamicLogicOpSupported()) {
+            cmdbuf.setLogicOpEXT(logic_op);
+        }
+    }
+    if (dirty_state.polygon_mode) {
+        dirty_state.polygon_mode = false;
+        if (instance.IsDynamicPolygonModeSupported()) {
+            cmdbuf.setPolygonModeEXT(polygon_mode);
+        }
+    }
+    if (dirty_state.rasterization_samples) {
+        dirty_state.rasterization_samples = false;
+        if (instance.IsDynamicRasterizationSamplesSupported()) {
+            cmdbuf.setRasterizationSamplesEXT(rasterization_samples);
+        }
+    }
     if (dirty_state.line_width) {
         dirty_state.line_width = false;
         cmdbuf.setLineWidth(line_width);
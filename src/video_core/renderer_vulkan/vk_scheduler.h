@@ -4,9 +4,13 @@
 #pragma once
 
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <span>
+#include <vector>
 
+#include "common/thread_worker.h"
 #include "common/unique_function.h"
 #include "video_core/amdgpu/regs_color.h"
 #include "video_core/amdgpu/regs_primitive.h"
@@ -19,7 +23,12 @@ class VkCtxScope;
 
 namespace Vulkan {
 
+class ComputeScheduler;
+class GpuProfiler;
+class DescriptorBuffer;
+class DrawBatcher;
 class Instance;
+class TransferScheduler;
 
 struct RenderState {
     std::array<vk::RenderingAttachmentInfo, 8> color_attachments;
@@ -46,8 +55,8 @@ struct RenderState {
 };
 
 struct SubmitInfo {
-    std::array<vk::Semaphore, 3> wait_semas;
-    std::array<u64, 3> wait_ticks;
+    std::array<vk::Semaphore, 4> wait_semas;
+    std::array<u64, 4> wait_ticks;
     std::array<vk::Semaphore, 3> signal_semas;
     std::array<u64, 3> signal_ticks;
     vk::Fence fence;
@@ -72,6 +81,8 @@ struct SubmitInfo {
 using Viewports = boost::container::static_vector<vk::Viewport, AmdGpu::NUM_VIEWPORTS>;
 using Scissors = boost::container::static_vector<vk::Rect2D, AmdGpu::NUM_VIEWPORTS>;
 using ColorWriteMasks = std::array<vk::ColorComponentFlags, AmdGpu::NUM_COLOR_BUFFERS>;
+using ColorBlendEnables = std::array<vk::Bool32, AmdGpu::NUM_COLOR_BUFFERS>;
+using ColorBlendEquations = std::array<vk::ColorBlendEquationEXT, AmdGpu::NUM_COLOR_BUFFERS>;
 struct StencilOps {
     vk::StencilOp fail_op{};
     vk::StencilOp pass_op{};
@@ -115,6 +126,12 @@ struct DynamicState {
 
         bool blend_constants : 1;
         bool color_write_masks : 1;
+        bool color_blend_enables : 1;
+        bool color_blend_equations : 1;
+        bool logic_op_enabled : 1;
+        bool logic_op : 1;
+        bool polygon_mode : 1;
+        bool rasterization_samples : 1;
         bool line_width : 1;
         bool feedback_loop_enabled : 1;
     } dirty_state{};
@@ -152,6 +169,12 @@ struct DynamicState {
 
     std::array<float, 4> blend_constants{};
     ColorWriteMasks color_write_masks{};
+    ColorBlendEnables color_blend_enables{};
+    ColorBlendEquations color_blend_equations{};
+    bool logic_op_enabled{};
+    vk::LogicOp logic_op{};
+    vk::PolygonMode polygon_mode{};
+    vk::SampleCountFlagBits rasterization_samples{};
     float line_width{};
     bool feedback_loop_enabled{};
 
@@ -163,6 +186,9 @@ struct DynamicState {
         std::memset(&dirty_state, 0xFF, sizeof(dirty_state));
     }
 
+    /// Returns true if the next commit records any state.
+    [[nodiscard]] bool IsDirty(const Instance& instance) const;
+
     void SetViewports(const Viewports& viewports_) {
         if (!std::ranges::equal(viewports, viewports_)) {
             viewports = viewports_;
@@ -323,6 +349,48 @@ struct DynamicState {
         }
     }
 
+    void SetColorBlendEnables(const ColorBlendEnables& color_blend_enables_) {
+        if (!std::ranges::equal(color_blend_enables, color_blend_enables_)) {
+            color_blend_enables = color_blend_enables_;
+            dirty_state.color_blend_enables = true;
+        }
+    }
+
+    void SetColorBlendEquations(const ColorBlendEquations& color_blend_equations_) {
+        if (!std::ranges::equal(color_blend_equations, color_blend_equations_)) {
+            color_blend_equations = color_blend_equations_;
+            dirty_state.color_blend_equations = true;
+        }
+    }
+
+    void SetLogicOpEnabled(const bool enabled) {
+        if (logic_op_enabled != enabled) {
+            logic_op_enabled = enabled;
+            dirty_state.logic_op_enabled = true;
+        }
+    }
+
+    void SetLogicOp(const vk::LogicOp logic_op_) {
+        if (logic_op != logic_op_) {
+            logic_op = logic_op_;
+            dirty_state.logic_op = true;
+        }
+    }
+
+    void SetPolygonMode(const vk::PolygonMode polygon_mode_) {
+        if (polygon_mode != polygon_mode_) {
+            polygon_mode = polygon_mode_;
+            dirty_state.polygon_mode = true;
+        }
+    }
+
+    void SetRasterizationSamples(const vk::SampleCountFlagBits samples) {
+        if (rasterization_samples != samples) {
+            rasterization_samples = samples;
+            dirty_state.rasterization_samples = true;
+        }
+    }
+
     void SetLineWidth(const float width) {
         if (line_width != width) {
             line_width = width;
@@ -360,22 +428,43 @@ public:
     /// Attempts to execute operations whose tick the GPU has caught up with.
     void PopPendingOperations();
 
-    /// Starts a new rendering scope with provided state.
+    /// Starts a new rendering scope with provided state. The current scope is continued when
+    /// the new state only differs in attachments it clears.
     void BeginRendering(const RenderState& new_state);
 
-    /// Ends current rendering scope.
+    /// Ends current rendering scope and records the deferred barriers.
     void EndRendering();
 
+    /// Defers barriers until the rendering scope ends or the next one begins, so the transitions
+    /// of a draw or dispatch are recorded in a single pipeline barrier.
+    void DeferBarriers(std::span<const vk::ImageMemoryBarrier2> image_barriers,
+                       std::span<const vk::BufferMemoryBarrier2> buffer_barriers = {});
+
     /// Returns the current render state.
     const RenderState& GetRenderState() const {
         return render_state;
     }
 
+    /// Returns true while a rendering scope is open and no barriers wait to be recorded, draws
+    /// recorded with the current state then continue the scope.
+    [[nodiscard]] bool CanContinueRendering(const RenderState& state) const noexcept {
+        return is_rendering && pending_image_barriers.empty() && pending_buffer_barriers.empty() &&
+               render_state == state;
+    }
+
     /// Returns the current pipeline dynamic state tracking.
     DynamicState& GetDynamicState() {
         return dynamic_state;
     }
 
+    /// Binds a graphics pipeline, skipped when it is already bound to the current command buffer.
+    void BindGraphicsPipeline(vk::Pipeline pipeline) {
+        if (bound_graphics_pipeline != pipeline) {
+            current_cmdbuf.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+            bound_graphics_pipeline = pipeline;
+        }
+    }
+
     /// Returns the current command buffer.
     vk::CommandBuffer CommandBuffer() const {
         return current_cmdbuf;
@@ -405,19 +494,85 @@ public:
         pending_ops.emplace(std::move(func), CurrentTick());
     }
 
+    /// Records commands into a secondary command buffer on a recording thread. The commands are
+    /// executed at the current position of the command stream, the callback must only reference
+    /// state that stays valid until the next flush. This begins a new primary command buffer so
+    /// previously returned command buffers and bound state must not be reused afterwards.
+    void RecordParallel(Common::UniqueFunction<void, vk::CommandBuffer>&& func);
+
+    /// Creates the transfer queue upload path, batches recorded on it are submitted ahead of
+    /// every flush. Returns null if the device has no dedicated transfer queue.
+    TransferScheduler* EnableAsyncTransfer();
+
+    /// Returns the transfer queue upload path, null if it is not enabled.
+    [[nodiscard]] TransferScheduler* GetTransferScheduler() const noexcept {
+        return transfer_scheduler.get();
+    }
+
+    /// Creates the timestamp query profiler, render passes are recorded as zones from then on.
+    /// Returns null if the device cannot write timestamps.
+    GpuProfiler* EnableGpuProfiler();
+
+    /// Creates the descriptor buffer ring, pipelines created from then on bind their descriptors
+    /// from it. Returns null if the device does not support descriptor buffers.
+    DescriptorBuffer* EnableDescriptorBuffer();
+
+    /// Returns the descriptor buffer ring, null if it is not enabled.
+    [[nodiscard]] DescriptorBuffer* GetDescriptorBuffer() const noexcept {
+        return descriptor_buffer.get();
+    }
+
+    /// Creates the draw batcher, its pending draws are recorded before the rendering scope
+    /// changes or ends.
+    DrawBatcher* EnableDrawBatching();
+
+    /// Records the draws held back by the draw batcher, if any.
+    void FlushDraws();
+
+    /// Creates the async compute path for guest compute rings. Returns null if the graphics
+    /// queue family has no second queue.
+    ComputeScheduler* EnableAsyncCompute();
+
+    /// Redirects recording to the async compute batch until EndAsyncCompute, does nothing if
+    /// async compute is not enabled. Opening a batch submits the graphics work recorded so far,
+    /// as the batch may depend on any of it.
+    void BeginAsyncCompute();
+
+    /// Returns recording to the graphics command buffer.
+    void EndAsyncCompute();
+
+    /// Submits the async compute batch at a guest synchronization point, graphics work recorded
+    /// from then on waits for it to complete.
+    void SyncAsyncCompute();
+
     static std::mutex submit_mutex;
 
 private:
     void AllocateWorkerCommandBuffers();
 
+    void BeginCommandBuffer(vk::CommandBuffer cmdbuf);
+
     void SubmitExecution(SubmitInfo& info);
 
+    /// Waits for parallel recordings and stitches them into the submission.
+    void StitchParallelRecordings();
+
+    /// Clears the attachments the new state clears without leaving the current scope, returns
+    /// false when the states are not compatible.
+    bool ContinueRendering(const RenderState& new_state);
+
+    void FlushBarriers();
+
+    /// Records on the async compute batch, which waits for the given graphics tick if it is new.
+    void SwitchToAsyncCompute(u64 graphics_tick);
+
 private:
     const Instance& instance;
     MasterSemaphore master_semaphore;
     CommandPool command_pool;
     DynamicState dynamic_state;
     vk::CommandBuffer current_cmdbuf;
+    vk::Pipeline bound_graphics_pipeline;
     std::condition_variable_any event_cv;
     struct PendingOp {
         Common::UniqueFunction<void> callback;
@@ -426,7 +581,32 @@ private:
     std::queue<PendingOp> pending_ops;
     RenderState render_state;
     bool is_rendering = false;
+    std::vector<vk::ImageMemoryBarrier2> pending_image_barriers;
+    std::vector<vk::BufferMemoryBarrier2> pending_buffer_barriers;
     tracy::VkCtxScope* profiler_scope{};
+
+    /// Primary command buffers of the current submission that precede current_cmdbuf.
+    std::vector<vk::CommandBuffer> submit_cmdbufs;
+    struct ParallelRecording {
+        vk::CommandBuffer stitch_cmdbuf;
+        vk::CommandBuffer secondary_cmdbuf;
+        u32 context_index;
+    };
+    std::vector<ParallelRecording> parallel_recordings;
+    /// Secondary command pools, each only used by one recording at a time.
+    std::vector<std::unique_ptr<CommandPool>> recording_pools;
+    std::vector<u32> free_recording_pools;
+    std::unique_ptr<Common::ThreadWorker> recording_worker;
+    std::unique_ptr<TransferScheduler> transfer_scheduler;
+    std::unique_ptr<GpuProfiler> gpu_profiler;
+    std::unique_ptr<DescriptorBuffer> descriptor_buffer;
+    std::unique_ptr<DrawBatcher> draw_batcher;
+    std::unique_ptr<ComputeScheduler> compute_scheduler;
+    /// Graphics command buffer set aside while recording on the async compute batch.
+    vk::CommandBuffer graphics_cmdbuf{};
+    /// Compute tick the next graphics submission waits for before any of its commands.
+    u64 compute_release_tick{};
+    bool is_async_compute{};
 };
 
 } // namespace Vulkan
@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <array>
+
+#include "core/debug_state.h"
 #include "shader_recompiler/info.h"
 #include "video_core/renderer_vulkan/vk_rasterizer.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
@@ -12,8 +15,26 @@ namespace Vulkan {
 
 static constexpr u64 COPY_SHADER_HASH = 0xfefebf9f;
 
-static bool ExecuteCopyShaderHLE(const Shader::Info& info, const AmdGpu::ComputeProgram& cs_program,
-                                 Rasterizer& rasterizer) {
+using ShaderHLEHandler = bool (*)(const Shader::Info& info, const AmdGpu::Regs& regs,
+                                  const AmdGpu::ComputeProgram& cs_program,
+                                  Rasterizer& rasterizer);
+
+/// A compute shader replaced with native commands. Shaders are matched by program hash, or by
+/// IR fingerprint for utility shaders that are rebuilt with different register allocation.
+struct ShaderHLE {
+    const char* name;
+    u64 pgm_hash;
+    u64 ir_fingerprint;
+    ShaderHLEHandler handler;
+
+    bool Matches(const Shader::Info& info) const {
+        return (pgm_hash != 0 && info.pgm_hash == pgm_hash) ||
+               (ir_fingerprint != 0 && info.ir_fingerprint == ir_fingerprint);
+    }
+};
+
+static bool ExecuteCopyShaderHLE(const Shader::Info& info, const AmdGpu::Regs& regs,
+                                 const AmdGpu::ComputeProgram& cs_program, Rasterizer& rasterizer) {
     auto& scheduler = rasterizer.GetScheduler();
     auto& buffer_cache = rasterizer.GetBufferCache();
 
@@ -120,14 +141,21 @@ static bool ExecuteCopyShaderHLE(const Shader::Info& info, const AmdGpu::Compute
     return true;
 }
 
+static constexpr std::array ShaderHLEs = {
+    ShaderHLE{"copy", COPY_SHADER_HASH, 0, &ExecuteCopyShaderHLE},
+};
+
 bool ExecuteShaderHLE(const Shader::Info& info, const AmdGpu::Regs& regs,
                       const AmdGpu::ComputeProgram& cs_program, Rasterizer& rasterizer) {
-    switch (info.pgm_hash) {
-    case COPY_SHADER_HASH:
-        return ExecuteCopyShaderHLE(info, cs_program, rasterizer);
-    default:
-        return false;
+    for (const auto& hle : ShaderHLEs) {
+        if (!hle.Matches(info) || !hle.handler(info, regs, cs_program, rasterizer)) {
+            continue;
+        }
+        LOG_TRACE(Render_Vulkan, "Executed {} shader {:#x} with HLE", hle.name, info.pgm_hash);
+        DebugState.renderer_counters.Add(DebugStateType::RendererCounter::ShaderHleDispatches);
+        return true;
     }
+    return false;
 }
 
 } // namespace Vulkan
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <array>
+#include <cstring>
+#include <utility>
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "video_core/buffer_cache/buffer.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_platform.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_shader_profiler.h"
+
+#include <vk_mem_alloc.h>
+
+namespace Vulkan {
+
+ShaderProfiler::ShaderProfiler(const Instance& instance_, Scheduler& scheduler_)
+    : instance{instance_}, scheduler{scheduler_} {
+    counters = std::make_unique<VideoCore::Buffer>(
+        instance, scheduler, VideoCore::MemoryUsage::Download, 0,
+        vk::BufferUsageFlagBits::eStorageBuffer | vk::BufferUsageFlagBits::eShaderDeviceAddress,
+        CounterBufferSize);
+    ASSERT_MSG(!counters->mapped_data.empty(), "Shader profiling buffer is not host visible");
+    std::memset(counters->mapped_data.data(), 0, CounterBufferSize);
+    if (!counters->is_coherent) {
+        vmaFlushAllocation(instance.GetAllocator(), counters->buffer.allocation, 0,
+                           CounterBufferSize);
+    }
+    SetObjectName(instance.GetDevice(), counters->Handle(), "ShaderProfilingBuffer");
+
+    if (!instance.IsTimestampQuerySupported()) {
+        LOG_WARNING(Render_Vulkan, "Timestamp queries are not supported, shader GPU time will "
+                                   "not be measured");
+        return;
+    }
+    const vk::Device device = instance.GetDevice();
+    const vk::QueryPoolCreateInfo pool_ci = {
+        .queryType = vk::QueryType::eTimestamp,
+        .queryCount = MaxQueries,
+    };
+    auto [pool_result, pool] = device.createQueryPoolUnique(pool_ci);
+    ASSERT_MSG(pool_result == vk::Result::eSuccess, "Failed to create query pool: {}",
+               vk::to_string(pool_result));
+    query_pool = std::move(pool);
+    device.resetQueryPool(*query_pool, 0, MaxQueries);
+    SetObjectName(device, *query_pool, "ShaderProfilingQueries");
+}
+
+ShaderProfiler::~ShaderProfiler() = default;
+
+u32 ShaderProfiler::Register(const std::string& name, u32 num_counters) {
+    std::scoped_lock lk{mutex};
+    if (const auto it = slot_map.find(name); it != slot_map.end()) {
+        // Recompiled permutations share the counters of their first compilation.
+        return slots[it->second].num_counters == num_counters ? it->second : InvalidSlot;
+    }
+    const u64 offset = Common::AlignUp(counter_pos, instance.StorageMinAlignment());
+    const u64 size = num_counters * sizeof(u32);
+    if (offset + size > CounterBufferSize) {
+        LOG_WARNING(Render_Vulkan, "Shader profiling buffer is full, {} is not profiled", name);
+        return InvalidSlot;
+    }
+    counter_pos = offset + size;
+    const u32 slot = static_cast<u32>(slots.size());
+    slots.push_back({offset, num_counters, 0, 0});
+    slot_map.emplace(name, slot);
+    return slot;
+}
+
+vk::DescriptorBufferInfo ShaderProfiler::GetCounters(u32 slot) const {
+    std::scoped_lock lk{mutex};
+    const Slot& region = slots[slot];
+    return vk::DescriptorBufferInfo{
+        .buffer = counters->Handle(),
+        .offset = region.offset,
+        .range = region.num_counters * sizeof(u32),
+    };
+}
+
+void ShaderProfiler::BeginWork(std::span<const u32> work_slots) {
+    if (!query_pool) {
+        return;
+    }
+    if (pending_work.size() >= MaxQueries / 2) {
+        Collect();
+        if (pending_work.size() >= MaxQueries / 2) {
+            // All queries are still in flight, this draw is not timed.
+            return;
+        }
+    }
+    pending_work.push({next_query, scheduler.CurrentTick(), {}});
+    PendingWork& work = pending_work.back();
+    for (const u32 slot : work_slots) {
+        if (slot != InvalidSlot) {
+            work.slots.push_back(slot);
+        }
+    }
+    scheduler.CommandBuffer().writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, *query_pool,
+                                             next_query);
+    work_open = true;
+}
+
+void ShaderProfiler::EndWork() {
+    if (!std::exchange(work_open, false)) {
+        return;
+    }
+    scheduler.CommandBuffer().writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe,
+                                             *query_pool, next_query + 1);
+    next_query = (next_query + 2) % MaxQueries;
+}
+
+void ShaderProfiler::Collect() {
+    if (!query_pool) {
+        return;
+    }
+    const vk::Device device = instance.GetDevice();
+    const double period = instance.TimestampPeriod();
+    while (!pending_work.empty()) {
+        const PendingWork& work = pending_work.front();
+        if (!scheduler.IsFree(work.tick)) {
+            break;
+        }
+        std::array<u64, 2> timestamps{};
+        const auto result = device.getQueryPoolResults(
+            *query_pool, work.query, 2, sizeof(timestamps), timestamps.data(), sizeof(u64),
+            vk::QueryResultFlagBits::e64);
+        if (result == vk::Result::eSuccess && timestamps[1] >= timestamps[0]) {
+            const u64 time_ns = static_cast<u64>((timestamps[1] - timestamps[0]) * period);
+            std::scoped_lock lk{mutex};
+            for (const u32 slot : work.slots) {
+                slots[slot].gpu_time_ns += time_ns;
+                ++slots[slot].num_dispatches;
+            }
+        }
+        device.resetQueryPool(*query_pool, work.query, 2);
+        pending_work.pop();
+    }
+}
+
+std::optional<ShaderProfiler::ShaderStats> ShaderProfiler::GetStats(std::string_view name,
+                                                                    bool read_counters) const {
+    std::scoped_lock lk{mutex};
+    const auto it = slot_map.find(std::string{name});
+    if (it == slot_map.end()) {
+        return std::nullopt;
+    }
+    const Slot& slot = slots[it->second];
+    ShaderStats stats{slot.gpu_time_ns, slot.num_dispatches, {}};
+    if (read_counters) {
+        const u64 size = slot.num_counters * sizeof(u32);
+        if (!counters->is_coherent) {
+            vmaInvalidateAllocation(instance.GetAllocator(), counters->buffer.allocation,
+                                    slot.offset, size);
+        }
+        stats.block_counts.resize(slot.num_counters);
+        std::memcpy(stats.block_counts.data(), counters->mapped_data.data() + slot.offset, size);
+    }
+    return stats;
+}
+
+} // namespace Vulkan
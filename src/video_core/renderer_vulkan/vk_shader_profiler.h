@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace VideoCore {
+class Buffer;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * Collects per-shader profiling data when shader profiling is enabled. Instrumented shaders
+ * increment one counter per basic block in a region of a host visible buffer, the counters are
+ * never reset so they hold the total number of invocations that entered each block. In addition
+ * every draw and dispatch is bracketed by timestamp queries, its GPU time is attributed to all
+ * shaders of the bound pipeline.
+ */
+class ShaderProfiler {
+public:
+    static constexpr u32 InvalidSlot = ~0U;
+    static constexpr u64 CounterBufferSize = 64_MB;
+    static constexpr u32 MaxQueries = 4096;
+
+    struct ShaderStats {
+        u64 gpu_time_ns{};
+        u64 num_dispatches{};
+        std::vector<u32> block_counts;
+    };
+
+    explicit ShaderProfiler(const Instance& instance, Scheduler& scheduler);
+    ~ShaderProfiler();
+
+    ShaderProfiler(const ShaderProfiler&) = delete;
+    ShaderProfiler& operator=(const ShaderProfiler&) = delete;
+
+    /// Reserves counters for a shader and returns its slot, InvalidSlot if the buffer is full.
+    [[nodiscard]] u32 Register(const std::string& name, u32 num_counters);
+
+    /// Returns the counter region of a slot, to be bound as the shader's profiling buffer.
+    [[nodiscard]] vk::DescriptorBufferInfo GetCounters(u32 slot) const;
+
+    /// Records the start timestamp of a draw or dispatch using the shaders in slots.
+    void BeginWork(std::span<const u32> slots);
+
+    /// Records the end timestamp of the last draw or dispatch.
+    void EndWork();
+
+    /// Accumulates the timestamps of all completed work.
+    void Collect();
+
+    /// Returns the statistics of a shader, block counts are only read when requested.
+    [[nodiscard]] std::optional<ShaderStats> GetStats(std::string_view name,
+                                                      bool read_counters = false) const;
+
+private:
+    struct Slot {
+        u64 offset;
+        u32 num_counters;
+        u64 gpu_time_ns;
+        u64 num_dispatches;
+    };
+
+    struct PendingWork {
+        u32 query;
+        u64 tick;
+        std::vector<u32> slots;
+    };
+
+    const Instance& instance;
+    Scheduler& scheduler;
+    std::unique_ptr<VideoCore::Buffer> counters;
+    vk::UniqueQueryPool query_pool;
+    mutable std::mutex mutex;
+    std::unordered_map<std::string, u32> slot_map;
+    std::vector<Slot> slots;
+    std::queue<PendingWork> pending_work;
+    u64 counter_pos{};
+    u32 next_query{};
+    bool work_open{};
+};
+
+} // namespace Vulkan
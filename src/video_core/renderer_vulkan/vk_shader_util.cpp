@@ -1,10 +1,15 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <algorithm>
 #include <memory>
+#include <string>
 #include <glslang/Include/ResourceLimits.h>
 #include <glslang/Public/ShaderLang.h>
 #include <glslang/SPIRV/GlslangToSpv.h>
+#ifdef ENABLE_SPIRV_OPT
+#include <spirv-tools/optimizer.hpp>
+#endif
 #include "common/assert.h"
 #include "common/logging/log.h"
 #include "video_core/renderer_vulkan/vk_shader_util.h"
@@ -266,4 +271,41 @@ vk::ShaderModule CompileSPV(std::span<const u32> code, vk::Device device) {
     return module;
 }
 
+std::optional<std::vector<u32>> OptimizeSPV(std::span<const u32> code, std::string_view passes) {
+#ifdef ENABLE_SPIRV_OPT
+    // The optimizer is not thread safe, every caller builds its own.
+    spvtools::Optimizer optimizer{SPV_ENV_VULKAN_1_3};
+    optimizer.SetMessageConsumer([](spv_message_level_t level, const char*,
+                                    const spv_position_t& position, const char* message) {
+        if (level <= SPV_MSG_ERROR) {
+            LOG_ERROR(Render_Vulkan, "spirv-opt: {} at word {}", message, position.index);
+        }
+    });
+    if (passes == "performance") {
+        optimizer.RegisterPerformancePasses();
+    } else {
+        std::vector<std::string> flags;
+        size_t pos = 0;
+        while (pos < passes.size()) {
+            const size_t end = std::min(passes.find_first_of(" ,", pos), passes.size());
+            if (end != pos) {
+                flags.emplace_back(passes.substr(pos, end - pos));
+            }
+            pos = end + 1;
+        }
+        if (!optimizer.RegisterPassesFromFlags(flags)) {
+            LOG_ERROR(Render_Vulkan, "Invalid spirv-opt pass list: {}", passes);
+            return std::nullopt;
+        }
+    }
+    std::vector<u32> optimized;
+    if (!optimizer.Run(code.data(), code.size(), &optimized)) {
+        return std::nullopt;
+    }
+    return optimized;
+#else
+    return std::nullopt;
+#endif
+}
+
 } // namespace Vulkan
@@ -3,7 +3,10 @@
 
 #pragma once
 
+#include <optional>
 #include <span>
+#include <string_view>
+#include <vector>
 
 #include "common/types.h"
 #include "video_core/renderer_vulkan/vk_common.h"
@@ -26,4 +29,13 @@ vk::ShaderModule Compile(std::string_view code, vk::ShaderStageFlagBits stage, v
  */
 vk::ShaderModule CompileSPV(std::span<const u32> code, vk::Device device);
 
+/**
+ * @brief Runs spirv-opt over SPIR-V bytecode.
+ * @param code The SPIR-V bytecode data.
+ * @param passes "performance" for the standard performance recipe, otherwise a list of spirv-opt
+ *               pass flags separated by spaces or commas.
+ * @return The optimized bytecode, or nullopt if the optimizer is unavailable or failed.
+ */
+std::optional<std::vector<u32>> OptimizeSPV(std::span<const u32> code, std::string_view passes);
+
 } // namespace Vulkan
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <limits>
+#include <utility>
 #include "common/assert.h"
 #include "common/config.h"
 #include "common/logging/log.h"
@@ -37,6 +38,9 @@ void Swapchain::Create(u32 width_, u32 height_) {
     height = height_;
     needs_recreation = false;
 
+    // The retired swapchain is handed to the new one, so the presentation engine can reuse its
+    // resources and keep showing its last image until the new one is presented.
+    const vk::SwapchainKHR old_swapchain = std::exchange(swapchain, VK_NULL_HANDLE);
     Destroy();
 
     SetSurfaceProperties();
@@ -67,7 +71,7 @@ void Swapchain::Create(u32 width_, u32 height_) {
         .compositeAlpha = composite_alpha,
         .presentMode = present_mode,
         .clipped = true,
-        .oldSwapchain = nullptr,
+        .oldSwapchain = old_swapchain,
     };
 
     auto [swapchain_result, chain] = instance.GetDevice().createSwapchainKHR(swapchain_info);
@@ -76,7 +80,11 @@ void Swapchain::Create(u32 width_, u32 height_) {
     swapchain = chain;
 
     SetupImages();
+    if (old_swapchain) {
+        instance.GetDevice().destroySwapchainKHR(old_swapchain);
+    }
     RefreshSemaphores();
+    present_id = 0;
 }
 
 void Swapchain::Recreate(u32 width_, u32 height_) {
@@ -90,12 +98,7 @@ void Swapchain::SetHDR(bool hdr) {
         return;
     }
 
-    auto result = instance.GetDevice().waitIdle();
-    if (result != vk::Result::eSuccess) {
-        LOG_WARNING(ImGui, "Failed to wait for Vulkan device idle on mode change: {}",
-                    vk::to_string(result));
-    }
-
+    // Recreation waits for the device to become idle.
     needs_hdr = hdr;
     Recreate(width, height);
     ImGui::Core::OnSurfaceFormatChange(needs_hdr ? SURFACE_FORMAT_HDR.format
@@ -128,8 +131,13 @@ bool Swapchain::AcquireNextImage() {
 }
 
 bool Swapchain::Present() {
-
+    const u64 next_present_id = present_id + 1;
+    const vk::PresentIdKHR present_id_info = {
+        .swapchainCount = 1,
+        .pPresentIds = &next_present_id,
+    };
     const vk::PresentInfoKHR present_info = {
+        .pNext = instance.IsPresentWaitSupported() ? &present_id_info : nullptr,
         .waitSemaphoreCount = 1,
         .pWaitSemaphores = &present_ready[image_index],
         .swapchainCount = 1,
@@ -146,10 +154,47 @@ bool Swapchain::Present() {
     }
 
     frame_index = (frame_index + 1) % image_count;
+    present_id = next_present_id;
 
     return !needs_recreation;
 }
 
+bool Swapchain::WaitForPresent(u64 id, u64 timeout_ns) {
+    if (!instance.IsPresentWaitSupported() || id == 0 || id > present_id) {
+        return false;
+    }
+    const auto result = instance.GetDevice().waitForPresentKHR(swapchain, id, timeout_ns);
+    switch (result) {
+    case vk::Result::eSuccess:
+    case vk::Result::eTimeout:
+        break;
+    case vk::Result::eSuboptimalKHR:
+    case vk::Result::eErrorOutOfDateKHR:
+    case vk::Result::eErrorSurfaceLostKHR:
+        needs_recreation = true;
+        break;
+    default:
+        LOG_WARNING(Render_Vulkan, "Waiting for present {} returned {}", id,
+                    vk::to_string(result));
+        return false;
+    }
+    return true;
+}
+
+bool Swapchain::IsPresentModeSupported(vk::PresentModeKHR mode) const {
+    return std::ranges::find(present_modes, mode) != present_modes.cend();
+}
+
+void Swapchain::SetPresentMode(vk::PresentModeKHR mode) {
+    if (present_mode == mode || !IsPresentModeSupported(mode)) {
+        return;
+    }
+    LOG_INFO(Render_Vulkan, "Switching present mode from {} to {}", vk::to_string(present_mode),
+             vk::to_string(mode));
+    present_mode = mode;
+    Recreate(width, height);
+}
+
 void Swapchain::FindPresentFormat() {
     const auto [formats_result, formats] =
         instance.GetPhysicalDevice().getSurfaceFormatsKHR(surface);
@@ -190,17 +235,21 @@ void Swapchain::FindPresentFormat() {
 }
 
 void Swapchain::FindPresentMode() {
-    const auto [modes_result, modes] =
-        instance.GetPhysicalDevice().getSurfacePresentModesKHR(surface);
+    auto [modes_result, modes] = instance.GetPhysicalDevice().getSurfacePresentModesKHR(surface);
     if (modes_result != vk::Result::eSuccess) {
         LOG_ERROR(Render, "Failed to query available present modes, falling back to Fifo as "
                           "guaranteed supported option.");
         present_mode = vk::PresentModeKHR::eFifo;
+        present_modes = {present_mode};
         return;
     }
+    present_modes = std::move(modes);
 
     const auto requested_mode = Config::getPresentMode();
-    if (requested_mode == "Mailbox") {
+    if (requested_mode == "Auto") {
+        // The present pacer switches modes once it has measured the frame times.
+        present_mode = vk::PresentModeKHR::eFifo;
+    } else if (requested_mode == "Mailbox") {
         present_mode = vk::PresentModeKHR::eMailbox;
     } else if (requested_mode == "Fifo") {
         present_mode = vk::PresentModeKHR::eFifo;
@@ -212,7 +261,7 @@ void Swapchain::FindPresentMode() {
         present_mode = vk::PresentModeKHR::eMailbox;
     }
 
-    if (std::ranges::find(modes, present_mode) == modes.cend()) {
+    if (!IsPresentModeSupported(present_mode)) {
         // FIFO is guaranteed to be supported by the Vulkan spec.
         constexpr auto fallback = vk::PresentModeKHR::eFifo;
         LOG_WARNING(Render, "Requested present mode {} is not supported, falling back to {}.",
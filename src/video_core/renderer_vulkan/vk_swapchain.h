@@ -34,6 +34,25 @@ public:
     /// Presents the current image and move to the next one
     bool Present();
 
+    /// Waits until the present with the provided id is displayed or the timeout expires.
+    /// Returns false if presents can not be waited on.
+    bool WaitForPresent(u64 id, u64 timeout_ns);
+
+    /// Returns the id of the last present on the current swapchain, zero if there was none.
+    u64 GetPresentId() const {
+        return present_id;
+    }
+
+    vk::PresentModeKHR GetPresentMode() const {
+        return present_mode;
+    }
+
+    /// Returns true if the surface supports the provided present mode.
+    bool IsPresentModeSupported(vk::PresentModeKHR mode) const;
+
+    /// Recreates the swapchain with a different present mode.
+    void SetPresentMode(vk::PresentModeKHR mode);
+
     vk::SurfaceKHR GetSurface() const {
         return surface;
     }
@@ -119,6 +138,7 @@ private:
     vk::SurfaceFormatKHR surface_format;
     vk::Format view_format;
     vk::PresentModeKHR present_mode;
+    std::vector<vk::PresentModeKHR> present_modes;
     vk::Extent2D extent;
     vk::SurfaceTransformFlagBitsKHR transform;
     vk::CompositeAlphaFlagBitsKHR composite_alpha;
@@ -131,6 +151,7 @@ private:
     u32 image_count = 0;
     u32 image_index = 0;
     u32 frame_index = 0;
+    u64 present_id = 0;
     bool needs_recreation = true;
     bool needs_hdr = false;    // The game requested HDR swapchain
     bool supports_hdr = false; // SC supports HDR output
@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <utility>
+
+#include "common/alignment.h"
+#include "common/assert.h"
+#include "common/debug.h"
+#include "video_core/buffer_cache/buffer.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_platform.h"
+#include "video_core/renderer_vulkan/vk_transfer_scheduler.h"
+
+#include <vk_mem_alloc.h>
+
+namespace Vulkan {
+
+TransferScheduler::TransferScheduler(const Instance& instance_, Scheduler& scheduler)
+    : instance{instance_}, master_semaphore{instance},
+      command_pool{instance, &master_semaphore, vk::CommandBufferLevel::ePrimary,
+                   instance.GetTransferQueueFamilyIndex()} {
+    ring = std::make_unique<VideoCore::Buffer>(instance, scheduler, VideoCore::MemoryUsage::Upload,
+                                               0, vk::BufferUsageFlagBits::eTransferSrc, RingSize);
+    ASSERT_MSG(!ring->mapped_data.empty(), "Transfer upload ring is not host visible");
+    SetObjectName(instance.GetDevice(), ring->Handle(), "TransferRing:{:#x}", RingSize);
+}
+
+TransferScheduler::~TransferScheduler() {
+    // Make sure nothing is still reading the ring before it is destroyed.
+    Submit();
+    master_semaphore.Wait(master_semaphore.CurrentTick() - 1);
+}
+
+std::optional<TransferScheduler::Allocation> TransferScheduler::Map(u64 size) {
+    if (size > RingSize / 2) {
+        return std::nullopt;
+    }
+    constexpr u64 Alignment = 16;
+    write_pos = Common::AlignUp(write_pos, Alignment);
+    if ((write_pos % RingSize) + size > RingSize) {
+        // Allocations never wrap around the end of the ring.
+        write_pos = Common::AlignUp(write_pos, RingSize);
+    }
+    while (write_pos + size > reclaim_pos + RingSize) {
+        if (pending_ranges.empty()) {
+            // The space is still held by copies that were not submitted yet.
+            Submit();
+        }
+        const PendingRange range = pending_ranges.front();
+        pending_ranges.pop();
+        master_semaphore.Wait(range.tick);
+        reclaim_pos = range.end;
+    }
+    const u64 offset = write_pos % RingSize;
+    write_pos += size;
+    return Allocation{ring->mapped_data.data() + offset, offset};
+}
+
+void TransferScheduler::Copy(vk::Buffer dst_buffer, std::span<const vk::BufferCopy> copies) {
+    RENDERER_TRACE;
+    if (!ring->is_coherent) {
+        const auto [min_it, max_it] = std::ranges::minmax_element(
+            copies, {}, [](const vk::BufferCopy& copy) { return copy.srcOffset; });
+        const u64 begin = min_it->srcOffset;
+        const u64 end = max_it->srcOffset + max_it->size;
+        vmaFlushAllocation(instance.GetAllocator(), ring->buffer.allocation, begin, end - begin);
+    }
+    if (!current_cmdbuf) {
+        current_cmdbuf = command_pool.Commit();
+        const vk::CommandBufferBeginInfo begin_info = {
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+        };
+        const auto begin_result = current_cmdbuf.begin(begin_info);
+        ASSERT_MSG(begin_result == vk::Result::eSuccess,
+                   "Failed to begin transfer command buffer: {}", vk::to_string(begin_result));
+    }
+    current_cmdbuf.copyBuffer(ring->Handle(), dst_buffer, copies);
+}
+
+u64 TransferScheduler::Flush() {
+    Submit();
+    return std::exchange(unwaited_tick, 0);
+}
+
+void TransferScheduler::Submit() {
+    if (!current_cmdbuf) {
+        return;
+    }
+    RENDERER_TRACE;
+    const auto end_result = current_cmdbuf.end();
+    ASSERT_MSG(end_result == vk::Result::eSuccess, "Failed to end transfer command buffer: {}",
+               vk::to_string(end_result));
+
+    const u64 signal_value = master_semaphore.NextTick();
+    const vk::Semaphore timeline = master_semaphore.Handle();
+    const vk::TimelineSemaphoreSubmitInfo timeline_si = {
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &signal_value,
+    };
+    const vk::SubmitInfo submit_info = {
+        .pNext = &timeline_si,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &current_cmdbuf,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &timeline,
+    };
+    const auto submit_result = instance.GetTransferQueue().submit(submit_info);
+    ASSERT_MSG(submit_result != vk::Result::eErrorDeviceLost, "Device lost during submit");
+
+    current_cmdbuf = vk::CommandBuffer{};
+    pending_ranges.push({write_pos, signal_value});
+    unwaited_tick = signal_value;
+    master_semaphore.Refresh();
+}
+
+} // namespace Vulkan
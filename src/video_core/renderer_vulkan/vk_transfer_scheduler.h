@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <queue>
+#include <span>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_master_semaphore.h"
+#include "video_core/renderer_vulkan/vk_resource_pool.h"
+
+namespace VideoCore {
+class Buffer;
+}
+
+namespace Vulkan {
+
+class Instance;
+class Scheduler;
+
+/**
+ * Records buffer uploads on the dedicated transfer queue, so they can run on the DMA engine while
+ * the graphics queue is still busy rendering. Copies are batched and the batch is submitted right
+ * before the next graphics submission, which waits for it on the transfer timeline semaphore.
+ * Source data lives in a persistently mapped upload ring that is recycled as transfers complete.
+ */
+class TransferScheduler {
+public:
+    static constexpr u64 RingSize = 256_MB;
+
+    explicit TransferScheduler(const Instance& instance, Scheduler& scheduler);
+    ~TransferScheduler();
+
+    TransferScheduler(const TransferScheduler&) = delete;
+    TransferScheduler& operator=(const TransferScheduler&) = delete;
+
+    struct Allocation {
+        u8* data;
+        u64 offset;
+    };
+
+    /// Reserves space in the upload ring, nullopt if the request does not fit in it.
+    [[nodiscard]] std::optional<Allocation> Map(u64 size);
+
+    /// Records copies from the upload ring to the destination buffer.
+    void Copy(vk::Buffer dst_buffer, std::span<const vk::BufferCopy> copies);
+
+    /// Submits the recorded copies to the transfer queue. Returns the transfer timeline tick the
+    /// next graphics submission has to wait for, zero if no copies were submitted since last call.
+    u64 Flush();
+
+    /// Returns the transfer timeline semaphore.
+    [[nodiscard]] vk::Semaphore Semaphore() const noexcept {
+        return master_semaphore.Handle();
+    }
+
+private:
+    void Submit();
+
+private:
+    const Instance& instance;
+    MasterSemaphore master_semaphore;
+    CommandPool command_pool;
+    std::unique_ptr<VideoCore::Buffer> ring;
+    vk::CommandBuffer current_cmdbuf{};
+    struct PendingRange {
+        u64 end;
+        u64 tick;
+    };
+    std::queue<PendingRange> pending_ranges;
+    u64 write_pos{};
+    u64 reclaim_pos{};
+    u64 unwaited_tick{};
+};
+
+} // namespace Vulkan
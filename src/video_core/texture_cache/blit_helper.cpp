@@ -125,7 +125,7 @@ void BlitHelper::ReinterpretColorAsMsDepth(u32 width, u32 height, u32 num_sample
         CreateColorToMSDepthPipeline(key);
         it = --color_to_ms_depth_pl.end();
     }
-    cmdbuf.bindPipeline(vk::PipelineBindPoint::eGraphics, *it->second);
+    scheduler.BindGraphicsPipeline(*it->second);
 
     const vk::Viewport viewport = {
         .x = 0,
@@ -227,7 +227,7 @@ void BlitHelper::CopyBetweenMsImages(u32 width, u32 height, u32 num_samples,
         CreateMsCopyPipeline(key);
         it = --ms_image_copy_pl.end();
     }
-    cmdbuf.bindPipeline(vk::PipelineBindPoint::eGraphics, *it->second);
+    scheduler.BindGraphicsPipeline(*it->second);
 
     const vk::Viewport viewport = {
         .x = 0,
@@ -82,6 +82,41 @@ UniqueImage::~UniqueImage() {
     }
 }
 
+static vk::PipelineStageFlags2 PipelineStageForAccess(vk::AccessFlags2 access) {
+    constexpr auto transfer_access =
+        vk::AccessFlagBits2::eTransferRead | vk::AccessFlagBits2::eTransferWrite;
+    constexpr auto color_access =
+        vk::AccessFlagBits2::eColorAttachmentRead | vk::AccessFlagBits2::eColorAttachmentWrite;
+    constexpr auto depth_access = vk::AccessFlagBits2::eDepthStencilAttachmentRead |
+                                  vk::AccessFlagBits2::eDepthStencilAttachmentWrite;
+    constexpr auto shader_access = vk::AccessFlagBits2::eShaderRead |
+                                   vk::AccessFlagBits2::eShaderWrite |
+                                   vk::AccessFlagBits2::eShaderSampledRead |
+                                   vk::AccessFlagBits2::eShaderStorageRead |
+                                   vk::AccessFlagBits2::eShaderStorageWrite;
+    if (!access || (access & ~(transfer_access | color_access | depth_access | shader_access))) {
+        return vk::PipelineStageFlagBits2::eAllGraphics |
+               vk::PipelineStageFlagBits2::eComputeShader;
+    }
+    vk::PipelineStageFlags2 stage{};
+    if (access & transfer_access) {
+        stage |= vk::PipelineStageFlagBits2::eTransfer;
+    }
+    if (access & color_access) {
+        stage |= vk::PipelineStageFlagBits2::eColorAttachmentOutput;
+    }
+    if (access & depth_access) {
+        stage |= vk::PipelineStageFlagBits2::eEarlyFragmentTests |
+                 vk::PipelineStageFlagBits2::eLateFragmentTests;
+    }
+    if (access & shader_access) {
+        stage |= vk::PipelineStageFlagBits2::ePreRasterizationShaders |
+                 vk::PipelineStageFlagBits2::eFragmentShader |
+                 vk::PipelineStageFlagBits2::eComputeShader;
+    }
+    return stage;
+}
+
 void UniqueImage::Create(const vk::ImageCreateInfo& image_ci) {
     this->image_ci = image_ci;
     ASSERT(!image);
@@ -103,9 +138,40 @@ void UniqueImage::Create(const vk::ImageCreateInfo& image_ci) {
     image = vk::Image{unsafe_image};
 }
 
+bool UniqueImage::CreateAliasing(const vk::ImageCreateInfo& image_ci, UniqueImage& donor) {
+    ASSERT(!image);
+    if (!donor.allocation) {
+        return false;
+    }
+    const vk::DeviceImageMemoryRequirements image_requirements = {
+        .pCreateInfo = &image_ci,
+    };
+    const auto requirements = device.getImageMemoryRequirements(image_requirements);
+    const auto& memory_requirements = requirements.memoryRequirements;
+    VmaAllocationInfo alloc_info{};
+    vmaGetAllocationInfo(allocator, donor.allocation, &alloc_info);
+    if (memory_requirements.size > alloc_info.size ||
+        alloc_info.offset % memory_requirements.alignment != 0 ||
+        (memory_requirements.memoryTypeBits & (1U << alloc_info.memoryType)) == 0) {
+        return false;
+    }
+
+    const VkImageCreateInfo image_ci_unsafe = static_cast<VkImageCreateInfo>(image_ci);
+    VkImage unsafe_image{};
+    const VkResult result =
+        vmaCreateAliasingImage(allocator, donor.allocation, &image_ci_unsafe, &unsafe_image);
+    if (result != VK_SUCCESS) {
+        return false;
+    }
+    this->image_ci = image_ci;
+    image = vk::Image{unsafe_image};
+    allocation = std::exchange(donor.allocation, VK_NULL_HANDLE);
+    return true;
+}
+
 Image::Image(const Vulkan::Instance& instance_, Vulkan::Scheduler& scheduler_,
              BlitHelper& blit_helper_, Common::SlotVector<ImageView>& slot_image_views_,
-             const ImageInfo& info_)
+             const ImageInfo& info_, UniqueImage* alias_donor)
     : instance{&instance_}, scheduler{&scheduler_}, blit_helper{&blit_helper_},
       slot_image_views{&slot_image_views_}, info{info_} {
     if (info.pixel_format == vk::Format::eUndefined) {
@@ -172,7 +238,9 @@ Image::Image(const Vulkan::Instance& instance_, Vulkan::Scheduler& scheduler_,
     backing = &backing_images.emplace_back();
     backing->num_samples = info.num_samples;
     backing->image = UniqueImage{instance->GetDevice(), instance->GetAllocator()};
-    backing->image.Create(image_ci);
+    if (!alias_donor || !backing->image.CreateAliasing(image_ci, *alias_donor)) {
+        backing->image.Create(image_ci);
+    }
 
     Vulkan::SetObjectName(instance->GetDevice(), GetImage(),
                           "Image {}x{}x{} {} {} {:#x}:{:#x} L:{} M:{} S:{}", info.size.width,
@@ -302,14 +370,8 @@ Image::Barriers Image::GetBarriers(vk::ImageLayout dst_layout, vk::AccessFlags2
 
 void Image::Transit(vk::ImageLayout dst_layout, vk::AccessFlags2 dst_mask,
                     std::optional<SubresourceRange> range, vk::CommandBuffer cmdbuf /*= {}*/) {
-    // Adjust pipieline stage
-    const vk::PipelineStageFlags2 dst_pl_stage =
-        (dst_mask == vk::AccessFlagBits2::eTransferRead ||
-         dst_mask == vk::AccessFlagBits2::eTransferWrite)
-            ? vk::PipelineStageFlagBits2::eTransfer
-            : vk::PipelineStageFlagBits2::eAllGraphics | vk::PipelineStageFlagBits2::eComputeShader;
-
-    const auto barriers = GetBarriers(dst_layout, dst_mask, dst_pl_stage, range);
+    const auto barriers =
+        GetBarriers(dst_layout, dst_mask, PipelineStageForAccess(dst_mask), range);
     if (barriers.empty()) {
         return;
     }
@@ -325,8 +387,17 @@ void Image::Transit(vk::ImageLayout dst_layout, vk::AccessFlags2 dst_mask,
     });
 }
 
+void Image::QueueTransit(vk::ImageLayout dst_layout, vk::AccessFlags2 dst_mask,
+                         std::optional<SubresourceRange> range) {
+    const auto barriers =
+        GetBarriers(dst_layout, dst_mask, PipelineStageForAccess(dst_mask), range);
+    if (!barriers.empty()) {
+        scheduler->DeferBarriers(barriers);
+    }
+}
+
 void Image::Upload(std::span<const vk::BufferImageCopy> upload_copies, vk::Buffer buffer,
-                   u64 offset) {
+                   u64 offset, u64 size) {
     SetBackingSamples(info.num_samples, false);
     scheduler->EndRendering();
 
@@ -337,7 +408,7 @@ void Image::Upload(std::span<const vk::BufferImageCopy> upload_copies, vk::Buffe
         .dstAccessMask = vk::AccessFlagBits2::eTransferRead,
         .buffer = buffer,
         .offset = offset,
-        .size = info.guest_size,
+        .size = size,
     };
     const vk::BufferMemoryBarrier2 post_barrier{
         .srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
@@ -346,7 +417,7 @@ void Image::Upload(std::span<const vk::BufferImageCopy> upload_copies, vk::Buffe
         .dstAccessMask = vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite,
         .buffer = buffer,
         .offset = offset,
-        .size = info.guest_size,
+        .size = size,
     };
     const auto image_barriers =
         GetBarriers(vk::ImageLayout::eTransferDstOptimal, vk::AccessFlagBits2::eTransferWrite,
@@ -685,7 +756,7 @@ void Image::Resolve(Image& src_image, const VideoCore::SubresourceRange& mrt0_ra
 
 void Image::Clear(const vk::ClearValue& clear_value, const VideoCore::SubresourceRange& range) {
     const vk::ImageSubresourceRange vk_range = {
-        .aspectMask = vk::ImageAspectFlagBits::eColor,
+        .aspectMask = aspect_mask,
         .baseMipLevel = range.base.level,
         .levelCount = range.extent.levels,
         .baseArrayLayer = range.base.layer,
@@ -694,8 +765,13 @@ void Image::Clear(const vk::ClearValue& clear_value, const VideoCore::Subresourc
     scheduler->EndRendering();
     Transit(vk::ImageLayout::eTransferDstOptimal, vk::AccessFlagBits2::eTransferWrite, {});
     const auto cmdbuf = scheduler->CommandBuffer();
-    cmdbuf.clearColorImage(GetImage(), vk::ImageLayout::eTransferDstOptimal, clear_value.color,
-                           vk_range);
+    if (info.props.is_depth) {
+        cmdbuf.clearDepthStencilImage(GetImage(), vk::ImageLayout::eTransferDstOptimal,
+                                      clear_value.depthStencil, vk_range);
+    } else {
+        cmdbuf.clearColorImage(GetImage(), vk::ImageLayout::eTransferDstOptimal,
+                               clear_value.color, vk_range);
+    }
 }
 
 void Image::SetBackingSamples(u32 num_samples, bool copy_backing) {
@@ -59,6 +59,10 @@ struct UniqueImage {
 
     void Create(const vk::ImageCreateInfo& image_ci);
 
+    /// Creates the image in the memory of donor and takes ownership of that memory. Returns false
+    /// and leaves donor untouched if the allocation cannot hold the image.
+    bool CreateAliasing(const vk::ImageCreateInfo& image_ci, UniqueImage& donor);
+
     operator vk::Image() const {
         return image;
     }
@@ -81,7 +85,8 @@ class BlitHelper;
 
 struct Image {
     Image(const Vulkan::Instance& instance, Vulkan::Scheduler& scheduler, BlitHelper& blit_helper,
-          Common::SlotVector<ImageView>& slot_image_views, const ImageInfo& info);
+          Common::SlotVector<ImageView>& slot_image_views, const ImageInfo& info,
+          UniqueImage* alias_donor = nullptr);
     ~Image();
 
     Image(const Image&) = delete;
@@ -121,7 +126,11 @@ struct Image {
                          std::optional<SubresourceRange> subres_range);
     void Transit(vk::ImageLayout dst_layout, vk::AccessFlags2 dst_mask,
                  std::optional<SubresourceRange> range, vk::CommandBuffer cmdbuf = {});
-    void Upload(std::span<const vk::BufferImageCopy> upload_copies, vk::Buffer buffer, u64 offset);
+    /// Same as Transit but the barriers are batched with the others of the next draw or dispatch.
+    void QueueTransit(vk::ImageLayout dst_layout, vk::AccessFlags2 dst_mask,
+                      std::optional<SubresourceRange> range);
+    void Upload(std::span<const vk::BufferImageCopy> upload_copies, vk::Buffer buffer, u64 offset,
+                u64 size);
     void Download(std::span<const vk::BufferImageCopy> download_copies, vk::Buffer buffer,
                   u64 offset, u64 download_size);
 
@@ -167,6 +176,8 @@ public:
     std::deque<BackingImage> backing_images;
     BackingImage* backing{};
     boost::container::static_vector<u64, 16> mip_hashes{};
+    /// Hashes of the row bands of a linear image as of its last upload.
+    std::vector<u64> band_hashes;
     u64 lru_id{};
     u64 tick_accessed_last{};
     u64 hash{};
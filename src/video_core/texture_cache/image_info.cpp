@@ -145,6 +145,21 @@ ImageInfo::ImageInfo(const AmdGpu::Image& image, const Shader::ImageResource& de
     UpdateSize();
 }
 
+ImageInfo::ImageInfo(VAddr cpu_address, vk::Format format, u32 num_bits_, u32 width, u32 height,
+                     u32 pitch_) noexcept {
+    tile_mode = AmdGpu::TileMode::DisplayLinearAligned;
+    array_mode = AmdGpu::GetArrayMode(tile_mode);
+    pixel_format = format;
+    type = AmdGpu::ImageType::Color2D;
+    size.width = width;
+    size.height = height;
+    pitch = pitch_;
+    num_bits = num_bits_;
+
+    guest_address = cpu_address;
+    UpdateSize();
+}
+
 bool ImageInfo::IsCompatible(const ImageInfo& info) const {
     return (pixel_format == info.pixel_format && num_samples == info.num_samples &&
             num_bits == info.num_bits);
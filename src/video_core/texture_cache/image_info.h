@@ -42,6 +42,9 @@ struct ImageInfo {
     ImageInfo(const AmdGpu::DepthBuffer& buffer, u32 num_slices, VAddr htile_address,
               AmdGpu::CbDbExtent hint, bool write_buffer = false) noexcept;
     ImageInfo(const AmdGpu::Image& image, const Shader::ImageResource& desc) noexcept;
+    /// Linear 2D image written by the host, such as a plane of a decoded video frame.
+    ImageInfo(VAddr cpu_address, vk::Format format, u32 num_bits, u32 width, u32 height,
+              u32 pitch) noexcept;
 
     bool IsTiled() const {
         return tile_mode != AmdGpu::TileMode::DisplayLinearAligned;
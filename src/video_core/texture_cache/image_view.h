@@ -53,6 +53,9 @@ struct ImageView {
 
     ImageViewInfo info;
     vk::UniqueImageView image_view;
+    /// Texture heap slot holding a descriptor of this view, written in heap_layout.
+    u32 heap_slot{~0U};
+    vk::ImageLayout heap_layout{};
 };
 
 } // namespace VideoCore
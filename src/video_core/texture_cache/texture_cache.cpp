@@ -1,15 +1,18 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include <cstring>
 #include <xxhash.h>
 
 #include "common/assert.h"
 #include "common/config.h"
 #include "common/debug.h"
 #include "common/scope_exit.h"
+#include "core/debug_state.h"
 #include "core/memory.h"
 #include "video_core/buffer_cache/buffer_cache.h"
 #include "video_core/page_manager.h"
+#include "video_core/renderer_vulkan/vk_descriptor_buffer.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
 #include "video_core/texture_cache/host_compatibility.h"
@@ -26,20 +29,45 @@ TextureCache::TextureCache(const Vulkan::Instance& instance_, Vulkan::Scheduler&
                            PageManager& tracker_)
     : instance{instance_}, scheduler{scheduler_}, liverpool{liverpool_},
       buffer_cache{buffer_cache_}, tracker{tracker_}, blit_helper{instance, scheduler},
-      tile_manager{instance, scheduler, buffer_cache.GetUtilityBuffer(MemoryUsage::Stream)} {
+      tile_manager{instance, scheduler, buffer_cache.GetUtilityBuffer(MemoryUsage::Stream)},
+      video_converter{instance, scheduler, buffer_cache.GetUtilityBuffer(MemoryUsage::Stream)} {
     // Create basic null image at fixed image ID.
     const auto null_id = GetNullImage(vk::Format::eR8G8B8A8Unorm);
     ASSERT(null_id.index == NULL_IMAGE_ID.index);
 
+    if (Config::isBindlessTexturesEnabled()) {
+        // Descriptor buffer pipelines cannot bind descriptor sets allocated from pools.
+        if (Config::isDescriptorBufferEnabled() &&
+            Vulkan::DescriptorBuffer::IsSupported(instance)) {
+            LOG_WARNING(Render_Vulkan, "Bindless textures are not supported with descriptor "
+                                       "buffers and are disabled");
+        } else if (!TextureHeap::IsSupported(instance)) {
+            LOG_WARNING(Render_Vulkan, "Descriptor indexing is not supported, bindless textures "
+                                       "are disabled");
+        } else {
+            texture_heap = std::make_unique<TextureHeap>(instance, scheduler);
+        }
+    }
+
     // Set up garbage collection parameters.
-    if (!instance.CanReportMemoryUsage()) {
+    if (instance.CanReportMemoryUsage()) {
+        UpdateGcThresholds(instance.GetTotalMemoryBudget());
+    } else {
         trigger_gc_memory = 0;
         pressure_gc_memory = DEFAULT_PRESSURE_GC_MEMORY;
         critical_gc_memory = DEFAULT_CRITICAL_GC_MEMORY;
-        return;
     }
 
-    const s64 device_local_memory = static_cast<s64>(instance.GetTotalMemoryBudget());
+    downloaded_images_thread =
+        std::jthread([&](const std::stop_token& token) { DownloadedImagesThread(token); });
+}
+
+void TextureCache::UpdateGcThresholds(u64 budget) {
+    if (budget == memory_budget) {
+        return;
+    }
+    memory_budget = budget;
+    const s64 device_local_memory = static_cast<s64>(budget);
     const s64 min_spacing_expected = device_local_memory - 1_GB;
     const s64 min_spacing_critical = device_local_memory - 512_MB;
     const s64 mem_threshold = std::min<s64>(device_local_memory, TARGET_GC_THRESHOLD);
@@ -52,9 +80,14 @@ TextureCache::TextureCache(const Vulkan::Instance& instance_, Vulkan::Scheduler&
         std::max<u64>(std::min(device_local_memory - min_vacancy_critical, min_spacing_critical),
                       DEFAULT_CRITICAL_GC_MEMORY));
     trigger_gc_memory = static_cast<u64>((device_local_memory - mem_threshold) / 2);
+}
 
-    downloaded_images_thread =
-        std::jthread([&](const std::stop_token& token) { DownloadedImagesThread(token); });
+void TextureCache::PublishMemoryStats() const {
+    auto& stats = DebugState.texture_cache_memory;
+    stats.device_usage.store(total_used_memory, std::memory_order_relaxed);
+    stats.device_budget.store(memory_budget, std::memory_order_relaxed);
+    stats.image_memory.store(image_memory, std::memory_order_relaxed);
+    stats.num_images.store(static_cast<u32>(lru_cache.Size()), std::memory_order_relaxed);
 }
 
 TextureCache::~TextureCache() = default;
@@ -99,6 +132,10 @@ void TextureCache::DownloadImageMemory(ImageId image_id) {
         return;
     }
     auto& download_buffer = buffer_cache.GetUtilityBuffer(MemoryUsage::Download);
+    if (image.info.props.is_tiled) {
+        DownloadTiledImageMemory(image, download_buffer);
+        return;
+    }
     const u32 download_size = image.info.pitch * image.info.size.height *
                               image.info.resources.layers * (image.info.num_bits / 8);
     ASSERT(download_size <= image.info.guest_size);
@@ -133,6 +170,55 @@ void TextureCache::DownloadImageMemory(ImageId image_id) {
     }
 }
 
+void TextureCache::DownloadTiledImageMemory(Image& image, StreamBuffer& download_buffer) {
+    // Retile on the GPU straight into the staging buffer, so the guest layout can be copied
+    // back as is. Only the base level is tracked as GPU modified.
+    const auto& mip = image.info.mips_layout[0];
+    const auto [download, offset] = download_buffer.Map(image.info.guest_size);
+    download_buffer.Commit();
+    std::array<vk::BufferImageCopy, 1> image_download = {{{
+        .bufferOffset = 0,
+        .bufferRowLength = mip.pitch,
+        .bufferImageHeight = mip.height,
+        .imageSubresource =
+            {
+                .aspectMask = image.info.props.is_depth ? vk::ImageAspectFlagBits::eDepth
+                                                        : vk::ImageAspectFlagBits::eColor,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = image.info.resources.layers,
+            },
+        .imageOffset = {0, 0, 0},
+        .imageExtent = {image.info.size.width, image.info.size.height,
+                        image.info.props.is_volume ? image.info.size.depth : 1},
+    }}};
+    scheduler.EndRendering();
+    tile_manager.TileImage(image, image_download, download_buffer.Handle(),
+                           static_cast<u32>(offset), mip.size);
+
+    const vk::BufferMemoryBarrier2 host_barrier = {
+        .srcStageMask = vk::PipelineStageFlagBits2::eComputeShader,
+        .srcAccessMask = vk::AccessFlagBits2::eShaderWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eHost,
+        .dstAccessMask = vk::AccessFlagBits2::eHostRead,
+        .buffer = download_buffer.Handle(),
+        .offset = offset,
+        .size = image.info.guest_size,
+    };
+    scheduler.CommandBuffer().pipelineBarrier2(vk::DependencyInfo{
+        .bufferMemoryBarrierCount = 1,
+        .pBufferMemoryBarriers = &host_barrier,
+    });
+
+    {
+        std::unique_lock lock(downloaded_images_mutex);
+        downloaded_images_queue.emplace(scheduler.CurrentTick(),
+                                        image.info.guest_address + mip.offset,
+                                        download + mip.offset, mip.size);
+        downloaded_images_cv.notify_one();
+    }
+}
+
 void TextureCache::DownloadedImagesThread(const std::stop_token& token) {
     auto* memory = Core::Memory::Instance();
     while (!token.stop_requested()) {
@@ -165,6 +251,11 @@ void TextureCache::MarkAsMaybeDirty(ImageId image_id, Image& image) {
 }
 
 void TextureCache::InvalidateMemory(VAddr addr, size_t size) {
+    // Faults on pages that only buffers watch must not wait for the GPU thread to release the
+    // cache mutex.
+    if (!IsRegionRegistered(addr, size)) {
+        return;
+    }
     std::scoped_lock lock{mutex};
     const auto pages_start = PageManager::GetPageAddr(addr);
     const auto pages_end = PageManager::GetNextPageAddr(addr + size - 1);
@@ -195,6 +286,17 @@ void TextureCache::InvalidateMemory(VAddr addr, size_t size) {
     });
 }
 
+bool TextureCache::IsRegionRegistered(VAddr addr, size_t size) const {
+    const u64 page_end = (addr + size - 1) >> Traits::PageBits;
+    for (u64 page = addr >> Traits::PageBits; page <= page_end; ++page) {
+        const PageData* const entry = page_table.find(page);
+        if (entry && entry->num_images.load(std::memory_order_acquire) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 void TextureCache::InvalidateMemoryFromGPU(VAddr address, size_t max_size) {
     std::scoped_lock lock{mutex};
     ForEachImageInRegion(address, max_size, [&](ImageId image_id, Image& image) {
@@ -314,6 +416,7 @@ std::tuple<ImageId, int, int> TextureCache::ResolveOverlap(const ImageInfo& imag
                                                            BindingType binding,
                                                            ImageId cache_image_id,
                                                            ImageId merged_image_id) {
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::ImageOverlaps);
     auto& cache_image = slot_images[cache_image_id];
     const bool safe_to_delete =
         scheduler.CurrentTick() - cache_image.tick_accessed_last > NumFramesBeforeRemoval;
@@ -326,7 +429,7 @@ std::tuple<ImageId, int, int> TextureCache::ResolveOverlap(const ImageInfo& imag
             lhs_block_size != rhs_block_size) {
             // Very likely this kind of overlap is caused by allocation from a pool.
             if (safe_to_delete) {
-                FreeImage(cache_image_id);
+                RecycleImageMemory(cache_image_id);
             }
             return {merged_image_id, -1, -1};
         }
@@ -366,7 +469,7 @@ std::tuple<ImageId, int, int> TextureCache::ResolveOverlap(const ImageInfo& imag
         // Likely the address is reused for a image with a different tiling mode.
         if (image_info.tile_mode != cache_image.info.tile_mode) {
             if (safe_to_delete) {
-                FreeImage(cache_image_id);
+                RecycleImageMemory(cache_image_id);
             }
             return {merged_image_id, -1, -1};
         }
@@ -417,6 +520,25 @@ std::tuple<ImageId, int, int> TextureCache::ResolveOverlap(const ImageInfo& imag
     return {merged_image_id, -1, -1};
 }
 
+void TextureCache::RecycleImageMemory(ImageId image_id) {
+    auto& image = slot_images[image_id];
+    // The new image starts out undefined, so the memory can only be handed over once the gpu is
+    // done with the old one.
+    if (image.backing_images.size() == 1 && scheduler.IsFree(image.tick_accessed_last)) {
+        ReleaseAliasDonor();
+        alias_donor = std::move(image.backing->image);
+    }
+    FreeImage(image_id);
+}
+
+void TextureCache::ReleaseAliasDonor() {
+    if (!alias_donor) {
+        return;
+    }
+    // Image views of the donor are reclaimed by a deferred operation as well.
+    scheduler.DeferOperation([donor = std::move(alias_donor)] {});
+}
+
 ImageId TextureCache::ExpandImage(const ImageInfo& info, ImageId image_id) {
     const auto new_image_id =
         slot_images.insert(instance, scheduler, blit_helper, slot_image_views, info);
@@ -508,9 +630,11 @@ ImageId TextureCache::FindImage(ImageDesc& desc, bool exact_fmt) {
     }
     // Create and register a new image
     if (!image_id) {
-        image_id = slot_images.insert(instance, scheduler, blit_helper, slot_image_views, info);
+        image_id = slot_images.insert(instance, scheduler, blit_helper, slot_image_views, info,
+                                      &alias_donor);
         RegisterImage(image_id);
     }
+    ReleaseAliasDonor();
 
     Image& image = slot_images[image_id];
     image.tick_accessed_last = scheduler.CurrentTick();
@@ -527,6 +651,48 @@ ImageId TextureCache::FindImage(ImageDesc& desc, bool exact_fmt) {
     return image_id;
 }
 
+ImageId TextureCache::FindTextureImage(const AmdGpu::Image& image,
+                                       const Shader::ImageResource& image_desc, ImageDesc& desc) {
+    if (image.Address() == 0) [[unlikely]] {
+        desc = ImageDesc{image, image_desc};
+        return FindImage(desc);
+    }
+
+    // Besides the T# the descriptor depends only on the resource bits below.
+    const u32 flags = static_cast<u32>(image_desc.is_written) |
+                      static_cast<u32>(image_desc.is_depth) << 1 |
+                      static_cast<u32>(image_desc.is_array) << 2;
+    const u64 hash = XXH3_64bits_withSeed(&image, sizeof(image), flags);
+    auto& lookup = texture_lookups[hash % NumTextureLookups];
+    {
+        std::scoped_lock lock{mutex};
+        if (lookup.epoch == image_epoch && lookup.flags == flags &&
+            std::memcmp(&lookup.image, &image, sizeof(image)) == 0) {
+            desc = lookup.desc;
+            Image& cached_image = slot_images[lookup.image_id];
+            cached_image.tick_accessed_last = scheduler.CurrentTick();
+            TouchImage(cached_image);
+            return lookup.image_id;
+        }
+    }
+
+    desc = ImageDesc{image, image_desc};
+    const u64 epoch = image_epoch;
+    const ImageId image_id = FindImage(desc);
+
+    // Images registered by the lookup itself change the epoch, such results are cached the next
+    // time the same T# is bound.
+    std::scoped_lock lock{mutex};
+    lookup = TextureLookup{
+        .image = image,
+        .flags = flags,
+        .epoch = epoch,
+        .image_id = image_id,
+        .desc = desc,
+    };
+    return image_id;
+}
+
 ImageId TextureCache::FindImageFromRange(VAddr address, size_t size, bool ensure_valid) {
     ImageIds image_ids;
     ForEachImageInRegion(address, size, [&](ImageId image_id, Image& image) {
@@ -561,7 +727,7 @@ ImageView& TextureCache::FindTexture(ImageId image_id, const ImageDesc& desc) {
     Image& image = slot_images[image_id];
     if (desc.type == BindingType::Storage) {
         image.flags |= ImageFlagBits::GpuModified;
-        if (Config::readbackLinearImages() && !image.info.props.is_tiled &&
+        if (Config::GetSnapshot().readback_linear_images && !image.info.props.is_tiled &&
             image.info.guest_address != 0) {
             download_images.emplace(image_id);
         }
@@ -573,7 +739,7 @@ ImageView& TextureCache::FindTexture(ImageId image_id, const ImageDesc& desc) {
 ImageView& TextureCache::FindRenderTarget(ImageId image_id, const ImageDesc& desc) {
     Image& image = slot_images[image_id];
     image.flags |= ImageFlagBits::GpuModified;
-    if (Config::readbackLinearImages() && !image.info.props.is_tiled) {
+    if (Config::GetSnapshot().readback_linear_images && !image.info.props.is_tiled) {
         download_images.emplace(image_id);
     }
     image.usage.render_target = 1u;
@@ -635,6 +801,29 @@ ImageView& TextureCache::FindDepthTarget(ImageId image_id, const ImageDesc& desc
     return image.FindView(desc.view_info, false);
 }
 
+void TextureCache::UploadVideoFrame(const VideoFrame& frame) {
+    ImageDesc luma_desc{ImageInfo{frame.address, vk::Format::eR8Unorm, 8, frame.width,
+                                  frame.height, frame.pitch}};
+    ImageDesc chroma_desc{ImageInfo{frame.address + frame.chroma_offset, vk::Format::eR8G8Unorm,
+                                    16, (frame.width + 1) / 2, (frame.height + 1) / 2,
+                                    frame.pitch / 2}};
+    const ImageId luma_id = FindImage(luma_desc);
+    const ImageId chroma_id = FindImage(chroma_desc);
+
+    std::scoped_lock lock{mutex};
+    video_converter.Convert(frame, slot_images[luma_id], slot_images[chroma_id]);
+    for (const ImageId image_id : {luma_id, chroma_id}) {
+        Image& image = slot_images[image_id];
+        // The frame replaces the whole image, older guest memory contents do not matter.
+        image.flags &= ~ImageFlagBits::Dirty;
+        image.flags |= ImageFlagBits::GpuModified;
+        TrackImage(image_id);
+        if (Config::GetSnapshot().readback_linear_images) {
+            download_images.emplace(image_id);
+        }
+    }
+}
+
 void TextureCache::RefreshImage(Image& image) {
     if (False(image.flags & ImageFlagBits::Dirty) || image.info.num_samples > 1) {
         return;
@@ -664,6 +853,19 @@ void TextureCache::RefreshImage(Image& image) {
     const u32 num_mips = image.info.resources.levels;
     const bool is_gpu_modified = True(image.flags & ImageFlagBits::GpuModified);
     const bool is_gpu_dirty = True(image.flags & ImageFlagBits::GpuDirty);
+    const u8* guest_memory = std::bit_cast<u8*>(image.info.guest_address);
+
+    // Rows of large linear images are contiguous in guest memory, so they are split in bands and
+    // only the bands whose contents changed since the last upload are refreshed.
+    const bool is_banded = !is_gpu_dirty && !image.info.props.is_tiled &&
+                           !image.info.props.is_volume && num_layers == 1 &&
+                           image.info.guest_size >= BANDED_UPLOAD_THRESHOLD;
+    if (!is_banded) {
+        image.band_hashes.clear();
+    }
+    u32 upload_begin = is_banded ? image.info.guest_size : 0;
+    u32 upload_end = is_banded ? 0 : image.info.guest_size;
+    u32 band_index = 0;
 
     boost::container::small_vector<vk::BufferImageCopy, 14> image_copies;
     for (u32 m = 0; m < num_mips; m++) {
@@ -672,19 +874,65 @@ void TextureCache::RefreshImage(Image& image) {
         const u32 depth =
             image.info.props.is_volume ? std::max(image.info.size.depth >> m, 1u) : 1u;
         const auto [mip_size, mip_pitch, mip_height, mip_offset] = image.info.mips_layout[m];
+        const u32 extent_width = mip_pitch ? std::min(mip_pitch, width) : width;
+        const u32 extent_height = mip_height ? std::min(mip_height, height) : height;
+
+        if (is_banded) {
+            const u32 block_size = image.info.props.is_block ? 4 : 1;
+            const u32 row_size = mip_pitch / block_size * image.info.num_bits / 8;
+            const u32 num_rows = mip_size / row_size;
+            const u32 band_rows = std::max(UPLOAD_BAND_SIZE / row_size, 1u);
+            bool is_prev_dirty = false;
+            for (u32 row = 0; row < num_rows; row += band_rows, ++band_index) {
+                const u32 rows = std::min(band_rows, num_rows - row);
+                const u32 band_offset = mip_offset + row * row_size;
+                const u64 hash = XXH3_64bits(guest_memory + band_offset, rows * row_size);
+                if (band_index == image.band_hashes.size()) {
+                    image.band_hashes.push_back(~hash);
+                }
+                if (std::exchange(image.band_hashes[band_index], hash) == hash) {
+                    is_prev_dirty = false;
+                    continue;
+                }
+                const u32 y = row * block_size;
+                if (y >= extent_height) {
+                    // Padding rows past the end of the mip.
+                    continue;
+                }
+                const u32 band_height = std::min(rows * block_size, extent_height - y);
+                upload_begin = std::min(upload_begin, band_offset);
+                upload_end = std::max(upload_end, band_offset + rows * row_size);
+                if (is_prev_dirty) {
+                    image_copies.back().imageExtent.height += band_height;
+                    continue;
+                }
+                is_prev_dirty = true;
+                image_copies.push_back({
+                    .bufferOffset = band_offset,
+                    .bufferRowLength = mip_pitch,
+                    .bufferImageHeight = 0,
+                    .imageSubresource{
+                        .aspectMask = image.aspect_mask & ~vk::ImageAspectFlagBits::eStencil,
+                        .mipLevel = m,
+                        .baseArrayLayer = 0,
+                        .layerCount = 1,
+                    },
+                    .imageOffset = {0, static_cast<s32>(y), 0},
+                    .imageExtent = {extent_width, band_height, 1},
+                });
+            }
+            continue;
+        }
 
         // Protect GPU modified resources from accidental CPU reuploads.
         if (is_gpu_modified && !is_gpu_dirty) {
-            const u8* addr = std::bit_cast<u8*>(image.info.guest_address);
-            const u64 hash = XXH3_64bits(addr + mip_offset, mip_size);
+            const u64 hash = XXH3_64bits(guest_memory + mip_offset, mip_size);
             if (image.mip_hashes[m] == hash) {
                 continue;
             }
             image.mip_hashes[m] = hash;
         }
 
-        const u32 extent_width = mip_pitch ? std::min(mip_pitch, width) : width;
-        const u32 extent_height = mip_height ? std::min(mip_height, height) : height;
         image_copies.push_back({
             .bufferOffset = mip_offset,
             .bufferRowLength = mip_pitch,
@@ -704,11 +952,16 @@ void TextureCache::RefreshImage(Image& image) {
         image.flags &= ~ImageFlagBits::Dirty;
         return;
     }
+    DebugState.AddStall(DebugStateType::StallCause::ImageUpload);
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::ImageUploads);
+    const u32 upload_size = upload_end - upload_begin;
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::ImageUploadBytes,
+                                     upload_size);
 
     scheduler.EndRendering();
 
     const auto [in_buffer, in_offset] =
-        buffer_cache.ObtainBufferForImage(image.info.guest_address, image.info.guest_size);
+        buffer_cache.ObtainBufferForImage(image.info.guest_address + upload_begin, upload_size);
     if (auto barrier = in_buffer->GetBarrier(vk::AccessFlagBits2::eTransferRead,
                                              vk::PipelineStageFlagBits2::eTransfer)) {
         scheduler.CommandBuffer().pipelineBarrier2(vk::DependencyInfo{
@@ -721,15 +974,16 @@ void TextureCache::RefreshImage(Image& image) {
     const auto [buffer, offset] =
         tile_manager.DetileImage(in_buffer->Handle(), in_offset, image.info);
     for (auto& copy : image_copies) {
-        copy.bufferOffset += offset;
+        copy.bufferOffset = copy.bufferOffset - upload_begin + offset;
     }
 
-    image.Upload(image_copies, buffer, offset);
+    image.Upload(image_copies, buffer, offset, upload_size);
 }
 
 vk::Sampler TextureCache::GetSampler(const AmdGpu::Sampler& sampler,
                                      AmdGpu::BorderColorBuffer border_color_base) {
-    const u64 hash = XXH3_64bits(&sampler, sizeof(sampler));
+    // Border colors read from the table depend on its base address as well.
+    const u64 hash = XXH3_64bits_withSeed(&sampler, sizeof(sampler), border_color_base.base_addr);
     const auto [it, new_sampler] = samplers.try_emplace(hash, instance, sampler, border_color_base);
     return it->second.Handle();
 }
@@ -738,11 +992,20 @@ void TextureCache::RegisterImage(ImageId image_id) {
     Image& image = slot_images[image_id];
     ASSERT_MSG(False(image.flags & ImageFlagBits::Registered),
                "Trying to register an already registered image");
+    DebugState.renderer_counters.Add(DebugStateType::RendererCounter::ImagesCreated);
     image.flags |= ImageFlagBits::Registered;
+    ++image_epoch;
     total_used_memory += Common::AlignUp(image.info.guest_size, 1024);
+    image_memory += Common::AlignUp(image.info.guest_size, 1024);
+    Core::Memory::Instance()->TrackHostMirror(Core::HostMirror::TextureCache,
+                                              Common::AlignUp(image.info.guest_size, 1024));
     image.lru_id = lru_cache.Insert(image_id, gc_tick);
     ForEachPage(image.info.guest_address, image.info.guest_size,
-                [this, image_id](u64 page) { page_table[page].push_back(image_id); });
+                [this, image_id](u64 page) {
+                    PageData& entry = page_table[page];
+                    entry.image_ids.push_back(image_id);
+                    entry.num_images.fetch_add(1, std::memory_order_release);
+                });
 }
 
 void TextureCache::UnregisterImage(ImageId image_id) {
@@ -750,21 +1013,27 @@ void TextureCache::UnregisterImage(ImageId image_id) {
     ASSERT_MSG(True(image.flags & ImageFlagBits::Registered),
                "Trying to unregister an already unregistered image");
     image.flags &= ~ImageFlagBits::Registered;
+    ++image_epoch;
     lru_cache.Free(image.lru_id);
     total_used_memory -= Common::AlignUp(image.info.guest_size, 1024);
+    image_memory -= Common::AlignUp(image.info.guest_size, 1024);
+    Core::Memory::Instance()->TrackHostMirror(
+        Core::HostMirror::TextureCache,
+        -static_cast<s64>(Common::AlignUp(image.info.guest_size, 1024)));
     ForEachPage(image.info.guest_address, image.info.guest_size, [this, image_id](u64 page) {
         const auto page_it = page_table.find(page);
         if (page_it == nullptr) {
             UNREACHABLE_MSG("Unregistering unregistered page=0x{:x}", page << PageShift);
             return;
         }
-        auto& image_ids = *page_it;
+        auto& image_ids = page_it->image_ids;
         const auto vector_it = std::ranges::find(image_ids, image_id);
         if (vector_it == image_ids.end()) {
             ASSERT_MSG(false, "Unregistering unregistered image in page=0x{:x}", page << PageShift);
             return;
         }
         image_ids.erase(vector_it);
+        page_it->num_images.fetch_sub(1, std::memory_order_release);
     });
 }
 
@@ -878,10 +1147,14 @@ void TextureCache::UntrackImageTail(ImageId image_id) {
 
 void TextureCache::RunGarbageCollector() {
     SCOPE_EXIT {
+        PublishMemoryStats();
         ++gc_tick;
     };
     if (instance.CanReportMemoryUsage()) {
-        total_used_memory = instance.GetDeviceMemoryUsage();
+        // The budget moves with the memory other processes use, so follow it every run.
+        const auto status = instance.GetDeviceMemoryStatus();
+        total_used_memory = status.usage;
+        UpdateGcThresholds(status.budget);
     }
     if (total_used_memory < trigger_gc_memory) {
         return;
@@ -898,6 +1171,12 @@ void TextureCache::RunGarbageCollector() {
         ticks_to_destroy = aggresive ? 160 : pressured ? 80 : 16;
         ticks_to_destroy = std::min(ticks_to_destroy, gc_tick);
         num_deletions = aggresive ? 40 : pressured ? 20 : 10;
+        if (allow_aggressive && memory_budget != 0 && total_used_memory >= memory_budget) {
+            // Past the budget the driver starts paging to system memory, which is far worse
+            // than recreating images. Evict anything that was not used recently.
+            ticks_to_destroy = std::min<u64>(NumFramesBeforeRemoval, gc_tick);
+            num_deletions = 80;
+        }
     };
     const auto clean_up = [&](ImageId image_id) {
         if (num_deletions == 0) {
@@ -918,6 +1197,8 @@ void TextureCache::RunGarbageCollector() {
             DownloadImageMemory(image_id);
         }
         FreeImage(image_id);
+        DebugState.texture_cache_memory.num_evicted.fetch_add(1, std::memory_order_relaxed);
+        DebugState.AddStall(DebugStateType::StallCause::ImageEviction);
         if (total_used_memory < critical_gc_memory) {
             if (aggresive) {
                 num_deletions >>= 2;
@@ -943,6 +1224,17 @@ void TextureCache::RunGarbageCollector() {
     }
 }
 
+u32 TextureCache::GetHeapSlot(ImageView& image_view, vk::ImageLayout layout) {
+    if (image_view.heap_slot != TextureHeap::InvalidSlot && image_view.heap_layout == layout) {
+        return image_view.heap_slot;
+    }
+    // Descriptors carry the layout the image is sampled in, another layout needs a new slot.
+    texture_heap->Release(image_view.heap_slot);
+    image_view.heap_slot = texture_heap->Allocate(*image_view.image_view, layout);
+    image_view.heap_layout = layout;
+    return image_view.heap_slot;
+}
+
 void TextureCache::TouchImage(const Image& image) {
     lru_cache.Touch(image.lru_id, gc_tick);
 }
@@ -969,6 +1261,9 @@ void TextureCache::DeleteImage(ImageId image_id) {
         Image& image = slot_images[image_id];
         for (auto& backing : image.backing_images) {
             for (const ImageViewId image_view_id : backing.image_view_ids) {
+                if (texture_heap) {
+                    texture_heap->Release(slot_image_views[image_view_id].heap_slot);
+                }
                 slot_image_views.erase(image_view_id);
             }
         }
@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
@@ -11,6 +13,7 @@
 #include <queue>
 #include <tsl/robin_map.h>
 
+#include "common/debug.h"
 #include "common/lru_cache.h"
 #include "common/slot_vector.h"
 #include "shader_recompiler/resource.h"
@@ -19,7 +22,9 @@
 #include "video_core/texture_cache/image.h"
 #include "video_core/texture_cache/image_view.h"
 #include "video_core/texture_cache/sampler.h"
+#include "video_core/texture_cache/texture_heap.h"
 #include "video_core/texture_cache/tile_manager.h"
+#include "video_core/texture_cache/video_converter.h"
 
 namespace AmdGpu {
 struct Liverpool;
@@ -36,10 +41,20 @@ class TextureCache {
     static constexpr s64 DEFAULT_CRITICAL_GC_MEMORY = 3_GB;
     static constexpr s64 TARGET_GC_THRESHOLD = 8_GB;
 
+    // Linear images at least this large are refreshed in bands of rows of about this size.
+    static constexpr u32 BANDED_UPLOAD_THRESHOLD = 1_MB;
+    static constexpr u32 UPLOAD_BAND_SIZE = 64_KB;
+
     using ImageIds = boost::container::small_vector<ImageId, 16>;
 
+    struct PageData {
+        ImageIds image_ids;
+        // Read without locks by the fault handlers, written under the cache mutex.
+        std::atomic<u32> num_images{};
+    };
+
     struct Traits {
-        using Entry = ImageIds;
+        using Entry = PageData;
         static constexpr size_t AddressSpaceBits = 40;
         static constexpr size_t FirstLevelBits = 10;
         static constexpr size_t PageBits = 20;
@@ -73,6 +88,7 @@ public:
               view_info{buffer, view, ctl}, type{BindingType::DepthTarget} {}
         ImageDesc(const Libraries::VideoOut::BufferAttributeGroup& group, VAddr cpu_address)
             : info{group, cpu_address}, type{BindingType::VideoOut} {}
+        explicit ImageDesc(const ImageInfo& info_) : info{info_} {}
     };
 
 public:
@@ -87,6 +103,10 @@ public:
     /// Invalidates any image in the logical page range.
     void InvalidateMemory(VAddr addr, size_t size);
 
+    /// Returns true if an image is registered in the pages of the range, can be called without
+    /// holding the cache mutex.
+    [[nodiscard]] bool IsRegionRegistered(VAddr addr, size_t size) const;
+
     /// Marks an image as dirty if it exists at the provided address.
     void InvalidateMemoryFromGPU(VAddr address, size_t max_size);
 
@@ -99,6 +119,12 @@ public:
     /// Retrieves the image handle of the image with the provided attributes.
     [[nodiscard]] ImageId FindImage(ImageDesc& desc, bool exact_fmt = false);
 
+    /// Retrieves the image sampled by a shader texture binding and fills its descriptor. The
+    /// lookup of an identical T# is reused as long as no image was registered or unregistered.
+    [[nodiscard]] ImageId FindTextureImage(const AmdGpu::Image& image,
+                                           const Shader::ImageResource& image_desc,
+                                           ImageDesc& desc);
+
     /// Retrieves image whose address matches provided
     [[nodiscard]] ImageId FindImageFromRange(VAddr address, size_t size, bool ensure_valid = true);
 
@@ -111,6 +137,10 @@ public:
     /// Retrieves the depth target with specified properties
     [[nodiscard]] ImageView& FindDepthTarget(ImageId image_id, const ImageDesc& desc);
 
+    /// Writes a decoded video frame into the images backing its guest frame buffer, the guest
+    /// memory itself is left untouched.
+    void UploadVideoFrame(const VideoFrame& frame);
+
     /// Updates image contents if it was modified by CPU.
     void UpdateImage(ImageId image_id) {
         std::scoped_lock lock{mutex};
@@ -152,6 +182,15 @@ public:
         return slot_image_views[id];
     }
 
+    /// Returns the bindless texture heap, null if it is not enabled.
+    [[nodiscard]] TextureHeap* GetTextureHeap() const noexcept {
+        return texture_heap.get();
+    }
+
+    /// Returns the texture heap slot of an image view sampled in the provided layout, writing
+    /// its descriptor if it is not in the heap yet.
+    [[nodiscard]] u32 GetHeapSlot(ImageView& image_view, vk::ImageLayout layout);
+
     /// Returns true if the specified address is a metadata surface.
     bool IsMeta(VAddr address) const {
         return surface_metas.contains(address);
@@ -176,6 +215,18 @@ public:
         return false;
     }
 
+    /// Copies the clear state between two metadata surfaces of the same type.
+    bool CopyMeta(VAddr dst_address, VAddr src_address) {
+        const auto src_it = surface_metas.find(src_address);
+        auto dst_it = surface_metas.find(dst_address);
+        if (src_it == surface_metas.end() || dst_it == surface_metas.end() ||
+            src_it->second.type != dst_it->second.type) {
+            return false;
+        }
+        dst_it.value().clear_mask = src_it->second.clear_mask;
+        return true;
+    }
+
     /// Updates the state of a slice of the specified metadata surface.
     bool TouchMeta(VAddr address, u32 slice, bool is_clear) {
         auto it = surface_metas.find(address);
@@ -207,7 +258,7 @@ public:
                     return;
                 }
             }
-            for (const ImageId image_id : *it) {
+            for (const ImageId image_id : it->image_ids) {
                 Image& image = slot_images[image_id];
                 if (image.flags & ImageFlagBits::Picked) {
                     continue;
@@ -257,6 +308,9 @@ private:
     /// Copies image memory back to CPU.
     void DownloadImageMemory(ImageId image_id);
 
+    /// Writes the base level of a tiled image back to guest memory in its tiled layout.
+    void DownloadTiledImageMemory(Image& image, StreamBuffer& download_buffer);
+
     /// Thread function for copying downloaded images out to CPU memory.
     void DownloadedImagesThread(const std::stop_token& token);
 
@@ -287,6 +341,18 @@ private:
     /// Touch the image in the LRU cache.
     void TouchImage(const Image& image);
 
+    /// Frees an image whose contents are discarded, keeping its memory for the next image created.
+    void RecycleImageMemory(ImageId image_id);
+
+    /// Releases recycled memory that was not reused by a new image.
+    void ReleaseAliasDonor();
+
+    /// Recomputes the garbage collection thresholds from the device memory budget.
+    void UpdateGcThresholds(u64 memory_budget);
+
+    /// Publishes memory statistics to the devtools overlay.
+    void PublishMemoryStats() const;
+
     void FreeImage(ImageId image_id) {
         UntrackImage(image_id);
         UnregisterImage(image_id);
@@ -301,19 +367,34 @@ private:
     PageManager& tracker;
     BlitHelper blit_helper;
     TileManager tile_manager;
+    VideoConverter video_converter;
+    std::unique_ptr<TextureHeap> texture_heap;
     Common::SlotVector<Image> slot_images;
     Common::SlotVector<ImageView> slot_image_views;
     tsl::robin_map<u64, Sampler> samplers;
     tsl::robin_map<vk::Format, ImageId> null_images;
     std::unordered_set<ImageId> download_images;
+    UniqueImage alias_donor;
     u64 total_used_memory = 0;
+    u64 image_memory = 0;
+    u64 memory_budget = 0;
     u64 trigger_gc_memory = 0;
     u64 pressure_gc_memory = 0;
     u64 critical_gc_memory = 0;
     u64 gc_tick = 0;
     Common::LeastRecentlyUsedCache<ImageId, u64> lru_cache;
     PageTable page_table;
-    std::mutex mutex;
+    struct TextureLookup {
+        AmdGpu::Image image{};
+        u32 flags{};
+        u64 epoch{};
+        ImageId image_id{};
+        ImageDesc desc{};
+    };
+    static constexpr size_t NumTextureLookups = 256;
+    std::array<TextureLookup, NumTextureLookups> texture_lookups{};
+    u64 image_epoch = 1;
+    PROFILED_MUTEX(std::mutex, mutex);
     struct DownloadedImage {
         u64 tick;
         VAddr device_addr;
@@ -0,0 +1,131 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <algorithm>
+#include <utility>
+
+#include "common/assert.h"
+#include "common/logging/log.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_platform.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/texture_cache/texture_heap.h"
+
+namespace VideoCore {
+
+TextureHeap::TextureHeap(const Vulkan::Instance& instance_, Vulkan::Scheduler& scheduler_)
+    : instance{instance_}, scheduler{scheduler_} {
+    const auto& vk12_props = instance.GetVk12Properties();
+    capacity = std::min({MaxTextures, vk12_props.maxDescriptorSetUpdateAfterBindSampledImages,
+                         vk12_props.maxPerStageDescriptorUpdateAfterBindSampledImages});
+
+    const vk::Device device = instance.GetDevice();
+    const vk::DescriptorBindingFlags binding_flags =
+        vk::DescriptorBindingFlagBits::ePartiallyBound |
+        vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+        vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+    const vk::DescriptorSetLayoutBindingFlagsCreateInfo binding_flags_ci = {
+        .bindingCount = 1,
+        .pBindingFlags = &binding_flags,
+    };
+    const vk::DescriptorSetLayoutBinding binding = {
+        .binding = 0,
+        .descriptorType = vk::DescriptorType::eSampledImage,
+        .descriptorCount = capacity,
+        .stageFlags = vk::ShaderStageFlagBits::eAllGraphics | vk::ShaderStageFlagBits::eCompute,
+    };
+    const vk::DescriptorSetLayoutCreateInfo layout_ci = {
+        .pNext = &binding_flags_ci,
+        .flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+        .bindingCount = 1,
+        .pBindings = &binding,
+    };
+    auto [layout_result, set_layout] = device.createDescriptorSetLayoutUnique(layout_ci);
+    ASSERT_MSG(layout_result == vk::Result::eSuccess,
+               "Failed to create texture heap descriptor set layout: {}",
+               vk::to_string(layout_result));
+    layout = std::move(set_layout);
+
+    const vk::DescriptorPoolSize pool_size = {
+        .type = vk::DescriptorType::eSampledImage,
+        .descriptorCount = capacity,
+    };
+    const vk::DescriptorPoolCreateInfo pool_ci = {
+        .flags = vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+        .maxSets = 1,
+        .poolSizeCount = 1,
+        .pPoolSizes = &pool_size,
+    };
+    auto [pool_result, heap_pool] = device.createDescriptorPoolUnique(pool_ci);
+    ASSERT_MSG(pool_result == vk::Result::eSuccess,
+               "Failed to create texture heap descriptor pool: {}", vk::to_string(pool_result));
+    pool = std::move(heap_pool);
+
+    const vk::DescriptorSetLayout set_layout_handle = *layout;
+    const vk::DescriptorSetAllocateInfo alloc_info = {
+        .descriptorPool = *pool,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &set_layout_handle,
+    };
+    const auto set_result = device.allocateDescriptorSets(&alloc_info, &set);
+    ASSERT_MSG(set_result == vk::Result::eSuccess,
+               "Failed to allocate texture heap descriptor set: {}", vk::to_string(set_result));
+    Vulkan::SetObjectName(device, set, "TextureHeap");
+
+    const vk::DescriptorImageInfo null_info = {.imageLayout = vk::ImageLayout::eGeneral};
+    const vk::WriteDescriptorSet null_write = {
+        .dstSet = set,
+        .dstBinding = 0,
+        .dstArrayElement = NullSlot,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eSampledImage,
+        .pImageInfo = &null_info,
+    };
+    device.updateDescriptorSets(null_write, {});
+    LOG_INFO(Render_Vulkan, "Texture heap holds {} sampled images", capacity);
+}
+
+TextureHeap::~TextureHeap() = default;
+
+bool TextureHeap::IsSupported(const Vulkan::Instance& instance) {
+    // The null slot relies on null descriptors.
+    return instance.IsSampledImageIndexingSupported() && instance.IsNullDescriptorSupported();
+}
+
+u32 TextureHeap::Allocate(vk::ImageView image_view, vk::ImageLayout image_layout) {
+    u32 slot;
+    if (!free_slots.empty()) {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    } else if (next_slot < capacity) {
+        slot = next_slot++;
+    } else {
+        if (!std::exchange(warned_full, true)) {
+            LOG_ERROR(Render_Vulkan, "Texture heap is full, new textures are sampled as null");
+        }
+        return NullSlot;
+    }
+    const vk::DescriptorImageInfo image_info = {
+        .imageView = image_view,
+        .imageLayout = image_layout,
+    };
+    const vk::WriteDescriptorSet write = {
+        .dstSet = set,
+        .dstBinding = 0,
+        .dstArrayElement = slot,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eSampledImage,
+        .pImageInfo = &image_info,
+    };
+    instance.GetDevice().updateDescriptorSets(write, {});
+    return slot;
+}
+
+void TextureHeap::Release(u32 slot) {
+    if (slot == NullSlot || slot == InvalidSlot) {
+        return;
+    }
+    scheduler.DeferOperation([this, slot] { free_slots.push_back(slot); });
+}
+
+} // namespace VideoCore
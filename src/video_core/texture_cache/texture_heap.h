@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <vector>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace Vulkan {
+class Instance;
+class Scheduler;
+} // namespace Vulkan
+
+namespace VideoCore {
+
+/**
+ * Holds a descriptor for every image view sampled by shaders in one large runtime array. Shaders
+ * compiled for the heap index the array with slots the renderer uploads per draw, so sampled
+ * images no longer need a descriptor write every time they are bound. Descriptors are written
+ * once per view and layout, slots are recycled when the GPU no longer uses them.
+ */
+class TextureHeap {
+public:
+    static constexpr u32 MaxTextures = 16384;
+    /// Always holds a null descriptor, used for unbound images and when the heap is full.
+    static constexpr u32 NullSlot = 0;
+    static constexpr u32 InvalidSlot = ~0U;
+
+    explicit TextureHeap(const Vulkan::Instance& instance, Vulkan::Scheduler& scheduler);
+    ~TextureHeap();
+
+    TextureHeap(const TextureHeap&) = delete;
+    TextureHeap& operator=(const TextureHeap&) = delete;
+
+    /// Returns true if the device can index sampled images from an update after bind array.
+    [[nodiscard]] static bool IsSupported(const Vulkan::Instance& instance);
+
+    [[nodiscard]] vk::DescriptorSetLayout Layout() const noexcept {
+        return *layout;
+    }
+
+    [[nodiscard]] vk::DescriptorSet Set() const noexcept {
+        return set;
+    }
+
+    /// Writes a descriptor for the image view in the provided layout and returns its slot.
+    [[nodiscard]] u32 Allocate(vk::ImageView image_view, vk::ImageLayout image_layout);
+
+    /// Returns a slot to the heap once the GPU has finished the commands recorded so far.
+    void Release(u32 slot);
+
+private:
+    const Vulkan::Instance& instance;
+    Vulkan::Scheduler& scheduler;
+    vk::UniqueDescriptorSetLayout layout;
+    vk::UniqueDescriptorPool pool;
+    vk::DescriptorSet set;
+    std::vector<u32> free_slots;
+    u32 capacity{};
+    u32 next_slot{NullSlot + 1};
+    bool warned_full{};
+};
+
+} // namespace VideoCore
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: Copyright 2024 shadPS4 Emulator Project
 // SPDX-License-Identifier: GPL-2.0-or-later
 
+#include "common/div_ceil.h"
 #include "video_core/buffer_cache/buffer.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_scheduler.h"
@@ -98,11 +99,18 @@ TileManager::ScratchBuffer TileManager::GetScratchBuffer(u32 size) {
     return {buffer, allocation};
 }
 
+/// Packs every image property the tiling shader is specialized on.
+static u32 TilingPipelineKey(const ImageInfo& info, bool is_tiler) {
+    ASSERT(u32(info.tile_mode) < AmdGpu::NUM_TILE_MODES && info.num_bits <= 128);
+    return u32(info.tile_mode) | (info.num_bits << 5) |
+           ((std::bit_width(info.num_samples) - 1) << 13) | (u32(info.alt_tile) << 16) |
+           (u32(is_tiler) << 17);
+}
+
 vk::Pipeline TileManager::GetTilingPipeline(const ImageInfo& info, bool is_tiler) {
-    const u32 pl_id = u32(info.tile_mode) * NUM_BPPS + std::bit_width(info.num_bits) - 4;
-    auto& tiling_pipelines = is_tiler ? tilers : detilers;
-    if (auto pipeline = *tiling_pipelines[pl_id]; pipeline != VK_NULL_HANDLE) {
-        return pipeline;
+    const u32 pl_key = TilingPipelineKey(info, is_tiler);
+    if (const auto it = tiling_pipelines.find(pl_key); it != tiling_pipelines.end()) {
+        return *it->second;
     }
 
     const auto device = instance.GetDevice();
@@ -117,18 +125,28 @@ vk::Pipeline TileManager::GetTilingPipeline(const ImageInfo& info, bool is_tiler
     if (AmdGpu::IsMacroTiled(info.array_mode)) {
         const auto macro_tile_mode =
             AmdGpu::CalculateMacrotileMode(info.tile_mode, info.num_bits, info.num_samples);
-        const u32 num_banks = AmdGpu::GetNumBanks(macro_tile_mode);
-        defines.emplace_back(
-            fmt::format("PIPE_CONFIG={}", u32(AmdGpu::GetPipeConfig(info.tile_mode))));
+        // Neo surfaces flagged with the alternate tile mode use the 16 pipe configuration.
+        const auto pipe_config = info.alt_tile ? AmdGpu::GetAltPipeConfig(info.tile_mode)
+                                               : AmdGpu::GetPipeConfig(info.tile_mode);
+        const u32 num_pipes = AmdGpu::GetPipeCount(pipe_config);
+        const u32 num_banks = info.alt_tile ? AmdGpu::GetAltNumBanks(macro_tile_mode)
+                                            : AmdGpu::GetNumBanks(macro_tile_mode);
+        const u32 bank_height = info.alt_tile ? AmdGpu::GetAltBankHeight(macro_tile_mode)
+                                              : AmdGpu::GetBankHeight(macro_tile_mode);
+        const u32 macro_tile_aspect = info.alt_tile
+                                          ? AmdGpu::GetAltMacrotileAspect(macro_tile_mode)
+                                          : AmdGpu::GetMacrotileAspect(macro_tile_mode);
+        defines.emplace_back(fmt::format("PIPE_CONFIG={}", u32(pipe_config)));
+        defines.emplace_back(fmt::format("NUM_PIPES={}", num_pipes));
+        defines.emplace_back(fmt::format("NUM_PIPE_BITS={}", std::bit_width(num_pipes) - 1));
         defines.emplace_back(fmt::format("BANK_WIDTH={}", AmdGpu::GetBankWidth(macro_tile_mode)));
-        defines.emplace_back(fmt::format("BANK_HEIGHT={}", AmdGpu::GetBankHeight(macro_tile_mode)));
+        defines.emplace_back(fmt::format("BANK_HEIGHT={}", bank_height));
         defines.emplace_back(fmt::format("NUM_BANKS={}", num_banks));
         defines.emplace_back(fmt::format("NUM_BANK_BITS={}", std::bit_width(num_banks) - 1));
         defines.emplace_back(fmt::format(
             "TILE_SPLIT_BYTES={}", AmdGpu::CalculateTileSplit(info.tile_mode, info.array_mode,
                                                               micro_tile_mode, info.num_bits)));
-        defines.emplace_back(
-            fmt::format("MACRO_TILE_ASPECT={}", AmdGpu::GetMacrotileAspect(macro_tile_mode)));
+        defines.emplace_back(fmt::format("MACRO_TILE_ASPECT={}", macro_tile_aspect));
     }
     if (is_tiler) {
         defines.emplace_back(fmt::format("IS_TILER=1"));
@@ -136,8 +154,10 @@ vk::Pipeline TileManager::GetTilingPipeline(const ImageInfo& info, bool is_tiler
 
     const auto& module = Vulkan::Compile(HostShaders::TILING_COMP,
                                          vk::ShaderStageFlagBits::eCompute, device, defines);
-    const auto module_name = fmt::format("{}_{} {}", magic_enum::enum_name(info.tile_mode),
-                                         info.num_bits, is_tiler ? "tiler" : "detiler");
+    const auto module_name =
+        fmt::format("{}_{}{}{} {}", magic_enum::enum_name(info.tile_mode), info.num_bits,
+                    info.num_samples > 1 ? fmt::format("_{}x", info.num_samples) : "",
+                    info.alt_tile ? "_alt" : "", is_tiler ? "tiler" : "detiler");
     LOG_WARNING(Render_Vulkan, "Compiling shader {}", module_name);
     for (const auto& def : defines) {
         LOG_WARNING(Render_Vulkan, "#define {}", def);
@@ -156,9 +176,9 @@ vk::Pipeline TileManager::GetTilingPipeline(const ImageInfo& info, bool is_tiler
         device.createComputePipelineUnique(VK_NULL_HANDLE, compute_pipeline_ci);
     ASSERT_MSG(result == vk::Result::eSuccess, "Detiler pipeline creation failed {}",
                vk::to_string(result));
-    tiling_pipelines[pl_id] = std::move(pipeline);
     device.destroyShaderModule(module);
-    return *tiling_pipelines[pl_id];
+    const auto [it, _] = tiling_pipelines.try_emplace(pl_key, std::move(pipeline));
+    return *it->second;
 }
 
 TileManager::Result TileManager::DetileImage(vk::Buffer in_buffer, u32 in_offset,
@@ -321,7 +341,8 @@ void TileManager::TileImage(Image& in_image, std::span<vk::BufferImageCopy> buff
     }};
     cmdbuf.pushDescriptorSetKHR(vk::PipelineBindPoint::eCompute, *pl_layout, 0, set_writes);
 
-    const auto dim_x = (info.guest_size / (info.num_bits / 8)) / 64;
+    // Only the provided levels have linear data to tile.
+    const auto dim_x = Common::DivCeil(copy_size / (info.num_bits / 8), 64U);
     cmdbuf.dispatch(dim_x, 1, 1);
 }
 
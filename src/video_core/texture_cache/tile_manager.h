@@ -3,6 +3,8 @@
 
 #pragma once
 
+#include <tsl/robin_map.h>
+
 #include "common/types.h"
 #include "video_core/amdgpu/tiling.h"
 #include "video_core/buffer_cache/buffer.h"
@@ -14,8 +16,6 @@ struct Image;
 class StreamBuffer;
 
 class TileManager {
-    static constexpr size_t NUM_BPPS = 5;
-
 public:
     using ScratchBuffer = std::pair<vk::Buffer, VmaAllocation>;
     using Result = std::pair<vk::Buffer, u32>;
@@ -39,8 +39,7 @@ private:
     StreamBuffer& stream_buffer;
     vk::UniqueDescriptorSetLayout desc_layout;
     vk::UniquePipelineLayout pl_layout;
-    std::array<vk::UniquePipeline, AmdGpu::NUM_TILE_MODES * NUM_BPPS> detilers{};
-    std::array<vk::UniquePipeline, AmdGpu::NUM_TILE_MODES * NUM_BPPS> tilers{};
+    tsl::robin_map<u32, vk::UniquePipeline> tiling_pipelines;
 };
 
 } // namespace VideoCore
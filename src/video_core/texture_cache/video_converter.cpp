@@ -0,0 +1,196 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#include <cstring>
+
+#include "video_core/buffer_cache/buffer.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_scheduler.h"
+#include "video_core/renderer_vulkan/vk_shader_util.h"
+#include "video_core/texture_cache/image.h"
+#include "video_core/texture_cache/image_view.h"
+#include "video_core/texture_cache/video_converter.h"
+
+#include "video_core/host_shaders/yuv_to_nv12_comp.h"
+
+namespace VideoCore {
+
+struct ChromaConstants {
+    u32 u_offset;
+    u32 v_offset;
+    u32 stride;
+    u32 width;
+    u32 height;
+};
+
+VideoConverter::VideoConverter(const Vulkan::Instance& instance_, Vulkan::Scheduler& scheduler_,
+                               StreamBuffer& stream_buffer_)
+    : instance{instance_}, scheduler{scheduler_}, stream_buffer{stream_buffer_} {
+    const auto device = instance.GetDevice();
+    const std::array<vk::DescriptorSetLayoutBinding, 2> bindings = {{
+        {
+            .binding = 0,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        },
+        {
+            .binding = 1,
+            .descriptorType = vk::DescriptorType::eStorageImage,
+            .descriptorCount = 1,
+            .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        },
+    }};
+    const vk::DescriptorSetLayoutCreateInfo desc_layout_ci = {
+        .flags = vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR,
+        .bindingCount = static_cast<u32>(bindings.size()),
+        .pBindings = bindings.data(),
+    };
+    auto desc_layout_result = device.createDescriptorSetLayoutUnique(desc_layout_ci);
+    ASSERT_MSG(desc_layout_result.result == vk::Result::eSuccess,
+               "Failed to create descriptor set layout: {}",
+               vk::to_string(desc_layout_result.result));
+    desc_layout = std::move(desc_layout_result.value);
+
+    const vk::DescriptorSetLayout set_layout = *desc_layout;
+    const vk::PushConstantRange push_constants = {
+        .stageFlags = vk::ShaderStageFlagBits::eCompute,
+        .offset = 0,
+        .size = sizeof(ChromaConstants),
+    };
+    const vk::PipelineLayoutCreateInfo layout_info = {
+        .setLayoutCount = 1U,
+        .pSetLayouts = &set_layout,
+        .pushConstantRangeCount = 1U,
+        .pPushConstantRanges = &push_constants,
+    };
+    auto [layout_result, layout] = device.createPipelineLayoutUnique(layout_info);
+    ASSERT_MSG(layout_result == vk::Result::eSuccess, "Failed to create pipeline layout: {}",
+               vk::to_string(layout_result));
+    pl_layout = std::move(layout);
+
+    const auto module =
+        Vulkan::Compile(HostShaders::YUV_TO_NV12_COMP, vk::ShaderStageFlagBits::eCompute, device);
+    Vulkan::SetObjectName(device, module, "yuv_to_nv12.comp");
+    const vk::ComputePipelineCreateInfo compute_pipeline_ci = {
+        .stage{
+            .stage = vk::ShaderStageFlagBits::eCompute,
+            .module = module,
+            .pName = "main",
+        },
+        .layout = *pl_layout,
+    };
+    auto [pipeline_result, pipeline] =
+        device.createComputePipelineUnique(VK_NULL_HANDLE, compute_pipeline_ci);
+    ASSERT_MSG(pipeline_result == vk::Result::eSuccess, "Video pipeline creation failed {}",
+               vk::to_string(pipeline_result));
+    device.destroyShaderModule(module);
+    chroma_pipeline = std::move(pipeline);
+}
+
+VideoConverter::~VideoConverter() = default;
+
+void VideoConverter::Convert(const VideoFrame& frame, Image& luma, Image& chroma) {
+    const u32 chroma_width = (frame.width + 1) / 2;
+    const u32 chroma_height = (frame.height + 1) / 2;
+    const u32 num_planes = frame.is_nv12 ? 2 : 3;
+
+    // Stage the decoder planes one after the other.
+    std::array<u32, 3> offsets{};
+    u32 staging_size = 0;
+    for (u32 plane = 0; plane < num_planes; ++plane) {
+        offsets[plane] = staging_size;
+        staging_size += frame.strides[plane] * (plane == 0 ? frame.height : chroma_height);
+    }
+    const auto [data, offset] = stream_buffer.Map(staging_size, instance.StorageMinAlignment());
+    for (u32 plane = 0; plane < num_planes; ++plane) {
+        const u32 num_rows = plane == 0 ? frame.height : chroma_height;
+        std::memcpy(data + offsets[plane], frame.planes[plane], frame.strides[plane] * num_rows);
+    }
+    stream_buffer.Commit();
+
+    scheduler.EndRendering();
+    const auto cmdbuf = scheduler.CommandBuffer();
+    const vk::ImageSubresourceLayers subresource = {
+        .aspectMask = vk::ImageAspectFlagBits::eColor,
+        .mipLevel = 0,
+        .baseArrayLayer = 0,
+        .layerCount = 1,
+    };
+
+    luma.Transit(vk::ImageLayout::eTransferDstOptimal, vk::AccessFlagBits2::eTransferWrite, {});
+    cmdbuf.copyBufferToImage(stream_buffer.Handle(), luma.GetImage(),
+                             vk::ImageLayout::eTransferDstOptimal,
+                             vk::BufferImageCopy{
+                                 .bufferOffset = offset,
+                                 .bufferRowLength = frame.strides[0],
+                                 .bufferImageHeight = frame.height,
+                                 .imageSubresource = subresource,
+                                 .imageExtent = {frame.width, frame.height, 1},
+                             });
+
+    if (frame.is_nv12) {
+        chroma.Transit(vk::ImageLayout::eTransferDstOptimal, vk::AccessFlagBits2::eTransferWrite,
+                       {});
+        cmdbuf.copyBufferToImage(stream_buffer.Handle(), chroma.GetImage(),
+                                 vk::ImageLayout::eTransferDstOptimal,
+                                 vk::BufferImageCopy{
+                                     .bufferOffset = offset + offsets[1],
+                                     .bufferRowLength = frame.strides[1] / 2,
+                                     .bufferImageHeight = chroma_height,
+                                     .imageSubresource = subresource,
+                                     .imageExtent = {chroma_width, chroma_height, 1},
+                                 });
+        return;
+    }
+
+    // Planar chroma is interleaved by the compute shader.
+    ImageViewInfo view_info{};
+    view_info.format = vk::Format::eR8G8Unorm;
+    view_info.is_storage = true;
+    const auto& view = chroma.FindView(view_info);
+    chroma.Transit(vk::ImageLayout::eGeneral, vk::AccessFlagBits2::eShaderStorageWrite, {});
+
+    const vk::DescriptorBufferInfo planes_info = {
+        .buffer = stream_buffer.Handle(),
+        .offset = offset,
+        .range = staging_size,
+    };
+    const vk::DescriptorImageInfo chroma_info = {
+        .imageView = *view.image_view,
+        .imageLayout = vk::ImageLayout::eGeneral,
+    };
+    const std::array<vk::WriteDescriptorSet, 2> set_writes = {{
+        {
+            .dstSet = VK_NULL_HANDLE,
+            .dstBinding = 0,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eStorageBuffer,
+            .pBufferInfo = &planes_info,
+        },
+        {
+            .dstSet = VK_NULL_HANDLE,
+            .dstBinding = 1,
+            .dstArrayElement = 0,
+            .descriptorCount = 1,
+            .descriptorType = vk::DescriptorType::eStorageImage,
+            .pImageInfo = &chroma_info,
+        },
+    }};
+    // Both chroma planes of the frames FFmpeg outputs share the same stride.
+    const ChromaConstants consts = {
+        .u_offset = offsets[1],
+        .v_offset = offsets[2],
+        .stride = frame.strides[1],
+        .width = chroma_width,
+        .height = chroma_height,
+    };
+    cmdbuf.bindPipeline(vk::PipelineBindPoint::eCompute, *chroma_pipeline);
+    cmdbuf.pushDescriptorSetKHR(vk::PipelineBindPoint::eCompute, *pl_layout, 0, set_writes);
+    cmdbuf.pushConstants(*pl_layout, vk::ShaderStageFlagBits::eCompute, 0, sizeof(consts),
+                         &consts);
+    cmdbuf.dispatch((chroma_width + 7) / 8, (chroma_height + 7) / 8, 1);
+}
+
+} // namespace VideoCore
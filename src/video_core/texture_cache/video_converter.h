@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: Copyright 2025 shadPS4 Emulator Project
+// SPDX-License-Identifier: GPL-2.0-or-later
+
+#pragma once
+
+#include <array>
+
+#include "common/types.h"
+#include "video_core/renderer_vulkan/vk_common.h"
+
+namespace Vulkan {
+class Instance;
+class Scheduler;
+} // namespace Vulkan
+
+namespace VideoCore {
+
+struct Image;
+class StreamBuffer;
+
+/// Decoded video frame in host memory, destined for an NV12 frame buffer in guest memory.
+struct VideoFrame {
+    VAddr address;
+    u32 width;
+    u32 height;
+    /// Row pitch of the guest luma plane in bytes, the chroma plane has the same pitch.
+    u32 pitch;
+    /// Offset of the guest chroma plane from the luma plane.
+    u32 chroma_offset;
+    /// Chroma is interleaved already in the second plane, otherwise U and V follow the luma.
+    bool is_nv12;
+    std::array<const u8*, 3> planes;
+    std::array<u32, 3> strides;
+};
+
+/// Writes decoded video frames into the luma and chroma images backing a guest frame buffer.
+class VideoConverter {
+public:
+    explicit VideoConverter(const Vulkan::Instance& instance, Vulkan::Scheduler& scheduler,
+                            StreamBuffer& stream_buffer);
+    ~VideoConverter();
+
+    /// Records the upload of the frame into an R8 luma and an R8G8 chroma image.
+    void Convert(const VideoFrame& frame, Image& luma, Image& chroma);
+
+private:
+    const Vulkan::Instance& instance;
+    Vulkan::Scheduler& scheduler;
+    StreamBuffer& stream_buffer;
+    vk::UniqueDescriptorSetLayout desc_layout;
+    vk::UniquePipelineLayout pl_layout;
+    vk::UniquePipeline chroma_pipeline;
+};
+
+} // namespace VideoCore